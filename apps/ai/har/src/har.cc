@@ -5,6 +5,10 @@
  *
  * This example continuously samples the IMU and performs inference on 10s windows
  * with a 2s overlap (i.e., inference every 8s).
+ *
+ * The IMU runs in FIFO mode: it buffers FIFO_WATERMARK samples before interrupting, the
+ * driver reads them in one SPI burst into a sliding window ring, and each complete window
+ * is normalized and quantized straight into the model input.
  **/
 
 
@@ -28,20 +32,18 @@ typedef enum { INFERENCE_PENDING, IDLE } myState_e;
 #define OVERLAP_DURATION_S   2
 #define WINDOW_SIZE        (SAMPLE_RATE_HZ * WINDOW_DURATION_S)   // 200 samples
 #define STEP_SIZE          (SAMPLE_RATE_HZ * (WINDOW_DURATION_S - OVERLAP_DURATION_S)) // 160 samples (8s)
-#define MPU_AXES             6
-
-/// Circular buffer for sliding window
-static float g_sensorData[WINDOW_SIZE][MPU_AXES];
-static int buffer_head = 0;
-static bool window_filled = false;
-
-/// Chunk buffer for incoming STEP_SIZE samples
-static ns_imu_sensor_data_t imu_chunk[STEP_SIZE];
-volatile bool chunk_ready = false;
-
-/// Stats for normalization
-static float g_sensorMean[MPU_AXES];
-static float g_sensorStd[MPU_AXES];
+#define FIFO_WATERMARK      40   // samples per IMU interrupt / SPI burst
+
+/// Sliding window, with room for two bursts beyond the window so a complete window isn't
+/// overwritten while inference runs
+static ns_imu_raw_sample_t g_windowRing[NS_IMU_WINDOW_CAPACITY(WINDOW_SIZE, 2 * FIFO_WATERMARK)];
+static ns_imu_window_t g_window = {
+    .buffer = g_windowRing,
+    .capacity = NS_IMU_WINDOW_CAPACITY(WINDOW_SIZE, 2 * FIFO_WATERMARK),
+    .window_len = WINDOW_SIZE,
+    .hop = STEP_SIZE,
+};
+volatile bool window_ready = false;
 
 /// Labels
 constexpr size_t kCategoryCount = 6;
@@ -49,71 +51,18 @@ const char *kCategoryLabels[kCategoryCount] = {
     "Walking", "Jogging", "Stairs", "Sitting", "Standing"
 };
 
-/// Callback when a chunk of STEP_SIZE samples is ready
+/// Called by ns_imu_fifo_poll (in the main loop, not the IMU interrupt) when a new window is
+/// complete
 void imu_frame_available_cb(void *arg) {
-    ns_imu_config_t *cfg = (ns_imu_config_t *)arg;
-    memcpy(imu_chunk, cfg->frame_buffer, sizeof(imu_chunk));
-    chunk_ready = true;
-}
-
-/// Append new chunk into circular buffer and update head/index
-void append_chunk_to_buffer(void) {
-    for (int i = 0; i < STEP_SIZE; i++) {
-        int idx = (buffer_head + i) % WINDOW_SIZE;
-        // accel
-        g_sensorData[idx][0] = imu_chunk[i].accel_g[0];
-        g_sensorData[idx][1] = imu_chunk[i].accel_g[1];
-        g_sensorData[idx][2] = imu_chunk[i].accel_g[2];
-        // gyro
-        g_sensorData[idx][3] = imu_chunk[i].gyro_dps[0];
-        g_sensorData[idx][4] = imu_chunk[i].gyro_dps[1];
-        g_sensorData[idx][5] = imu_chunk[i].gyro_dps[2];
-    }
-    buffer_head = (buffer_head + STEP_SIZE) % WINDOW_SIZE;
-    // After enough samples, buffer is full
-    if (!window_filled && buffer_head == 0) {
-        window_filled = true;
-    }
-}
-
-/// Compute mean and std deviation over WINDOW_SIZE samples
-void compute_stats(void) {
-    // reset
-    for (int axis = 0; axis < MPU_AXES; axis++) {
-        g_sensorMean[axis] = 0.0f;
-    }
-    // accumulate mean
-    for (int i = 0; i < WINDOW_SIZE; i++) {
-        for (int axis = 0; axis < MPU_AXES; axis++) {
-            g_sensorMean[axis] += g_sensorData[i][axis];
-        }
-    }
-    for (int axis = 0; axis < MPU_AXES; axis++) {
-        g_sensorMean[axis] /= WINDOW_SIZE;
-    }
-    // std dev
-    for (int axis = 0; axis < MPU_AXES; axis++) {
-        float var = 0.0f;
-        for (int i = 0; i < WINDOW_SIZE; i++) {
-            float diff = g_sensorData[i][axis] - g_sensorMean[axis];
-            var += diff * diff;
-        }
-        g_sensorStd[axis] = sqrtf(var / WINDOW_SIZE);
-    }
+    window_ready = true;
 }
 
 /// Run inference on current buffer
 void run_inference(void) {
-    // prepare tensor input
-    int tensorIndex = 0;
-    for (int i = 0; i < WINDOW_SIZE; i++) {
-        for (int axis = 0; axis < MPU_AXES; axis++) {
-            float norm = (g_sensorData[i][axis] - g_sensorMean[axis]) / g_sensorStd[axis];
-            norm = norm / model_input->params.scale + model_input->params.zero_point;
-            norm = MAX(MIN(norm, 127), -128);
-            model_input->data.int8[tensorIndex++] = (int8_t)norm;
-        }
-    }
+    // prepare tensor input: per-axis z-score over the window, quantized
+    ns_imu_window_zscore_int8(
+        &g_window, model_input->params.scale, model_input->params.zero_point,
+        model_input->data.int8);
     // invoke
     TfLiteStatus status = interpreter->Invoke();
     if (status != kTfLiteOk) {
@@ -144,7 +93,7 @@ int main(void) {
     NS_TRY(ns_set_performance_mode(NS_MINIMUM_PERF), "Set CPU Perf mode failed.\n");
     ns_itm_printf_enable();
 
-    // configure IMU for STEP_SIZE-chunks
+    // configure IMU for FIFO bursts feeding the sliding window
     ns_imu_config_t imu_cfg = {
         .api               = &ns_imu_V1_0_0,
         .sensor            = NS_IMU_SENSOR_ICM45605,
@@ -161,8 +110,10 @@ int main(void) {
         .gyro_ln_bw        = IPREG_SYS1_REG_172_GYRO_UI_LPFBW_DIV_4,
         .calibrate         = true,
         .frame_available_cb= imu_frame_available_cb,
-        .frame_size        = STEP_SIZE,
-        .frame_buffer      = imu_chunk
+        .frame_size        = 0,
+        .frame_buffer      = NULL,
+        .fifo_watermark    = FIFO_WATERMARK,
+        .window            = &g_window,
     };
     NS_TRY(ns_imu_configure(&imu_cfg), "IMU Init Failed.\n");
     ns_lp_printf("Continuous HAR: 10s windows with 2s overlap\n");
@@ -174,13 +125,11 @@ int main(void) {
     myState_e state = IDLE;
 
     while (1) {
-        if (chunk_ready) {
-            chunk_ready = false;
-            append_chunk_to_buffer();
-            if (window_filled) {
-                compute_stats();
-                run_inference();
-            }
+        // Reads the IMU FIFO if its watermark interrupt woke us up
+        ns_imu_fifo_poll(&imu_cfg);
+        if (window_ready) {
+            window_ready = false;
+            run_inference();
         }
         ns_deep_sleep();
     }
@@ -7,6 +7,7 @@
 #include "ParamsNNCntrl.h"
 #include "ns_ambiqsuite_harness.h"
 #include "neural_nets.h"
+#include "ns_arena.h"
 
 #ifdef AUDIODEBUG
     #include "SEGGER_RTT.h"
@@ -16,6 +17,12 @@ NNSPClass NNSP_INST; // 10ms
 
 FeatureClass FEAT_INST;
 
+// Per-instance NNSP buffers (STFT state, NN output, and the feature/NN scratch, which
+// overlay each other). Measured with an ns_arena planning pass: ~13.5KB for either net_se.
+#define SE_ARENA_SIZE (14 * 1024)
+static uint8_t seArena[SE_ARENA_SIZE] __attribute__((aligned(NS_ARENA_MAX_ALIGNMENT)));
+static ns_arena_t SE_ARENA;
+
 // PcmBufClass PCMBUF_INST;
 
 void seCntrlClass_init(seCntrlClass *pt_inst) {
@@ -34,10 +41,14 @@ void seCntrlClass_init(seCntrlClass *pt_inst) {
 
     // PcmBufClass_init(&PCMBUF_INST);
 
-    NNSPClass_init(
-        (NNSPClass *)pt_inst->pt_nnsp, (void *)&net_se, (void *)&FEAT_INST, 3, feature_mean_se,
-        feature_stdR_se, &pt_inst->Params.thresh_prob_s2i, &pt_inst->Params.thresh_cnts_s2i,
-        &params_nn3_se);
+    ns_arena_init(&SE_ARENA, seArena, SE_ARENA_SIZE);
+    if (NNSPClass_init_arena(
+            (NNSPClass *)pt_inst->pt_nnsp, (void *)&net_se, (void *)&FEAT_INST, 3,
+            feature_mean_se, feature_stdR_se, &pt_inst->Params.thresh_prob_s2i,
+            &pt_inst->Params.thresh_cnts_s2i, &params_nn3_se, &SE_ARENA)) {
+        ns_lp_printf("SE_ARENA_SIZE (%d bytes) is too small\n", SE_ARENA_SIZE);
+        ns_arena_print_plan(&SE_ARENA);
+    }
 }
 
 void seCntrlClass_reset(seCntrlClass *pt_inst) {
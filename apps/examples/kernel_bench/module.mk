@@ -0,0 +1,19 @@
+local_app_name := kernel_bench
+local_src := $(wildcard $(subdirectory)/src/*.c)
+local_src += $(wildcard $(subdirectory)/src/*.cc)
+local_src += $(wildcard $(subdirectory)/src/*.cpp)
+local_src += $(wildcard $(subdirectory)/src/*.s)
+ifdef KB_FULL_PMU
+DEFINES += KB_FULL_PMU=$(KB_FULL_PMU)
+endif
+ifdef KB_RPC
+DEFINES += KB_RPC=$(KB_RPC)
+endif
+local_bin := $(BINDIR)/$(subdirectory)
+
+bindirs   += $(local_bin)
+examples  += $(local_bin)/$(local_app_name).axf
+examples  += $(local_bin)/$(local_app_name).bin
+mains     += $(local_bin)/src/$(local_app_name).o
+
+$(eval $(call make-axf, $(local_bin)/$(local_app_name), $(local_src)))
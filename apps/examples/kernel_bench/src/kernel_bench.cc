@@ -0,0 +1,398 @@
+/**
+ * @file kernel_bench.cc
+ * @author Ambiq
+ * @brief PMU micro-benchmark of the neuralSPOT DSP and NN kernels
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Sweeps the hot kernels (affine_Krows_8x16, lstm_8x16, the NNSP STFT analysis and synthesis in
+ * their shifting and overlap-add forms, melSpecProc, log10_vec, ns_mfcc_compute) across the
+ * sizes the speech models use. Each case runs through the ns_pmu invoke hook, counting cycles,
+ * instructions, MVE instructions and MVE multiply-accumulates per call. Results are printed as
+ * a table (lines starting with "KB") and, with KB_RPC, sent to tools/ns_kernel_bench.py, which
+ * stores them and diffs them against a baseline.
+ *
+ * Build with KB_FULL_PMU=1 to also run ns_pmu_characterize_function on every case, which walks
+ * the whole PMU event map (printed over SWO, not sent over RPC).
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#if !defined(AM_PART_APOLLO5B) && !defined(AM_PART_APOLLO510B)
+    #error "This example is only supported on Apollo5B or Apollo510B"
+#endif
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "ns_ambiqsuite_harness.h"
+#include "ns_audio_mfcc.h"
+#include "ns_core.h"
+#include "ns_peripherals_button.h"
+#include "ns_peripherals_power.h"
+#include "ns_pmu_utils.h"
+
+#include "activation.h"
+#include "affine.h"
+#include "fixlog10.h"
+#include "lstm.h"
+#include "melSpecProc.h"
+#include "spectrogram_module.h"
+
+#ifndef KB_RPC
+    #ifdef NS_USB_PRESENT
+        #define KB_RPC 1
+    #else
+        #define KB_RPC 0
+    #endif
+#endif
+#ifndef KB_FULL_PMU
+    #define KB_FULL_PMU 0
+#endif
+#define KB_REPS 16         // calls per measurement, counters are reported per call
+#define KB_RPC_WAIT_S 10   // time to start the PC side before sending without a button press
+
+#if KB_RPC
+    #include "ns_rpc_generic_data.h"
+#endif
+
+extern "C" {
+extern const int16_t stft_win_coeff_w240_h80[];
+extern const int16_t stft_win_coeff_w480_h160[];
+extern const int16_t mfltrBank_coeff_nfilt22_fftsize256[];
+extern const int16_t mfltrBank_coeff_nfilt40_fftsize512[];
+extern const int16_t mfltrBank_coeff_nfilt72_fftsize512[];
+}
+
+// Counters sampled for every case, in table order
+static const uint32_t kb_events[4] = {
+    ARM_PMU_CPU_CYCLES, ARM_PMU_INST_RETIRED, ARM_PMU_MVE_INST_RETIRED,
+    ARM_PMU_MVE_INT_MAC_RETIRED};
+
+typedef struct {
+    const char *kernel;
+    const char *size;
+    int32_t dims[4];
+    void (*setup)(const int32_t *dims);
+    invoke_fp run;
+} kb_case_t;
+
+// Largest sizes in the sweep
+#define KB_MAX_IN 512
+#define KB_MAX_LSTM 128
+#define KB_MAX_FFT 512
+#define KB_MAX_LOG 1024
+#define KB_MFCC_ARENA NS_MFCC_ARENA_SIZE(640, 1024, 64, 13)
+
+static const int32_t *g_dims; // dims of the case being run
+static uint32_t g_seed = 1;
+
+alignas(16) static int8_t g_kernel[4 * KB_MAX_LSTM * KB_MAX_LSTM];
+alignas(16) static int8_t g_kernelRec[4 * KB_MAX_LSTM * KB_MAX_LSTM];
+alignas(16) static int16_t g_bias[4 * KB_MAX_LSTM];
+alignas(16) static int16_t g_in16[KB_MAX_IN * 2];
+alignas(16) static int16_t g_out16[KB_MAX_IN];
+alignas(16) static int16_t g_hState[KB_MAX_LSTM];
+alignas(16) static int32_t g_cState[KB_MAX_LSTM];
+alignas(16) static int64_t g_accum[4];
+alignas(16) static int32_t g_in32[KB_MAX_LOG];
+alignas(16) static int32_t g_out32[2 * KB_MAX_FFT + 2];
+alignas(16) static uint8_t g_mfccArena[KB_MFCC_ARENA];
+static float g_mfccOut[16];
+static ns_mfcc_cfg_t g_mfcc;
+static stftModule g_stft;
+
+static int32_t kb_rand(int32_t lim) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return (int32_t)((g_seed >> 8) % (2 * lim + 1)) - lim;
+}
+
+static void kb_fill_inputs(void) {
+    g_seed = 1;
+    for (uint32_t i = 0; i < sizeof(g_kernel); i++) {
+        g_kernel[i] = (int8_t)kb_rand(24);
+        g_kernelRec[i] = (int8_t)kb_rand(24);
+    }
+    for (int i = 0; i < 4 * KB_MAX_LSTM; i++) {
+        g_bias[i] = (int16_t)kb_rand(2000);
+    }
+    for (int i = 0; i < KB_MAX_IN * 2; i++) {
+        g_in16[i] = (int16_t)kb_rand(4096);
+    }
+    for (int i = 0; i < KB_MAX_LOG; i++) {
+        kb_rand(1);
+        g_in32[i] = 1 + (int32_t)((g_seed >> 1) >> (i & 15)); // positive, spread over decades
+    }
+}
+
+// affine_Krows_8x16: 4 output rows, the FC/RNN inner kernel. dims: input length
+static int kb_run_affine() {
+    for (int r = 0; r < KB_REPS; r++) {
+        int16_t *po = g_out16;
+        int8_t *pw = g_kernel;
+        int16_t *pb = g_bias;
+        affine_Krows_8x16(
+            4, &po, &pw, &pb, g_in16, (int16_t)g_dims[0], 7, 15, 12, g_accum, 1,
+            (void *(*)(void *, int32_t *, int))relu6_fix);
+    }
+    return g_out16[0];
+}
+
+// lstm_8x16, one timestep. dims: input, cells
+static void kb_setup_lstm(const int32_t *dims) {
+    memset(g_hState, 0, sizeof(g_hState));
+    memset(g_cState, 0, sizeof(g_cState));
+}
+
+static int kb_run_lstm() {
+    for (int r = 0; r < KB_REPS; r++) {
+        lstm_8x16(
+            g_out16, g_kernel, g_kernelRec, g_bias, g_in16, g_hState, g_cState,
+            (int16_t)g_dims[1], (int16_t)g_dims[0], (int16_t)g_dims[1], 7, 15, 12, 15, ftanh,
+            (void *(*)(void *, int32_t *, int))tanh_fix);
+    }
+    return g_out16[0];
+}
+
+// STFT analysis and synthesis, one hop. dims: window, hop, FFT size
+static void kb_setup_stft(const int32_t *dims) {
+    stftModule_construct(
+        &g_stft, (int16_t)dims[0], (int16_t)dims[1], (int16_t)dims[2],
+        dims[0] == 240 ? stft_win_coeff_w240_h80 : stft_win_coeff_w480_h160);
+    stftModule_setDefault(&g_stft);
+}
+
+static int kb_run_stft() {
+    int16_t qbit;
+    for (int r = 0; r < KB_REPS; r++) {
+        stftModule_analyze_arm(&g_stft, g_in16, g_out32, (int16_t)g_dims[2], &qbit);
+    }
+    return g_out32[0];
+}
+
+static int kb_run_stft_ola() {
+    int16_t qbit;
+    for (int r = 0; r < KB_REPS; r++) {
+        stftModule_analyze_ola(&g_stft, g_in16, g_out32, (int16_t)g_dims[2], &qbit);
+    }
+    return g_out32[0];
+}
+
+static int kb_run_istft() {
+    for (int r = 0; r < KB_REPS; r++) {
+        stftModule_synthesize_arm(&g_stft, g_in32, g_out16);
+    }
+    return g_out16[0];
+}
+
+static int kb_run_istft_ola() {
+    for (int r = 0; r < KB_REPS; r++) {
+        stftModule_synthesize_ola(&g_stft, g_in32, g_out16);
+    }
+    return g_out16[0];
+}
+
+// melSpecProc on a power spectrum. dims: filters, FFT size
+static int kb_run_melspec() {
+    const int16_t *banks = (g_dims[0] == 22)   ? mfltrBank_coeff_nfilt22_fftsize256
+                           : (g_dims[0] == 40) ? mfltrBank_coeff_nfilt40_fftsize512
+                                               : mfltrBank_coeff_nfilt72_fftsize512;
+    for (int r = 0; r < KB_REPS; r++) {
+        melSpecProc(g_in32, g_out32, banks, (int16_t)g_dims[0]);
+    }
+    return g_out32[0];
+}
+
+// log10_vec. dims: vector length
+static int kb_run_log10() {
+    for (int r = 0; r < KB_REPS; r++) {
+        log10_vec(g_out32, g_in32, g_dims[0], 15);
+    }
+    return g_out32[0];
+}
+
+// ns_mfcc_compute, one frame. dims: frame length, FFT size, filterbanks, coefficients
+static void kb_setup_mfcc(const int32_t *dims) {
+    memset(&g_mfcc, 0, sizeof(g_mfcc));
+    g_mfcc.api = &ns_mfcc_V1_0_0;
+    g_mfcc.arena = g_mfccArena;
+    g_mfcc.sample_frequency = 16000;
+    g_mfcc.num_fbank_bins = dims[2];
+    g_mfcc.low_freq = 20;
+    g_mfcc.high_freq = 4000;
+    g_mfcc.num_frames = 1;
+    g_mfcc.num_coeffs = dims[3];
+    g_mfcc.num_dec_bits = 0;
+    g_mfcc.frame_len = dims[0];
+    g_mfcc.frame_len_pow2 = dims[1];
+    NS_TRY(ns_mfcc_init(&g_mfcc), "MFCC init failed.\n");
+}
+
+static int kb_run_mfcc() {
+    for (int r = 0; r < KB_REPS; r++) {
+        ns_mfcc_compute(&g_mfcc, g_in16, g_mfccOut);
+    }
+    return (int)g_mfccOut[0];
+}
+
+static const kb_case_t kb_cases[] = {
+    {"affine_Krows_8x16", "4x64", {64}, NULL, kb_run_affine},
+    {"affine_Krows_8x16", "4x128", {128}, NULL, kb_run_affine},
+    {"affine_Krows_8x16", "4x256", {256}, NULL, kb_run_affine},
+    {"affine_Krows_8x16", "4x512", {512}, NULL, kb_run_affine},
+    {"lstm_8x16", "40x64", {40, 64}, kb_setup_lstm, kb_run_lstm},
+    {"lstm_8x16", "64x128", {64, 128}, kb_setup_lstm, kb_run_lstm},
+    {"lstm_8x16", "128x128", {128, 128}, kb_setup_lstm, kb_run_lstm},
+    {"stftModule_analyze_arm", "240/80/256", {240, 80, 256}, kb_setup_stft, kb_run_stft},
+    {"stftModule_analyze_arm", "480/160/512", {480, 160, 512}, kb_setup_stft, kb_run_stft},
+    {"stftModule_analyze_ola", "240/80/256", {240, 80, 256}, kb_setup_stft, kb_run_stft_ola},
+    {"stftModule_analyze_ola", "480/160/512", {480, 160, 512}, kb_setup_stft, kb_run_stft_ola},
+    {"stftModule_synthesize_arm", "480/160/512", {480, 160, 512}, kb_setup_stft, kb_run_istft},
+    {"stftModule_synthesize_ola", "480/160/512", {480, 160, 512}, kb_setup_stft,
+     kb_run_istft_ola},
+    {"melSpecProc", "22x256", {22, 256}, NULL, kb_run_melspec},
+    {"melSpecProc", "40x512", {40, 512}, NULL, kb_run_melspec},
+    {"melSpecProc", "72x512", {72, 512}, NULL, kb_run_melspec},
+    {"log10_vec", "64", {64}, NULL, kb_run_log10},
+    {"log10_vec", "257", {257}, NULL, kb_run_log10},
+    {"log10_vec", "1024", {1024}, NULL, kb_run_log10},
+    {"ns_mfcc_compute", "320/512/40/10", {320, 512, 40, 10}, kb_setup_mfcc, kb_run_mfcc},
+    {"ns_mfcc_compute", "480/512/40/13", {480, 512, 40, 13}, kb_setup_mfcc, kb_run_mfcc},
+    {"ns_mfcc_compute", "640/1024/64/13", {640, 1024, 64, 13}, kb_setup_mfcc, kb_run_mfcc},
+};
+#define KB_NUM_CASES (sizeof(kb_cases) / sizeof(kb_cases[0]))
+
+static ns_pmu_config_t g_pmu;
+static char g_rows[KB_NUM_CASES + 2][128];
+
+static uint32_t kb_measure(const kb_case_t *c, uint32_t *perCall) {
+    g_dims = c->dims;
+    if (c->setup) {
+        c->setup(c->dims);
+    }
+    c->run(); // warm the caches
+
+    ns_pmu_reset_config(&g_pmu);
+    for (int i = 0; i < 4; i++) {
+        ns_pmu_event_create(&g_pmu.events[i], kb_events[i], NS_PMU_EVENT_COUNTER_SIZE_32);
+    }
+    if (c->setup) {
+        c->setup(c->dims); // same state as the warm-up run
+    }
+    uint32_t status = ns_pmu_init(&g_pmu);
+    if (status != NS_STATUS_SUCCESS) {
+        return status;
+    }
+    c->run();
+    ns_pmu_get_counters(&g_pmu);
+    for (int i = 0; i < 4; i++) {
+        perCall[i] = (g_pmu.counter[i].counterValue + KB_REPS / 2) / KB_REPS;
+    }
+
+#if KB_FULL_PMU
+    ns_lp_printf("\n%s %s, every PMU event (%d calls per pass):\n", c->kernel, c->size, KB_REPS);
+    ns_pmu_characterize_function(c->run, &g_pmu);
+#endif
+    return NS_STATUS_SUCCESS;
+}
+
+#if KB_RPC
+    #define KB_USB_BUFSIZE 2048
+static uint8_t kb_rx_buf[KB_USB_BUFSIZE];
+static uint8_t kb_tx_buf[KB_USB_BUFSIZE];
+
+static void kb_send_rows(uint32_t numRows) {
+    char desc[] = "KernelBench";
+    ns_rpc_config_t rpcConfig = {
+        .api = &ns_rpc_gdo_V1_1_0,
+        .mode = NS_RPC_GENERICDATA_CLIENT,
+        .rx_buf = kb_rx_buf,
+        .rx_bufLength = KB_USB_BUFSIZE,
+        .tx_buf = kb_tx_buf,
+        .tx_bufLength = KB_USB_BUFSIZE,
+        .sendBlockToEVB_cb = NULL,
+        .fetchBlockFromEVB_cb = NULL,
+        .computeOnEVB_cb = NULL,
+        .transport = NS_RPC_TRANSPORT_USB};
+    volatile int buttonPressed = 0;
+    ns_button_config_t buttonConfig = {
+        .api = &ns_button_V1_0_0,
+        .button_0_enable = true,
+        .button_1_enable = false,
+        .button_0_flag = &buttonPressed,
+        .button_1_flag = NULL};
+
+    NS_TRY(ns_rpc_genericDataOperations_init(&rpcConfig), "RPC Init Failed\n");
+    NS_TRY(ns_peripheral_button_init(&buttonConfig), "Button init failed\n");
+    ns_lp_printf("Start tools/ns_kernel_bench.py capture, then press Button 0 (or wait %ds)\n",
+                 KB_RPC_WAIT_S);
+    for (int ms = 0; (buttonPressed == 0) && (ms < KB_RPC_WAIT_S * 1000); ms++) {
+        ns_delay_us(1000);
+    }
+
+    // One row per block, the last an empty end marker
+    for (uint32_t i = 0; i <= numRows; i++) {
+        const char *row = (i < numRows) ? g_rows[i] : "";
+        dataBlock block = {
+            .length = (uint32_t)strlen(row),
+            .dType = uint8_e,
+            .description = desc,
+            .cmd = write_cmd,
+            .buffer = {.data = (uint8_t *)row, .dataLength = (uint32_t)strlen(row)}};
+        if (ns_rpc_data_sendBlockToPC(&block) != ns_rpc_data_success) {
+            ns_lp_printf("RPC send of row %d failed\n", i);
+        }
+    }
+}
+#endif
+
+static const char *kb_toolchain(void) {
+#if defined(__ARMCC_VERSION)
+    return "armclang " __VERSION__;
+#elif defined(__clang__)
+    return "llvm " __clang_version__;
+#else
+    return "gcc " __VERSION__;
+#endif
+}
+
+int main(void) {
+    ns_core_config_t ns_core_cfg = {.api = &ns_core_V1_0_0};
+    uint32_t numRows = 0;
+    uint32_t perCall[4];
+
+    NS_TRY(ns_core_init(&ns_core_cfg), "Core init failed.\n");
+    NS_TRY(ns_power_config(&ns_development_default), "Power Init Failed.\n");
+    ns_itm_printf_enable();
+    ns_interrupt_master_enable();
+    g_pmu.api = &ns_pmu_V1_0_0;
+
+    snprintf(g_rows[numRows++], sizeof(g_rows[0]), "# toolchain\t%s", kb_toolchain());
+    snprintf(g_rows[numRows++], sizeof(g_rows[0]), "kernel\tsize\tcycles\tinst\tmve_inst\tmve_mac");
+    for (uint32_t i = 0; i < KB_NUM_CASES; i++) {
+        const kb_case_t *c = &kb_cases[i];
+        kb_fill_inputs();
+        if (kb_measure(c, perCall) != NS_STATUS_SUCCESS) {
+            ns_lp_printf("PMU init failed for %s %s\n", c->kernel, c->size);
+            continue;
+        }
+        snprintf(
+            g_rows[numRows++], sizeof(g_rows[0]), "%s\t%s\t%lu\t%lu\t%lu\t%lu", c->kernel,
+            c->size, (unsigned long)perCall[0], (unsigned long)perCall[1],
+            (unsigned long)perCall[2], (unsigned long)perCall[3]);
+    }
+
+    ns_lp_printf("\n");
+    for (uint32_t i = 0; i < numRows; i++) {
+        ns_lp_printf("KB\t%s\n", g_rows[i]);
+    }
+#if KB_RPC
+    kb_send_rows(numRows);
+#endif
+    ns_lp_printf("Kernel benchmark done.\n");
+    while (1) {
+        ns_deep_sleep();
+    }
+}
@@ -49,8 +49,8 @@
 
 // Allocate memory for MFCC calculations
 #define MFCC_ARENA_SIZE                                                                            \
-    32 * (MY_MFCC_FRAME_LEN_POW2 * 2 +                                                             \
-          MY_MFCC_NUM_FBANK_BINS * (NS_MFCC_SIZEBINS + MY_MFCC_NUM_MFCC_COEFFS))
+    NS_MFCC_ARENA_SIZE(                                                                            \
+        SAMPLES_IN_FRAME, MY_MFCC_FRAME_LEN_POW2, MY_MFCC_NUM_FBANK_BINS, MY_MFCC_NUM_MFCC_COEFFS)
 static uint8_t mfccArena[MFCC_ARENA_SIZE];
 static ns_mfcc_cfg_t mfcc_config = {.api = &ns_mfcc_V1_0_0,
                              .arena = mfccArena,
@@ -79,7 +79,9 @@ typedef struct usb_data {
 #ifndef JPG_MODE
 static uint8_t rgbBuffer[RGB_BUFF_SIZE] __attribute__((aligned(16)));
 #else
-static uint8_t jpgBuffer[JPG_BUFF_SIZE] __attribute__((aligned(16)));
+// Two JPG buffers: the next frame is captured and DMA'd while the current one is sent
+static uint8_t jpgBuffer[NS_CAMERA_PIPELINE_BUFFERS][JPG_BUFF_SIZE] __attribute__((aligned(16)));
+static ns_camera_pipeline_t cameraPipeline;
 #endif
 void picture_dma_complete(ns_camera_config_t *cfg); 
 void picture_taken_complete(ns_camera_config_t *cfg);
@@ -158,13 +160,6 @@ void tic() {
 
 uint32_t toc() { return ns_us_ticker_read(&tickTimer) - elapsedTime; }
 
-void press_jpg_shutter_button(ns_camera_config_t *cfg) {
-    camera_config.imageMode = NS_CAM_IMAGE_MODE_320X320;
-    camera_config.imagePixFmt = NS_CAM_IMAGE_PIX_FMT_JPEG;
-    // ns_lp_printf("Taking JPG picture\n");
-    ns_press_shutter_button(cfg);
-}
-
 void press_rgb_shutter_button(ns_camera_config_t *cfg) {
     camera_config.imageMode = NS_CAM_IMAGE_MODE_96X96;
     camera_config.imagePixFmt = NS_CAM_IMAGE_PIX_FMT_RGB565;
@@ -177,11 +172,6 @@ static uint32_t start_rgb_dma() {
     uint32_t camLength = ns_start_dma_read(&camera_config, rgbBuffer, &bufferOffset, RGB_BUFF_SIZE);
     return camLength;
 }
-#else // JPG_MODE
-static uint32_t start_jpg_dma() {
-    uint32_t camLength = ns_start_dma_read(&camera_config, jpgBuffer, &bufferOffset, JPG_BUFF_SIZE);
-    return camLength;
-}
 #endif
 
 /**
@@ -291,6 +281,15 @@ int main(void) {
     ns_lp_printf("USB Init Success\n");
 
     // Camera Setup
+#ifdef JPG_MODE
+    // The pipeline takes over the camera callbacks, so attach it before ns_camera_init
+    for (int i = 0; i < NS_CAMERA_PIPELINE_BUFFERS; i++) {
+        cameraPipeline.buffers[i] = jpgBuffer[i];
+    }
+    cameraPipeline.bufferSize = JPG_BUFF_SIZE;
+    cameraPipeline.dropStale = true; // always show the most recent frame
+    NS_TRY(ns_camera_pipeline_attach(&camera_config, &cameraPipeline), "Pipeline init failed\n");
+#endif
     if (ns_camera_init(&camera_config) != NS_STATUS_SUCCESS) {
         ns_lp_printf(
             "Camera Init Failed, please ensure the camera is present and connected correctly\n");
@@ -307,14 +306,24 @@ int main(void) {
     ns_start_camera(&camera_config);
     ns_delay_us(10000);
 
-    // Take the first picture
 #ifdef JPG_MODE
-    press_jpg_shutter_button(&camera_config);
+    // Capture, DMA and rendering are pipelined: while one frame is sent to the WebUSB client
+    // the next one is captured and transferred into the other buffer. See ns_camera_pipeline.h.
+    ns_lp_printf("Camera pipeline started\n");
+    NS_TRY(ns_camera_pipeline_start(&cameraPipeline), "Pipeline start failed\n");
+    while (1) {
+        ns_camera_frame_t frame;
+        if (ns_camera_pipeline_get_frame(&cameraPipeline, &frame)) {
+            bufferOffset = frame.offset;
+            render_image(frame.length, frame.buffer);
+            ns_camera_pipeline_release_frame(&cameraPipeline, &frame);
+        }
+    }
 #else
+    // Take the first picture
     press_rgb_shutter_button(&camera_config);
-#endif
 
-    // Note: this demo only takes JPG pictures, but the code is in here to take RGB pictures.
+    // Note: this demo takes JPG pictures (above), but the code is in here to take RGB pictures.
     // See the FOMO example for more elaborate camera use cases.
 
     // There are two camera interactions here:
@@ -334,37 +343,17 @@ int main(void) {
 
     // Now sit in a loop triggering pics and DMA, then sending them to the WebUSB client
     while (1) {
-        // ns_delay_us(1000);
         if (pictureTaken) {
-            // ns_lp_printf("Picture taken\n");
             tic();
-#ifdef JPG_MODE
-            buffer_length = start_jpg_dma();
-            if (buffer_length > JPG_BUFF_SIZE) {
-                // We set the jpg buff size to less than the absolute max assuming jpg
-                // will be smaller than that. If it's not, we have a problem.
-                ns_lp_printf("JPG Bigger than expected: %d\n", buffer_length);
-            }
-#else
             buffer_length = start_rgb_dma();
-#endif
-
             pictureTaken = false;
         }
         if (dmaComplete) {
-// ns_lp_printf("DMA Complete %d\n", toc());
-#ifdef JPG_MODE
-            buffer_length = ns_chop_off_trailing_zeros(
-                jpgBuffer, buffer_length); // Remove trailing zeros, calc new length
-            press_jpg_shutter_button(
-                &camera_config); // Start the next picture while current is xfering
-            render_image(buffer_length, jpgBuffer);
-#else
             press_rgb_shutter_button(&camera_config);
             render_image(buffer_length, rgbBuffer);
-#endif
             dmaComplete = false;
         }
         // ns_deep_sleep();
     }
+#endif
 }
@@ -356,6 +356,18 @@ void erpc_transport_tcp_close(void);
  * @return Return NULL or erpc_transport_t instance pointer.
  */
 erpc_transport_t erpc_transport_usb_cdc_init(usb_handle_t);
+
+/*!
+ * @brief Create an USB vendor bulk transport.
+ *
+ * Create a transport over the USB vendor interface's bulk endpoints. The USB device must have
+ * been initialized with deviceType NS_USB_VENDOR_BULK_DEVICE.
+ *
+ * @param[in] handle ns-usb handle returned by ns_usb_init.
+ *
+ * @return Return NULL or erpc_transport_t instance pointer.
+ */
+erpc_transport_t erpc_transport_usb_bulk_init(usb_handle_t handle);
 #endif
 //@}
 /*!
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _EMBEDDED_RPC__USB_BULK_TRANSPORT_H_
+#define _EMBEDDED_RPC__USB_BULK_TRANSPORT_H_
+
+#include "erpc_config_internal.h"
+#include "erpc_framed_transport.hpp"
+
+extern "C" {
+#include "ns_usb.h"
+#include "ns_usb_bulk_frame.h"
+}
+
+/*!
+ * @addtogroup USB_BULK_transport
+ * @{
+ * @file
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace erpc {
+/*!
+ * @brief Transport over the USB vendor interface's bulk endpoints.
+ *
+ * Each eRPC message (header and body) goes out as a single ns_usb_bulk_frame, written to the
+ * IN endpoint in one transfer so the host can read it with one large bulk read. Received
+ * frames are stripped back into a byte stream as eRPC reads from it.
+ *
+ * @ingroup USB_BULK_transport
+ */
+class UsbBulkTransport : public FramedTransport
+{
+public:
+    /*!
+     * @brief Constructor.
+     *
+     * @param[in] usbHandle ns-usb handle, initialized as NS_USB_VENDOR_BULK_DEVICE.
+     */
+    UsbBulkTransport(usb_handle_t usbHandle);
+
+    /*!
+     * @brief Destructor.
+     */
+    virtual ~UsbBulkTransport(void);
+
+    /*!
+     * @brief Reset the receive framing state.
+     *
+     * @retval kErpcStatus_Success Always.
+     */
+    virtual erpc_status_t init(void);
+
+    /*!
+     * @brief Send a message as one bulk frame.
+     *
+     * @param[in] message Message buffer to send.
+     *
+     * @retval kErpcStatus_SendFailed The message didn't fit or the host stopped reading.
+     * @retval kErpcStatus_Success The message was queued on the IN endpoint.
+     */
+    virtual erpc_status_t send(MessageBuffer *message) override;
+
+private:
+    usb_handle_t m_usbHandle;
+    ns_usb_bulk_deframer_t m_deframer; /*!< Receive framing state */
+
+    /*! Frame header, eRPC header, largest message and pad, sent as one transfer */
+    uint8_t m_txFrame[NS_USB_BULK_FRAME_HEADER_SIZE + sizeof(Header) + ERPC_DEFAULT_BUFFER_SIZE +
+                      1];
+
+    /*!
+     * @brief Receive payload bytes, stripping bulk framing.
+     *
+     * @param[inout] data Preallocated buffer for receiving data.
+     * @param[in] size Size of data to read.
+     *
+     * @retval kErpcStatus_ReceiveFailed Timed out waiting for data.
+     * @retval kErpcStatus_Success Successfully received all data.
+     */
+    virtual erpc_status_t underlyingReceive(uint8_t *data, uint32_t size);
+
+    /*!
+     * @brief Send data as its own bulk frame.
+     *
+     * @param[in] data Buffer to send.
+     * @param[in] size Size of data to send.
+     *
+     * @retval kErpcStatus_SendFailed The data didn't fit or the host stopped reading.
+     * @retval kErpcStatus_Success The data was queued on the IN endpoint.
+     */
+    virtual erpc_status_t underlyingSend(const uint8_t *data, uint32_t size);
+
+    /*!
+     * @brief Frame and send header (may be NULL) followed by data.
+     */
+    erpc_status_t sendFrame(const uint8_t *header, uint32_t headerSize, const uint8_t *data,
+                            uint32_t size);
+};
+
+} // namespace erpc
+
+/*! @} */
+
+#endif /* _EMBEDDED_RPC__USB_BULK_TRANSPORT_H_ */
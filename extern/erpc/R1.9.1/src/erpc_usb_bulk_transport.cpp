@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020-2021 NXP
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include "erpc_usb_bulk_transport.hpp"
+#include "erpc_config_internal.h"
+#include ENDIANNESS_HEADER
+#include "ns_ambiqsuite_harness.h"
+
+using namespace erpc;
+
+////////////////////////////////////////////////////////////////////////////////
+// Definitions
+////////////////////////////////////////////////////////////////////////////////
+
+// Full speed max packet size. A frame that isn't a multiple of it isn't a multiple of the high
+// speed size either, so padding for it ends every transfer in a short packet at both speeds.
+#define USB_BULK_MAX_PACKET 64
+
+////////////////////////////////////////////////////////////////////////////////
+// Code
+////////////////////////////////////////////////////////////////////////////////
+
+// Deframer read callback: blocking read from the ns-usb receive ring
+static uint32_t usb_bulk_read(void *ctx, uint8_t *buf, uint32_t len)
+{
+    return ns_usb_receive_data_timeout((usb_handle_t)ctx, buf, len, NS_USB_RX_TIMEOUT_MS);
+}
+
+UsbBulkTransport::UsbBulkTransport(usb_handle_t usbHandle)
+: m_usbHandle(usbHandle)
+{
+    ns_usb_bulk_deframer_reset(&m_deframer);
+}
+
+UsbBulkTransport::~UsbBulkTransport(void) {}
+
+erpc_status_t UsbBulkTransport::init(void)
+{
+    ns_usb_bulk_deframer_reset(&m_deframer);
+    return kErpcStatus_Success;
+}
+
+erpc_status_t UsbBulkTransport::sendFrame(const uint8_t *header, uint32_t headerSize,
+                                          const uint8_t *data, uint32_t size)
+{
+    uint32_t payload = headerSize + size;
+    if (NS_USB_BULK_FRAME_HEADER_SIZE + payload + 1 > sizeof(m_txFrame))
+    {
+        return kErpcStatus_SendFailed;
+    }
+
+    uint8_t *p = m_txFrame;
+    uint32_t pad = ns_usb_bulk_frame_header(p, payload, USB_BULK_MAX_PACKET);
+    p += NS_USB_BULK_FRAME_HEADER_SIZE;
+    if (headerSize)
+    {
+        memcpy(p, header, headerSize);
+        p += headerSize;
+    }
+    memcpy(p, data, size);
+    p += size;
+    if (pad)
+    {
+        *p++ = 0;
+    }
+
+    uint32_t frameSize = (uint32_t)(p - m_txFrame);
+    uint32_t bytes_tx = ns_usb_send_data(m_usbHandle, m_txFrame, frameSize);
+    if (bytes_tx != frameSize)
+    {
+        ns_printf("NS USB ERROR: asked to send %d, sent %d bytes\n", frameSize, bytes_tx);
+        return kErpcStatus_SendFailed;
+    }
+    return kErpcStatus_Success;
+}
+
+erpc_status_t UsbBulkTransport::send(MessageBuffer *message)
+{
+    uint16_t messageLength;
+    Header h;
+
+    erpc_assert((m_crcImpl != NULL) && ("Uninitialized Crc16 object." != NULL));
+
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(m_sendLock);
+#endif
+
+    // Same header as FramedTransport::send, but sent in one transfer with the body
+    messageLength = message->getUsed();
+    h.m_messageSize = messageLength;
+    h.m_crc = m_crcImpl->computeCRC16(message->get(), messageLength);
+
+    ERPC_WRITE_AGNOSTIC_16(h.m_messageSize);
+    ERPC_WRITE_AGNOSTIC_16(h.m_crc);
+
+    return sendFrame((const uint8_t *)&h, sizeof(h), message->get(), messageLength);
+}
+
+erpc_status_t UsbBulkTransport::underlyingSend(const uint8_t *data, uint32_t size)
+{
+    return sendFrame(NULL, 0, data, size);
+}
+
+erpc_status_t UsbBulkTransport::underlyingReceive(uint8_t *data, uint32_t size)
+{
+    uint32_t bytes_rx = ns_usb_bulk_deframe_read(&m_deframer, usb_bulk_read, m_usbHandle, data,
+                                                 size);
+    if (bytes_rx < size)
+    {
+        ns_printf("NS USB ERROR: asked for %d, Rec %d bytes\n", size, bytes_rx);
+        ns_usb_handle_read_error(m_usbHandle);
+        ns_usb_bulk_deframer_reset(&m_deframer);
+        return kErpcStatus_ReceiveFailed;
+    }
+    return kErpcStatus_Success;
+}
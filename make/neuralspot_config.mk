@@ -294,6 +294,8 @@ DEFINES += NS_TFSTRUCTURE_RECENT
 
 MLPROFILE := 0
 TFLM_VALIDATOR := 0
+# TRACE=1 compiles in the ns_trace instrumentation of neuralSPOT modules
+TRACE := 0
 # TFLM_VALIDATOR_MAX_EVENTS := 40
 
 # DEFINES += OPUS_ARM_INLINE_ASM
@@ -318,6 +320,10 @@ ifeq ($(TFLM_VALIDATOR),1)
   DEFINES += NS_TFLM_VALIDATOR
 endif
 
+ifeq ($(TRACE),1)
+  DEFINES += NS_TRACE
+endif
+
 ifdef TFLM_VALIDATOR_MAX_EVENTS
 	DEFINES += NS_PROFILER_RPC_EVENTS_MAX=$(TFLM_VALIDATOR_MAX_EVENTS)
 endif
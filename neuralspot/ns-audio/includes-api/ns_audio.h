@@ -59,6 +59,8 @@ extern "C" {
     #include "am_mcu_apollo.h"
     #include "am_util.h"
     #include "ns_core.h"
+    #include "ns_audio_file.h"
+    #include "ns_audio_pdm_repack.h"
     #include "ns_ipc_ring_buffer.h"
 
     #define NS_AUDIO_V0_0_1                                                                        \
@@ -91,10 +93,11 @@ typedef enum {
     NS_AUDIO_API_TASK,       ///< FreeRTOS task event (TODO)
 } ns_audio_api_mode_e;
 
-/// Audio Source (current only AUDADC and PDM are supported)
+/// Audio Source
 typedef enum {
     NS_AUDIO_SOURCE_AUDADC, ///< Collect data from AUDADC
     NS_AUDIO_SOURCE_PDM,    ///< Collect data from PDM
+    NS_AUDIO_SOURCE_FILE,   ///< Replay a recording, see ns_audio_file.h
 } ns_audio_source_e;
 
 /// Audio Clock Source
@@ -192,6 +195,14 @@ typedef struct ns_audio_cfg {
     #else
     am_hal_offset_cal_coeffs_array_t *sOffsetCalib;
     #endif
+
+    /** Deferred PDM conversion - only used by the pdm driver */
+    ns_audio_pdm_repack_t *pdmRepack;  ///< If set, the ISR skips conversion, see ns_audio_pdm_convert
+    const uint32_t *volatile pdmFrame; ///< DMA words of the latest completed frame, set by the ISR
+    volatile uint32_t pdmFrameCount;   ///< Incremented by the ISR for every completed frame
+
+    /** File Config - only used by the file replay source */
+    ns_audio_file_cfg_t *file_config;
 } ns_audio_config_t;
 
 extern ns_audio_config_t *g_ns_audio_config;
@@ -231,8 +242,37 @@ extern void ns_audio_getPCM(int16_t *pcm, uint32_t *raw, int16_t len);
  *
  * @param config - ns audio config
  * @param pcm - resulting PCM data
+ * @return NS_STATUS_SUCCESS, or ns_audio_pdm_convert's failure for a deferred PDM conversion
+ * that was overrun by the next frame
+ */
+extern uint32_t ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm);
+
+/**
+ * @brief Convert the latest PDM frame to int16 PCM outside the ISR
+ *
+ * Requires config->pdmRepack, which selects gain, DC removal and channel layout. The ISR only
+ * publishes the DMA buffer, and the DMA engine starts refilling it one frame period later, so
+ * the conversion must run within that window (ns_audio_getPCM_v2 calls this for PDM sources).
+ *
+ * @param config - ns audio config
+ * @param pcm - numSamples * numChannels int16 samples
+ * @return NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the next frame completed during conversion
+ */
+extern uint32_t ns_audio_pdm_convert(ns_audio_config_t *config, int16_t *pcm);
+
+/**
+ * @brief Deliver the next frame of an NS_AUDIO_SOURCE_FILE replay
+ *
+ * Stands in for the audio interrupt: call it where the application would sleep waiting for
+ * audio. In real-time mode it waits until the next frame's capture would have completed (and
+ * returns immediately when the application is already late); the frame is copied to
+ * audioBuffer in callback mode and the callback runs before it returns.
+ *
+ * @param config - ns audio config, started with ns_start_audio
+ * @return NS_STATUS_SUCCESS, NS_STATUS_FAILURE once a non-looping recording has no full frame
+ * left, NS_STATUS_INVALID_CONFIG if the file source isn't running
  */
-extern void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm);
+extern uint32_t ns_audio_file_poll(ns_audio_config_t *config);
 
 /**
  * @brief Set gain of audio source
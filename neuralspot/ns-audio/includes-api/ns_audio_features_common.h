@@ -42,6 +42,10 @@ extern "C" {
 
 typedef float ns_fbank_t[][50];
 
+// Bytes needed at arena_fbanks: first/last bin indexes plus one ns_fbank_t row per bin
+#define NS_FBANKS_ARENA_SIZE(num_fbank_bins)                                                       \
+    ((num_fbank_bins) * (2 * sizeof(int32_t) + 50 * sizeof(float)))
+
 typedef struct {
     uint8_t *arena_fbanks;
     uint32_t sample_frequency;
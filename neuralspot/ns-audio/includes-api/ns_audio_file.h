@@ -0,0 +1,106 @@
+/**
+ * @file ns_audio_file.h
+ * @author Ambiq
+ * @brief Recorded audio replay source for ns_audio (NS_AUDIO_SOURCE_FILE)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Replays a recording (16-bit WAV or raw int16 PCM) through the same contract as the PDM and
+ * AUDADC sources: numSamples per frame, interleaved channels, audioBuffer filled before the
+ * callback in NS_AUDIO_API_CALLBACK mode, ns_audio_getPCM_v2 in NS_AUDIO_API_RINGBUFFER mode.
+ * There is no interrupt; the application calls ns_audio_file_poll() where it would otherwise
+ * sleep waiting for the audio IRQ, and the callback runs from there. Frames are delivered at
+ * the recording's sample rate (NS_AUDIO_FILE_REALTIME) or back to back
+ * (NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE), which makes KWS, SE and NNID pipelines benchmarkable on
+ * Linux with reproducible input.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-audio
+ *  @{
+ */
+
+#ifndef NS_AUDIO_FILE_H
+#define NS_AUDIO_FILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ns_timer.h"
+
+/// Frame delivery pacing
+typedef enum {
+    NS_AUDIO_FILE_REALTIME,            ///< A frame every numSamples / sampleRate seconds
+    NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, ///< Every poll delivers the next frame immediately
+} ns_audio_file_pacing_e;
+
+/// Replay delivery statistics, cleared when the source starts
+typedef struct {
+    uint32_t frames;     ///< Frames delivered
+    uint32_t lateFrames; ///< Delivered more than one frame period after capture completed
+    uint32_t maxLateUs;  ///< Worst delivery delay after capture completed
+    uint32_t loops;      ///< Times the recording wrapped around
+} ns_audio_file_stats_t;
+
+/// Recording and replay configuration, referenced by ns_audio_config_t.file_config
+typedef struct {
+    const int16_t *pcm;             ///< Interleaved samples, set by ns_audio_file_open/load
+    uint32_t numFrames;             ///< Samples per channel in pcm
+    uint8_t numChannels;            ///< Channels in pcm, must match ns_audio_config_t
+    uint16_t sampleRate;            ///< In Hz, must match ns_audio_config_t
+    ns_audio_file_pacing_e pacing;  ///< Real time or as fast as possible
+    bool loop;                      ///< Wrap around at the end instead of stopping
+    ns_timer_config_t *timer;       ///< Initialized timer, required for NS_AUDIO_FILE_REALTIME
+
+    // Internals
+    uint32_t position;              ///< Next sample (per channel) to deliver
+    uint32_t startUs;               ///< Timer value when replay started
+    const int16_t *frame;           ///< Latest delivered frame, read by ns_audio_getPCM_v2
+    uint32_t frameUs;               ///< Timer value when the latest frame's capture completed
+    bool running;                   ///< Between ns_start_audio and ns_end_audio
+    ns_audio_file_stats_t stats;    ///< Delivery statistics
+    void *owned;                    ///< Buffer allocated by ns_audio_file_load
+} ns_audio_file_cfg_t;
+
+/**
+ * @brief Use an in-memory recording, e.g. a WAV file linked into flash
+ *
+ * A RIFF/WAVE image must be 16-bit PCM; its channel count and rate replace the ones in f.
+ * Anything else is taken as raw interleaved int16 PCM with f->numChannels and f->sampleRate
+ * already set.
+ *
+ * @param f - replay configuration, pacing/loop/timer are left untouched
+ * @param data - WAV image or raw PCM, must outlive the replay
+ * @param bytes - size of data
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG for unsupported or truncated data
+ */
+extern uint32_t ns_audio_file_open(ns_audio_file_cfg_t *f, const void *data, uint32_t bytes);
+
+#ifdef NS_HOST_BUILD
+/**
+ * @brief Read a WAV or raw PCM file into memory and open it (host builds only)
+ *
+ * @param f - replay configuration
+ * @param path - .wav file, or raw int16 PCM described by f->numChannels and f->sampleRate
+ * @return NS_STATUS_SUCCESS, NS_STATUS_FAILURE if the file can't be read
+ */
+extern uint32_t ns_audio_file_load(ns_audio_file_cfg_t *f, const char *path);
+
+/**
+ * @brief Free the buffer allocated by ns_audio_file_load
+ *
+ * @param f - replay configuration
+ */
+extern void ns_audio_file_close(ns_audio_file_cfg_t *f);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_AUDIO_FILE_H
+/** @}*/
@@ -56,6 +56,7 @@ extern "C" {
 #endif
 
 #include "arm_math.h"
+#include "ns_arena.h"
 #include "ns_audio_features_common.h"
 
 typedef struct {
@@ -70,11 +71,17 @@ typedef struct {
     float compression_exponent;
     float *melspecBuffer; //[2 * MELSPEC_FRAME_LEN]; // interleaved real + imaginary parts
     ns_fbanks_cfg_t fbc;
+    ns_arena_t *pool; // optional shared arena, used instead of 'arena' when set
 } ns_melspec_cfg_t;
 
-// Arena should be enough to accomodate the various buffers
-// e.g. MFCC_ARENA_SIZE  32*(MELSPEC_FRAME_LEN_POW2*2 + MELSPEC_NUM_FBANK_BINS*52))
-// where '32' is size of float and int32_t
+// Filterbanks persist, melspecBuffer is scratch. The stand-alone size includes slack for an
+// unaligned arena buffer.
+#define NS_MELSPEC_ARENA_SIZE(frame_len, num_fbank_bins)                                           \
+    (NS_ARENA_ALIGN(                                                                               \
+         NS_ARENA_ALIGN(NS_FBANKS_ARENA_SIZE(num_fbank_bins), NS_ARENA_DEFAULT_ALIGNMENT) +        \
+             NS_ARENA_ALIGN(2 * (frame_len) * sizeof(float), NS_ARENA_DEFAULT_ALIGNMENT),          \
+         NS_ARENA_MAX_ALIGNMENT) +                                                                 \
+     NS_ARENA_MAX_ALIGNMENT)
 
 // #ifndef STFT_OVERRIDE_DEFAULTS
 //     #define MELSPEC_SAMP_FREQ 16000
@@ -87,7 +94,15 @@ typedef struct {
 //     #define MELSPEC_COMPRESSION_EXPONENT 0.3
 // #endif
 
-extern void ns_melspec_init(ns_melspec_cfg_t *c);
+/**
+ * @brief initialize data structures used for mel spectrogram related functions
+ *
+ * Buffers come from c->pool if set (as an ns_arena stage named "melspec"), otherwise from
+ * c->arena, which must be NS_MELSPEC_ARENA_SIZE bytes.
+ *
+ * @return uint32_t status
+ */
+extern uint32_t ns_melspec_init(ns_melspec_cfg_t *c);
 
 extern void
 ns_melspec_audio_to_stft(ns_melspec_cfg_t *c, const int16_t *audio_data, float32_t *stft_out);
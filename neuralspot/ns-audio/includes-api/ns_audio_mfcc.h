@@ -40,6 +40,7 @@
 extern "C" {
     #endif
 
+    #include "ns_arena.h"
     #include "ns_audio_features_common.h"
     #include "ns_core.h"
     #include "string.h"
@@ -64,7 +65,7 @@ extern const ns_core_api_t ns_mfcc_current_version;
  */
 typedef struct {
     const ns_core_api_t *api;  ///< API prefix
-    uint8_t *arena;            ///< Pointer to arena (must be allocated by caller)
+    uint8_t *arena;            ///< Arena of NS_MFCC_ARENA_SIZE bytes (unless pool is set)
     uint32_t sample_frequency; ///< Sample frequency of audio data
     uint32_t num_fbank_bins;   ///< Number of filterbank bins
     uint32_t low_freq;         ///< Low frequency cutoff
@@ -82,14 +83,29 @@ typedef struct {
     float *mfccWindowFunction; ///< pointer to MFCC window function (set internally)
     float *mfccDCTMatrix;      ///< pointer to MFCC DCT matrix (set internally)
     ns_fbanks_cfg_t fbc;       ///< Filterbank config (set internally)
+    ns_arena_t *pool;          ///< Optional shared arena, used instead of 'arena' when set
 } ns_mfcc_cfg_t;
 
     #define NS_MFCC_SIZEBINS 53
 
-// Arena should be enough to accomodate the various buffers
-// e.g. MFCC_ARENA_SIZE  32*(MY_MFCC_FRAME_LEN_POW2*2 +
-// MY_MFCC_NUM_FBANK_BINS*(NS_MFCC_SIZEBINS+MY_MFCC_NUM_MFCC_COEFFS)) where '32' is size of float
-// and int32_t
+// Persistent (window, DCT matrix, filterbanks) and per-compute scratch (frame, FFT buffer,
+// energies) bytes, as requested from an ns_arena by ns_mfcc_init
+    #define NS_MFCC_PERSISTENT_SIZE(frame_len, num_fbank_bins, num_coeffs)                         \
+        (NS_ARENA_ALIGN((frame_len) * sizeof(float), NS_ARENA_DEFAULT_ALIGNMENT) +                 \
+         NS_ARENA_ALIGN(                                                                           \
+             (num_fbank_bins) * (num_coeffs) * sizeof(float), NS_ARENA_DEFAULT_ALIGNMENT) +        \
+         NS_ARENA_ALIGN(NS_FBANKS_ARENA_SIZE(num_fbank_bins), NS_ARENA_DEFAULT_ALIGNMENT))
+    #define NS_MFCC_SCRATCH_SIZE(frame_len_pow2, num_fbank_bins)                                   \
+        (2 * NS_ARENA_ALIGN((frame_len_pow2) * sizeof(float), NS_ARENA_DEFAULT_ALIGNMENT) +        \
+         NS_ARENA_ALIGN((num_fbank_bins) * sizeof(float), NS_ARENA_DEFAULT_ALIGNMENT))
+
+// Size of a stand-alone MFCC arena (ns_mfcc_cfg_t.arena), including slack for an unaligned buffer
+    #define NS_MFCC_ARENA_SIZE(frame_len, frame_len_pow2, num_fbank_bins, num_coeffs)              \
+        (NS_ARENA_ALIGN(                                                                           \
+             NS_MFCC_PERSISTENT_SIZE(frame_len, num_fbank_bins, num_coeffs) +                      \
+                 NS_MFCC_SCRATCH_SIZE(frame_len_pow2, num_fbank_bins),                             \
+             NS_ARENA_MAX_ALIGNMENT) +                                                             \
+         NS_ARENA_MAX_ALIGNMENT)
 
     #define M_2PI 6.283185307179586476925286766559005
     #ifndef M_PI
@@ -108,6 +124,9 @@ extern float g_audioSumInt;
 /**
  * @brief Initializes the MFCC calculator based on desired configuration
  *
+ * Buffers come from c->pool if set (as an ns_arena stage named "mfcc"), otherwise from
+ * c->arena. When c->pool is a planning arena, only the buffer requests are recorded.
+ *
  * @param c configuration struct (see ns_mfcc_cfg_t)
  * @return uint32_t status
  */
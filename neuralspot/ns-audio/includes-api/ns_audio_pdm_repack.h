@@ -0,0 +1,81 @@
+/**
+ * @file ns_audio_pdm_repack.h
+ * @author Ambiq
+ * @brief PDM DMA word to int16 PCM conversion
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The PDM DMA engine delivers one 32-bit word per sample (interleaved L/R for stereo), with
+ * the 16 significant bits at a part-specific offset. This converter extracts them and fuses
+ * optional per-channel gain, DC removal and channel de-interleaving into a single pass, so the
+ * PDM ISR can hand off the DMA buffer and leave the conversion to the consumer.
+ *
+ * On Helium (MVE) parts the conversion runs 4 samples per vector op; elsewhere a scalar loop
+ * computes the same result bit for bit.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-audio
+ *  @{
+ */
+
+#ifndef NS_AUDIO_PDM_REPACK
+#define NS_AUDIO_PDM_REPACK
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Unity gain in the Q8 gain format
+#define NS_AUDIO_PDM_GAIN_UNITY 256
+
+/// Sample offset within the DMA word: 24-bit packing (Apollo4/Apollo5) and 16-bit (Apollo330)
+#define NS_AUDIO_PDM_SHIFT_24BIT 8
+#define NS_AUDIO_PDM_SHIFT_16BIT 0
+
+/**
+ * @brief PDM conversion settings and DC tracking state
+ *
+ * Per sample: x = (int16)(word >> sampleShift), y = sat16(((x - dc) * gain) >> 8).
+ * The DC estimate is updated once per frame from that frame's mean, so every sample of a frame
+ * sees the same offset and the pass stays vectorizable.
+ */
+typedef struct {
+    uint8_t numChannels;  ///< 1 or 2, stereo words arrive interleaved L/R
+    uint8_t sampleShift;  ///< NS_AUDIO_PDM_SHIFT_24BIT or NS_AUDIO_PDM_SHIFT_16BIT
+    bool deinterleave;    ///< Stereo only: write all left samples, then all right samples
+    uint8_t dcShift;      ///< DC tracking speed (dc += (mean - dc) >> dcShift), 0 disables
+    int16_t gain[2];      ///< Per-channel gain, Q8 (NS_AUDIO_PDM_GAIN_UNITY is 1.0)
+    int32_t dc[2];        ///< Per-channel DC estimate, Q8, updated by ns_audio_pdm_repack
+} ns_audio_pdm_repack_t;
+
+/**
+ * @brief Set up a plain conversion: unity gain, no DC removal, interleaved output
+ *
+ * @param r - converter to initialize
+ * @param numChannels - 1 or 2
+ * @param sampleShift - bit offset of the int16 sample within each DMA word
+ */
+extern void ns_audio_pdm_repack_init(ns_audio_pdm_repack_t *r, uint8_t numChannels,
+                                     uint8_t sampleShift);
+
+/**
+ * @brief Convert one frame of PDM DMA words to int16 PCM
+ *
+ * @param r - converter settings and DC state
+ * @param dma - numSamples * numChannels DMA words
+ * @param pcm - numSamples * numChannels int16 samples, may alias dma unless de-interleaving
+ * @param numSamples - samples per channel
+ */
+extern void ns_audio_pdm_repack(ns_audio_pdm_repack_t *r, const uint32_t *dma, int16_t *pcm,
+                                uint32_t numSamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_AUDIO_PDM_REPACK
+/** @}*/
@@ -0,0 +1,199 @@
+/**
+ * @file ns_pipeline.h
+ * @author Ambiq
+ * @brief Declarative audio front-end pipeline (capture -> condition -> features -> model)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * A pipeline is an array of stages. Each stage consumes a window of `frame` input items,
+ * advances by `hop` items and writes `out_bytes` per invocation straight into the input window
+ * of the next stage, so data moves between stages without intermediate copies. Captured frames
+ * are handed to the pipeline by reference through an ns_ipc ring of frame pointers: the audio
+ * callback submits the buffer it was given, and ns_pipeline_process() runs the chain later from
+ * the application's main loop. Every stage keeps its own call and timing counters.
+ *
+ *   ns_pipeline_stage_t stages[2];
+ *   ns_pipeline_mfcc_stage(&stages[0], &mfcc_config, mfccWindow, 320);
+ *   stages[1] = (ns_pipeline_stage_t){.name = "classifier", .run = classify, ...};
+ *   ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0, .stages = stages, .numStages = 2, ...};
+ *   ns_pipeline_init(&pipe);
+ *
+ *   // audio callback (IRQ context)       // main loop
+ *   ns_pipeline_submit(&pipe, pcm);       ns_pipeline_process(&pipe);
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-audio
+ *  @{
+ */
+
+#ifndef NS_PIPELINE_H
+#define NS_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_audio_melspec.h"
+#include "ns_audio_mfcc.h"
+#include "ns_core.h"
+#include "ns_ipc_ring_buffer.h"
+#include "ns_timer.h"
+
+#define NS_PIPELINE_V1_0_0                                                                         \
+    { .major = 1, .minor = 0, .revision = 0 }
+#define NS_PIPELINE_OLDEST_SUPPORTED_VERSION NS_PIPELINE_V1_0_0
+#define NS_PIPELINE_CURRENT_VERSION NS_PIPELINE_V1_0_0
+#define NS_PIPELINE_API_ID 0xCA000D
+
+extern const ns_core_api_t ns_pipeline_V1_0_0;
+extern const ns_core_api_t ns_pipeline_oldest_supported_version;
+extern const ns_core_api_t ns_pipeline_current_version;
+
+#define NS_PIPELINE_MAX_STAGES 8
+
+/// Stage body: read frame items from in, write out_bytes to out, return an NS_STATUS code
+typedef uint32_t (*ns_pipeline_stage_cb)(void *ctx, const void *in, void *out);
+
+struct ns_pipeline;
+
+/// Invoked with the last stage's output every time it runs
+typedef void (*ns_pipeline_output_cb)(struct ns_pipeline *p, const void *out);
+
+/// Per-stage counters, timing only collected when the pipeline has a timer
+typedef struct {
+    uint32_t calls;    ///< Invocations
+    uint32_t errors;   ///< Invocations that returned an error
+    uint32_t last_us;  ///< Duration of the latest invocation
+    uint32_t max_us;   ///< Longest invocation
+    uint64_t total_us; ///< Sum over all invocations
+} ns_pipeline_stage_stats_t;
+
+/**
+ * @brief One pipeline stage and its frame/hop contract
+ *
+ * The upstream stage's out_bytes must be a whole number of items, and both frame and hop must
+ * be multiples of that item count, so every upstream output lands in the window whole. The
+ * first stage's input is whatever is pushed or submitted to the pipeline.
+ */
+typedef struct {
+    const char *name;         ///< For ns_pipeline_print_stats
+    ns_pipeline_stage_cb run; ///< Stage body
+    void *ctx;                ///< Passed to run, e.g. the ns_mfcc_cfg_t
+    uint16_t item_bytes;      ///< Size of one input item (2 for int16 PCM, 4 for a float feature)
+    uint16_t frame;           ///< Input items per invocation
+    uint16_t hop;             ///< Input items consumed per invocation, 1..frame
+    uint32_t out_bytes;       ///< Bytes written per invocation
+    uint8_t *window;          ///< frame * item_bytes bytes; may be NULL for a first stage with
+                              ///< hop == frame, which then runs directly on the pushed buffers
+
+    // Internals
+    uint32_t fill;                   ///< Items currently in window
+    ns_pipeline_stage_stats_t stats; ///< Counters, cleared by init and reset
+} ns_pipeline_stage_t;
+
+/// Pipeline configuration and state
+typedef struct ns_pipeline {
+    const ns_core_api_t *api;       ///< API prefix
+    ns_pipeline_stage_t *stages;    ///< Stages in order, input first
+    uint8_t numStages;              ///< 1..NS_PIPELINE_MAX_STAGES
+    void *output;                   ///< Last stage output, its out_bytes
+    ns_pipeline_output_cb onOutput; ///< Optional, called after every last-stage invocation
+    void *user;                     ///< For the application (e.g. context for onOutput)
+    ns_timer_config_t *timer;       ///< Optional, per-stage timing when set (initialized timer)
+
+    // Frame handoff, only needed for ns_pipeline_submit/ns_pipeline_process
+    const void **frameSlots;        ///< Storage for frameDepth frame pointers
+    uint16_t frameDepth;            ///< Frames that may be queued before submit drops them
+    uint16_t frameItems;            ///< First-stage items in each submitted frame
+
+    // Internals
+    ns_ipc_ring_buffer_t ring;      ///< Ring of frame pointers
+    uint32_t dropped;               ///< Frames submitted while the ring was full
+} ns_pipeline_t;
+
+/**
+ * @brief Validate the stage contracts and reset windows, counters and the frame ring
+ *
+ * @param p - pipeline
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG if a contract does not hold
+ */
+extern uint32_t ns_pipeline_init(ns_pipeline_t *p);
+
+/**
+ * @brief Clear stage windows and counters, discarding queued frames
+ *
+ * @param p - pipeline
+ */
+extern void ns_pipeline_reset(ns_pipeline_t *p);
+
+/**
+ * @brief Run items through the pipeline synchronously
+ *
+ * @param p - pipeline
+ * @param data - first-stage input items
+ * @param items - number of items; for a window-less first stage a multiple of its frame
+ * @return NS_STATUS_SUCCESS or the first stage error
+ */
+extern uint32_t ns_pipeline_push(ns_pipeline_t *p, const void *data, uint32_t items);
+
+/**
+ * @brief Queue a captured frame (frameItems items) by reference, safe from IRQ context
+ *
+ * The frame is read when ns_pipeline_process runs, so it must stay valid until then.
+ *
+ * @param p - pipeline
+ * @param frame - captured frame
+ * @return NS_STATUS_SUCCESS, NS_STATUS_FAILURE if the ring was full and the frame was dropped
+ */
+extern uint32_t ns_pipeline_submit(ns_pipeline_t *p, const void *frame);
+
+/**
+ * @brief Run every queued frame through the pipeline
+ *
+ * @param p - pipeline
+ * @return Number of frames processed
+ */
+extern uint32_t ns_pipeline_process(ns_pipeline_t *p);
+
+/**
+ * @brief Print per-stage call counts and timing
+ *
+ * @param p - pipeline
+ */
+extern void ns_pipeline_print_stats(ns_pipeline_t *p);
+
+/**
+ * @brief MFCC stage: frame_len int16 samples in, num_coeffs floats out
+ *
+ * @param s - stage to fill in
+ * @param cfg - initialized MFCC calculator
+ * @param window - cfg->frame_len int16 samples, or NULL when hop == frame_len
+ * @param hop - samples between MFCC frames
+ */
+extern void ns_pipeline_mfcc_stage(
+    ns_pipeline_stage_t *s, ns_mfcc_cfg_t *cfg, int16_t *window, uint16_t hop);
+
+/// Melspec stage context: the calculator and its STFT scratch
+typedef struct {
+    ns_melspec_cfg_t *cfg; ///< Initialized melspec calculator
+    float32_t *stft;       ///< 2 * frame_len floats
+} ns_pipeline_melspec_t;
+
+/**
+ * @brief Melspec stage: frame_len int16 samples in, num_fbank_bins floats out
+ *
+ * @param s - stage to fill in
+ * @param ctx - calculator and STFT scratch, must outlive the pipeline
+ * @param window - frame_len int16 samples, or NULL when hop == frame_len
+ * @param hop - samples between melspec frames
+ */
+extern void ns_pipeline_melspec_stage(
+    ns_pipeline_stage_t *s, ns_pipeline_melspec_t *ctx, int16_t *window, uint16_t hop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_PIPELINE_H
+/** @}*/
@@ -15,6 +15,7 @@
 #include "am_util.h"
 #include "ns_audio.h"
 #include "ns_core.h"
+#include "ns_trace.h"
 
 static void *pvPDMHandle;
 
@@ -130,6 +131,7 @@ void am_pdm0_isr(void) {
     am_hal_pdm_interrupt_clear(pvPDMHandle, ui32Status);
 
     if (ui32Status & AM_HAL_PDM_INT_DCMP) {
+        NS_TRACE_BEGIN("pdm_isr");
         memcpy(
             (uint8_t *)g_ns_audio_config->audioBuffer, (uint8_t *)g_ns_audio_config->sampleBuffer,
             g_ns_audio_config->numSamples * g_ns_audio_config->numChannels * 2);
@@ -149,6 +151,7 @@ void am_pdm0_isr(void) {
         PDMn(0)->DMATOTCOUNT = g_ns_audio_config->numSamples * g_ns_audio_config->numChannels *
                                2; // FIFO unit in bytes
         AM_CRITICAL_END;
+        NS_TRACE_END("pdm_isr");
         // #if configUSE_AAD
         //         if(g_sVosSys.ui8WosSkipFrameFlag)
         //         {
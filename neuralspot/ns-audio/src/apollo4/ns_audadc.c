@@ -35,6 +35,7 @@
     #include "am_util.h"
     #include "ns_audio.h"
     #include "ns_core.h"
+    #include "ns_trace.h"
 
 // #define HFRC2_ADJ            0
 // #define AUDADC_EXAMPLE_DEBUG 1
@@ -363,8 +364,10 @@ void am_audadc0_isr(void) {
                 am_hal_audadc_interrupt_service(g_AUDADCHandle, &g_sAUDADCDMAConfig);
             }
 
+            NS_TRACE_BEGIN("audadc_isr");
             g_ns_audio_config->callback(g_ns_audio_config, 0);
             audadc_config_dma(g_ns_audio_config);
+            NS_TRACE_END("audadc_isr");
         } else {
             if (AUDADCn(0)->DMASTAT_b.DMACPL) {
                 am_util_stdio_printf("WHAT clearing AUDADC interrupt status\n");
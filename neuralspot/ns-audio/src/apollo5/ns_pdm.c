@@ -14,10 +14,15 @@
 #include "am_mcu_apollo.h"
 #include "am_util.h"
 #include "ns_audio.h"
+#include "ns_audio_pdm_repack.h"
 #include "ns_core.h"
+#include "ns_trace.h"
 
 static void *pvPDMHandle;
 
+// Used by the ISR when the application has not asked for deferred conversion
+static ns_audio_pdm_repack_t s_isrRepack;
+
 #ifdef NS_PDM1TO3_PRESENT
 static const IRQn_Type g_ePdmInterrupts[] = {PDM0_IRQn, PDM1_IRQn, PDM2_IRQn, PDM3_IRQn};
 #else
@@ -52,6 +57,7 @@ void pdm_trigger_dma(ns_audio_config_t *config) {
 }
 
 uint32_t pdm_init(ns_audio_config_t *config) {
+    ns_audio_pdm_repack_init(&s_isrRepack, config->numChannels, NS_AUDIO_PDM_SHIFT_24BIT);
     ns_pdm_cfg_t *cfg = config->pdm_config;
 
     // Common PDM Configuration
@@ -239,17 +245,20 @@ void am_pdm_isr_common(uint8_t pdmNumber) {
     // ns_lp_printf("PDM ISR %d\n", ui32Status);
 
 
+        NS_TRACE_BEGIN("pdm_isr");
         uint32_t *ui32PDMDatabuffer = (uint32_t *)am_hal_pdm_dma_get_buffer(pvPDMHandle);
 
-        g_ns_audio_config->callback(g_ns_audio_config, 0);
-
-        // Re-arrange data
-        uint8_t *temp1 = (uint8_t *)g_ns_audio_config->audioBuffer;
-        for (uint32_t i = 0; i < g_ns_audio_config->numSamples * g_ns_audio_config->numChannels;
-             i++) {
-            temp1[2 * i] = (ui32PDMDatabuffer[i] & 0xFF00) >> 8U;
-            temp1[2 * i + 1] = (ui32PDMDatabuffer[i] & 0xFF0000) >> 16U;
+        // Hand off the DMA buffer; with pdmRepack set the consumer converts it later via
+        // ns_audio_getPCM_v2, otherwise convert it here before notifying the application
+        g_ns_audio_config->pdmFrame = ui32PDMDatabuffer;
+        g_ns_audio_config->pdmFrameCount++;
+        if (g_ns_audio_config->pdmRepack == NULL) {
+            ns_audio_pdm_repack(
+                &s_isrRepack, ui32PDMDatabuffer, (int16_t *)g_ns_audio_config->audioBuffer,
+                g_ns_audio_config->numSamples);
         }
+        g_ns_audio_config->callback(g_ns_audio_config, 0);
+        NS_TRACE_END("pdm_isr");
 
     } else if (ui32Status & (AM_HAL_PDM_INT_UNDFL | AM_HAL_PDM_INT_OVF)) {
         uint32_t count = am_hal_pdm_fifo_count_get(pvPDMHandle);
@@ -264,6 +273,7 @@ void am_pdm_isr_common(uint8_t pdmNumber) {
         #pragma GCC diagnostic pop
         #endif
         am_hal_pdm_fifo_flush(pvPDMHandle);
+        NS_TRACE_INSTANT("pdm_fifo_flush", ui32Status);
         // ns_lp_printf("am_hal_pdm_fifo_flush() %d\n", ui32Status);
     }
 
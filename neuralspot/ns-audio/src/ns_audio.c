@@ -25,8 +25,10 @@
     #include "ns_audadc.h"
 #endif
 
+#include "ns_audio_file_source.h"
 #include "ns_ipc_ring_buffer.h"
 #include "ns_pdm.h"
+#include "ns_trace.h"
 
 const ns_core_api_t ns_audio_V0_0_1 = {.apiId = NS_AUDIO_API_ID, .version = NS_AUDIO_V0_0_1};
 const ns_core_api_t ns_audio_V1_0_0 = {.apiId = NS_AUDIO_API_ID, .version = NS_AUDIO_V1_0_0};
@@ -68,7 +70,12 @@ uint32_t ns_audio_init(ns_audio_config_t *cfg) {
         return NS_STATUS_INVALID_VERSION;
     }
 
-    if ((cfg->callback == NULL) || (cfg->audioBuffer == NULL) || (cfg->sampleBuffer == NULL) || ((uintptr_t)cfg->audioBuffer % 2 != 0)) {
+    if ((cfg->callback == NULL) || (cfg->audioBuffer == NULL) || ((uintptr_t)cfg->audioBuffer % 2 != 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    // The file source replays from memory, there is no DMA buffer
+    if ((cfg->sampleBuffer == NULL) && (cfg->eAudioSource != NS_AUDIO_SOURCE_FILE)) {
         return NS_STATUS_INVALID_CONFIG;
     }
 
@@ -148,6 +155,18 @@ uint32_t ns_audio_init(ns_audio_config_t *cfg) {
             }
         }
     }
+    else if (g_ns_audio_config->eAudioSource == NS_AUDIO_SOURCE_FILE) {
+        if (g_ns_audio_config->file_config == NULL) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        // If api doesn't support dynamic audio source, start the replay here
+        if (ns_core_check_api(g_ns_audio_config->api, &ns_audio_oldest_supported_version, &ns_audio_V2_0_0) == NS_STATUS_SUCCESS) {
+            if(ns_start_audio(g_ns_audio_config) != NS_STATUS_SUCCESS) {
+                return NS_STATUS_INIT_FAILED;
+            }
+            audio_started = true;
+        }
+    }
     else {
         return NS_STATUS_INVALID_CONFIG;
     }
@@ -188,6 +207,11 @@ uint32_t ns_start_audio(ns_audio_config_t *cfg) {
         return NS_STATUS_INIT_FAILED;
 #endif
     }
+    else if (g_ns_audio_config->eAudioSource == NS_AUDIO_SOURCE_FILE) {
+        if (file_source_init(g_ns_audio_config)) {
+            return NS_STATUS_INIT_FAILED;
+        }
+    }
     else {
         if (g_ns_audio_config->pdm_config == NULL) {
             g_ns_audio_config->pdm_config = &ns_pdm_default;
@@ -214,6 +238,10 @@ uint32_t ns_end_audio(ns_audio_config_t *cfg) {
         pdm_deinit(cfg);
         audio_started = false;
         return NS_STATUS_SUCCESS;
+    } else if (g_ns_audio_config->eAudioSource == NS_AUDIO_SOURCE_FILE) {
+        file_source_deinit(cfg);
+        audio_started = false;
+        return NS_STATUS_SUCCESS;
     }
     return NS_STATUS_INVALID_CONFIG;
 }
@@ -233,10 +261,34 @@ void ns_audio_getPCM(int16_t *pcm, uint32_t *raw, int16_t len) {
     }
 }
 
-void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm) {
+uint32_t ns_audio_pdm_convert(ns_audio_config_t *config, int16_t *pcm) {
+    if ((config == NULL) || (config->pdmRepack == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    uint32_t frame = config->pdmFrameCount;
+    const uint32_t *dma = config->pdmFrame;
+    if (dma == NULL) {
+        return NS_STATUS_FAILURE;
+    }
+    NS_TRACE_BEGIN("pdm_convert");
+    ns_audio_pdm_repack(config->pdmRepack, dma, pcm, config->numSamples);
+    NS_TRACE_END("pdm_convert");
+
+    // The DMA engine refills this buffer once the following frame completes
+    return (config->pdmFrameCount == frame) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+}
+
+uint32_t ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm) {
+    if (config->eAudioSource == NS_AUDIO_SOURCE_FILE) {
+        file_source_get_pcm(config, (int16_t *)pcm);
+        return NS_STATUS_SUCCESS;
+    }
+    if ((config->eAudioSource == NS_AUDIO_SOURCE_PDM) && (config->pdmRepack != NULL)) {
+        return ns_audio_pdm_convert(config, (int16_t *)pcm);
+    }
 #ifndef NS_AUDADC_PRESENT
-    // Platform only supports PDM, and there is nothing to do for PDM here
-    return;
+    // Without deferred conversion the PDM ISR already filled audioBuffer
+    return NS_STATUS_SUCCESS;
 #else
     uint32_t ui32PcmSampleCnt = config->numSamples * config->numChannels;
 
@@ -271,8 +323,9 @@ void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm) {
             }
         }
     } else if (config->eAudioSource == NS_AUDIO_SOURCE_PDM) {
-        // ISR current does the work, do nothing here
+        // Without deferred conversion the PDM ISR already filled audioBuffer
     }
+    return NS_STATUS_SUCCESS;
 #endif
 }
 
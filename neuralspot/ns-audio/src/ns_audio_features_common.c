@@ -59,8 +59,8 @@ ns_audio_MelScale(float freq) {
 static void
 ns_fbanks_map_arena(ns_fbanks_cfg_t *cfg) {
     cfg->mfccFbankFirst = (int32_t *)cfg->arena_fbanks;
-    cfg->mfccFbankLast = (int32_t *)(cfg->mfccFbankFirst + cfg->num_fbank_bins * sizeof(int32_t));
-    cfg->melFBank = (ns_fbank_t *)(cfg->mfccFbankLast + cfg->num_fbank_bins * sizeof(int32_t));
+    cfg->mfccFbankLast = cfg->mfccFbankFirst + cfg->num_fbank_bins;
+    cfg->melFBank = (ns_fbank_t *)(cfg->mfccFbankLast + cfg->num_fbank_bins);
 }
 
 void
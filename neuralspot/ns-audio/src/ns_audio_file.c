@@ -0,0 +1,219 @@
+/**
+ * @file ns_audio_file.c
+ * @author Ambiq
+ * @brief Recorded audio replay source for ns_audio
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ns_ambiqsuite_harness.h"
+#include "ns_audio.h"
+#include "ns_audio_file_source.h"
+#include "ns_trace.h"
+
+#ifdef NS_HOST_BUILD
+    #include <stdio.h>
+    #include <stdlib.h>
+#endif
+
+#define NS_AUDIO_FILE_WAVE_PCM 1
+#define NS_AUDIO_FILE_WAVE_EXTENSIBLE 0xFFFE
+
+static inline uint32_t file_rd16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+static inline uint32_t file_rd32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Walks the RIFF chunks for "fmt " and "data"; a data size past the end of the image (as left
+// by recorders that were interrupted) is clamped to what is there
+static uint32_t file_parse_wav(ns_audio_file_cfg_t *f, const uint8_t *data, uint32_t bytes) {
+    const uint8_t *fmt = NULL;
+    uint32_t pos = 12;
+
+    while (pos + 8 <= bytes) {
+        const uint8_t *chunk = data + pos;
+        uint32_t len = file_rd32(chunk + 4);
+        pos += 8;
+        if (!memcmp(chunk, "fmt ", 4)) {
+            if ((len < 16) || (pos + 16 > bytes)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+            fmt = data + pos;
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (fmt == NULL) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+            uint32_t tag = file_rd16(fmt);
+            uint32_t channels = file_rd16(fmt + 2);
+            uint32_t rate = file_rd32(fmt + 4);
+            uint32_t bits = file_rd16(fmt + 14);
+            if (((tag != NS_AUDIO_FILE_WAVE_PCM) && (tag != NS_AUDIO_FILE_WAVE_EXTENSIBLE)) ||
+                (bits != 16) || (channels < 1) || (channels > 2) || (rate > UINT16_MAX) ||
+                ((uintptr_t)(data + pos) & 1)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+            if (len > bytes - pos) {
+                len = bytes - pos;
+            }
+            f->pcm = (const int16_t *)(data + pos);
+            f->numChannels = channels;
+            f->sampleRate = rate;
+            f->numFrames = len / (2 * channels);
+            return NS_STATUS_SUCCESS;
+        }
+        if (len > bytes - pos) {
+            break;
+        }
+        pos += len + (len & 1);
+    }
+    return NS_STATUS_INVALID_CONFIG;
+}
+
+uint32_t ns_audio_file_open(ns_audio_file_cfg_t *f, const void *data, uint32_t bytes) {
+    const uint8_t *d = (const uint8_t *)data;
+
+    if ((f == NULL) || (data == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((bytes >= 12) && !memcmp(d, "RIFF", 4) && !memcmp(d + 8, "WAVE", 4)) {
+        return file_parse_wav(f, d, bytes);
+    }
+
+    // Raw PCM, described by the caller
+    if ((f->numChannels < 1) || (f->numChannels > 2) || (f->sampleRate == 0) ||
+        ((uintptr_t)d & 1)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    f->pcm = (const int16_t *)data;
+    f->numFrames = bytes / (2 * f->numChannels);
+    return NS_STATUS_SUCCESS;
+}
+
+#ifdef NS_HOST_BUILD
+uint32_t ns_audio_file_load(ns_audio_file_cfg_t *f, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf = NULL;
+    long size;
+
+    if (fp == NULL) {
+        return NS_STATUS_FAILURE;
+    }
+    if ((fseek(fp, 0, SEEK_END) == 0) && ((size = ftell(fp)) > 0) &&
+        (fseek(fp, 0, SEEK_SET) == 0) && ((buf = malloc(size)) != NULL) &&
+        (fread(buf, 1, size, fp) == (size_t)size)) {
+        fclose(fp);
+        uint32_t status = ns_audio_file_open(f, buf, (uint32_t)size);
+        if (status != NS_STATUS_SUCCESS) {
+            free(buf);
+            return status;
+        }
+        f->owned = buf;
+        return NS_STATUS_SUCCESS;
+    }
+    free(buf);
+    fclose(fp);
+    return NS_STATUS_FAILURE;
+}
+
+void ns_audio_file_close(ns_audio_file_cfg_t *f) {
+    free(f->owned);
+    f->owned = NULL;
+    f->pcm = NULL;
+    f->numFrames = 0;
+}
+#endif
+
+uint32_t file_source_init(ns_audio_config_t *config) {
+    ns_audio_file_cfg_t *f = config->file_config;
+
+    if ((f == NULL) || (f->pcm == NULL) || (f->numChannels != config->numChannels) ||
+        (f->sampleRate != config->sampleRate)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((f->pacing == NS_AUDIO_FILE_REALTIME) && (f->timer == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    f->position = 0;
+    f->frame = NULL;
+    f->frameUs = 0;
+    memset(&f->stats, 0, sizeof(f->stats));
+    f->startUs = f->timer ? ns_us_ticker_read(f->timer) : 0;
+    f->running = true;
+    return NS_STATUS_SUCCESS;
+}
+
+void file_source_deinit(ns_audio_config_t *config) {
+    if (config->file_config != NULL) {
+        config->file_config->running = false;
+    }
+}
+
+void file_source_get_pcm(ns_audio_config_t *config, int16_t *pcm) {
+    ns_audio_file_cfg_t *f = config->file_config;
+    if ((f == NULL) || (f->frame == NULL) || (pcm == f->frame)) {
+        return;
+    }
+    memcpy(pcm, f->frame, config->numSamples * config->numChannels * sizeof(int16_t));
+}
+
+uint32_t ns_audio_file_poll(ns_audio_config_t *config) {
+    if ((config == NULL) || (config->eAudioSource != NS_AUDIO_SOURCE_FILE) ||
+        (config->file_config == NULL) || !config->file_config->running) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    ns_audio_file_cfg_t *f = config->file_config;
+    uint32_t n = config->numSamples;
+    uint32_t bytes = n * f->numChannels * sizeof(int16_t);
+
+    if (f->position + n > f->numFrames) {
+        if (!f->loop || (f->numFrames < n)) {
+            return NS_STATUS_FAILURE;
+        }
+        f->position = 0;
+        f->stats.loops++;
+    }
+
+    if (f->pacing == NS_AUDIO_FILE_REALTIME) {
+        // Frame k's capture completes (k + 1) frame periods after the start
+        uint32_t period = (uint32_t)((uint64_t)n * 1000000 / f->sampleRate);
+        uint32_t due =
+            f->startUs +
+            (uint32_t)((uint64_t)(f->stats.frames + 1) * n * 1000000 / f->sampleRate);
+        int32_t early = (int32_t)(due - ns_us_ticker_read(f->timer));
+        if (early > 0) {
+            ns_delay_us(early);
+        } else {
+            uint32_t late = (uint32_t)(-early);
+            if (late > f->stats.maxLateUs) {
+                f->stats.maxLateUs = late;
+            }
+            // A microphone would already have overwritten this frame
+            if (late > period) {
+                f->stats.lateFrames++;
+                NS_TRACE_INSTANT("audio_file_late", late);
+            }
+        }
+        f->frameUs = due;
+    } else {
+        f->frameUs = f->timer ? ns_us_ticker_read(f->timer) : 0;
+    }
+
+    f->frame = f->pcm + f->position * f->numChannels;
+    f->position += n;
+    f->stats.frames++;
+
+    // Same hand-off as the PDM ISR: audioBuffer holds the frame when the callback runs
+    NS_TRACE_BEGIN("audio_file_frame");
+    if (config->eAudioApiMode == NS_AUDIO_API_CALLBACK) {
+        memcpy(config->audioBuffer, f->frame, bytes);
+    }
+    config->callback(config, bytes);
+    NS_TRACE_END("audio_file_frame");
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file ns_audio_file_source.h
+ * @author Ambiq
+ * @brief File replay source internals, used by ns_audio
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef NS_AUDIO_FILE_SOURCE
+#define NS_AUDIO_FILE_SOURCE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_audio.h"
+
+/// File source start - should only be invoked by ns_audio, not directly
+extern uint32_t file_source_init(ns_audio_config_t *config);
+extern void file_source_deinit(ns_audio_config_t *config);
+
+/// Copy the latest replayed frame, backs ns_audio_getPCM_v2
+extern void file_source_get_pcm(ns_audio_config_t *config, int16_t *pcm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_AUDIO_FILE_SOURCE
@@ -0,0 +1,207 @@
+/**
+ * @file ns_audio_pdm_repack.c
+ * @author Ambiq
+ * @brief PDM DMA word to int16 PCM conversion
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_audio_pdm_repack.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+    #define NS_PDM_REPACK_MVE
+#elif defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    #include <cmsis_gcc.h>
+    #define NS_PDM_REPACK_DSP
+#endif
+
+void ns_audio_pdm_repack_init(ns_audio_pdm_repack_t *r, uint8_t numChannels,
+                              uint8_t sampleShift) {
+    r->numChannels = numChannels;
+    r->sampleShift = sampleShift;
+    r->deinterleave = false;
+    r->dcShift = 0;
+    r->gain[0] = NS_AUDIO_PDM_GAIN_UNITY;
+    r->gain[1] = NS_AUDIO_PDM_GAIN_UNITY;
+    r->dc[0] = 0;
+    r->dc[1] = 0;
+}
+
+static inline int16_t pdm_sat16(int32_t v) {
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+// Two DMA words' samples packed into one word of int16 PCM (first sample in the low half)
+static inline uint32_t pdm_pack2(uint32_t w0, uint32_t w1, uint32_t shift) {
+#ifdef NS_PDM_REPACK_DSP
+    return (shift == NS_AUDIO_PDM_SHIFT_24BIT) ? __PKHBT(w0 >> 8, w1, 8) : __PKHBT(w0, w1, 16);
+#else
+    return ((w0 >> shift) & 0xFFFFu) | ((w1 << (16 - shift)) & 0xFFFF0000u);
+#endif
+}
+
+// Plain extraction, which is all the ISRs need by default: words [i, n) to int16, two samples
+// per 32-bit store so it costs less than the byte-by-byte loop it replaced. The constant
+// shifts let each loop compile to a shift and a PKHBT (or an AND/ORR pair) per two samples.
+static void pdm_extract_only(const uint32_t *dma, int16_t *pcm, uint32_t i, uint32_t n,
+                             uint32_t shift) {
+    if ((i < n) && (((uintptr_t)(pcm + i) & 3) != 0)) {
+        pcm[i] = (int16_t)(uint16_t)(dma[i] >> shift);
+        i++;
+    }
+    uint32_t *out = (uint32_t *)(pcm + i);
+    if (shift == NS_AUDIO_PDM_SHIFT_24BIT) {
+        for (; i + 1 < n; i += 2) {
+            *out++ = pdm_pack2(dma[i], dma[i + 1], NS_AUDIO_PDM_SHIFT_24BIT);
+        }
+    } else if (shift == NS_AUDIO_PDM_SHIFT_16BIT) {
+        for (; i + 1 < n; i += 2) {
+            *out++ = pdm_pack2(dma[i], dma[i + 1], NS_AUDIO_PDM_SHIFT_16BIT);
+        }
+    }
+    for (; i < n; i++) {
+        pcm[i] = (int16_t)(uint16_t)(dma[i] >> shift);
+    }
+}
+
+// Scalar path, also used for the tail the vector loop leaves behind: samples [start, end) of
+// each channel. The word to int16 extraction shifts the sample to the top of the word and back
+// down so it sign-extends exactly like the vector path. Unity gain without DC removal reduces
+// to the extraction alone; otherwise the loops are split by layout so neither carries a
+// per-sample branch.
+static void pdm_repack_scalar(const ns_audio_pdm_repack_t *r, const uint32_t *dma, int16_t *pcm,
+                              uint32_t numSamples, uint32_t start, uint32_t end,
+                              const int32_t *dcv, int64_t *sums) {
+    uint32_t ch = r->numChannels;
+    uint32_t up = 16 - r->sampleShift;
+
+    if ((r->dcShift == 0) && (r->gain[0] == NS_AUDIO_PDM_GAIN_UNITY) &&
+        ((ch == 1) || ((r->gain[1] == NS_AUDIO_PDM_GAIN_UNITY) && !r->deinterleave))) {
+        pdm_extract_only(dma, pcm, start * ch, end * ch, r->sampleShift);
+        return;
+    }
+
+    if ((ch == 1) || r->deinterleave) {
+        for (uint32_t c = 0; c < ch; c++) {
+            const uint32_t *src = dma + c;
+            int16_t *dst = pcm + c * numSamples;
+            int32_t dc = dcv[c];
+            int32_t gain = r->gain[c];
+            int64_t sum = 0;
+            for (uint32_t i = start; i < end; i++) {
+                int32_t x = (int32_t)(src[i * ch] << up) >> 16;
+                sum += x;
+                dst[i] = pdm_sat16(((x - dc) * gain) >> 8);
+            }
+            sums[c] += sum;
+        }
+        return;
+    }
+
+    // Interleaved stereo stays sample-major so in-place conversion never overruns its input
+    int32_t dcL = dcv[0], dcR = dcv[1];
+    int32_t gainL = r->gain[0], gainR = r->gain[1];
+    int64_t sumL = 0, sumR = 0;
+    for (uint32_t i = start; i < end; i++) {
+        int32_t xl = (int32_t)(dma[2 * i] << up) >> 16;
+        int32_t xr = (int32_t)(dma[2 * i + 1] << up) >> 16;
+        sumL += xl;
+        sumR += xr;
+        pcm[2 * i] = pdm_sat16(((xl - dcL) * gainL) >> 8);
+        pcm[2 * i + 1] = pdm_sat16(((xr - dcR) * gainR) >> 8);
+    }
+    sums[0] += sumL;
+    sums[1] += sumR;
+}
+
+#ifdef NS_PDM_REPACK_MVE
+static inline int32x4_t pdm_extract(uint32x4_t w, int32x4_t up) {
+    return vshrq_n_s32(vreinterpretq_s32_u32(vshlq_u32(w, up)), 16);
+}
+
+static inline int32x4_t pdm_scale(int32x4_t x, int32_t dc, int32_t gain) {
+    return vshrq_n_s32(vmulq_n_s32(vsubq_n_s32(x, dc), gain), 8);
+}
+
+// 4 samples per channel per iteration. Returns the number of samples per channel converted;
+// the stereo remainder (numSamples % 4) is left for the scalar loop.
+static uint32_t pdm_repack_mve(const ns_audio_pdm_repack_t *r, const uint32_t *dma,
+                               int16_t *pcm, uint32_t numSamples, const int32_t *dcv,
+                               int64_t *sums) {
+    int32x4_t up = vdupq_n_s32(16 - r->sampleShift);
+    int32x4_t hi = vdupq_n_s32(INT16_MAX);
+    int32x4_t lo = vdupq_n_s32(INT16_MIN);
+
+    if (r->numChannels == 1) {
+        int64_t acc = 0;
+        for (uint32_t i = 0; i < numSamples; i += 4) {
+            mve_pred16_t p = vctp32q(numSamples - i);
+            int32x4_t x = pdm_extract(vldrwq_z_u32(dma + i, p), up);
+            int32x4_t y = pdm_scale(x, dcv[0], r->gain[0]);
+            acc = vaddlvaq_p_s32(acc, x, p);
+            vstrhq_p_s32(pcm + i, vminq_s32(vmaxq_s32(y, lo), hi), p);
+        }
+        sums[0] += acc;
+        return numSamples;
+    }
+
+    uint32_t n4 = numSamples & ~3u;
+    int64_t accL = 0, accR = 0;
+    int16x8_t packed = vdupq_n_s16(0);
+    for (uint32_t i = 0; i < n4; i += 4) {
+        uint32x4x2_t w = vld2q_u32(dma + 2 * i);
+        int32x4_t xl = pdm_extract(w.val[0], up);
+        int32x4_t xr = pdm_extract(w.val[1], up);
+        int32x4_t yl = pdm_scale(xl, dcv[0], r->gain[0]);
+        int32x4_t yr = pdm_scale(xr, dcv[1], r->gain[1]);
+        accL = vaddlvaq_s32(accL, xl);
+        accR = vaddlvaq_s32(accR, xr);
+        if (r->deinterleave) {
+            vstrhq_s32(pcm + i, vminq_s32(vmaxq_s32(yl, lo), hi));
+            vstrhq_s32(pcm + numSamples + i, vminq_s32(vmaxq_s32(yr, lo), hi));
+        } else {
+            // Saturating narrows into the even (left) and odd (right) halfword lanes
+            packed = vqmovnbq_s32(packed, yl);
+            packed = vqmovntq_s32(packed, yr);
+            vst1q_s16(pcm + 2 * i, packed);
+        }
+    }
+    sums[0] += accL;
+    sums[1] += accR;
+    return n4;
+}
+#endif
+
+void ns_audio_pdm_repack(ns_audio_pdm_repack_t *r, const uint32_t *dma, int16_t *pcm,
+                         uint32_t numSamples) {
+    int32_t dcv[2] = {0, 0};
+    int64_t sums[2] = {0, 0};
+    uint32_t done = 0;
+
+    if (r->dcShift) {
+        dcv[0] = r->dc[0] >> 8;
+        dcv[1] = r->dc[1] >> 8;
+    }
+
+#ifdef NS_PDM_REPACK_MVE
+    done = pdm_repack_mve(r, dma, pcm, numSamples, dcv, sums);
+#endif
+    pdm_repack_scalar(r, dma, pcm, numSamples, done, numSamples, dcv, sums);
+
+    if (r->dcShift && numSamples) {
+        for (uint32_t c = 0; c < r->numChannels; c++) {
+            int32_t mean = (int32_t)((sums[c] * 256) / (int64_t)numSamples);
+            r->dc[c] += (mean - r->dc[c]) >> r->dcShift;
+        }
+    }
+}
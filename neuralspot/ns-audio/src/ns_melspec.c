@@ -52,6 +52,7 @@
 
 #include "float.h"
 #include "ns_ambiqsuite_harness.h"
+#include "ns_core.h"
 #include "ns_audio_melspec.h"
 #include <string.h>
 
@@ -66,21 +67,45 @@ arm_cfft_instance_f32 g_melspecRfft;
 /**
  * @brief initialize data structures used for mel spectrogram related functions
  */
-void
+uint32_t
 ns_melspec_init(ns_melspec_cfg_t *cfg) {
+    ns_arena_t standalone;
+    ns_arena_t *a;
+
+    if (cfg->pool) {
+        a = cfg->pool;
+    } else {
+        if (cfg->arena == NULL) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        ns_arena_init(
+            &standalone, cfg->arena, NS_MELSPEC_ARENA_SIZE(cfg->frame_len, cfg->num_fbank_bins));
+        a = &standalone;
+    }
+    ns_arena_begin(a, "melspec");
+    cfg->fbc.arena_fbanks =
+        (uint8_t *)ns_arena_alloc(a, NS_FBANKS_ARENA_SIZE(cfg->num_fbank_bins), 0);
+    cfg->melspecBuffer = (float *)ns_arena_scratch_alloc(a, 2 * cfg->frame_len * sizeof(float), 0);
+    if (ns_arena_end(a)) {
+        return NS_STATUS_INIT_FAILED;
+    }
+    if (ns_arena_is_planning(a)) {
+        return NS_STATUS_SUCCESS;
+    }
+
     arm_status status = arm_cfft_init_f32(&g_melspecRfft, cfg->frame_len);
     if (status != ARM_MATH_SUCCESS) {
         ns_printf("problem initializing melspec: status enum %d\n", status);
+        return NS_STATUS_INIT_FAILED;
     }
-    cfg->melspecBuffer = (float *)(cfg->arena);
 
-    cfg->fbc.arena_fbanks = (uint8_t *)(cfg->melspecBuffer) + 2 * cfg->frame_len * sizeof(float);
     cfg->fbc.sample_frequency = cfg->sample_frequency;
     cfg->fbc.num_fbank_bins = cfg->num_fbank_bins;
     cfg->fbc.low_freq = cfg->low_freq;
     cfg->fbc.high_freq = cfg->high_freq;
     cfg->fbc.frame_len_pow2 = cfg->frame_len_pow2;
     ns_fbanks_init(&(cfg->fbc));
+    return NS_STATUS_SUCCESS;
 }
 
 /**
@@ -58,15 +58,19 @@ const ns_core_api_t ns_mfcc_current_version = {.apiId = NS_MFCC_API_ID, .version
 // float g_mfccWindowFunction[MFCC_FRAME_LEN];
 // float g_mfccDCTMatrix[MFCC_NUM_FBANK_BINS * MFCC_NUM_MFCC_FEATURES];
 
-// WARNING this is some hacky, finicky pointer math. Sizes and order have to match
-// Fiddle with this at your own peril
-static void ns_mfcc_map_arena(ns_mfcc_cfg_t *cfg) {
-    cfg->mfccFrame = (float *)cfg->arena;
-    cfg->mfccDCTMatrix = (float *)(cfg->mfccFrame + cfg->frame_len_pow2 * sizeof(float));
-    cfg->mfccBuffer =
-        (float *)(cfg->mfccDCTMatrix + cfg->num_fbank_bins * cfg->num_coeffs * sizeof(float));
-    cfg->mfccEnergies = (float *)(cfg->mfccBuffer + cfg->frame_len_pow2 * sizeof(float));
-    cfg->mfccWindowFunction = (float *)(cfg->mfccEnergies + cfg->num_fbank_bins * sizeof(float));
+// Window, DCT matrix, and filterbanks are computed once by init and persist. Frame, FFT
+// buffer, and energies are only live during ns_mfcc_compute, so they are arena scratch.
+static uint32_t ns_mfcc_map_arena(ns_mfcc_cfg_t *cfg, ns_arena_t *a) {
+    ns_arena_begin(a, "mfcc");
+    cfg->mfccWindowFunction = (float *)ns_arena_alloc(a, cfg->frame_len * sizeof(float), 0);
+    cfg->mfccDCTMatrix =
+        (float *)ns_arena_alloc(a, cfg->num_fbank_bins * cfg->num_coeffs * sizeof(float), 0);
+    cfg->fbc.arena_fbanks =
+        (uint8_t *)ns_arena_alloc(a, NS_FBANKS_ARENA_SIZE(cfg->num_fbank_bins), 0);
+    cfg->mfccFrame = (float *)ns_arena_scratch_alloc(a, cfg->frame_len_pow2 * sizeof(float), 0);
+    cfg->mfccBuffer = (float *)ns_arena_scratch_alloc(a, cfg->frame_len_pow2 * sizeof(float), 0);
+    cfg->mfccEnergies = (float *)ns_arena_scratch_alloc(a, cfg->num_fbank_bins * sizeof(float), 0);
+    return ns_arena_end(a);
 }
 // --------------------
 
@@ -95,6 +99,8 @@ static void create_dct_matrix(ns_mfcc_cfg_t *cfg, int32_t input_length, int32_t
 
 uint32_t ns_mfcc_init(ns_mfcc_cfg_t *c) {
     int i;
+    ns_arena_t standalone;
+    ns_arena_t *a;
 #ifndef NS_DISABLE_API_VALIDATION
     if (c == NULL) {
         return NS_STATUS_INVALID_HANDLE;
@@ -104,9 +110,24 @@ uint32_t ns_mfcc_init(ns_mfcc_cfg_t *c) {
         return NS_STATUS_INVALID_VERSION;
     }
 #endif
-    ns_mfcc_map_arena(c);
+    if (c->pool) {
+        a = c->pool;
+    } else {
+        if (c->arena == NULL) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        ns_arena_init(
+            &standalone, c->arena,
+            NS_MFCC_ARENA_SIZE(c->frame_len, c->frame_len_pow2, c->num_fbank_bins, c->num_coeffs));
+        a = &standalone;
+    }
+    if (ns_mfcc_map_arena(c, a)) {
+        return NS_STATUS_INIT_FAILED;
+    }
+    if (ns_arena_is_planning(a)) {
+        return NS_STATUS_SUCCESS;
+    }
 
-    c->fbc.arena_fbanks = (uint8_t *)(c->mfccWindowFunction) + c->frame_len * sizeof(float);
     c->fbc.sample_frequency = c->sample_frequency;
     c->fbc.num_fbank_bins = c->num_fbank_bins;
     c->fbc.low_freq = c->low_freq;
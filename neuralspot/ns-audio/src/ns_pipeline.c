@@ -0,0 +1,266 @@
+/**
+ * @file ns_pipeline.c
+ * @author Ambiq
+ * @brief Declarative audio front-end pipeline
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ns_pipeline.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_trace.h"
+
+const ns_core_api_t ns_pipeline_V1_0_0 = {
+    .apiId = NS_PIPELINE_API_ID, .version = NS_PIPELINE_V1_0_0};
+const ns_core_api_t ns_pipeline_oldest_supported_version = {
+    .apiId = NS_PIPELINE_API_ID, .version = NS_PIPELINE_OLDEST_SUPPORTED_VERSION};
+const ns_core_api_t ns_pipeline_current_version = {
+    .apiId = NS_PIPELINE_API_ID, .version = NS_PIPELINE_CURRENT_VERSION};
+
+static uint32_t ns_pipeline_run_stage(ns_pipeline_t *p, uint32_t k, const void *in);
+
+static inline uint32_t ns_pipeline_first_error(uint32_t status, uint32_t next) {
+    return (status != NS_STATUS_SUCCESS) ? status : next;
+}
+
+uint32_t ns_pipeline_init(ns_pipeline_t *p) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (p == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (ns_core_check_api(
+            p->api, &ns_pipeline_oldest_supported_version, &ns_pipeline_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+#endif
+    if ((p->stages == NULL) || (p->numStages == 0) || (p->numStages > NS_PIPELINE_MAX_STAGES)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    for (uint32_t k = 0; k < p->numStages; k++) {
+        ns_pipeline_stage_t *s = &p->stages[k];
+        if ((s->run == NULL) || (s->item_bytes == 0) || (s->frame == 0) || (s->hop == 0) ||
+            (s->hop > s->frame)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        if (s->window == NULL) {
+            // Only the first stage can read its input in place, one whole frame at a time
+            if ((k != 0) || (s->hop != s->frame)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+        }
+        if (k + 1 < p->numStages) {
+            // The output has to land whole in the next window, before and after every slide
+            ns_pipeline_stage_t *next = &p->stages[k + 1];
+            uint32_t items = s->out_bytes / next->item_bytes;
+            if ((items == 0) || (s->out_bytes % next->item_bytes) || (next->frame % items) ||
+                (next->hop % items)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+        } else if ((p->output == NULL) && (s->out_bytes != 0)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+
+    if (p->frameDepth != 0) {
+        ns_pipeline_stage_t *first = &p->stages[0];
+        if ((p->frameSlots == NULL) || (p->frameItems == 0) ||
+            ((first->window == NULL) && (p->frameItems % first->frame))) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        ns_ipc_ringbuff_setup_t setup = {
+            .indx = 0,
+            .pData = (volatile uint8_t *)p->frameSlots,
+            .ui32ByteSize = p->frameDepth * sizeof(const void *)};
+        ns_ipc_ring_buffer_init(&p->ring, setup);
+    }
+
+    ns_pipeline_reset(p);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_pipeline_reset(ns_pipeline_t *p) {
+    for (uint32_t k = 0; k < p->numStages; k++) {
+        p->stages[k].fill = 0;
+        memset(&p->stages[k].stats, 0, sizeof(ns_pipeline_stage_stats_t));
+    }
+    if (p->frameDepth != 0) {
+        ns_ipc_flush_ring_buffer(&p->ring);
+    }
+    p->dropped = 0;
+}
+
+// Appends items to stage k's window, running the stage every time the window is full and
+// sliding the window by hop afterwards
+static uint32_t ns_pipeline_feed(ns_pipeline_t *p, uint32_t k, const uint8_t *data,
+                                 uint32_t items) {
+    ns_pipeline_stage_t *s = &p->stages[k];
+    uint32_t status = NS_STATUS_SUCCESS;
+
+    if (s->window == NULL) {
+        for (uint32_t i = 0; i + s->frame <= items; i += s->frame) {
+            status = ns_pipeline_first_error(
+                status, ns_pipeline_run_stage(p, k, data + i * s->item_bytes));
+        }
+        return status;
+    }
+
+    while (items) {
+        uint32_t n = s->frame - s->fill;
+        if (n > items) {
+            n = items;
+        }
+        memcpy(s->window + s->fill * s->item_bytes, data, n * s->item_bytes);
+        s->fill += n;
+        data += n * s->item_bytes;
+        items -= n;
+        if (s->fill == s->frame) {
+            status = ns_pipeline_first_error(status, ns_pipeline_run_stage(p, k, s->window));
+        }
+    }
+    return status;
+}
+
+static uint32_t ns_pipeline_run_stage(ns_pipeline_t *p, uint32_t k, const void *in) {
+    ns_pipeline_stage_t *s = &p->stages[k];
+    ns_pipeline_stage_t *next = (k + 1 < p->numStages) ? &p->stages[k + 1] : NULL;
+    void *out = next ? (void *)(next->window + next->fill * next->item_bytes) : p->output;
+    uint32_t t0 = 0;
+
+    if (p->timer) {
+        t0 = ns_us_ticker_read(p->timer);
+    }
+    NS_TRACE_BEGIN(s->name);
+    uint32_t status = s->run(s->ctx, in, out);
+    NS_TRACE_END(s->name);
+    if (p->timer) {
+        uint32_t us = ns_us_ticker_read(p->timer) - t0;
+        s->stats.last_us = us;
+        s->stats.total_us += us;
+        if (us > s->stats.max_us) {
+            s->stats.max_us = us;
+        }
+    }
+    s->stats.calls++;
+
+    // Slide this stage's window before anything downstream can feed it again
+    if ((s->window != NULL) && (in == s->window)) {
+        s->fill = s->frame - s->hop;
+        if (s->fill) {
+            memmove(s->window, s->window + s->hop * s->item_bytes, s->fill * s->item_bytes);
+        }
+    }
+
+    if (status != NS_STATUS_SUCCESS) {
+        s->stats.errors++;
+        return status;
+    }
+    if (next == NULL) {
+        if (p->onOutput) {
+            p->onOutput(p, out);
+        }
+        return NS_STATUS_SUCCESS;
+    }
+
+    // The output was written in place at the tail of the next window
+    next->fill += s->out_bytes / next->item_bytes;
+    if (next->fill == next->frame) {
+        return ns_pipeline_run_stage(p, k + 1, next->window);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_pipeline_push(ns_pipeline_t *p, const void *data, uint32_t items) {
+    return ns_pipeline_feed(p, 0, (const uint8_t *)data, items);
+}
+
+uint32_t ns_pipeline_submit(ns_pipeline_t *p, const void *frame) {
+    if (p->frameDepth == 0) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    // Check for room first, a push into a full ring would only store part of the pointer
+    if (ns_ipc_get_ring_buffer_status(&p->ring) + sizeof(frame) > p->ring.ui32Capacity) {
+        p->dropped++;
+        NS_TRACE_INSTANT("pipeline_drop", p->dropped);
+        return NS_STATUS_FAILURE;
+    }
+    ns_ipc_ring_buffer_push(&p->ring, (void *)&frame, sizeof(frame), true);
+    NS_TRACE_COUNTER("pipeline_queue", ns_ipc_get_ring_buffer_status(&p->ring) / sizeof(frame));
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_pipeline_process(ns_pipeline_t *p) {
+    const void *frame;
+    uint32_t frames = 0;
+
+    if (p->frameDepth == 0) {
+        return 0;
+    }
+    while (ns_ipc_ring_buffer_pop(&p->ring, &frame, sizeof(frame)) == sizeof(frame)) {
+        NS_TRACE_BEGIN("pipeline_frame");
+        ns_pipeline_feed(p, 0, (const uint8_t *)frame, p->frameItems);
+        NS_TRACE_END("pipeline_frame");
+        frames++;
+    }
+    return frames;
+}
+
+void ns_pipeline_print_stats(ns_pipeline_t *p) {
+    ns_lp_printf("%-16s %8s %6s %10s %10s %10s\n", "stage", "calls", "errors", "avg us",
+                 "max us", "last us");
+    for (uint32_t k = 0; k < p->numStages; k++) {
+        ns_pipeline_stage_t *s = &p->stages[k];
+        uint32_t avg = s->stats.calls ? (uint32_t)(s->stats.total_us / s->stats.calls) : 0;
+        ns_lp_printf("%-16s %8u %6u %10u %10u %10u\n", s->name ? s->name : "?",
+                     (unsigned)s->stats.calls, (unsigned)s->stats.errors, (unsigned)avg,
+                     (unsigned)s->stats.max_us, (unsigned)s->stats.last_us);
+    }
+    if (p->dropped) {
+        ns_lp_printf("%u frames dropped\n", (unsigned)p->dropped);
+    }
+}
+
+//
+// Stage adapters for the ns-audio feature calculators
+//
+static uint32_t ns_pipeline_mfcc_run(void *ctx, const void *in, void *out) {
+    return ns_mfcc_compute((ns_mfcc_cfg_t *)ctx, (const int16_t *)in, (float *)out);
+}
+
+void ns_pipeline_mfcc_stage(
+    ns_pipeline_stage_t *s, ns_mfcc_cfg_t *cfg, int16_t *window, uint16_t hop) {
+    memset(s, 0, sizeof(*s));
+    s->name = "mfcc";
+    s->run = ns_pipeline_mfcc_run;
+    s->ctx = cfg;
+    s->item_bytes = sizeof(int16_t);
+    s->frame = cfg->frame_len;
+    s->hop = hop;
+    s->out_bytes = cfg->num_coeffs * sizeof(float);
+    s->window = (uint8_t *)window;
+}
+
+static uint32_t ns_pipeline_melspec_run(void *ctx, const void *in, void *out) {
+    ns_pipeline_melspec_t *m = (ns_pipeline_melspec_t *)ctx;
+    ns_melspec_audio_to_stft(m->cfg, (const int16_t *)in, m->stft);
+    ns_melspec_stft_to_compressed_melspec(m->cfg, m->stft, (float32_t *)out);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_pipeline_melspec_stage(
+    ns_pipeline_stage_t *s, ns_pipeline_melspec_t *ctx, int16_t *window, uint16_t hop) {
+    memset(s, 0, sizeof(*s));
+    s->name = "melspec";
+    s->run = ns_pipeline_melspec_run;
+    s->ctx = ctx;
+    s->item_bytes = sizeof(int16_t);
+    s->frame = ctx->cfg->frame_len;
+    s->hop = hop;
+    s->out_bytes = ctx->cfg->num_fbank_bins * sizeof(float);
+    s->window = (uint8_t *)window;
+}
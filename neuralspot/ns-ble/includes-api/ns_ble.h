@@ -57,6 +57,8 @@
         #include "hci_drv_cooper.h"
     #endif
     #include "hci_handler.h"
+    #include "ns_ble_dispatch.h"
+    #include "ns_ble_stream.h"
 
     #ifdef __cplusplus
 extern "C" {
@@ -114,6 +116,9 @@ extern const ns_core_api_t ns_ble_current_version;
 
     #define NS_BLE_MAX_SERVICES 1
 
+    // Default wait for the stack to confirm a stream notification
+    #define NS_BLE_STREAM_TIMEOUT_MS 1000
+
 // *** Typedefs Prototypes (for callbacks)
 typedef struct ns_ble_control ns_ble_control_t;
 typedef struct ns_ble_service_control ns_ble_service_control_t;
@@ -222,6 +227,11 @@ typedef struct ns_ble_control {
     // New API ------
     ns_ble_service_t *services[NS_BLE_MAX_SERVICES]; /*! Array of services */
     uint16_t numServices;                            /*! Number of services */
+
+    // Dispatch tables, rebuilt by ns_ble_start_service
+    ns_ble_dispatch_table_t handleTable; /*! Attribute handle -> characteristic */
+    ns_ble_dispatch_table_t cccTable;    /*! CCC index -> characteristic */
+    ns_ble_dispatch_table_t eventTable;  /*! Indication timer event -> characteristic */
 } ns_ble_control_t;
 
 // ----------------------------------------------------------------------------
@@ -335,9 +345,11 @@ typedef struct ns_ble_characteristic {
     wsfTimer_t indicationTimer;       /*! \brief periodic measurement timer */
     uint32_t indicationPeriod;        /*! \brief periodic measurement period in ms */
     uint8_t indicationIsAsynchronous; /*! \brief TRUE if indication is asynchronous */
+    ns_ble_stream_t *stream;          /*! \brief Frame queue of a streaming characteristic */
 
     // Internals
     uint16_t handleId;
+    ns_ble_service_t *service; // set by ns_ble_add_characteristic
 
 } ns_ble_characteristic_t;
 
@@ -395,6 +407,36 @@ extern int ns_ble_create_characteristic(
     ns_ble_characteristic_notify_handler_t notifyHandlerCb, uint16_t periodMs, uint8_t async,
     uint16_t *attributeCount);
 
+/**
+ * @brief Define a streaming characteristic: a notify characteristic that sends the frames
+ * queued with ns_ble_send_stream as fast as the connection accepts them, fragmenting frames
+ * larger than the MTU (see ns_ble_stream.h for the fragment format). Add it to the service with
+ * ns_ble_add_characteristic like any other characteristic.
+ *
+ * @param c - config struct, populated by this function
+ * @param uuidString - a 16-byte UUID string
+ * @param stream - stream with queue, queueSize and maxInFlight set. ops are filled in here.
+ * @param timeoutMs - how long to wait for the stack to confirm a notification before resending,
+ * 0 for NS_BLE_STREAM_TIMEOUT_MS
+ * @param attributeCount - a pointer to the service's attribute count. This is incremented by the
+ * function.
+ * @return int
+ */
+extern int ns_ble_create_stream_characteristic(
+    ns_ble_characteristic_t *c, char const *uuidString, ns_ble_stream_t *stream,
+    uint16_t timeoutMs, uint16_t *attributeCount);
+
+/**
+ * @brief Queue a frame on a streaming characteristic and start sending it. Frames queued while
+ * no client is subscribed are sent once one subscribes.
+ *
+ * @param c - streaming characteristic
+ * @param data - frame
+ * @param len - frame length in bytes
+ * @return int NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the queue is full
+ */
+extern int ns_ble_send_stream(ns_ble_characteristic_t *c, const void *data, uint32_t len);
+
 /**
  * @brief Add a characteristic to a service. This function should be called after all
  * characteristics have been defined using ns_ble_create_characteristic.
@@ -0,0 +1,62 @@
+/**
+ * @file ns_ble_dispatch.h
+ * @author Ambiq
+ * @brief Dense lookup tables for ns-ble event dispatch
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Timer events, CCC indices and attribute handles are allocated sequentially by ns-ble, so
+ * each maps to its characteristic through a plain array indexed by key - first. ns_ble.c
+ * builds the tables when a service starts and uses them in the WSF handler and the ATT
+ * read/write callbacks instead of scanning every characteristic of every service.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_BLE_DISPATCH_H
+#define NS_BLE_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint16_t first;  ///< Smallest key
+    uint16_t count;  ///< Keys first .. first + count - 1
+    void **entries;  ///< count entries, NULL where no key is mapped
+} ns_ble_dispatch_table_t;
+
+/**
+ * @brief Set up an empty table over caller-provided storage
+ *
+ * @param t table
+ * @param storage count pointers
+ * @param first smallest key
+ * @param count number of keys
+ */
+void ns_ble_dispatch_init(
+    ns_ble_dispatch_table_t *t, void **storage, uint16_t first, uint16_t count);
+
+/**
+ * @brief Map a key to an entry
+ *
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_INVALID_CONFIG if key is out of range
+ */
+uint32_t ns_ble_dispatch_set(ns_ble_dispatch_table_t *t, uint16_t key, void *entry);
+
+/**
+ * @brief Entry mapped to key, NULL if none
+ */
+static inline void *ns_ble_dispatch_get(const ns_ble_dispatch_table_t *t, uint16_t key) {
+    const uint16_t i = (uint16_t)(key - t->first); // keys below first wrap out of range
+    return (i < t->count) ? t->entries[i] : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_BLE_DISPATCH_H
@@ -0,0 +1,222 @@
+/**
+ * @file ns_ble_stream.h
+ * @author Ambiq
+ * @brief Credit-based BLE notification streaming
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * A streaming characteristic sends a queue of application frames as back-to-back
+ * notifications instead of one notification per timer tick. Frames larger than the ATT MTU
+ * are split into fragments, each notification carrying a one byte fragment header:
+ *
+ *   bit 7 START, bit 6 END, bits 5..0 sequence number (mod 64)
+ *   START fragments follow the header with the frame length (uint16, little endian)
+ *
+ * Every notification handed to the stack uses a credit, and the ATTS_HANDLE_VALUE_CNF that
+ * the stack sends once the notification is in the controller's buffers returns it, so the
+ * queue is drained as fast as the link accepts data without overflowing Cordio's pending
+ * notification slots. If the stack rejects a notification (ATT_ERR_OVERFLOW etc.) the
+ * stream waits for the outstanding confirmations and goes back to the first unconfirmed
+ * fragment; the receiver drops the duplicates by sequence number.
+ *
+ * The queueing logic has no BLE dependencies: the stack is reached through
+ * ns_ble_stream_ops_t. ns_ble_create_stream_characteristic() (ns_ble.h) wires a stream to a
+ * notify characteristic.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_BLE_STREAM_H
+#define NS_BLE_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NS_BLE_STREAM_FRAG_START 0x80
+#define NS_BLE_STREAM_FRAG_END 0x40
+#define NS_BLE_STREAM_SEQ_MASK 0x3F
+
+/// ATT opcode and handle preceding the value of a notification
+#define NS_BLE_STREAM_ATT_OVERHEAD 3
+/// MTU before the exchange completes
+#define NS_BLE_STREAM_DEFAULT_MTU 23
+/// Largest MTU used, a notification then fills one 251 byte LL packet
+#define NS_BLE_STREAM_MAX_MTU 247
+/// Bounded by the sequence window the receiver can tell apart (half of 64)
+#define NS_BLE_STREAM_MAX_INFLIGHT 16
+
+/// Bytes of queue used by a frame of len bytes
+#define NS_BLE_STREAM_QUEUE_BYTES(len) ((len) + 2)
+
+/**
+ * @brief Stack operations used by the stream. send is only called between lock and unlock.
+ */
+typedef struct {
+    uint32_t (*send)(void *ctx, const uint8_t *data, uint16_t len); ///< Notify, 0 if accepted
+    uint32_t (*nowMs)(void *ctx);               ///< Optional clock for throughput statistics
+    uint32_t (*lock)(void *ctx);                ///< Enter critical section, returns state
+    void (*unlock)(void *ctx, uint32_t state);  ///< Leave critical section
+    void *ctx;                                  ///< Passed to every op
+} ns_ble_stream_ops_t;
+
+typedef struct {
+    // Config
+    uint8_t *queue;      ///< Frame queue storage
+    uint32_t queueSize;  ///< In bytes, see NS_BLE_STREAM_QUEUE_BYTES
+    uint8_t maxInFlight; ///< Notifications handed to the stack before a confirmation is needed
+                         ///< (at most ATT_NUM_SIMUL_NTF avoids overflow and retransmission)
+    ns_ble_stream_ops_t ops;
+
+    // Internal state
+    uint16_t mtu;
+    bool enabled;        ///< Client subscribed
+    bool recovering;     ///< Waiting for outstanding confirmations after a rejection
+    uint32_t head;       ///< Queue write position
+    uint32_t tail;       ///< Oldest frame not yet confirmed
+    uint32_t used;       ///< Queue bytes in use
+    uint32_t frames;     ///< Frames in the queue
+    uint32_t sendPos;    ///< Frame being fragmented
+    uint32_t unsent;     ///< Frames from sendPos on
+    uint16_t sendOffset; ///< Bytes of the sendPos frame already sent
+    uint16_t ackOffset;  ///< Bytes of the tail frame already confirmed
+    uint8_t sendSeq;
+    uint8_t ackSeq;
+    uint8_t generation;  ///< Bumped whenever sending goes back to the first unconfirmed fragment
+    uint8_t stale;       ///< Notifications from an older generation the stack may still confirm
+    uint8_t inFlight;    ///< Notifications of the current generation awaiting confirmation
+    uint8_t inFlightHead; ///< Oldest pending notification, the stale ones come first
+    uint8_t inFlightLen[NS_BLE_STREAM_MAX_INFLIGHT]; ///< Payload bytes of each fragment
+    bool inFlightEnd[NS_BLE_STREAM_MAX_INFLIGHT];    ///< Fragment completes its frame
+    uint8_t inFlightGen[NS_BLE_STREAM_MAX_INFLIGHT]; ///< Generation the fragment was sent in
+    bool timing;
+    uint8_t frag[NS_BLE_STREAM_MAX_MTU - NS_BLE_STREAM_ATT_OVERHEAD];
+
+    // Statistics
+    uint32_t framesQueued;   ///< Frames accepted by push
+    uint32_t framesSent;     ///< Frames fully confirmed
+    uint32_t framesDropped;  ///< Frames refused by push because the queue was full
+    uint32_t bytesSent;      ///< Payload bytes confirmed
+    uint32_t notifications;  ///< Notifications handed to the stack, including retransmissions
+    uint32_t rejected;       ///< Notifications the stack confirmed with an error
+    uint32_t retransmits;    ///< Times the stream went back to the first unconfirmed fragment
+    uint32_t lateConfirms;   ///< Confirmations of notifications sent before a timeout, ignored
+    uint32_t queueHighWater; ///< Most queue bytes used
+    uint32_t startMs;        ///< Time of the first notification
+    uint32_t lastAckMs;      ///< Time of the latest confirmation
+} ns_ble_stream_t;
+
+/// Reassembles frames from received fragments (the central's side of the stream)
+typedef struct {
+    // Config
+    uint8_t *buffer; ///< Frame storage
+    uint32_t size;   ///< Largest frame accepted
+
+    // Internal state
+    bool synced;      ///< A START fragment has been seen since reset
+    bool inFrame;
+    uint8_t expectedSeq;
+    uint16_t frameLen; ///< Length of the frame being (or last) reassembled
+    uint16_t received;
+
+    // Statistics
+    uint32_t frames;     ///< Frames completed
+    uint32_t duplicates; ///< Fragments dropped as retransmissions of ones already received
+    uint32_t skipped;    ///< Sequence gaps: fragments lost without confirmation (only possible
+                         ///< with maxInFlight > 1), the frame they belonged to is dropped
+    uint32_t errors;     ///< Malformed fragments and frames dropped for not fitting buffer
+} ns_ble_stream_rx_t;
+
+/**
+ * @brief Validate the config and reset the stream. queue, queueSize, maxInFlight and ops
+ * must be set. The stream starts disabled with the default MTU.
+ *
+ * @param s stream
+ * @return uint32_t NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+uint32_t ns_ble_stream_init(ns_ble_stream_t *s);
+
+/**
+ * @brief Queue a frame. The data is copied, call ns_ble_stream_pump to start sending.
+ *
+ * @param s stream
+ * @param data frame
+ * @param len frame length, up to 65535 bytes
+ * @return uint32_t NS_STATUS_SUCCESS, NS_STATUS_FAILURE if the queue is full or
+ * NS_STATUS_INVALID_CONFIG if the frame can never fit
+ */
+uint32_t ns_ble_stream_push(ns_ble_stream_t *s, const void *data, uint32_t len);
+
+/**
+ * @brief Hand fragments to the stack while there are credits and queued data
+ *
+ * @return uint32_t number of notifications sent
+ */
+uint32_t ns_ble_stream_pump(ns_ble_stream_t *s);
+
+/**
+ * @brief Notification confirmed by the stack (ATTS_HANDLE_VALUE_CNF), returns a credit
+ *
+ * @param s stream
+ * @param ok confirmation status was ATT_SUCCESS
+ */
+void ns_ble_stream_on_sent(ns_ble_stream_t *s, bool ok);
+
+/**
+ * @brief Confirmations stopped coming (e.g. the stack couldn't allocate a message): go back to
+ * the first unconfirmed fragment. Confirmations for the notifications already handed to the
+ * stack may still arrive late; they are ignored, and nothing is resent until they have arrived
+ * or the next timeout gives them up as lost.
+ */
+void ns_ble_stream_on_timeout(ns_ble_stream_t *s);
+
+/**
+ * @brief Use a new ATT MTU for the following fragments
+ */
+void ns_ble_stream_set_mtu(ns_ble_stream_t *s, uint16_t mtu);
+
+/**
+ * @brief Client subscribed or unsubscribed. Subscribing restarts the unconfirmed frame from
+ * its first fragment, as a new subscriber resets its reassembler.
+ */
+void ns_ble_stream_set_enabled(ns_ble_stream_t *s, bool enabled);
+
+/**
+ * @brief Connection closed: forget the notifications in flight, restart the unconfirmed frame
+ * from its first fragment and disable the stream. Queued frames are kept.
+ */
+void ns_ble_stream_link_reset(ns_ble_stream_t *s);
+
+/**
+ * @brief Queue bytes in use, including frames waiting for confirmation
+ */
+uint32_t ns_ble_stream_queue_depth(ns_ble_stream_t *s);
+
+/**
+ * @brief Confirmed payload bytes per second since the first notification, 0 without nowMs
+ */
+uint32_t ns_ble_stream_throughput(ns_ble_stream_t *s);
+
+/**
+ * @brief Reset a reassembler. buffer and size must be set.
+ */
+void ns_ble_stream_rx_reset(ns_ble_stream_rx_t *r);
+
+/**
+ * @brief Feed one received notification value to the reassembler
+ *
+ * @param r reassembler
+ * @param data notification value
+ * @param len notification value length
+ * @return true if a frame completed, it is in r->buffer with length r->frameLen
+ */
+bool ns_ble_stream_rx_push(ns_ble_stream_rx_t *r, const uint8_t *data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_BLE_STREAM_H
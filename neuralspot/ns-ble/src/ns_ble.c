@@ -9,6 +9,9 @@
  *
  */
 #include "ns_ble.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "wsf_math.h"
 
 const ns_core_api_t ns_ble_V0_0_1 = {.apiId = NS_BLE_API_ID, .version = NS_BLE_V0_0_1};
 
@@ -53,7 +56,7 @@ am_hal_mpu_attr_t sMPUAttr =
 };
 #endif
 
-static dmConnId_t currentConnId = 0;
+static dmConnId_t currentConnId = DM_CONN_ID_NONE;
 
 // *** Generic Default Configurations
 
@@ -387,7 +390,7 @@ static void ns_ble_generic_procMsg(ns_ble_msg_t *pMsg) {
         break;
 
     case DM_CONN_OPEN_IND:
-        currentConnId = pMsg->dm.connOpen.handle;
+        currentConnId = (dmConnId_t)pMsg->hdr.param;
         ns_ble_generic_conn_open((dmEvt_t *)pMsg);
         uiEvent = APP_UI_CONN_OPEN;
         break;
@@ -724,12 +727,96 @@ void ns_ble_new_handler_init(wsfHandlerId_t handlerId) {
     // ns_lp_printf("ns_ble_new_handler_init\n");
 }
 
-static void ns_ble_generic_new_handle_cnf(attEvt_t *pMsg){};
+// *** Streaming characteristics
+// Called with interrupts disabled by ns_ble_stream_pump
+static uint32_t ns_ble_stream_att_send(void *ctx, const uint8_t *data, uint16_t len) {
+    ns_ble_characteristic_t *c = ctx;
+    if ((currentConnId == DM_CONN_ID_NONE) || !AttsCccEnabled(currentConnId, c->cccIndex)) {
+        return NS_STATUS_FAILURE;
+    }
+    AttsHandleValueNtf(currentConnId, c->valueHandle, len, (uint8_t *)data);
+    // Confirmation watchdog
+    WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_ble_stream_now_ms(void *ctx) {
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+static uint32_t ns_ble_stream_lock_irq(void *ctx) { return am_hal_interrupt_master_disable(); }
+
+static void ns_ble_stream_unlock_irq(void *ctx, uint32_t state) {
+    am_hal_interrupt_master_set(state);
+}
+
+// Apply fn to every streaming characteristic
+static void ns_ble_for_each_stream(void (*fn)(ns_ble_characteristic_t *, uint32_t), uint32_t arg) {
+    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
+        ns_ble_service_t *service = g_ns_ble_control.services[i];
+        for (int j = 0; j < service->numCharacteristics; j++) {
+            if (service->characteristics[j]->stream != NULL) {
+                fn(service->characteristics[j], arg);
+            }
+        }
+    }
+}
+
+static void ns_ble_stream_set_mtu_cb(ns_ble_characteristic_t *c, uint32_t mtu) {
+    ns_ble_stream_set_mtu(c->stream, mtu);
+    ns_ble_stream_pump(c->stream);
+}
+
+static void ns_ble_stream_link_reset_cb(ns_ble_characteristic_t *c, uint32_t unused) {
+    WsfTimerStop(&c->indicationTimer);
+    ns_ble_stream_link_reset(c->stream);
+}
+
+static void ns_ble_generic_new_handle_cnf(attEvt_t *pMsg) {
+    ns_ble_characteristic_t *c = ns_ble_dispatch_get(&g_ns_ble_control.handleTable, pMsg->handle);
+    if ((c != NULL) && (c->stream != NULL) && (c->valueHandle == pMsg->handle)) {
+        // The confirmation returns a credit, refill the connection event
+        ns_ble_stream_on_sent(c->stream, pMsg->hdr.status == ATT_SUCCESS);
+        ns_ble_stream_pump(c->stream);
+        if ((c->stream->inFlight == 0) && (c->stream->stale == 0)) {
+            WsfTimerStop(&c->indicationTimer);
+        }
+    }
+}
+
+int ns_ble_create_stream_characteristic(
+    ns_ble_characteristic_t *c, char const *uuidString, ns_ble_stream_t *stream,
+    uint16_t timeoutMs, uint16_t *attributeCount) {
+    static uint8_t streamPlaceholder; // values are only ever notified, never stored
+    stream->ops.send = ns_ble_stream_att_send;
+    stream->ops.nowMs = ns_ble_stream_now_ms;
+    stream->ops.lock = ns_ble_stream_lock_irq;
+    stream->ops.unlock = ns_ble_stream_unlock_irq;
+    stream->ops.ctx = c;
+    if (ns_ble_stream_init(stream) != NS_STATUS_SUCCESS) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    NS_TRY(
+        ns_ble_create_characteristic(
+            c, uuidString, &streamPlaceholder, sizeof(streamPlaceholder), NS_BLE_NOTIFY, NULL,
+            NULL, NULL, timeoutMs ? timeoutMs : NS_BLE_STREAM_TIMEOUT_MS, true, attributeCount),
+        "Failed to create stream characteristic\n");
+    c->stream = stream;
+    return NS_STATUS_SUCCESS;
+}
+
+int ns_ble_send_stream(ns_ble_characteristic_t *c, const void *data, uint32_t len) {
+    if (ns_ble_stream_push(c->stream, data, len) != NS_STATUS_SUCCESS) {
+        return NS_STATUS_FAILURE;
+    }
+    ns_ble_stream_pump(c->stream);
+    return NS_STATUS_SUCCESS;
+}
 
 void ns_ble_send_value(ns_ble_characteristic_t *c, attEvt_t *pMsg) {
-    dmConnId_t connId = 1; //currentConnId;
+    dmConnId_t connId = currentConnId;
     // ns_lp_printf("ns_ble_send_value");
-    if (AttsCccEnabled(connId, c->indicationTimer.msg.status)) {
+    if ((connId != DM_CONN_ID_NONE) && AttsCccEnabled(connId, c->indicationTimer.msg.status)) {
         int ret = AttsSetAttr(c->valueHandle, c->valueLen, c->applicationValue);
         if (ret != ATT_SUCCESS) {
             ns_lp_printf("... failed to send\n");
@@ -743,53 +830,52 @@ void ns_ble_send_value(ns_ble_characteristic_t *c, attEvt_t *pMsg) {
 }
 
 static bool ns_ble_handle_indication_timer_expired(ns_ble_msg_t *pMsg) {
-    uint8_t event = pMsg->hdr.event;
-    ns_ble_service_t *service;
     // ns_lp_printf("ns_ble_handle_indication_timer_expired\n");
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->cccIndicationHandle == event) {
-                ns_ble_characteristic_t *c = service->characteristics[j];
-                // Found a match, handle timer expiry
-                // Call the callback to update the value of attribute
-                c->notifyHandlerCb(service, c);
-
-                // Send the value if not asynchronous
-                if (c->indicationIsAsynchronous == false) {
-                    ns_ble_send_value(c, (attEvt_t *)pMsg);
-                }
-
-                // Restart timer
-                WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
-                return true;
-            }
+    ns_ble_characteristic_t *c =
+        ns_ble_dispatch_get(&g_ns_ble_control.eventTable, pMsg->hdr.event);
+    if (c == NULL) {
+        return false;
+    }
+    if (c->stream != NULL) {
+        // No confirmation within the timeout, resend what is unconfirmed
+        ns_ble_stream_on_timeout(c->stream);
+        ns_ble_stream_pump(c->stream);
+        if (c->stream->stale) {
+            // Nothing resent until the stale notifications are confirmed or time out too
+            WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
         }
+        return true;
     }
-    return false;
+    // Call the callback to update the value of attribute
+    c->notifyHandlerCb(c->service, c);
+
+    // Send the value if not asynchronous
+    if (c->indicationIsAsynchronous == false) {
+        ns_ble_send_value(c, (attEvt_t *)pMsg);
+    }
+
+    // Restart timer
+    WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
+    return true;
 }
 
 static void ns_ble_process_ccc_state(attsCccEvt_t *pMsg) {
-    uint8_t idx = pMsg->idx;
-    ns_ble_service_t *service;
     // ns_lp_printf("ns_ble_process_ccc_state\n");
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            ns_ble_characteristic_t *c = service->characteristics[j];
-            // ns_lp_printf("webbleProcessCccState: %d %d %d\n", j, idx, c->cccIndex);
-            if (service->characteristics[j]->cccIndex == idx) {
-                if (pMsg->value == ATT_CLIENT_CFG_NOTIFY) {
-                    // Start the timer
-                    ns_lp_printf("webbleStartTimer\n");
-                    WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
-                } else {
-                    // Stop the timer
-                    ns_lp_printf("webbleStopTimer\n");
-                    WsfTimerStop(&c->indicationTimer);
-                }
-            }
-        }
+    ns_ble_characteristic_t *c = ns_ble_dispatch_get(&g_ns_ble_control.cccTable, pMsg->idx);
+    if (c == NULL) {
+        return;
+    }
+    if (c->stream != NULL) {
+        ns_ble_stream_set_enabled(c->stream, pMsg->value == ATT_CLIENT_CFG_NOTIFY);
+        ns_ble_stream_pump(c->stream);
+    } else if (pMsg->value == ATT_CLIENT_CFG_NOTIFY) {
+        // Start the timer
+        ns_lp_printf("webbleStartTimer\n");
+        WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
+    } else {
+        // Stop the timer
+        ns_lp_printf("webbleStopTimer\n");
+        WsfTimerStop(&c->indicationTimer);
     }
 }
 
@@ -799,13 +885,18 @@ bool ns_ble_new_proc_msg(ns_ble_msg_t *pMsg) {
     // ns_lp_printf("ns_ble_new_proc_msg: %d\n", pMsg->hdr.event);
     switch (pMsg->hdr.event) {
     case DM_CONN_OPEN_IND:
-        currentConnId = pMsg->dm.connOpen.handle;
+        currentConnId = (dmConnId_t)pMsg->hdr.param;
         ns_ble_generic_conn_open((dmEvt_t *)pMsg);
-        DmConnSetDataLen(1, 251, 0x848);
+        DmConnSetDataLen(currentConnId, 251, 0x848);
         break;
 
     case DM_CONN_CLOSE_IND:
-        // amdtps_conn_close((dmEvt_t *) pMsg);
+        currentConnId = DM_CONN_ID_NONE;
+        ns_ble_for_each_stream(ns_ble_stream_link_reset_cb, 0);
+        break;
+
+    case ATT_MTU_UPDATE_IND:
+        ns_ble_for_each_stream(ns_ble_stream_set_mtu_cb, pMsg->att.mtu);
         break;
 
     case ATTS_CCC_STATE_IND:
@@ -865,16 +956,9 @@ uint8_t ns_ble_generic_write_cback(
     dmConnId_t connId, uint16_t handle, uint8_t operation, uint16_t offset, uint16_t len,
     uint8_t *pValue, attsAttr_t *pAttr) {
     // ns_lp_printf("ns_ble_generic_write_cback, handle %d\n", handle);
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        ns_ble_service_t *service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->valueHandle == handle) {
-                if (service->characteristics[j]->writeHandlerCb) {
-                    return service->characteristics[j]->writeHandlerCb(
-                        service, service->characteristics[j], pValue);
-                }
-            }
-        }
+    ns_ble_characteristic_t *c = ns_ble_dispatch_get(&g_ns_ble_control.handleTable, handle);
+    if ((c != NULL) && (c->valueHandle == handle) && c->writeHandlerCb) {
+        return c->writeHandlerCb(c->service, c, pValue);
     }
 
     return ATT_ERR_HANDLE;
@@ -883,16 +967,9 @@ uint8_t ns_ble_generic_write_cback(
 uint8_t ns_ble_generic_read_cback(
     dmConnId_t connId, uint16_t handle, uint8_t operation, uint16_t offset, attsAttr_t *pAttr) {
     // ns_lp_printf("ns_ble_generic_read_cback, handle %d\n", handle);
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        ns_ble_service_t *service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->valueHandle == handle) {
-                if (service->characteristics[j]->readHandlerCb) {
-                    return service->characteristics[j]->readHandlerCb(
-                        service, service->characteristics[j], pAttr->pValue);
-                }
-            }
-        }
+    ns_ble_characteristic_t *c = ns_ble_dispatch_get(&g_ns_ble_control.handleTable, handle);
+    if ((c != NULL) && (c->valueHandle == handle) && c->readHandlerCb) {
+        return c->readHandlerCb(c->service, c, pAttr->pValue);
     }
     ns_lp_printf("ns_ble_generic_read_cback, handle %d, not found\n", handle);
     return ATT_ERR_HANDLE;
@@ -1025,6 +1102,7 @@ int ns_ble_create_characteristic(
     c->readHandlerCb = readHandlerCb;
     c->writeHandlerCb = writeHandlerCb;
     c->notifyHandlerCb = notifyHandlerCb;
+    c->stream = NULL; // only ns_ble_create_stream_characteristic attaches a stream
 
     // *** Remember mem location of attribute's value
     // (different from WSF 'value', which is a placeholder)
@@ -1141,11 +1219,74 @@ int ns_ble_add_characteristic(ns_ble_service_t *s, ns_ble_characteristic_t *c) {
     }
 
     // Add Characteristic to Service Characteristic List
+    c->service = s;
     s->characteristics[s->nextCharacteristicIndex++] = c;
 
     return NS_STATUS_SUCCESS;
 }
 
+// (Re)allocate a dispatch table for keys first..last, empty if last < first
+static int ns_ble_dispatch_alloc(ns_ble_dispatch_table_t *t, uint16_t first, uint16_t last) {
+    uint16_t count = (last >= first) ? last - first + 1 : 0;
+    void **storage = NULL;
+    if (t->entries != NULL) {
+        ns_free(t->entries);
+    }
+    if (count) {
+        storage = ns_malloc(sizeof(void *) * count);
+        if (storage == NULL) {
+            ns_ble_dispatch_init(t, NULL, first, 0);
+            return NS_STATUS_FAILURE;
+        }
+    }
+    ns_ble_dispatch_init(t, storage, first, count);
+    return NS_STATUS_SUCCESS;
+}
+
+// Map the attribute handles, CCC indices and timer events of every characteristic of every
+// service to the characteristic, so dispatch doesn't have to search for it
+static int ns_ble_build_dispatch_tables(void) {
+    uint16_t firstHandle = 0xFFFF, lastHandle = 0;
+    uint16_t firstEvent = 0xFFFF, lastEvent = 0;
+    uint16_t lastCcc = 0;
+
+    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
+        ns_ble_service_t *service = g_ns_ble_control.services[i];
+        firstHandle = WSF_MIN(firstHandle, service->baseHandle);
+        lastHandle = WSF_MAX(lastHandle, service->nextHandleId - 1);
+        for (int j = 0; j < service->nextCharacteristicIndex; j++) {
+            ns_ble_characteristic_t *c = service->characteristics[j];
+            if (c->ccc.pUuid != NULL) {
+                firstEvent = WSF_MIN(firstEvent, c->cccIndicationHandle);
+                lastEvent = WSF_MAX(lastEvent, c->cccIndicationHandle);
+                lastCcc = WSF_MAX(lastCcc, c->cccIndex);
+            }
+        }
+    }
+
+    // CCC index 0 is the GATT service changed descriptor
+    if (ns_ble_dispatch_alloc(&g_ns_ble_control.handleTable, firstHandle, lastHandle) ||
+        ns_ble_dispatch_alloc(&g_ns_ble_control.cccTable, 1, lastCcc) ||
+        ns_ble_dispatch_alloc(&g_ns_ble_control.eventTable, firstEvent, lastEvent)) {
+        return NS_STATUS_FAILURE;
+    }
+
+    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
+        ns_ble_service_t *service = g_ns_ble_control.services[i];
+        for (int j = 0; j < service->nextCharacteristicIndex; j++) {
+            ns_ble_characteristic_t *c = service->characteristics[j];
+            ns_ble_dispatch_set(&g_ns_ble_control.handleTable, c->declarationHandle, c);
+            ns_ble_dispatch_set(&g_ns_ble_control.handleTable, c->valueHandle, c);
+            if (c->ccc.pUuid != NULL) {
+                ns_ble_dispatch_set(&g_ns_ble_control.handleTable, c->cccHandle, c);
+                ns_ble_dispatch_set(&g_ns_ble_control.cccTable, c->cccIndex, c);
+                ns_ble_dispatch_set(&g_ns_ble_control.eventTable, c->cccIndicationHandle, c);
+            }
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
 int ns_ble_start_service(ns_ble_service_t *s) {
     // *** Finish creating Service structures, then kick it off
     if (s->nextCharacteristicIndex != s->numCharacteristics) {
@@ -1162,6 +1303,11 @@ int ns_ble_start_service(ns_ble_service_t *s) {
     s->group.startHandle = s->baseHandle;
     s->group.endHandle = s->nextHandleId - 1;
 
+    if (ns_ble_build_dispatch_tables() != NS_STATUS_SUCCESS) {
+        ns_lp_printf("ns_ble_start_service: out of memory for dispatch tables\n");
+        return NS_STATUS_FAILURE;
+    }
+
     AttsAddGroup(&(s->group));
     GattSetSvcChangedIdx(0); // TODO something better here
 
@@ -0,0 +1,32 @@
+/**
+ * @file ns_ble_dispatch.c
+ * @author Ambiq
+ * @brief Dense lookup tables for ns-ble event dispatch
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_ble_dispatch.h"
+#include "ns_core.h"
+
+void ns_ble_dispatch_init(
+    ns_ble_dispatch_table_t *t, void **storage, uint16_t first, uint16_t count) {
+    t->first = first;
+    t->count = (storage != NULL) ? count : 0;
+    t->entries = storage;
+    for (uint16_t i = 0; i < t->count; i++) {
+        storage[i] = NULL;
+    }
+}
+
+uint32_t ns_ble_dispatch_set(ns_ble_dispatch_table_t *t, uint16_t key, void *entry) {
+    const uint16_t i = (uint16_t)(key - t->first);
+    if (i >= t->count) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    t->entries[i] = entry;
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,402 @@
+/**
+ * @file ns_ble_stream.c
+ * @author Ambiq
+ * @brief Credit-based BLE notification streaming
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_ble_stream.h"
+#include "ns_core.h"
+#include <string.h>
+
+// Fragment header bytes: flags/sequence, plus the frame length on START fragments
+#define NS_BLE_STREAM_HDR 1
+#define NS_BLE_STREAM_START_HDR 3
+
+static uint32_t ns_ble_stream_lock(ns_ble_stream_t *s) {
+    return s->ops.lock ? s->ops.lock(s->ops.ctx) : 0;
+}
+
+static void ns_ble_stream_unlock(ns_ble_stream_t *s, uint32_t state) {
+    if (s->ops.unlock) {
+        s->ops.unlock(s->ops.ctx, state);
+    }
+}
+
+static uint32_t ns_ble_stream_now(ns_ble_stream_t *s) {
+    return s->ops.nowMs ? s->ops.nowMs(s->ops.ctx) : 0;
+}
+
+static inline uint32_t ns_ble_stream_wrap(ns_ble_stream_t *s, uint32_t pos) {
+    return (pos >= s->queueSize) ? pos - s->queueSize : pos;
+}
+
+static uint16_t ns_ble_stream_frame_len(ns_ble_stream_t *s, uint32_t pos) {
+    return s->queue[pos] | (s->queue[ns_ble_stream_wrap(s, pos + 1)] << 8);
+}
+
+// Copy len bytes at queue position pos (wrapping) to dst
+static void ns_ble_stream_copy_out(ns_ble_stream_t *s, uint32_t pos, uint8_t *dst, uint32_t len) {
+    uint32_t first = s->queueSize - pos;
+    if (first >= len) {
+        memcpy(dst, &s->queue[pos], len);
+    } else {
+        memcpy(dst, &s->queue[pos], first);
+        memcpy(dst + first, s->queue, len - first);
+    }
+}
+
+static void ns_ble_stream_copy_in(
+    ns_ble_stream_t *s, uint32_t pos, const uint8_t *src, uint32_t len) {
+    uint32_t first = s->queueSize - pos;
+    if (first >= len) {
+        memcpy(&s->queue[pos], src, len);
+    } else {
+        memcpy(&s->queue[pos], src, first);
+        memcpy(s->queue, src + first, len - first);
+    }
+}
+
+// Resume sending at the first unconfirmed fragment. Caller holds the lock. Notifications
+// still in flight become stale: the stack may yet confirm them, and those confirmations must
+// not be taken for the resent fragments.
+static void ns_ble_stream_rewind(ns_ble_stream_t *s) {
+    s->sendPos = s->tail;
+    s->unsent = s->frames;
+    s->sendOffset = s->ackOffset;
+    s->sendSeq = s->ackSeq;
+    s->stale += s->inFlight;
+    s->inFlight = 0;
+    s->generation++;
+    s->recovering = false;
+}
+
+// Nothing pending in the stack any more (link reset), or stale notifications given up as lost
+static void ns_ble_stream_forget_stale(ns_ble_stream_t *s) {
+    s->inFlightHead = (s->inFlightHead + s->stale) % NS_BLE_STREAM_MAX_INFLIGHT;
+    s->stale = 0;
+}
+
+// Restart the unconfirmed frame from its START fragment, for a fresh receiver
+static void ns_ble_stream_restart(ns_ble_stream_t *s) {
+    s->ackOffset = 0;
+    s->ackSeq = 0;
+    ns_ble_stream_rewind(s);
+}
+
+uint32_t ns_ble_stream_init(ns_ble_stream_t *s) {
+    if (s == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((s->queue == NULL) || (s->queueSize < NS_BLE_STREAM_QUEUE_BYTES(1)) ||
+        (s->maxInFlight == 0) || (s->maxInFlight > NS_BLE_STREAM_MAX_INFLIGHT) ||
+        (s->ops.send == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    s->mtu = NS_BLE_STREAM_DEFAULT_MTU;
+    s->enabled = false;
+    s->head = 0;
+    s->tail = 0;
+    s->used = 0;
+    s->frames = 0;
+    s->timing = false;
+    s->generation = 0;
+    s->stale = 0;
+    s->inFlight = 0;
+    s->inFlightHead = 0;
+    ns_ble_stream_restart(s);
+
+    s->framesQueued = 0;
+    s->framesSent = 0;
+    s->framesDropped = 0;
+    s->bytesSent = 0;
+    s->notifications = 0;
+    s->rejected = 0;
+    s->retransmits = 0;
+    s->lateConfirms = 0;
+    s->queueHighWater = 0;
+    s->startMs = 0;
+    s->lastAckMs = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ble_stream_push(ns_ble_stream_t *s, const void *data, uint32_t len) {
+    const uint32_t need = NS_BLE_STREAM_QUEUE_BYTES(len);
+    if ((len > 0xFFFF) || (need > s->queueSize)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    uint32_t state = ns_ble_stream_lock(s);
+    if (s->used + need > s->queueSize) {
+        s->framesDropped++;
+        ns_ble_stream_unlock(s, state);
+        return NS_STATUS_FAILURE;
+    }
+    const uint8_t hdr[2] = {len & 0xFF, len >> 8};
+    ns_ble_stream_copy_in(s, s->head, hdr, 2);
+    ns_ble_stream_copy_in(s, ns_ble_stream_wrap(s, s->head + 2), data, len);
+    s->head = ns_ble_stream_wrap(s, s->head + need);
+    s->used += need;
+    s->frames++;
+    s->unsent++;
+    s->framesQueued++;
+    if (s->used > s->queueHighWater) {
+        s->queueHighWater = s->used;
+    }
+    ns_ble_stream_unlock(s, state);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ble_stream_pump(ns_ble_stream_t *s) {
+    uint32_t sent = 0;
+    uint32_t state = ns_ble_stream_lock(s);
+
+    // After a timeout, wait for the stale notifications first: they still hold stack buffers
+    while (s->enabled && !s->recovering && !s->stale && s->unsent &&
+           (s->inFlight < s->maxInFlight)) {
+        const uint16_t frameLen = ns_ble_stream_frame_len(s, s->sendPos);
+        uint32_t room = s->mtu - NS_BLE_STREAM_ATT_OVERHEAD;
+        uint32_t hdrLen = NS_BLE_STREAM_HDR;
+
+        s->frag[0] = s->sendSeq;
+        if (s->sendOffset == 0) {
+            s->frag[0] |= NS_BLE_STREAM_FRAG_START;
+            s->frag[1] = frameLen & 0xFF;
+            s->frag[2] = frameLen >> 8;
+            hdrLen = NS_BLE_STREAM_START_HDR;
+        }
+        room -= hdrLen;
+        uint32_t n = frameLen - s->sendOffset;
+        if (n > room) {
+            n = room;
+        }
+        const bool end = (s->sendOffset + n == frameLen);
+        if (end) {
+            s->frag[0] |= NS_BLE_STREAM_FRAG_END;
+        }
+        ns_ble_stream_copy_out(
+            s, ns_ble_stream_wrap(s, s->sendPos + 2 + s->sendOffset), &s->frag[hdrLen], n);
+
+        if (s->ops.send(s->ops.ctx, s->frag, hdrLen + n) != 0) {
+            break; // not connected or not subscribed, the next pump retries
+        }
+
+        if (!s->timing) {
+            s->timing = true;
+            s->startMs = ns_ble_stream_now(s);
+        }
+        uint8_t slot = (s->inFlightHead + s->inFlight) % NS_BLE_STREAM_MAX_INFLIGHT;
+        s->inFlightLen[slot] = n;
+        s->inFlightEnd[slot] = end;
+        s->inFlightGen[slot] = s->generation;
+        s->inFlight++;
+        s->notifications++;
+        s->sendSeq = (s->sendSeq + 1) & NS_BLE_STREAM_SEQ_MASK;
+        if (end) {
+            s->sendPos = ns_ble_stream_wrap(s, s->sendPos + NS_BLE_STREAM_QUEUE_BYTES(frameLen));
+            s->sendOffset = 0;
+            s->unsent--;
+        } else {
+            s->sendOffset += n;
+        }
+        sent++;
+    }
+
+    ns_ble_stream_unlock(s, state);
+    return sent;
+}
+
+// Oldest fragment in flight was confirmed: free its frame once the last fragment is
+static void ns_ble_stream_ack(ns_ble_stream_t *s) {
+    const uint8_t slot = s->inFlightHead;
+    s->inFlightHead = (slot + 1) % NS_BLE_STREAM_MAX_INFLIGHT;
+    s->ackOffset += s->inFlightLen[slot];
+    s->ackSeq = (s->ackSeq + 1) & NS_BLE_STREAM_SEQ_MASK;
+    s->bytesSent += s->inFlightLen[slot];
+    if (s->inFlightEnd[slot]) {
+        const uint32_t bytes = NS_BLE_STREAM_QUEUE_BYTES(ns_ble_stream_frame_len(s, s->tail));
+        s->tail = ns_ble_stream_wrap(s, s->tail + bytes);
+        s->used -= bytes;
+        s->frames--;
+        s->ackOffset = 0;
+        s->framesSent++;
+    }
+}
+
+void ns_ble_stream_on_sent(ns_ble_stream_t *s, bool ok) {
+    uint32_t state = ns_ble_stream_lock(s);
+    if ((s->stale + s->inFlight) == 0) {
+        ns_ble_stream_unlock(s, state); // left over from before a link reset
+        return;
+    }
+    if (s->inFlightGen[s->inFlightHead] != s->generation) {
+        // Sent before a timeout, its fragment is (or will be) resent
+        s->inFlightHead = (s->inFlightHead + 1) % NS_BLE_STREAM_MAX_INFLIGHT;
+        s->stale--;
+        s->lateConfirms++;
+        ns_ble_stream_unlock(s, state);
+        return;
+    }
+
+    // Cordio confirms accepted notifications in order, but a rejection can overtake the
+    // confirmation of an earlier notification that is pending on flow control. So after a
+    // rejection nothing is acknowledged or sent until every notification in flight is
+    // accounted for, then sending resumes at the first unconfirmed fragment.
+    if (!ok) {
+        s->rejected++;
+        s->recovering = true;
+    }
+    if (s->recovering) {
+        s->inFlightHead = (s->inFlightHead + 1) % NS_BLE_STREAM_MAX_INFLIGHT;
+        if (--s->inFlight == 0) {
+            ns_ble_stream_rewind(s);
+            s->retransmits++;
+        }
+    } else {
+        ns_ble_stream_ack(s);
+        s->inFlight--;
+        s->lastAckMs = ns_ble_stream_now(s);
+    }
+    ns_ble_stream_unlock(s, state);
+}
+
+void ns_ble_stream_on_timeout(ns_ble_stream_t *s) {
+    uint32_t state = ns_ble_stream_lock(s);
+    // Stale notifications had a whole timeout to be confirmed: they were lost
+    ns_ble_stream_forget_stale(s);
+    if (s->inFlight) {
+        ns_ble_stream_rewind(s);
+        s->retransmits++;
+    }
+    ns_ble_stream_unlock(s, state);
+}
+
+void ns_ble_stream_set_mtu(ns_ble_stream_t *s, uint16_t mtu) {
+    if (mtu > NS_BLE_STREAM_MAX_MTU) {
+        mtu = NS_BLE_STREAM_MAX_MTU;
+    }
+    if (mtu < NS_BLE_STREAM_DEFAULT_MTU) {
+        mtu = NS_BLE_STREAM_DEFAULT_MTU;
+    }
+    uint32_t state = ns_ble_stream_lock(s);
+    s->mtu = mtu;
+    ns_ble_stream_unlock(s, state);
+}
+
+void ns_ble_stream_set_enabled(ns_ble_stream_t *s, bool enabled) {
+    uint32_t state = ns_ble_stream_lock(s);
+    if (enabled && !s->enabled && (s->inFlight == 0)) {
+        ns_ble_stream_restart(s);
+    }
+    s->enabled = enabled;
+    ns_ble_stream_unlock(s, state);
+}
+
+void ns_ble_stream_link_reset(ns_ble_stream_t *s) {
+    uint32_t state = ns_ble_stream_lock(s);
+    s->enabled = false;
+    s->mtu = NS_BLE_STREAM_DEFAULT_MTU;
+    ns_ble_stream_restart(s);
+    ns_ble_stream_forget_stale(s);
+    ns_ble_stream_unlock(s, state);
+}
+
+uint32_t ns_ble_stream_queue_depth(ns_ble_stream_t *s) { return s->used; }
+
+uint32_t ns_ble_stream_throughput(ns_ble_stream_t *s) {
+    uint32_t elapsed = s->lastAckMs - s->startMs;
+    if (!s->timing || (elapsed == 0)) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)s->bytesSent * 1000 / elapsed);
+}
+
+void ns_ble_stream_rx_reset(ns_ble_stream_rx_t *r) {
+    r->synced = false;
+    r->inFrame = false;
+    r->expectedSeq = 0;
+    r->frameLen = 0;
+    r->received = 0;
+    r->frames = 0;
+    r->duplicates = 0;
+    r->skipped = 0;
+    r->errors = 0;
+}
+
+bool ns_ble_stream_rx_push(ns_ble_stream_rx_t *r, const uint8_t *data, uint16_t len) {
+    if (len < NS_BLE_STREAM_HDR) {
+        r->errors++;
+        return false;
+    }
+    const uint8_t flags = data[0];
+    const uint8_t seq = flags & NS_BLE_STREAM_SEQ_MASK;
+
+    if (!r->synced) {
+        if (!(flags & NS_BLE_STREAM_FRAG_START)) {
+            r->skipped++;
+            return false;
+        }
+        r->synced = true;
+        r->expectedSeq = seq;
+    }
+    const uint8_t ahead = (seq - r->expectedSeq) & NS_BLE_STREAM_SEQ_MASK;
+    if (ahead > NS_BLE_STREAM_SEQ_MASK / 2) {
+        r->duplicates++; // resent after a rejection
+        return false;
+    }
+    if (ahead) {
+        // A notification the stack dropped without confirming: lose the partial frame and
+        // resynchronize on the next START
+        r->skipped++;
+        r->inFrame = false;
+        if (!(flags & NS_BLE_STREAM_FRAG_START)) {
+            return false;
+        }
+    }
+    r->expectedSeq = (seq + 1) & NS_BLE_STREAM_SEQ_MASK;
+
+    if (flags & NS_BLE_STREAM_FRAG_START) {
+        if (len < NS_BLE_STREAM_START_HDR) {
+            r->errors++;
+            r->inFrame = false;
+            return false;
+        }
+        r->frameLen = data[1] | (data[2] << 8);
+        r->received = 0;
+        r->inFrame = (r->frameLen <= r->size);
+        if (!r->inFrame) {
+            r->errors++;
+            return false;
+        }
+        data += NS_BLE_STREAM_START_HDR;
+        len -= NS_BLE_STREAM_START_HDR;
+    } else if (!r->inFrame) {
+        return false; // rest of a frame that was dropped
+    } else {
+        data += NS_BLE_STREAM_HDR;
+        len -= NS_BLE_STREAM_HDR;
+    }
+
+    if (r->received + len > r->frameLen) {
+        r->errors++;
+        r->inFrame = false;
+        return false;
+    }
+    memcpy(&r->buffer[r->received], data, len);
+    r->received += len;
+
+    if (flags & NS_BLE_STREAM_FRAG_END) {
+        r->inFrame = false;
+        if (r->received != r->frameLen) {
+            r->errors++;
+            return false;
+        }
+        r->frames++;
+        return true;
+    }
+    return false;
+}
@@ -11,6 +11,7 @@
 #ifndef __CAMERA_H
 #define __CAMERA_H
 
+#include "ns_camera_pipeline.h"
 #include "ns_core.h"
 #include "ns_spi.h"
 #include "arm_math.h"
@@ -155,12 +156,25 @@ uint32_t ns_transfer_picture(
  * @param cfg
  * @param camBuf Buffer to store image
  * @param buffer_offset Returned value of buffer offset
- * @param bufLen Length of buffer
- * @return uint32_t Total size of image in bytes
+ * @param bufLen Length of buffer, at most this many bytes are transferred
+ * @return uint32_t Total size of image in bytes (may exceed bufLen)
  */
 uint32_t ns_start_dma_read(
     ns_camera_config_t *cfg, uint8_t *camBuf, uint32_t *buffer_offset, uint32_t bufLen);
 
+/**
+ * @brief Drive a double-buffered capture pipeline (see ns_camera_pipeline.h) with this camera
+ *
+ * Fills in the pipeline's ops and takes over cfg's pictureTakenCb and dmaCompleteCb, so it
+ * must be called before ns_camera_init. The pipeline's buffers, bufferSize and dropStale
+ * must already be set; the pipeline is initialized here.
+ *
+ * @param cfg camera config
+ * @param pipeline pipeline to attach
+ * @return uint32_t status
+ */
+uint32_t ns_camera_pipeline_attach(ns_camera_config_t *cfg, ns_camera_pipeline_t *pipeline);
+
 // uint32_t ns_camera_capture(ns_camera_config_t *cfg, uint8_t *camBuf, uint32_t bufLen);
 
 /**
@@ -172,7 +186,9 @@ uint32_t ns_start_dma_read(
  * @param imgWidth Width of RGB565 image
  * @param imgHeight Height of RGB565 image
  * @param scaleFactor Scale factor to reduce image size
- * @return int
+ * @return int 0 on success, -1 if the JPG headers couldn't be parsed
+ *
+ * Only the MCUs in the center crop are fully decoded, the rest are entropy decoded and skipped.
  */
 int camera_decode_image(
     uint8_t *camBuf, uint32_t camLen, uint8_t *imgBuf, uint32_t imgWidth, uint32_t imgHeight,
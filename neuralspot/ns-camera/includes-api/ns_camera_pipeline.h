@@ -0,0 +1,176 @@
+/**
+ * @file ns_camera_pipeline.h
+ * @author Ambiq
+ * @brief Double-buffered camera capture pipeline
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Capturing a frame, DMAing it out of the camera, and decoding/inferring on it are
+ * independent: the camera can expose frame N+1 and its FIFO can be read into a second
+ * buffer while the application works on frame N. The pipeline keeps two frame buffers
+ * and runs that state machine, handing completed frames to the application through a
+ * ready queue, so frame rate approaches 1/max(capture + transfer, processing) instead of
+ * 1/(capture + transfer + processing).
+ *
+ * The state machine is hardware independent: it drives the camera through
+ * ns_camera_pipeline_ops_t and is told about completions through
+ * ns_camera_pipeline_on_captured() and ns_camera_pipeline_on_read_done(). For the
+ * Arducam, ns_camera_pipeline_attach() (ns_camera.h) fills in the ops and hooks the
+ * ns_camera callbacks.
+ *
+ * @code
+ * ns_camera_pipeline_attach(&camera_config, &pipeline); // before ns_camera_init
+ * ns_camera_init(&camera_config);
+ * ns_start_camera(&camera_config);
+ * ns_camera_pipeline_start(&pipeline);
+ * while (1) {
+ *     ns_camera_frame_t frame;
+ *     if (ns_camera_pipeline_get_frame(&pipeline, &frame)) {
+ *         // decode and infer on frame.buffer + frame.offset, next frame is captured meanwhile
+ *         ns_camera_pipeline_release_frame(&pipeline, &frame);
+ *     }
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_CAMERA_PIPELINE_H
+#define NS_CAMERA_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NS_CAMERA_PIPELINE_BUFFERS 2
+
+typedef enum {
+    NS_CAMERA_BUF_FREE = 0, ///< Available for the next transfer
+    NS_CAMERA_BUF_FILLING,  ///< Camera FIFO is being read into it
+    NS_CAMERA_BUF_READY,    ///< Holds a complete frame, queued for the application
+    NS_CAMERA_BUF_IN_USE,   ///< Handed to the application by ns_camera_pipeline_get_frame
+} ns_camera_buf_state_e;
+
+typedef enum {
+    NS_CAMERA_PIPE_IDLE = 0,  ///< Camera is not capturing
+    NS_CAMERA_PIPE_CAPTURING, ///< Exposure in progress
+    NS_CAMERA_PIPE_CAPTURED,  ///< Frame waiting in the camera FIFO for a free buffer
+    NS_CAMERA_PIPE_READING,   ///< Camera FIFO is being read
+} ns_camera_pipe_state_e;
+
+/**
+ * @brief Camera operations used by the pipeline. start_read and the lock functions may be
+ * called from the completion callbacks (interrupt context), start_capture is only called
+ * from ns_camera_pipeline_start/service/get_frame/release_frame.
+ */
+typedef struct {
+    uint32_t (*startCapture)(void *ctx); ///< Trigger a capture, 0 on success
+    uint32_t (*startRead)(void *ctx, uint8_t *buf, uint32_t bufLen); ///< Start reading the FIFO
+    uint32_t (*lock)(void *ctx);                 ///< Enter critical section, returns state
+    void (*unlock)(void *ctx, uint32_t state);   ///< Leave critical section
+    void *ctx;                                   ///< Passed to every op
+} ns_camera_pipeline_ops_t;
+
+/// A frame handed to the application
+typedef struct {
+    uint8_t *buffer;   ///< Frame buffer
+    uint32_t offset;   ///< Start of image data in buffer (1 for Arducam JPEGs)
+    uint32_t length;   ///< Bytes of buffer used, including offset
+    uint32_t sequence; ///< Capture sequence number, starting at 0
+    uint8_t index;     ///< Buffer index, used by release_frame
+} ns_camera_frame_t;
+
+typedef struct {
+    // Config
+    uint8_t *buffers[NS_CAMERA_PIPELINE_BUFFERS]; ///< Frame buffers
+    uint32_t bufferSize;                          ///< Size of each frame buffer, in bytes
+    bool dropStale; ///< Overwrite the oldest unclaimed frame instead of waiting for one to be
+                    ///< released (lowest latency rather than every frame)
+    ns_camera_pipeline_ops_t ops;
+
+    // Internal state
+    volatile ns_camera_pipe_state_e state;
+    volatile ns_camera_buf_state_e bufState[NS_CAMERA_PIPELINE_BUFFERS];
+    uint32_t bufOffset[NS_CAMERA_PIPELINE_BUFFERS];
+    uint32_t bufLength[NS_CAMERA_PIPELINE_BUFFERS];
+    uint32_t bufSequence[NS_CAMERA_PIPELINE_BUFFERS];
+    int8_t filling;         ///< Buffer being read into, -1 if none
+    bool running;           ///< Captures are triggered while running
+    uint32_t nextSequence;  ///< Sequence number of the next capture
+
+    // Statistics
+    uint32_t framesCaptured;  ///< Captures completed
+    uint32_t framesDelivered; ///< Frames returned by get_frame
+    uint32_t framesDropped;   ///< Frames overwritten by dropStale
+    uint32_t stalls;          ///< Captures that had to wait for a free buffer
+} ns_camera_pipeline_t;
+
+/**
+ * @brief Validate the config and reset the pipeline state. buffers, bufferSize, dropStale and
+ * ops must be set.
+ *
+ * @param p pipeline
+ * @return uint32_t NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+uint32_t ns_camera_pipeline_init(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Start capturing. Captures continue back to back until ns_camera_pipeline_stop.
+ *
+ * @param p pipeline
+ * @return uint32_t status of the first capture trigger
+ */
+uint32_t ns_camera_pipeline_start(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Stop triggering new captures. A capture or transfer in flight still completes.
+ */
+void ns_camera_pipeline_stop(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Trigger the next capture if the camera is idle. get_frame and release_frame call
+ * this; call it from the main loop when not polling for frames.
+ */
+void ns_camera_pipeline_service(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Take the oldest ready frame. The buffer belongs to the application until released.
+ *
+ * @param p pipeline
+ * @param frame filled in on success
+ * @return true if a frame was available
+ */
+bool ns_camera_pipeline_get_frame(ns_camera_pipeline_t *p, ns_camera_frame_t *frame);
+
+/**
+ * @brief Give a frame's buffer back to the pipeline
+ */
+void ns_camera_pipeline_release_frame(ns_camera_pipeline_t *p, const ns_camera_frame_t *frame);
+
+/**
+ * @brief Number of frames waiting to be taken by get_frame
+ */
+uint32_t ns_camera_pipeline_frames_ready(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Capture-complete event, called by the camera driver (may be interrupt context)
+ */
+void ns_camera_pipeline_on_captured(ns_camera_pipeline_t *p);
+
+/**
+ * @brief Transfer-complete event, called by the camera driver (may be interrupt context)
+ *
+ * @param p pipeline
+ * @param offset start of image data in the buffer
+ * @param length bytes of the buffer used, including offset
+ */
+void ns_camera_pipeline_on_read_done(ns_camera_pipeline_t *p, uint32_t offset, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_CAMERA_PIPELINE_H
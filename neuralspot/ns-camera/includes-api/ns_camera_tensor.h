@@ -0,0 +1,90 @@
+/**
+ * @file ns_camera_tensor.h
+ * @author Ambiq
+ * @brief Decode a JPEG straight into a quantized model input tensor
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Instead of decoding to an RGB565 frame, point-sampling it and converting that to
+ * the model's input type, ns_camera_decode_to_tensor() area-averages each decoded MCU
+ * into a small band of accumulators and writes finished rows directly into an
+ * int8/uint8 HWC tensor.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_CAMERA_TENSOR_H
+#define NS_CAMERA_TENSOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    NS_CAMERA_TENSOR_RGB = 0,       ///< 3 channels, R G B
+    NS_CAMERA_TENSOR_GRAYSCALE = 1, ///< 1 channel, luma
+} ns_camera_tensor_color_e;
+
+typedef enum {
+    NS_CAMERA_TENSOR_OK = 0,
+    NS_CAMERA_TENSOR_BAD_JPEG = -1,       ///< Headers couldn't be parsed, or decode failed
+    NS_CAMERA_TENSOR_BAD_CONFIG = -2,     ///< Upscaling, or bins larger than 257 pixels
+    NS_CAMERA_TENSOR_SCRATCH_SMALL = -3,  ///< scratch smaller than needed for this JPEG
+} ns_camera_tensor_status_e;
+
+/**
+ * @brief Scratch bytes needed for the row accumulators
+ *
+ * @param width tensor width
+ * @param height tensor height
+ * @param channels 3 for RGB, 1 for grayscale
+ * @param src_height height of the (cropped) source region in pixels, divided by 8 for dc_only
+ */
+#define NS_CAMERA_TENSOR_SCRATCH_SIZE(width, height, channels, src_height)                         \
+    ((((15 * (height)) / (src_height)) + 2) * (width) * (channels) * sizeof(uint16_t))
+
+typedef struct {
+    void *tensor;                   ///< int8_t or uint8_t output, height x width x channels
+    uint16_t width;                 ///< Tensor width
+    uint16_t height;                ///< Tensor height
+    ns_camera_tensor_color_e color; ///< Tensor channels
+    bool is_signed;                 ///< int8 tensor (otherwise uint8)
+
+    // Quantization: q = round((pixel * pixel_scale + pixel_offset) / scale) + zero_point, where
+    // pixel is the 0..255 area average. E.g. a model trained on [0,1] inputs uses
+    // pixel_scale = 1/255, pixel_offset = 0, and the scale/zero_point of its input tensor.
+    float pixel_scale;
+    float pixel_offset;
+    float scale;
+    int32_t zero_point;
+
+    bool center_crop; ///< Crop the source to the tensor's aspect ratio (otherwise stretch)
+    bool dc_only;     ///< Decode only the DC term of each 8x8 block (1/8 scale, much faster)
+
+    uint16_t *scratch;     ///< Row accumulators, see NS_CAMERA_TENSOR_SCRATCH_SIZE
+    uint32_t scratch_size; ///< Size of scratch, in bytes
+} ns_camera_tensor_cfg_t;
+
+/**
+ * @brief Decode a JPEG into a quantized model input tensor
+ *
+ * Each tensor pixel is the average of the source pixels that map to it (box filter), so
+ * the source must be at least as large as the tensor and a tensor pixel may cover at most
+ * 257 source pixels (use dc_only for larger downscaling ratios). MCUs outside the crop are
+ * only entropy decoded.
+ *
+ * @param jpg JPEG data
+ * @param len Length of JPEG data in bytes
+ * @param cfg Tensor description
+ * @return int ns_camera_tensor_status_e
+ */
+int ns_camera_decode_to_tensor(const uint8_t *jpg, uint32_t len, const ns_camera_tensor_cfg_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_CAMERA_TENSOR_H
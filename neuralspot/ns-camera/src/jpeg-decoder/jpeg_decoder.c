@@ -37,17 +37,34 @@ int jpeg_decoder_decode_mcu(jpeg_decoder_context_t *ctx) {
     return 1;
 }
 
+static int jpeg_decoder_mcu_in_roi(jpeg_decoder_context_t *ctx) {
+    return (ctx->mcu_x >= ctx->roi_x0) && (ctx->mcu_x < ctx->roi_x1) &&
+           (ctx->mcu_y >= ctx->roi_y0) && (ctx->mcu_y < ctx->roi_y1);
+}
+
+static int jpeg_decoder_prime(jpeg_decoder_context_t *ctx) {
+    if (!ctx->primed) {
+        ctx->primed = 1;
+        return jpeg_decoder_decode_mcu(ctx);
+    }
+    return 1;
+}
+
 int jpeg_decoder_read(jpeg_decoder_context_t *ctx) {
     int y, x;
     uint16_t *pDst_row;
 
-    if (ctx->is_available == 0 || ctx->mcu_y >= ctx->imgInfo.m_MCUSPerCol) {
+    if (jpeg_decoder_prime(ctx) == -1 || ctx->is_available == 0 ||
+        ctx->mcu_y >= ctx->imgInfo.m_MCUSPerCol) {
         jpeg_decoder_abort(ctx);
         return 0;
     }
 
+    // MCUs outside the crop window weren't decoded, so there is nothing to convert
+    const int mcu_height = jpeg_decoder_mcu_in_roi(ctx) ? ctx->imgInfo.m_MCUHeight : 0;
+
     pDst_row = ctx->pImage;
-    for (y = 0; y < ctx->imgInfo.m_MCUHeight; y += 8) {
+    for (y = 0; y < mcu_height; y += 8) {
 
         const int by_limit =
             jpg_min(8, ctx->imgInfo.m_height - (ctx->mcu_y * ctx->imgInfo.m_MCUHeight + y));
@@ -130,13 +147,16 @@ int jpeg_decoder_read_swapped_bytes(jpeg_decoder_context_t *ctx) {
     int y, x;
     uint16_t *pDst_row;
 
-    if (ctx->is_available == 0 || ctx->mcu_y >= ctx->imgInfo.m_MCUSPerCol) {
+    if (jpeg_decoder_prime(ctx) == -1 || ctx->is_available == 0 ||
+        ctx->mcu_y >= ctx->imgInfo.m_MCUSPerCol) {
         jpeg_decoder_abort(ctx);
         return 0;
     }
 
+    const int mcu_height = jpeg_decoder_mcu_in_roi(ctx) ? ctx->imgInfo.m_MCUHeight : 0;
+
     pDst_row = ctx->pImage;
-    for (y = 0; y < ctx->imgInfo.m_MCUHeight; y += 8) {
+    for (y = 0; y < mcu_height; y += 8) {
 
         const int by_limit =
             jpg_min(8, ctx->imgInfo.m_height - (ctx->mcu_y * ctx->imgInfo.m_MCUHeight + y));
@@ -207,29 +227,51 @@ int jpeg_decoder_read_swapped_bytes(jpeg_decoder_context_t *ctx) {
     return 1;
 }
 
-int jpeg_decoder_init(jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size) {
+int jpeg_decoder_open(
+    jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size, int reduce) {
     ctx->mcu_x = 0;
     ctx->mcu_y = 0;
     ctx->status = 0;
     ctx->is_available = 0;
+    ctx->primed = 0;
     ctx->g_nInFileOfs = 0;
     ctx->jpg_data = (uint8_t *)array;
     ctx->g_nInFileSize = array_size;
 
-    ctx->status = pjpeg_decode_init(&ctx->imgInfo, pjpeg_callback, ctx, 0);
+    ctx->status = pjpeg_decode_init(&ctx->imgInfo, pjpeg_callback, ctx, reduce);
 
     if (ctx->status) {
         return 0;
     }
 
     ctx->row_pitch = ctx->imgInfo.m_MCUWidth;
+    ctx->roi_x0 = 0;
+    ctx->roi_y0 = 0;
+    ctx->roi_x1 = ctx->imgInfo.m_MCUSPerRow;
+    ctx->roi_y1 = ctx->imgInfo.m_MCUSPerCol;
 
     memset(
         ctx->pImage, 0, ctx->imgInfo.m_MCUWidth * ctx->imgInfo.m_MCUHeight * sizeof(*ctx->pImage));
 
     ctx->is_available = 1;
 
-    return jpeg_decoder_decode_mcu(ctx);
+    return 1;
+}
+
+int jpeg_decoder_init(jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size) {
+    if (!jpeg_decoder_open(ctx, array, array_size, 0)) {
+        return 0;
+    }
+    return jpeg_decoder_prime(ctx);
+}
+
+void jpeg_decoder_set_roi(
+    jpeg_decoder_context_t *ctx, int mcu_x0, int mcu_y0, int mcu_x1, int mcu_y1) {
+    ctx->roi_x0 = mcu_x0;
+    ctx->roi_y0 = mcu_y0;
+    ctx->roi_x1 = mcu_x1;
+    ctx->roi_y1 = mcu_y1;
+    pjpeg_set_mcu_roi(mcu_x0, mcu_y0, mcu_x1, mcu_y1);
 }
 
 void jpeg_decoder_abort(jpeg_decoder_context_t *ctx) {
@@ -32,6 +32,11 @@ typedef struct {
     uint32_t g_nInFileSize;
     uint32_t g_nInFileOfs;
     uint32_t row_pitch;
+    int primed; // first MCU has been decoded
+    int roi_x0; // MCU crop window, [roi_x0, roi_x1) x [roi_y0, roi_y1)
+    int roi_y0;
+    int roi_x1;
+    int roi_y1;
     // uint32_t decoded_width, decoded_height;
     // uint32_t row_blocks_per_mcu, col_blocks_per_mcu;
     uint16_t pImage[256];
@@ -41,6 +46,20 @@ unsigned char pjpeg_callback(
     unsigned char *pBuf, unsigned char buf_size, unsigned char *pBytes_actually_read,
     void *pCallback_data);
 int jpeg_decoder_init(jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size);
+
+// Parse the JPEG headers without decoding any MCU, so the image info can be used to
+// pick a crop window before decoding starts. If reduce is set, picojpeg only decodes
+// the DC coefficient of each 8x8 block (see pjpeg_decode_init).
+// Returns 1 on success, 0 on failure.
+int jpeg_decoder_open(
+    jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size, int reduce);
+
+// Only fully decode MCUs in columns [mcu_x0, mcu_x1) and rows [mcu_y0, mcu_y1).
+// jpeg_decoder_read() still returns every MCU, but for MCUs outside the window pImage
+// is not updated, and picojpeg skips their IDCT and color conversion.
+void jpeg_decoder_set_roi(
+    jpeg_decoder_context_t *ctx, int mcu_x0, int mcu_y0, int mcu_x1, int mcu_y1);
+
 int jpeg_decoder_read(jpeg_decoder_context_t *ctx);
 void jpeg_decoder_abort(jpeg_decoder_context_t *ctx);
 
@@ -234,6 +234,10 @@ static pjpeg_need_bytes_callback_t g_pNeedBytesCallback;
 static void *g_pCallback_data;
 static uint8 gCallbackStatus;
 static uint8 gReduce;
+
+// MCU crop window [gRoiX0, gRoiX1) x [gRoiY0, gRoiY1). MCUs outside of it are only
+// entropy decoded.
+static uint16 gRoiX0, gRoiY0, gRoiX1, gRoiY1;
 //------------------------------------------------------------------------------
 static void fillInBuf(void) {
     unsigned char status;
@@ -1976,6 +1980,10 @@ static void transformBlockReduce(uint8 mcuBlock) {
 static uint8 decodeNextMCU(void) {
     uint8 status;
     uint8 mcuBlock;
+    uint16 mcuX = gMaxMCUSPerRow - gNumMCUSRemainingX;
+    uint16 mcuY = gMaxMCUSPerCol - gNumMCUSRemainingY;
+    // Outside the crop window, only keep the bitstream and DC predictors in sync
+    uint8 skip = (mcuX < gRoiX0) || (mcuX >= gRoiX1) || (mcuY < gRoiY0) || (mcuY >= gRoiY1);
 
     if (gRestartInterval) {
         if (gRestartsLeft == 0) {
@@ -2010,8 +2018,8 @@ static uint8 decodeNextMCU(void) {
 
         compACTab = gCompACTab[componentID];
 
-        if (gReduce) {
-            // Decode, but throw out the AC coefficients in reduce mode.
+        if ((gReduce) || (skip)) {
+            // Decode, but throw out the AC coefficients in reduce or skip mode.
             for (k = 1; k < 64; k++) {
                 s = huffDecode(
                     compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
@@ -2041,7 +2049,8 @@ static uint8 decodeNextMCU(void) {
                 }
             }
 
-            transformBlockReduce(mcuBlock);
+            if (!skip)
+                transformBlockReduce(mcuBlock);
         } else {
             // Decode and dequantize AC coefficients
             for (k = 1; k < 64; k++) {
@@ -2121,6 +2130,13 @@ unsigned char pjpeg_decode_mcu(void) {
     return 0;
 }
 //------------------------------------------------------------------------------
+void pjpeg_set_mcu_roi(int x0, int y0, int x1, int y1) {
+    gRoiX0 = (uint16)((x0 < 0) ? 0 : x0);
+    gRoiY0 = (uint16)((y0 < 0) ? 0 : y0);
+    gRoiX1 = (uint16)((x1 > gMaxMCUSPerRow) ? gMaxMCUSPerRow : x1);
+    gRoiY1 = (uint16)((y1 > gMaxMCUSPerCol) ? gMaxMCUSPerCol : y1);
+}
+//------------------------------------------------------------------------------
 unsigned char pjpeg_decode_init(
     pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
     void *pCallback_data, unsigned char reduce) {
@@ -2171,6 +2187,8 @@ unsigned char pjpeg_decode_init(
     pInfo->m_pMCUBufG = gMCUBufG;
     pInfo->m_pMCUBufB = gMCUBufB;
 
+    pjpeg_set_mcu_roi(0, 0, gMaxMCUSPerRow, gMaxMCUSPerCol);
+
     return 0;
 }
 
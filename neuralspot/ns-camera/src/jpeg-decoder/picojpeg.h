@@ -128,6 +128,14 @@ unsigned char pjpeg_decode_init(
 // thread safe.
 unsigned char pjpeg_decode_mcu(void);
 
+// Restricts full decoding to the MCUs in columns [x0, x1) and rows [y0, y1).
+// MCUs outside this window are only entropy decoded (to keep the bitstream and
+// DC predictors in sync): their dequantization, IDCT and color conversion are
+// skipped, and the MCU buffers are left untouched. pjpeg_decode_init() resets
+// the window to the whole image; call this before decoding the first MCU that
+// should be skipped.
+void pjpeg_set_mcu_roi(int x0, int y0, int x1, int y1);
+
 #ifdef __cplusplus
 }
 #endif
@@ -318,8 +318,11 @@ uint32_t ns_start_dma_read(
     }
 
     // Get FIFO length
-    dma_total_requested_length = cameraReadFifoLength(&camera);
-    // ns_lp_printf("CAMERA FIFO length: %u\n", dma_total_requested_length);
+    uint32_t fifo_length = cameraReadFifoLength(&camera);
+    // ns_lp_printf("CAMERA FIFO length: %u\n", fifo_length);
+
+    // Never DMA past the end of camBuf
+    dma_total_requested_length = (fifo_length > bufLen) ? bufLen : fifo_length;
     if (cfg->imagePixFmt == NS_CAM_IMAGE_PIX_FMT_JPEG) {
         *buffer_offset = 1;
     } else {
@@ -338,7 +341,7 @@ uint32_t ns_start_dma_read(
     ns_spi_read_dma(
         spiHandle, camBuf, dma_current_chunk_length, ARDU_BURST_FIFO_READ, 1, camera.csPin);
 
-    return dma_total_requested_length;
+    return fifo_length;
 }
 
 uint32_t ns_transfer_picture(
@@ -384,6 +387,61 @@ uint32_t ns_transfer_picture(
     return length;
 }
 
+// Pipelined capture: the Arducam's completion callbacks feed the pipeline's state machine
+static ns_camera_pipeline_t *nsCameraPipeline = NULL;
+static uint8_t *nsCameraPipelineBuf;
+static uint32_t nsCameraPipelineOffset;
+
+static void ns_camera_pipeline_picture_taken(ns_camera_config_t *cfg) {
+    ns_camera_pipeline_on_captured(nsCameraPipeline);
+}
+
+static void ns_camera_pipeline_dma_complete(ns_camera_config_t *cfg) {
+    uint32_t length =
+        ns_chop_off_trailing_zeros(nsCameraPipelineBuf, dma_total_requested_length);
+    ns_camera_pipeline_on_read_done(nsCameraPipeline, nsCameraPipelineOffset, length);
+}
+
+static uint32_t ns_camera_pipeline_start_capture(void *ctx) {
+    return ns_press_shutter_button(&ns_camera_config);
+}
+
+static uint32_t ns_camera_pipeline_start_read(void *ctx, uint8_t *buf, uint32_t bufLen) {
+    nsCameraPipelineBuf = buf;
+    uint32_t length = ns_start_dma_read(&ns_camera_config, buf, &nsCameraPipelineOffset, bufLen);
+    if (length > bufLen) {
+        ns_lp_printf("Camera frame truncated: %d > %d\n", length, bufLen);
+    }
+    return (length == 0) ? NS_STATUS_FAILURE : NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_camera_pipeline_lock_irq(void *ctx) {
+    return am_hal_interrupt_master_disable();
+}
+
+static void ns_camera_pipeline_unlock_irq(void *ctx, uint32_t state) {
+    am_hal_interrupt_master_set(state);
+}
+
+uint32_t ns_camera_pipeline_attach(ns_camera_config_t *cfg, ns_camera_pipeline_t *pipeline) {
+    if ((cfg == NULL) || (pipeline == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    pipeline->ops.startCapture = ns_camera_pipeline_start_capture;
+    pipeline->ops.startRead = ns_camera_pipeline_start_read;
+    pipeline->ops.lock = ns_camera_pipeline_lock_irq;
+    pipeline->ops.unlock = ns_camera_pipeline_unlock_irq;
+    pipeline->ops.ctx = cfg;
+    uint32_t status = ns_camera_pipeline_init(pipeline);
+    if (status != NS_STATUS_SUCCESS) {
+        return status;
+    }
+    cfg->pictureTakenCb = ns_camera_pipeline_picture_taken;
+    cfg->dmaCompleteCb = ns_camera_pipeline_dma_complete;
+    nsCameraPipeline = pipeline;
+    return NS_STATUS_SUCCESS;
+}
+
 /**
  * @brief Convenience routine to capture and transfer next frame.
  *
@@ -436,7 +494,9 @@ int camera_decode_image(
     uint16_t *pImg;
     uint16_t color;
 
-    jpeg_decoder_init(&jpegCtx, camBuf, camLen);
+    if (!jpeg_decoder_open(&jpegCtx, camBuf, camLen, 0)) {
+        return -1;
+    }
 
     const int keep_x_mcus = scaleFactor * imgWidth / jpegCtx.imgInfo.m_MCUWidth;
     const int keep_y_mcus = scaleFactor * imgHeight / jpegCtx.imgInfo.m_MCUHeight;
@@ -451,6 +511,11 @@ int camera_decode_image(
     const int skip_start_y_mcus = skip_y_mcus / 2;
     const int skip_end_y_mcu_index = skip_start_y_mcus + keep_y_mcus;
 
+    // MCUs outside the center crop are only entropy decoded
+    jpeg_decoder_set_roi(
+        &jpegCtx, skip_start_x_mcus, skip_start_y_mcus, skip_end_x_mcu_index,
+        skip_end_y_mcu_index);
+
     const int scaleImageSize = imgHeight * imgWidth * 2;
 
     for (int i = 0; i < scaleImageSize; i++) {
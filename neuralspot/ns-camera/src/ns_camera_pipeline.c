@@ -0,0 +1,192 @@
+/**
+ * @file ns_camera_pipeline.c
+ * @author Ambiq
+ * @brief Double-buffered camera capture pipeline
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_camera_pipeline.h"
+#include "ns_core.h"
+
+static uint32_t ns_camera_pipeline_lock(ns_camera_pipeline_t *p) {
+    return p->ops.lock ? p->ops.lock(p->ops.ctx) : 0;
+}
+
+static void ns_camera_pipeline_unlock(ns_camera_pipeline_t *p, uint32_t state) {
+    if (p->ops.unlock) {
+        p->ops.unlock(p->ops.ctx, state);
+    }
+}
+
+// Oldest buffer in the given state, or -1. Caller holds the lock.
+static int ns_camera_pipeline_oldest(ns_camera_pipeline_t *p, ns_camera_buf_state_e state) {
+    int oldest = -1;
+    for (int i = 0; i < NS_CAMERA_PIPELINE_BUFFERS; i++) {
+        if ((p->bufState[i] == state) &&
+            ((oldest < 0) || ((int32_t)(p->bufSequence[i] - p->bufSequence[oldest]) < 0))) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+// Claim a buffer for a captured frame if one can take it. Caller holds the lock.
+static int ns_camera_pipeline_claim(ns_camera_pipeline_t *p) {
+    if (p->state != NS_CAMERA_PIPE_CAPTURED) {
+        return -1;
+    }
+    int buf = ns_camera_pipeline_oldest(p, NS_CAMERA_BUF_FREE);
+    if ((buf < 0) && p->dropStale) {
+        buf = ns_camera_pipeline_oldest(p, NS_CAMERA_BUF_READY);
+        if (buf >= 0) {
+            p->framesDropped++;
+        }
+    }
+    if (buf < 0) {
+        return -1; // wait for release_frame
+    }
+    p->bufState[buf] = NS_CAMERA_BUF_FILLING;
+    p->bufSequence[buf] = p->nextSequence++;
+    p->filling = buf;
+    p->state = NS_CAMERA_PIPE_READING;
+    return buf;
+}
+
+// Start the transfer into a claimed buffer (outside the lock, it may touch the bus)
+static void ns_camera_pipeline_read(ns_camera_pipeline_t *p, int buf) {
+    if (buf < 0) {
+        return;
+    }
+    if (p->ops.startRead(p->ops.ctx, p->buffers[buf], p->bufferSize)) {
+        // Transfer couldn't start, give the buffer back and drop the frame
+        uint32_t state = ns_camera_pipeline_lock(p);
+        p->bufState[buf] = NS_CAMERA_BUF_FREE;
+        p->filling = -1;
+        p->state = NS_CAMERA_PIPE_IDLE;
+        ns_camera_pipeline_unlock(p, state);
+    }
+}
+
+uint32_t ns_camera_pipeline_init(ns_camera_pipeline_t *p) {
+    if (p == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((p->bufferSize == 0) || (p->ops.startCapture == NULL) || (p->ops.startRead == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (int i = 0; i < NS_CAMERA_PIPELINE_BUFFERS; i++) {
+        if (p->buffers[i] == NULL) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        p->bufState[i] = NS_CAMERA_BUF_FREE;
+        p->bufOffset[i] = 0;
+        p->bufLength[i] = 0;
+        p->bufSequence[i] = 0;
+    }
+    p->state = NS_CAMERA_PIPE_IDLE;
+    p->filling = -1;
+    p->running = false;
+    p->nextSequence = 0;
+    p->framesCaptured = 0;
+    p->framesDelivered = 0;
+    p->framesDropped = 0;
+    p->stalls = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_camera_pipeline_start(ns_camera_pipeline_t *p) {
+    p->running = true;
+    if (p->state != NS_CAMERA_PIPE_IDLE) {
+        return NS_STATUS_SUCCESS;
+    }
+    p->state = NS_CAMERA_PIPE_CAPTURING;
+    if (p->ops.startCapture(p->ops.ctx)) {
+        p->state = NS_CAMERA_PIPE_IDLE;
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_camera_pipeline_stop(ns_camera_pipeline_t *p) { p->running = false; }
+
+void ns_camera_pipeline_service(ns_camera_pipeline_t *p) {
+    // Only this function and start() leave IDLE from thread context, so no lock is needed to
+    // test it; completions only ever move the camera *to* IDLE.
+    if (p->running && (p->state == NS_CAMERA_PIPE_IDLE)) {
+        ns_camera_pipeline_start(p);
+    }
+}
+
+bool ns_camera_pipeline_get_frame(ns_camera_pipeline_t *p, ns_camera_frame_t *frame) {
+    ns_camera_pipeline_service(p);
+
+    uint32_t state = ns_camera_pipeline_lock(p);
+    int buf = ns_camera_pipeline_oldest(p, NS_CAMERA_BUF_READY);
+    if (buf >= 0) {
+        p->bufState[buf] = NS_CAMERA_BUF_IN_USE;
+        p->framesDelivered++;
+        frame->buffer = p->buffers[buf];
+        frame->offset = p->bufOffset[buf];
+        frame->length = p->bufLength[buf];
+        frame->sequence = p->bufSequence[buf];
+        frame->index = (uint8_t)buf;
+    }
+    ns_camera_pipeline_unlock(p, state);
+    return buf >= 0;
+}
+
+void ns_camera_pipeline_release_frame(ns_camera_pipeline_t *p, const ns_camera_frame_t *frame) {
+    if (frame->index >= NS_CAMERA_PIPELINE_BUFFERS) {
+        return;
+    }
+    int buf = -1;
+    uint32_t state = ns_camera_pipeline_lock(p);
+    if (p->bufState[frame->index] == NS_CAMERA_BUF_IN_USE) {
+        p->bufState[frame->index] = NS_CAMERA_BUF_FREE;
+        buf = ns_camera_pipeline_claim(p);
+    }
+    ns_camera_pipeline_unlock(p, state);
+    ns_camera_pipeline_read(p, buf);
+    ns_camera_pipeline_service(p);
+}
+
+uint32_t ns_camera_pipeline_frames_ready(ns_camera_pipeline_t *p) {
+    uint32_t ready = 0;
+    for (int i = 0; i < NS_CAMERA_PIPELINE_BUFFERS; i++) {
+        ready += (p->bufState[i] == NS_CAMERA_BUF_READY);
+    }
+    return ready;
+}
+
+void ns_camera_pipeline_on_captured(ns_camera_pipeline_t *p) {
+    int buf = -1;
+    uint32_t state = ns_camera_pipeline_lock(p);
+    if (p->state == NS_CAMERA_PIPE_CAPTURING) {
+        p->framesCaptured++;
+        p->state = NS_CAMERA_PIPE_CAPTURED;
+        buf = ns_camera_pipeline_claim(p);
+        if (buf < 0) {
+            p->stalls++;
+        }
+    }
+    ns_camera_pipeline_unlock(p, state);
+    ns_camera_pipeline_read(p, buf);
+}
+
+void ns_camera_pipeline_on_read_done(ns_camera_pipeline_t *p, uint32_t offset, uint32_t length) {
+    uint32_t state = ns_camera_pipeline_lock(p);
+    if ((p->state == NS_CAMERA_PIPE_READING) && (p->filling >= 0)) {
+        p->bufOffset[p->filling] = offset;
+        p->bufLength[p->filling] = (length > p->bufferSize) ? p->bufferSize : length;
+        p->bufState[p->filling] = NS_CAMERA_BUF_READY;
+        p->filling = -1;
+        // The next capture is triggered from thread context (service), since camera register
+        // writes can't be issued from the transfer-complete interrupt
+        p->state = NS_CAMERA_PIPE_IDLE;
+    }
+    ns_camera_pipeline_unlock(p, state);
+}
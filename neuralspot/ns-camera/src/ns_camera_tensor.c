@@ -0,0 +1,175 @@
+/**
+ * @file ns_camera_tensor.c
+ * @author Ambiq
+ * @brief Decode a JPEG straight into a quantized model input tensor
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_camera_tensor.h"
+#include "jpeg-decoder/jpeg_decoder.h"
+#include "jpeg-decoder/picojpeg.h"
+#include <math.h>
+#include <string.h>
+
+// Largest bin (in source pixels) whose 8-bit sums fit in a uint16_t accumulator
+#define NS_CAMERA_TENSOR_MAX_BIN 257
+
+static jpeg_decoder_context_t tensorJpegCtx;
+
+// Source pixels s in [0, src) map to output index s * dst / src. This is the first
+// source pixel of output index o.
+static uint32_t bin_start(uint32_t o, uint32_t src, uint32_t dst) {
+    return (o * src + dst - 1) / dst;
+}
+
+static uint32_t bin_count(uint32_t o, uint32_t src, uint32_t dst) {
+    return bin_start(o + 1, src, dst) - bin_start(o, src, dst);
+}
+
+static void build_lut(const ns_camera_tensor_cfg_t *cfg, uint8_t *lut) {
+    const int32_t lo = cfg->is_signed ? -128 : 0;
+    const int32_t hi = cfg->is_signed ? 127 : 255;
+    for (int p = 0; p < 256; p++) {
+        float real = p * cfg->pixel_scale + cfg->pixel_offset;
+        int32_t q = (int32_t)floorf(real / cfg->scale + 0.5f) + cfg->zero_point;
+        q = (q < lo) ? lo : ((q > hi) ? hi : q);
+        lut[p] = (uint8_t)q; // int8 tensors reinterpret the bits
+    }
+}
+
+// Write the averages of one finished output row and clear its accumulators
+static void flush_row(
+    const ns_camera_tensor_cfg_t *cfg, uint16_t *acc, uint32_t oy, uint32_t channels,
+    uint32_t cw, uint32_t ch, const uint8_t *lut) {
+    uint8_t *out = (uint8_t *)cfg->tensor + oy * cfg->width * channels;
+    const uint32_t count_y = bin_count(oy, ch, cfg->height);
+
+    for (uint32_t ox = 0; ox < cfg->width; ox++) {
+        const uint32_t count = count_y * bin_count(ox, cw, cfg->width);
+        for (uint32_t c = 0; c < channels; c++) {
+            *out++ = lut[(*acc + (count >> 1)) / count];
+            *acc++ = 0;
+        }
+    }
+}
+
+int ns_camera_decode_to_tensor(
+    const uint8_t *jpg, uint32_t len, const ns_camera_tensor_cfg_t *cfg) {
+    jpeg_decoder_context_t *ctx = &tensorJpegCtx;
+    uint8_t lut[256];
+    uint16_t ox_map[16];
+
+    if (!jpeg_decoder_open(ctx, jpg, len, cfg->dc_only)) {
+        return NS_CAMERA_TENSOR_BAD_JPEG;
+    }
+    const pjpeg_image_info_t *info = &ctx->imgInfo;
+
+    // In DC-only mode every 8x8 block decodes to one pixel
+    const uint32_t shift = cfg->dc_only ? 3 : 0;
+    const uint32_t src_w = (info->m_width + (1 << shift) - 1) >> shift;
+    const uint32_t src_h = (info->m_height + (1 << shift) - 1) >> shift;
+    const uint32_t mcu_w = info->m_MCUWidth >> shift;
+    const uint32_t mcu_h = info->m_MCUHeight >> shift;
+    const uint32_t w = cfg->width;
+    const uint32_t h = cfg->height;
+
+    // Source region that is scaled into the tensor
+    uint32_t cw = src_w, ch = src_h;
+    if (cfg->center_crop && w && h) {
+        if (src_w * h > src_h * w) {
+            cw = src_h * w / h;
+        } else {
+            ch = src_w * h / w;
+        }
+    }
+    const uint32_t x0 = (src_w - cw) / 2;
+    const uint32_t y0 = (src_h - ch) / 2;
+
+    if ((w == 0) || (h == 0) || (cw < w) || (ch < h) ||
+        (((cw + w - 1) / w) * ((ch + h - 1) / h) > NS_CAMERA_TENSOR_MAX_BIN)) {
+        return NS_CAMERA_TENSOR_BAD_CONFIG;
+    }
+
+    const uint32_t channels = (cfg->color == NS_CAMERA_TENSOR_RGB) ? 3 : 1;
+    uint32_t band = ((mcu_h - 1) * h) / ch + 2;
+    band = (band > h) ? h : band;
+    const uint32_t row_len = w * channels;
+    if (cfg->scratch_size < band * row_len * sizeof(uint16_t)) {
+        return NS_CAMERA_TENSOR_SCRATCH_SMALL;
+    }
+    memset(cfg->scratch, 0, band * row_len * sizeof(uint16_t));
+    build_lut(cfg, lut);
+
+    jpeg_decoder_set_roi(
+        ctx, x0 / mcu_w, y0 / mcu_h, (x0 + cw + mcu_w - 1) / mcu_w, (y0 + ch + mcu_h - 1) / mcu_h);
+
+    const bool gray_src = (info->m_scanType == PJPG_GRAYSCALE);
+    uint32_t next_row = 0; // next output row to be written
+    for (int my = 0; my < info->m_MCUSPerCol; my++) {
+        for (int mx = 0; mx < info->m_MCUSPerRow; mx++) {
+            if (pjpeg_decode_mcu()) {
+                return NS_CAMERA_TENSOR_BAD_JPEG;
+            }
+            if ((mx < ctx->roi_x0) || (mx >= ctx->roi_x1) || (my < ctx->roi_y0) ||
+                (my >= ctx->roi_y1)) {
+                continue;
+            }
+
+            // Output column of each of this MCU's source columns (-1 if cropped)
+            for (uint32_t px = 0; px < mcu_w; px++) {
+                int32_t sx = (int32_t)(mx * mcu_w + px) - (int32_t)x0;
+                ox_map[px] = ((sx < 0) || (sx >= (int32_t)cw)) ? 0xFFFF : sx * w / cw;
+            }
+
+            for (uint32_t py = 0; py < mcu_h; py++) {
+                int32_t sy = (int32_t)(my * mcu_h + py) - (int32_t)y0;
+                if ((sy < 0) || (sy >= (int32_t)ch)) {
+                    continue;
+                }
+                uint16_t *acc_row = cfg->scratch + ((sy * h / ch) % band) * row_len;
+
+                for (uint32_t px = 0; px < mcu_w; px++) {
+                    if (ox_map[px] == 0xFFFF) {
+                        continue;
+                    }
+                    // Byte offset of the pixel in picojpeg's 8x8 block layout
+                    uint32_t ofs = shift ? (py * 128 + px * 64)
+                                         : ((py >> 3) * 128 + (px >> 3) * 64 + (py & 7) * 8 +
+                                            (px & 7));
+                    uint16_t *acc = acc_row + ox_map[px] * channels;
+                    uint8_t r = info->m_pMCUBufR[ofs];
+
+                    if (gray_src) {
+                        for (uint32_t c = 0; c < channels; c++) {
+                            acc[c] += r;
+                        }
+                    } else {
+                        uint8_t g = info->m_pMCUBufG[ofs];
+                        uint8_t b = info->m_pMCUBufB[ofs];
+                        if (channels == 3) {
+                            acc[0] += r;
+                            acc[1] += g;
+                            acc[2] += b;
+                        } else {
+                            acc[0] += (77 * r + 150 * g + 29 * b + 128) >> 8;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Flush the output rows whose source rows have all been decoded
+        int32_t rows_done = (int32_t)((my + 1) * mcu_h) - (int32_t)y0;
+        while ((next_row < h) && (rows_done > 0) &&
+               (bin_start(next_row + 1, ch, h) <= (uint32_t)rows_done)) {
+            flush_row(
+                cfg, cfg->scratch + (next_row % band) * row_len, next_row, channels, cw, ch, lut);
+            next_row++;
+        }
+    }
+    return (next_row == h) ? NS_CAMERA_TENSOR_OK : NS_CAMERA_TENSOR_BAD_JPEG;
+}
@@ -145,6 +145,7 @@ void am_gpio0_203f_isr(void) {
 }
 #endif
 
+#ifndef NS_HOST_BUILD // newlib syscall overrides, the host C library has its own
 int __wrap__write_r(struct _reent *r, int fd, const void *ptr, size_t len) {
     // For example, write each byte to UART here.
     // If fd is STDOUT_FILENO or STDERR_FILENO, you might send it to a debug console.
@@ -199,3 +200,4 @@ int __wrap__fstat_r(struct _reent *r, int fd, struct stat *st) {
     // Otherwise, return an error.
     return 0;  // Or an appropriate value.
 }
+#endif
@@ -40,6 +40,10 @@ typedef struct {
   float integralFBx;
   float integralFBy;
   float integralFBz;
+  // Filter parameters, set to the defaults below by ns_mahony_init
+  float sampleFreq; // Hz
+  float twoKp;      // 2 * proportional gain
+  float twoKi;      // 2 * integral gain
 } ns_mahony_cfg_t;
 
 // #include "mpu6050registers.h"
@@ -51,6 +55,28 @@ extern uint16_t ns_mahony_update(ns_mahony_cfg_t *cfg, float gx, float gy, float
 extern uint16_t ns_get_quaternion(ns_mahony_cfg_t *cfg,double *qw, double *qx, double *qy, double *qz);
 extern uint16_t ns_get_RollPitchYaw(ns_mahony_cfg_t *cfg, double *pitch, double *roll, double *yaw);
 
+/*
+ * Batched updates for IMU FIFO windows. Samples are accel xyz followed by gyro xyz (rad/s),
+ * the layout of ns_imu_window_to_float() and ns_imu_raw_sample_t, oldest first. Both paths
+ * keep the state in registers for the whole batch and avoid double precision and divisions.
+ */
+#define NS_MAHONY_SAMPLE_AXES 6
+
+// float32 path, n samples of NS_MAHONY_SAMPLE_AXES floats
+extern uint16_t ns_mahony_update_batch(ns_mahony_cfg_t *cfg, const float *samples, uint32_t n);
+
+// Q-format fixed-point path (Q30 quaternion), for raw int16 sensor samples. stride is the
+// number of int16 between consecutive samples: NS_MAHONY_SAMPLE_AXES for packed data, or
+// sizeof(ns_imu_raw_sample_t) / sizeof(int16_t) to walk FIFO samples in place. gyroScale
+// converts gyro LSB to rad/s and must be below 2; accel scale doesn't matter. Angular rates,
+// including feedback, must stay within +-128 rad/s.
+extern uint16_t ns_mahony_update_batch_q(ns_mahony_cfg_t *cfg, const int16_t *samples,
+                                         uint32_t n, uint32_t stride, float gyroScale);
+
+// float variants of the getters
+extern uint16_t ns_get_quaternion_f(ns_mahony_cfg_t *cfg, float *qw, float *qx, float *qy, float *qz);
+extern uint16_t ns_get_RollPitchYaw_f(ns_mahony_cfg_t *cfg, float *roll, float *pitch, float *yaw);
+
 #ifdef __cplusplus
 }
 #endif
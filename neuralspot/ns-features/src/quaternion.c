@@ -38,6 +38,9 @@ uint16_t ns_mahony_init(ns_mahony_cfg_t *cfg) {
 	cfg->integralFBx = 0.0f;
 	cfg->integralFBy = 0.0f;
 	cfg->integralFBz = 0.0f;
+	cfg->sampleFreq = mahonysampleFreq;
+	cfg->twoKp = mahonytwoKpDef;
+	cfg->twoKi = mahonytwoKiDef;
 	return NS_STATUS_SUCCESS;
 }
 
@@ -80,10 +83,10 @@ uint16_t ns_mahony_update(ns_mahony_cfg_t *cfg, float gx, float gy, float gz, fl
 		halfez = (ax * halfvy - ay * halfvx);
 
 		// Compute and apply integral feedback if enabled
-		if(mahonytwoKiDef > 0.0f) {
-			cfg->integralFBx += mahonytwoKiDef * halfex * (1.0f / mahonysampleFreq);	// integral error scaled by Ki
-			cfg->integralFBy += mahonytwoKiDef * halfey * (1.0f / mahonysampleFreq);
-			cfg->integralFBz += mahonytwoKiDef * halfez * (1.0f / mahonysampleFreq);
+		if(cfg->twoKi > 0.0f) {
+			cfg->integralFBx += cfg->twoKi * halfex * (1.0f / cfg->sampleFreq);	// integral error scaled by Ki
+			cfg->integralFBy += cfg->twoKi * halfey * (1.0f / cfg->sampleFreq);
+			cfg->integralFBz += cfg->twoKi * halfez * (1.0f / cfg->sampleFreq);
 			gx += cfg->integralFBx;	// apply integral feedback
 			gy += cfg->integralFBy;
 			gz += cfg->integralFBz;
@@ -94,15 +97,15 @@ uint16_t ns_mahony_update(ns_mahony_cfg_t *cfg, float gx, float gy, float gz, fl
 		}
 
 		// Apply proportional feedback
-		gx += mahonytwoKpDef * halfex;
-		gy += mahonytwoKpDef * halfey;
-		gz += mahonytwoKpDef * halfez;
+		gx += cfg->twoKp * halfex;
+		gy += cfg->twoKp * halfey;
+		gz += cfg->twoKp * halfez;
 	}
 
 	// Integrate rate of change of quaternion
-	gx *= (0.5f * (1.0f / mahonysampleFreq));		// pre-multiply common factors
-	gy *= (0.5f * (1.0f / mahonysampleFreq));
-	gz *= (0.5f * (1.0f / mahonysampleFreq));
+	gx *= (0.5f * (1.0f / cfg->sampleFreq));		// pre-multiply common factors
+	gy *= (0.5f * (1.0f / cfg->sampleFreq));
+	gz *= (0.5f * (1.0f / cfg->sampleFreq));
 	qa = cfg->q0;
 	qb = cfg->q1;
 	qc = cfg->q2;
@@ -164,4 +167,283 @@ uint16_t ns_get_RollPitchYaw(ns_mahony_cfg_t *cfg, double *roll, double *pitch,
 	*pitch = -asin(2 * cfg->q1 * cfg->q3 + 2 * cfg->q0 * cfg->q2);
 	*roll = atan2(2 * cfg->q2 * cfg->q3 - 2 * cfg->q0 * cfg->q1, 2 * cfg->q0 * cfg->q0 + 2 * cfg->q3 * cfg->q3 - 1 + 1e-4);
 	return NS_STATUS_SUCCESS;
-}
\ No newline at end of file
+}
+
+
+/*
+ * Fast inverse square root: bit-level initial guess refined by two Newton iterations
+ * (relative error below 5e-6, re-normalisation keeps it from accumulating)
+ */
+static inline float ns_mahony_inv_sqrtf(float x) {
+	union {
+		float f;
+		uint32_t i;
+	} u = {.f = x};
+	float halfx = 0.5f * x;
+	u.i = 0x5f3759df - (u.i >> 1);
+	u.f *= 1.5f - halfx * u.f * u.f;
+	u.f *= 1.5f - halfx * u.f * u.f;
+	return u.f;
+}
+
+/*
+ * Batched Mahony update, float32 only. Same filter as ns_mahony_update.
+ */
+uint16_t ns_mahony_update_batch(ns_mahony_cfg_t *cfg, const float *samples, uint32_t n) {
+	#ifndef NS_DISABLE_API_VALIDATION
+		if (cfg == NULL || (samples == NULL && n > 0)) {
+			return NS_STATUS_INVALID_HANDLE;
+		}
+
+		if (ns_core_check_api(cfg->api, &ns_mahony_oldest_supported_version, &ns_mahony_current_version)) {
+			return NS_STATUS_INVALID_VERSION;
+		}
+	#endif
+	const float kiDt = cfg->twoKi * (1.0f / cfg->sampleFreq);
+	const float twoKp = cfg->twoKp;
+	const float halfDt = 0.5f * (1.0f / cfg->sampleFreq);
+	const int useKi = cfg->twoKi > 0.0f;
+	float q0 = cfg->q0, q1 = cfg->q1, q2 = cfg->q2, q3 = cfg->q3;
+	float iFBx = cfg->integralFBx, iFBy = cfg->integralFBy, iFBz = cfg->integralFBz;
+	float recipNorm;
+	float qa, qb, qc;
+
+	if (!useKi) {
+		iFBx = iFBy = iFBz = 0.0f;
+	}
+	for (uint32_t i = 0; i < n; i++, samples += NS_MAHONY_SAMPLE_AXES) {
+		float ax = samples[0], ay = samples[1], az = samples[2];
+		float gx = samples[3], gy = samples[4], gz = samples[5];
+
+		if(!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
+			recipNorm = ns_mahony_inv_sqrtf(ax * ax + ay * ay + az * az);
+			ax *= recipNorm;
+			ay *= recipNorm;
+			az *= recipNorm;
+
+			float halfvx = q1 * q3 - q0 * q2;
+			float halfvy = q0 * q1 + q2 * q3;
+			float halfvz = q0 * q0 - 0.5f + q3 * q3;
+
+			float halfex = (ay * halfvz - az * halfvy);
+			float halfey = (az * halfvx - ax * halfvz);
+			float halfez = (ax * halfvy - ay * halfvx);
+
+			if (useKi) {
+				iFBx += kiDt * halfex;
+				iFBy += kiDt * halfey;
+				iFBz += kiDt * halfez;
+				gx += iFBx;
+				gy += iFBy;
+				gz += iFBz;
+			}
+
+			gx += twoKp * halfex;
+			gy += twoKp * halfey;
+			gz += twoKp * halfez;
+		}
+
+		gx *= halfDt;
+		gy *= halfDt;
+		gz *= halfDt;
+		qa = q0;
+		qb = q1;
+		qc = q2;
+		q0 += (-qb * gx - qc * gy - q3 * gz);
+		q1 += (qa * gx + qc * gz - q3 * gy);
+		q2 += (qa * gy - qb * gz + q3 * gx);
+		q3 += (qa * gz + qb * gy - qc * gx);
+
+		recipNorm = ns_mahony_inv_sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+		q0 *= recipNorm;
+		q1 *= recipNorm;
+		q2 *= recipNorm;
+		q3 *= recipNorm;
+	}
+
+	cfg->q0 = q0;
+	cfg->q1 = q1;
+	cfg->q2 = q2;
+	cfg->q3 = q3;
+	cfg->integralFBx = iFBx;
+	cfg->integralFBy = iFBy;
+	cfg->integralFBz = iFBz;
+	return NS_STATUS_SUCCESS;
+}
+
+// Fixed-point formats used by ns_mahony_update_batch_q
+#define NS_MAHONY_Q30 1073741824.0f // quaternion, unit vectors, feedback error, half angles
+#define NS_MAHONY_Q28 268435456.0f  // integral feedback (rad/s)
+#define NS_MAHONY_Q24 16777216.0f   // angular rate (rad/s)
+
+/*
+ * 1/sqrt(m / 2^32) in Q30 for m in [2^30, 2^32), sampled at the middle of each 2^26 wide bin
+ */
+static const uint32_t ns_mahony_rsqrt_lut[48] = {
+	2114695713, 2053387115, 1997119227, 1945237133, 1897199172, 1852552937,
+	1810917218, 1771968208, 1735428857, 1701060526, 1668656406, 1638036256,
+	1609042172, 1581535151, 1555392273, 1530504391, 1506774204, 1484114654,
+	1462447584, 1441702596, 1421816090, 1402730445, 1384393311, 1366757007,
+	1349778000, 1333416450, 1317635818, 1302402522, 1287685637, 1273456629,
+	1259689126, 1246358707, 1233442724, 1220920139, 1208771378, 1196978204,
+	1185523604, 1174391680, 1163567563, 1153037323, 1142787899, 1132807028,
+	1123083182, 1113605518, 1104363818, 1095348453, 1086550331, 1077960865,
+};
+
+/*
+ * Fixed-point fast inverse square root of x > 0: table lookup refined by two Newton
+ * iterations. Returns r and sets *shift so that v / sqrt(x) * 2^30 = (v * r) >> *shift,
+ * i.e. normalising a vector whose squared norm is x to Q30.
+ */
+static inline uint32_t ns_mahony_rsqrt_q30(uint64_t x, int32_t *shift) {
+	// Even shift t bringing x into [2^30, 2^32), so sqrt(x) = sqrt(m) * 2^(t / 2)
+	int32_t bits = 64 - __builtin_clzll(x);
+	int32_t t = bits - 32 + (bits & 1);
+	uint64_t m = (t >= 0) ? (x >> t) : (x << -t);
+	uint64_t r = ns_mahony_rsqrt_lut[(m >> 26) - 16];
+
+	for (int i = 0; i < 2; i++) {
+		// r = r * (3 - m * r^2) / 2
+		uint64_t mr2 = (m * ((r * r) >> 30)) >> 32;
+		r = (r * (uint64_t)((3ULL << 30) - mr2)) >> 31;
+	}
+	*shift = 16 + t / 2;
+	return (uint32_t)r;
+}
+
+/*
+ * Batched Mahony update in fixed point. Same filter as ns_mahony_update, the state is
+ * converted to and from the float config once per batch.
+ */
+uint16_t ns_mahony_update_batch_q(ns_mahony_cfg_t *cfg, const int16_t *samples,
+                                  uint32_t n, uint32_t stride, float gyroScale) {
+	#ifndef NS_DISABLE_API_VALIDATION
+		if (cfg == NULL || (samples == NULL && n > 0)) {
+			return NS_STATUS_INVALID_HANDLE;
+		}
+
+		if (ns_core_check_api(cfg->api, &ns_mahony_oldest_supported_version, &ns_mahony_current_version)) {
+			return NS_STATUS_INVALID_VERSION;
+		}
+	#endif
+	const int64_t gyroScaleQ30 = (int64_t)(gyroScale * NS_MAHONY_Q30);
+	const int64_t kiDtQ30 = (int64_t)(cfg->twoKi * (1.0f / cfg->sampleFreq) * NS_MAHONY_Q30);
+	const int64_t twoKpQ24 = (int64_t)(cfg->twoKp * NS_MAHONY_Q24);
+	const int64_t halfDtQ30 = (int64_t)(0.5f * (1.0f / cfg->sampleFreq) * NS_MAHONY_Q30);
+	const int useKi = cfg->twoKi > 0.0f;
+	int32_t q0 = (int32_t)(cfg->q0 * NS_MAHONY_Q30);
+	int32_t q1 = (int32_t)(cfg->q1 * NS_MAHONY_Q30);
+	int32_t q2 = (int32_t)(cfg->q2 * NS_MAHONY_Q30);
+	int32_t q3 = (int32_t)(cfg->q3 * NS_MAHONY_Q30);
+	int32_t iFBx = 0, iFBy = 0, iFBz = 0;
+	int32_t shift;
+	uint32_t recipNorm;
+
+	if (useKi) {
+		iFBx = (int32_t)(cfg->integralFBx * NS_MAHONY_Q28);
+		iFBy = (int32_t)(cfg->integralFBy * NS_MAHONY_Q28);
+		iFBz = (int32_t)(cfg->integralFBz * NS_MAHONY_Q28);
+	}
+	for (uint32_t i = 0; i < n; i++, samples += stride) {
+		int64_t ax = samples[0], ay = samples[1], az = samples[2];
+		// rad/s, Q24
+		int32_t gx = (int32_t)((samples[3] * gyroScaleQ30) >> 6);
+		int32_t gy = (int32_t)((samples[4] * gyroScaleQ30) >> 6);
+		int32_t gz = (int32_t)((samples[5] * gyroScaleQ30) >> 6);
+
+		if (ax != 0 || ay != 0 || az != 0) {
+			recipNorm = ns_mahony_rsqrt_q30((uint64_t)(ax * ax + ay * ay + az * az), &shift);
+			ax = (ax * recipNorm) >> shift;
+			ay = (ay * recipNorm) >> shift;
+			az = (az * recipNorm) >> shift;
+
+			int64_t halfvx = ((int64_t)q1 * q3 - (int64_t)q0 * q2) >> 30;
+			int64_t halfvy = ((int64_t)q0 * q1 + (int64_t)q2 * q3) >> 30;
+			int64_t halfvz = (((int64_t)q0 * q0 + (int64_t)q3 * q3) >> 30) - (1 << 29);
+
+			int64_t halfex = (ay * halfvz - az * halfvy) >> 30;
+			int64_t halfey = (az * halfvx - ax * halfvz) >> 30;
+			int64_t halfez = (ax * halfvy - ay * halfvx) >> 30;
+
+			if (useKi) {
+				iFBx += (int32_t)((halfex * kiDtQ30) >> 32);
+				iFBy += (int32_t)((halfey * kiDtQ30) >> 32);
+				iFBz += (int32_t)((halfez * kiDtQ30) >> 32);
+				gx += iFBx >> 4;
+				gy += iFBy >> 4;
+				gz += iFBz >> 4;
+			}
+
+			gx += (int32_t)((halfex * twoKpQ24) >> 30);
+			gy += (int32_t)((halfey * twoKpQ24) >> 30);
+			gz += (int32_t)((halfez * twoKpQ24) >> 30);
+		}
+
+		// Half angles, Q30
+		int64_t hx = (gx * halfDtQ30) >> 24;
+		int64_t hy = (gy * halfDtQ30) >> 24;
+		int64_t hz = (gz * halfDtQ30) >> 24;
+		int64_t qa = q0, qb = q1, qc = q2, qd = q3;
+		qa += (-qb * hx - qc * hy - qd * hz) >> 30;
+		qb += ((int64_t)q0 * hx + qc * hz - qd * hy) >> 30;
+		qc += ((int64_t)q0 * hy - (int64_t)q1 * hz + qd * hx) >> 30;
+		qd += ((int64_t)q0 * hz + (int64_t)q1 * hy - (int64_t)q2 * hx) >> 30;
+
+		recipNorm = ns_mahony_rsqrt_q30((uint64_t)(qa * qa + qb * qb + qc * qc + qd * qd), &shift);
+		q0 = (int32_t)((qa * recipNorm) >> shift);
+		q1 = (int32_t)((qb * recipNorm) >> shift);
+		q2 = (int32_t)((qc * recipNorm) >> shift);
+		q3 = (int32_t)((qd * recipNorm) >> shift);
+	}
+
+	cfg->q0 = q0 * (1.0f / NS_MAHONY_Q30);
+	cfg->q1 = q1 * (1.0f / NS_MAHONY_Q30);
+	cfg->q2 = q2 * (1.0f / NS_MAHONY_Q30);
+	cfg->q3 = q3 * (1.0f / NS_MAHONY_Q30);
+	cfg->integralFBx = iFBx * (1.0f / NS_MAHONY_Q28);
+	cfg->integralFBy = iFBy * (1.0f / NS_MAHONY_Q28);
+	cfg->integralFBz = iFBz * (1.0f / NS_MAHONY_Q28);
+	return NS_STATUS_SUCCESS;
+}
+
+/*
+ * get quaternion, float
+ */
+uint16_t ns_get_quaternion_f(ns_mahony_cfg_t *cfg, float *qw, float *qx, float *qy, float *qz) {
+#ifndef NS_DISABLE_API_VALIDATION
+	if(cfg == NULL || qw == NULL || qx == NULL || qy == NULL || qz == NULL) {
+		return NS_STATUS_INVALID_HANDLE;
+	}
+
+	if (ns_core_check_api(cfg->api, &ns_mahony_oldest_supported_version, &ns_mahony_current_version)) {
+		return NS_STATUS_INVALID_VERSION;
+	}
+#endif
+
+	*qw = cfg->q0;
+	*qx = cfg->q1;
+	*qy = cfg->q2;
+	*qz = cfg->q3;
+	return NS_STATUS_SUCCESS;
+}
+
+/*
+ * get euler angles, float (same sequence as ns_get_RollPitchYaw)
+ */
+uint16_t ns_get_RollPitchYaw_f(ns_mahony_cfg_t *cfg, float *roll, float *pitch, float *yaw) {
+#ifndef NS_DISABLE_API_VALIDATION
+	if(cfg == NULL || roll == NULL || pitch == NULL || yaw == NULL) {
+		return NS_STATUS_INVALID_HANDLE;
+	}
+
+	if (ns_core_check_api(cfg->api, &ns_mahony_oldest_supported_version, &ns_mahony_current_version)) {
+		return NS_STATUS_INVALID_VERSION;
+	}
+#endif
+	float sinp = 2.0f * cfg->q1 * cfg->q3 + 2.0f * cfg->q0 * cfg->q2;
+	sinp = (sinp > 1.0f) ? 1.0f : ((sinp < -1.0f) ? -1.0f : sinp); // rounding past the poles
+	*yaw = atan2f(2.0f * cfg->q1 * cfg->q2 - 2.0f * cfg->q0 * cfg->q3, 2.0f * cfg->q0 * cfg->q0 + 2.0f * cfg->q1 * cfg->q1 - 1.0f + 1e-4f);
+	*pitch = -asinf(sinp);
+	*roll = atan2f(2.0f * cfg->q2 * cfg->q3 - 2.0f * cfg->q0 * cfg->q1, 2.0f * cfg->q0 * cfg->q0 + 2.0f * cfg->q3 * cfg->q3 - 1.0f + 1e-4f);
+	return NS_STATUS_SUCCESS;
+}
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "quaternion.h"
 #include "unity/unity.h"
 #include "ns_core.h"
@@ -160,4 +161,103 @@ void MahonyUpdateTest_InvalidAPIVersion() {
     int status = ns_mahony_init(&mcfg);
     // check if the function returns an error
     TEST_ASSERT_EQUAL(2, status);
-}
\ No newline at end of file
+}
+
+// vectors of the tests above, accel xyz then gyro xyz as consumed by the batched updates
+static const float mahony_vectors[][6] = {
+    {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+    {-40000.0f, 50000.0f, -60000.0f, 10000.0f, -20000.0f, 30000.0f},
+    {-0.4f, -0.5f, -0.6f, -0.1f, -0.2f, -0.3f},
+};
+
+static void mahony_run_reference(ns_mahony_cfg_t *cfg, const float *v, int steps) {
+    cfg->api = &ns_mahony_V0_0_1;
+    ns_mahony_init(cfg);
+    for (int i = 0; i < steps; i++) {
+        ns_mahony_update(cfg, v[3], v[4], v[5], v[0], v[1], v[2]);
+    }
+}
+
+// float32 batch against repeated ns_mahony_update
+void MahonyUpdateTest_BatchMatchesUpdate() {
+    float samples[100 * 6];
+    ns_mahony_cfg_t ref;
+
+    for (int v = 0; v < 3; v++) {
+        for (int i = 0; i < 100; i++) {
+            memcpy(&samples[i * 6], mahony_vectors[v], sizeof(mahony_vectors[v]));
+        }
+        mahony_run_reference(&ref, mahony_vectors[v], 100);
+        ns_mahony_init(&mcfg);
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mahony_update_batch(&mcfg, samples, 60));
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mahony_update_batch(&mcfg, &samples[60 * 6], 40));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q0, mcfg.q0);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q1, mcfg.q1);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q2, mcfg.q2);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q3, mcfg.q3);
+    }
+}
+
+// fixed-point batch against repeated ns_mahony_update, packed and strided samples
+void MahonyUpdateTest_FixedPointBatch() {
+    // the negative inputs vector in LSB, gyro at 1e-4 rad/s per LSB
+    const int16_t raw[6] = {-4000, -5000, -6000, -1000, -2000, -3000};
+    int16_t samples[100 * 10];
+    ns_mahony_cfg_t ref;
+
+    mahony_run_reference(&ref, mahony_vectors[2], 100);
+    for (int stride = 6; stride <= 10; stride += 4) {
+        memset(samples, 0x55, sizeof(samples));
+        for (int i = 0; i < 100; i++) {
+            memcpy(&samples[i * stride], raw, sizeof(raw));
+        }
+        ns_mahony_init(&mcfg);
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mahony_update_batch_q(&mcfg, samples, 100, stride, 1e-4f));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q0, mcfg.q0);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q1, mcfg.q1);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q2, mcfg.q2);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, ref.q3, mcfg.q3);
+    }
+
+    // all-zero inputs leave the quaternion unchanged
+    memset(samples, 0, sizeof(samples));
+    ns_mahony_init(&mcfg);
+    ns_mahony_update_batch_q(&mcfg, samples, 100, 6, 1e-4f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0f, mcfg.q0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0f, mcfg.q1);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0f, mcfg.q2);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0f, mcfg.q3);
+
+    TEST_ASSERT_EQUAL(1, ns_mahony_update_batch_q(0, samples, 1, 6, 1e-4f));
+    TEST_ASSERT_EQUAL(1, ns_mahony_update_batch(&mcfg, 0, 1));
+}
+
+// float getters against the double ones
+void MahonyUpdateTest_FloatGetters() {
+    const float q[][4] = {
+        {1, 0, 0, 0}, {0.7071, 0.7071, 0, 0}, {0.7071, 0, 0.7071, 0}, {0.7071, 0, 0, 0.7071}};
+    double roll, pitch, yaw, qw, qx, qy, qz;
+    float rollf, pitchf, yawf, qwf, qxf, qyf, qzf;
+
+    mcfg.api = &ns_mahony_V0_0_1;
+    for (int i = 0; i < 4; i++) {
+        mcfg.q0 = q[i][0];
+        mcfg.q1 = q[i][1];
+        mcfg.q2 = q[i][2];
+        mcfg.q3 = q[i][3];
+        ns_get_RollPitchYaw(&mcfg, &roll, &pitch, &yaw);
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_get_RollPitchYaw_f(&mcfg, &rollf, &pitchf, &yawf));
+        TEST_ASSERT_FLOAT_WITHIN(0.0002, roll, rollf);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, pitch, pitchf); // asin is steep next to the poles
+        TEST_ASSERT_FLOAT_WITHIN(0.0002, yaw, yawf);
+
+        ns_get_quaternion(&mcfg, &qw, &qx, &qy, &qz);
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_get_quaternion_f(&mcfg, &qwf, &qxf, &qyf, &qzf));
+        TEST_ASSERT_EQUAL_FLOAT(qw, qwf);
+        TEST_ASSERT_EQUAL_FLOAT(qx, qxf);
+        TEST_ASSERT_EQUAL_FLOAT(qy, qyf);
+        TEST_ASSERT_EQUAL_FLOAT(qz, qzf);
+    }
+    TEST_ASSERT_EQUAL(1, ns_get_RollPitchYaw_f(&mcfg, 0, &pitchf, &yawf));
+    TEST_ASSERT_EQUAL(1, ns_get_quaternion_f(&mcfg, &qwf, 0, &qyf, &qzf));
+}
@@ -6,4 +6,7 @@ void MahonyUpdateTest_LargeAccelGyroValues();
 void MahonyUpdateTest_RollPitchYaw();
 void MahonyUpdateTest_NegativeInputs();
 void MahonyUpdateTest_NullPointer();
-void MahonyUpdateTest_InvalidAPIVersion();
\ No newline at end of file
+void MahonyUpdateTest_InvalidAPIVersion();
+void MahonyUpdateTest_BatchMatchesUpdate();
+void MahonyUpdateTest_FixedPointBatch();
+void MahonyUpdateTest_FloatGetters();
\ No newline at end of file
@@ -115,7 +115,47 @@ typedef struct {
 extern void
 ns_TFDebugLogInit(ns_debug_log_init_t *cfg);
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L) || defined(AM_PART_APOLLO330P)
+/// How ns_characterize_model_cfg picks the PMU events it captures
+typedef enum {
+    NS_CHARACTERIZE_FULL,     ///< Every event in ns_pmu_map, one inference per 4 events
+    NS_CHARACTERIZE_ADAPTIVE, ///< A cheap pass, then only the event groups the layers call for
+    NS_CHARACTERIZE_SUBSET,   ///< Only the events listed in ns_characterize_cfg_t
+} ns_characterize_mode_e;
+
+#define NS_CHARACTERIZE_MAX_EVENTS 32 ///< Largest user event list
+#define NS_CHARACTERIZE_MAX_RUNS 24   ///< Inferences an ADAPTIVE or SUBSET plan may use
+#define NS_PMU_NOT_CAPTURED 0xFFFFFFFF ///< Counter value for events the plan skipped
+
+typedef struct {
+    ns_characterize_mode_e mode;
+    const uint32_t *events; ///< ARM_PMU_* ids: the SUBSET, or extra events for ADAPTIVE
+    uint32_t numEvents;     ///< Entries in events, up to NS_CHARACTERIZE_MAX_EVENTS
+    uint32_t numLayers;     ///< As passed to ns_get_layer_counters, used by ADAPTIVE
+    uint32_t rv;            ///< As passed to ns_get_layer_counters, used by ADAPTIVE
+} ns_characterize_cfg_t;
+
 extern uint32_t ns_characterize_model(invoke_fp func);
+
+/**
+ * @brief Characterize a model with a chosen event plan
+ *
+ * FULL behaves like ns_characterize_model. ADAPTIVE first runs cycles, instructions, MVE
+ * instructions and MVE integer MACs, classifies every layer that takes a noticeable share of
+ * the cycles as memory bound, vector compute bound or scalar bound, and then only runs the
+ * event groups those classes need, plus any user events. SUBSET runs exactly the given events.
+ * Readback through ns_get_layer_counters and ns_parse_pmu_stats keeps the full ns_pmu_map
+ * layout; events the plan skipped read as NS_PMU_NOT_CAPTURED.
+ *
+ * @param func - runs one inference
+ * @param cfg - event plan
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG if the plan doesn't fit. An ADAPTIVE plan
+ * is sized for every follow-up group before the cheap pass, so a plan is only ever rejected
+ * before any inference has run.
+ */
+extern uint32_t ns_characterize_model_cfg(invoke_fp func, const ns_characterize_cfg_t *cfg);
+
+/// Inferences the last characterization ran
+extern uint32_t ns_characterize_runs(void);
 extern uint32_t ns_parse_pmu_stats(uint32_t num_layers, uint32_t rv);
 extern uint32_t ns_set_pmu_header(void);
 extern uint32_t ns_get_layer_counters(uint32_t layer,
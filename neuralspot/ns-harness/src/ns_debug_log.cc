@@ -82,6 +82,177 @@ ns_TFDebugLogInit(ns_debug_log_init_t *cfg) {
 #endif
 }
 
+#ifdef NS_MLPROFILE
+#if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L) || defined(AM_PART_APOLLO330P)
+// Event plan of the last characterization: map index captured by each (run * 4 + counter) slot.
+// An empty plan is the full map in order, map index m captured in run m/4, counter m%4.
+static uint16_t ns_characterize_plan[NS_CHARACTERIZE_MAX_RUNS * 4];
+static uint32_t ns_characterize_plan_len = 0;
+static uint32_t ns_characterize_num_runs = 0;
+
+// Adaptive heuristics, applied to the cheap pass
+#define NS_CHARACTERIZE_HOT_SHARE 50       ///< Layers under 1/50 of the cycles aren't followed up
+#define NS_CHARACTERIZE_MEM_IPC_X100 40    ///< Under 0.4 instructions per cycle: memory bound
+#define NS_CHARACTERIZE_MVE_SHARE_X100 25  ///< At least 25% MVE instructions: vector code
+#define NS_CHARACTERIZE_MAC_RATE_X100 25   ///< Under 0.25 MVE MACs per cycle: vector unit stalls
+
+static const uint32_t ns_characterize_cheap[4] = {
+    ARM_PMU_CPU_CYCLES, ARM_PMU_INST_RETIRED, ARM_PMU_MVE_INST_RETIRED,
+    ARM_PMU_MVE_INT_MAC_RETIRED};
+
+// Follow-up groups, one inference each
+#define NS_CHARACTERIZE_GROUPS 5
+static const uint32_t ns_characterize_groups[NS_CHARACTERIZE_GROUPS][4] = {
+    // Memory bound: data cache behaviour and backend stalls
+    {ARM_PMU_L1D_CACHE, ARM_PMU_L1D_CACHE_REFILL, ARM_PMU_L1D_CACHE_MISS_RD,
+     ARM_PMU_STALL_BACKEND},
+    // Memory bound: where the accesses go
+    {ARM_PMU_MEM_ACCESS, ARM_PMU_BUS_ACCESS, ARM_PMU_DTCM_ACCESS, ARM_PMU_ITCM_ACCESS},
+    // Vector code: access patterns the MVE load/store unit handles poorly
+    {ARM_PMU_MVE_LDST_RETIRED, ARM_PMU_MVE_LDST_NONCONTIG_RETIRED,
+     ARM_PMU_MVE_LDST_UNALIGNED_RETIRED, ARM_PMU_MVE_PRED},
+    // Vector MAC layers running below rate: why the vector unit stalls
+    {ARM_PMU_MVE_STALL, ARM_PMU_MVE_STALL_RESOURCE, ARM_PMU_MVE_STALL_DEPENDENCY,
+     ARM_PMU_MVE_STALL_BREAK},
+    // Scalar code: fetch and branch behaviour
+    {ARM_PMU_STALL_FRONTEND, ARM_PMU_BR_MIS_PRED_RETIRED, ARM_PMU_L1I_CACHE_REFILL,
+     ARM_PMU_LD_RETIRED},
+};
+#define NS_CHARACTERIZE_GROUP_MEM (1 << 0)
+#define NS_CHARACTERIZE_GROUP_BUS (1 << 1)
+#define NS_CHARACTERIZE_GROUP_MVE_LDST (1 << 2)
+#define NS_CHARACTERIZE_GROUP_MVE_STALL (1 << 3)
+#define NS_CHARACTERIZE_GROUP_SCALAR (1 << 4)
+
+static int32_t characterize_map_index(uint32_t eventId) {
+    for (uint32_t i = 0; i < NS_NUM_PMU_MAP_SIZE; i++) {
+        if (ns_pmu_map[i].eventId == eventId) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+// Append events to the plan, skipping duplicates and events the map doesn't know
+static uint32_t characterize_plan_add(const uint32_t *events, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t index = characterize_map_index(events[i]);
+        if (index < 0) {
+            ns_lp_printf("Skipping unknown PMU event 0x%x\n", events[i]);
+            continue;
+        }
+        uint32_t slot = 0;
+        while ((slot < ns_characterize_plan_len) &&
+               (ns_characterize_plan[slot] != (uint16_t)index)) {
+            slot++;
+        }
+        if (slot < ns_characterize_plan_len) {
+            continue;
+        }
+        if (ns_characterize_plan_len == NS_CHARACTERIZE_MAX_RUNS * 4) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        ns_characterize_plan[ns_characterize_plan_len++] = (uint16_t)index;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+// Rebuild the plan: the cheap pass (ADAPTIVE), then the given follow-up groups and user events
+static uint32_t characterize_plan_build(const ns_characterize_cfg_t *cfg, uint32_t groups) {
+    ns_characterize_plan_len = 0;
+    if (cfg->mode == NS_CHARACTERIZE_ADAPTIVE) {
+        if ((characterize_plan_add(ns_characterize_cheap, 4) != NS_STATUS_SUCCESS) ||
+            (ns_characterize_plan_len != 4)) {
+            return NS_STATUS_FAILURE;
+        }
+        for (uint32_t g = 0; g < NS_CHARACTERIZE_GROUPS; g++) {
+            if ((groups & (1 << g)) &&
+                (characterize_plan_add(ns_characterize_groups[g], 4) != NS_STATUS_SUCCESS)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+        }
+    }
+    return characterize_plan_add(cfg->events, cfg->numEvents);
+}
+
+// Run one inference capturing the plan's events for the given run
+static void characterize_plan_run(invoke_fp func, uint32_t run) {
+    ns_pmu_reset_config(&ns_microProfilerPMU);
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t slot = run * 4 + i;
+        // Past the end of the plan, count event 0 like the full sweep does
+        uint32_t index = (slot < ns_characterize_plan_len) ? ns_characterize_plan[slot] : 0;
+        ns_pmu_event_create(&(ns_microProfilerPMU.events[i]), ns_pmu_map[index].eventId,
+                            NS_PMU_EVENT_COUNTER_SIZE_32);
+    }
+    ns_pmu_init(&ns_microProfilerPMU);
+    func();
+    ns_lp_printf(".");
+}
+
+// Counter value of map_index for a source layer, wherever the plan captured it
+static uint32_t characterize_counter(uint32_t num_layers, uint32_t source_layer,
+                                     uint32_t source_layer_count, uint32_t map_index) {
+    uint32_t slot = map_index;
+    if (ns_characterize_plan_len != 0) {
+        for (slot = 0; slot < ns_characterize_plan_len; slot++) {
+            if (ns_characterize_plan[slot] == map_index) {
+                break;
+            }
+        }
+        if (slot == ns_characterize_plan_len) {
+            return NS_PMU_NOT_CAPTURED;
+        }
+    }
+    uint32_t index = (num_layers + source_layer) + source_layer_count * (slot / 4);
+    return ns_microProfilerSidecar.pmu_snapshot[index].counterValue[slot % 4];
+}
+
+// Classify the layers from the cheap pass (run 0), returns the follow-up groups they need
+static uint32_t characterize_classify(const ns_characterize_cfg_t *cfg) {
+    uint32_t source_layer_count = cfg->numLayers - cfg->rv * 2;
+    uint32_t memory = 0, vector = 0, scalar = 0, cold = 0;
+    uint32_t groups = 0;
+    uint64_t total = 0;
+
+    for (uint32_t l = 0; l < source_layer_count; l++) {
+        total += characterize_counter(cfg->numLayers, l, source_layer_count, ns_characterize_plan[0]);
+    }
+    for (uint32_t l = 0; l < source_layer_count; l++) {
+        uint64_t cycles = characterize_counter(cfg->numLayers, l, source_layer_count, ns_characterize_plan[0]);
+        uint64_t inst = characterize_counter(cfg->numLayers, l, source_layer_count, ns_characterize_plan[1]);
+        uint64_t mve = characterize_counter(cfg->numLayers, l, source_layer_count, ns_characterize_plan[2]);
+        uint64_t macs = characterize_counter(cfg->numLayers, l, source_layer_count, ns_characterize_plan[3]);
+
+        if ((cycles == 0) || (cycles * NS_CHARACTERIZE_HOT_SHARE < total)) {
+            cold++;
+            continue;
+        }
+        bool is_vector = mve * 100 >= inst * NS_CHARACTERIZE_MVE_SHARE_X100;
+        if (inst * 100 < cycles * NS_CHARACTERIZE_MEM_IPC_X100) {
+            memory++;
+            groups |= NS_CHARACTERIZE_GROUP_MEM | NS_CHARACTERIZE_GROUP_BUS;
+            if (is_vector) {
+                groups |= NS_CHARACTERIZE_GROUP_MVE_LDST;
+            }
+        } else if (is_vector) {
+            vector++;
+            groups |= NS_CHARACTERIZE_GROUP_MVE_LDST;
+            if ((macs != 0) && (macs * 100 < cycles * NS_CHARACTERIZE_MAC_RATE_X100)) {
+                groups |= NS_CHARACTERIZE_GROUP_MVE_STALL;
+            }
+        } else {
+            scalar++;
+            groups |= NS_CHARACTERIZE_GROUP_SCALAR;
+        }
+    }
+    ns_lp_printf("\nLayers: %d memory bound, %d vector, %d scalar, %d below 1/%d of the cycles\n",
+                 memory, vector, scalar, cold, NS_CHARACTERIZE_HOT_SHARE);
+    return groups;
+}
+#endif // AM_PART_APOLLO5B || AM_PART_APOLLO510L || AM_PART_APOLLO330P
+#endif // NS_MLPROFILE
+
 /**
  * @brief Given a model, characterize it by running it repeatedly and capturing PMU events.
  * 
@@ -93,6 +264,8 @@ uint32_t ns_characterize_model(invoke_fp func) {
 #ifdef NS_MLPROFILE
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L) || defined(AM_PART_APOLLO330P)
     uint32_t map_index = 0;
+    ns_characterize_plan_len = 0;
+    ns_characterize_num_runs = 0;
     ns_lp_printf("Starting model characterization, capturing %d (%d/%d) PMU events per layer\n", NS_NUM_PMU_MAP_SIZE, g_ns_pmu_map_length, sizeof(ns_pmu_map_t));
     for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index = map_index + 4) {
         // Init the pmu capture
@@ -113,6 +286,7 @@ uint32_t ns_characterize_model(invoke_fp func) {
         // ns_lp_printf("PMU initialized\n");
         // Run the model
         func();
+        ns_characterize_num_runs++;
         // ns_lp_printf("Model run complete\n");
         ns_lp_printf(".");
     }
@@ -121,6 +295,66 @@ uint32_t ns_characterize_model(invoke_fp func) {
     return NS_STATUS_SUCCESS;
 }
 
+uint32_t ns_characterize_model_cfg(invoke_fp func, const ns_characterize_cfg_t *cfg) {
+#ifdef NS_MLPROFILE
+#if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L) || defined(AM_PART_APOLLO330P)
+    if ((cfg == NULL) || (cfg->mode == NS_CHARACTERIZE_FULL)) {
+        return ns_characterize_model(func);
+    }
+    if ((cfg->numEvents > NS_CHARACTERIZE_MAX_EVENTS) || ((cfg->numEvents != 0) && (cfg->events == NULL)) ||
+        (cfg->numLayers < cfg->rv * 2)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    uint32_t source_layer_count = cfg->numLayers - cfg->rv * 2;
+    ns_characterize_num_runs = 0;
+
+    // Size the plan as if the cheap pass called for every follow-up group, so a plan that can't
+    // fit the sidecar is rejected before any inference has overwritten it
+    uint32_t status = characterize_plan_build(cfg, (1 << NS_CHARACTERIZE_GROUPS) - 1);
+    if (status == (uint32_t)NS_STATUS_FAILURE) {
+        ns_lp_printf("Cheap pass events missing from the PMU map, running the full sweep\n");
+        return ns_characterize_model(func);
+    }
+    if (status != NS_STATUS_SUCCESS) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    uint32_t runs = (ns_characterize_plan_len + 3) / 4;
+    if (cfg->numLayers + source_layer_count * runs > NS_PROFILER_MAX_EVENTS) {
+        ns_lp_printf("Characterization needs more than %d profiler events\n", NS_PROFILER_MAX_EVENTS);
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    if (cfg->mode == NS_CHARACTERIZE_ADAPTIVE) {
+        ns_lp_printf("Starting adaptive model characterization\n");
+        characterize_plan_build(cfg, 0);
+        characterize_plan_run(func, 0);
+        ns_characterize_num_runs = 1;
+        characterize_plan_build(cfg, characterize_classify(cfg));
+        runs = (ns_characterize_plan_len + 3) / 4;
+    } else {
+        ns_lp_printf("Starting model characterization of %d selected PMU events\n", cfg->numEvents);
+    }
+    for (uint32_t run = ns_characterize_num_runs; run < runs; run++) {
+        characterize_plan_run(func, run);
+    }
+    ns_characterize_num_runs = runs;
+    ns_lp_printf("\nCaptured %d of %d PMU events in %d inferences (full sweep: %d)\n",
+                 ns_characterize_plan_len, NS_NUM_PMU_MAP_SIZE, runs, (NS_NUM_PMU_MAP_SIZE + 3) / 4);
+    return NS_STATUS_SUCCESS;
+#endif
+#endif
+    return ns_characterize_model(func);
+}
+
+uint32_t ns_characterize_runs(void) {
+#ifdef NS_MLPROFILE
+#if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L) || defined(AM_PART_APOLLO330P)
+    return ns_characterize_num_runs;
+#endif
+#endif
+    return 0;
+}
+
 /**
  * @brief  Searches for the "CALL_ONCE" layer in the global profiler stats array.
  *
@@ -234,15 +468,12 @@ ns_get_layer_counters(uint32_t layer,
     // ns_lp_printf("Layer %d, source layer %d, source layer count %d\n", layer, source_layer, source_layer_count);
 
     // 5. For each PMU counter index (map_index), compute the "non-obvious" index
-    //    and extract the PMU counter from the sidecar
+    //    and extract the PMU counter from the sidecar. Events the characterization
+    //    plan skipped come back as NS_PMU_NOT_CAPTURED.
     for (uint32_t map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++)
     {
-        // index formula from the snippet
-        uint32_t index = (num_layers + source_layer) + source_layer_count * (map_index / 4);
-        // retrieve the PMU snapshot (mocked by g_ns_microProfilerSidecar)
-        uint32_t counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[map_index % 4];
-        // ns_lp_printf("Layer %d, map_index %d, index %d, counterValue %d\n", layer, map_index, index, counterValue);
-        out_counters[map_index] = counterValue;
+        out_counters[map_index] =
+            characterize_counter(num_layers, source_layer, source_layer_count, map_index);
     }
 #endif
 #endif
@@ -362,10 +593,12 @@ uint32_t ns_parse_pmu_stats(uint32_t num_layers, uint32_t rv) {
                 } else {
                     source_layer = print_layer;
                 }
-                uint32_t index = (num_layers + source_layer) + source_layer_count * (map_index/4);
-                uint32_t counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[map_index%4];
-                // ns_lp_printf(", (%d, %d, %d,)%u", index, map_index, source_layer, counterValue);
-                ns_lp_printf(", %u", counterValue);
+                uint32_t counterValue = characterize_counter(num_layers, source_layer, source_layer_count, map_index);
+                if (counterValue == NS_PMU_NOT_CAPTURED) {
+                    ns_lp_printf(", ");
+                } else {
+                    ns_lp_printf(", %u", counterValue);
+                }
             // source_layer++;
             }
         }
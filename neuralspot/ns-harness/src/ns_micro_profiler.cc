@@ -23,6 +23,7 @@ limitations under the License.
 #if defined(NS_MLPROFILE)
 
     #include "ns_debug_log.h"
+    #include "ns_trace.h"
     #include "tensorflow/lite/micro/micro_profiler.h"
 
     #include <cinttypes>
@@ -69,6 +70,7 @@ MicroProfiler::BeginEvent(const char *tag) {
 
     // real_event++;
     tags_[num_events_] = tag;
+    NS_TRACE_BEGIN(tag);
     start_ticks_[num_events_] = ns_us_ticker_read(ns_microProfilerTimer);
     ns_reset_perf_counters();
     // #ifndef AM_PART_APOLLO5A
@@ -103,6 +105,7 @@ MicroProfiler::EndEvent(uint32_t event_handle) {
     TFLITE_DCHECK(event_handle < kMaxEvents);
 
     end_ticks_[event_handle] = ns_us_ticker_read(ns_microProfilerTimer);
+    NS_TRACE_END(tags_[event_handle]);
     #if not defined(AM_PART_APOLLO5B) && not defined(AM_PART_APOLLO5A) && not defined(AM_PART_APOLLO510L) && not defined(AM_PART_APOLLO330P)
     ns_cache_dump_t c;
     ns_capture_cache_stats(&c);
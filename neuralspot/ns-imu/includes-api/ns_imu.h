@@ -21,6 +21,7 @@ extern "C" {
 #include "ns_core.h"
 #include "ns_spi.h"
 #include "ns_i2c.h"
+#include "ns_imu_fifo.h"
 
 #define NS_IMU_V0_0_1                                                                          \
     { .major = 0, .minor = 0, .revision = 1 }
@@ -38,6 +39,13 @@ extern const ns_core_api_t ns_imu_current_version;
 
 // Define the callback function type
 typedef void (*ns_imu_frame_available_cb)(void *arg); // arg is the ns_imu_config_t struct
+// Called with the raw bytes of every FIFO burst (e.g. to record dumps for host testing)
+typedef void (*ns_imu_fifo_burst_cb)(const uint8_t *raw, uint32_t bytes);
+
+/// Most FIFO packets read per burst (one SPI transaction of at most 4095 bytes)
+#ifndef NS_IMU_FIFO_MAX_BURST
+    #define NS_IMU_FIFO_MAX_BURST 255
+#endif
 
 typedef enum {
     NS_IMU_SENSOR_ICM45605,
@@ -70,12 +78,24 @@ typedef struct {
     uint32_t       frame_size;
     ns_imu_sensor_data_t *frame_buffer;
 
+    // FIFO mode configuration - set fifo_watermark and window (and frame_available_cb) to
+    // enable. The IMU interrupts once per fifo_watermark samples; the next ns_imu_fifo_poll
+    // reads the buffered samples in one SPI burst and appends them to window, and
+    // frame_available_cb is called (from ns_imu_fifo_poll) whenever a window completes.
+    // frame_size and frame_buffer are unused in this mode.
+    uint32_t             fifo_watermark; /// Samples per interrupt, 1..NS_IMU_FIFO_MAX_BURST
+    ns_imu_window_t     *window;         /// Initialized by ns_imu_configure
+    ns_imu_fifo_burst_cb fifo_burst_cb;  /// Optional raw burst tap
+
     // Internal state
     void            *imu_dev_handle; // IMU device handle
     ns_spi_config_t *spi_cfg;        // SPI configuration
     uint32_t        calibrated;
     float           accel_bias[3];   // bias to subtract from accel_g
     float           gyro_bias[3];    // bias to subtract from gyro_dps
+    ns_imu_fifo_unpacker_t fifo_unpacker; // FIFO packet parser state
+    uint32_t        fifo_bursts;     // SPI bursts read by ns_imu_fifo_poll on this config
+    uint32_t        fifo_samples;    // samples unpacked by ns_imu_fifo_poll on this config
 } ns_imu_config_t;
 
 
@@ -98,6 +118,30 @@ uint32_t ns_imu_configure(ns_imu_config_t *cfg); // Will soft reset and configur
 uint32_t ns_imu_get_data(ns_imu_config_t *cfg, ns_imu_sensor_data_t *data);
 uint32_t ns_imu_get_raw_data(ns_imu_config_t *cfg, ns_imu_sensor_data_t *data);
 
+/**
+ * @brief FIFO mode: service the last watermark interrupt, from thread context
+ *
+ * The interrupt only flags that the watermark was reached. Call this from the main loop (e.g.
+ * after waking from ns_deep_sleep): it reads the interrupt status and the buffered packets in
+ * one SPI burst, appends them to cfg->window, updates cfg->fifo_bursts and cfg->fifo_samples,
+ * and calls frame_available_cb if a window completed. Does nothing if no interrupt is pending.
+ * Poll at least once per watermark period or the IMU FIFO overflows.
+ *
+ * @param cfg Config struct passed to ns_imu_configure
+ * @return uint32_t status
+ */
+uint32_t ns_imu_fifo_poll(ns_imu_config_t *cfg);
+
+/**
+ * @brief Per-axis conversion from raw LSB to natural units (g, dps), including calibration
+ * biases, for use with ns_imu_window_to_float
+ *
+ * @param cfg Config struct
+ * @param scale Filled in with gain and bias for accel xyz, gyro xyz
+ * @return uint32_t status
+ */
+uint32_t ns_imu_get_axis_scale(ns_imu_config_t *cfg, ns_imu_axis_scale_t *scale);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,141 @@
+/**
+ * @file ns_imu_fifo.h
+ * @author Ambiq
+ * @brief IMU FIFO packet unpacking and sliding window batching
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * In FIFO mode the IMU buffers samples and interrupts once per watermark, and the driver
+ * reads every buffered packet in one burst. This layer turns those raw bursts into
+ * timestamped int16 samples, keeps them in a sliding window ring, and converts a whole
+ * window to model input at once (float in natural units, or z-score normalized int8).
+ *
+ * It has no hardware dependencies so it can be exercised on a PC with recorded FIFO dumps.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_IMU_FIFO
+#define NS_IMU_FIFO
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Bytes per FIFO packet with accel + gyro enabled (header, 6x int16, temp, timestamp)
+#define NS_IMU_FIFO_PACKET_SIZE 16
+/// Accel X/Y/Z followed by gyro X/Y/Z
+#define NS_IMU_AXES 6
+
+/// Ring capacity needed so a ready window isn't overwritten before the next burst completes
+#define NS_IMU_WINDOW_CAPACITY(window_len, max_burst) ((window_len) + (max_burst))
+
+typedef struct {
+    int16_t data[NS_IMU_AXES]; ///< accel xyz, gyro xyz, in LSB
+    int8_t temp;               ///< temperature in LSB
+    uint32_t timestamp_us;     ///< unwrapped sensor timestamp
+} ns_imu_raw_sample_t;
+
+/// Unpacker state carried between bursts
+typedef struct {
+    bool big_endian;          ///< Sensor data endianness (inv_imu_device_t.endianness_data)
+    uint32_t ts_resolution_us; ///< FIFO timestamp LSB in us (1 or 16)
+
+    // Internal state
+    bool started;
+    uint16_t last_ts;
+    uint32_t time_us;
+    uint32_t invalid; ///< Packets skipped because they were empty or malformed
+} ns_imu_fifo_unpacker_t;
+
+/// Sliding window over the sample stream
+typedef struct {
+    ns_imu_raw_sample_t *buffer; ///< Ring storage, capacity samples
+    uint32_t capacity;           ///< >= window_len, see NS_IMU_WINDOW_CAPACITY
+    uint32_t window_len;         ///< Samples per window
+    uint32_t hop;                ///< Samples between consecutive windows
+
+    // Internal state
+    uint32_t total;       ///< Samples pushed since init
+    uint32_t ready_end;   ///< total at the end of the latest complete window
+    volatile bool ready;  ///< A window is waiting to be converted
+    uint32_t windows;     ///< Windows completed
+    uint32_t overruns;    ///< Windows completed before the previous one was converted
+} ns_imu_window_t;
+
+/// Per-axis linear conversion: value = raw * gain - bias
+typedef struct {
+    float gain[NS_IMU_AXES];
+    float bias[NS_IMU_AXES];
+} ns_imu_axis_scale_t;
+
+/**
+ * @brief Reset the unpacker (e.g. after the FIFO was flushed)
+ */
+void ns_imu_fifo_unpacker_reset(ns_imu_fifo_unpacker_t *u);
+
+/**
+ * @brief Unpack a burst of 16-byte FIFO packets
+ *
+ * Packets without both accel and gyro data, or flagged invalid by the sensor, are skipped
+ * (and counted in u->invalid). The 16-bit sensor timestamp is unwrapped into a 32-bit
+ * microsecond count, which requires at least one sample per 65536 timestamp LSBs.
+ *
+ * @param u unpacker state
+ * @param raw FIFO bytes, as read from FIFO_DATA
+ * @param bytes number of bytes (trailing partial packets are ignored)
+ * @param out unpacked samples
+ * @param max_out capacity of out
+ * @return uint32_t number of samples written to out
+ */
+uint32_t ns_imu_fifo_unpack(
+    ns_imu_fifo_unpacker_t *u, const uint8_t *raw, uint32_t bytes, ns_imu_raw_sample_t *out,
+    uint32_t max_out);
+
+/**
+ * @brief Initialize a window. buffer, capacity, window_len and hop must be set.
+ *
+ * @return uint32_t NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+uint32_t ns_imu_window_init(ns_imu_window_t *w);
+
+/**
+ * @brief Append samples to the window ring
+ *
+ * @return true if at least one window completed
+ */
+bool ns_imu_window_push(ns_imu_window_t *w, const ns_imu_raw_sample_t *samples, uint32_t n);
+
+/**
+ * @brief Sample i (0 is the oldest) of the latest complete window
+ */
+const ns_imu_raw_sample_t *ns_imu_window_sample(const ns_imu_window_t *w, uint32_t i);
+
+/**
+ * @brief Convert the latest complete window to float, window_len x NS_IMU_AXES, oldest first.
+ * Clears the ready flag.
+ */
+void ns_imu_window_to_float(ns_imu_window_t *w, const ns_imu_axis_scale_t *scale, float *out);
+
+/**
+ * @brief Z-score normalize each axis of the latest complete window and quantize it into an
+ * int8 tensor, window_len x NS_IMU_AXES, oldest first. Clears the ready flag.
+ *
+ * Normalization is invariant to per-axis gain and bias, so it works directly on the raw
+ * samples: mean and variance are accumulated in integers and each element costs one
+ * multiply-add.
+ *
+ * @param w window
+ * @param scale quantization scale of the input tensor
+ * @param zero_point quantization zero point of the input tensor
+ * @param out int8 tensor
+ */
+void ns_imu_window_zscore_int8(ns_imu_window_t *w, float scale, int32_t zero_point, int8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // NS_IMU_FIFO
@@ -28,6 +28,11 @@ const ns_core_api_t ns_imu_current_version = {
 ns_spi_config_t static ns_imu_spi_config;
 ns_imu_config_t static ns_imu_config; // config struct, needed for ISR
 uint32_t static ns_imu_frame_buffer_index = 0;
+uint8_t static ns_imu_fifo_burst[NS_IMU_FIFO_MAX_BURST * NS_IMU_FIFO_PACKET_SIZE];
+bool static volatile ns_imu_fifo_pending = false; // watermark interrupt not yet serviced
+
+// Samples are unpacked and appended to the window in chunks of this many
+#define NS_IMU_FIFO_UNPACK_CHUNK 16
 
 // ISR for the IMU
 // #ifndef NS_GPIO0_203F_IRQn
@@ -44,8 +49,63 @@ uint32_t static ns_imu_frame_buffer_index = 0;
 // }
 // #endif
 
+// FIFO mode: read every buffered packet in one burst and append it to the window
+static uint32_t ns_imu_fifo_service(ns_imu_config_t *cfg) {
+    ns_imu_raw_sample_t samples[NS_IMU_FIFO_UNPACK_CHUNK];
+    uint32_t packets;
+    bool window_ready = false;
+
+    if (ns_imu_ICM_45605_read_fifo(cfg, ns_imu_fifo_burst, NS_IMU_FIFO_MAX_BURST, &packets) !=
+        NS_STATUS_SUCCESS) {
+        ns_lp_printf("NS_IMU: Failed to read FIFO\n");
+        return NS_STATUS_FAILURE;
+    }
+    const uint32_t bytes = packets * NS_IMU_FIFO_PACKET_SIZE;
+    cfg->fifo_bursts++;
+    if (cfg->fifo_burst_cb) {
+        cfg->fifo_burst_cb(ns_imu_fifo_burst, bytes);
+    }
+
+    for (uint32_t offset = 0; offset < bytes;
+         offset += NS_IMU_FIFO_UNPACK_CHUNK * NS_IMU_FIFO_PACKET_SIZE) {
+        uint32_t chunk = bytes - offset;
+        if (chunk > NS_IMU_FIFO_UNPACK_CHUNK * NS_IMU_FIFO_PACKET_SIZE) {
+            chunk = NS_IMU_FIFO_UNPACK_CHUNK * NS_IMU_FIFO_PACKET_SIZE;
+        }
+        uint32_t n = ns_imu_fifo_unpack(
+            &cfg->fifo_unpacker, ns_imu_fifo_burst + offset, chunk, samples,
+            NS_IMU_FIFO_UNPACK_CHUNK);
+        cfg->fifo_samples += n;
+        window_ready |= ns_imu_window_push(cfg->window, samples, n);
+    }
+    if (window_ready) {
+        cfg->frame_available_cb(cfg);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_imu_fifo_poll(ns_imu_config_t *cfg) {
+    if ((cfg == NULL) || (cfg->fifo_watermark == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (!ns_imu_fifo_pending) {
+        return NS_STATUS_SUCCESS;
+    }
+    // Cleared before the read, so a watermark reached during the burst is serviced next poll
+    ns_imu_fifo_pending = false;
+    if (ns_imu_ICM_45605_handle_interrupt() == 0) {
+        return NS_STATUS_SUCCESS;
+    }
+    return ns_imu_fifo_service(cfg);
+}
+
 void ns_imu_data_available_cb(void *pArg) {
     // Called when the IMU fires an interrupt
+    if (ns_imu_config.fifo_watermark) {
+        // The status read and the burst are SPI transfers, left to ns_imu_fifo_poll
+        ns_imu_fifo_pending = true;
+        return;
+    }
     ns_imu_sensor_data_t *data = &(ns_imu_config.frame_buffer[ns_imu_frame_buffer_index]);
     uint32_t data_available = ns_imu_ICM_45605_handle_interrupt();
     if (data_available == 0) {
@@ -98,6 +158,17 @@ uint32_t ns_imu_configure(ns_imu_config_t *cfg) {
     }
 #endif
 
+    if (cfg->fifo_watermark) {
+        if ((cfg->fifo_watermark > NS_IMU_FIFO_MAX_BURST) || (cfg->frame_available_cb == NULL) ||
+            (cfg->window == NULL) || (ns_imu_window_init(cfg->window) != NS_STATUS_SUCCESS)) {
+            ns_lp_printf("NS_IMU: Invalid FIFO mode configuration\n");
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        cfg->fifo_bursts = 0;
+        cfg->fifo_samples = 0;
+        ns_imu_fifo_pending = false;
+    }
+
     ns_imu_spi_config.iom = cfg->iom;
 
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510L)
@@ -219,4 +290,13 @@ uint32_t ns_imu_get_raw_data(ns_imu_config_t *cfg, ns_imu_sensor_data_t *data) {
         ns_lp_printf("ICM45605: Sensor not supported\n");
     }
     return NS_STATUS_FAILURE;
-}
\ No newline at end of file
+}
+
+uint32_t ns_imu_get_axis_scale(ns_imu_config_t *cfg, ns_imu_axis_scale_t *scale) {
+    if (cfg->sensor == NS_IMU_SENSOR_ICM45605) {
+        return ns_imu_ICM45605_get_axis_scale(cfg, scale);
+    } else {
+        ns_lp_printf("ICM45605: Sensor not supported\n");
+    }
+    return NS_STATUS_FAILURE;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file ns_imu_fifo.c
+ * @author Ambiq
+ * @brief IMU FIFO packet unpacking and sliding window batching
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_imu_fifo.h"
+#include "ns_core.h"
+#include <math.h>
+
+// FIFO packet header bits (see fifo_header_t in the TDK driver)
+#define NS_IMU_FIFO_HDR_EXT 0x80
+#define NS_IMU_FIFO_HDR_ACCEL 0x40
+#define NS_IMU_FIFO_HDR_GYRO 0x20
+#define NS_IMU_FIFO_HDR_20BITS 0x10
+#define NS_IMU_FIFO_HDR_TIMESTAMP 0x08
+
+// Value the sensor reports for samples it couldn't produce
+#define NS_IMU_FIFO_INVALID ((int16_t)0x8000)
+
+static inline int16_t ns_imu_fifo_read16(const uint8_t *p, bool big_endian) {
+    return big_endian ? (int16_t)((p[0] << 8) | p[1]) : (int16_t)((p[1] << 8) | p[0]);
+}
+
+void ns_imu_fifo_unpacker_reset(ns_imu_fifo_unpacker_t *u) {
+    u->started = false;
+    u->last_ts = 0;
+    u->time_us = 0;
+    u->invalid = 0;
+}
+
+uint32_t ns_imu_fifo_unpack(
+    ns_imu_fifo_unpacker_t *u, const uint8_t *raw, uint32_t bytes, ns_imu_raw_sample_t *out,
+    uint32_t max_out) {
+    const uint32_t resolution = u->ts_resolution_us ? u->ts_resolution_us : 1;
+    uint32_t n = 0;
+
+    for (; (bytes >= NS_IMU_FIFO_PACKET_SIZE) && (n < max_out);
+         raw += NS_IMU_FIFO_PACKET_SIZE, bytes -= NS_IMU_FIFO_PACKET_SIZE) {
+        const uint8_t header = raw[0];
+        if ((header & (NS_IMU_FIFO_HDR_EXT | NS_IMU_FIFO_HDR_20BITS)) ||
+            ((header & (NS_IMU_FIFO_HDR_ACCEL | NS_IMU_FIFO_HDR_GYRO)) !=
+             (NS_IMU_FIFO_HDR_ACCEL | NS_IMU_FIFO_HDR_GYRO))) {
+            u->invalid++;
+            continue;
+        }
+
+        ns_imu_raw_sample_t *s = &out[n];
+        for (int i = 0; i < NS_IMU_AXES; i++) {
+            s->data[i] = ns_imu_fifo_read16(&raw[1 + 2 * i], u->big_endian);
+        }
+        if ((s->data[0] == NS_IMU_FIFO_INVALID) || (s->data[3] == NS_IMU_FIFO_INVALID)) {
+            u->invalid++;
+            continue;
+        }
+        s->temp = (int8_t)raw[13];
+
+        // Unwrap the 16-bit timestamp: the difference is taken modulo 2^16
+        if (header & NS_IMU_FIFO_HDR_TIMESTAMP) {
+            uint16_t ts = (uint16_t)ns_imu_fifo_read16(&raw[14], u->big_endian);
+            if (u->started) {
+                u->time_us += (uint16_t)(ts - u->last_ts) * resolution;
+            }
+            u->last_ts = ts;
+            u->started = true;
+        }
+        s->timestamp_us = u->time_us;
+        n++;
+    }
+    return n;
+}
+
+uint32_t ns_imu_window_init(ns_imu_window_t *w) {
+    if (w == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((w->buffer == NULL) || (w->window_len == 0) || (w->hop == 0) ||
+        (w->capacity < w->window_len)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    w->total = 0;
+    w->ready_end = 0;
+    w->ready = false;
+    w->windows = 0;
+    w->overruns = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_imu_window_push(ns_imu_window_t *w, const ns_imu_raw_sample_t *samples, uint32_t n) {
+    bool completed = false;
+    for (uint32_t i = 0; i < n; i++) {
+        w->buffer[w->total % w->capacity] = samples[i];
+        w->total++;
+        if ((w->total >= w->window_len) && (((w->total - w->window_len) % w->hop) == 0)) {
+            if (w->ready) {
+                w->overruns++;
+            }
+            w->ready_end = w->total;
+            w->ready = true;
+            w->windows++;
+            completed = true;
+        }
+    }
+    return completed;
+}
+
+const ns_imu_raw_sample_t *ns_imu_window_sample(const ns_imu_window_t *w, uint32_t i) {
+    return &w->buffer[(w->ready_end - w->window_len + i) % w->capacity];
+}
+
+void ns_imu_window_to_float(ns_imu_window_t *w, const ns_imu_axis_scale_t *scale, float *out) {
+    w->ready = false;
+    uint32_t idx = (w->ready_end - w->window_len) % w->capacity;
+    for (uint32_t i = 0; i < w->window_len; i++) {
+        const int16_t *d = w->buffer[idx].data;
+        for (int a = 0; a < NS_IMU_AXES; a++) {
+            *out++ = d[a] * scale->gain[a] - scale->bias[a];
+        }
+        idx = (idx + 1 == w->capacity) ? 0 : idx + 1;
+    }
+}
+
+void ns_imu_window_zscore_int8(ns_imu_window_t *w, float scale, int32_t zero_point, int8_t *out) {
+    int32_t sum[NS_IMU_AXES] = {0};
+    int64_t sum_sq[NS_IMU_AXES] = {0};
+    float gain[NS_IMU_AXES];
+    float offset[NS_IMU_AXES];
+    const uint32_t n = w->window_len;
+    const uint32_t first = (w->ready_end - n) % w->capacity;
+
+    w->ready = false;
+
+    // Exact integer statistics of the raw samples
+    uint32_t idx = first;
+    for (uint32_t i = 0; i < n; i++) {
+        const int16_t *d = w->buffer[idx].data;
+        for (int a = 0; a < NS_IMU_AXES; a++) {
+            sum[a] += d[a];
+            sum_sq[a] += (int32_t)d[a] * d[a];
+        }
+        idx = (idx + 1 == w->capacity) ? 0 : idx + 1;
+    }
+
+    // q = ((x - mean) / std) / scale + zero_point = x * gain + offset
+    for (int a = 0; a < NS_IMU_AXES; a++) {
+        int64_t var_n2 = (int64_t)n * sum_sq[a] - (int64_t)sum[a] * sum[a]; // var * n^2
+        if (var_n2 <= 0) {
+            gain[a] = 0.0f; // constant axis normalizes to 0
+            offset[a] = (float)zero_point;
+        } else {
+            gain[a] = (float)n / (sqrtf((float)var_n2) * scale);
+            offset[a] = zero_point - ((float)sum[a] / n) * gain[a];
+        }
+    }
+
+    idx = first;
+    for (uint32_t i = 0; i < n; i++) {
+        const int16_t *d = w->buffer[idx].data;
+        for (int a = 0; a < NS_IMU_AXES; a++) {
+            int32_t q = (int32_t)floorf(d[a] * gain[a] + offset[a] + 0.5f);
+            *out++ = (int8_t)((q < -128) ? -128 : ((q > 127) ? 127 : q));
+        }
+        idx = (idx + 1 == w->capacity) ? 0 : idx + 1;
+    }
+}
@@ -11,6 +11,7 @@
 
 #include "ns_imu.h"
 #include "imu/inv_imu_driver.h"
+#include "imu/inv_imu_driver_advanced.h"
 #include "ns_imu_icm45605_driver.h"
 #include "ns_ambiqsuite_harness.h"
 
@@ -158,7 +159,17 @@ uint32_t ns_imu_ICM45605_configure_interrupts(ns_imu_config_t *cfg) {
     }
 	/* Interrupts configuration */
 	memset(&int_config, INV_IMU_DISABLE, sizeof(int_config));
-	int_config.INV_UI_DRDY = INV_IMU_ENABLE;
+    if (cfg->fifo_watermark) {
+        // FIFO mode: one interrupt per watermark instead of one per sample
+        status = ns_imu_ICM45605_configure_fifo(cfg);
+        if (status != NS_STATUS_SUCCESS) {
+            ns_lp_printf("NS_IMU ICM: Failed to configure FIFO\n");
+            return status;
+        }
+        int_config.INV_FIFO_THS = INV_IMU_ENABLE;
+    } else {
+        int_config.INV_UI_DRDY = INV_IMU_ENABLE;
+    }
 	status = inv_imu_set_config_int(cfg->imu_dev_handle, INV_IMU_INT2, &int_config);
 
     return status;
@@ -167,7 +178,74 @@ uint32_t ns_imu_ICM45605_configure_interrupts(ns_imu_config_t *cfg) {
 uint32_t ns_imu_ICM_45605_handle_interrupt(void) {
     inv_imu_int_state_t int_state;
     inv_imu_get_int_status(&ns_imu_icm45605_dev, INV_IMU_INT2, &int_state);
-    return int_state.INV_UI_DRDY ? 1 : 0;
+    return (int_state.INV_UI_DRDY || int_state.INV_FIFO_THS) ? 1 : 0;
+}
+
+uint32_t ns_imu_ICM45605_configure_fifo(ns_imu_config_t *cfg) {
+    inv_imu_fifo_config_t fifo_config;
+    uint32_t status = NS_STATUS_SUCCESS;
+
+    // 16us timestamps wrap every ~1s, so any ODR of at least 1Hz unwraps unambiguously
+    status |= inv_imu_adv_set_timestamp_resolution(
+        &ns_imu_icm45605_dev, TMST_WOM_CONFIG_TMST_RESOL_16_US);
+
+    // Accel + gyro packets are 16 bytes: header, 6x int16, temp, timestamp
+    status |= inv_imu_get_fifo_config(&ns_imu_icm45605_dev, &fifo_config);
+    fifo_config.gyro_en    = INV_IMU_ENABLE;
+    fifo_config.accel_en   = INV_IMU_ENABLE;
+    fifo_config.hires_en   = INV_IMU_DISABLE;
+    fifo_config.fifo_wm_th = (uint16_t)cfg->fifo_watermark;
+    fifo_config.fifo_mode  = FIFO_CONFIG0_FIFO_MODE_STREAM;
+    fifo_config.fifo_depth = FIFO_CONFIG0_FIFO_DEPTH_MAX;
+    status |= inv_imu_set_fifo_config(&ns_imu_icm45605_dev, &fifo_config);
+    status |= inv_imu_flush_fifo(&ns_imu_icm45605_dev);
+
+    cfg->fifo_unpacker.big_endian = ns_imu_icm45605_dev.endianness_data;
+    cfg->fifo_unpacker.ts_resolution_us = 16;
+    ns_imu_fifo_unpacker_reset(&cfg->fifo_unpacker);
+    return status ? NS_STATUS_FAILURE : NS_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Read every buffered FIFO packet (up to max_packets) in a single SPI burst
+ *
+ * @param cfg Config struct
+ * @param buf Destination, at least max_packets * NS_IMU_FIFO_PACKET_SIZE bytes
+ * @param max_packets Most packets to read
+ * @param packets Number of packets read
+ * @return uint32_t status
+ */
+uint32_t ns_imu_ICM_45605_read_fifo(
+    ns_imu_config_t *cfg, uint8_t *buf, uint32_t max_packets, uint32_t *packets) {
+    uint16_t count = 0;
+    *packets = 0;
+    if (inv_imu_get_frame_count(&ns_imu_icm45605_dev, &count) != INV_IMU_OK) {
+        return NS_STATUS_FAILURE;
+    }
+    if (count > max_packets) {
+        count = max_packets; // the rest is picked up by the next burst
+    }
+    if (count == 0) {
+        return NS_STATUS_SUCCESS;
+    }
+    if (ns_imu_icm45605_read_reg(FIFO_DATA, buf, count * NS_IMU_FIFO_PACKET_SIZE)) {
+        return NS_STATUS_FAILURE;
+    }
+    *packets = count;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_imu_ICM45605_get_axis_scale(ns_imu_config_t *cfg, ns_imu_axis_scale_t *scale) {
+    if (cfg == NULL || scale == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    for (int i = 0; i < 3; i++) {
+        scale->gain[i]     = ns_imu_accel_map[cfg->accel_fsr] / 32768;
+        scale->gain[i + 3] = ns_imu_gyro_map[cfg->gyro_fsr] / 32768;
+        scale->bias[i]     = cfg->calibrated ? cfg->accel_bias[i] : 0.0f;
+        scale->bias[i + 3] = cfg->calibrated ? cfg->gyro_bias[i] : 0.0f;
+    }
+    return NS_STATUS_SUCCESS;
 }
 
 
@@ -15,3 +15,7 @@ uint32_t ns_imu_ICM_45606_get_data(ns_imu_config_t *cfg, ns_imu_sensor_data_t *d
 uint32_t ns_imu_ICM_45606_get_raw_data(ns_imu_config_t *cfg, ns_imu_sensor_data_t *data);
 uint32_t ns_imu_ICM45605_configure_interrupts(ns_imu_config_t *cfg);
 uint32_t ns_imu_ICM_45605_handle_interrupt(void);
+uint32_t ns_imu_ICM45605_configure_fifo(ns_imu_config_t *cfg);
+uint32_t ns_imu_ICM_45605_read_fifo(
+    ns_imu_config_t *cfg, uint8_t *buf, uint32_t max_packets, uint32_t *packets);
+uint32_t ns_imu_ICM45605_get_axis_scale(ns_imu_config_t *cfg, ns_imu_axis_scale_t *scale);
@@ -0,0 +1,58 @@
+/**
+ * @file ns_model_cascade.h
+ * @author Ambiq
+ * @brief ns_model as an ns_cascade stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Copies each frame into the model's first input tensor (unless the frame already is that
+ * tensor), invokes it, and scores the frame with one element of the first output tensor,
+ * dequantized for int8/uint8/int16 outputs.
+ *
+ * For a power-gated arena, bankPower switches the SRAM bank holding it. TFLM keeps the
+ * arena's persistent data (tensor and operator state) at its end and the activations, which
+ * every Invoke rewrites, at its start, so a bank that only holds the start of the arena can be
+ * turned off between invocations as is. If the whole arena loses power, reinit has to rebuild
+ * the interpreter before the next invoke, and streaming state (variable tensors) starts over.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_CASCADE
+    #define NS_MODEL_CASCADE
+    #include "ns_cascade.h"
+    #include "ns_model.h"
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+/// Stage context, configured by the application
+typedef struct {
+    ns_model_state_t *ms;                ///< Model after ns_model_init
+    uint32_t scoreIndex;                 ///< Output tensor 0 element used as the score
+    uint32_t (*bankPower)(bool on);      ///< Optional, switches the arena's SRAM bank
+    int (*reinit)(ns_model_state_t *ms); ///< Optional, after bankPower(true)
+} ns_model_cascade_ctx_t;
+
+/**
+ * @brief Wrap an initialized model as a cascade stage
+ *
+ * Sets name, run, ctx and, when ctx->bankPower is set, power; the gate thresholds, lookback
+ * and powerOffDelay are left to the caller.
+ *
+ * @param s - stage to fill in
+ * @param ctx - configured context, must outlive the cascade
+ * @return NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+extern uint32_t ns_model_cascade_stage(ns_cascade_stage_t *s, ns_model_cascade_ctx_t *ctx);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @}*/
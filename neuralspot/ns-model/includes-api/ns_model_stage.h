@@ -0,0 +1,58 @@
+/**
+ * @file ns_model_stage.h
+ * @author Ambiq
+ * @brief ns_model as an ns_pipeline stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Feeds a window of upstream items (features, PCM) to the model's first input tensor, invokes
+ * it, and outputs the raw bytes of the first output tensor. Float items are quantized when
+ * the input tensor is int8; otherwise the item size has to match the tensor element size.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_STAGE
+    #define NS_MODEL_STAGE
+    #include "ns_model.h"
+    #include "ns_pipeline.h"
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+/// Stage context, filled in by ns_model_stage
+typedef struct {
+    ns_model_state_t *ms; ///< Initialized model
+    bool quantize;        ///< Float items into an int8 input tensor
+} ns_model_stage_ctx_t;
+
+/**
+ * @brief Wrap an initialized model as a pipeline stage
+ *
+ * With frame == hop and window == NULL the upstream stage writes straight into the input
+ * tensor. A sliding window (hop < frame) needs its own window buffer, because TFLM may reuse
+ * the input tensor's memory for intermediate tensors during Invoke.
+ *
+ * @param s - stage to fill in
+ * @param ctx - stage context, must outlive the pipeline
+ * @param ms - model state after ns_model_init
+ * @param item_bytes - size of one upstream item (4 for float features)
+ * @param frame - items per invocation, must fill the input tensor
+ * @param hop - items between invocations
+ * @param window - frame * item_bytes bytes, or NULL to use the input tensor when hop == frame
+ * @return NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+extern uint32_t ns_model_stage(
+    ns_pipeline_stage_t *s, ns_model_stage_ctx_t *ctx, ns_model_state_t *ms, uint16_t item_bytes,
+    uint16_t frame, uint16_t hop, void *window);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @}*/
@@ -0,0 +1,115 @@
+/**
+ * @file ns_model_stream.h
+ * @author Ambiq
+ * @brief Sliding-window (and streaming) inference on top of ns_model
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Sliding-window models (KWS, HAR, ...) see mostly the same input on every call: a 1s KWS
+ * window with a 20ms hop shares 98% of its features with the previous one. ns_model_stream
+ * owns that window, so the application only pushes the new data:
+ *
+ *   - Windowed models: the window is kept in a linear buffer with slack for a few extra hops.
+ *     New data is appended at the tail and the window is simply the last input-tensor-sized
+ *     run of the buffer; only when the tail reaches the end is the window moved back to the
+ *     front, once per (bufferSize - window) / hopBytes hops. The window is copied into the input
+ *     tensor right before Invoke (TFLM may reuse input tensor memory for intermediate tensors
+ *     during Invoke, so it can't hold the history itself).
+ *   - Streaming models (exported with state in variable tensors or resource variables, see
+ *     ns_model_state_t.rv_arena, whose input is just the new hops): with buffer == NULL the
+ *     hops are written straight into the input tensor, and the model's own state carries the
+ *     history, so every invoke costs one hop of work instead of a window.
+ *
+ * The model is invoked every hopsPerInvoke hops once a full window is available, and the
+ * optional onOutput callback reads the output tensors.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_STREAM
+    #define NS_MODEL_STREAM
+    #include "ns_model.h"
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+typedef struct ns_model_stream ns_model_stream_t;
+
+/// Called after every successful invoke, with the output tensors in s->ms->model_output
+typedef void (*ns_model_stream_cb)(ns_model_stream_t *s, void *user);
+
+struct ns_model_stream {
+    // Configuration (init by application)
+    ns_model_state_t *ms;       ///< Model after ns_model_init, input tensor 0 is streamed
+    uint32_t hopBytes;          ///< New input bytes per hop, e.g. one feature frame
+    uint16_t hopsPerInvoke;     ///< Invoke every this many hops (0 is taken as 1)
+    uint8_t *buffer;            ///< Window buffer, or NULL for a streaming model (see above)
+    uint32_t bufferSize;        ///< At least the input tensor's bytes plus one hop
+    ns_model_stream_cb onOutput; ///< Optional
+    void *user;                 ///< Passed to onOutput
+
+    // State (init by ns_model_stream_init)
+    uint32_t windowBytes; ///< Input tensor bytes
+    uint32_t tail;        ///< End of the data in buffer (or the input tensor)
+    uint32_t fill;        ///< Valid bytes before tail, up to windowBytes
+    uint32_t hopFill;     ///< Bytes of the hop being received
+    uint32_t hops;        ///< Complete hops since the last invoke
+    uint32_t invokes;     ///< Successful invokes
+    uint32_t moves;       ///< Times the window was moved back to the front of buffer
+};
+
+/**
+ * @brief Check the configuration against the model and start with an empty window
+ *
+ * A streaming model (buffer == NULL) needs an input tensor of exactly hopsPerInvoke * hopBytes
+ * bytes. A windowed one needs a tensor of at least one hop and a buffer of at least the
+ * tensor's bytes plus one hop; each extra hop of buffer saves that many window moves.
+ *
+ * @param s - stream, configuration filled in
+ * @return NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+extern uint32_t ns_model_stream_init(ns_model_stream_t *s);
+
+/**
+ * @brief Append input data, invoking the model as windows complete
+ *
+ * Any number of bytes can be pushed at a time: hops are counted as hopBytes boundaries are
+ * crossed, and one push may invoke the model several times (onOutput runs after each).
+ *
+ * @param s - initialized stream
+ * @param data - new input, in the input tensor's element format
+ * @param bytes - size of data
+ * @return NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if an invoke failed (the rest of data is
+ *         dropped)
+ */
+extern uint32_t ns_model_stream_push(ns_model_stream_t *s, const void *data, uint32_t bytes);
+
+/**
+ * @brief The current window, oldest byte first (windowed models)
+ *
+ * @param s - initialized stream
+ * @return the last windowBytes bytes pushed, contiguous, or NULL before a full window
+ */
+extern const uint8_t *ns_model_stream_window(ns_model_stream_t *s);
+
+/**
+ * @brief Drop the window and clear the model's variable tensors and resource variables
+ *
+ * For a new utterance or after a gap in the input, so stale history doesn't leak into the
+ * next result.
+ *
+ * @param s - initialized stream
+ * @return NS_STATUS_SUCCESS or NS_STATUS_FAILURE
+ */
+extern uint32_t ns_model_stream_reset(ns_model_stream_t *s);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @}*/
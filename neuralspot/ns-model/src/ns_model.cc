@@ -13,6 +13,7 @@
 #include "ns_model.h"
 #include "ns_ambiqsuite_harness.h"
 #include "ns_debug_log.h"
+#include "ns_trace.h"
 
 // Tensorflow Lite for Microcontroller includes (somewhat boilerplate)
 // #include "tensorflow/lite/micro/all_ops_resolver.h"
@@ -103,7 +104,9 @@ ns_model_init(ns_model_state_t *ms) {
     ms->interpreter = &static_interpreter;
 
     // Allocate memory from the tensor_arena for the model's tensors.
+    NS_TRACE_BEGIN("model_allocate");
     TfLiteStatus allocate_status = ms->interpreter->AllocateTensors();
+    NS_TRACE_END("model_allocate");
 
     if (allocate_status != kTfLiteOk) {
         TF_LITE_REPORT_ERROR(ms->error_reporter, "AllocateTensors() failed");
@@ -0,0 +1,85 @@
+/**
+ * @file ns_model_cascade.cc
+ * @author Ambiq
+ * @brief ns_model as an ns_cascade stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ns_model_cascade.h"
+#include "ns_trace.h"
+
+static uint32_t ns_model_cascade_run(void *ctx, const void *frame, float *score) {
+    ns_model_cascade_ctx_t *c = (ns_model_cascade_ctx_t *)ctx;
+    TfLiteTensor *input = c->ms->model_input[0];
+    TfLiteTensor *output = c->ms->model_output[0];
+
+    if (frame != input->data.raw) {
+        memcpy(input->data.raw, frame, input->bytes);
+    }
+    NS_TRACE_BEGIN("model_invoke");
+    TfLiteStatus invoke_status = c->ms->interpreter->Invoke();
+    NS_TRACE_END("model_invoke");
+    if (invoke_status != kTfLiteOk) {
+        return NS_STATUS_FAILURE;
+    }
+
+    float scale = output->params.scale;
+    int32_t zp = output->params.zero_point;
+    switch (output->type) {
+    case kTfLiteFloat32:
+        *score = output->data.f[c->scoreIndex];
+        break;
+    case kTfLiteInt8:
+        *score = (output->data.int8[c->scoreIndex] - zp) * scale;
+        break;
+    case kTfLiteUInt8:
+        *score = (output->data.uint8[c->scoreIndex] - zp) * scale;
+        break;
+    case kTfLiteInt16:
+        *score = (output->data.i16[c->scoreIndex] - zp) * scale;
+        break;
+    default:
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_model_cascade_power(void *ctx, bool on) {
+    ns_model_cascade_ctx_t *c = (ns_model_cascade_ctx_t *)ctx;
+
+    if (c->bankPower(on) != NS_STATUS_SUCCESS) {
+        return NS_STATUS_FAILURE;
+    }
+    if (on && (c->reinit != NULL) && (c->reinit(c->ms) != NS_STATUS_SUCCESS)) {
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_cascade_stage(ns_cascade_stage_t *s, ns_model_cascade_ctx_t *ctx) {
+    ns_model_state_t *ms = ctx->ms;
+
+    if ((ms == NULL) || (ms->state != READY) || (ms->numInputTensors == 0) ||
+        (ms->numOutputTensors == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    TfLiteTensor *output = ms->model_output[0];
+    uint32_t elementBytes = (output->type == kTfLiteFloat32)  ? 4
+                            : (output->type == kTfLiteInt16) ? 2
+                                                              : 1;
+    if ((ctx->scoreIndex + 1) * elementBytes > output->bytes) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    s->name = "model";
+    s->run = ns_model_cascade_run;
+    s->ctx = ctx;
+    s->power = (ctx->bankPower != NULL) ? ns_model_cascade_power : NULL;
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file ns_model_stage.cc
+ * @author Ambiq
+ * @brief ns_model as an ns_pipeline stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "ns_model_stage.h"
+#include "ns_trace.h"
+
+static uint32_t ns_model_stage_run(void *ctx, const void *in, void *out) {
+    ns_model_stage_ctx_t *c = (ns_model_stage_ctx_t *)ctx;
+    TfLiteTensor *input = c->ms->model_input[0];
+    TfLiteTensor *output = c->ms->model_output[0];
+
+    if (c->quantize) {
+        const float *x = (const float *)in;
+        float scale = input->params.scale;
+        int32_t zp = input->params.zero_point;
+        for (uint32_t i = 0; i < input->bytes; i++) {
+            int32_t q = (int32_t)roundf(x[i] / scale) + zp;
+            input->data.int8[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    } else if (in != input->data.raw) {
+        memcpy(input->data.raw, in, input->bytes);
+    }
+
+    NS_TRACE_BEGIN("model_invoke");
+    TfLiteStatus invoke_status = c->ms->interpreter->Invoke();
+    NS_TRACE_END("model_invoke");
+    if (invoke_status != kTfLiteOk) {
+        return NS_STATUS_FAILURE;
+    }
+    memcpy(out, output->data.raw, output->bytes);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stage(
+    ns_pipeline_stage_t *s, ns_model_stage_ctx_t *ctx, ns_model_state_t *ms, uint16_t item_bytes,
+    uint16_t frame, uint16_t hop, void *window) {
+    if ((ms == NULL) || (ms->state != READY) || (ms->numInputTensors == 0) ||
+        (ms->numOutputTensors == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    TfLiteTensor *input = ms->model_input[0];
+
+    ctx->ms = ms;
+    ctx->quantize = (input->type == kTfLiteInt8) && (item_bytes == sizeof(float));
+    uint32_t tensor_items = ctx->quantize ? input->bytes : input->bytes / item_bytes;
+    if ((tensor_items != frame) || (!ctx->quantize && (input->bytes % item_bytes))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->name = "model";
+    s->run = ns_model_stage_run;
+    s->ctx = ctx;
+    s->item_bytes = item_bytes;
+    s->frame = frame;
+    s->hop = hop;
+    s->out_bytes = ms->model_output[0]->bytes;
+    s->window = (uint8_t *)window;
+    if (window == NULL) {
+        if (ctx->quantize || (hop != frame)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        // Upstream output lands directly in the input tensor
+        s->window = input->data.uint8;
+    }
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file ns_model_stream.cc
+ * @author Ambiq
+ * @brief Sliding-window (and streaming) inference on top of ns_model
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ns_model_stream.h"
+#include "ns_trace.h"
+
+static uint32_t ns_model_stream_invoke(ns_model_stream_t *s) {
+    TfLiteTensor *input = s->ms->model_input[0];
+
+    if (s->buffer != NULL) {
+        memcpy(input->data.raw, s->buffer + s->tail - s->windowBytes, s->windowBytes);
+    }
+    NS_TRACE_BEGIN("model_invoke");
+    TfLiteStatus invoke_status = s->ms->interpreter->Invoke();
+    NS_TRACE_END("model_invoke");
+    if (invoke_status != kTfLiteOk) {
+        return NS_STATUS_FAILURE;
+    }
+    s->invokes++;
+    if (s->onOutput != NULL) {
+        s->onOutput(s, s->user);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stream_init(ns_model_stream_t *s) {
+    ns_model_state_t *ms = s->ms;
+
+    if ((ms == NULL) || (ms->state != READY) || (ms->numInputTensors == 0) ||
+        (s->hopBytes == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (s->hopsPerInvoke == 0) {
+        s->hopsPerInvoke = 1;
+    }
+    s->windowBytes = ms->model_input[0]->bytes;
+    if (s->buffer == NULL) {
+        // Streaming model: the input tensor holds exactly the hops of one invoke
+        if (s->windowBytes != s->hopsPerInvoke * s->hopBytes) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    } else if ((s->windowBytes < s->hopBytes) || (s->bufferSize < s->windowBytes + s->hopBytes)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    s->tail = 0;
+    s->fill = 0;
+    s->hopFill = 0;
+    s->hops = 0;
+    s->invokes = 0;
+    s->moves = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stream_push(ns_model_stream_t *s, const void *data, uint32_t bytes) {
+    const uint8_t *src = (const uint8_t *)data;
+    uint8_t *dst = (s->buffer != NULL) ? s->buffer : s->ms->model_input[0]->data.uint8;
+
+    while (bytes > 0) {
+        uint32_t n = s->hopBytes - s->hopFill;
+        if (n > bytes) {
+            n = bytes;
+        }
+        if ((s->buffer != NULL) && (s->tail + n > s->bufferSize)) {
+            // Out of slack: move the window back to the front, the only copy of old data
+            memmove(s->buffer, s->buffer + s->tail - s->fill, s->fill);
+            s->tail = s->fill;
+            s->moves++;
+        }
+        memcpy(dst + s->tail, src, n);
+        s->tail += n;
+        s->fill = (s->fill + n < s->windowBytes) ? s->fill + n : s->windowBytes;
+        s->hopFill += n;
+        src += n;
+        bytes -= n;
+
+        if (s->hopFill < s->hopBytes) {
+            continue;
+        }
+        s->hopFill = 0;
+        if ((++s->hops < s->hopsPerInvoke) || (s->fill < s->windowBytes)) {
+            continue;
+        }
+        s->hops = 0;
+        if (s->buffer == NULL) {
+            // The model's state carries the history; the next hops start a new input
+            s->tail = 0;
+            s->fill = 0;
+        }
+        if (ns_model_stream_invoke(s) != NS_STATUS_SUCCESS) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+const uint8_t *ns_model_stream_window(ns_model_stream_t *s) {
+    if ((s->buffer == NULL) || (s->fill < s->windowBytes)) {
+        return NULL;
+    }
+    return s->buffer + s->tail - s->windowBytes;
+}
+
+uint32_t ns_model_stream_reset(ns_model_stream_t *s) {
+    s->tail = 0;
+    s->fill = 0;
+    s->hopFill = 0;
+    s->hops = 0;
+    // Variable tensors and resource variables (rv_arena) back to their initial values
+    if (s->ms->interpreter->Reset() != kTfLiteOk) {
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#ifndef __AFFINE_PACKED_H__
+#define __AFFINE_PACKED_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "activation.h"
+
+/*
+        Compressed weight tables for the NNSP FC/LSTM kernels.
+
+        The dense int8 kernels read every weight from flash on every frame, so they are bound
+        by weight bandwidth. Two compressed row formats cut the bytes read:
+
+        4x16 (packed 4-bit, per-row scale)
+            w[r][k] = s[r] * q[r][k], q in [-8, 7], s in [1, 255]
+            Each row is 1 scale byte followed by the nibbles, 16 inputs per 8 bytes: byte j of
+            input group g holds q[16g + j] in its low nibble and q[16g + 8 + j] in its high
+            nibble. A last group of n < 16 inputs is split at h = (n + 1) / 2 the same way, in
+            h bytes. A row therefore needs AFFINE_4X16_ROW_BYTES(dim_input), half its int8
+            size plus the scale.
+
+        sparse_8x16 (block-sparse int8)
+            Inputs are split into 8-wide blocks. Each row is a bitmap of its nonzero blocks
+            (bit b of byte b/8 for block b, AFFINE_SPARSE_MASK_BYTES(dim_input) bytes) followed
+            by the int8 weights of those blocks only; a last partial block keeps its real width.
+            Zero blocks are neither stored nor multiplied.
+
+        Rows are stored in the order the layer consumes them (groups of up to 4 rows, the
+        LSTM gates i, j, f, o per group), each row complete, so a table is walked front to back
+        like the int8 ones and *pp_kernel is left after the rows used. Unlike the ARM_OPTIMIZED
+        == 1 int8 tables there is no interleaving: the same table serves the Cortex-M4, Helium
+        and host builds. tools/ns_nnsp_weight_pack.py converts existing int8 tables and
+        switches the layer functions in a NeuralNetClass definition.
+
+        All functions take the arguments of their 8x16 counterparts (affine.h, lstm.h), with
+        pp_kernel/p_kernel pointing at a packed table, so they drop into NeuralNetClass.layer_func.
+        A 4x16 table whose s*q products fit in int8 gives exactly the output of the 8x16 kernel
+        on those products.
+*/
+#define AFFINE_4X16_ROW_BYTES(dim_input)                                                           \
+    (1 + 8 * ((dim_input) >> 4) + ((((dim_input)&15) + 1) >> 1))
+#define AFFINE_SPARSE_BLOCK 8
+#define AFFINE_SPARSE_MASK_BYTES(dim_input) (((((dim_input) + 7) >> 3) + 7) >> 3)
+
+int affine_Krows_4x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int16_t **pp_bias, int16_t *input,
+    int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int64_t *pt_accum, int8_t is_out, void *(*act)(void *, int32_t *, int));
+
+int affine_Krows_sparse_8x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int16_t **pp_bias, int16_t *input,
+    int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int64_t *pt_accum, int8_t is_out, void *(*act)(void *, int32_t *, int));
+
+int rc_Krows_4x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int8_t **pp_kernel_rec,
+    int16_t **pp_bias, int16_t *input, int16_t *input_rec, int16_t dim_input, int16_t dim_input_rec,
+    int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input, int16_t qbit_input_rec,
+    void *(*act)(void *, int32_t *, int));
+
+int rc_Krows_sparse_8x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int8_t **pp_kernel_rec,
+    int16_t **pp_bias, int16_t *input, int16_t *input_rec, int16_t dim_input, int16_t dim_input_rec,
+    int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input, int16_t qbit_input_rec,
+    void *(*act)(void *, int32_t *, int));
+
+int fc_4x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *input_rec, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int));
+
+int fc_sparse_8x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *input_rec, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int));
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -20,6 +20,7 @@ extern "C" {
 #endif // AM_PART_APOLLO5B || AM_PART_APOLLO510L || AM_PART_APOLLO330P
 
 #define ARM_FFT 1       // fft using CMSIS
+#define STFT_OLA 1      // stft with circular overlap-add buffers (spectrogram_module.h)
 #define DEBUG_NNID 0
 #ifdef __cplusplus
 }
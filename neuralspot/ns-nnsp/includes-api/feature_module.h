@@ -20,6 +20,7 @@ typedef struct {
     const int32_t *pt_norm_stdR;
     int8_t qbit_output;
     void *pt_dcrm;
+    int32_t *pspec; // scratch, only used inside FeatureClass_execute
 } FeatureClass;
 
 void FeatureClass_construct(
@@ -33,6 +34,23 @@ void FeatureClass_construct(
         int16_t fftsize,
         const int16_t *pt_stft_win_coeff);
 
+/*
+    FeatureClass_construct_arena: same as FeatureClass_construct, but the STFT and
+    power spectrum buffers come from an arena stage named "nnsp_feat".
+    Returns 0 on success.
+*/
+int FeatureClass_construct_arena(
+        FeatureClass *ps,
+        const int32_t *norm_mean,
+        const int32_t *norm_stdR,
+        int8_t qbit_output,
+        int16_t num_mfltrBank,
+        int16_t winsize,
+        int16_t hopsize,
+        int16_t fftsize,
+        const int16_t *pt_stft_win_coeff,
+        ns_arena_t *arena);
+
 void FeatureClass_setDefault(FeatureClass *ps);
 
 void FeatureClass_execute(FeatureClass *ps, int16_t *input);
@@ -0,0 +1,24 @@
+#ifndef __FEATURE_STAGE_H__
+#define __FEATURE_STAGE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "feature_module.h"
+#include "ns_pipeline.h"
+
+/*
+    FeatureClass_stage: wraps a constructed FeatureClass as an ns_pipeline stage.
+    Consumes one STFT hop of int16 samples per invocation and outputs the newest
+    normalized feature vector (dim_feat int16). The FeatureClass keeps its own
+    context history. window holds hopsize samples, or is NULL for a first stage
+    fed whole hops.
+*/
+void FeatureClass_stage(
+        ns_pipeline_stage_t *s,
+        FeatureClass *ps,
+        int16_t *window);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -17,6 +17,19 @@ int lstm_8x16(
     int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
     int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int));
 
+// lstm_8x16 on compressed tables, see affine_packed.h
+int lstm_4x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int));
+
+int lstm_sparse_8x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int));
+
 int lstm_8x16_acc32b(
     int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
     int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
@@ -5,6 +5,7 @@ extern "C" {
 #endif
 #include <stdint.h>
 #include "activation.h"
+#include "ns_arena.h"
 typedef enum { fc, lstm } NET_LAYER_TYPE;
 
 typedef struct {
@@ -22,11 +23,18 @@ typedef struct {
     int8_t *pt_kernel[10];
     int16_t *pt_bias[10];
     int8_t *pt_kernel_rec[10];
+    int16_t *pt_scratch[2]; // ping-pong layer buffers (set by NeuralNetClass_init*)
 
 } NeuralNetClass;
 
 void NeuralNetClass_init(NeuralNetClass *pt_inst);
 
+/*
+    NeuralNetClass_init_arena: take the ping-pong layer buffers from an arena
+    stage named "nnsp_net", sized for this net's layers. Returns 0 on success.
+*/
+int NeuralNetClass_init_arena(NeuralNetClass *pt_inst, ns_arena_t *arena);
+
 void NeuralNetClass_setDefault(NeuralNetClass *pt_inst);
 
 void NeuralNetClass_exe(
@@ -7,6 +7,7 @@ This module integrates neural nets, feature extraction & post processing
 extern "C" {
 #endif
 #include <stdint.h>
+#include "ns_arena.h"
 
 typedef struct {
     int16_t samplingRate;
@@ -37,6 +38,8 @@ typedef struct {
     void *pt_state_nnid;
     PARAMS_NNSP *pt_params;
     void *pt_dcrm;
+    int32_t *pt_nn_output; // NN output of the last inference
+    int16_t *pt_input_tmp; // DC-removed input (SE only)
 } NNSPClass;
 
 int NNSPClass_init(
@@ -44,6 +47,19 @@ int NNSPClass_init(
     const int32_t *pt_stdR, int16_t *pt_thresh_prob, int16_t *pt_th_count_trigger,
     PARAMS_NNSP *pt_params);
 
+/*
+    NNSPClass_init_arena: same as NNSPClass_init, but every per-instance buffer
+    (NN output, SE output, STFT state, and the feature and NN scratch) comes from
+    an arena, so several instances don't share the module's static buffers and
+    the feature and NN scratch overlay each other. Read results through
+    pt_inst->pt_nn_output rather than NNSPClass_get_nn_out.
+    Returns 0 on success (or when arena is a planning arena).
+*/
+int NNSPClass_init_arena(
+    NNSPClass *pt_inst, void *pt_net, void *pt_feat, char nn_id, const int32_t *pt_mean,
+    const int32_t *pt_stdR, int16_t *pt_thresh_prob, int16_t *pt_th_count_trigger,
+    PARAMS_NNSP *pt_params, ns_arena_t *arena);
+
 int NNSPClass_reset(NNSPClass *pt_inst);
 int16_t NNSPClass_get_nnOut_dim(NNSPClass *pt_inst);
 int16_t NNSPClass_get_nn_out(int32_t *output, int len);
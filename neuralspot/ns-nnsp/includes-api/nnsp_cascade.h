@@ -0,0 +1,23 @@
+#ifndef __NNSP_CASCADE_H__
+#define __NNSP_CASCADE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "nn_speech.h"
+#include "ns_cascade.h"
+
+/*
+    NNSPClass_cascade_stage: wraps an initialized NNSPClass as an ns_cascade stage
+    that runs NNSPClass_exec on one STFT hop of int16 samples per frame. The score is
+    the class-1 probability for the binary classifiers (vad_id, kws_galaxy_id), the
+    best enrolled-speaker correlation for nnid_id (0 until is_get_corr is set), and
+    the trigger for the others. An se_id instance scales the frame in place, so it
+    has to be the last stage. Only name, run and ctx are set: thresholds, lookback
+    and power hooks are left to the caller.
+*/
+void NNSPClass_cascade_stage(ns_cascade_stage_t *s, NNSPClass *pt_inst);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
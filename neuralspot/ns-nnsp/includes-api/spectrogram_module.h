@@ -9,10 +9,13 @@ extern "C" {
     #include <arm_math.h>
 #endif
 #include "ambiq_nnsp_const.h"
+#include "ns_arena.h"
 typedef struct {
     int16_t len_win;
     int16_t hop;
     int16_t len_fft;
+    int16_t inPos;  // oldest input sample in dataBuffer, used by the _ola functions
+    int16_t outPos; // oldest overlap-add sum in odataBuffer, used by the _ola functions
     int16_t *dataBuffer;
     int32_t *odataBuffer;
     const int16_t *window;
@@ -21,12 +24,22 @@ typedef struct {
     arm_rfft_instance_q31 ifft_st;
 #endif
     int32_t *spec;
+    int32_t *fft_buf; // scratch, only used inside analyze/synthesize
 } stftModule;
 
 int stftModule_construct(
     stftModule *ps, int16_t len_win, int16_t hopsize, int16_t fftsize,
     const int16_t *pt_stft_win_coeff);
 
+/*
+    stftModule_construct_arena: same as stftModule_construct, but the per-instance
+    buffers come from an arena instead of the module's static buffers.
+    Returns 0 on success.
+*/
+int stftModule_construct_arena(
+    stftModule *ps, int16_t len_win, int16_t hopsize, int16_t fftsize,
+    const int16_t *pt_stft_win_coeff, ns_arena_t *arena);
+
 int stftModule_setDefault(stftModule *ps);
 
 #if ARM_FFT == 0
@@ -47,6 +60,34 @@ int stftModule_analyze_arm(
     int16_t fftsize, int16_t *pt_qbit_out);
 
 int stftModule_synthesize_arm(void *ps_t, int32_t *spec, int16_t *output);
+
+/*
+    Overlap-add engine: the same transforms as stftModule_analyze_arm and
+    stftModule_synthesize_arm, bit-exact with them, but dataBuffer and odataBuffer are used
+    as circular buffers (inPos/outPos) instead of being shifted by a hop every frame.
+    Windowing, overlap-add, output saturation and clearing take a single pass over
+    each buffer. Any len_win/hop/window table works, e.g. stft_win_coeff_w480_h160.
+    Use either these or the _arm functions on a given stftModule, not both.
+*/
+int stftModule_analyze_ola(
+    void *ps_t,
+    int16_t *fft_in_q16, // q15
+    int32_t *spec,       // q21
+    int16_t fftsize, int16_t *pt_qbit_out);
+
+int stftModule_synthesize_ola(void *ps_t, int32_t *spec, int16_t *output);
+
+/*
+    stftModule_synthesize_masked_ola: applies a Q15 mask to bins
+    [start_bin, start_bin + num_bins) of spec (in place, other bins are zeroed),
+    then runs the inverse stft as stftModule_synthesize_ola.
+*/
+int stftModule_synthesize_masked_ola(
+    void *ps_t,
+    int32_t *spec,       // Q21
+    const int16_t *mask, // Q15, indexed by bin
+    int start_bin, int num_bins,
+    int16_t *output);    // Q15
 #endif
 
 #ifdef __cplusplus
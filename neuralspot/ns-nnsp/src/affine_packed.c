@@ -0,0 +1,299 @@
+#include "ambiq_nnsp_debug.h"
+#include "ambiq_stdint.h"
+#include "minmax.h"
+#include "activation.h"
+#include "affine.h"
+#include "affine_packed.h"
+#include <arm_math.h>
+#if ARM_OPTIMIZED == 3
+    #include <arm_mve.h>
+#endif
+
+typedef int (*affine_krows_t)(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int16_t **pp_bias, int16_t *input,
+    int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int64_t *pt_accum, int8_t is_out, void *(*act)(void *, int32_t *, int));
+
+#if ARM_OPTIMIZED == 3
+/*
+    Sum of q[k] * input[k] over one 4x16 row: each 8-byte load gives the weights of two
+    8-input vectors, the low nibbles sign-extended by shifting left 12 then right 12, the high
+    ones by 8 then 12. The last group splits at h, its unused lanes predicated off.
+*/
+static int64_t dot_4x16(const uint8_t *pw, const int16_t *pi, int n) {
+    int64_t acc = 0;
+    for (; n > 0; n -= 16, pw += 8, pi += 16) {
+        int h = (n >= 16) ? 8 : (n + 1) >> 1;
+        mve_pred16_t p_lo = vctp16q(h);
+        mve_pred16_t p_hi = vctp16q(MIN(n, 16) - h);
+        int16x8_t w = vreinterpretq_s16_u16(vldrbq_z_u16(pw, p_lo));
+        acc = vmlaldavaq_s16(acc, vshrq_n_s16(vshlq_n_s16(w, 12), 12), vldrhq_z_s16(pi, p_lo));
+        acc = vmlaldavaq_s16(acc, vshrq_n_s16(vshlq_n_s16(w, 8), 12), vldrhq_z_s16(pi + h, p_hi));
+    }
+    return acc;
+}
+
+// Sum over the nonzero blocks of one sparse row, leaves *ppw after the row
+static int64_t dot_sparse_8x16(const int8_t **ppw, const int16_t *pi, int n) {
+    const uint8_t *mask = (const uint8_t *)*ppw;
+    const int8_t *pw = *ppw + AFFINE_SPARSE_MASK_BYTES(n);
+    int blocks = (n + 7) >> 3;
+    int64_t acc = 0;
+    for (int b0 = 0; b0 < blocks; b0 += 8) {
+        uint32_t m = *mask++;
+        while (m) {
+            int b = b0 + __builtin_ctz(m);
+            int w = MIN(n - (b << 3), AFFINE_SPARSE_BLOCK);
+            mve_pred16_t p = vctp16q(w);
+            m &= m - 1;
+            acc = vmlaldavaq_s16(acc, vldrbq_z_s16(pw, p), vldrhq_z_s16(pi + (b << 3), p));
+            pw += w;
+        }
+    }
+    *ppw = pw;
+    return acc;
+}
+
+// Same alignment, bias and rounding as the Helium affine_Krows_8x16
+static int affine_packed_out(
+    int16_t dim_output, int16_t **pp_output, int16_t **pp_bias, int16_t qbit_kernel,
+    int16_t qbit_bias, int16_t qbit_input, int64_t *pt_accum, int8_t is_out,
+    void *(*act)(void *, int32_t *, int)) {
+    int16_t *p_bias = *pp_bias;
+    __attribute__((aligned(16))) int32_t acc32[4];
+    int i;
+    int lshift;
+    int qbit_s;
+
+    if (p_bias == 0)
+        qbit_s = qbit_input + qbit_kernel;
+    else
+        qbit_s = MAX(15, qbit_input + qbit_kernel);
+
+    lshift = (qbit_input + qbit_kernel) - qbit_s;
+    if (lshift != 0) {
+        for (i = 0; i < dim_output; i++)
+            pt_accum[i] = sqrshrl(pt_accum[i], lshift);
+    }
+    if (p_bias != 0) {
+        lshift = qbit_bias - qbit_s;
+        for (i = 0; i < dim_output; i++) {
+            pt_accum[i] += (lshift == 0) ? (int64_t)*p_bias : sqrshrl((int64_t)*p_bias, lshift);
+            p_bias++;
+        }
+    }
+    if (is_out) {
+        lshift = qbit_s - 15;
+        if (lshift != 0) {
+            for (i = 0; i < dim_output; i++)
+                pt_accum[i] = sqrshrl(pt_accum[i], lshift);
+        }
+        for (i = 0; i < dim_output; i++)
+            acc32[i] = (int32_t)MIN(MAX(pt_accum[i], MIN_INT32_T), MAX_INT32_T);
+        *pp_output = (int16_t *)(*act)(*pp_output, acc32, dim_output);
+    }
+    *pp_bias = p_bias;
+    return 0;
+}
+#else
+static int64_t dot_4x16(const uint8_t *pw, const int16_t *pi, int n) {
+    int64_t acc = 0;
+    int32_t sum;
+    int j;
+    for (; n >= 16; n -= 16, pw += 8, pi += 16) {
+        sum = 0;
+        for (j = 0; j < 8; j++) {
+            sum += (int32_t)((int8_t)(pw[j] << 4) >> 4) * pi[j];
+            sum += (int32_t)((int8_t)pw[j] >> 4) * pi[8 + j];
+        }
+        acc += sum;
+    }
+    // Last group, split at h
+    int h = (n + 1) >> 1;
+    for (j = 0; j < h; j++)
+        acc += (int32_t)((int8_t)(pw[j] << 4) >> 4) * pi[j];
+    for (j = 0; j < n - h; j++)
+        acc += (int32_t)((int8_t)pw[j] >> 4) * pi[h + j];
+    return acc;
+}
+
+static int64_t dot_sparse_8x16(const int8_t **ppw, const int16_t *pi, int n) {
+    const uint8_t *mask = (const uint8_t *)*ppw;
+    const int8_t *pw = *ppw + AFFINE_SPARSE_MASK_BYTES(n);
+    int blocks = (n + 7) >> 3;
+    int64_t acc = 0;
+    for (int b0 = 0; b0 < blocks; b0 += 8) {
+        uint32_t m = *mask++;
+        while (m) {
+            int b = b0 + __builtin_ctz(m);
+            int w = MIN(n - (b << 3), AFFINE_SPARSE_BLOCK);
+            const int16_t *x = pi + (b << 3);
+            int32_t sum = 0;
+            m &= m - 1;
+            for (int j = 0; j < w; j++)
+                sum += (int32_t)pw[j] * x[j];
+            acc += sum;
+            pw += w;
+        }
+    }
+    *ppw = pw;
+    return acc;
+}
+
+// Same alignment, bias and truncation as the portable and Cortex-M4 affine_Krows_8x16
+static int affine_packed_out(
+    int16_t dim_output, int16_t **pp_output, int16_t **pp_bias, int16_t qbit_kernel,
+    int16_t qbit_bias, int16_t qbit_input, int64_t *pt_accum, int8_t is_out,
+    void *(*act)(void *, int32_t *, int)) {
+    int16_t *p_bias = *pp_bias;
+    __attribute__((aligned(16))) int32_t acc32[4];
+    int i;
+    int shift;
+    int qbit_s;
+
+    if (p_bias == 0)
+        qbit_s = qbit_input + qbit_kernel;
+    else
+        qbit_s = MAX(15, qbit_input + qbit_kernel);
+
+    shift = qbit_s - (qbit_input + qbit_kernel);
+    shift_64b(pt_accum, shift, dim_output); // align acc to w
+    if (p_bias != 0) {
+        shift = qbit_s - (qbit_bias);
+        for (i = 0; i < dim_output; i++) {
+            pt_accum[i] +=
+                (shift >= 0) ? ((int64_t)*p_bias++) << shift : ((int64_t)*p_bias++) >> -shift;
+        }
+    }
+    if (is_out) {
+        shift = 15 - qbit_s;
+        shift_64b(pt_accum, shift, dim_output);
+        for (i = 0; i < dim_output; i++)
+            acc32[i] = (int32_t)MIN(MAX(pt_accum[i], MIN_INT32_T), MAX_INT32_T);
+        *pp_output = (int16_t *)(*act)(*pp_output, acc32, dim_output);
+    }
+    *pp_bias = p_bias;
+    return 0;
+}
+#endif
+
+int affine_Krows_4x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int16_t **pp_bias, int16_t *input,
+    int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int64_t *pt_accum, int8_t is_out, void *(*act)(void *, int32_t *, int)) {
+    /*
+        "affine_Krows_4x16" is "affine_Krows_8x16" on a packed 4-bit table.
+        See "affine_packed.h" for the row format
+    */
+    const uint8_t *pw = (const uint8_t *)*pp_kernel;
+    int row_bytes = AFFINE_4X16_ROW_BYTES(dim_input);
+    int i;
+
+    for (i = 0; i < dim_output; i++, pw += row_bytes)
+        pt_accum[i] += (int64_t)pw[0] * dot_4x16(pw + 1, input, dim_input);
+    *pp_kernel = (int8_t *)pw;
+
+    return affine_packed_out(
+        dim_output, pp_output, pp_bias, qbit_kernel, qbit_bias, qbit_input, pt_accum, is_out, act);
+}
+
+int affine_Krows_sparse_8x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int16_t **pp_bias, int16_t *input,
+    int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int64_t *pt_accum, int8_t is_out, void *(*act)(void *, int32_t *, int)) {
+    /*
+        "affine_Krows_sparse_8x16" is "affine_Krows_8x16" on a block-sparse table.
+        See "affine_packed.h" for the row format
+    */
+    const int8_t *pw = *pp_kernel;
+    int i;
+
+    for (i = 0; i < dim_output; i++)
+        pt_accum[i] += dot_sparse_8x16(&pw, input, dim_input);
+    *pp_kernel = (int8_t *)pw;
+
+    return affine_packed_out(
+        dim_output, pp_output, pp_bias, qbit_kernel, qbit_bias, qbit_input, pt_accum, is_out, act);
+}
+
+// rc_Krows_8x16 and fc_8x16 with another row kernel
+static int rc_Krows_packed(
+    affine_krows_t affine, int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel,
+    int8_t **pp_kernel_rec, int16_t **pp_bias, int16_t *input, int16_t *input_rec,
+    int16_t dim_input, int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias,
+    int16_t qbit_input, int16_t qbit_input_rec, void *(*act)(void *, int32_t *, int)) {
+    __attribute__((aligned(16))) int64_t acc[4] = {0, 0, 0, 0};
+    int16_t *p_bias_null = (int16_t *)0;
+
+    affine(
+        dim_output, pp_output, pp_kernel, &p_bias_null, input, dim_input, qbit_kernel, qbit_bias,
+        qbit_input, acc, 0, act);
+    shift_64b(acc, qbit_input_rec - qbit_input, dim_output);
+    affine(
+        dim_output, pp_output, pp_kernel_rec, pp_bias, input_rec, dim_input_rec, qbit_kernel,
+        qbit_bias, qbit_input_rec, acc, 1, act);
+    return 0;
+}
+
+static int fc_packed(
+    affine_krows_t affine, int16_t *p_output, int8_t *p_kernel, int16_t *p_bias, int16_t *input,
+    int16_t dim_output, int16_t dim_input, int16_t qbit_kernel, int16_t qbit_bias,
+    int16_t qbit_input, void *(*act)(void *, int32_t *, int)) {
+    __attribute__((aligned(16))) int64_t acc[4];
+    int16_t *po = p_output;
+    int8_t *pw = p_kernel;
+    int16_t *pb = p_bias;
+    int rows;
+    int i, j;
+
+    for (i = 0; i < dim_output; i += rows) {
+        rows = MIN(dim_output - i, 4);
+        for (j = 0; j < rows; j++)
+            acc[j] = 0;
+        affine(rows, &po, &pw, &pb, input, dim_input, qbit_kernel, qbit_bias, qbit_input, acc, 1,
+               act);
+    }
+    return 0;
+}
+
+int rc_Krows_4x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int8_t **pp_kernel_rec,
+    int16_t **pp_bias, int16_t *input, int16_t *input_rec, int16_t dim_input, int16_t dim_input_rec,
+    int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input, int16_t qbit_input_rec,
+    void *(*act)(void *, int32_t *, int)) {
+    return rc_Krows_packed(
+        affine_Krows_4x16, dim_output, pp_output, pp_kernel, pp_kernel_rec, pp_bias, input,
+        input_rec, dim_input, dim_input_rec, qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
+        act);
+}
+
+int rc_Krows_sparse_8x16(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int8_t **pp_kernel_rec,
+    int16_t **pp_bias, int16_t *input, int16_t *input_rec, int16_t dim_input, int16_t dim_input_rec,
+    int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input, int16_t qbit_input_rec,
+    void *(*act)(void *, int32_t *, int)) {
+    return rc_Krows_packed(
+        affine_Krows_sparse_8x16, dim_output, pp_output, pp_kernel, pp_kernel_rec, pp_bias, input,
+        input_rec, dim_input, dim_input_rec, qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
+        act);
+}
+
+int fc_4x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *input_rec, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+    return fc_packed(
+        affine_Krows_4x16, p_output, p_kernel, p_bias, input, dim_output, dim_input, qbit_kernel,
+        qbit_bias, qbit_input, act);
+}
+
+int fc_sparse_8x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *input_rec, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+    return fc_packed(
+        affine_Krows_sparse_8x16, p_output, p_kernel, p_bias, input, dim_output, dim_input,
+        qbit_kernel, qbit_bias, qbit_input, act);
+}
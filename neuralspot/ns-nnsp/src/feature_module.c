@@ -19,6 +19,14 @@ extern const int16_t mfltrBank_coeff_nfilt72_fftsize512[];
 extern const int16_t mfltrBank_coeff_nfilt40_fftsize512[];
 extern const int16_t mfltrBank_coeff_nfilt22_fftsize256[];
 
+static void FeatureClass_init_params(
+        FeatureClass *ps,
+        const int32_t *norm_mean,
+        const int32_t *norm_stdR,
+        int8_t qbit_output,
+        int16_t num_mfltrBank,
+        int16_t fftsize);
+
 void FeatureClass_construct(
         FeatureClass *ps, 
         const int32_t *norm_mean, 
@@ -32,6 +40,46 @@ void FeatureClass_construct(
     {
 
     stftModule_construct(&ps->state_stftModule, winsize, hopsize, fftsize, pt_stft_win_coeff);
+    ps->pspec = GLOBAL_PSPEC;
+    FeatureClass_init_params(
+        ps, norm_mean, norm_stdR, qbit_output, num_mfltrBank, fftsize);
+}
+
+int FeatureClass_construct_arena(
+        FeatureClass *ps,
+        const int32_t *norm_mean,
+        const int32_t *norm_stdR,
+        int8_t qbit_output,
+        int16_t num_mfltrBank,
+        int16_t winsize,
+        int16_t hopsize,
+        int16_t fftsize,
+        const int16_t *pt_stft_win_coeff,
+        ns_arena_t *arena)
+    {
+    int ret;
+
+    ns_arena_begin(arena, "nnsp_feat");
+    ret = stftModule_construct_arena(
+        &ps->state_stftModule, winsize, hopsize, fftsize, pt_stft_win_coeff, arena);
+    ps->pspec = (int32_t *)ns_arena_scratch_alloc(
+        arena, (1 + (fftsize >> 1)) * sizeof(int32_t), 16);
+    if (ns_arena_end(arena) || ret) {
+        return -1;
+    }
+    FeatureClass_init_params(
+        ps, norm_mean, norm_stdR, qbit_output, num_mfltrBank, fftsize);
+    return 0;
+}
+
+static void FeatureClass_init_params(
+        FeatureClass *ps,
+        const int32_t *norm_mean,
+        const int32_t *norm_stdR,
+        int8_t qbit_output,
+        int16_t num_mfltrBank,
+        int16_t fftsize)
+    {
     ps->pt_norm_mean = norm_mean;
     ps->pt_norm_stdR = norm_stdR;
     ps->num_context = NUM_FEATURE_CONTEXT;
@@ -66,7 +114,7 @@ void FeatureClass_setDefault(FeatureClass *ps) {
 
 void FeatureClass_execute(FeatureClass *ps, int16_t *input) {
     int16_t qbit_out;
-    int32_t *pspec = GLOBAL_PSPEC;
+    int32_t *pspec = ps->pspec;
     int32_t *spec = ps->state_stftModule.spec;
     int shift = (ps->num_context - 1) * ps->dim_feat;
     int i;
@@ -95,7 +143,11 @@ void FeatureClass_execute(FeatureClass *ps, int16_t *input) {
     #endif
     spec2pspec(pspec, spec, 1 + (LEN_FFT_NNSP >> 1));
 #else
+    #if STFT_OLA == 1
+    stftModule_analyze_ola(
+    #else
     stftModule_analyze_arm(
+    #endif
         (void *)&ps->state_stftModule,
         input, // q15
         spec,  // q21
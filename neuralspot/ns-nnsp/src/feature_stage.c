@@ -0,0 +1,26 @@
+#include <string.h>
+#include "feature_stage.h"
+
+static uint32_t FeatureClass_stage_run(void *ctx, const void *in, void *out) {
+    FeatureClass *ps = (FeatureClass *)ctx;
+    FeatureClass_execute(ps, (int16_t *)in);
+    memcpy(out,
+           ps->normFeatContext + (ps->num_context - 1) * ps->dim_feat,
+           ps->dim_feat * sizeof(int16_t));
+    return NS_STATUS_SUCCESS;
+}
+
+void FeatureClass_stage(
+        ns_pipeline_stage_t *s,
+        FeatureClass *ps,
+        int16_t *window) {
+    memset(s, 0, sizeof(*s));
+    s->name = "nnsp_feature";
+    s->run = FeatureClass_stage_run;
+    s->ctx = ps;
+    s->item_bytes = sizeof(int16_t);
+    s->frame = ps->state_stftModule.hop;
+    s->hop = ps->state_stftModule.hop;
+    s->out_bytes = ps->dim_feat * sizeof(int16_t);
+    s->window = (uint8_t *)window;
+}
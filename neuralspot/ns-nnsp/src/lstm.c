@@ -1,6 +1,7 @@
 #include "ambiq_stdint.h"
 #include "affine.h"
 #include "affine_acc32b.h"
+#include "affine_packed.h"
 #include "lstm.h"
 #include "minmax.h"
 #if DEBUG_PRINT
@@ -12,11 +13,19 @@ __attribute__((aligned(16))) int16_t F_STATES[4];
 __attribute__((aligned(16))) int16_t O_STATES[4];
 __attribute__((aligned(16))) int64_t tmp[4];
 
-int lstm_8x16(
-    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
-    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
-    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
-    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+// One gate's rows: rc_Krows_8x16 or one of its compressed counterparts (affine_packed.h)
+typedef int (*rc_krows_t)(
+    int16_t dim_output, int16_t **pp_output, int8_t **pp_kernel, int8_t **pp_kernel_rec,
+    int16_t **pp_bias, int16_t *input, int16_t *input_rec, int16_t dim_input, int16_t dim_input_rec,
+    int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input, int16_t qbit_input_rec,
+    void *(*act)(void *, int32_t *, int));
+
+static int lstm_rows(
+    rc_krows_t rc_Krows, int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec,
+    int16_t *p_bias, int16_t *input, int16_t *h_state, int32_t *c_state, int16_t dim_output,
+    int16_t dim_input, int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias,
+    int16_t qbit_input, int16_t qbit_input_rec, ACTIVATION_TYPE act_type,
+    void *(*act)(void *, int32_t *, int)) {
     int16_t *po = p_output;
     int8_t *pw = p_kernel;
     int8_t *pw_r = p_kernel_rec;
@@ -37,22 +46,22 @@ int lstm_8x16(
         p_jstate = J_STATES;
         p_fstate = F_STATES;
         p_ostate = O_STATES;
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_istate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_jstate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & tanh_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_fstate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_ostate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
@@ -84,22 +93,22 @@ int lstm_8x16(
         p_fstate = F_STATES;
         p_ostate = O_STATES;
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_istate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_jstate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & tanh_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_fstate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
 
-        rc_Krows_8x16(
+        rc_Krows(
             rows_sub, &p_ostate, &pw, &pw_r, &pb, input, h_state, dim_input, dim_input_rec,
             qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
             (void *(*)(void *, int32_t *, int)) & sigmoid_fix);
@@ -135,6 +144,39 @@ int lstm_8x16(
     return 0;
 }
 
+int lstm_8x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+    return lstm_rows(
+        rc_Krows_8x16, p_output, p_kernel, p_kernel_rec, p_bias, input, h_state, c_state,
+        dim_output, dim_input, dim_input_rec, qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
+        act_type, act);
+}
+
+int lstm_4x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+    return lstm_rows(
+        rc_Krows_4x16, p_output, p_kernel, p_kernel_rec, p_bias, input, h_state, c_state,
+        dim_output, dim_input, dim_input_rec, qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
+        act_type, act);
+}
+
+int lstm_sparse_8x16(
+    int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
+    int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
+    int16_t dim_input_rec, int16_t qbit_kernel, int16_t qbit_bias, int16_t qbit_input,
+    int16_t qbit_input_rec, ACTIVATION_TYPE act_type, void *(*act)(void *, int32_t *, int)) {
+    return lstm_rows(
+        rc_Krows_sparse_8x16, p_output, p_kernel, p_kernel_rec, p_bias, input, h_state, c_state,
+        dim_output, dim_input, dim_input_rec, qbit_kernel, qbit_bias, qbit_input, qbit_input_rec,
+        act_type, act);
+}
+
 int lstm_8x16_acc32b(
     int16_t *p_output, int8_t *p_kernel, int8_t *p_kernel_rec, int16_t *p_bias, int16_t *input,
     int16_t *h_state, int32_t *c_state, int16_t dim_output, int16_t dim_input,
@@ -24,7 +24,25 @@ static void pointer_exchange(void **ppt1, void **ppt2) {
     *ppt2 = pt;
 }
 
-void NeuralNetClass_init(NeuralNetClass *pt_inst) {}
+void NeuralNetClass_init(NeuralNetClass *pt_inst) {
+    pt_inst->pt_scratch[0] = input0;
+    pt_inst->pt_scratch[1] = input1;
+}
+
+int NeuralNetClass_init_arena(NeuralNetClass *pt_inst, ns_arena_t *arena) {
+    int i;
+    // Each buffer holds the net input or any layer output (int32 when linear)
+    int32_t len = pt_inst->size_layer[0];
+    for (i = 1; i <= pt_inst->numlayers; i++)
+        len = MAX(len, 2 * pt_inst->size_layer[i]);
+    len = (len + 7) & ~7; // whole 128-bit vectors
+
+    ns_arena_begin(arena, "nnsp_net");
+    for (i = 0; i < 2; i++)
+        pt_inst->pt_scratch[i] =
+            (int16_t *)ns_arena_scratch_alloc(arena, len * sizeof(int16_t), 16);
+    return ns_arena_end(arena) ? -1 : 0;
+}
 
 void NeuralNetClass_setDefault(NeuralNetClass *pt_inst) {
     int i, j;
@@ -85,8 +103,8 @@ void NeuralNetClass_exe(
         return;
     }
 
-    pt0 = (int16_t *)input0;
-    pt1 = (int16_t *)input1;
+    pt0 = pt_inst->pt_scratch[0];
+    pt1 = pt_inst->pt_scratch[1];
 #if ARM_OPTIMIZED==3
     move_data_16b(
         input,
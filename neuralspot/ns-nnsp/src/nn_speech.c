@@ -10,6 +10,7 @@
 #include "ambiq_nnsp_debug.h"
 #include "nnid_class.h"
 #include "ns_ambiqsuite_harness.h"
+#include "ns_trace.h"
 #if AMBIQ_NNSP_DEBUG == 1
     #include "debug_files.h"
 #endif
@@ -78,6 +79,58 @@ int NNSPClass_init(
     NeuralNetClass_init((NeuralNetClass *)pt_inst->pt_net);
 
     pt_inst->pt_se_out = glob_se_out;
+    pt_inst->pt_nn_output = glob_nn_output;
+    pt_inst->pt_input_tmp = input_tmp;
+
+    if (pt_inst->nn_id == nnid_id)
+        pt_inst->pt_state_nnid = (void *)&state_nnid;
+    else
+        pt_inst->pt_state_nnid = (void *)0;
+
+    return 0;
+}
+
+int NNSPClass_init_arena(
+    NNSPClass *pt_inst, void *pt_net, void *pt_feat, char nn_id, const int32_t *pt_mean,
+    const int32_t *pt_stdR, int16_t *pt_thresh_prob, int16_t *pt_th_count_trigger,
+    PARAMS_NNSP *pt_params, ns_arena_t *arena) {
+    NeuralNetClass *net = (NeuralNetClass *)pt_net;
+    int ret;
+
+    ns_arena_begin(arena, "nnsp");
+    pt_inst->pt_dcrm = ns_arena_alloc(arena, sizeof(IIR_CLASS), 0);
+    pt_inst->pt_nn_output = (int32_t *)ns_arena_alloc(
+        arena, net->size_layer[net->numlayers] * sizeof(int32_t), 16);
+    if (nn_id == se_id) {
+        pt_inst->pt_se_out =
+            (int16_t *)ns_arena_alloc(arena, pt_params->hopsize_stft * sizeof(int16_t), 16);
+        pt_inst->pt_input_tmp = (int16_t *)ns_arena_alloc(arena, 160 * sizeof(int16_t), 16);
+    } else {
+        pt_inst->pt_se_out = (int16_t *)0;
+        pt_inst->pt_input_tmp = (int16_t *)0;
+    }
+    ret = ns_arena_end(arena);
+
+    ret |= FeatureClass_construct_arena(
+        (FeatureClass *)pt_feat, pt_mean, pt_stdR, net->qbit_input[0], pt_params->num_mfltrBank,
+        pt_params->winsize_stft, pt_params->hopsize_stft, pt_params->fftsize,
+        pt_params->pt_stft_win_coeff, arena);
+    ret |= NeuralNetClass_init_arena(net, arena);
+    if (ret) {
+        return -1;
+    }
+    if (ns_arena_is_planning(arena)) {
+        return 0;
+    }
+
+    IIR_CLASS_init(pt_inst->pt_dcrm);
+    pt_inst->pt_params = pt_params;
+    pt_inst->nn_id = nn_id;
+    pt_inst->pt_feat = (void *)pt_feat;
+    pt_inst->pt_net = (void *)pt_net;
+    pt_inst->num_dnsmpl = pt_params->num_dnsmpl;
+    pt_inst->pt_thresh_prob = pt_thresh_prob;
+    pt_inst->pt_th_count_trigger = pt_th_count_trigger;
 
     if (pt_inst->nn_id == nnid_id)
         pt_inst->pt_state_nnid = (void *)&state_nnid;
@@ -131,7 +184,7 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
 #endif
     int16_t *pt_inputs;
 
-
+    NS_TRACE_BEGIN("nnsp_feature");
     if (pt_inst->nn_id == se_id) {
 
 #if 0
@@ -147,8 +200,8 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
         }
 #endif
         if (pt_inst->pt_params->is_dcrm) {
-            IIR_CLASS_exec(pt_inst->pt_dcrm, input_tmp, rawPCM, 160);
-            pt_inputs = input_tmp;
+            IIR_CLASS_exec(pt_inst->pt_dcrm, pt_inst->pt_input_tmp, rawPCM, 160);
+            pt_inputs = pt_inst->pt_input_tmp;
         } else {
             pt_inputs = rawPCM;
         }
@@ -157,7 +210,9 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
         FeatureClass_execute(pt_feat, rawPCM);
 
     }
+    NS_TRACE_END("nnsp_feature");
     if (pt_inst->slides == 1) {
+        NS_TRACE_BEGIN("nnsp_nn");
 #ifdef ENERGYMODE
         am_set_power_monitor_state(AM_AI_INFERING);
 #endif
@@ -167,8 +222,8 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
         // for (int i = 0; i < 432; i++) {
         //     pt_feat->normFeatContext[i] = 1;
         // }
-        NeuralNetClass_exe(pt_net, pt_feat->normFeatContext, glob_nn_output, debug_layer);
-        // int16_t *po = (int16_t *)glob_nn_output;
+        NeuralNetClass_exe(pt_net, pt_feat->normFeatContext, pt_inst->pt_nn_output, debug_layer);
+        // int16_t *po = (int16_t *)pt_inst->pt_nn_output;
         // ns_printf("output: \n\n");
         // for (int i = 0; i < 257; i++) {
         //     ns_printf("%d ", po[i]);
@@ -176,27 +231,27 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
         // ns_printf("\n");
         switch (pt_inst->nn_id) {
         case s2i_id:
-            s2i_post_proc(pt_inst, glob_nn_output, &pt_inst->trigger);
+            s2i_post_proc(pt_inst, pt_inst->pt_nn_output, &pt_inst->trigger);
             break;
 
         case kws_galaxy_id:
-            binary_post_proc(pt_inst, glob_nn_output, &pt_inst->trigger);
+            binary_post_proc(pt_inst, pt_inst->pt_nn_output, &pt_inst->trigger);
             break;
 
         case vad_id:
-            binary_post_proc(pt_inst, glob_nn_output, &pt_inst->trigger);
+            binary_post_proc(pt_inst, pt_inst->pt_nn_output, &pt_inst->trigger);
             break;
 
         case nnid_id:
             if (pt_nnid->is_get_corr)
                 nnidClass_get_cos(
-                    glob_nn_output, pt_nnid->pt_embd, pt_nnid->dim_embd, pt_nnid->total_enroll_ppls,
-                    pt_nnid->corr);
+                    pt_inst->pt_nn_output, pt_nnid->pt_embd, pt_nnid->dim_embd,
+                    pt_nnid->total_enroll_ppls, pt_nnid->corr);
             break;
 
         case se_id:
 #if AMBIQ_NNSP_DEBUG == 1
-            tmp = glob_nn_output;
+            tmp = pt_inst->pt_nn_output;
             for (int i = 0; i < 257; i++) {
                 fprintf(file_mask_c, "%d ", tmp[i]);
             }
@@ -204,7 +259,7 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
 #endif
             se_post_proc(
                 (void *)pt_inst->pt_feat,
-                (int16_t *)glob_nn_output,
+                (int16_t *)pt_inst->pt_nn_output,
                  pt_inst->pt_se_out,
                 pt_inst->pt_params->start_bin,
                 NNSPClass_get_nnOut_dim(pt_inst));
@@ -214,6 +269,7 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
 #if CHECK_POWER
         am_hal_pwrctrl_mcu_mode_select(AM_HAL_PWRCTRL_MCU_MODE_LOW_POWER);
 #endif
+        NS_TRACE_END("nnsp_nn");
     }
 
     if (pt_inst->num_dnsmpl == 1)
@@ -247,6 +303,10 @@ void se_post_proc(
     FeatureClass *pt_feat = (FeatureClass *) pt_feat_t;
     stftModule *pt_stft_state = &(pt_feat->state_stftModule);
     int32_t *spec = pt_stft_state->spec;
+#if STFT_OLA == 1
+    stftModule_synthesize_masked_ola(
+        pt_stft_state, spec, pt_nn_est, start_bin, nn_dim_out, pt_se_out);
+#else
     int64_t tmp;
 
     for (int i = 0; i < start_bin; i++) {
@@ -269,6 +329,7 @@ void se_post_proc(
     }
 
     stftModule_synthesize_arm(pt_stft_state, spec, pt_se_out);
+#endif
 }
 
 void s2i_post_proc(NNSPClass *pt_inst, int32_t *pt_nn_est, int16_t *pt_trigger) {
@@ -0,0 +1,42 @@
+#include <string.h>
+#include "nnsp_cascade.h"
+#include "nnsp_identification.h"
+#include "nnid_class.h"
+
+static uint32_t NNSPClass_cascade_run(void *ctx, const void *frame, float *score) {
+    NNSPClass *pt_inst = (NNSPClass *)ctx;
+    NNID_CLASS *pt_nnid;
+    int16_t trigger = NNSPClass_exec(pt_inst, (int16_t *)frame);
+    int32_t den;
+
+    switch (pt_inst->nn_id) {
+    case vad_id:
+    case kws_galaxy_id:
+        // binary_post_proc left the two class likelihoods in the NN output
+        den = pt_inst->pt_nn_output[0] + pt_inst->pt_nn_output[1];
+        *score = (den > 0) ? (float)pt_inst->pt_nn_output[1] / den : 0.0f;
+        break;
+
+    case nnid_id:
+        pt_nnid = (NNID_CLASS *)pt_inst->pt_state_nnid;
+        *score = 0.0f;
+        if (pt_nnid->is_get_corr) {
+            for (int i = 0; i < pt_nnid->total_enroll_ppls; i++) {
+                if (pt_nnid->corr[i] > *score)
+                    *score = pt_nnid->corr[i];
+            }
+        }
+        break;
+
+    default:
+        *score = (float)trigger;
+        break;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void NNSPClass_cascade_stage(ns_cascade_stage_t *s, NNSPClass *pt_inst) {
+    s->name = "nnsp";
+    s->run = NNSPClass_cascade_run;
+    s->ctx = pt_inst;
+}
@@ -19,12 +19,43 @@ int stftModule_construct(
     stftModule *ps, int16_t len_win, int16_t hopsize, int16_t fftsize,
     const int16_t *pt_stft_win_coeff) {
     ps->spec = glob_spec;
+    ps->fft_buf = glob_fft_buf;
     ps->dataBuffer = dataBuffer;
     ps->odataBuffer = odataBuffer;
     ps->len_win = len_win;
     ps->hop = hopsize;
     ps->len_fft = fftsize;
     ps->window = pt_stft_win_coeff;
+    ps->inPos = 0;
+    ps->outPos = 0;
+#if ARM_FFT == 1
+    arm_fft_init(&ps->fft_st, 0, fftsize);
+    arm_fft_init(&ps->ifft_st, 1, fftsize);
+#endif
+    return 0;
+}
+
+int stftModule_construct_arena(
+    stftModule *ps, int16_t len_win, int16_t hopsize, int16_t fftsize,
+    const int16_t *pt_stft_win_coeff, ns_arena_t *arena) {
+    // dataBuffer and odataBuffer carry overlap state, spec is read back by synthesize
+    ps->dataBuffer = (int16_t *)ns_arena_alloc(arena, len_win * sizeof(int16_t), 16);
+    ps->odataBuffer = (int32_t *)ns_arena_alloc(arena, len_win * sizeof(int32_t), 16);
+    ps->spec = (int32_t *)ns_arena_alloc(arena, (2 * fftsize + 2) * sizeof(int32_t), 16);
+    ps->fft_buf =
+        (int32_t *)ns_arena_scratch_alloc(arena, (2 * fftsize + 2) * sizeof(int32_t), 16);
+    ps->len_win = len_win;
+    ps->hop = hopsize;
+    ps->len_fft = fftsize;
+    ps->window = pt_stft_win_coeff;
+    ps->inPos = 0;
+    ps->outPos = 0;
+    if (arena->failures != 0) {
+        return -1;
+    }
+    if (ns_arena_is_planning(arena)) {
+        return 0;
+    }
 #if ARM_FFT == 1
     arm_fft_init(&ps->fft_st, 0, fftsize);
     arm_fft_init(&ps->ifft_st, 1, fftsize);
@@ -37,6 +68,8 @@ int stftModule_setDefault(stftModule *ps) {
         ps->dataBuffer[i] = 0;
         ps->odataBuffer[i] = 0;
     }
+    ps->inPos = 0;
+    ps->outPos = 0;
     return 0;
 }
 
@@ -119,17 +152,17 @@ int stftModule_analyze_arm(
 
     for (i = 0; i < ps->len_win; i++) {
         tmp = (int32_t)ps->window[i] * (int32_t)ps->dataBuffer[i];
-        glob_fft_buf[i] = tmp; // Q30
+        ps->fft_buf[i] = tmp; // Q30
     }
 
     for (i = 0; i < (ps->len_fft - ps->len_win); i++) {
-        glob_fft_buf[i + ps->len_win] = 0;
+        ps->fft_buf[i + ps->len_win] = 0;
     }
 
     arm_fft_exec(
         &ps->fft_st,
         spec,          // fft_out, Q21
-        glob_fft_buf); // fft_in,  Q30    
+        ps->fft_buf); // fft_in,  Q30    
 
     if (fftsize == 512)
         *pt_qbit_out = 21;
@@ -155,10 +188,10 @@ int stftModule_synthesize_arm(
     arm_rfft_q31(
         &ps->ifft_st,
         spec,          // Q21
-        glob_fft_buf); // Q21
+        ps->fft_buf); // Q21
 
     for (i = 0; i < ps->len_win; i++) {
-        tmp64 = ((int64_t)ps->window[i]) * (int64_t)glob_fft_buf[i];
+        tmp64 = ((int64_t)ps->window[i]) * (int64_t)ps->fft_buf[i];
         tmp64 >>= 21;
         tmp64 = (int64_t)ps->odataBuffer[i] + (int64_t)tmp64;
         tmp64 = MIN(MAX(tmp64, INT32_MIN), INT32_MAX);
@@ -220,17 +253,17 @@ int stftModule_analyze_arm(
         ps->dataBuffer+ps->len_win - ps->hop,
         ps->hop);
     vec16_vec16_mul_32b(
-        glob_fft_buf,
+        ps->fft_buf,
         (int16_t*) ps->window,
         ps->dataBuffer,
         ps->len_win);
     set_zero_32b(
-        glob_fft_buf+ps->len_win,
+        ps->fft_buf+ps->len_win,
         ps->len_fft - ps->len_win);
     arm_fft_exec(
         &ps->fft_st,
         spec,          // fft_out, Q21
-        glob_fft_buf); // fft_in,  Q30
+        ps->fft_buf); // fft_in,  Q30
     if (fftsize == 512)
         *pt_qbit_out = 21;
     else
@@ -254,10 +287,10 @@ int stftModule_synthesize_arm(
     arm_rfft_q31(
         &ps->ifft_st,
         spec,          // Q21
-        glob_fft_buf); // Q21
+        ps->fft_buf); // Q21
 
     for (i = 0; i < ps->len_win; i++) {
-        tmp64 = ((int64_t)ps->window[i]) * (int64_t)glob_fft_buf[i];
+        tmp64 = ((int64_t)ps->window[i]) * (int64_t)ps->fft_buf[i];
         tmp64 >>= 21;
         tmp64 = (int64_t)ps->odataBuffer[i] + (int64_t)tmp64;
         tmp64 = MIN(MAX(tmp64, INT32_MIN), INT32_MAX);
@@ -296,4 +329,143 @@ int stftModule_synthesize_arm(
 
 #endif
 
+/*
+    Overlap-add engine, see spectrogram_module.h
+*/
+
+// fft_buf[i] = window[i] * x[i], Q30
+static inline void stft_window_segment(int32_t *y, const int16_t *window, int16_t *x, int len) {
+#if ARM_OPTIMIZED == 3
+    vec16_vec16_mul_32b(y, (int16_t *)window, x, len);
+#else
+    for (int i = 0; i < len; i++) {
+        y[i] = (int32_t)window[i] * (int32_t)x[i];
+    }
+#endif
+}
+
+int stftModule_analyze_ola(
+    void *ps_t,
+    int16_t *fft_in_q16, // q15
+    int32_t *spec,       // q21
+    int16_t fftsize, int16_t *pt_qbit_out) {
+    stftModule *ps = (stftModule *)ps_t;
+    int len_win = ps->len_win;
+    int pos = ps->inPos;
+    int n1 = MIN(ps->hop, len_win - pos);
+
+    // The new hop replaces the oldest samples
+    for (int i = 0; i < n1; i++)
+        ps->dataBuffer[pos + i] = fft_in_q16[i];
+    for (int i = n1; i < ps->hop; i++)
+        ps->dataBuffer[i - n1] = fft_in_q16[i];
+    pos += ps->hop;
+    if (pos >= len_win)
+        pos -= len_win;
+    ps->inPos = pos;
+
+    // Window the frame oldest sample first: [pos, len_win) then [0, pos)
+    stft_window_segment(ps->fft_buf, ps->window, ps->dataBuffer + pos, len_win - pos);
+    stft_window_segment(
+        ps->fft_buf + len_win - pos, ps->window + len_win - pos, ps->dataBuffer, pos);
+
+#if ARM_OPTIMIZED == 3
+    set_zero_32b(ps->fft_buf + len_win, ps->len_fft - len_win);
+#else
+    for (int i = len_win; i < ps->len_fft; i++)
+        ps->fft_buf[i] = 0;
+#endif
+
+    arm_fft_exec(
+        &ps->fft_st,
+        spec,          // fft_out, Q21
+        ps->fft_buf); // fft_in,  Q30
+    if (fftsize == 512)
+        *pt_qbit_out = 21;
+    else
+        *pt_qbit_out = 22;
+    return 0;
+}
+
+/*
+    Adds window[i] * y[i] into acc[i]. The first `emit` sums are complete: they are written
+    to output and their slots cleared for the next frame's tail.
+*/
+static inline void stft_ola_segment(
+    int32_t *acc, const int16_t *window, const int32_t *y, int len, int emit, int16_t *output) {
+    int i;
+    int64_t tmp64;
+
+    for (i = 0; i < emit; i++) {
+        tmp64 = (((int64_t)window[i]) * (int64_t)y[i]) >> 21;
+        tmp64 = MIN(MAX((int64_t)acc[i] + tmp64, INT32_MIN), INT32_MAX);
+        output[i] = (int16_t)MIN(MAX(tmp64, INT16_MIN), INT16_MAX);
+        acc[i] = 0;
+    }
+    for (; i < len; i++) {
+        tmp64 = (((int64_t)window[i]) * (int64_t)y[i]) >> 21;
+        tmp64 = MIN(MAX((int64_t)acc[i] + tmp64, INT32_MIN), INT32_MAX);
+        acc[i] = (int32_t)tmp64;
+    }
+}
+
+int stftModule_synthesize_ola(
+    void *ps_t,
+    int32_t *spec,   // Q21
+    int16_t *output) // Q15
+{
+    stftModule *ps = (stftModule *)ps_t;
+    int len_win = ps->len_win;
+    int pos = ps->outPos;
+    int n1 = len_win - pos;
+    int emit1 = MIN(ps->hop, n1);
+
+    arm_rfft_q31(
+        &ps->ifft_st,
+        spec,          // Q21
+        ps->fft_buf); // Q21
+
+    // Frame sample i lands on odataBuffer[(pos + i) % len_win]
+    stft_ola_segment(ps->odataBuffer + pos, ps->window, ps->fft_buf, n1, emit1, output);
+    stft_ola_segment(
+        ps->odataBuffer, ps->window + n1, ps->fft_buf + n1, pos, ps->hop - emit1,
+        output + emit1);
+
+    pos += ps->hop;
+    if (pos >= len_win)
+        pos -= len_win;
+    ps->outPos = pos;
+    return 0;
+}
+
+int stftModule_synthesize_masked_ola(
+    void *ps_t,
+    int32_t *spec,       // Q21
+    const int16_t *mask, // Q15
+    int start_bin, int num_bins,
+    int16_t *output)     // Q15
+{
+    stftModule *ps = (stftModule *)ps_t;
+    int num_spec = 1 + (ps->len_fft >> 1);
+    int end_bin = MIN(start_bin + num_bins, num_spec);
+    int64_t tmp;
+    int i;
+
+    for (i = 0; i < start_bin; i++) {
+        spec[2 * i] = 0;
+        spec[2 * i + 1] = 0;
+    }
+    for (; i < end_bin; i++) {
+        tmp = (int64_t)mask[i] * (int64_t)spec[2 * i];
+        spec[2 * i] = (int32_t)(tmp >> 15);
+        tmp = (int64_t)mask[i] * (int64_t)spec[2 * i + 1];
+        spec[2 * i + 1] = (int32_t)(tmp >> 15);
+    }
+    for (; i < num_spec; i++) {
+        spec[2 * i] = 0;
+        spec[2 * i + 1] = 0;
+    }
+    return stftModule_synthesize_ola(ps, spec, output);
+}
+
 #endif
@@ -53,7 +53,11 @@ typedef status (*ns_rpc_data_computeOnEVB_cb)(const dataBlock *in_block, dataBlo
 
 typedef enum { NS_RPC_GENERICDATA_CLIENT, NS_RPC_GENERICDATA_SERVER } rpcGenericDataMode_e;
 
-typedef enum { NS_RPC_TRANSPORT_USB, NS_RPC_TRANSPORT_UART } ns_rpc_transport_e;
+typedef enum {
+    NS_RPC_TRANSPORT_USB,     ///< USB CDC (virtual serial port)
+    NS_RPC_TRANSPORT_UART,    ///< UART
+    NS_RPC_TRANSPORT_USB_BULK ///< USB vendor bulk endpoints, for large transfers
+} ns_rpc_transport_e;
 /**
  * @brief RPC Configuration Struct
  *
@@ -72,7 +76,7 @@ typedef struct {
     ns_rpc_data_sendBlockToEVB_cb sendBlockToEVB_cb;       ///< Callback for sendBlockToEVB
     ns_rpc_data_fetchBlockFromEVB_cb fetchBlockFromEVB_cb; ///< Callback for fetchBlockFromEVB
     ns_rpc_data_computeOnEVB_cb computeOnEVB_cb;           ///< Callback for computeOnEVB
-    ns_rpc_transport_e transport; ///< Transport type USB or UART
+    ns_rpc_transport_e transport; ///< Transport type USB, USB_BULK or UART
 } ns_rpc_config_t;
 
 /**
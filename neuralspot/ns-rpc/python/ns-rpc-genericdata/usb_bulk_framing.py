@@ -0,0 +1,79 @@
+"""Framing for byte streams carried over the neuralSPOT USB vendor bulk endpoints.
+
+A bulk IN transfer only completes on the host when a short packet arrives or the read buffer
+is full, so every message is sent as one frame that is never a multiple of the endpoint's max
+packet size:
+
+    magic (2) | pad (2) | length (4) | payload (length) | pad bytes (pad)
+
+little endian. The receiver strips headers and padding, so payloads read back as a continuous
+stream. Must stay in sync with neuralspot/ns-usb/src/ns_usb_bulk_frame.c.
+"""
+
+import struct
+
+MAGIC = 0x534E  # "NS"
+HEADER_SIZE = 8
+_HEADER = struct.Struct("<HHI")
+
+
+def encode_frame(payload, max_packet=64):
+    """Return payload wrapped in a frame, padded so it ends in a short packet."""
+    pad = 1 if max_packet and (HEADER_SIZE + len(payload)) % max_packet == 0 else 0
+    return _HEADER.pack(MAGIC, pad, len(payload)) + bytes(payload) + bytes(pad)
+
+
+class Deframer:
+    """Turns a sequence of frames back into a byte stream.
+
+    read_fn() returns the next chunk of received bytes (any size, e.g. one bulk read) and
+    raises on timeout.
+    """
+
+    def __init__(self, read_fn):
+        self._read = read_fn
+        self.reset()
+
+    def reset(self):
+        self._buf = bytearray()
+        self.remaining = 0  # payload bytes left in the current frame
+        self.pad = 0  # pad bytes following the current frame
+        self.frames = 0
+        self.resyncs = 0  # bytes skipped looking for a frame header
+
+    def _fill(self, n):
+        while len(self._buf) < n:
+            chunk = self._read()
+            if not chunk:
+                raise TimeoutError("USB bulk read returned no data")
+            self._buf += chunk
+
+    def _next_frame(self):
+        self._fill(self.pad)
+        del self._buf[: self.pad]
+        self.pad = 0
+        while True:
+            self._fill(HEADER_SIZE)
+            magic, pad, length = _HEADER.unpack_from(self._buf)
+            if magic == MAGIC and pad <= 1:
+                break
+            del self._buf[0]
+            self.resyncs += 1
+        del self._buf[:HEADER_SIZE]
+        self.pad = pad
+        self.remaining = length
+        self.frames += 1
+
+    def read(self, size):
+        """Return exactly size payload bytes."""
+        out = bytearray()
+        while len(out) < size:
+            if self.remaining == 0:
+                self._next_frame()
+                continue
+            self._fill(1)
+            take = min(size - len(out), self.remaining, len(self._buf))
+            out += self._buf[:take]
+            del self._buf[:take]
+            self.remaining -= take
+        return bytes(out)
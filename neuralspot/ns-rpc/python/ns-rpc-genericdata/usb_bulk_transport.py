@@ -0,0 +1,73 @@
+"""eRPC transport over the neuralSPOT USB vendor bulk endpoints (pyusb/libusb).
+
+Used when the EVB's ns-rpc is initialized with NS_RPC_TRANSPORT_USB_BULK. Each eRPC message is
+written as a single framed bulk transfer, and responses are read with large bulk reads, so
+multi-KB tensors move in a few transfers instead of 64 byte CDC packets.
+
+Requires pyusb and a libusb backend. On Windows the vendor interface binds to WinUSB
+automatically (MS OS 2.0 descriptor); on Linux the user needs access to the device (udev rule
+for VID 0xCAFE).
+"""
+
+from erpc.transport import FramedTransport
+
+try:
+    from .usb_bulk_framing import Deframer, encode_frame
+except ImportError:
+    from usb_bulk_framing import Deframer, encode_frame
+
+NS_USB_VID = 0xCAFE
+VENDOR_CLASS = 0xFF
+
+
+class UsbBulkTransport(FramedTransport):
+    def __init__(self, vid=NS_USB_VID, pid=None, timeout_ms=30000, read_size=16384):
+        import usb.core
+        import usb.util
+
+        super(UsbBulkTransport, self).__init__()
+        self._usb = usb
+        match = {"idVendor": vid}
+        if pid is not None:
+            match["idProduct"] = pid
+        self._dev = usb.core.find(**match)
+        if self._dev is None:
+            raise IOError("No USB device with VID 0x%04x" % vid)
+
+        cfg = self._dev.get_active_configuration()
+        self._intf = usb.util.find_descriptor(cfg, bInterfaceClass=VENDOR_CLASS)
+        if self._intf is None:
+            raise IOError("USB device has no vendor interface")
+        try:
+            if self._dev.is_kernel_driver_active(self._intf.bInterfaceNumber):
+                self._dev.detach_kernel_driver(self._intf.bInterfaceNumber)
+        except (NotImplementedError, usb.core.USBError):
+            pass  # not supported on this platform
+        usb.util.claim_interface(self._dev, self._intf)
+
+        def endpoint(direction):
+            return usb.util.find_descriptor(
+                self._intf,
+                custom_match=lambda e: usb.util.endpoint_direction(e.bEndpointAddress) == direction,
+            )
+
+        self._ep_out = endpoint(usb.util.ENDPOINT_OUT)
+        self._ep_in = endpoint(usb.util.ENDPOINT_IN)
+        self._max_packet = self._ep_in.wMaxPacketSize
+        self._timeout = timeout_ms
+        # Whole packets, so a read never splits one
+        self._read_size = max(self._max_packet, read_size - read_size % self._max_packet)
+        self._deframer = Deframer(self._read_chunk)
+
+    def _read_chunk(self):
+        return bytes(self._ep_in.read(self._read_size, self._timeout))
+
+    def close(self):
+        self._usb.util.release_interface(self._dev, self._intf)
+        self._usb.util.dispose_resources(self._dev)
+
+    def _base_send(self, data):
+        self._ep_out.write(encode_frame(data, self._max_packet), self._timeout)
+
+    def _base_receive(self, count):
+        return self._deframer.read(count)
@@ -28,6 +28,7 @@
 #include "ns_ambiqsuite_harness.h"
 #include "ns_core.h"
 #include "ns_malloc.h"
+#include "ns_trace.h"
 
 #define NS_RPC_GENERIC_DATA
 #ifdef NS_RPC_GENERIC_DATA
@@ -88,7 +89,10 @@ ns_rpc_data_sendBlockToEVB(const dataBlock *block) {
     // ns_lp_printf("Received call to sendBlockToEVB\n");
 
     if (g_RpcGenericDataConfig.sendBlockToEVB_cb != NULL) {
-        return g_RpcGenericDataConfig.sendBlockToEVB_cb(block);
+        NS_TRACE_BEGIN("rpc_sendBlockToEVB");
+        status s = g_RpcGenericDataConfig.sendBlockToEVB_cb(block);
+        NS_TRACE_END("rpc_sendBlockToEVB");
+        return s;
     } else {
         return ns_rpc_data_success;
     }
@@ -99,7 +103,10 @@ ns_rpc_data_fetchBlockFromEVB(dataBlock *block) {
     // ns_lp_printf("Received call to fetchBlockFromEVB\n");
 
     if (g_RpcGenericDataConfig.fetchBlockFromEVB_cb != NULL) {
-        return g_RpcGenericDataConfig.fetchBlockFromEVB_cb(block);
+        NS_TRACE_BEGIN("rpc_fetchBlockFromEVB");
+        status s = g_RpcGenericDataConfig.fetchBlockFromEVB_cb(block);
+        NS_TRACE_END("rpc_fetchBlockFromEVB");
+        return s;
     } else {
         return ns_rpc_data_success;
     }
@@ -110,7 +117,10 @@ ns_rpc_data_computeOnEVB(const dataBlock *in_block, dataBlock *result_block) {
     // ns_lp_printf("Received call to computeOnEVB\n");
 
     if (g_RpcGenericDataConfig.computeOnEVB_cb != NULL) {
-        return g_RpcGenericDataConfig.computeOnEVB_cb(in_block, result_block);
+        NS_TRACE_BEGIN("rpc_computeOnEVB");
+        status s = g_RpcGenericDataConfig.computeOnEVB_cb(in_block, result_block);
+        NS_TRACE_END("rpc_computeOnEVB");
+        return s;
     } else {
         return ns_rpc_data_success;
     }
@@ -134,14 +144,16 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
     }
     #endif
     // will default to usb if cfg->transport is not explicitly set
-    if(cfg->transport == NS_RPC_TRANSPORT_USB) {
+    if((cfg->transport == NS_RPC_TRANSPORT_USB) || (cfg->transport == NS_RPC_TRANSPORT_USB_BULK)) {
     #ifdef NS_USB_PRESENT
             usb_handle_t usb_handle = NULL;
+            const bool bulk = (cfg->transport == NS_RPC_TRANSPORT_USB_BULK);
 
             // For server mode, add a service callback to USB
             // if (cfg->mode == NS_RPC_GENERICDATA_SERVER) {
             //     g_RpcGenericUSBHandle.service_cb = &ns_rpc_data_serverService;
             // }
+            g_RpcGenericUSBHandle.deviceType = bulk ? NS_USB_VENDOR_BULK_DEVICE : NS_USB_CDC_DEVICE;
             g_RpcGenericUSBHandle.rx_buffer = cfg->rx_buf;
             g_RpcGenericUSBHandle.rx_bufferLength = cfg->rx_bufLength;
             g_RpcGenericUSBHandle.tx_buffer = cfg->tx_buf;
@@ -166,7 +178,8 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
 
             // Common ERPC init
             /* USB transport layer initialization */
-            erpc_transport_t transport = erpc_transport_usb_cdc_init(usb_handle);
+            erpc_transport_t transport = bulk ? erpc_transport_usb_bulk_init(usb_handle)
+                                              : erpc_transport_usb_cdc_init(usb_handle);
 
             /* MessageBufferFactory initialization */
             erpc_mbf_t message_buffer_factory = erpc_mbf_static_init();
@@ -251,7 +264,9 @@ void ns_rpc_genericDataOperations_pollServer(ns_rpc_config_t *cfg) {
     if(ns_core_check_api(cfg->api, &ns_rpc_gdo_oldest_supported_version, &ns_rpc_gdo_V1_0_0) == NS_STATUS_SUCCESS) {
 #ifdef NS_USB_PRESENT
         if (ns_usb_data_available(cfg->usbHandle)) {
+            NS_TRACE_BEGIN("rpc_poll");
             stat = erpc_server_poll(); // service RPC server
+            NS_TRACE_END("rpc_poll");
             if (stat != kErpcStatus_Success) {
                 ns_lp_printf("erpc_server_poll failed with status %d\n", stat);
             }
@@ -259,10 +274,12 @@ void ns_rpc_genericDataOperations_pollServer(ns_rpc_config_t *cfg) {
 #endif
     }
     else {
-        if(cfg->transport == NS_RPC_TRANSPORT_USB) {
+        if((cfg->transport == NS_RPC_TRANSPORT_USB) || (cfg->transport == NS_RPC_TRANSPORT_USB_BULK)) {
     #ifdef NS_USB_PRESENT
             if (ns_usb_data_available(cfg->usbHandle)) {
+                NS_TRACE_BEGIN("rpc_poll");
                 stat = erpc_server_poll(); // service RPC server
+                NS_TRACE_END("rpc_poll");
                 if (stat != kErpcStatus_Success) {
                     ns_lp_printf("erpc_server_poll failed with status %d\n", stat);
                 }
@@ -270,7 +287,9 @@ void ns_rpc_genericDataOperations_pollServer(ns_rpc_config_t *cfg) {
     #endif
         }
         else {
+            NS_TRACE_BEGIN("rpc_poll");
             stat = erpc_server_poll(); // service RPC server
+            NS_TRACE_END("rpc_poll");
             if (stat != kErpcStatus_Success) {
                 ns_lp_printf("erpc_server_poll failed with status %d\n", stat);
             }
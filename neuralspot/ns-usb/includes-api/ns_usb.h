@@ -35,6 +35,20 @@ extern "C" {
     #define NS_USB_API_ID 0xCA0006
     #define MAX_URL_LENGTH 100
 
+    /// Timeout value for ns_usb_receive_data_timeout that never expires
+    #define NS_USB_WAIT_FOREVER 0xFFFFFFFF
+
+    /// Timeout used by ns_usb_recieve_data, in ms
+    #ifndef NS_USB_RX_TIMEOUT_MS
+        #define NS_USB_RX_TIMEOUT_MS 30000
+    #endif
+
+    /// Bytes of received CDC data ns-usb holds until it is read. TinyUSB's CDC class keeps its
+    /// own FIFO in rx_buffer, so this ring has separate storage.
+    #ifndef NS_USB_CDC_RX_RING_SIZE
+        #define NS_USB_CDC_RX_RING_SIZE 1024
+    #endif
+
 extern const ns_core_api_t ns_usb_V0_0_1;
 extern const ns_core_api_t ns_usb_V1_0_0;
 extern const ns_core_api_t ns_usb_oldest_supported_version;
@@ -47,7 +61,8 @@ typedef enum {
     NS_USB_CDC_DEVICE, ///< CDC (uart-like) device
     NS_USB_HID_DEVICE, ///< Human Interface Device (not supported)
     NS_USB_MSC_DEVICE, ///< Mass Storage Device (not supported)
-    NS_USB_VENDOR_DEVICE ///< Vendor Device (e.g. for WebUSB)
+    NS_USB_VENDOR_DEVICE, ///< Vendor Device (e.g. for WebUSB)
+    NS_USB_VENDOR_BULK_DEVICE ///< Vendor bulk endpoints as a byte stream (e.g. for eRPC)
 } ns_usb_device_type_e;
 
 /// @brief USB Transaction Control Stucture
@@ -79,8 +94,10 @@ typedef void (*ns_usb_service_cb)(uint8_t);
  */
 typedef struct {
     const ns_core_api_t *api;        ///< API prefix
-    ns_usb_device_type_e deviceType; ///< Device type, only CDC is currently supported
+    ns_usb_device_type_e deviceType; ///< Device type: CDC, VENDOR or VENDOR_BULK
     void *rx_buffer; ///< Pointer to allocated buffer which USB CDC will use for rx transfers
+                     ///< (CDC: TinyUSB's RX FIFO; VENDOR_BULK: holds received data until it
+                     ///< is read)
     uint16_t rx_bufferLength; ///< Length of rx buffer
     void *tx_buffer; ///< Pointer to allocated buffer which USB CDC will use for tx transfers
     uint16_t tx_bufferLength;     ///< Length of tx buffer
@@ -110,7 +127,7 @@ extern uint32_t ns_usb_init(ns_usb_config_t *, usb_handle_t *);
 extern void ns_usb_register_callbacks(usb_handle_t, ns_usb_rx_cb, ns_usb_tx_cb);
 
 /**
- * @brief Blocking USB Receive Data
+ * @brief Blocking USB Receive Data, waits up to NS_USB_RX_TIMEOUT_MS
  *
  * @param handle USB handle
  * @param buffer Pointer to buffer where data will be placed
@@ -119,6 +136,27 @@ extern void ns_usb_register_callbacks(usb_handle_t, ns_usb_rx_cb, ns_usb_tx_cb);
  */
 extern uint32_t ns_usb_recieve_data(usb_handle_t handle, void *buffer, uint32_t bufsize);
 
+/**
+ * @brief Receive CDC or vendor bulk data, sleeping (WFI) until it arrives or the timeout expires
+ *
+ * Returns as soon as bufsize bytes have been received. Bytes are consumed as they arrive, so
+ * bufsize may be larger than the rx buffer. The timeout has 1ms resolution; 0 returns
+ * whatever is already buffered, NS_USB_WAIT_FOREVER never times out.
+ *
+ * @param handle USB handle
+ * @param buffer Pointer to buffer where data will be placed
+ * @param bufsize Requested number of bytes
+ * @param timeout_ms Maximum time to wait, in ms
+ * @return uint32_t Bytes received, less than bufsize on timeout
+ */
+extern uint32_t ns_usb_receive_data_timeout(
+    usb_handle_t handle, void *buffer, uint32_t bufsize, uint32_t timeout_ms);
+
+/**
+ * @brief Number of received CDC or vendor bulk bytes waiting to be read
+ */
+extern uint32_t ns_usb_rx_available(usb_handle_t handle);
+
 /**
  * @brief Blocking USB Send Data
  *
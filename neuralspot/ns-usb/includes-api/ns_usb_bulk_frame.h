@@ -0,0 +1,80 @@
+/**
+ * @file ns_usb_bulk_frame.h
+ * @author Ambiq
+ * @brief Framing for byte streams carried over USB vendor bulk endpoints
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * A bulk IN transfer only completes on the host when a short packet arrives or the host's
+ * read buffer is full, so a stream sent as large host reads needs every message to end on a
+ * short packet. Each message is sent as one frame:
+ *
+ *   magic (2) | pad (2) | length (4) | payload (length) | pad bytes (pad)
+ *
+ * little endian, where pad is 1 if the frame would otherwise be a multiple of the endpoint's
+ * max packet size and 0 otherwise. The receiver strips headers and padding, so the payloads
+ * read back as a continuous stream. The host side lives in
+ * ns-rpc/python/ns-rpc-genericdata/usb_bulk_framing.py and must stay in sync with this.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NS_USB_BULK_FRAME_H
+#define NS_USB_BULK_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define NS_USB_BULK_FRAME_MAGIC 0x534E ///< "NS"
+#define NS_USB_BULK_FRAME_HEADER_SIZE 8
+
+/// Reads up to len bytes, returns the number read (fewer only on timeout or error)
+typedef uint32_t (*ns_usb_bulk_read_fn)(void *ctx, uint8_t *buf, uint32_t len);
+
+/// Receive state carried between reads
+typedef struct {
+    uint32_t remaining; ///< Payload bytes left in the current frame
+    uint32_t pad;       ///< Pad bytes following the current frame
+    uint32_t frames;    ///< Frames received
+    uint32_t resyncs;   ///< Bytes skipped looking for a frame header
+} ns_usb_bulk_deframer_t;
+
+/**
+ * @brief Build the header for a frame carrying len bytes
+ *
+ * @param hdr NS_USB_BULK_FRAME_HEADER_SIZE bytes, filled in
+ * @param len payload length
+ * @param max_packet endpoint max packet size (0 to never pad)
+ * @return uint32_t number of pad bytes to send after the payload
+ */
+uint32_t ns_usb_bulk_frame_header(uint8_t *hdr, uint32_t len, uint32_t max_packet);
+
+/**
+ * @brief Reset the receive state (e.g. after flushing the endpoint)
+ */
+void ns_usb_bulk_deframer_reset(ns_usb_bulk_deframer_t *d);
+
+/**
+ * @brief Read size payload bytes, stripping frame headers and padding
+ *
+ * Payload bytes are read straight into data. A read may span frames, and a frame may be
+ * consumed by several reads.
+ *
+ * @param d receive state
+ * @param read underlying byte reader
+ * @param ctx passed to read
+ * @param data destination
+ * @param size payload bytes wanted
+ * @return uint32_t payload bytes read, less than size if read came up short
+ */
+uint32_t ns_usb_bulk_deframe_read(
+    ns_usb_bulk_deframer_t *d, ns_usb_bulk_read_fn read, void *ctx, uint8_t *data,
+    uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // NS_USB_BULK_FRAME_H
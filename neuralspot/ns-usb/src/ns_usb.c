@@ -14,7 +14,9 @@
 #include "ns_usb.h"
 #include "ns_ambiqsuite_harness.h"
 #include "ns_core.h"
+#include "ns_ipc_ring_buffer.h"
 #include "ns_timer.h"
+#include "ns_trace.h"
 #include "tusb.h"
 
 const ns_core_api_t ns_usb_V0_0_1 = {.apiId = NS_USB_API_ID, .version = NS_USB_V0_0_1};
@@ -40,6 +42,15 @@ ns_usb_config_t usb_config = {
 
 volatile uint8_t gGotUSBRx = 0;
 
+// Receive ring for CDC and vendor bulk devices. Filled from the USB interrupts as data arrives,
+// drained by ns_usb_receive_data_timeout. Vendor bulk devices back it with cfg->rx_buffer; the
+// CDC class already uses that as its RX FIFO (cdc_device_ns.c), so CDC gets its own storage.
+static ns_ipc_ring_buffer_t ns_usb_rx_ring;
+static uint8_t ns_usb_cdc_rx_ring_data[NS_USB_CDC_RX_RING_SIZE];
+
+// USB service periods (1ms each) since init, used for receive timeouts
+static volatile uint32_t ns_usb_ticks = 0;
+
 // volatile const void *pTUSB_WeakFcnPointers[] =
 // {
 //     (void *)tud_mount_cb,
@@ -58,7 +69,39 @@ volatile uint8_t gGotUSBRx = 0;
 //     (void *)tud_descriptor_string_cb,
 // };
 
-bool ns_usb_data_available(usb_handle_t handle) { return (gGotUSBRx == 1); }
+bool ns_usb_data_available(usb_handle_t handle) {
+    return !ns_ipc_ring_buffer_empty(&ns_usb_rx_ring);
+}
+
+uint32_t ns_usb_rx_available(usb_handle_t handle) {
+    return ns_ipc_get_ring_buffer_status(&ns_usb_rx_ring);
+}
+
+// Move whatever TinyUSB has received into the RX ring. Called from the class rx callbacks and
+// the service interrupt; whatever doesn't fit stays in the TinyUSB FIFO (and the host is NAKed
+// once that fills) until a reader makes room. Emptying the FIFO here on every callback is what
+// keeps the OUT endpoint re-armed while the application is still consuming the previous data.
+void ns_usb_rx_drain(void) {
+    uint8_t chunk[64];
+    const bool vendor = (usb_config.deviceType == NS_USB_VENDOR_BULK_DEVICE);
+    if (ns_usb_rx_ring.ui32Capacity == 0) {
+        return; // not a streaming device
+    }
+    while (vendor ? tud_vendor_available() : tud_cdc_available()) {
+        uint32_t space =
+            ns_usb_rx_ring.ui32Capacity - ns_ipc_get_ring_buffer_status(&ns_usb_rx_ring);
+        if (space == 0) {
+            break;
+        }
+        uint32_t len = (space < sizeof(chunk)) ? space : sizeof(chunk);
+        uint32_t n = vendor ? tud_vendor_read(chunk, len) : tud_cdc_read(chunk, len);
+        if (n == 0) {
+            break;
+        }
+        ns_ipc_ring_buffer_push(&ns_usb_rx_ring, chunk, n, true);
+        NS_TRACE_COUNTER("usb_rx_ring", ns_ipc_get_ring_buffer_status(&ns_usb_rx_ring));
+    }
+}
 
 uint32_t ns_get_cdc_rx_bufferLength() { return usb_config.rx_bufferLength; }
 uint32_t ns_get_cdc_tx_bufferLength() { return usb_config.tx_bufferLength; }
@@ -70,7 +113,11 @@ uint8_t *ns_usb_get_tx_buffer() { return usb_config.tx_buffer; }
 static void ns_usb_service_callback(ns_timer_config_t *c) {
     // Invoked in ISR context
     // ns_lp_printf("U");
+    ns_usb_ticks++;
+    NS_TRACE_BEGIN("usb_service");
     tud_task();
+    ns_usb_rx_drain(); // picks up data that didn't fit in the ring earlier
+    NS_TRACE_END("usb_service");
     if (usb_config.service_cb != NULL) {
         usb_config.service_cb(gGotUSBRx);
         ns_lp_printf("got usb rx %d\n", gGotUSBRx);
@@ -110,6 +157,16 @@ uint32_t ns_usb_init(ns_usb_config_t *cfg, usb_handle_t *h) {
     usb_config.service_cb = cfg->service_cb;
     usb_config.desc_url = cfg->desc_url;
     *h = (void *)&usb_config;
+
+    ns_ipc_ringbuff_setup_t rx_ring_setup = {.indx = 0, .pData = NULL, .ui32ByteSize = 0};
+    if (cfg->deviceType == NS_USB_CDC_DEVICE) {
+        rx_ring_setup.pData = ns_usb_cdc_rx_ring_data;
+        rx_ring_setup.ui32ByteSize = sizeof(ns_usb_cdc_rx_ring_data);
+    } else if (cfg->deviceType == NS_USB_VENDOR_BULK_DEVICE) {
+        rx_ring_setup.pData = (uint8_t *)cfg->rx_buffer;
+        rx_ring_setup.ui32ByteSize = cfg->rx_bufferLength;
+    }
+    ns_ipc_ring_buffer_init(&ns_usb_rx_ring, rx_ring_setup);
     tusb_init();
 
     // Set up a timer to service usb
@@ -124,69 +181,41 @@ void ns_usb_register_callbacks(usb_handle_t handle, ns_usb_rx_cb rxcb, ns_usb_tx
     ((ns_usb_config_t *)handle)->tx_cb = txcb;
 }
 
-// Blocking read from USB. Will loop until we get the full buffer or timeout
-uint32_t ns_usb_recieve_data(usb_handle_t handle, void *buffer, uint32_t bufsize) {
-
-    // USB reads one block at a time, loop until we get full
-    // request
+uint32_t ns_usb_receive_data_timeout(
+    usb_handle_t handle, void *buffer, uint32_t bufsize, uint32_t timeout_ms) {
+    uint8_t *dst = (uint8_t *)buffer;
     uint32_t bytes_rx = 0;
-    uint32_t retries = 100000;
-    uint32_t block_retries = 15; // number of rx blocks we'll retry
-
-    if (gGotUSBRx == 0)
-        // ns_lp_printf("Kicking off read of %d, have %d, sem %d \n", bufsize, tud_cdc_available(),
-        //         gGotUSBRx);
-        ns_delay_us(100);
-    // uint32_t before = tud_cdc_available();
-    // uint8_t before_sem = gGotUSBRx;
-    // ns_delay_us(10);
-    // uint32_t after = tud_cdc_available();
-    // uint8_t after_sem = gGotUSBRx;
-    while (tud_cdc_available() < bufsize) {
-        // If there isn't enough data to satisfy request, wait for a while
-
-        // ns_lp_printf("Mystery path after %d %d %d\n", after, after_sem, gGotUSBRx);
-
-        // We only care abot gGotUSBRx in order to count 'blocks' (i.e. USB RX interrupts)
-        ns_interrupt_master_disable(); // critical region
-        if (tud_cdc_available() < bufsize) {
-            gGotUSBRx = 0; // set to 1 in IRQ context, need to disable IRQs for a bit
-        }
-        ns_interrupt_master_enable();
+    uint32_t start = ns_usb_ticks;
 
-        // Wait for a block to come in
-        while ((gGotUSBRx == 0) && (tud_cdc_available() < bufsize)) {
-            ns_delay_us(750);
-            // tud_task(); // process USB events
-            retries--;
-            if (retries == 0) {
-                ns_lp_printf("[ERROR] ns_usb_recieve_data exhausted wait for sem\n");
-                break;
-            }
-        };
-
-        // Incoming blocks may be less than needed bytes, try up to 5 times
-        if (block_retries == 0) {
-            ns_lp_printf("[ERROR] ns_usb_recieve_data exhausted block retries\n");
+    NS_TRACE_BEGIN("usb_rx");
+    while (1) {
+        bytes_rx += ns_ipc_ring_buffer_pop(&ns_usb_rx_ring, dst + bytes_rx, bufsize - bytes_rx);
+        if (bytes_rx == bufsize) {
             break;
         }
-        block_retries--;
+        if ((timeout_ms != NS_USB_WAIT_FOREVER) && ((ns_usb_ticks - start) >= timeout_ms)) {
+            break;
+        }
+        // Pull in whatever the USB interrupt has queued instead of waiting for the next service
+        // tick, then sleep until the next interrupt if there is still nothing to read.
+        // Interrupts stay masked from the check to the WFI so an arrival in between still wakes
+        // it, and so tud_task can't race the service interrupt.
+        uint32_t state = am_hal_interrupt_master_disable();
+        tud_task();
+        ns_usb_rx_drain();
+        if (ns_ipc_ring_buffer_empty(&ns_usb_rx_ring)) {
+            am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_NORMAL);
+        }
+        am_hal_interrupt_master_set(state);
     }
-    // uint32_t after2 = tud_cdc_available();
-    // uint8_t after2_sem = gGotUSBRx;
     gGotUSBRx = 0;
-    ns_interrupt_master_disable(); // critical region
-    tud_task(); // process USB events
-    bytes_rx = tud_cdc_read((void *)buffer, bufsize);
-    ns_interrupt_master_enable();
-    // if (retries != 10000)
-    //     ns_lp_printf("rx_data ask %d got %d retries %d before cnt, sem: %d,%d, after cnt, sem: %d, %d, af2 cnt,sem: %d, %d\n",
-    //         bufsize, bytes_rx, retries, before, before_sem, after, after_sem, after2,
-    //         after2_sem);
-    // ns_lp_printf("Got bytes %d\n", bytes_rx);
-     ns_delay_us(200);
-
-    // dontoptimizeme = after + after_sem + before + before_sem + after2 + after2_sem;
+    NS_TRACE_END("usb_rx");
+    return bytes_rx;
+}
+
+// Blocking read from USB. Will loop until we get the full buffer or timeout
+uint32_t ns_usb_recieve_data(usb_handle_t handle, void *buffer, uint32_t bufsize) {
+    uint32_t bytes_rx = ns_usb_receive_data_timeout(handle, buffer, bufsize, NS_USB_RX_TIMEOUT_MS);
     if (bytes_rx != bufsize) {
         ns_lp_printf("[ERROR] RX error, asked for %d, got %d\n", bufsize, bytes_rx);
     }
@@ -199,13 +228,54 @@ void ns_usb_handle_read_error(usb_handle_t h) {
         ns_delay_us(10000);
     }
     ns_lp_printf("In error after wait\n");
-    tud_cdc_read_flush();
+    uint32_t state = am_hal_interrupt_master_disable();
+    if (usb_config.deviceType == NS_USB_VENDOR_BULK_DEVICE) {
+        tud_vendor_read_flush();
+    } else {
+        tud_cdc_read_flush();
+    }
+    ns_ipc_flush_ring_buffer(&ns_usb_rx_ring);
     gGotUSBRx = 0; // may be set by final RX
+    am_hal_interrupt_master_set(state);
+}
+
+// Vendor bulk send: the whole buffer is queued as one transfer and the IN endpoint is kept
+// busy from the TX FIFO, so there is no per-chunk delay. Callers frame their data (see
+// ns_usb_bulk_frame.h) so the transfer ends in a short packet.
+static uint32_t ns_usb_vendor_send_data(const uint8_t *buffer, uint32_t bufsize) {
+    uint32_t bytes_tx = 0;
+    uint32_t start = ns_usb_ticks;
+
+    NS_TRACE_BEGIN("usb_tx");
+    while (bytes_tx < bufsize) {
+        uint32_t state = am_hal_interrupt_master_disable();
+        uint32_t n = tud_vendor_write(buffer + bytes_tx, bufsize - bytes_tx);
+        tud_vendor_write_flush();
+        tud_task();
+        if (n) {
+            start = ns_usb_ticks;
+        } else if (tud_vendor_write_available() == 0) {
+            am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_NORMAL); // FIFO full, wait for the host
+        }
+        am_hal_interrupt_master_set(state);
+        bytes_tx += n;
+        if ((n == 0) && ((ns_usb_ticks - start) >= NS_USB_RX_TIMEOUT_MS)) {
+            ns_lp_printf("[ERROR] USB TX timeout, sent %d of %d\n", bytes_tx, bufsize);
+            NS_TRACE_INSTANT("usb_tx_timeout", bytes_tx);
+            break;
+        }
+    }
+    NS_TRACE_END("usb_tx");
+    return bytes_tx;
 }
 
 uint32_t ns_usb_send_data(usb_handle_t handle, void *buffer, uint32_t bufsize) {
 
     uint32_t bytes_tx = 0;
+    if (usb_config.deviceType == NS_USB_VENDOR_BULK_DEVICE) {
+        return ns_usb_vendor_send_data((const uint8_t *)buffer, bufsize);
+    }
+    NS_TRACE_BEGIN("usb_tx");
     // ns_lp_printf("NS USB  asked to send %d from 0x%x, \n", bufsize, (uint32_t)buffer);
     // Make sure there is no pending data in the USB TX buffer
     // This is a blocking call, so we can be sure that the buffer is flushed
@@ -236,6 +306,7 @@ uint32_t ns_usb_send_data(usb_handle_t handle, void *buffer, uint32_t bufsize) {
 
     // uint32_t retval =  tud_cdc_write(buffer, bufsize);
     // tud_cdc_write_flush();
+    NS_TRACE_END("usb_tx");
     return bytes_tx;
 }
 
@@ -0,0 +1,108 @@
+/**
+ * @file ns_usb_bulk_frame.c
+ * @author Ambiq
+ * @brief Framing for byte streams carried over USB vendor bulk endpoints
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_usb_bulk_frame.h"
+#include <string.h>
+
+static void ns_usb_bulk_put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void ns_usb_bulk_put32(uint8_t *p, uint32_t v) {
+    ns_usb_bulk_put16(p, v & 0xFFFF);
+    ns_usb_bulk_put16(p + 2, v >> 16);
+}
+
+static uint16_t ns_usb_bulk_get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+static uint32_t ns_usb_bulk_get32(const uint8_t *p) {
+    return ns_usb_bulk_get16(p) | ((uint32_t)ns_usb_bulk_get16(p + 2) << 16);
+}
+
+uint32_t ns_usb_bulk_frame_header(uint8_t *hdr, uint32_t len, uint32_t max_packet) {
+    uint32_t pad =
+        (max_packet && (((NS_USB_BULK_FRAME_HEADER_SIZE + len) % max_packet) == 0)) ? 1 : 0;
+    ns_usb_bulk_put16(hdr, NS_USB_BULK_FRAME_MAGIC);
+    ns_usb_bulk_put16(hdr + 2, (uint16_t)pad);
+    ns_usb_bulk_put32(hdr + 4, len);
+    return pad;
+}
+
+void ns_usb_bulk_deframer_reset(ns_usb_bulk_deframer_t *d) {
+    d->remaining = 0;
+    d->pad = 0;
+    d->frames = 0;
+    d->resyncs = 0;
+}
+
+// Read exactly len bytes, false if the reader came up short
+static int ns_usb_bulk_read_exact(ns_usb_bulk_read_fn read, void *ctx, uint8_t *buf, uint32_t len) {
+    while (len) {
+        uint32_t n = read(ctx, buf, len);
+        if (n == 0) {
+            return 0;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 1;
+}
+
+// Consume the previous frame's padding and the next header
+static int ns_usb_bulk_next_frame(ns_usb_bulk_deframer_t *d, ns_usb_bulk_read_fn read, void *ctx) {
+    uint8_t hdr[NS_USB_BULK_FRAME_HEADER_SIZE];
+
+    while (d->pad) {
+        if (!ns_usb_bulk_read_exact(read, ctx, hdr, 1)) {
+            return 0;
+        }
+        d->pad--;
+    }
+    if (!ns_usb_bulk_read_exact(read, ctx, hdr, sizeof(hdr))) {
+        return 0;
+    }
+    // Slide forward a byte at a time until a valid header lines up
+    while ((ns_usb_bulk_get16(hdr) != NS_USB_BULK_FRAME_MAGIC) ||
+           (ns_usb_bulk_get16(hdr + 2) > 1)) {
+        memmove(hdr, hdr + 1, sizeof(hdr) - 1);
+        d->resyncs++;
+        if (!ns_usb_bulk_read_exact(read, ctx, &hdr[sizeof(hdr) - 1], 1)) {
+            return 0;
+        }
+    }
+    d->pad = ns_usb_bulk_get16(hdr + 2);
+    d->remaining = ns_usb_bulk_get32(hdr + 4);
+    d->frames++;
+    return 1;
+}
+
+uint32_t ns_usb_bulk_deframe_read(
+    ns_usb_bulk_deframer_t *d, ns_usb_bulk_read_fn read, void *ctx, uint8_t *data,
+    uint32_t size) {
+    uint32_t got = 0;
+    while (got < size) {
+        if (d->remaining == 0) {
+            if (!ns_usb_bulk_next_frame(d, read, ctx)) {
+                break;
+            }
+            continue; // frames may be empty
+        }
+        uint32_t want = (size - got < d->remaining) ? size - got : d->remaining;
+        uint32_t n = read(ctx, data + got, want);
+        if (n == 0) {
+            break;
+        }
+        got += n;
+        d->remaining -= n;
+    }
+    return got;
+}
@@ -7,6 +7,7 @@
 
 extern volatile uint8_t gGotUSBRx;
 extern ns_usb_config_t usb_config;
+extern void ns_usb_rx_drain(void);
 
 // Invoked when CDC interface received data from host
 void tud_cdc_rx_cb(uint8_t itf) {
@@ -20,6 +21,7 @@ void tud_cdc_rx_cb(uint8_t itf) {
         rx.itf = itf;
         usb_config.rx_cb(&rx);
     }
+    ns_usb_rx_drain();
     gGotUSBRx = 1;
     // ns_lp_printf("---rx---\n");
 }
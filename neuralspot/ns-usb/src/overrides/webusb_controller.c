@@ -55,6 +55,9 @@
 #include "usb_descriptors.h"
 #include "webusb_controller.h"
 
+extern ns_usb_config_t usb_config;
+extern void ns_usb_rx_drain(void);
+
 //--------------------------------------------------------------------+
 // Structure definitions
 //--------------------------------------------------------------------+
@@ -154,6 +157,12 @@ void tud_vendor_rx_cb(uint8_t itf) {
     (void)itf;
     uint32_t bytes_rx = 0;
 
+    // Vendor bulk devices carry a plain byte stream, queued for ns_usb_receive_data
+    if (usb_config.deviceType == NS_USB_VENDOR_BULK_DEVICE) {
+        ns_usb_rx_drain();
+        return;
+    }
+
     // check whether the remain size of RX ring-buffer is zero
     while (tud_vendor_available()) {
         uint16_t frame_header = 0;
@@ -0,0 +1,179 @@
+/**
+ * @file ns_arena.h
+ * @author Ambiq
+ * @brief Scoped bump allocator for feature extractor, NNSP, and model scratch memory
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * An ns_arena manages one caller-supplied block of memory. Persistent allocations
+ * (state that lives as long as the owning module) grow up from the bottom of the
+ * block, scratch allocations (buffers only used while a module is executing) grow
+ * down from the top.
+ *
+ * Each module that draws from the arena opens a stage with ns_arena_begin(). Every
+ * stage's scratch allocations start at the top of the block again, so modules that
+ * never run at the same time (e.g. MFCC followed by inference) share the same
+ * scratch memory. The arena tracks the high-water mark and, optionally, records
+ * each stage's requests so a pipeline can be sized exactly:
+ *
+ * @code
+ * ns_arena_t plan;
+ * ns_arena_init_plan(&plan);
+ * mfcc_cfg.pool = &plan;   ns_mfcc_init(&mfcc_cfg);   // records, doesn't touch memory
+ * ns_arena_print_plan(&plan);                         // per-stage breakdown
+ * // ns_arena_required(&plan) is the minimal size of the shared arena
+ * @endcode
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-arena
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_ARENA
+    #define NS_ARENA
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdbool.h>
+    #include <stddef.h>
+    #include <stdint.h>
+
+    /// Alignment used when an allocation asks for 0
+    #define NS_ARENA_DEFAULT_ALIGNMENT 16
+    /// Largest supported alignment (M55 cache line). Arena bounds are aligned to this.
+    #define NS_ARENA_MAX_ALIGNMENT 32
+    /// Number of stages whose requests are recorded for ns_arena_print_plan()
+    #define NS_ARENA_MAX_STAGES 8
+
+    /// Round a byte count up to an arena alignment boundary
+    #define NS_ARENA_ALIGN(bytes, align) (((bytes) + ((align) - 1)) & ~((uint32_t)(align) - 1))
+
+/**
+ * @brief Requests recorded for one stage (see ns_arena_begin)
+ *
+ */
+typedef struct {
+    const char *name;    ///< Stage name, as passed to ns_arena_begin
+    uint32_t persistent; ///< Bytes (incl. alignment padding) kept for the module's lifetime
+    uint32_t scratch;    ///< Bytes (incl. alignment padding) needed only while it runs
+    uint32_t failures;   ///< Requests that did not fit
+} ns_arena_stage_t;
+
+/**
+ * @brief Arena state. Initialize with ns_arena_init or ns_arena_init_plan.
+ *
+ */
+typedef struct {
+    uint8_t *base;         ///< Start of managed memory (NULL when planning)
+    uint32_t size;         ///< Size of managed memory, in bytes
+    uint32_t head;         ///< Persistent bytes in use, counted from base
+    uint32_t scratch;      ///< Scratch bytes used by the current stage, counted from the top
+    uint32_t scratch_peak; ///< Largest scratch footprint of any stage
+    uint32_t high_water;   ///< Largest head + scratch_peak seen
+    bool planning;         ///< Planning arenas only count, they never hand out memory
+    uint32_t failures;     ///< Failed requests in the current stage
+    uint32_t num_stages;   ///< Stages opened so far (may exceed NS_ARENA_MAX_STAGES)
+    ns_arena_stage_t stages[NS_ARENA_MAX_STAGES]; ///< Per-stage request log
+} ns_arena_t;
+
+/// Opaque position returned by ns_arena_mark
+typedef uint32_t ns_arena_mark_t;
+
+/**
+ * @brief Initialize an arena over a block of memory
+ *
+ * The usable region is trimmed so both ends are NS_ARENA_MAX_ALIGNMENT aligned; declare
+ * the backing buffer with __attribute__((aligned(NS_ARENA_MAX_ALIGNMENT))) to use all of it.
+ *
+ * @param a arena to initialize
+ * @param mem backing memory
+ * @param size size of backing memory, in bytes
+ * @return uint32_t status
+ */
+extern uint32_t ns_arena_init(ns_arena_t *a, void *mem, uint32_t size);
+
+/**
+ * @brief Initialize a planning arena: allocations always succeed, return NULL, and are
+ * only recorded. Use it to compute the exact size of a shared arena.
+ *
+ * @param a arena to initialize
+ * @return uint32_t status
+ */
+extern uint32_t ns_arena_init_plan(ns_arena_t *a);
+
+/**
+ * @brief Start a new stage. Subsequent allocations are accounted to this stage, and its
+ * scratch allocations overlay those of every other stage.
+ *
+ * @param a arena
+ * @param name stage name used by ns_arena_print_plan (string must outlive the arena)
+ */
+extern void ns_arena_begin(ns_arena_t *a, const char *name);
+
+/**
+ * @brief Close the current stage
+ *
+ * @param a arena
+ * @return uint32_t NS_STATUS_SUCCESS if every request in the stage was satisfied
+ */
+extern uint32_t ns_arena_end(ns_arena_t *a);
+
+/**
+ * @brief Allocate persistent memory
+ *
+ * @param a arena
+ * @param bytes requested size
+ * @param align power of two <= NS_ARENA_MAX_ALIGNMENT, or 0 for the default
+ * @return void* memory, or NULL if it doesn't fit (always NULL when planning)
+ */
+extern void *ns_arena_alloc(ns_arena_t *a, uint32_t bytes, uint32_t align);
+
+/**
+ * @brief Allocate scratch memory for the current stage. Scratch memory is only valid while
+ * the owning module runs - other stages reuse it.
+ *
+ * @param a arena
+ * @param bytes requested size
+ * @param align power of two <= NS_ARENA_MAX_ALIGNMENT, or 0 for the default
+ * @return void* memory, or NULL if it doesn't fit (always NULL when planning)
+ */
+extern void *ns_arena_scratch_alloc(ns_arena_t *a, uint32_t bytes, uint32_t align);
+
+/**
+ * @brief Remember the current persistent allocation point
+ */
+extern ns_arena_mark_t ns_arena_mark(ns_arena_t *a);
+
+/**
+ * @brief Release every persistent allocation made since the mark was taken
+ */
+extern void ns_arena_rewind(ns_arena_t *a, ns_arena_mark_t mark);
+
+/**
+ * @brief Release everything, keeping the high-water statistics
+ */
+extern void ns_arena_reset(ns_arena_t *a);
+
+/**
+ * @brief Minimal backing size (in bytes) for an aligned buffer that satisfies every request
+ * seen so far. On a planning arena this is the size of the shared pipeline arena.
+ */
+extern uint32_t ns_arena_required(const ns_arena_t *a);
+
+/**
+ * @brief Print the per-stage request log, totals, and high-water mark
+ */
+extern void ns_arena_print_plan(const ns_arena_t *a);
+
+static inline bool ns_arena_is_planning(const ns_arena_t *a) { return a->planning; }
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */ // end of ns-arena
@@ -0,0 +1,194 @@
+/**
+ * @file ns_cascade.h
+ * @author Ambiq
+ * @brief Early-exit model cascades (cheap gate model -> expensive model)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Always-on applications run a small model (VAD, wake word) on every frame and only sometimes
+ * need a large one (speaker ID, full KWS, ASR). ns_cascade runs such a chain: stage k runs on
+ * a frame only while the gate of stage k-1 is open, and each stage's score drives its own gate
+ * with hysteresis:
+ *
+ *   - the gate opens after onCount consecutive frames scoring >= onThreshold
+ *   - it stays open while scores stay >= offThreshold, and for hangover frames after that
+ *   - it closes at once when an upstream gate closes or the stage fails
+ *
+ * Every stage reads the same input frame in place. When a stage wakes up it can first be fed
+ * its lookback most recent frames from a shared history ring, so a model with context (an
+ * NNSP feature window, a streaming RNN) sees the onset that opened the gate. Stages idle for
+ * powerOffDelay frames get power(ctx, false), e.g. to power down the SRAM bank holding their
+ * arena, and power(ctx, true) before they next run.
+ *
+ * Per-stage counters give invocation rates, open time, timing and an energy estimate (active
+ * time at the stage's activeUw), so the saving against running everything can be read off
+ * ns_cascade_print_stats. Stage adapters exist for ns_model (ns_model_cascade_stage, ns-model)
+ * and NNSPClass (NNSPClass_cascade_stage, ns-nnsp); any other stage is a run callback that
+ * returns a score.
+ *
+ * @code
+ * static uint8_t history[8 * 320];  // 8 frames of 160 int16 samples
+ * ns_cascade_stage_t stages[2] = {
+ *     {.name = "vad", .run = vad_run, .ctx = &vad, .onThreshold = 0.6f, .offThreshold = 0.4f,
+ *      .onCount = 3, .hangover = 20, .activeUw = 300},
+ *     {.name = "nnid", .run = nnid_run, .ctx = &nnid, .onThreshold = 0.8f,
+ *      .offThreshold = 0.8f, .lookback = 6, .powerOffDelay = 100, .power = bank_power,
+ *      .activeUw = 9000}};
+ * ns_cascade_t cascade = {.api = &ns_cascade_V1_0_0, .stages = stages, .numStages = 2,
+ *                         .frameBytes = 320, .history = history, .historyFrames = 8,
+ *                         .onDetect = on_speaker, .timer = &tickTimer};
+ * ns_cascade_init(&cascade);
+ * ...
+ * ns_cascade_process(&cascade, pcmFrame); // every 10ms
+ * @endcode
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-cascade
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_CASCADE_H
+#define NS_CASCADE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ns_core.h"
+#include "ns_timer.h"
+
+#define NS_CASCADE_V1_0_0                                                                          \
+    { .major = 1, .minor = 0, .revision = 0 }
+#define NS_CASCADE_OLDEST_SUPPORTED_VERSION NS_CASCADE_V1_0_0
+#define NS_CASCADE_CURRENT_VERSION NS_CASCADE_V1_0_0
+#define NS_CASCADE_API_ID 0xCA0010
+
+extern const ns_core_api_t ns_cascade_V1_0_0;
+extern const ns_core_api_t ns_cascade_oldest_supported_version;
+extern const ns_core_api_t ns_cascade_current_version;
+
+#define NS_CASCADE_MAX_STAGES 4
+
+/// Stage body: run on one frame, write its confidence to score, return an NS_STATUS code
+typedef uint32_t (*ns_cascade_run_cb)(void *ctx, const void *frame, float *score);
+
+/// Power the stage's resources (e.g. its arena's SRAM bank) up or down
+typedef uint32_t (*ns_cascade_power_cb)(void *ctx, bool on);
+
+struct ns_cascade;
+
+/// Invoked when the last stage's gate opens, with the score that opened it
+typedef void (*ns_cascade_detect_cb)(struct ns_cascade *c, float score);
+
+/// Per-stage counters, cleared by init and reset; timing and energy need the cascade's timer
+typedef struct {
+    uint32_t invokes;       ///< run calls, replayed lookback frames included
+    uint32_t replays;       ///< run calls on lookback frames
+    uint32_t errors;        ///< run or power calls that failed
+    uint32_t opens;         ///< Times the gate opened
+    uint32_t openFrames;    ///< Frames ending with the gate open
+    uint32_t poweredFrames; ///< Frames with the stage powered
+    uint32_t powerUps;      ///< power(ctx, true) calls
+    uint32_t max_us;        ///< Longest run
+    uint64_t total_us;      ///< Time in run
+    uint64_t energy_pj;     ///< total_us * activeUw
+} ns_cascade_stage_stats_t;
+
+/// One stage: the model, its gate and its power hooks
+typedef struct {
+    const char *name;          ///< For ns_cascade_print_stats
+    ns_cascade_run_cb run;     ///< Stage body
+    void *ctx;                 ///< Passed to run and power
+    float onThreshold;         ///< Scores at or above it count towards opening the gate
+    float offThreshold;        ///< Scores below it start closing an open gate, <= onThreshold
+    uint16_t onCount;          ///< Consecutive frames >= onThreshold to open (0 is taken as 1)
+    uint16_t hangover;         ///< Frames the gate stays open once scores drop below off
+    uint16_t lookback;         ///< History frames fed to run when the stage wakes up
+    uint16_t powerOffDelay;    ///< Idle frames before power(ctx, false), with power set
+    ns_cascade_power_cb power; ///< Optional
+    uint32_t activeUw;         ///< Power while running, in uW, for the energy counter
+
+    // Internals
+    bool open;                      ///< Gate state
+    bool awake;                     ///< Ran on the previous frame
+    bool powered;                   ///< Set by init, cleared by power(ctx, false)
+    uint16_t count;                 ///< Consecutive frames >= onThreshold while closed
+    uint16_t hang;                  ///< Hangover frames left while open
+    uint32_t idle;                  ///< Frames since the stage last ran
+    float score;                    ///< Latest score
+    ns_cascade_stage_stats_t stats; ///< Counters
+} ns_cascade_stage_t;
+
+/// Cascade configuration and state
+typedef struct ns_cascade {
+    const ns_core_api_t *api;       ///< API prefix
+    ns_cascade_stage_t *stages;     ///< Stages in order, cheapest first
+    uint8_t numStages;              ///< 1..NS_CASCADE_MAX_STAGES
+    uint32_t frameBytes;            ///< Size of a frame, needed with history
+    uint8_t *history;               ///< historyFrames * frameBytes bytes, or NULL without lookback
+    uint16_t historyFrames;         ///< More than the largest lookback
+    ns_cascade_detect_cb onDetect;  ///< Optional
+    void *user;                     ///< For the application
+    ns_timer_config_t *timer;       ///< Optional, initialized timer for timing and energy
+
+    // Internals
+    uint32_t frames; ///< Frames processed
+} ns_cascade_t;
+
+/**
+ * @brief Validate the configuration and clear gates, history and counters
+ *
+ * Stages start powered and with their gates closed.
+ *
+ * @param c - cascade
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG
+ */
+extern uint32_t ns_cascade_init(ns_cascade_t *c);
+
+/**
+ * @brief Close every gate and clear the history and counters (power states are kept)
+ *
+ * @param c - cascade
+ */
+extern void ns_cascade_reset(ns_cascade_t *c);
+
+/**
+ * @brief Run one frame through the cascade
+ *
+ * With a history ring the frame is copied into it once and every stage reads that copy;
+ * without one every stage reads frame itself.
+ *
+ * @param c - cascade
+ * @param frame - frameBytes of input
+ * @return Number of stages whose gate is open after this frame (numStages: detected)
+ */
+extern uint32_t ns_cascade_process(ns_cascade_t *c, const void *frame);
+
+/**
+ * @brief Fraction of frames a stage ran on, replays included
+ *
+ * @param c - cascade
+ * @param k - stage index
+ * @return invokes / frames, 0 before the first frame
+ */
+extern float ns_cascade_rate(ns_cascade_t *c, uint32_t k);
+
+/**
+ * @brief Print per-stage invocation rates, timing and energy
+ *
+ * @param c - cascade
+ */
+extern void ns_cascade_print_stats(ns_cascade_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_CASCADE_H
+/** @}*/
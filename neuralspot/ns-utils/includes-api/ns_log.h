@@ -0,0 +1,233 @@
+/**
+ * @file ns_log.h
+ * @author Ambiq
+ * @brief Deferred binary logging: format-string IDs and raw argument words in a RAM ring
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * ns_lp_printf formats on the calling thread and blocks on the UART/SWO, which costs thousands
+ * of cycles per call and perturbs whatever is being measured. ns_log() instead stores each
+ * format string once, at build time, in the .ns_log_fmt section, and at run time appends a
+ * record of a few 32-bit words (header, format ID, timestamp, arguments) to a lock-free RAM
+ * ring. The ring is drained later, from the idle loop or before sleeping, to ITM, to the
+ * printf transport, or to a caller-supplied writer (e.g. an RPC or USB stream), and
+ * tools/ns_log_decode.py turns the words back into text using the application's ELF:
+ *
+ * @code
+ * static uint32_t logWords[1024];
+ * ns_log_config_t logCfg = {.api = &ns_log_V1_0_0, .buffer = logWords, .size = 1024,
+ *                           .sink = NS_LOG_SINK_ITM};
+ * ns_log_init(&logCfg);
+ * ...
+ * ns_log("frame %d energy %f", frame, energy);  // tens of cycles, safe from ISRs
+ * ...
+ * ns_log_drain(0);                              // in the idle loop
+ * @endcode
+ *
+ * @code
+ * ns_log_decode build/apollo4p_evb/app.axf swo.bin --itm 1
+ * @endcode
+ *
+ * Arguments are stored as one word each: integers and pointers are truncated to 32 bits and
+ * floating point values are stored as float, so %lld and %lf are not supported. A %s argument
+ * is decoded by reading the string from the ELF, so it must point to constant data. In C,
+ * pointers other than char * and void * need a (void *) cast. Format strings should not end in
+ * a newline, every record is a line.
+ *
+ * The GCC linker scripts place .ns_log_fmt in a non-allocated (INFO) section, so the strings
+ * take no flash. Toolchains without that (armclang scatter files) keep them in a regular
+ * read-only section, which only costs flash; decoding works the same way.
+ *
+ * Define NS_LOG_TEXT to turn ns_log() back into ns_lp_printf, or NS_LOG_DISABLE to compile
+ * it out.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-log
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_LOG_H
+#define NS_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ns_core.h"
+
+#define NS_LOG_V1_0_0                                                                              \
+    { .major = 1, .minor = 0, .revision = 0 }
+#define NS_LOG_OLDEST_SUPPORTED_VERSION NS_LOG_V1_0_0
+#define NS_LOG_CURRENT_VERSION NS_LOG_V1_0_0
+#define NS_LOG_API_ID 0xCA000E
+
+extern const ns_core_api_t ns_log_V1_0_0;
+extern const ns_core_api_t ns_log_oldest_supported_version;
+extern const ns_core_api_t ns_log_current_version;
+
+/// Most arguments a single ns_log() call can carry
+#define NS_LOG_MAX_ARGS 8
+/// Words in a record ahead of the arguments: header, format ID, timestamp
+#define NS_LOG_RECORD_OVERHEAD 3
+/// Record header word: 'NL' marker in the upper half (used to resync a stream), argument count
+#define NS_LOG_HEADER(nargs) (0x4E4C0000 | (nargs))
+#define NS_LOG_HEADER_MAGIC_MASK 0xFFFF0000
+/// Format ID of the records ns_log_drain() emits after an overflow, its argument is the count
+#define NS_LOG_ID_DROPPED 0xFFFFFFFF
+
+/// Where ns_log_drain() sends records
+typedef enum {
+    NS_LOG_SINK_ITM,      ///< 32-bit writes to ITM stimulus port itmPort (SWO)
+    NS_LOG_SINK_PRINTF,   ///< One "#NSL <hex words>" line per record through ns_lp_printf
+    NS_LOG_SINK_CALLBACK, ///< Record words passed to write, e.g. for an RPC or USB transport
+} ns_log_sink_e;
+
+/// Receives one record (or several) from ns_log_drain() for NS_LOG_SINK_CALLBACK
+typedef void (*ns_log_write_cb)(const uint32_t *words, uint32_t count, void *user);
+
+/// Ring counters, see ns_log_get_stats
+typedef struct {
+    uint32_t drained; ///< Records sent to the sink
+    uint32_t dropped; ///< Records lost because the ring was full
+    uint32_t maxFill; ///< Most words waiting in the ring at a drain
+} ns_log_stats_t;
+
+/// Log configuration and ring state
+typedef struct {
+    const ns_core_api_t *api; ///< API prefix
+    uint32_t *buffer;         ///< Ring storage, size words
+    uint32_t size;            ///< Ring size in words, a power of two
+    ns_log_sink_e sink;       ///< Drain destination
+    uint8_t itmPort;          ///< Stimulus port for NS_LOG_SINK_ITM
+    ns_log_write_cb write;    ///< Writer for NS_LOG_SINK_CALLBACK
+    void *user;               ///< Passed to write
+
+    // Internals
+    volatile uint32_t head;    ///< Words reserved by producers, free running
+    volatile uint32_t tail;    ///< Words released by the drain, free running
+    volatile uint32_t dropped; ///< Records dropped since init, updated by producers
+    uint32_t droppedReported;  ///< dropped value covered by the last drop record
+    ns_log_stats_t stats;      ///< Drain counters
+} ns_log_config_t;
+
+/**
+ * @brief Start logging into cfg's ring. Records written before this are discarded.
+ *
+ * @param cfg - configuration, must outlive the log
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG for a bad buffer size or sink
+ */
+extern uint32_t ns_log_init(ns_log_config_t *cfg);
+
+/**
+ * @brief Append a record to the ring, normally called through ns_log()
+ *
+ * Lock-free: safe from interrupt handlers and from several threads. When the ring is full the
+ * record is dropped and counted.
+ *
+ * @param fmt - format string, its address is the ID the decoder looks up
+ * @param args - argument words
+ * @param nargs - number of arguments, at most NS_LOG_MAX_ARGS
+ */
+extern void ns_log_write(const char *fmt, const uint32_t *args, uint32_t nargs);
+
+/**
+ * @brief Send committed records to the sink. Call from a single context, e.g. the idle loop.
+ *
+ * Stops at the first record a producer has reserved but not finished writing yet.
+ *
+ * @param maxRecords - most records to send, 0 for no limit
+ * @return uint32_t records sent (including a dropped-records marker)
+ */
+extern uint32_t ns_log_drain(uint32_t maxRecords);
+
+/**
+ * @brief Drain until the ring is empty, e.g. before deep sleep or a reset
+ */
+extern void ns_log_flush(void);
+
+/**
+ * @brief Copy the ring counters
+ *
+ * @param stats - receives the counters, dropped includes records not yet reported
+ */
+extern void ns_log_get_stats(ns_log_stats_t *stats);
+
+/// Format strings live in their own section so they can be left out of the image
+#define NS_LOG_FMT_SECTION __attribute__((section(".ns_log_fmt"), used))
+
+static inline uint32_t ns_log_float_word(double v) {
+    float f = (float)v;
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    return w;
+}
+
+static inline uint32_t ns_log_int_word(uint32_t v) { return v; }
+
+static inline uint32_t ns_log_ptr_word(const void *p) { return (uint32_t)(uintptr_t)p; }
+
+#ifdef __cplusplus
+}
+
+static inline uint32_t ns_log_word(float v) { return ns_log_float_word(v); }
+static inline uint32_t ns_log_word(double v) { return ns_log_float_word(v); }
+template <typename T> static inline uint32_t ns_log_word(T *p) { return ns_log_ptr_word(p); }
+template <typename T> static inline uint32_t ns_log_word(T v) { return (uint32_t)v; }
+    #define NS_LOG_WORD(x) ns_log_word(x)
+#else
+    #define NS_LOG_WORD(x)                                                                         \
+        _Generic((x),                                                                              \
+            float: ns_log_float_word,                                                              \
+            double: ns_log_float_word,                                                             \
+            char *: ns_log_ptr_word,                                                               \
+            const char *: ns_log_ptr_word,                                                         \
+            void *: ns_log_ptr_word,                                                               \
+            const void *: ns_log_ptr_word,                                                         \
+            default: ns_log_int_word)(x)
+#endif
+
+// Argument counting and per-argument word conversion, up to NS_LOG_MAX_ARGS. The format string
+// rides along so the variadic part is omitted, not empty, for calls without arguments.
+#define NS_LOG_NARGS(fmt, ...) NS_LOG_NARGS_(fmt, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define NS_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define NS_LOG_CAT(a, b) NS_LOG_CAT_(a, b)
+#define NS_LOG_CAT_(a, b) a##b
+#define NS_LOG_W0()
+#define NS_LOG_W1(a) , NS_LOG_WORD(a)
+#define NS_LOG_W2(a, ...) , NS_LOG_WORD(a) NS_LOG_W1(__VA_ARGS__)
+#define NS_LOG_W3(a, ...) , NS_LOG_WORD(a) NS_LOG_W2(__VA_ARGS__)
+#define NS_LOG_W4(a, ...) , NS_LOG_WORD(a) NS_LOG_W3(__VA_ARGS__)
+#define NS_LOG_W5(a, ...) , NS_LOG_WORD(a) NS_LOG_W4(__VA_ARGS__)
+#define NS_LOG_W6(a, ...) , NS_LOG_WORD(a) NS_LOG_W5(__VA_ARGS__)
+#define NS_LOG_W7(a, ...) , NS_LOG_WORD(a) NS_LOG_W6(__VA_ARGS__)
+#define NS_LOG_W8(a, ...) , NS_LOG_WORD(a) NS_LOG_W7(__VA_ARGS__)
+#define NS_LOG_WORDS(fmt, ...)                                                                     \
+    NS_LOG_CAT(NS_LOG_W, NS_LOG_NARGS(fmt, ##__VA_ARGS__))(__VA_ARGS__)
+
+#if defined(NS_LOG_DISABLE)
+    #define ns_log(fmt, ...)                                                                       \
+        do {                                                                                       \
+        } while (0)
+#elif defined(NS_LOG_TEXT)
+    #define ns_log(fmt, ...) ns_lp_printf(fmt "\n", ##__VA_ARGS__)
+#else
+    /**
+     * @brief Log a printf-style message as a binary record, see the file description
+     */
+    #define ns_log(fmt, ...)                                                                       \
+        do {                                                                                       \
+            static const char NS_LOG_FMT_SECTION ns_log_fmt_[] = fmt;                              \
+            const uint32_t ns_log_args_[] = {0 NS_LOG_WORDS(fmt, ##__VA_ARGS__)};                  \
+            ns_log_write(ns_log_fmt_, ns_log_args_ + 1, NS_LOG_NARGS(fmt, ##__VA_ARGS__));         \
+        } while (0)
+#endif
+
+#endif // NS_LOG_H
+/** @} */ // end of ns-log
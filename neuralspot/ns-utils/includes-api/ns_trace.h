@@ -0,0 +1,194 @@
+/**
+ * @file ns_trace.h
+ * @author Ambiq
+ * @brief Timestamped event tracing across ISRs and tasks, exported to Chrome/Perfetto
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * ns_trace records begin/end spans, instants and counter samples as fixed-size events (16 bytes
+ * on the EVB) in a RAM ring. Each event carries a timestamp, a static name, a value, and the
+ * track it happened on: the exception number when called from an ISR, otherwise the running
+ * task (see ns_trace_config_t.track). In NS_TRACE_RING mode the ring is a flight recorder that
+ * keeps the latest events, so it can be frozen with ns_trace_enable(false) right after a stall
+ * is detected; NS_TRACE_ONESHOT keeps the first events instead.
+ *
+ * ns_trace_dump() prints the ring as "#NST" lines, and tools/ns_trace_export.py turns a
+ * captured console log into Chrome trace JSON for chrome://tracing or ui.perfetto.dev:
+ *
+ * @code
+ * static ns_trace_event_t traceEvents[512];
+ * ns_trace_config_t traceCfg = {.api = &ns_trace_V1_0_0, .events = traceEvents, .size = 512,
+ *                               .mode = NS_TRACE_RING, .timer = &tickTimer};
+ * ns_trace_init(&traceCfg);
+ * ...
+ * ns_trace_begin("postprocess");
+ * ...
+ * ns_trace_end("postprocess");
+ * ns_trace_counter("queue_depth", depth);
+ * ...
+ * ns_trace_dump(NULL, NULL);
+ * @endcode
+ *
+ * neuralSPOT's own audio, USB, RPC, model and NNSP code is instrumented with the NS_TRACE_*
+ * macros below, which compile to nothing unless the build defines NS_TRACE (make TRACE=1).
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * \addtogroup ns-trace
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_TRACE_H
+#define NS_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ns_core.h"
+#include "ns_timer.h"
+
+#define NS_TRACE_V1_0_0                                                                            \
+    { .major = 1, .minor = 0, .revision = 0 }
+#define NS_TRACE_OLDEST_SUPPORTED_VERSION NS_TRACE_V1_0_0
+#define NS_TRACE_CURRENT_VERSION NS_TRACE_V1_0_0
+#define NS_TRACE_API_ID 0xCA000F
+
+extern const ns_core_api_t ns_trace_V1_0_0;
+extern const ns_core_api_t ns_trace_oldest_supported_version;
+extern const ns_core_api_t ns_trace_current_version;
+
+/// Tracks at or above this value are tasks (NS_TRACE_TASK_TRACK + track()), below are exceptions
+#define NS_TRACE_TASK_TRACK 128
+
+/// Event kinds, the values are the Chrome trace phase characters
+typedef enum {
+    NS_TRACE_PH_BEGIN = 'B',   ///< Span start
+    NS_TRACE_PH_END = 'E',     ///< Span end, closes the latest open span on the same track
+    NS_TRACE_PH_INSTANT = 'i', ///< Point event
+    NS_TRACE_PH_COUNTER = 'C', ///< Counter sample
+} ns_trace_phase_e;
+
+/// Ring behaviour once it is full
+typedef enum {
+    NS_TRACE_RING,    ///< Overwrite the oldest events (flight recorder)
+    NS_TRACE_ONESHOT, ///< Keep the first events, count the rest as dropped
+} ns_trace_mode_e;
+
+/// One recorded event
+typedef struct {
+    uint32_t timestamp; ///< Timer microseconds, or ticksPerUs-rate ticks without a timer
+    const char *name;   ///< Static string
+    int32_t value;      ///< Counter value, or an optional argument of the other phases
+    uint8_t phase;      ///< ns_trace_phase_e
+    uint8_t track;      ///< Exception number in an ISR, NS_TRACE_TASK_TRACK + task otherwise
+    uint16_t seq;       ///< Low bits of the event number plus one, written last to commit
+} ns_trace_event_t;
+
+/// Trace configuration and ring state
+typedef struct {
+    const ns_core_api_t *api;  ///< API prefix
+    ns_trace_event_t *events;  ///< Ring storage
+    uint32_t size;             ///< Events in the ring, a power of two
+    ns_trace_mode_e mode;      ///< Overwrite or stop when full
+    ns_timer_config_t *timer;  ///< Optional initialized timer for microsecond timestamps
+    uint32_t ticksPerUs;       ///< Without a timer: core MHz, timestamps are DWT cycles
+    uint8_t (*track)(void);    ///< Optional: current task number (0..127) in thread mode
+
+    // Internals
+    volatile uint32_t next;    ///< Events recorded since init, free running
+    volatile uint32_t dropped; ///< Events rejected by a full NS_TRACE_ONESHOT ring
+    volatile bool enabled;     ///< Recording, see ns_trace_enable
+} ns_trace_config_t;
+
+/// Receives ns_trace_dump() output one line at a time (without the newline)
+typedef void (*ns_trace_line_cb)(const char *line, void *user);
+
+/**
+ * @brief Start recording into cfg's ring, discarding previous events
+ *
+ * @param cfg - configuration, must outlive the trace
+ * @return NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG for a bad ring size or timestamp source
+ */
+extern uint32_t ns_trace_init(ns_trace_config_t *cfg);
+
+/**
+ * @brief Pause or resume recording, e.g. to freeze the flight recorder once a stall is seen
+ */
+extern void ns_trace_enable(bool enable);
+
+/**
+ * @brief Record an event. Lock-free: safe from ISRs and several tasks.
+ *
+ * @param phase - ns_trace_phase_e
+ * @param name - static string, shared by a span's begin and end
+ * @param value - counter value or span/instant argument
+ */
+extern void ns_trace_record(uint8_t phase, const char *name, int32_t value);
+
+static inline void ns_trace_begin(const char *name) {
+    ns_trace_record(NS_TRACE_PH_BEGIN, name, 0);
+}
+static inline void ns_trace_end(const char *name) { ns_trace_record(NS_TRACE_PH_END, name, 0); }
+static inline void ns_trace_instant(const char *name, int32_t value) {
+    ns_trace_record(NS_TRACE_PH_INSTANT, name, value);
+}
+static inline void ns_trace_counter(const char *name, int32_t value) {
+    ns_trace_record(NS_TRACE_PH_COUNTER, name, value);
+}
+
+/**
+ * @brief Copy the complete events still in the ring, oldest first
+ *
+ * Events being written, or overwritten while copying, are skipped. Pause recording first for
+ * a consistent snapshot.
+ *
+ * @param out - destination
+ * @param max - capacity of out
+ * @return uint32_t events copied
+ */
+extern uint32_t ns_trace_read(ns_trace_event_t *out, uint32_t max);
+
+/**
+ * @brief Print the ring as "#NST" lines for tools/ns_trace_export.py
+ *
+ * Recording is paused while dumping and restored afterwards.
+ *
+ * @param out - line writer, or NULL for ns_lp_printf
+ * @param user - passed to out
+ * @return uint32_t events printed
+ */
+extern uint32_t ns_trace_dump(ns_trace_line_cb out, void *user);
+
+// Instrumentation of neuralSPOT modules, only compiled in with NS_TRACE (make TRACE=1)
+#ifdef NS_TRACE
+    #define NS_TRACE_BEGIN(name) ns_trace_begin(name)
+    #define NS_TRACE_END(name) ns_trace_end(name)
+    #define NS_TRACE_INSTANT(name, value) ns_trace_instant(name, value)
+    #define NS_TRACE_COUNTER(name, value) ns_trace_counter(name, value)
+#else
+    #define NS_TRACE_BEGIN(name)                                                                   \
+        do {                                                                                       \
+        } while (0)
+    #define NS_TRACE_END(name)                                                                     \
+        do {                                                                                       \
+        } while (0)
+    #define NS_TRACE_INSTANT(name, value)                                                          \
+        do {                                                                                       \
+        } while (0)
+    #define NS_TRACE_COUNTER(name, value)                                                          \
+        do {                                                                                       \
+        } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_TRACE_H
+/** @} */ // end of ns-trace
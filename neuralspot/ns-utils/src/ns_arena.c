@@ -0,0 +1,172 @@
+/**
+ * @file ns_arena.c
+ * @author Ambiq
+ * @brief Scoped bump allocator for feature extractor, NNSP, and model scratch memory
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_arena.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_core.h"
+#include <string.h>
+
+static ns_arena_stage_t *ns_arena_current_stage(ns_arena_t *a) {
+    if ((a->num_stages == 0) || (a->num_stages > NS_ARENA_MAX_STAGES)) {
+        return NULL;
+    }
+    return &a->stages[a->num_stages - 1];
+}
+
+static uint32_t ns_arena_alignment(uint32_t align) {
+    if (align == 0) {
+        return NS_ARENA_DEFAULT_ALIGNMENT;
+    }
+    // Larger alignments can't be honored from a NS_ARENA_MAX_ALIGNMENT aligned top
+    return (align > NS_ARENA_MAX_ALIGNMENT) ? NS_ARENA_MAX_ALIGNMENT : align;
+}
+
+static void ns_arena_update_high_water(ns_arena_t *a) {
+    uint32_t used = a->head + a->scratch_peak;
+    if (used > a->high_water) {
+        a->high_water = used;
+    }
+}
+
+static void *ns_arena_fail(ns_arena_t *a) {
+    ns_arena_stage_t *s = ns_arena_current_stage(a);
+    a->failures++;
+    if (s) {
+        s->failures++;
+    }
+    return NULL;
+}
+
+uint32_t ns_arena_init(ns_arena_t *a, void *mem, uint32_t size) {
+    if ((a == NULL) || (mem == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    memset(a, 0, sizeof(ns_arena_t));
+
+    uintptr_t mask = (uintptr_t)NS_ARENA_MAX_ALIGNMENT - 1;
+    uintptr_t start = ((uintptr_t)mem + mask) & ~mask;
+    uintptr_t end = ((uintptr_t)mem + size) & ~mask;
+    if (end <= start) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    a->base = (uint8_t *)start;
+    a->size = (uint32_t)(end - start);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_arena_init_plan(ns_arena_t *a) {
+    if (a == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    memset(a, 0, sizeof(ns_arena_t));
+    a->planning = true;
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_arena_begin(ns_arena_t *a, const char *name) {
+    a->num_stages++;
+    a->scratch = 0; // every stage overlays the same scratch region
+    a->failures = 0;
+    ns_arena_stage_t *s = ns_arena_current_stage(a);
+    if (s) {
+        s->name = name;
+        s->persistent = 0;
+        s->scratch = 0;
+        s->failures = 0;
+    }
+}
+
+uint32_t ns_arena_end(ns_arena_t *a) {
+    uint32_t status = (a->failures == 0) ? NS_STATUS_SUCCESS : NS_STATUS_INIT_FAILED;
+    a->scratch = 0;
+    a->failures = 0;
+    return status;
+}
+
+void *ns_arena_alloc(ns_arena_t *a, uint32_t bytes, uint32_t align) {
+    uint32_t offset = NS_ARENA_ALIGN(a->head, ns_arena_alignment(align));
+    uint32_t end = offset + bytes;
+
+    // Persistent memory may not grow into any stage's scratch region
+    if ((end < offset) || (!a->planning && (end > a->size - a->scratch_peak))) {
+        return ns_arena_fail(a);
+    }
+
+    ns_arena_stage_t *s = ns_arena_current_stage(a);
+    if (s) {
+        s->persistent += end - a->head;
+    }
+    a->head = end;
+    ns_arena_update_high_water(a);
+    return a->planning ? NULL : a->base + offset;
+}
+
+void *ns_arena_scratch_alloc(ns_arena_t *a, uint32_t bytes, uint32_t align) {
+    // Scratch grows down from the (max-aligned) top, so aligning the footprint aligns the address
+    uint32_t footprint = NS_ARENA_ALIGN(a->scratch + bytes, ns_arena_alignment(align));
+
+    if ((footprint < a->scratch) || (!a->planning && (footprint > a->size - a->head))) {
+        return ns_arena_fail(a);
+    }
+
+    ns_arena_stage_t *s = ns_arena_current_stage(a);
+    if (s && (footprint > s->scratch)) {
+        s->scratch = footprint;
+    }
+    a->scratch = footprint;
+    if (footprint > a->scratch_peak) {
+        a->scratch_peak = footprint;
+    }
+    ns_arena_update_high_water(a);
+    return a->planning ? NULL : a->base + a->size - footprint;
+}
+
+ns_arena_mark_t ns_arena_mark(ns_arena_t *a) { return a->head; }
+
+void ns_arena_rewind(ns_arena_t *a, ns_arena_mark_t mark) {
+    if (mark <= a->head) {
+        a->head = mark;
+    }
+}
+
+void ns_arena_reset(ns_arena_t *a) {
+    a->head = 0;
+    a->scratch = 0;
+    a->scratch_peak = 0;
+    a->failures = 0;
+    a->num_stages = 0;
+}
+
+uint32_t ns_arena_required(const ns_arena_t *a) {
+    return NS_ARENA_ALIGN(a->high_water, NS_ARENA_MAX_ALIGNMENT);
+}
+
+void ns_arena_print_plan(const ns_arena_t *a) {
+    uint32_t persistent = 0;
+    uint32_t scratch = 0;
+    uint32_t stages = (a->num_stages > NS_ARENA_MAX_STAGES) ? NS_ARENA_MAX_STAGES : a->num_stages;
+
+    ns_lp_printf("Stage\tPersistent\tScratch\tFailures\n");
+    for (uint32_t i = 0; i < stages; i++) {
+        const ns_arena_stage_t *s = &a->stages[i];
+        ns_lp_printf(
+            "%s\t%d\t%d\t%d\n", s->name ? s->name : "(unnamed)", s->persistent, s->scratch,
+            s->failures);
+        persistent += s->persistent;
+        scratch += s->scratch;
+    }
+    if (a->num_stages > NS_ARENA_MAX_STAGES) {
+        ns_lp_printf("(%d more stages not recorded)\n", a->num_stages - NS_ARENA_MAX_STAGES);
+    }
+    ns_lp_printf(
+        "Separate arenas: %d bytes, shared arena: %d bytes (persistent %d, scratch %d)\n",
+        persistent + scratch, ns_arena_required(a), a->head, a->scratch_peak);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file ns_cascade.c
+ * @author Ambiq
+ * @brief Early-exit model cascades (cheap gate model -> expensive model)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+
+#include "ns_cascade.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_trace.h"
+
+const ns_core_api_t ns_cascade_V1_0_0 = {.apiId = NS_CASCADE_API_ID, .version = NS_CASCADE_V1_0_0};
+const ns_core_api_t ns_cascade_oldest_supported_version = {
+    .apiId = NS_CASCADE_API_ID, .version = NS_CASCADE_OLDEST_SUPPORTED_VERSION};
+const ns_core_api_t ns_cascade_current_version = {
+    .apiId = NS_CASCADE_API_ID, .version = NS_CASCADE_CURRENT_VERSION};
+
+uint32_t ns_cascade_init(ns_cascade_t *c) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (c == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (ns_core_check_api(
+            c->api, &ns_cascade_oldest_supported_version, &ns_cascade_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+#endif
+    if ((c->stages == NULL) || (c->numStages == 0) || (c->numStages > NS_CASCADE_MAX_STAGES)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((c->history != NULL) && ((c->frameBytes == 0) || (c->historyFrames == 0))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (uint32_t k = 0; k < c->numStages; k++) {
+        ns_cascade_stage_t *s = &c->stages[k];
+        if ((s->run == NULL) || (s->offThreshold > s->onThreshold)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        // Replayed frames come from the ring, and the current frame occupies one slot of it
+        if ((s->lookback != 0) && ((c->history == NULL) || (s->lookback >= c->historyFrames))) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        if (s->onCount == 0) {
+            s->onCount = 1;
+        }
+        s->powered = true;
+    }
+    ns_cascade_reset(c);
+    return NS_STATUS_SUCCESS;
+}
+
+static void ns_cascade_close(ns_cascade_stage_t *s) {
+    s->open = false;
+    s->count = 0;
+    s->hang = 0;
+}
+
+void ns_cascade_reset(ns_cascade_t *c) {
+    for (uint32_t k = 0; k < c->numStages; k++) {
+        ns_cascade_stage_t *s = &c->stages[k];
+        ns_cascade_close(s);
+        s->awake = false;
+        s->idle = 0;
+        s->score = 0.0f;
+        memset(&s->stats, 0, sizeof(ns_cascade_stage_stats_t));
+    }
+    c->frames = 0;
+}
+
+static uint32_t ns_cascade_run(ns_cascade_t *c, ns_cascade_stage_t *s, const void *in,
+                               float *score) {
+    uint32_t t0 = 0;
+
+    if (c->timer) {
+        t0 = ns_us_ticker_read(c->timer);
+    }
+    NS_TRACE_BEGIN(s->name);
+    uint32_t status = s->run(s->ctx, in, score);
+    NS_TRACE_END(s->name);
+    if (c->timer) {
+        uint32_t us = ns_us_ticker_read(c->timer) - t0;
+        s->stats.total_us += us;
+        s->stats.energy_pj += (uint64_t)us * s->activeUw;
+        if (us > s->stats.max_us) {
+            s->stats.max_us = us;
+        }
+    }
+    s->stats.invokes++;
+    if (status != NS_STATUS_SUCCESS) {
+        s->stats.errors++;
+    }
+    return status;
+}
+
+// Brings an idle stage back: powers it up and replays the frames it missed, oldest first
+static uint32_t ns_cascade_wake(ns_cascade_t *c, ns_cascade_stage_t *s) {
+    if (!s->powered && (s->power != NULL)) {
+        if (s->power(s->ctx, true) != NS_STATUS_SUCCESS) {
+            s->stats.errors++;
+            return NS_STATUS_FAILURE;
+        }
+        s->powered = true;
+        s->stats.powerUps++;
+        NS_TRACE_INSTANT("cascade_power_up", s->stats.powerUps);
+    }
+    uint32_t n = s->lookback;
+    if (n > s->idle) {
+        n = s->idle;
+    }
+    if (n > c->frames) {
+        n = c->frames;
+    }
+    for (uint32_t j = n; j > 0; j--) {
+        float ignored;
+        const uint8_t *past = c->history + ((c->frames - j) % c->historyFrames) * c->frameBytes;
+        ns_cascade_run(c, s, past, &ignored);
+        s->stats.replays++;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+// Hysteresis: onCount frames at or above on to open, below off for longer than hangover to close
+static void ns_cascade_gate(ns_cascade_stage_t *s, float score) {
+    if (!s->open) {
+        s->count = (score >= s->onThreshold) ? s->count + 1 : 0;
+        if (s->count >= s->onCount) {
+            s->open = true;
+            s->hang = s->hangover;
+            s->stats.opens++;
+        }
+    } else if (score >= s->offThreshold) {
+        s->hang = s->hangover;
+    } else if (s->hang > 0) {
+        s->hang--;
+    } else {
+        ns_cascade_close(s);
+    }
+}
+
+uint32_t ns_cascade_process(ns_cascade_t *c, const void *frame) {
+    const void *in = frame;
+    bool active = true;
+    uint32_t depth = 0;
+
+    if (c->history != NULL) {
+        uint8_t *slot = c->history + (c->frames % c->historyFrames) * c->frameBytes;
+        memcpy(slot, frame, c->frameBytes);
+        in = slot;
+    }
+
+    for (uint32_t k = 0; k < c->numStages; k++) {
+        ns_cascade_stage_t *s = &c->stages[k];
+        bool wasOpen = s->open;
+
+        if (active && !s->awake && (ns_cascade_wake(c, s) != NS_STATUS_SUCCESS)) {
+            active = false;
+        }
+        if (!active) {
+            // Gated off: closed, and powered down once idle long enough
+            ns_cascade_close(s);
+            s->awake = false;
+            s->idle++;
+            if (s->powered && (s->power != NULL) && (s->idle >= s->powerOffDelay)) {
+                if (s->power(s->ctx, false) == NS_STATUS_SUCCESS) {
+                    s->powered = false;
+                } else {
+                    s->stats.errors++;
+                }
+            }
+        } else {
+            float score = 0.0f;
+            s->awake = true;
+            s->idle = 0;
+            if (ns_cascade_run(c, s, in, &score) == NS_STATUS_SUCCESS) {
+                s->score = score;
+                ns_cascade_gate(s, score);
+            } else {
+                ns_cascade_close(s);
+            }
+            active = s->open;
+        }
+
+        if (s->powered) {
+            s->stats.poweredFrames++;
+        }
+        if (s->open) {
+            s->stats.openFrames++;
+            depth++;
+            if ((k + 1 == c->numStages) && !wasOpen && (c->onDetect != NULL)) {
+                c->onDetect(c, s->score);
+            }
+        }
+    }
+    c->frames++;
+    return depth;
+}
+
+float ns_cascade_rate(ns_cascade_t *c, uint32_t k) {
+    if ((k >= c->numStages) || (c->frames == 0)) {
+        return 0.0f;
+    }
+    return (float)c->stages[k].stats.invokes / c->frames;
+}
+
+void ns_cascade_print_stats(ns_cascade_t *c) {
+    uint64_t energy = 0, alwaysOn = 0;
+
+    ns_lp_printf("%-12s %8s %7s %6s %7s %6s %9s %11s %7s\n", "stage", "invokes", "rate %",
+                 "opens", "open %", "errors", "avg us", "energy uJ", "pwr %");
+    for (uint32_t k = 0; k < c->numStages; k++) {
+        ns_cascade_stage_t *s = &c->stages[k];
+        uint32_t frames = c->frames ? c->frames : 1;
+        uint32_t invokes = s->stats.invokes ? s->stats.invokes : 1;
+        ns_lp_printf("%-12s %8u %7.2f %6u %7.2f %6u %9u %11.1f %7.2f\n", s->name ? s->name : "?",
+                     (unsigned)s->stats.invokes, 100.0f * ns_cascade_rate(c, k),
+                     (unsigned)s->stats.opens, 100.0f * s->stats.openFrames / frames,
+                     (unsigned)s->stats.errors, (unsigned)(s->stats.total_us / invokes),
+                     (double)s->stats.energy_pj / 1e6,
+                     100.0f * s->stats.poweredFrames / frames);
+        energy += s->stats.energy_pj;
+        // The same stage run on every frame, at its measured energy per run
+        alwaysOn += s->stats.energy_pj * c->frames / invokes;
+    }
+    if (c->timer) {
+        ns_lp_printf("%u frames: %.1f uJ, %.1f uJ running every stage on every frame\n",
+                     (unsigned)c->frames, (double)energy / 1e6, (double)alwaysOn / 1e6);
+    }
+}
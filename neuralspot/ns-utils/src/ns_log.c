@@ -0,0 +1,214 @@
+/**
+ * @file ns_log.c
+ * @author Ambiq
+ * @brief Deferred binary logging ring and drain
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ns_log.h"
+#include "ns_ambiqsuite_harness.h"
+
+#ifdef NS_HOST_BUILD
+    #include <time.h>
+#endif
+
+const ns_core_api_t ns_log_V1_0_0 = {.apiId = NS_LOG_API_ID, .version = NS_LOG_V1_0_0};
+const ns_core_api_t ns_log_oldest_supported_version = {
+    .apiId = NS_LOG_API_ID, .version = NS_LOG_OLDEST_SUPPORTED_VERSION};
+const ns_core_api_t ns_log_current_version = {
+    .apiId = NS_LOG_API_ID, .version = NS_LOG_CURRENT_VERSION};
+
+static ns_log_config_t *ns_log_cfg = NULL;
+
+static inline uint32_t ns_log_timestamp(void) {
+#ifdef NS_HOST_BUILD
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+uint32_t ns_log_init(ns_log_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (ns_core_check_api(cfg->api, &ns_log_oldest_supported_version, &ns_log_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+#endif
+    // The largest record has to fit, and free-running indices only wrap cleanly on a power of 2
+    if ((cfg->buffer == NULL) || (cfg->size < NS_LOG_RECORD_OVERHEAD + NS_LOG_MAX_ARGS) ||
+        (cfg->size & (cfg->size - 1))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((cfg->sink > NS_LOG_SINK_CALLBACK) ||
+        ((cfg->sink == NS_LOG_SINK_CALLBACK) && (cfg->write == NULL))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#ifdef NS_HOST_BUILD
+    if (cfg->sink == NS_LOG_SINK_ITM) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#else
+    if ((cfg->sink == NS_LOG_SINK_ITM) && (cfg->itmPort > 31)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    // Timestamps are core cycles
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= _VAL2FLD(DWT_CTRL_CYCCNTENA, 1);
+#endif
+
+    ns_log_cfg = NULL;
+    memset(cfg->buffer, 0, cfg->size * sizeof(uint32_t));
+    cfg->head = 0;
+    cfg->tail = 0;
+    cfg->dropped = 0;
+    cfg->droppedReported = 0;
+    memset(&cfg->stats, 0, sizeof(cfg->stats));
+    __atomic_store_n(&ns_log_cfg, cfg, __ATOMIC_RELEASE);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_log_write(const char *fmt, const uint32_t *args, uint32_t nargs) {
+    ns_log_config_t *cfg = __atomic_load_n(&ns_log_cfg, __ATOMIC_ACQUIRE);
+    if (cfg == NULL) {
+        return;
+    }
+    if (nargs > NS_LOG_MAX_ARGS) {
+        nargs = NS_LOG_MAX_ARGS;
+    }
+    uint32_t words = NS_LOG_RECORD_OVERHEAD + nargs;
+    uint32_t mask = cfg->size - 1;
+
+    // Claim words at head; an interrupting producer either finishes first or claims after us
+    uint32_t head = __atomic_load_n(&cfg->head, __ATOMIC_RELAXED);
+    do {
+        uint32_t tail = __atomic_load_n(&cfg->tail, __ATOMIC_ACQUIRE);
+        if (head - tail + words > cfg->size) {
+            __atomic_fetch_add(&cfg->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(
+        &cfg->head, &head, head + words, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    uint32_t *b = cfg->buffer;
+    b[(head + 1) & mask] = ns_log_ptr_word(fmt);
+    b[(head + 2) & mask] = ns_log_timestamp();
+    for (uint32_t i = 0; i < nargs; i++) {
+        b[(head + NS_LOG_RECORD_OVERHEAD + i) & mask] = args[i];
+    }
+    // The header commits the record: the drain treats a zero header as still being written
+    __atomic_store_n(&b[head & mask], NS_LOG_HEADER(nargs), __ATOMIC_RELEASE);
+}
+
+static void ns_log_emit(ns_log_config_t *cfg, const uint32_t *words, uint32_t count) {
+    switch (cfg->sink) {
+    case NS_LOG_SINK_CALLBACK:
+        cfg->write(words, count, cfg->user);
+        break;
+
+    case NS_LOG_SINK_PRINTF: {
+        static const char hex[] = "0123456789abcdef";
+        char line[5 + (NS_LOG_RECORD_OVERHEAD + NS_LOG_MAX_ARGS) * 9 + 1];
+        char *p = line;
+        memcpy(p, "#NSL", 4);
+        p += 4;
+        for (uint32_t i = 0; i < count; i++) {
+            *p++ = ' ';
+            for (int32_t shift = 28; shift >= 0; shift -= 4) {
+                *p++ = hex[(words[i] >> shift) & 0xF];
+            }
+        }
+        *p = 0;
+        ns_lp_printf("%s\n", line);
+        break;
+    }
+
+    case NS_LOG_SINK_ITM:
+#ifndef NS_HOST_BUILD
+        // Nothing is listening unless the ITM and this port are enabled (see ns_itm_printf_enable)
+        if (!(ITM->TCR & ITM_TCR_ITMENA_Msk) || !(ITM->TER & (1u << cfg->itmPort))) {
+            break;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            while (ITM->PORT[cfg->itmPort].u32 == 0) {
+            }
+            ITM->PORT[cfg->itmPort].u32 = words[i];
+        }
+#endif
+        break;
+    }
+}
+
+uint32_t ns_log_drain(uint32_t maxRecords) {
+    ns_log_config_t *cfg = ns_log_cfg;
+    uint32_t record[NS_LOG_RECORD_OVERHEAD + NS_LOG_MAX_ARGS];
+    uint32_t sent = 0;
+
+    if (cfg == NULL) {
+        return 0;
+    }
+    uint32_t mask = cfg->size - 1;
+    uint32_t tail = cfg->tail;
+    uint32_t fill = __atomic_load_n(&cfg->head, __ATOMIC_RELAXED) - tail;
+    if (fill > cfg->stats.maxFill) {
+        cfg->stats.maxFill = fill;
+    }
+
+    // Report overflows ahead of the records that made it, so gaps show up where they happened
+    uint32_t dropped = __atomic_load_n(&cfg->dropped, __ATOMIC_RELAXED);
+    if (dropped != cfg->droppedReported) {
+        record[0] = NS_LOG_HEADER(1);
+        record[1] = NS_LOG_ID_DROPPED;
+        record[2] = ns_log_timestamp();
+        record[3] = dropped - cfg->droppedReported;
+        ns_log_emit(cfg, record, NS_LOG_RECORD_OVERHEAD + 1);
+        cfg->droppedReported = dropped;
+        sent++;
+    }
+
+    while ((maxRecords == 0) || (sent < maxRecords)) {
+        uint32_t header = __atomic_load_n(&cfg->buffer[tail & mask], __ATOMIC_ACQUIRE);
+        if (header == 0) {
+            break;
+        }
+        uint32_t words = NS_LOG_RECORD_OVERHEAD + (header & 0xFF);
+        for (uint32_t i = 0; i < words; i++) {
+            record[i] = cfg->buffer[(tail + i) & mask];
+            cfg->buffer[(tail + i) & mask] = 0;
+        }
+        tail += words;
+        // Release the words only after they're cleared, producers may reuse them right away
+        __atomic_store_n(&cfg->tail, tail, __ATOMIC_RELEASE);
+        ns_log_emit(cfg, record, words);
+        cfg->stats.drained++;
+        sent++;
+    }
+    return sent;
+}
+
+void ns_log_flush(void) {
+    ns_log_config_t *cfg = ns_log_cfg;
+    if (cfg == NULL) {
+        return;
+    }
+    // Stops early at a record whose producer was interrupted mid-write; the next drain sends it
+    while ((cfg->tail != cfg->head) && ns_log_drain(0)) {
+    }
+}
+
+void ns_log_get_stats(ns_log_stats_t *stats) {
+    ns_log_config_t *cfg = ns_log_cfg;
+    if ((cfg == NULL) || (stats == NULL)) {
+        return;
+    }
+    *stats = cfg->stats;
+    stats->dropped = cfg->dropped;
+}
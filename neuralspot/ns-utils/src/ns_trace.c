@@ -0,0 +1,201 @@
+/**
+ * @file ns_trace.c
+ * @author Ambiq
+ * @brief Timestamped event tracing ring
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ns_trace.h"
+#include "ns_ambiqsuite_harness.h"
+
+#ifdef NS_HOST_BUILD
+    #include <time.h>
+#endif
+
+const ns_core_api_t ns_trace_V1_0_0 = {.apiId = NS_TRACE_API_ID, .version = NS_TRACE_V1_0_0};
+const ns_core_api_t ns_trace_oldest_supported_version = {
+    .apiId = NS_TRACE_API_ID, .version = NS_TRACE_OLDEST_SUPPORTED_VERSION};
+const ns_core_api_t ns_trace_current_version = {
+    .apiId = NS_TRACE_API_ID, .version = NS_TRACE_CURRENT_VERSION};
+
+static ns_trace_config_t *ns_trace_cfg = NULL;
+
+static inline uint32_t ns_trace_timestamp(ns_trace_config_t *cfg) {
+    if (cfg->timer != NULL) {
+        return ns_us_ticker_read(cfg->timer);
+    }
+#ifdef NS_HOST_BUILD
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+static inline uint8_t ns_trace_track(ns_trace_config_t *cfg) {
+#ifndef NS_HOST_BUILD
+    uint32_t exception = __get_IPSR();
+    if (exception != 0) {
+        return (uint8_t)(exception < NS_TRACE_TASK_TRACK ? exception : NS_TRACE_TASK_TRACK - 1);
+    }
+#endif
+    return NS_TRACE_TASK_TRACK + (cfg->track ? (cfg->track() & (NS_TRACE_TASK_TRACK - 1)) : 0);
+}
+
+uint32_t ns_trace_init(ns_trace_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (ns_core_check_api(
+            cfg->api, &ns_trace_oldest_supported_version, &ns_trace_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+#endif
+    if ((cfg->events == NULL) || (cfg->size < 2) || (cfg->size & (cfg->size - 1))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (cfg->timer != NULL) {
+        cfg->ticksPerUs = 1;
+    } else {
+#ifdef NS_HOST_BUILD
+        cfg->ticksPerUs = 1000; // CLOCK_MONOTONIC nanoseconds
+#else
+        if (cfg->ticksPerUs == 0) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= _VAL2FLD(DWT_CTRL_CYCCNTENA, 1);
+#endif
+    }
+
+    ns_trace_cfg = NULL;
+    memset(cfg->events, 0, cfg->size * sizeof(ns_trace_event_t));
+    cfg->next = 0;
+    cfg->dropped = 0;
+    cfg->enabled = true;
+    __atomic_store_n(&ns_trace_cfg, cfg, __ATOMIC_RELEASE);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_trace_enable(bool enable) {
+    if (ns_trace_cfg != NULL) {
+        ns_trace_cfg->enabled = enable;
+    }
+}
+
+void ns_trace_record(uint8_t phase, const char *name, int32_t value) {
+    ns_trace_config_t *cfg = __atomic_load_n(&ns_trace_cfg, __ATOMIC_ACQUIRE);
+    if ((cfg == NULL) || !cfg->enabled) {
+        return;
+    }
+
+    uint32_t n;
+    if (cfg->mode == NS_TRACE_ONESHOT) {
+        n = __atomic_load_n(&cfg->next, __ATOMIC_RELAXED);
+        do {
+            if (n >= cfg->size) {
+                __atomic_fetch_add(&cfg->dropped, 1, __ATOMIC_RELAXED);
+                return;
+            }
+        } while (!__atomic_compare_exchange_n(
+            &cfg->next, &n, n + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    } else {
+        n = __atomic_fetch_add(&cfg->next, 1, __ATOMIC_RELAXED);
+    }
+
+    ns_trace_event_t *e = &cfg->events[n & (cfg->size - 1)];
+    // Invalidate first: a reader copying this slot from the previous lap must not accept it
+    __atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    e->timestamp = ns_trace_timestamp(cfg);
+    e->name = name;
+    e->value = value;
+    e->phase = phase;
+    e->track = ns_trace_track(cfg);
+    __atomic_store_n(&e->seq, (uint16_t)(n + 1), __ATOMIC_RELEASE);
+}
+
+uint32_t ns_trace_read(ns_trace_event_t *out, uint32_t max) {
+    ns_trace_config_t *cfg = ns_trace_cfg;
+    uint32_t copied = 0;
+
+    if ((cfg == NULL) || (out == NULL)) {
+        return 0;
+    }
+    uint32_t end = __atomic_load_n(&cfg->next, __ATOMIC_ACQUIRE);
+    if (end > cfg->size && cfg->mode == NS_TRACE_ONESHOT) {
+        end = cfg->size;
+    }
+    uint32_t start = (end > cfg->size) ? end - cfg->size : 0;
+
+    for (uint32_t n = start; (n != end) && (copied < max); n++) {
+        ns_trace_event_t *e = &cfg->events[n & (cfg->size - 1)];
+        uint16_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+        if (seq != (uint16_t)(n + 1)) {
+            continue; // still being written, or already reused
+        }
+        out[copied] = *e;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        // Seqlock check: the slot must not have been reclaimed while it was copied
+        if (__atomic_load_n(&e->seq, __ATOMIC_RELAXED) == seq) {
+            copied++;
+        }
+    }
+    return copied;
+}
+
+static void ns_trace_emit(ns_trace_line_cb out, void *user, const char *line) {
+    if (out != NULL) {
+        out(line, user);
+    } else {
+        ns_lp_printf("%s\n", line);
+    }
+}
+
+uint32_t ns_trace_dump(ns_trace_line_cb out, void *user) {
+    ns_trace_config_t *cfg = ns_trace_cfg;
+    ns_trace_event_t e;
+    char line[96];
+    uint32_t printed = 0;
+
+    if (cfg == NULL) {
+        return 0;
+    }
+    bool wasEnabled = cfg->enabled;
+    cfg->enabled = false;
+
+    uint32_t end = cfg->next;
+    if (end > cfg->size && cfg->mode == NS_TRACE_ONESHOT) {
+        end = cfg->size;
+    }
+    uint32_t start = (end > cfg->size) ? end - cfg->size : 0;
+    uint32_t lost = start + cfg->dropped;
+
+    snprintf(line, sizeof(line), "#NST-BEGIN ticks_per_us=%u events=%u lost=%u",
+             (unsigned)cfg->ticksPerUs, (unsigned)(end - start), (unsigned)lost);
+    ns_trace_emit(out, user, line);
+
+    for (uint32_t n = start; n != end; n++) {
+        e = cfg->events[n & (cfg->size - 1)];
+        if (e.seq != (uint16_t)(n + 1)) {
+            continue; // a producer was interrupted before committing it
+        }
+        snprintf(line, sizeof(line), "#NST %u %c %u %d %s", (unsigned)e.timestamp, e.phase,
+                 (unsigned)e.track, (int)e.value, e.name ? e.name : "?");
+        ns_trace_emit(out, user, line);
+        printed++;
+    }
+
+    ns_trace_emit(out, user, "#NST-END");
+    cfg->enabled = wasEnabled;
+    return printed;
+}
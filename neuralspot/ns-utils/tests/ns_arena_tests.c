@@ -0,0 +1,102 @@
+#include "ns_arena.h"
+#include "unity/unity.h"
+#include "ns_core.h"
+
+#define ARENA_TEST_SIZE 1024
+static uint8_t arenaMem[ARENA_TEST_SIZE] __attribute__((aligned(NS_ARENA_MAX_ALIGNMENT)));
+static ns_arena_t arena;
+
+void ns_arena_tests_pre_test_hook() {
+    ns_arena_init(&arena, arenaMem, ARENA_TEST_SIZE);
+}
+void ns_arena_tests_post_test_hook() {
+    // post hook if needed
+}
+
+// Two-stage pipeline used to compare planned and real sizes
+static uint32_t two_stage_pipeline(ns_arena_t *a) {
+    uint32_t status;
+    ns_arena_begin(a, "feature");
+    ns_arena_alloc(a, 100, 0);
+    ns_arena_scratch_alloc(a, 300, 0);
+    status = ns_arena_end(a);
+    ns_arena_begin(a, "model");
+    ns_arena_alloc(a, 60, 4);
+    ns_arena_scratch_alloc(a, 200, 0);
+    ns_arena_scratch_alloc(a, 150, 32);
+    status |= ns_arena_end(a);
+    return status;
+}
+
+void ns_arena_test_alignment() {
+    ns_arena_begin(&arena, "align");
+    uint8_t *p1 = ns_arena_alloc(&arena, 3, 1);
+    uint8_t *p2 = ns_arena_alloc(&arena, 8, 0);
+    uint8_t *p3 = ns_arena_alloc(&arena, 8, 32);
+    uint8_t *s1 = ns_arena_scratch_alloc(&arena, 5, 8);
+    TEST_ASSERT_NOT_NULL(p1);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)p2 % NS_ARENA_DEFAULT_ALIGNMENT);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)p3 % 32);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)s1 % 8);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_arena_end(&arena));
+}
+
+void ns_arena_test_mark_rewind() {
+    ns_arena_begin(&arena, "scope");
+    uint8_t *keep = ns_arena_alloc(&arena, 64, 0);
+    ns_arena_mark_t mark = ns_arena_mark(&arena);
+    uint8_t *tmp = ns_arena_alloc(&arena, 128, 0);
+    ns_arena_rewind(&arena, mark);
+    uint8_t *again = ns_arena_alloc(&arena, 16, 0);
+    TEST_ASSERT_NOT_NULL(keep);
+    TEST_ASSERT_EQUAL_PTR(tmp, again);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_arena_end(&arena));
+    // High water remembers the rewound allocation
+    TEST_ASSERT_EQUAL_UINT32(NS_ARENA_ALIGN(64 + 128, 32), ns_arena_required(&arena));
+}
+
+void ns_arena_test_scratch_overlay() {
+    ns_arena_begin(&arena, "a");
+    uint8_t *a = ns_arena_scratch_alloc(&arena, 256, 0);
+    ns_arena_end(&arena);
+    ns_arena_begin(&arena, "b");
+    uint8_t *b = ns_arena_scratch_alloc(&arena, 128, 0);
+    ns_arena_end(&arena);
+    // Both stages start at the top of the arena
+    TEST_ASSERT_EQUAL_PTR(a + 256, b + 128);
+    TEST_ASSERT_EQUAL_UINT32(256, ns_arena_required(&arena));
+}
+
+void ns_arena_test_exhaustion() {
+    ns_arena_begin(&arena, "big");
+    TEST_ASSERT_NOT_NULL(ns_arena_scratch_alloc(&arena, 512, 0));
+    TEST_ASSERT_NOT_NULL(ns_arena_alloc(&arena, 512, 0));
+    // Full - neither end may grow into the other
+    TEST_ASSERT_NULL(ns_arena_alloc(&arena, 1, 0));
+    TEST_ASSERT_NULL(ns_arena_scratch_alloc(&arena, 1, 0));
+    TEST_ASSERT_EQUAL(NS_STATUS_INIT_FAILED, ns_arena_end(&arena));
+    // Later stages can't take the scratch peak of an earlier stage as persistent memory
+    ns_arena_begin(&arena, "later");
+    TEST_ASSERT_NULL(ns_arena_alloc(&arena, 16, 0));
+    TEST_ASSERT_EQUAL(NS_STATUS_INIT_FAILED, ns_arena_end(&arena));
+}
+
+void ns_arena_test_plan_matches_real() {
+    ns_arena_t plan;
+    ns_arena_init_plan(&plan);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, two_stage_pipeline(&plan));
+    TEST_ASSERT_EQUAL_UINT32(2, plan.num_stages);
+    TEST_ASSERT_EQUAL_UINT32(100, plan.stages[0].persistent);
+    TEST_ASSERT_EQUAL_UINT32(304, plan.stages[0].scratch);
+    uint32_t required = ns_arena_required(&plan);
+    // Shared arena is smaller than the sum of separate ones
+    TEST_ASSERT_TRUE(
+        required < plan.stages[0].persistent + plan.stages[0].scratch +
+                       plan.stages[1].persistent + plan.stages[1].scratch);
+
+    // The planned size is exactly enough
+    ns_arena_init(&arena, arenaMem, required);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, two_stage_pipeline(&arena));
+    ns_arena_init(&arena, arenaMem, required - NS_ARENA_MAX_ALIGNMENT);
+    TEST_ASSERT_EQUAL(NS_STATUS_INIT_FAILED, two_stage_pipeline(&arena));
+}
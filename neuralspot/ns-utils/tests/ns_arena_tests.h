@@ -0,0 +1,8 @@
+#include "ns_arena.h"
+void ns_arena_tests_pre_test_hook();
+void ns_arena_tests_post_test_hook();
+void ns_arena_test_alignment();
+void ns_arena_test_mark_rewind();
+void ns_arena_test_scratch_overlay();
+void ns_arena_test_exhaustion();
+void ns_arena_test_plan_matches_real();
@@ -0,0 +1,445 @@
+/**
+ * @file audio_file_replay.c
+ * @author Ambiq
+ * @brief Host checks of the ns_audio file replay source, and front-end throughput and latency
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Writes synthetic recordings to temporary WAV and raw PCM files and replays them through
+ * ns_audio_init/ns_start_audio/ns_audio_file_poll exactly as an application would with a
+ * microphone:
+ *   - callback mode (mono, stereo) and ringbuffer mode deliver the recording bit for bit
+ *   - looping, raw PCM, WAV files with extra chunks, and configuration errors
+ *   - real-time pacing never runs ahead of the recording, and a consumer that stalls for more
+ *     than a frame shows up as late frames
+ * then feeds the replay into KWS (MFCC) and SE/NNID (NNSP feature) front ends built with
+ * ns_pipeline and reports throughput as fast as possible, and capture-to-feature latency in
+ * real time.
+ *
+ *   ./audio_file_replay [file.wav]   // optional 16 kHz mono recording for the front-end runs
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "feature_stage.h"
+#include "ns_audio.h"
+#include "ns_pipeline.h"
+
+#define SAMPLE_RATE 16000
+#define FRAME 160 // 10ms
+#define MONO_SAMPLES (SAMPLE_RATE + 77) // leaves a partial frame at the end
+#define STEREO_SAMPLES (SAMPLE_RATE / 2)
+#define PACED_FRAMES 30
+#define STALL_EVERY 10
+#define STALL_US 25000
+
+static int16_t mono[MONO_SAMPLES];
+static int16_t stereo[STEREO_SAMPLES * 2];
+static int16_t captured[MONO_SAMPLES * 3];
+static uint32_t capturedSamples;
+static int16_t audioBuffer[FRAME * 2];
+static uint8_t ringStorage[FRAME * 2];
+static ns_ipc_ring_buffer_t ring;
+static int errors;
+
+static ns_timer_config_t timer = {
+    .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+
+static void check(int ok, const char *what, double v) {
+    if (!ok && errors++ < 10) {
+        printf("FAIL %s: %g\n", what, v);
+    }
+}
+
+//
+// Recordings
+//
+static void synthesize(void) {
+    uint32_t seed = 7;
+    for (int i = 0; i < MONO_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        mono[i] = (int16_t)(6000.0 * sin(2 * M_PI * 523.0 * i / SAMPLE_RATE) +
+                            (double)((int32_t)(seed >> 20) - 2048));
+    }
+    for (int i = 0; i < STEREO_SAMPLES; i++) {
+        stereo[2 * i] = (int16_t)(i * 3);
+        stereo[2 * i + 1] = (int16_t)(-i * 5);
+    }
+}
+
+static void put32(FILE *f, uint32_t v) { fwrite(&v, 4, 1, f); }
+static void put16(FILE *f, uint16_t v) { fwrite(&v, 2, 1, f); }
+
+// A LIST chunk with an odd length sits before "data" when extraChunk is set, as some
+// recorders write
+static void write_wav(const char *path, const int16_t *pcm, uint32_t frames, int channels,
+                      int bits, int extraChunk) {
+    FILE *f = fopen(path, "wb");
+    uint32_t bytes = frames * channels * 2;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + bytes + (extraChunk ? 14 : 0));
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, channels);
+    put32(f, SAMPLE_RATE);
+    put32(f, SAMPLE_RATE * channels * 2);
+    put16(f, channels * 2);
+    put16(f, bits);
+    if (extraChunk) {
+        fwrite("LIST", 1, 4, f);
+        put32(f, 5);
+        fwrite("INFO\0\0", 1, 6, f); // 5 bytes plus the pad byte
+    }
+    fwrite("data", 1, 4, f);
+    put32(f, bytes);
+    fwrite(pcm, 2, frames * channels, f);
+    fclose(f);
+}
+
+static void temp_path(char *path) {
+    strcpy(path, "/tmp/audio_file_replayXXXXXX");
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+//
+// The application side: the usual audio callback
+//
+static void frame_callback(ns_audio_config_t *config, uint16_t bytesCollected) {
+    uint32_t n = config->numSamples * config->numChannels;
+    check(bytesCollected == n * sizeof(int16_t), "bytesCollected", bytesCollected);
+    if (config->eAudioApiMode == NS_AUDIO_API_RINGBUFFER) {
+        int16_t pcm[FRAME * 2];
+        ns_audio_getPCM_v2(config, pcm);
+        ns_ipc_ring_buffer_push(config->bufferHandle, pcm, n * sizeof(int16_t), false);
+        return;
+    }
+    if (capturedSamples + n <= sizeof(captured) / sizeof(captured[0])) {
+        memcpy(&captured[capturedSamples], config->audioBuffer, n * sizeof(int16_t));
+        capturedSamples += n;
+    }
+}
+
+static ns_audio_file_cfg_t fileCfg;
+static ns_audio_config_t audioCfg;
+
+static void setup(ns_audio_api_mode_e mode, uint8_t channels, ns_audio_file_pacing_e pacing,
+                  bool loop) {
+    fileCfg.pacing = pacing;
+    fileCfg.loop = loop;
+    fileCfg.timer = &timer;
+    audioCfg = (ns_audio_config_t){.api = &ns_audio_V2_1_0,
+                                   .eAudioApiMode = mode,
+                                   .callback = frame_callback,
+                                   .audioBuffer = mode == NS_AUDIO_API_RINGBUFFER
+                                                      ? (void *)ringStorage
+                                                      : (void *)audioBuffer,
+                                   .eAudioSource = NS_AUDIO_SOURCE_FILE,
+                                   .numChannels = channels,
+                                   .numSamples = FRAME,
+                                   .sampleRate = SAMPLE_RATE,
+                                   .bufferHandle = &ring,
+                                   .file_config = &fileCfg};
+    capturedSamples = 0;
+}
+
+static uint32_t start(void) {
+    uint32_t status = ns_audio_init(&audioCfg);
+    return status ? status : ns_start_audio(&audioCfg);
+}
+
+static void check_callback_replay(const char *path) {
+    check(ns_audio_file_load(&fileCfg, path) == NS_STATUS_SUCCESS, "load mono wav", 0);
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, false);
+    check(start() == NS_STATUS_SUCCESS, "start mono", 0);
+    while (ns_audio_file_poll(&audioCfg) == NS_STATUS_SUCCESS) {
+    }
+    uint32_t whole = (MONO_SAMPLES / FRAME) * FRAME;
+    check(capturedSamples == whole, "mono samples delivered", capturedSamples);
+    check(!memcmp(captured, mono, whole * sizeof(int16_t)), "mono replay bit-exact", 0);
+    check(fileCfg.stats.frames == MONO_SAMPLES / FRAME, "mono frames", fileCfg.stats.frames);
+    ns_end_audio(&audioCfg);
+    check(ns_audio_file_poll(&audioCfg) == NS_STATUS_INVALID_CONFIG, "poll after end", 0);
+
+    // Looping wraps at the last whole frame
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, true);
+    start();
+    for (int i = 0; i < 2 * (MONO_SAMPLES / FRAME) + 3; i++) {
+        ns_audio_file_poll(&audioCfg);
+    }
+    check(fileCfg.stats.loops == 2, "loops", fileCfg.stats.loops);
+    check(!memcmp(&captured[2 * whole], mono, 3 * FRAME * sizeof(int16_t)), "loop data", 0);
+    ns_end_audio(&audioCfg);
+    ns_audio_file_close(&fileCfg);
+}
+
+static void check_stereo(const char *path) {
+    check(ns_audio_file_load(&fileCfg, path) == NS_STATUS_SUCCESS, "load stereo wav", 0);
+    check(fileCfg.numChannels == 2, "stereo channels", fileCfg.numChannels);
+    setup(NS_AUDIO_API_CALLBACK, 2, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, false);
+    check(start() == NS_STATUS_SUCCESS, "start stereo", 0);
+    while (ns_audio_file_poll(&audioCfg) == NS_STATUS_SUCCESS) {
+    }
+    check(capturedSamples == STEREO_SAMPLES * 2, "stereo samples", capturedSamples);
+    check(!memcmp(captured, stereo, sizeof(stereo)), "stereo replay bit-exact", 0);
+    ns_end_audio(&audioCfg);
+
+    // A mono consumer can't take a stereo recording
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, false);
+    check(start() == NS_STATUS_INIT_FAILED, "channel mismatch rejected", 0);
+    ns_audio_file_close(&fileCfg);
+}
+
+static void check_ringbuffer(const char *rawPath) {
+    // Raw PCM has no header, the caller describes it
+    fileCfg.numChannels = 1;
+    fileCfg.sampleRate = SAMPLE_RATE;
+    check(ns_audio_file_load(&fileCfg, rawPath) == NS_STATUS_SUCCESS, "load raw pcm", 0);
+    setup(NS_AUDIO_API_RINGBUFFER, 1, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, false);
+    check(start() == NS_STATUS_SUCCESS, "start ringbuffer", 0);
+    while (ns_audio_file_poll(&audioCfg) == NS_STATUS_SUCCESS) {
+        int16_t pcm[FRAME];
+        check(ns_ipc_ring_buffer_pop(&ring, pcm, sizeof(pcm)) == sizeof(pcm), "ring pop", 0);
+        memcpy(&captured[capturedSamples], pcm, sizeof(pcm));
+        capturedSamples += FRAME;
+    }
+    check(!memcmp(captured, mono, capturedSamples * sizeof(int16_t)) &&
+              (capturedSamples == (MONO_SAMPLES / FRAME) * FRAME),
+          "ringbuffer replay bit-exact", capturedSamples);
+    ns_end_audio(&audioCfg);
+
+    // Pacing needs a clock, and the rate has to match the consumer
+    fileCfg.timer = NULL;
+    audioCfg.file_config->pacing = NS_AUDIO_FILE_REALTIME;
+    audioCfg.file_config->timer = NULL;
+    check(ns_start_audio(&audioCfg) == NS_STATUS_INIT_FAILED, "realtime without timer", 0);
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, false);
+    fileCfg.sampleRate = 8000;
+    check(start() == NS_STATUS_INIT_FAILED, "rate mismatch rejected", 0);
+    ns_audio_file_close(&fileCfg);
+}
+
+static void check_parser(const char *path) {
+    static uint8_t image[4096];
+    FILE *f;
+    size_t n;
+
+    // Extra chunk before data
+    write_wav(path, mono, 1000, 1, 16, 1);
+    f = fopen(path, "rb");
+    n = fread(image, 1, sizeof(image), f);
+    fclose(f);
+    memset(&fileCfg, 0, sizeof(fileCfg));
+    check(ns_audio_file_open(&fileCfg, image, n) == NS_STATUS_SUCCESS, "wav with LIST", 0);
+    check((fileCfg.numFrames == 1000) && !memcmp(fileCfg.pcm, mono, 2000), "LIST data", 0);
+
+    // Truncated image: the data chunk is clamped to what is there
+    check((ns_audio_file_open(&fileCfg, image, n - 101) == NS_STATUS_SUCCESS) &&
+              (fileCfg.numFrames == 1000 - 51),
+          "truncated data clamped", fileCfg.numFrames);
+
+    // 8-bit recordings aren't supported
+    write_wav(path, mono, 100, 1, 8, 0);
+    f = fopen(path, "rb");
+    n = fread(image, 1, sizeof(image), f);
+    fclose(f);
+    check(ns_audio_file_open(&fileCfg, image, n) == NS_STATUS_INVALID_CONFIG, "8-bit rejected",
+          0);
+}
+
+static void check_pacing(const char *path) {
+    check(ns_audio_file_load(&fileCfg, path) == NS_STATUS_SUCCESS, "load paced", 0);
+
+    // Idle consumer: frames never arrive before their capture time
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_REALTIME, false);
+    start();
+    uint32_t t0 = ns_us_ticker_read(&timer);
+    for (int i = 0; i < PACED_FRAMES; i++) {
+        ns_audio_file_poll(&audioCfg);
+        int32_t early = (int32_t)(fileCfg.frameUs - ns_us_ticker_read(&timer));
+        check(early <= 0, "frame delivered before capture completed", early);
+    }
+    uint32_t elapsed = ns_us_ticker_read(&timer) - t0;
+    check(elapsed >= PACED_FRAMES * 10000 - 1000, "real-time replay ran early", elapsed);
+    printf("real time, idle consumer:   %2u frames in %6.1f ms, %u late, worst %u us late\n",
+           (unsigned)fileCfg.stats.frames, elapsed / 1000.0, (unsigned)fileCfg.stats.lateFrames,
+           (unsigned)fileCfg.stats.maxLateUs);
+    ns_end_audio(&audioCfg);
+
+    // Stalling consumer: every stall longer than a frame period misses frames
+    setup(NS_AUDIO_API_CALLBACK, 1, NS_AUDIO_FILE_REALTIME, false);
+    start();
+    t0 = ns_us_ticker_read(&timer);
+    for (int i = 0; i < PACED_FRAMES; i++) {
+        ns_audio_file_poll(&audioCfg);
+        if ((i % STALL_EVERY) == STALL_EVERY - 1) {
+            ns_delay_us(STALL_US);
+        }
+    }
+    elapsed = ns_us_ticker_read(&timer) - t0;
+    check(fileCfg.stats.lateFrames >= (PACED_FRAMES / STALL_EVERY) - 1, "late frames",
+          fileCfg.stats.lateFrames);
+    check(fileCfg.stats.maxLateUs >= STALL_US - 10000, "max lateness", fileCfg.stats.maxLateUs);
+    printf("real time, 25ms stalls:     %2u frames in %6.1f ms, %u late, worst %u us late\n",
+           (unsigned)fileCfg.stats.frames, elapsed / 1000.0, (unsigned)fileCfg.stats.lateFrames,
+           (unsigned)fileCfg.stats.maxLateUs);
+    ns_end_audio(&audioCfg);
+    ns_audio_file_close(&fileCfg);
+}
+
+//
+// Front ends fed from the replay
+//
+#define MFCC_FRAME_LEN 480
+#define MFCC_HOP 320
+#define MFCC_FBANKS 40
+#define MFCC_COEFFS 13
+#define NNSP_FBANKS 40
+
+extern const int16_t stft_win_coeff_w480_h160[];
+
+static ns_pipeline_t *frontEnd;
+static uint32_t outputs;
+static uint64_t latencySum;
+static uint32_t latencyMax;
+
+static void front_end_callback(ns_audio_config_t *config, uint16_t bytesCollected) {
+    ns_pipeline_push(frontEnd, config->audioBuffer, config->numSamples);
+}
+
+// Latency from the end of the capture of the frame that completed the feature
+static void on_feature(ns_pipeline_t *p, const void *out) {
+    uint32_t us = ns_us_ticker_read(&timer) - fileCfg.frameUs;
+    latencySum += us;
+    if (us > latencyMax) {
+        latencyMax = us;
+    }
+    outputs++;
+}
+
+static uint32_t sink(void *ctx, const void *in, void *out) { return NS_STATUS_SUCCESS; }
+
+static void run_front_end(const char *name, ns_pipeline_t *p, ns_audio_file_pacing_e pacing,
+                          uint32_t maxFrames) {
+    frontEnd = p;
+    outputs = 0;
+    latencySum = 0;
+    latencyMax = 0;
+    ns_pipeline_reset(p);
+    setup(NS_AUDIO_API_CALLBACK, 1, pacing, false);
+    audioCfg.callback = front_end_callback;
+    start();
+    uint32_t t0 = ns_us_ticker_read(&timer);
+    while ((fileCfg.stats.frames < maxFrames) &&
+           (ns_audio_file_poll(&audioCfg) == NS_STATUS_SUCCESS)) {
+    }
+    uint32_t elapsed = ns_us_ticker_read(&timer) - t0;
+    double audioMs = fileCfg.stats.frames * 10.0;
+    if (pacing == NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE) {
+        printf("%-12s fast: %5u frames in %7.1f ms, %8.0f frames/s, %6.1fx real time\n", name,
+               (unsigned)fileCfg.stats.frames, elapsed / 1000.0,
+               fileCfg.stats.frames / (elapsed / 1e6), audioMs * 1000.0 / elapsed);
+    } else {
+        printf("%-12s real time: %u features, capture-to-feature latency avg %u us, max %u us, "
+               "%u late frames\n",
+               name, (unsigned)outputs, (unsigned)(outputs ? latencySum / outputs : 0),
+               (unsigned)latencyMax, (unsigned)fileCfg.stats.lateFrames);
+    }
+    ns_end_audio(&audioCfg);
+}
+
+static void front_ends(const char *path) {
+    static ns_mfcc_cfg_t mfcc;
+    static uint8_t mfccArena[NS_MFCC_ARENA_SIZE(MFCC_FRAME_LEN, 512, MFCC_FBANKS, MFCC_COEFFS)];
+    static int16_t mfccWindow[MFCC_FRAME_LEN], featWindow[FRAME];
+    static float mfccOut[MFCC_COEFFS];
+    static FeatureClass feat;
+    static int32_t mean[NNSP_FBANKS], stdR[NNSP_FBANKS];
+    static int16_t featOut[NNSP_FBANKS];
+    ns_pipeline_stage_t kwsStages[2], nnspStages[2];
+
+    if (ns_audio_file_load(&fileCfg, path) != NS_STATUS_SUCCESS) {
+        check(0, "load front-end recording", 0);
+        return;
+    }
+    if ((fileCfg.numChannels != 1) || (fileCfg.sampleRate != SAMPLE_RATE)) {
+        printf("%s: front ends need 16 kHz mono\n", path);
+        check(0, "front-end recording format", fileCfg.sampleRate);
+        ns_audio_file_close(&fileCfg);
+        return;
+    }
+
+    mfcc = (ns_mfcc_cfg_t){.api = &ns_mfcc_V1_0_0, .arena = mfccArena,
+                           .sample_frequency = SAMPLE_RATE, .num_fbank_bins = MFCC_FBANKS,
+                           .low_freq = 20, .high_freq = 4000, .num_frames = 49,
+                           .num_coeffs = MFCC_COEFFS, .num_dec_bits = 0,
+                           .frame_len = MFCC_FRAME_LEN, .frame_len_pow2 = 512};
+    ns_mfcc_init(&mfcc);
+    ns_pipeline_mfcc_stage(&kwsStages[0], &mfcc, mfccWindow, MFCC_HOP);
+    kwsStages[1] = (ns_pipeline_stage_t){.name = "sink", .run = sink, .item_bytes = 4,
+                                         .frame = MFCC_COEFFS, .hop = MFCC_COEFFS,
+                                         .window = (uint8_t *)mfccOut};
+    ns_pipeline_t kws = {.api = &ns_pipeline_V1_0_0, .stages = kwsStages, .numStages = 2,
+                         .onOutput = on_feature};
+
+    for (int i = 0; i < NNSP_FBANKS; i++) {
+        stdR[i] = 1 << 15;
+    }
+    FeatureClass_construct(&feat, mean, stdR, 8, NNSP_FBANKS, 480, FRAME, 512,
+                           stft_win_coeff_w480_h160);
+    FeatureClass_setDefault(&feat);
+    FeatureClass_stage(&nnspStages[0], &feat, featWindow);
+    nnspStages[1] = (ns_pipeline_stage_t){.name = "sink", .run = sink, .item_bytes = 2,
+                                          .frame = NNSP_FBANKS, .hop = NNSP_FBANKS,
+                                          .window = (uint8_t *)featOut};
+    ns_pipeline_t nnsp = {.api = &ns_pipeline_V1_0_0, .stages = nnspStages, .numStages = 2,
+                          .onOutput = on_feature};
+
+    check(ns_pipeline_init(&kws) == NS_STATUS_SUCCESS, "kws front end", 0);
+    check(ns_pipeline_init(&nnsp) == NS_STATUS_SUCCESS, "nnsp front end", 0);
+    run_front_end("KWS (MFCC)", &kws, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, UINT32_MAX);
+    run_front_end("SE/NNID", &nnsp, NS_AUDIO_FILE_AS_FAST_AS_POSSIBLE, UINT32_MAX);
+    run_front_end("KWS (MFCC)", &kws, NS_AUDIO_FILE_REALTIME, 50);
+    run_front_end("SE/NNID", &nnsp, NS_AUDIO_FILE_REALTIME, 50);
+    ns_audio_file_close(&fileCfg);
+}
+
+int main(int argc, char **argv) {
+    char wavPath[64], stereoPath[64], rawPath[64], scratch[64];
+
+    ns_timer_init(&timer);
+    synthesize();
+    temp_path(wavPath);
+    temp_path(stereoPath);
+    temp_path(rawPath);
+    temp_path(scratch);
+    write_wav(wavPath, mono, MONO_SAMPLES, 1, 16, 0);
+    write_wav(stereoPath, stereo, STEREO_SAMPLES, 2, 16, 1);
+    FILE *raw = fopen(rawPath, "wb");
+    fwrite(mono, sizeof(int16_t), MONO_SAMPLES, raw);
+    fclose(raw);
+
+    check_callback_replay(wavPath);
+    check_stereo(stereoPath);
+    check_ringbuffer(rawPath);
+    check_parser(scratch);
+    check_pacing(wavPath);
+    printf("replay checks: %s\n", errors ? "FAILED" : "ok");
+    front_ends(argc > 1 ? argv[1] : wavPath);
+
+    remove(wavPath);
+    remove(stereoPath);
+    remove(rawPath);
+    remove(scratch);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file audio_pipeline_sim.c
+ * @author Ambiq
+ * @brief Host run of ns_pipeline chains on WAV input, checked against hand-wired chains
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Reads a 16-bit mono WAV (or synthesizes and writes one when no file is given) and replays it
+ * 10ms at a time through three pipelines, the way an audio callback would: each frame is
+ * submitted by reference and the main loop processes the queue every other frame.
+ *   - KWS style: MFCC (30ms window, 20ms hop) -> classifier over 49 MFCC frames, 1 frame hop
+ *   - NNSP style: FeatureClass (STFT hop) -> classifier over 6 feature vectors
+ *   - Melspec (512 window, 256 hop) -> classifier over one frame
+ * Each output must match the same kernels called directly on the recording, bit for bit, and
+ * per-stage timing is printed. Also checks contract validation and frame dropping.
+ *
+ *   ./audio_pipeline_sim [file.wav]
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "feature_stage.h"
+#include "ns_audio_file.h"
+#include "ns_audio_melspec.h"
+#include "ns_audio_mfcc.h"
+#include "ns_pipeline.h"
+
+#define SAMPLE_RATE 16000
+#define SYNTH_SECONDS 3
+#define MAX_SAMPLES (SAMPLE_RATE * 30)
+#define CAPTURE_FRAME 160 // 10ms, what the audio callback delivers
+#define FRAME_DEPTH 4
+
+#define MFCC_FRAME_LEN 480
+#define MFCC_FRAME_POW2 512
+#define MFCC_HOP 320
+#define MFCC_FBANKS 40
+#define MFCC_COEFFS 13
+#define KWS_FRAMES 49
+
+#define NNSP_WIN 480
+#define NNSP_HOP 160
+#define NNSP_FFT 512
+#define NNSP_FBANKS 40
+
+#define MEL_FRAME_LEN 512
+#define MEL_HOP 256
+#define MEL_FBANKS 40
+
+static int16_t audio[MAX_SAMPLES];
+static uint32_t numSamples;
+static int errors;
+
+static void sim_error(const char *msg, double v) {
+    if (errors++ < 10) {
+        printf("FAIL %s: %g\n", msg, v);
+    }
+}
+
+//
+// WAV input
+//
+static void put32(FILE *f, uint32_t v) { fwrite(&v, 4, 1, f); }
+static void put16(FILE *f, uint16_t v) { fwrite(&v, 2, 1, f); }
+
+static int write_wav(const char *path, const int16_t *pcm, uint32_t n) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return -1;
+    }
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + n * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1); // PCM
+    put16(f, 1);
+    put32(f, SAMPLE_RATE);
+    put32(f, SAMPLE_RATE * 2);
+    put16(f, 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, n * 2);
+    fwrite(pcm, 2, n, f);
+    fclose(f);
+    return 0;
+}
+
+// Mono 16-bit PCM at SAMPLE_RATE only, returns samples read or -1
+static int read_wav(const char *path, int16_t *pcm, uint32_t max) {
+    ns_audio_file_cfg_t f = {0};
+    int n = -1;
+
+    if (ns_audio_file_load(&f, path) != NS_STATUS_SUCCESS) {
+        return -1;
+    }
+    if ((f.numChannels != 1) || (f.sampleRate != SAMPLE_RATE)) {
+        printf("%s: need 16-bit mono PCM at %d Hz\n", path, SAMPLE_RATE);
+    } else {
+        n = f.numFrames < max ? f.numFrames : max;
+        memcpy(pcm, f.pcm, n * sizeof(int16_t));
+    }
+    ns_audio_file_close(&f);
+    return n;
+}
+
+static void synthesize(void) {
+    uint32_t seed = 1;
+    numSamples = SAMPLE_RATE * SYNTH_SECONDS;
+    for (uint32_t i = 0; i < numSamples; i++) {
+        double t = (double)i / SAMPLE_RATE;
+        seed = seed * 1664525u + 1013904223u;
+        double chirp = 8000.0 * sin(2 * M_PI * (200.0 + 600.0 * t) * t);
+        audio[i] = (int16_t)(chirp * (0.5 + 0.5 * sin(2 * M_PI * 1.5 * t)) +
+                             (double)((int32_t)(seed >> 20) - 2048));
+    }
+}
+
+//
+// Stand-in classifiers: a fixed weighted sum per window, enough to prove that each window
+// holds the right frames in the right order
+//
+static uint32_t classify_float(void *ctx, const void *in, void *out) {
+    uint32_t n = *(const uint32_t *)ctx;
+    const float *x = (const float *)in;
+    float acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += x[i] * (float)((i % 7) + 1);
+    }
+    *(float *)out = acc;
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t classify_int16(void *ctx, const void *in, void *out) {
+    uint32_t n = *(const uint32_t *)ctx;
+    const int16_t *x = (const int16_t *)in;
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += x[i] * (int32_t)((i % 5) + 1);
+    }
+    *(int32_t *)out = acc;
+    return NS_STATUS_SUCCESS;
+}
+
+typedef struct {
+    float f[4096];
+    int32_t i[4096];
+    uint32_t count;
+} outputs_t;
+
+static void collect_float(ns_pipeline_t *p, const void *out) {
+    outputs_t *o = (outputs_t *)p->user;
+    if (o->count < 4096) {
+        o->f[o->count++] = *(const float *)out;
+    }
+}
+
+static void collect_int(ns_pipeline_t *p, const void *out) {
+    outputs_t *o = (outputs_t *)p->user;
+    if (o->count < 4096) {
+        o->i[o->count++] = *(const int32_t *)out;
+    }
+}
+
+static ns_timer_config_t timer = {
+    .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+
+// Replays the recording in capture frames, processing the queue every other frame
+static void replay(ns_pipeline_t *p) {
+    for (uint32_t i = 0; i + CAPTURE_FRAME <= numSamples; i += CAPTURE_FRAME) {
+        if (ns_pipeline_submit(p, &audio[i]) != NS_STATUS_SUCCESS) {
+            sim_error("frame dropped", i);
+        }
+        if ((i / CAPTURE_FRAME) & 1) {
+            ns_pipeline_process(p);
+        }
+    }
+    ns_pipeline_process(p);
+}
+
+//
+// KWS style: MFCC -> classifier over 49 frames
+//
+static ns_mfcc_cfg_t mfcc;
+static uint8_t mfccArena[NS_MFCC_ARENA_SIZE(
+    MFCC_FRAME_LEN, MFCC_FRAME_POW2, MFCC_FBANKS, MFCC_COEFFS)];
+
+static void init_mfcc(void) {
+    mfcc = (ns_mfcc_cfg_t){.api = &ns_mfcc_V1_0_0,
+                           .arena = mfccArena,
+                           .sample_frequency = SAMPLE_RATE,
+                           .num_fbank_bins = MFCC_FBANKS,
+                           .low_freq = 20,
+                           .high_freq = 4000,
+                           .num_frames = KWS_FRAMES,
+                           .num_coeffs = MFCC_COEFFS,
+                           .num_dec_bits = 0,
+                           .frame_len = MFCC_FRAME_LEN,
+                           .frame_len_pow2 = MFCC_FRAME_POW2};
+    if (ns_mfcc_init(&mfcc) != NS_STATUS_SUCCESS) {
+        sim_error("ns_mfcc_init", 0);
+    }
+}
+
+static void run_kws(void) {
+    static int16_t mfccWindow[MFCC_FRAME_LEN];
+    static float kwsWindow[KWS_FRAMES * MFCC_COEFFS];
+    static float ref[KWS_FRAMES * MFCC_COEFFS + 4096 * MFCC_COEFFS];
+    static outputs_t got;
+    static const void *slots[FRAME_DEPTH];
+    static uint32_t kwsLen = KWS_FRAMES * MFCC_COEFFS;
+    float result;
+    ns_pipeline_stage_t stages[2];
+
+    init_mfcc();
+    ns_pipeline_mfcc_stage(&stages[0], &mfcc, mfccWindow, MFCC_HOP);
+    stages[1] = (ns_pipeline_stage_t){.name = "kws_classifier",
+                                      .run = classify_float,
+                                      .ctx = &kwsLen,
+                                      .item_bytes = sizeof(float),
+                                      .frame = KWS_FRAMES * MFCC_COEFFS,
+                                      .hop = MFCC_COEFFS,
+                                      .out_bytes = sizeof(float),
+                                      .window = (uint8_t *)kwsWindow};
+    ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0,
+                          .stages = stages,
+                          .numStages = 2,
+                          .output = &result,
+                          .onOutput = collect_float,
+                          .user = &got,
+                          .timer = &timer,
+                          .frameSlots = slots,
+                          .frameDepth = FRAME_DEPTH,
+                          .frameItems = CAPTURE_FRAME};
+    if (ns_pipeline_init(&pipe) != NS_STATUS_SUCCESS) {
+        sim_error("kws ns_pipeline_init", 0);
+        return;
+    }
+    replay(&pipe);
+
+    // Hand-wired: MFCC on every hop of the recording, classifier on every 49-frame run
+    uint32_t frames = 0, expected = 0;
+    for (uint32_t s = 0; s + MFCC_FRAME_LEN <= numSamples; s += MFCC_HOP) {
+        ns_mfcc_compute(&mfcc, &audio[s], &ref[frames++ * MFCC_COEFFS]);
+    }
+    for (uint32_t f = 0; f + KWS_FRAMES <= frames; f++, expected++) {
+        float want;
+        classify_float(&kwsLen, &ref[f * MFCC_COEFFS], &want);
+        if ((expected < got.count) && (memcmp(&want, &got.f[expected], sizeof(float)) != 0)) {
+            sim_error("kws output mismatch at window", expected);
+        }
+    }
+    if (got.count != expected) {
+        sim_error("kws window count", (double)got.count - expected);
+    }
+    printf("KWS pipeline: %u MFCC frames, %u classifier windows, bit-exact with direct calls\n",
+           (unsigned)stages[0].stats.calls, (unsigned)got.count);
+    ns_pipeline_print_stats(&pipe);
+}
+
+//
+// NNSP style: FeatureClass -> classifier over the 6-frame context
+//
+extern const int16_t stft_win_coeff_w480_h160[];
+
+static void run_nnsp(void) {
+    static FeatureClass feat, featRef;
+    static int32_t mean[NNSP_FBANKS], stdR[NNSP_FBANKS];
+    static int16_t ctxWindow[NUM_FEATURE_CONTEXT * NNSP_FBANKS];
+    static outputs_t got;
+    static const void *slots[FRAME_DEPTH];
+    static uint32_t ctxLen = NUM_FEATURE_CONTEXT * NNSP_FBANKS;
+    int32_t result;
+    ns_pipeline_stage_t stages[2];
+
+    for (int i = 0; i < NNSP_FBANKS; i++) {
+        mean[i] = 0;
+        stdR[i] = 1 << 15;
+    }
+    FeatureClass_construct(&feat, mean, stdR, 8, NNSP_FBANKS, NNSP_WIN, NNSP_HOP, NNSP_FFT,
+                           stft_win_coeff_w480_h160);
+    FeatureClass_construct(&featRef, mean, stdR, 8, NNSP_FBANKS, NNSP_WIN, NNSP_HOP, NNSP_FFT,
+                           stft_win_coeff_w480_h160);
+    FeatureClass_setDefault(&feat);
+
+    // Capture frames are exactly one STFT hop, so the feature stage reads them in place
+    FeatureClass_stage(&stages[0], &feat, NULL);
+    stages[1] = (ns_pipeline_stage_t){.name = "nnsp_classifier",
+                                      .run = classify_int16,
+                                      .ctx = &ctxLen,
+                                      .item_bytes = sizeof(int16_t),
+                                      .frame = NUM_FEATURE_CONTEXT * NNSP_FBANKS,
+                                      .hop = NNSP_FBANKS,
+                                      .out_bytes = sizeof(int32_t),
+                                      .window = (uint8_t *)ctxWindow};
+    ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0,
+                          .stages = stages,
+                          .numStages = 2,
+                          .output = &result,
+                          .onOutput = collect_int,
+                          .user = &got,
+                          .timer = &timer,
+                          .frameSlots = slots,
+                          .frameDepth = FRAME_DEPTH,
+                          .frameItems = CAPTURE_FRAME};
+    if (ns_pipeline_init(&pipe) != NS_STATUS_SUCCESS) {
+        sim_error("nnsp ns_pipeline_init", 0);
+        return;
+    }
+    replay(&pipe);
+
+    // Hand-wired: FeatureClass keeps the context itself, classify it once it is full. Both
+    // instances share the default STFT history buffer, so reset it before the second run.
+    FeatureClass_setDefault(&featRef);
+    uint32_t expected = 0;
+    for (uint32_t s = 0, h = 0; s + NNSP_HOP <= numSamples; s += NNSP_HOP, h++) {
+        FeatureClass_execute(&featRef, &audio[s]);
+        if (h + 1 >= NUM_FEATURE_CONTEXT) {
+            int32_t want;
+            classify_int16(&ctxLen, featRef.normFeatContext, &want);
+            if ((expected < got.count) && (want != got.i[expected])) {
+                sim_error("nnsp output mismatch at hop", h);
+            }
+            expected++;
+        }
+    }
+    if (got.count != expected) {
+        sim_error("nnsp window count", (double)got.count - expected);
+    }
+    printf("NNSP pipeline: %u feature hops, %u classifier windows, bit-exact with direct calls\n",
+           (unsigned)stages[0].stats.calls, (unsigned)got.count);
+    ns_pipeline_print_stats(&pipe);
+}
+
+//
+// Melspec -> classifier
+//
+static void run_melspec(void) {
+    static ns_melspec_cfg_t mel, melRef;
+    static uint8_t melArena[NS_MELSPEC_ARENA_SIZE(MEL_FRAME_LEN, MEL_FBANKS)];
+    static uint8_t melRefArena[NS_MELSPEC_ARENA_SIZE(MEL_FRAME_LEN, MEL_FBANKS)];
+    static float stft[2 * MEL_FRAME_LEN], stftRef[2 * MEL_FRAME_LEN];
+    static int16_t melWindow[MEL_FRAME_LEN];
+    static float melOut[MEL_FBANKS];
+    static outputs_t got;
+    static uint32_t melLen = MEL_FBANKS;
+    float result;
+    ns_pipeline_stage_t stages[2];
+    ns_pipeline_melspec_t melCtx = {.cfg = &mel, .stft = stft};
+
+    mel = (ns_melspec_cfg_t){.arena = melArena,
+                             .sample_frequency = SAMPLE_RATE,
+                             .num_fbank_bins = MEL_FBANKS,
+                             .low_freq = 20,
+                             .high_freq = 8000,
+                             .num_frames = 1,
+                             .frame_len = MEL_FRAME_LEN,
+                             .frame_len_pow2 = MEL_FRAME_LEN,
+                             .compression_exponent = 1.0f};
+    melRef = mel;
+    melRef.arena = melRefArena;
+    if ((ns_melspec_init(&mel) != NS_STATUS_SUCCESS) ||
+        (ns_melspec_init(&melRef) != NS_STATUS_SUCCESS)) {
+        sim_error("ns_melspec_init", 0);
+        return;
+    }
+    ns_pipeline_melspec_stage(&stages[0], &melCtx, melWindow, MEL_HOP);
+    stages[1] = (ns_pipeline_stage_t){.name = "mel_classifier",
+                                      .run = classify_float,
+                                      .ctx = &melLen,
+                                      .item_bytes = sizeof(float),
+                                      .frame = MEL_FBANKS,
+                                      .hop = MEL_FBANKS,
+                                      .out_bytes = sizeof(float),
+                                      .window = (uint8_t *)melOut};
+    ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0,
+                          .stages = stages,
+                          .numStages = 2,
+                          .output = &result,
+                          .onOutput = collect_float,
+                          .user = &got,
+                          .timer = &timer};
+    if (ns_pipeline_init(&pipe) != NS_STATUS_SUCCESS) {
+        sim_error("melspec ns_pipeline_init", 0);
+        return;
+    }
+    // Synchronous push, in odd-sized pieces
+    for (uint32_t i = 0; i < numSamples; i += 97) {
+        uint32_t n = numSamples - i < 97 ? numSamples - i : 97;
+        ns_pipeline_push(&pipe, &audio[i], n);
+    }
+
+    uint32_t expected = 0;
+    for (uint32_t s = 0; s + MEL_FRAME_LEN <= numSamples; s += MEL_HOP, expected++) {
+        float want, feat[MEL_FBANKS];
+        ns_melspec_audio_to_stft(&melRef, &audio[s], stftRef);
+        ns_melspec_stft_to_compressed_melspec(&melRef, stftRef, feat);
+        classify_float(&melLen, feat, &want);
+        if ((expected < got.count) && (memcmp(&want, &got.f[expected], sizeof(float)) != 0)) {
+            sim_error("melspec output mismatch at frame", expected);
+        }
+    }
+    if (got.count != expected) {
+        sim_error("melspec frame count", (double)got.count - expected);
+    }
+    printf("Melspec pipeline: %u frames, bit-exact with direct calls\n", (unsigned)got.count);
+    ns_pipeline_print_stats(&pipe);
+}
+
+//
+// Contracts and frame handoff
+//
+static uint32_t passthrough(void *ctx, const void *in, void *out) {
+    memcpy(out, in, 4 * sizeof(int16_t));
+    return NS_STATUS_SUCCESS;
+}
+
+static void check_contracts(void) {
+    static int16_t w0[8], w1[6], out[4];
+    static const void *slots[2];
+    ns_pipeline_stage_t st[2] = {
+        {.name = "a", .run = passthrough, .item_bytes = 2, .frame = 8, .hop = 4, .out_bytes = 8,
+         .window = (uint8_t *)w0},
+        {.name = "b", .run = passthrough, .item_bytes = 2, .frame = 6, .hop = 4, .out_bytes = 8,
+         .window = (uint8_t *)w1}};
+    ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0, .stages = st, .numStages = 2,
+                          .output = out, .frameSlots = slots, .frameDepth = 2,
+                          .frameItems = 4};
+
+    // 4 upstream items do not tile a 6 item window
+    if (ns_pipeline_init(&pipe) != NS_STATUS_INVALID_CONFIG) {
+        sim_error("accepted an untileable window", 0);
+    }
+    st[1].frame = 8;
+    if (ns_pipeline_init(&pipe) != NS_STATUS_SUCCESS) {
+        sim_error("rejected a valid pipeline", 0);
+    }
+    // A window-less stage can only be first
+    st[1].window = NULL;
+    st[1].hop = 8;
+    if (ns_pipeline_init(&pipe) != NS_STATUS_INVALID_CONFIG) {
+        sim_error("accepted a window-less second stage", 0);
+    }
+    st[1].window = (uint8_t *)w1;
+    ns_pipeline_init(&pipe);
+
+    // The ring holds frameDepth handles, the next submit is dropped and counted
+    int16_t frame[4] = {1, 2, 3, 4};
+    uint32_t s0 = ns_pipeline_submit(&pipe, frame);
+    uint32_t s1 = ns_pipeline_submit(&pipe, frame);
+    uint32_t s2 = ns_pipeline_submit(&pipe, frame);
+    if ((s0 != NS_STATUS_SUCCESS) || (s1 != NS_STATUS_SUCCESS) || (s2 != NS_STATUS_FAILURE) ||
+        (pipe.dropped != 1) || (ns_pipeline_process(&pipe) != 2)) {
+        sim_error("frame ring depth", pipe.dropped);
+    }
+}
+
+int main(int argc, char **argv) {
+    ns_timer_init(&timer);
+    if (argc > 1) {
+        int n = read_wav(argv[1], audio, MAX_SAMPLES);
+        if (n <= 0) {
+            printf("Could not read %s\n", argv[1]);
+            return 1;
+        }
+        numSamples = n;
+    } else {
+        // Round trip the synthetic recording through a WAV file like a real capture
+        char path[] = "/tmp/audio_pipeline_simXXXXXX";
+        int fd = mkstemp(path);
+        synthesize();
+        if ((fd < 0) || write_wav(path, audio, numSamples)) {
+            printf("Could not write %s\n", path);
+            return 1;
+        }
+        memset(audio, 0, sizeof(audio));
+        int n = read_wav(path, audio, MAX_SAMPLES);
+        remove(path);
+        if (n != (int)(SAMPLE_RATE * SYNTH_SECONDS)) {
+            sim_error("wav round trip samples", n);
+        }
+        numSamples = n > 0 ? n : 0;
+    }
+    printf("%u samples (%.2f s)\n", (unsigned)numSamples, (double)numSamples / SAMPLE_RATE);
+
+    check_contracts();
+    run_kws();
+    run_nnsp();
+    run_melspec();
+
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file ble_dispatch_bench.c
+ * @author Ambiq
+ * @brief Host micro-benchmark of ns-ble event dispatch
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Lays out a service the way ns_ble_create_characteristic/ns_ble_add_characteristic do
+ * (declaration, value and CCC handles, CCC indices from 1, timer events from 0xC0) and feeds
+ * a stream of WSF messages - indication timer expiries, CCC state changes, ATT reads/writes
+ * and notification confirmations - through two dispatchers: the linear scan over services and
+ * characteristics ns_ble used to do, and the ns_ble_dispatch tables. Checks that both find
+ * the same characteristic for every message (and nothing for unrelated events), and reports
+ * the cost per message as the number of characteristics grows.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ns_ble_dispatch.h"
+
+#define MAX_CHARS 63 // timer event ids are 8 bit, starting at 0xC0
+#define MESSAGES 2000000
+#define BASE_HANDLE 0x0800
+#define FIRST_EVENT 0xC0
+
+// The fields of ns_ble_characteristic_t the dispatch paths look at
+typedef struct {
+    uint16_t declarationHandle;
+    uint16_t valueHandle;
+    uint16_t cccHandle;
+    uint16_t cccIndex;
+    uint16_t cccIndicationHandle;
+    uint32_t hits;
+} bench_char_t;
+
+typedef struct {
+    bench_char_t *characteristics[MAX_CHARS];
+    uint16_t numCharacteristics;
+} bench_service_t;
+
+typedef enum { MSG_TIMER, MSG_CCC, MSG_READ, MSG_WRITE, MSG_CNF, MSG_OTHER } bench_msg_e;
+
+typedef struct {
+    bench_msg_e type;
+    uint16_t key; // event id, CCC index or attribute handle
+} bench_msg_t;
+
+static bench_char_t chars[MAX_CHARS];
+static bench_service_t service;
+static bench_service_t *services[1] = {&service};
+static const int numServices = 1;
+static bench_msg_t msgs[MESSAGES];
+
+static ns_ble_dispatch_table_t handleTable, cccTable, eventTable;
+static void *handleStorage[3 * MAX_CHARS + 1], *cccStorage[MAX_CHARS], *eventStorage[MAX_CHARS];
+
+static void build_service(int n) {
+    uint16_t handle = BASE_HANDLE + 1; // the service declaration comes first
+    service.numCharacteristics = n;
+    for (int i = 0; i < n; i++) {
+        bench_char_t *c = &chars[i];
+        c->declarationHandle = handle++;
+        c->valueHandle = handle++;
+        c->cccHandle = handle++; // every characteristic notifies, the worst case for the scan
+        c->cccIndex = i + 1;
+        c->cccIndicationHandle = FIRST_EVENT + i;
+        service.characteristics[i] = c;
+    }
+
+    // What ns_ble_start_service builds
+    ns_ble_dispatch_init(&handleTable, handleStorage, BASE_HANDLE, handle - BASE_HANDLE);
+    ns_ble_dispatch_init(&cccTable, cccStorage, 1, n);
+    ns_ble_dispatch_init(&eventTable, eventStorage, FIRST_EVENT, n);
+    for (int i = 0; i < n; i++) {
+        bench_char_t *c = &chars[i];
+        ns_ble_dispatch_set(&handleTable, c->declarationHandle, c);
+        ns_ble_dispatch_set(&handleTable, c->valueHandle, c);
+        ns_ble_dispatch_set(&handleTable, c->cccHandle, c);
+        ns_ble_dispatch_set(&cccTable, c->cccIndex, c);
+        ns_ble_dispatch_set(&eventTable, c->cccIndicationHandle, c);
+    }
+}
+
+// Mostly timer expiries and confirmations (streaming traffic), some reads, writes, CCC changes
+// and DM/ATT events that fall through to the timer match
+static void build_messages(int n) {
+    srand(n);
+    for (int i = 0; i < MESSAGES; i++) {
+        bench_char_t *c = &chars[rand() % n];
+        int r = rand() % 100;
+        if (r < 40) {
+            msgs[i] = (bench_msg_t){MSG_TIMER, c->cccIndicationHandle};
+        } else if (r < 75) {
+            msgs[i] = (bench_msg_t){MSG_CNF, c->valueHandle};
+        } else if (r < 85) {
+            msgs[i] = (bench_msg_t){MSG_READ, c->valueHandle};
+        } else if (r < 93) {
+            msgs[i] = (bench_msg_t){MSG_WRITE, c->valueHandle};
+        } else if (r < 95) {
+            msgs[i] = (bench_msg_t){MSG_CCC, c->cccIndex};
+        } else {
+            msgs[i] = (bench_msg_t){MSG_OTHER, 0x20 + rand() % 0x40}; // DM event range
+        }
+    }
+}
+
+// ns_ble's pre-table dispatch: search every characteristic of every service
+static bench_char_t *dispatch_scan(const bench_msg_t *m) {
+    for (int i = 0; i < numServices; i++) {
+        bench_service_t *s = services[i];
+        for (int j = 0; j < s->numCharacteristics; j++) {
+            bench_char_t *c = s->characteristics[j];
+            switch (m->type) {
+            case MSG_TIMER:
+            case MSG_OTHER:
+                if (c->cccIndicationHandle == m->key) {
+                    return c;
+                }
+                break;
+            case MSG_CCC:
+                if (c->cccIndex == m->key) {
+                    return c;
+                }
+                break;
+            default:
+                if (c->valueHandle == m->key) {
+                    return c;
+                }
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+static bench_char_t *dispatch_table(const bench_msg_t *m) {
+    bench_char_t *c;
+    switch (m->type) {
+    case MSG_TIMER:
+    case MSG_OTHER:
+        return ns_ble_dispatch_get(&eventTable, m->key);
+    case MSG_CCC:
+        return ns_ble_dispatch_get(&cccTable, m->key);
+    default:
+        c = ns_ble_dispatch_get(&handleTable, m->key);
+        return ((c != NULL) && (c->valueHandle == m->key)) ? c : NULL;
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double run(bench_char_t *(*dispatch)(const bench_msg_t *), uint32_t *found) {
+    double t0 = now_ns();
+    for (int i = 0; i < MESSAGES; i++) {
+        bench_char_t *c = dispatch(&msgs[i]);
+        if (c != NULL) {
+            c->hits++; // the handler's work
+            (*found)++;
+        }
+    }
+    return (now_ns() - t0) / MESSAGES;
+}
+
+int main(void) {
+    static const int sizes[] = {4, 16, 32, 63};
+    int errors = 0;
+
+    printf("chars\tscan ns\ttable ns\tspeedup\n");
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const int n = sizes[s];
+        build_service(n);
+        build_messages(n);
+
+        for (int i = 0; i < MESSAGES; i++) {
+            if (dispatch_scan(&msgs[i]) != dispatch_table(&msgs[i])) {
+                fprintf(stderr, "%d chars: message %d dispatched differently\n", n, i);
+                errors++;
+                break;
+            }
+        }
+        // Keys just outside every table
+        const bench_msg_t edges[] = {
+            {MSG_TIMER, FIRST_EVENT - 1}, {MSG_TIMER, FIRST_EVENT + n}, {MSG_CCC, 0},
+            {MSG_CCC, n + 1},             {MSG_READ, BASE_HANDLE},      {MSG_WRITE, 0},
+            {MSG_CNF, 0xFFFF},            {MSG_READ, chars[0].cccHandle}};
+        for (unsigned i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+            if (dispatch_table(&edges[i]) != NULL) {
+                fprintf(stderr, "%d chars: edge key %u matched\n", n, edges[i].key);
+                errors++;
+            }
+        }
+
+        uint32_t foundScan = 0, foundTable = 0;
+        double scan = run(dispatch_scan, &foundScan);
+        double table = run(dispatch_table, &foundTable);
+        if (foundScan != foundTable) {
+            errors++;
+        }
+        printf("%d\t%7.2f\t%8.2f\t%6.1fx\n", n, scan, table, scan / table);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,395 @@
+/**
+ * @file ble_stream_sim.c
+ * @author Ambiq
+ * @brief Host simulation of credit-based BLE notification streaming
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Drives ns_ble_stream through a stand-in for Cordio's ATT server and the controller:
+ * AttsHandleValueNtf queues a message to the ATT handler, which hands the notification to
+ * L2CAP and confirms it right away while the ACL buffers have room, parks it (one per handle,
+ * ATT_NUM_SIMUL_NTF) while flow is disabled, and rejects it with ATT_ERR_OVERFLOW when one is
+ * already parked. Each connection event the controller sends up to PACKETS_PER_EVENT buffered
+ * packets to a central that reassembles them with ns_ble_stream_rx.
+ *
+ * Checks that every frame arrives intact, once and in order (also across rejections, dropped
+ * confirmations and a disconnect), and compares throughput against the one-notification-per-
+ * timer-tick path of ns_ble_send_value running at the connection interval. Also checks that
+ * confirmations arriving after a timeout are not taken for the resent fragments.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ns_ble_stream.h"
+
+#define CONN_INTERVAL_MS 15
+#define PACKETS_PER_EVENT 6 // 2M PHY, 251 byte packets
+#define ACL_BUFFERS 8       // controller + HCI queue before L2CAP disables flow
+#define SIM_EVENTS 400
+#define MAX_FRAME 1500
+#define QUEUE_BYTES 8192
+#define MIN_EFFICIENCY 0.9 // fraction of the link's packet slots the stream must fill
+#define MIN_SPEEDUP 3.0
+#define MAX_MSGS 64
+
+typedef struct {
+    uint8_t data[NS_BLE_STREAM_MAX_MTU];
+    uint16_t len;
+} sim_pkt_t;
+
+typedef struct {
+    sim_pkt_t q[MAX_MSGS];
+    int head, count;
+} sim_fifo_t;
+
+typedef struct {
+    uint32_t nowMs;
+    bool connected;
+    bool subscribed;
+    uint32_t allocFailEvery; // drop every Nth notification without a confirmation, 0 for never
+    uint32_t ntfCount;
+
+    sim_fifo_t attQueue; // messages to the ATT handler
+    sim_fifo_t acl;      // L2CAP/HCI/controller buffers
+    bool parked;         // notification waiting for flow to be enabled
+    sim_pkt_t parkedPkt;
+    int cnf[MAX_MSGS];   // confirmations queued to the application, 1 for ATT_SUCCESS
+    int cnfHead, cnfCount;
+    uint32_t lastCnfMs;
+
+    ns_ble_stream_rx_t rx;
+    uint8_t rxBuf[MAX_FRAME];
+    int64_t lastFrame;   // index of the last frame the central received
+    uint32_t rxFrames, rxBytes, gaps, packetsSent, events;
+    int errors;
+} sim_t;
+
+static uint8_t queue[QUEUE_BYTES];
+
+static void sim_error(sim_t *sim, const char *msg) {
+    if (sim->errors++ < 10) {
+        fprintf(stderr, "t=%ums: %s\n", sim->nowMs, msg);
+    }
+}
+
+static void fifo_push(sim_t *sim, sim_fifo_t *f, const uint8_t *data, uint16_t len) {
+    if (f->count == MAX_MSGS) {
+        sim_error(sim, "sim queue overflow");
+        return;
+    }
+    sim_pkt_t *p = &f->q[(f->head + f->count++) % MAX_MSGS];
+    memcpy(p->data, data, len);
+    p->len = len;
+}
+
+static sim_pkt_t *fifo_pop(sim_fifo_t *f) {
+    sim_pkt_t *p = &f->q[f->head];
+    f->head = (f->head + 1) % MAX_MSGS;
+    f->count--;
+    return p;
+}
+
+static void cnf_push(sim_t *sim, int ok) {
+    sim->cnf[(sim->cnfHead + sim->cnfCount++) % MAX_MSGS] = ok;
+}
+
+// Deterministic frame contents: index, then a pattern derived from it
+static uint32_t frame_len(uint32_t index) { return 4 + (index * 7919u) % (MAX_FRAME - 4); }
+
+static uint8_t frame_byte(uint32_t index, uint32_t i) { return (uint8_t)(index * 31 + i * 7); }
+
+static void make_frame(uint32_t index, uint8_t *buf) {
+    memcpy(buf, &index, 4);
+    for (uint32_t i = 4; i < frame_len(index); i++) {
+        buf[i] = frame_byte(index, i);
+    }
+}
+
+// *** Stack stand-ins
+static uint32_t sim_send(void *ctx, const uint8_t *data, uint16_t len) {
+    sim_t *sim = ctx;
+    if (!sim->connected || !sim->subscribed) {
+        return 1;
+    }
+    if (len > NS_BLE_STREAM_MAX_MTU - NS_BLE_STREAM_ATT_OVERHEAD) {
+        sim_error(sim, "notification longer than the MTU");
+    }
+    if (sim->allocFailEvery && ((++sim->ntfCount % sim->allocFailEvery) == 0)) {
+        return 0; // WsfMsgAlloc failed: no notification and no confirmation
+    }
+    fifo_push(sim, &sim->attQueue, data, len);
+    return 0;
+}
+
+static uint32_t sim_now(void *ctx) { return ((sim_t *)ctx)->nowMs; }
+
+// Central receives one packet
+static void sim_deliver(sim_t *sim, const sim_pkt_t *p) {
+    sim->packetsSent++;
+    if (!ns_ble_stream_rx_push(&sim->rx, p->data, p->len)) {
+        return;
+    }
+    uint32_t index;
+    memcpy(&index, sim->rxBuf, 4);
+    if ((int64_t)index <= sim->lastFrame) {
+        sim_error(sim, "frame received twice or out of order");
+        return;
+    }
+    if (sim->rx.frameLen != frame_len(index)) {
+        sim_error(sim, "frame length corrupt");
+        return;
+    }
+    for (uint32_t i = 4; i < sim->rx.frameLen; i++) {
+        if (sim->rxBuf[i] != frame_byte(index, i)) {
+            sim_error(sim, "frame data corrupt");
+            return;
+        }
+    }
+    sim->gaps += index - (uint32_t)(sim->lastFrame + 1);
+    sim->lastFrame = index;
+    sim->rxFrames++;
+    sim->rxBytes += sim->rx.frameLen;
+}
+
+// The WSF task: ATT handler messages, then confirmations to the ns-ble handler, which
+// returns the credit and pumps (ns_ble_generic_new_handle_cnf)
+static void sim_run_wsf(sim_t *sim, ns_ble_stream_t *s) {
+    while (sim->attQueue.count || sim->cnfCount) {
+        while (sim->attQueue.count) {
+            sim_pkt_t *p = fifo_pop(&sim->attQueue);
+            if (sim->parked) {
+                cnf_push(sim, 0); // ATT_ERR_OVERFLOW
+            } else if (sim->acl.count < ACL_BUFFERS) {
+                fifo_push(sim, &sim->acl, p->data, p->len);
+                cnf_push(sim, 1);
+            } else {
+                sim->parked = true;
+                sim->parkedPkt = *p;
+            }
+        }
+        while (sim->cnfCount) {
+            int ok = sim->cnf[sim->cnfHead];
+            sim->cnfHead = (sim->cnfHead + 1) % MAX_MSGS;
+            sim->cnfCount--;
+            sim->lastCnfMs = sim->nowMs;
+            ns_ble_stream_on_sent(s, ok);
+            ns_ble_stream_pump(s);
+        }
+    }
+    // Confirmation watchdog (the characteristic's WSF timer)
+    if ((s->inFlight || s->stale) && (sim->nowMs - sim->lastCnfMs >= 10 * CONN_INTERVAL_MS)) {
+        sim->lastCnfMs = sim->nowMs;
+        ns_ble_stream_on_timeout(s);
+        ns_ble_stream_pump(s);
+    }
+}
+
+static void sim_connection_event(sim_t *sim, ns_ble_stream_t *s) {
+    for (int i = 0; (i < PACKETS_PER_EVENT) && sim->acl.count; i++) {
+        sim_deliver(sim, fifo_pop(&sim->acl));
+    }
+    // Buffers freed: L2CAP enables flow and ATT sends (and confirms) the parked notification
+    if (sim->parked && (sim->acl.count < ACL_BUFFERS)) {
+        sim->parked = false;
+        fifo_push(sim, &sim->acl, sim->parkedPkt.data, sim->parkedPkt.len);
+        cnf_push(sim, 1);
+    }
+    sim->events++;
+    sim->nowMs += CONN_INTERVAL_MS;
+}
+
+static void sim_connect(sim_t *sim, ns_ble_stream_t *s, uint16_t mtu) {
+    sim->connected = true;
+    ns_ble_stream_set_mtu(s, mtu); // ATT_MTU_UPDATE_IND
+    sim->subscribed = true;        // ATTS_CCC_STATE_IND, the central starts a fresh reassembler
+    ns_ble_stream_rx_reset(&sim->rx);
+    ns_ble_stream_set_enabled(s, true);
+    ns_ble_stream_pump(s);
+}
+
+static void sim_disconnect(sim_t *sim, ns_ble_stream_t *s) {
+    sim_run_wsf(sim, s); // confirmations already queued are delivered before DM_CONN_CLOSE_IND
+    sim->connected = false;
+    sim->subscribed = false;
+    sim->attQueue.count = 0; // dropped by ATT, the connection is gone
+    sim->acl.count = 0;
+    sim->parked = false;
+    ns_ble_stream_link_reset(s);
+}
+
+static int run(uint16_t mtu, uint8_t maxInFlight, uint32_t allocFailEvery, bool disconnect) {
+    static uint8_t frame[MAX_FRAME];
+    sim_t sim = {.allocFailEvery = allocFailEvery, .lastFrame = -1};
+    sim.rx.buffer = sim.rxBuf;
+    sim.rx.size = sizeof(sim.rxBuf);
+    ns_ble_stream_t s = {.queue = queue, .queueSize = sizeof(queue), .maxInFlight = maxInFlight};
+    s.ops.send = sim_send;
+    s.ops.nowMs = sim_now;
+    s.ops.ctx = &sim;
+    if (ns_ble_stream_init(&s)) {
+        fprintf(stderr, "stream init failed\n");
+        return 1;
+    }
+    sim_connect(&sim, &s, mtu);
+
+    uint32_t nextFrame = 0;
+    for (int e = 0; e < SIM_EVENTS; e++) {
+        if (disconnect && (e == SIM_EVENTS / 2)) {
+            sim_disconnect(&sim, &s);
+        }
+        if (disconnect && (e == SIM_EVENTS / 2 + 10)) {
+            sim_connect(&sim, &s, mtu);
+        }
+        // Producer keeps the queue full (ns_ble_send_stream)
+        for (;;) {
+            make_frame(nextFrame, frame);
+            if (ns_ble_stream_push(&s, frame, frame_len(nextFrame)) != 0) {
+                break;
+            }
+            nextFrame++;
+            ns_ble_stream_pump(&s);
+        }
+        sim_run_wsf(&sim, &s);
+        sim_connection_event(&sim, &s);
+        sim_run_wsf(&sim, &s);
+    }
+
+    const uint32_t events = disconnect ? SIM_EVENTS - 10 : SIM_EVENTS;
+    const double seconds = events * CONN_INTERVAL_MS / 1000.0;
+    // Packet slots of the link carrying new data (retransmitted duplicates don't count)
+    const double efficiency =
+        (double)(sim.packetsSent - sim.rx.duplicates) / (events * PACKETS_PER_EVENT);
+    const double kbps = sim.rxBytes / seconds / 1000;
+    const double timer_kbps =
+        (mtu - NS_BLE_STREAM_ATT_OVERHEAD) / (CONN_INTERVAL_MS / 1000.0) / 1000;
+
+    printf(
+        "%4u\t%u\t%s\t%6.1f\t%6.1f\t%5.2f\t%u/%u/%u\t%u/%u/%u\t%u/%u\n", mtu,
+        maxInFlight, allocFailEvery ? "drop" : (disconnect ? "disc" : "-"), timer_kbps, kbps,
+        efficiency, s.notifications, s.rejected, s.retransmits, sim.rx.duplicates,
+        sim.rx.skipped, sim.gaps, ns_ble_stream_throughput(&s) / 1000, s.queueHighWater);
+
+    if (sim.rx.errors) {
+        sim_error(&sim, "malformed fragments at the central");
+    }
+    if (!disconnect && !(allocFailEvery && (maxInFlight > 1)) && sim.gaps) {
+        sim_error(&sim, "frames lost");
+    }
+    if (!allocFailEvery && (kbps < MIN_SPEEDUP * timer_kbps)) {
+        sim_error(&sim, "stream not much faster than a notification per interval");
+    }
+    // With more credits than Cordio has pending notification slots, some are spent on
+    // rejected notifications
+    if (!allocFailEvery && !disconnect && (maxInFlight == 1) && (efficiency < MIN_EFFICIENCY)) {
+        sim_error(&sim, "stream left too many packet slots of the link empty");
+    }
+    if (sim.rxFrames < 20) {
+        sim_error(&sim, "stream stalled");
+    }
+    return sim.errors;
+}
+
+// Fragment layout on a 23 byte MTU: 17 + 19 + 14 bytes of a 50 byte frame
+static uint8_t golden[4][NS_BLE_STREAM_MAX_MTU];
+static uint16_t goldenLen[4];
+static int goldenCount;
+
+static uint32_t golden_send(void *ctx, const uint8_t *data, uint16_t len) {
+    if (goldenCount < 4) {
+        memcpy(golden[goldenCount], data, len);
+        goldenLen[goldenCount] = len;
+    }
+    goldenCount++;
+    return 0;
+}
+
+static int golden_test(void) {
+    uint8_t frame[50];
+    for (int i = 0; i < 50; i++) {
+        frame[i] = i;
+    }
+    ns_ble_stream_t s = {.queue = queue, .queueSize = sizeof(queue), .maxInFlight = 4};
+    s.ops.send = golden_send;
+    ns_ble_stream_init(&s);
+    ns_ble_stream_set_enabled(&s, true);
+    ns_ble_stream_push(&s, frame, sizeof(frame));
+    ns_ble_stream_pump(&s);
+
+    int ok = (goldenCount == 3) && (goldenLen[0] == 20) && (goldenLen[1] == 20) &&
+             (goldenLen[2] == 15) && (golden[0][0] == 0x80) && (golden[0][1] == 50) &&
+             (golden[0][2] == 0) && (golden[0][3] == 0) && (golden[1][0] == 0x01) &&
+             (golden[1][1] == 17) && (golden[2][0] == 0x42) && (golden[2][1] == 36) &&
+             (golden[2][14] == 49);
+    // Nothing more goes out until the frame is confirmed
+    for (int i = 0; i < 3; i++) {
+        ns_ble_stream_on_sent(&s, true);
+    }
+    ok = ok && (s.framesSent == 1) && (ns_ble_stream_queue_depth(&s) == 0);
+    if (!ok) {
+        fprintf(stderr, "golden fragment layout mismatch\n");
+    }
+    return !ok;
+}
+
+// Confirmations of notifications sent before a timeout must not release the frame
+static int late_confirm_test(void) {
+    uint8_t frame[50] = {0};
+    ns_ble_stream_t s = {.queue = queue, .queueSize = sizeof(queue), .maxInFlight = 4};
+    s.ops.send = golden_send;
+    goldenCount = 0;
+    ns_ble_stream_init(&s);
+    ns_ble_stream_set_enabled(&s, true);
+    ns_ble_stream_push(&s, frame, sizeof(frame));
+    ns_ble_stream_pump(&s);
+
+    // Flow stays off past the timeout, then the three confirmations come in late
+    ns_ble_stream_on_timeout(&s);
+    ns_ble_stream_pump(&s);
+    int ok = (goldenCount == 3);
+    for (int i = 0; i < 3; i++) {
+        ns_ble_stream_on_sent(&s, true);
+        ns_ble_stream_pump(&s);
+    }
+    ok = ok && (goldenCount == 6) && (s.framesSent == 0) && (s.lateConfirms == 3);
+    for (int i = 0; i < 3; i++) {
+        ns_ble_stream_on_sent(&s, true);
+    }
+    ok = ok && (s.framesSent == 1);
+
+    // Notifications that are never confirmed are given up at the next timeout
+    ns_ble_stream_push(&s, frame, sizeof(frame));
+    ns_ble_stream_pump(&s);
+    ns_ble_stream_on_timeout(&s);
+    ns_ble_stream_pump(&s);
+    ok = ok && (goldenCount == 9);
+    ns_ble_stream_on_timeout(&s);
+    ns_ble_stream_pump(&s);
+    for (int i = 0; i < 3; i++) {
+        ns_ble_stream_on_sent(&s, true);
+    }
+    ok = ok && (goldenCount == 12) && (s.framesSent == 2) && (ns_ble_stream_queue_depth(&s) == 0);
+    if (!ok) {
+        fprintf(stderr, "late confirmations taken for resent fragments\n");
+    }
+    return !ok;
+}
+
+int main(void) {
+    int errors = golden_test();
+    errors += late_confirm_test();
+
+    printf("mtu\tcredits\tfault\ttimer\tstream\tslots\tntf/rej/retx\tdup/skip/lost\tkB/s/hiwat\n");
+    errors += run(23, 1, 0, false);
+    errors += run(247, 1, 0, false);
+    errors += run(247, 4, 0, false);
+    errors += run(247, 1, 97, false);
+    errors += run(247, 4, 97, false);
+    errors += run(247, 1, 0, true);
+    errors += run(185, 4, 0, true);
+    return errors ? 1 : 0;
+}
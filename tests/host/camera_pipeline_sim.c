@@ -0,0 +1,196 @@
+/**
+ * @file camera_pipeline_sim.c
+ * @author Ambiq
+ * @brief Host simulation of the double-buffered camera pipeline
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Drives ns_camera_pipeline with a fake camera on a simulated clock: a capture takes
+ * capture_us, reading the FIFO takes frame_bytes at the SPI rate, and the application
+ * spends infer_us on every frame. Completions are delivered the way the interrupts would
+ * deliver them on hardware, in between application steps.
+ *
+ * Checks that the state machine never hands out a buffer that is being written, that
+ * frames arrive in order (and without gaps unless dropStale is set), and that throughput
+ * is close to 1/max(capture + transfer, infer) rather than 1/(capture + transfer + infer).
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ns_camera_pipeline.h"
+
+#define FRAMES 200
+#define FRAME_BYTES 20000
+#define SPI_BYTES_PER_US 1.0 // 8MHz SPI
+#define MIN_EFFICIENCY 0.95  // fraction of the ideal frame rate the pipeline must reach
+
+typedef enum { EV_NONE, EV_CAPTURE_DONE, EV_READ_DONE } sim_event_e;
+
+typedef struct {
+    double now_us;
+    double capture_us;
+    double read_us;
+    sim_event_e event; // the camera does one thing at a time, so one pending event suffices
+    double event_us;
+    uint8_t *read_buf;
+    uint32_t frame_id; // id written into the next frame read out of the camera
+    int held;          // buffer index owned by the application, -1 if none
+    int errors;
+} sim_camera_t;
+
+static uint8_t buffers[NS_CAMERA_PIPELINE_BUFFERS][FRAME_BYTES + 1];
+
+static void sim_error(sim_camera_t *cam, const char *msg) {
+    if (cam->errors++ < 10) {
+        fprintf(stderr, "t=%.0fus: %s\n", cam->now_us, msg);
+    }
+}
+
+static uint32_t sim_start_capture(void *ctx) {
+    sim_camera_t *cam = ctx;
+    if (cam->event != EV_NONE) {
+        sim_error(cam, "capture triggered while camera busy");
+        return 1;
+    }
+    cam->event = EV_CAPTURE_DONE;
+    cam->event_us = cam->now_us + cam->capture_us;
+    return 0;
+}
+
+static uint32_t sim_start_read(void *ctx, uint8_t *buf, uint32_t bufLen) {
+    sim_camera_t *cam = ctx;
+    if (cam->event != EV_NONE) {
+        sim_error(cam, "read started while camera busy");
+        return 1;
+    }
+    if ((cam->held >= 0) && (buf == buffers[cam->held])) {
+        sim_error(cam, "read started into the buffer the application holds");
+    }
+    cam->read_buf = buf;
+    cam->event = EV_READ_DONE;
+    cam->event_us = cam->now_us + cam->read_us;
+    return 0;
+}
+
+// Deliver (as "interrupts") every completion up to time t
+static void sim_advance(sim_camera_t *cam, ns_camera_pipeline_t *p, double t) {
+    while ((cam->event != EV_NONE) && (cam->event_us <= t)) {
+        sim_event_e ev = cam->event;
+        cam->now_us = cam->event_us;
+        cam->event = EV_NONE;
+        if (ev == EV_CAPTURE_DONE) {
+            ns_camera_pipeline_on_captured(p);
+        } else {
+            // The DMA writes the frame: Arducam pad byte, then the frame id everywhere
+            cam->read_buf[0] = 0;
+            memset(cam->read_buf + 1, cam->frame_id & 0xFF, FRAME_BYTES);
+            cam->frame_id++;
+            ns_camera_pipeline_on_read_done(p, 1, FRAME_BYTES + 1);
+        }
+    }
+    if (t > cam->now_us) {
+        cam->now_us = t;
+    }
+}
+
+static int frame_intact(const ns_camera_frame_t *f) {
+    for (uint32_t i = f->offset; i < f->length; i++) {
+        if (f->buffer[i] != (f->sequence & 0xFF)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int run(double capture_us, double infer_us, bool dropStale) {
+    sim_camera_t cam = {.capture_us = capture_us, .read_us = FRAME_BYTES / SPI_BYTES_PER_US,
+                        .held = -1};
+    ns_camera_pipeline_t p = {.bufferSize = sizeof(buffers[0]), .dropStale = dropStale};
+    for (int i = 0; i < NS_CAMERA_PIPELINE_BUFFERS; i++) {
+        p.buffers[i] = buffers[i];
+    }
+    p.ops.startCapture = sim_start_capture;
+    p.ops.startRead = sim_start_read;
+    p.ops.ctx = &cam;
+
+    if (ns_camera_pipeline_init(&p) || ns_camera_pipeline_start(&p)) {
+        fprintf(stderr, "pipeline init failed\n");
+        return 1;
+    }
+
+    int64_t last_seq = -1;
+    uint32_t gaps = 0;
+    double first_us = 0;
+    for (int n = 0; n < FRAMES;) {
+        ns_camera_frame_t f;
+        if (!ns_camera_pipeline_get_frame(&p, &f)) {
+            if (cam.event == EV_NONE) {
+                sim_error(&cam, "pipeline stalled with nothing in flight");
+                break;
+            }
+            sim_advance(&cam, &p, cam.event_us); // sleep until the next interrupt
+            continue;
+        }
+        if (n == 0) {
+            first_us = cam.now_us;
+        }
+        if ((int64_t)f.sequence <= last_seq) {
+            sim_error(&cam, "frame out of order");
+        }
+        gaps += f.sequence - (uint32_t)(last_seq + 1);
+        last_seq = f.sequence;
+        if (!frame_intact(&f)) {
+            sim_error(&cam, "frame corrupt on delivery");
+        }
+        cam.held = f.index;
+        sim_advance(&cam, &p, cam.now_us + infer_us); // decode + inference
+        if (!frame_intact(&f)) {
+            sim_error(&cam, "frame overwritten while the application held it");
+        }
+        cam.held = -1;
+        ns_camera_pipeline_release_frame(&p, &f);
+        n++;
+    }
+
+    const double read_us = cam.read_us;
+    const double cam_us = capture_us + read_us;
+    const double ideal_us = (cam_us > infer_us) ? cam_us : infer_us;
+    const double seq_fps = 1e6 / (cam_us + infer_us);
+    const double ideal_fps = 1e6 / ideal_us;
+    const double fps = (FRAMES - 1) * 1e6 / (cam.now_us - infer_us - first_us);
+    const double efficiency = fps / ideal_fps;
+
+    printf(
+        "%5.0f\t%5.0f\t%5.0f\t%s\t%6.2f\t%6.2f\t%6.2f\t%u/%u/%u\n", capture_us / 1000,
+        read_us / 1000, infer_us / 1000, dropStale ? "drop" : "wait", seq_fps, fps, ideal_fps,
+        p.stalls, p.framesDropped, gaps);
+
+    if (!dropStale && gaps) {
+        sim_error(&cam, "frames lost without dropStale");
+    }
+    if (dropStale && (gaps != p.framesDropped)) {
+        sim_error(&cam, "missing frames don't match drop count");
+    }
+    if (!dropStale && (efficiency < MIN_EFFICIENCY)) {
+        sim_error(&cam, "pipelined frame rate too far below max(capture, infer)");
+    }
+    return cam.errors;
+}
+
+int main(void) {
+    int errors = 0;
+
+    printf("cap ms\tspi ms\tinf ms\tmode\tseq fps\tfps\tideal\tstalls/drops/gaps\n");
+    // infer bound, capture bound, balanced, and the dropStale variants
+    errors += run(30000, 80000, false);
+    errors += run(30000, 20000, false);
+    errors += run(30000, 50000, false);
+    errors += run(30000, 80000, true);
+    errors += run(30000, 20000, true);
+    return errors ? 1 : 0;
+}
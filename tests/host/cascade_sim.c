@@ -0,0 +1,404 @@
+/**
+ * @file cascade_sim.c
+ * @author Ambiq
+ * @brief Host checks of the ns_cascade scheduler, and a VAD -> speaker ID cascade on audio
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Checks, with scripted stages:
+ *   - gate hysteresis: onCount, offThreshold and hangover decide exactly which frames the next
+ *     stage runs on, and onDetect fires once per opening of the last gate
+ *   - stages read the pushed frame in place, or the history copy when there is one
+ *   - a waking stage gets the frames it missed (up to lookback) before the current one, and
+ *     never a frame twice
+ *   - power hooks: down after powerOffDelay idle frames, up before the next run; a failed
+ *     power-up or run keeps the downstream stages off
+ *   - configuration validation
+ * then runs the nnid demo's VAD (gate) and speaker ID networks as a cascade over 10s of
+ * synthetic audio with 2s of voiced speech, checking that speaker ID only runs around the
+ * speech, and compares the time spent against running both networks on every frame.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "def_nn1_nnvad.h"
+#include "def_nn4_nnid.h"
+#include "feature_module.h"
+#include "ns_cascade.h"
+#include "nnsp_cascade.h"
+#include "nnsp_identification.h"
+
+#define MAX_FRAMES 64
+#define SAMPLE_RATE 16000
+#define HOP 160
+#define AUDIO_FRAMES 1000 // 10s of 10ms hops
+
+static int errors;
+
+static void fail(const char *what, long got, long want) {
+    if (errors++ < 20) {
+        printf("FAIL %s: got %ld want %ld\n", what, got, want);
+    }
+}
+
+static ns_timer_config_t timer = {
+    .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+
+//
+// Scripted stages: frames are int32 frame numbers, scores come from a per-stage script
+//
+typedef struct {
+    const float *script;  ///< Score per frame number
+    int32_t seen[MAX_FRAMES * 2];
+    uint32_t numSeen;
+    const void *lastPtr;
+    int32_t failAt;       ///< Frame number whose run fails, -1 for none
+    uint32_t powerLog[8]; ///< (frame << 1) | on
+    uint32_t numPower;
+    bool failPowerUp;
+    int32_t *now;
+} scripted_t;
+
+static uint32_t scripted_run(void *ctx, const void *frame, float *score) {
+    scripted_t *s = (scripted_t *)ctx;
+    int32_t f = *(const int32_t *)frame;
+    s->seen[s->numSeen++] = f;
+    s->lastPtr = frame;
+    *score = s->script[f];
+    return (f == s->failAt) ? NS_STATUS_FAILURE : NS_STATUS_SUCCESS;
+}
+
+static uint32_t scripted_power(void *ctx, bool on) {
+    scripted_t *s = (scripted_t *)ctx;
+    if (on && s->failPowerUp) {
+        return NS_STATUS_FAILURE;
+    }
+    s->powerLog[s->numPower++] = ((uint32_t)*s->now << 1) | on;
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t detections[8];
+static uint32_t numDetections;
+static int32_t frameNow;
+
+static void on_detect(ns_cascade_t *c, float score) {
+    (void)score;
+    detections[numDetections++] = c->frames;
+}
+
+static void check_seen(const char *what, scripted_t *s, const int32_t *want, uint32_t n) {
+    if (s->numSeen != n) {
+        fail(what, s->numSeen, n);
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (s->seen[i] != want[i]) {
+            fail(what, s->seen[i], want[i]);
+        }
+    }
+}
+
+static uint32_t run_frames(ns_cascade_t *c, uint32_t n, uint32_t *depths) {
+    int32_t frames[MAX_FRAMES];
+    for (frameNow = 0; frameNow < (int32_t)n; frameNow++) {
+        frames[frameNow] = frameNow;
+        depths[frameNow] = ns_cascade_process(c, &frames[frameNow]);
+    }
+    return n;
+}
+
+static void check_gate(void) {
+    //                           0    1    2    3    4    5    6    7    8    9   10   11
+    static const float gate[] = {0.7, 0.2, 0.7, 0.7, 0.5, 0.3, 0.3, 0.3, 0.9, 0.9, 0.1, 0.1};
+    static const float high[MAX_FRAMES] = {[0 ... MAX_FRAMES - 1] = 1.0f};
+    scripted_t g = {.script = gate, .failAt = -1, .now = &frameNow};
+    scripted_t e = {.script = high, .failAt = -1, .now = &frameNow};
+    ns_cascade_stage_t stages[2] = {
+        {.name = "gate", .run = scripted_run, .ctx = &g, .onThreshold = 0.6f,
+         .offThreshold = 0.4f, .onCount = 2, .hangover = 2},
+        {.name = "expensive", .run = scripted_run, .ctx = &e, .onThreshold = 0.5f,
+         .offThreshold = 0.5f}};
+    ns_cascade_t c = {.api = &ns_cascade_V1_0_0, .stages = stages, .numStages = 2,
+                      .onDetect = on_detect};
+    uint32_t depths[12];
+
+    if (ns_cascade_init(&c) != NS_STATUS_SUCCESS) {
+        fail("init", 1, 0);
+        return;
+    }
+    numDetections = 0;
+    run_frames(&c, 12, depths);
+
+    // Opens on the second high frame in a row (3), holds through 4 (above off) and two
+    // hangover frames (5, 6), closes on 7; reopens at 9 and is still in its hangover at 11
+    static const int32_t wantGate[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    static const int32_t wantExpensive[] = {3, 4, 5, 6, 9, 10, 11};
+    static const uint32_t wantDepth[] = {0, 0, 0, 2, 2, 2, 2, 0, 0, 2, 2, 2};
+    check_seen("gate stage frames", &g, wantGate, 12);
+    check_seen("expensive stage frames", &e, wantExpensive, 7);
+    for (int f = 0; f < 12; f++) {
+        if (depths[f] != wantDepth[f]) {
+            fail("open depth", depths[f], wantDepth[f]);
+        }
+    }
+    // The last gate opened at frames 3 and 9 (c.frames counts them before the increment)
+    if ((numDetections != 2) || (detections[0] != 3) || (detections[1] != 9)) {
+        fail("detections", numDetections, 2);
+    }
+    if ((stages[0].stats.opens != 2) || (stages[0].stats.openFrames != 7) ||
+        (stages[1].stats.invokes != 7) || (stages[1].stats.replays != 0)) {
+        fail("gate counters", stages[1].stats.invokes, 7);
+    }
+    if (fabsf(ns_cascade_rate(&c, 1) - 7.0f / 12.0f) > 1e-6f) {
+        fail("rate x1000", (long)(1000 * ns_cascade_rate(&c, 1)), 583);
+    }
+    // No history: every stage reads the caller's frame in place
+    if (e.lastPtr != g.lastPtr) {
+        fail("shared input", 0, 1);
+    }
+
+    // Three stages: the third only runs while the second is open, and the second closes when
+    // its own run fails
+    static const float mid[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    scripted_t g2 = {.script = gate, .failAt = -1, .now = &frameNow};
+    scripted_t m = {.script = mid, .failAt = 5, .now = &frameNow};
+    scripted_t l = {.script = high, .failAt = -1, .now = &frameNow};
+    ns_cascade_stage_t three[3] = {
+        {.name = "gate", .run = scripted_run, .ctx = &g2, .onThreshold = 0.6f,
+         .offThreshold = 0.4f, .onCount = 2, .hangover = 2},
+        {.name = "mid", .run = scripted_run, .ctx = &m, .onThreshold = 0.5f,
+         .offThreshold = 0.5f},
+        {.name = "last", .run = scripted_run, .ctx = &l, .onThreshold = 0.5f,
+         .offThreshold = 0.5f}};
+    ns_cascade_t c3 = {.api = &ns_cascade_V1_0_0, .stages = three, .numStages = 3};
+    ns_cascade_init(&c3);
+    run_frames(&c3, 12, depths);
+    static const int32_t wantLast[] = {3, 4, 6, 9, 10, 11};
+    check_seen("third stage frames", &l, wantLast, 6);
+    if ((three[1].stats.errors != 1) || (depths[5] != 1)) {
+        fail("failed run closes its gate", depths[5], 1);
+    }
+}
+
+static void check_history_and_power(void) {
+    static const float gate[] = {0.9, 0.9, 0.0, 0.0, 0.0, 0.0, 0.9, 0.9, 0.9, 0.0, 0.9, 0.9};
+    static const float high[MAX_FRAMES] = {[0 ... MAX_FRAMES - 1] = 1.0f};
+    static int32_t history[8];
+    scripted_t g = {.script = gate, .failAt = -1, .now = &frameNow};
+    scripted_t e = {.script = high, .failAt = -1, .now = &frameNow};
+    ns_cascade_stage_t stages[2] = {
+        {.name = "gate", .run = scripted_run, .ctx = &g, .onThreshold = 0.5f,
+         .offThreshold = 0.5f},
+        {.name = "expensive", .run = scripted_run, .ctx = &e, .onThreshold = 0.5f,
+         .offThreshold = 0.5f, .lookback = 3, .powerOffDelay = 2, .power = scripted_power}};
+    ns_cascade_t c = {.api = &ns_cascade_V1_0_0, .stages = stages, .numStages = 2,
+                      .frameBytes = sizeof(int32_t), .history = (uint8_t *)history,
+                      .historyFrames = 8};
+    uint32_t depths[12];
+
+    if (ns_cascade_init(&c) != NS_STATUS_SUCCESS) {
+        fail("init with history", 1, 0);
+        return;
+    }
+    run_frames(&c, 12, depths);
+
+    // Frame 0 has no history yet. The stage idles over 2..5 and wakes at 6 with the last 3 of
+    // those replayed; it idles at 9 only, so waking at 10 replays just frame 9
+    static const int32_t want[] = {0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    check_seen("lookback replay", &e, want, 11);
+    if ((stages[1].stats.replays != 4) || (stages[1].stats.invokes != 11)) {
+        fail("replays", stages[1].stats.replays, 4);
+    }
+    // Stages read the history copy, not the caller's frame
+    if ((g.lastPtr != (void *)&history[11 % 8]) || (e.lastPtr != g.lastPtr)) {
+        fail("history slot", 0, 1);
+    }
+    // Idle from frame 2: down at 3 (second idle frame), up at 6; idle at 9 is too short
+    if ((e.numPower != 2) || (e.powerLog[0] != ((3u << 1) | 0)) ||
+        (e.powerLog[1] != ((6u << 1) | 1))) {
+        fail("power sequence", e.numPower, 2);
+    }
+    if ((stages[1].stats.powerUps != 1) || (stages[1].stats.poweredFrames != 9)) {
+        fail("powered frames", stages[1].stats.poweredFrames, 9);
+    }
+
+    // A stage that can't be powered up stays off, and is retried on every frame its gate opens
+    // for (6, 7, 8, 10, 11)
+    ns_cascade_init(&c);
+    e.numSeen = 0;
+    e.numPower = 0;
+    e.failPowerUp = true;
+    run_frames(&c, 12, depths);
+    if ((e.numSeen != 2) || (depths[7] != 1) || (stages[1].stats.errors != 5)) {
+        fail("failed power-up", e.numSeen, 2);
+    }
+}
+
+static void check_config(void) {
+    static const float none[1];
+    static uint8_t history[4 * 4];
+    scripted_t g = {.script = none, .failAt = -1, .now = &frameNow};
+    ns_cascade_stage_t s = {.run = scripted_run, .ctx = &g, .onThreshold = 0.4f,
+                            .offThreshold = 0.6f};
+    ns_cascade_t c = {.api = &ns_cascade_V1_0_0, .stages = &s, .numStages = 1};
+
+    if (ns_cascade_init(&c) != NS_STATUS_INVALID_CONFIG) {
+        fail("off above on accepted", 0, 1);
+    }
+    s.offThreshold = 0.4f;
+    s.lookback = 2;
+    if (ns_cascade_init(&c) != NS_STATUS_INVALID_CONFIG) {
+        fail("lookback without history accepted", 0, 1);
+    }
+    c.history = history;
+    c.frameBytes = 4;
+    c.historyFrames = 2;
+    if (ns_cascade_init(&c) != NS_STATUS_INVALID_CONFIG) {
+        fail("lookback filling the history accepted", 0, 1);
+    }
+    c.historyFrames = 4;
+    if ((ns_cascade_init(&c) != NS_STATUS_SUCCESS) || (s.onCount != 1)) {
+        fail("valid config", 1, 0);
+    }
+    c.api = &ns_timer_V1_0_0;
+    if (ns_cascade_init(&c) != NS_STATUS_INVALID_VERSION) {
+        fail("wrong api accepted", 0, 1);
+    }
+}
+
+//
+// VAD -> speaker ID on synthetic audio: a noise floor with two 1s voiced bursts
+//
+static int16_t audio[AUDIO_FRAMES * HOP];
+static uint8_t vadArenaMem[48 * 1024], nnidArenaMem[96 * 1024];
+static FeatureClass vadFeat, nnidFeat;
+static NNSPClass vad, nnid;
+static int16_t threshProb = 0x7fff >> 1, countTrigger = 1;
+static uint32_t bankSwitches;
+
+static int is_speech(int frame) {
+    return ((frame >= 200) && (frame < 300)) || ((frame >= 600) && (frame < 700));
+}
+
+static void synthesize(void) {
+    uint32_t seed = 1;
+    double phase = 0;
+    for (int i = 0; i < AUDIO_FRAMES * HOP; i++) {
+        double t = (double)i / SAMPLE_RATE;
+        double s = 0;
+        seed = seed * 1664525u + 1013904223u;
+        if (is_speech(i / HOP)) {
+            // Voiced: a wavering pitch through three formants, syllable-rate modulation
+            double f0 = 130 + 30 * sin(2 * M_PI * 3 * t);
+            phase += 2 * M_PI * f0 / SAMPLE_RATE;
+            for (int h = 1; h < 25; h++) {
+                double fh = h * f0;
+                double env = exp(-pow((fh - 500) / 300, 2)) +
+                             0.6 * exp(-pow((fh - 1500) / 400, 2)) +
+                             0.3 * exp(-pow((fh - 2500) / 500, 2));
+                s += env * sin(h * phase);
+            }
+            s *= 3000 * (0.6 + 0.4 * sin(2 * M_PI * 4 * t));
+        }
+        audio[i] = (int16_t)(s + ((int32_t)(seed >> 16) - 32768) / 512);
+    }
+}
+
+static void init_nnsp(void) {
+    ns_arena_t a;
+    ns_arena_init(&a, vadArenaMem, sizeof(vadArenaMem));
+    NNSPClass_init_arena(&vad, &net_nnvad, &vadFeat, vad_id, feature_mean_nnvad,
+                         feature_stdR_nnvad, &threshProb, &countTrigger, &params_nn1_nnvad, &a);
+    ns_arena_init(&a, nnidArenaMem, sizeof(nnidArenaMem));
+    NNSPClass_init_arena(&nnid, &net_nnid, &nnidFeat, nnid_id, feature_mean_nnid,
+                         feature_stdR_nnid, &threshProb, &countTrigger, &params_nn4_nnid, &a);
+    NNSPClass_reset(&vad);
+    NNSPClass_reset(&nnid);
+}
+
+static uint32_t bank_power(void *ctx, bool on) {
+    (void)ctx;
+    (void)on;
+    bankSwitches++;
+    return NS_STATUS_SUCCESS;
+}
+
+static void check_vad_nnid(void) {
+    static uint8_t history[8 * HOP * sizeof(int16_t)];
+    ns_cascade_stage_t stages[2] = {
+        {.onThreshold = 0.6f, .offThreshold = 0.4f, .onCount = 3, .hangover = 30,
+         .activeUw = 1000},
+        {.onThreshold = 0.8f, .offThreshold = 0.8f, .lookback = 6, .powerOffDelay = 50,
+         .activeUw = 1000}};
+    ns_cascade_t c = {.api = &ns_cascade_V1_0_0, .stages = stages, .numStages = 2,
+                      .frameBytes = HOP * sizeof(int16_t), .history = history,
+                      .historyFrames = 8, .timer = &timer};
+    uint32_t missed = 0, extra = 0;
+
+    // Nobody is enrolled, so speaker ID scores 0 and its own gate stays closed: what's under
+    // test is when it runs
+    synthesize();
+    init_nnsp();
+    NNSPClass_cascade_stage(&stages[0], &vad);
+    NNSPClass_cascade_stage(&stages[1], &nnid);
+    stages[0].name = "vad";
+    stages[1].name = "nnid";
+    stages[1].power = bank_power;
+    if (ns_cascade_init(&c) != NS_STATUS_SUCCESS) {
+        fail("vad cascade init", 1, 0);
+        return;
+    }
+    for (int f = 0; f < AUDIO_FRAMES; f++) {
+        uint32_t before = stages[1].stats.invokes;
+        ns_cascade_process(&c, &audio[f * HOP]);
+        bool ran = stages[1].stats.invokes != before;
+        // Speaker ID must cover the speech (after the VAD's onset delay) and stop within the
+        // hangover once it ends
+        if (!ran && is_speech(f) && is_speech(f - 10)) {
+            missed++;
+        }
+        if (ran && !is_speech(f) && !is_speech(f - 50)) {
+            extra++;
+        }
+    }
+    if ((missed != 0) || (extra != 0) || (stages[0].stats.opens != 2)) {
+        fail("speaker ID frames outside speech", extra, 0);
+        fail("speech frames without speaker ID", missed, 0);
+    }
+    if ((stages[0].stats.invokes != AUDIO_FRAMES) || (ns_cascade_rate(&c, 1) > 0.35f) ||
+        (stages[1].stats.powerUps != 2) || (bankSwitches != 5)) {
+        // The bank starts on: down in the first silence, then up and down once per burst
+        fail("nnid power cycles", bankSwitches, 5);
+    }
+    ns_cascade_print_stats(&c);
+
+    // Both networks on every frame, the way the hand-written flow gates only the
+    // post-processing
+    init_nnsp();
+    uint32_t t0 = ns_us_ticker_read(&timer);
+    for (int f = 0; f < AUDIO_FRAMES; f++) {
+        NNSPClass_exec(&vad, &audio[f * HOP]);
+        NNSPClass_exec(&nnid, &audio[f * HOP]);
+    }
+    uint32_t alwaysUs = ns_us_ticker_read(&timer) - t0;
+    uint64_t cascadeUs = stages[0].stats.total_us + stages[1].stats.total_us;
+    printf("VAD -> NNID over %ds: speaker ID on %.1f%% of frames, %.1f ms vs %.1f ms "
+           "running both on every frame (%.2fx)\n",
+           AUDIO_FRAMES * HOP / SAMPLE_RATE, 100.0f * ns_cascade_rate(&c, 1),
+           cascadeUs / 1000.0, alwaysUs / 1000.0, (double)alwaysUs / cascadeUs);
+}
+
+int main(void) {
+    ns_timer_init(&timer);
+    check_gate();
+    check_history_and_power();
+    check_config();
+    check_vad_nnid();
+    printf("cascade checks: %s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,899 @@
+/**
+ * @file dsp_bench.c
+ * @author Ambiq
+ * @brief Host accuracy check and benchmark of the neuralSPOT DSP and NN kernels
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Links libneuralspot_host.a and runs every hot kernel on a synthetic 16kHz recording (a
+ * chirp over noise): ns_mfcc_compute, the ns_melspec STFT and filterbank, the NNSP STFT
+ * analysis/synthesis (shifting and circular overlap-add variants), fc_8x16, lstm_8x16,
+ * log10_vec and an ns_ipc ring buffer. Float kernels are checked against double precision
+ * references, integer kernels against the CRCs in golden/dsp_bench.txt, and the cost per call
+ * is reported. The 4-bit and block-sparse layers (affine_packed.h) are checked bit-exact
+ * against fc_8x16/lstm_8x16 on the weights they decode to, with the weight bytes they read.
+ *
+ *   ./dsp_bench                 check and time
+ *   ./dsp_bench -g              rewrite the golden CRCs after an intended change
+ *   ./dsp_bench -o times.tsv    also save the timings
+ *   ./dsp_bench -b times.tsv    fail if a kernel is more than 25% (-t) slower than saved
+ *
+ * The CMSIS-DSP transforms come from the host shim (stubs/arm_math_host.c), so the FFT paths
+ * measure neuralSPOT's code around them rather than the device FFT.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "activation.h"
+#include "affine.h"
+#include "affine_packed.h"
+#include "crc32.h"
+#include "fixlog10.h"
+#include "lstm.h"
+#include "ns_arena.h"
+#include "ns_audio_melspec.h"
+#include "ns_audio_mfcc.h"
+#include "ns_ipc_ring_buffer.h"
+#include "spectrogram_module.h"
+
+#define SAMPLE_RATE 16000
+#define SAMPLES SAMPLE_RATE // one second
+#define REPEATS 5
+#define MAX_KERNELS 28
+#define GOLDEN_PATH "golden/dsp_bench.txt"
+
+// MFCC as the keyword spotting examples configure it
+#define MFCC_FRAME_LEN 480
+#define MFCC_FRAME_POW2 512
+#define MFCC_FBANKS 40
+#define MFCC_COEFFS 13
+#define MFCC_DEC_BITS 4
+#define MFCC_SHIFT 320
+#define MFCC_FRAMES ((SAMPLES - MFCC_FRAME_LEN) / MFCC_SHIFT + 1)
+
+#define MEL_FRAME_LEN 512
+#define MEL_FBANKS 40
+
+// NNSP speech enhancement front end and layer sizes
+#define STFT_WIN 480
+#define STFT_HOP 160
+#define STFT_FFT 512
+#define STFT_HOPS (SAMPLES / STFT_HOP)
+#define MIN_STFT_SNR_DB 60.0
+#define SE_START_BIN 1 // speech enhancement mask bins, as the NNSP SE models use them
+#define SE_BINS 256
+#define FC_IN 160
+#define FC_OUT 128
+#define LSTM_DIM 128
+#define LOG10_LEN 1024
+#define MAX_LOG10_ERR 1e-3
+
+#define RING_BYTES 4096
+#define RING_FRAMES 20000
+
+typedef struct {
+    const char *name;
+    double nsPerCall;
+    uint32_t calls; // per timed pass
+    uint32_t crc;
+    bool hasCrc;
+    char check[48];
+} kernel_result_t;
+
+static int16_t audio[SAMPLES];
+static kernel_result_t results[MAX_KERNELS];
+static int numResults;
+static int errors;
+
+static void sim_error(const char *msg, double v) {
+    if (errors++ < 10) {
+        fprintf(stderr, "%s: %g\n", msg, v);
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Portable generator, so the golden CRCs don't depend on the C library's rand()
+static uint32_t g_seed;
+static uint32_t lcg(void) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+static int32_t lcg_range(int32_t lo, int32_t hi) { return lo + (int32_t)(lcg() % (hi - lo + 1)); }
+
+static void synthesize(void) {
+    g_seed = 1;
+    for (int i = 0; i < SAMPLES; i++) {
+        double t = (double)i / SAMPLE_RATE;
+        double chirp = 8000 * sin(2 * M_PI * (100 * t + 3000 * t * t));
+        audio[i] = (int16_t)(chirp + lcg_range(-500, 500));
+    }
+}
+
+static kernel_result_t *add_result(const char *name, uint32_t calls) {
+    kernel_result_t *r = &results[numResults++];
+    memset(r, 0, sizeof(*r));
+    r->name = name;
+    r->calls = calls;
+    return r;
+}
+
+static void set_crc(kernel_result_t *r, const void *data, uint32_t bytes) {
+    r->crc = CalcCrc32(0xFFFFFFFF, bytes, (uint8_t *)data);
+    r->hasCrc = true;
+}
+
+// Best of REPEATS passes of run(), per call
+static double time_kernel(void (*run)(void), uint32_t calls) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        double t0 = now_ns();
+        run();
+        best = fmin(best, now_ns() - t0);
+    }
+    return best / calls;
+}
+
+// Direct DFT of a real sequence, the reference for the FFT based kernels
+static void ref_dft(const double *x, int n, int bins, double *re, double *im) {
+    for (int k = 0; k < bins; k++) {
+        double sr = 0, si = 0;
+        for (int i = 0; i < n; i++) {
+            double a = 2 * M_PI * (double)((int64_t)k * i % n) / n;
+            sr += x[i] * cos(a);
+            si -= x[i] * sin(a);
+        }
+        re[k] = sr;
+        im[k] = si;
+    }
+}
+
+static uint32_t bit_reverse(uint32_t i, uint32_t n) {
+    uint32_t r = 0;
+    for (uint32_t b = n >> 1; b; b >>= 1, i >>= 1) {
+        r = (r << 1) | (i & 1);
+    }
+    return r;
+}
+
+//
+// MFCC
+//
+static ns_mfcc_cfg_t mfcc;
+static uint8_t mfccArena[NS_MFCC_ARENA_SIZE(
+    MFCC_FRAME_LEN, MFCC_FRAME_POW2, MFCC_FBANKS, MFCC_COEFFS)];
+static float mfccOut[MFCC_FRAMES][MFCC_COEFFS];
+
+static void run_mfcc(void) {
+    for (int f = 0; f < MFCC_FRAMES; f++) {
+        ns_mfcc_compute(&mfcc, &audio[f * MFCC_SHIFT], mfccOut[f]);
+    }
+}
+
+static void bench_mfcc(void) {
+    kernel_result_t *r = add_result("mfcc", MFCC_FRAMES);
+    mfcc = (ns_mfcc_cfg_t){.api = &ns_mfcc_V1_0_0,
+                           .arena = mfccArena,
+                           .sample_frequency = SAMPLE_RATE,
+                           .num_fbank_bins = MFCC_FBANKS,
+                           .low_freq = 20,
+                           .high_freq = 4000,
+                           .num_frames = MFCC_FRAMES,
+                           .num_coeffs = MFCC_COEFFS,
+                           .num_dec_bits = MFCC_DEC_BITS,
+                           .frame_len = MFCC_FRAME_LEN,
+                           .frame_len_pow2 = MFCC_FRAME_POW2};
+    if (ns_mfcc_init(&mfcc) != NS_STATUS_SUCCESS) {
+        sim_error("ns_mfcc_init failed", 0);
+        return;
+    }
+    run_mfcc();
+
+    // Same steps in double precision, on the filterbank ns_mfcc_init built
+    double maxErr = 0;
+    for (int f = 0; f < MFCC_FRAMES; f++) {
+        double x[MFCC_FRAME_POW2] = {0}, re[MFCC_FRAME_POW2 / 2 + 1], im[MFCC_FRAME_POW2 / 2 + 1];
+        double energy[MFCC_FBANKS];
+        for (int i = 0; i < MFCC_FRAME_LEN; i++) {
+            double w = 0.5 - 0.5 * cos(2 * M_PI * i / MFCC_FRAME_LEN);
+            x[i] = audio[f * MFCC_SHIFT + i] / 32768.0 * w;
+        }
+        ref_dft(x, MFCC_FRAME_POW2, MFCC_FRAME_POW2 / 2 + 1, re, im);
+        for (int b = 0; b < MFCC_FBANKS; b++) {
+            energy[b] = 0;
+            for (int i = mfcc.fbc.mfccFbankFirst[b], j = 0; i <= mfcc.fbc.mfccFbankLast[b];
+                 i++, j++) {
+                energy[b] += sqrt(re[i] * re[i] + im[i] * im[i]) * (*mfcc.fbc.melFBank)[b][j];
+            }
+            energy[b] = log(energy[b]);
+        }
+        for (int k = 0; k < MFCC_COEFFS; k++) {
+            double sum = 0;
+            for (int b = 0; b < MFCC_FBANKS; b++) {
+                sum += sqrt(2.0 / MFCC_FBANKS) * cos(M_PI / MFCC_FBANKS * (b + 0.5) * k) *
+                       energy[b];
+            }
+            maxErr = fmax(maxErr, fabs(round(sum * (1 << MFCC_DEC_BITS)) - mfccOut[f][k]));
+        }
+    }
+    if (maxErr > 1) {
+        sim_error("mfcc coefficient error (LSB)", maxErr);
+    }
+    snprintf(r->check, sizeof(r->check), "max err %.0f LSB", maxErr);
+    r->nsPerCall = time_kernel(run_mfcc, r->calls);
+}
+
+//
+// Mel spectrogram
+//
+static ns_melspec_cfg_t melspec;
+static uint8_t melspecArena[NS_MELSPEC_ARENA_SIZE(MEL_FRAME_LEN, MEL_FBANKS)];
+#define MEL_FRAMES (SAMPLES / MEL_FRAME_LEN)
+static float melStft[2 * MEL_FRAME_LEN];
+static float melOut[MEL_FRAMES][MEL_FBANKS];
+
+static void run_melspec(void) {
+    for (int f = 0; f < MEL_FRAMES; f++) {
+        ns_melspec_audio_to_stft(&melspec, &audio[f * MEL_FRAME_LEN], melStft);
+        ns_melspec_stft_to_compressed_melspec(&melspec, melStft, melOut[f]);
+    }
+}
+
+static void bench_melspec(void) {
+    kernel_result_t *r = add_result("melspec", MEL_FRAMES);
+    melspec = (ns_melspec_cfg_t){.arena = melspecArena,
+                                 .sample_frequency = SAMPLE_RATE,
+                                 .num_fbank_bins = MEL_FBANKS,
+                                 .low_freq = 20,
+                                 .high_freq = 8000,
+                                 .num_frames = MEL_FRAMES,
+                                 .frame_len = MEL_FRAME_LEN,
+                                 .frame_len_pow2 = MEL_FRAME_LEN,
+                                 .compression_exponent = 1.0f};
+    if (ns_melspec_init(&melspec) != NS_STATUS_SUCCESS) {
+        sim_error("ns_melspec_init failed", 0);
+        return;
+    }
+    run_melspec();
+
+    // ns_melspec runs the CFFT without bit reversal and weights the real parts in that order
+    double maxErr = 0;
+    for (int f = 0; f < MEL_FRAMES; f++) {
+        double x[MEL_FRAME_LEN], re[MEL_FRAME_LEN], im[MEL_FRAME_LEN];
+        for (int i = 0; i < MEL_FRAME_LEN; i++) {
+            x[i] = audio[f * MEL_FRAME_LEN + i];
+        }
+        ref_dft(x, MEL_FRAME_LEN, MEL_FRAME_LEN, re, im);
+        for (int b = 0; b < MEL_FBANKS; b++) {
+            double sum = 0, mag = 1;
+            for (int j = melspec.fbc.mfccFbankFirst[b], k = 0; j < melspec.fbc.mfccFbankLast[b];
+                 j++, k++) {
+                double term = re[bit_reverse(j, MEL_FRAME_LEN)] * (*melspec.fbc.melFBank)[b][k];
+                sum += term;
+                mag += fabs(term);
+            }
+            maxErr = fmax(maxErr, fabs(sum - melOut[f][b]) / mag);
+        }
+    }
+    if (maxErr > 1e-5) {
+        sim_error("melspec relative error", maxErr);
+    }
+    snprintf(r->check, sizeof(r->check), "max rel err %.1e", maxErr);
+    r->nsPerCall = time_kernel(run_melspec, r->calls);
+}
+
+//
+// NNSP STFT analysis and overlap-add synthesis
+//
+extern const int16_t stft_win_coeff_w480_h160[];
+static stftModule stft;
+static int32_t stftSpec[STFT_HOPS][2 * STFT_FFT + 2];
+static int16_t stftOut[SAMPLES];
+
+static void run_stft_analyze(void) {
+    int16_t qbit;
+    stftModule_setDefault(&stft);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        stftModule_analyze_arm(&stft, &audio[h * STFT_HOP], stftSpec[h], STFT_FFT, &qbit);
+    }
+}
+
+static void run_stft_synthesize(void) {
+    static int32_t spec[2 * STFT_FFT + 2]; // synthesis may overwrite its input
+    stftModule_setDefault(&stft);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        memcpy(spec, stftSpec[h], sizeof(spec));
+        stftModule_synthesize_arm(&stft, spec, &stftOut[h * STFT_HOP]);
+    }
+}
+
+static void bench_stft(void) {
+    kernel_result_t *ra = add_result("stft_analyze", STFT_HOPS);
+    kernel_result_t *rs = add_result("stft_synthesize", STFT_HOPS);
+    stftModule_construct(&stft, STFT_WIN, STFT_HOP, STFT_FFT, stft_win_coeff_w480_h160);
+    run_stft_analyze();
+    run_stft_synthesize();
+
+    // Analysis: the windowed Q30 frame's DFT / N, bins 0..N/2
+    double maxErr = 0;
+    for (int h = 0; h < STFT_HOPS; h++) {
+        double x[STFT_FFT] = {0}, re[STFT_FFT / 2 + 1], im[STFT_FFT / 2 + 1];
+        for (int i = 0; i < STFT_WIN; i++) {
+            int s = h * STFT_HOP + STFT_HOP - STFT_WIN + i;
+            x[i] = (double)stft_win_coeff_w480_h160[i] * (s >= 0 ? audio[s] : 0);
+        }
+        ref_dft(x, STFT_FFT, STFT_FFT / 2 + 1, re, im);
+        for (int k = 0; k <= STFT_FFT / 2; k++) {
+            maxErr = fmax(maxErr, fabs(re[k] / STFT_FFT - stftSpec[h][2 * k]));
+            maxErr = fmax(maxErr, fabs(im[k] / STFT_FFT - stftSpec[h][2 * k + 1]));
+        }
+    }
+    if (maxErr > 1) {
+        sim_error("stft analysis error (LSB)", maxErr);
+    }
+    snprintf(ra->check, sizeof(ra->check), "max err %.2f LSB", maxErr);
+
+    // Synthesis: the squared window overlaps to one, the output is the input delayed
+    double best = -1e30;
+    for (int lag = 0; lag <= STFT_WIN; lag++) {
+        double sig = 0, noise = 0;
+        for (int i = STFT_WIN + lag; i < SAMPLES; i++) {
+            double d = stftOut[i] - audio[i - lag];
+            sig += (double)audio[i - lag] * audio[i - lag];
+            noise += d * d;
+        }
+        best = fmax(best, 10 * log10(sig / fmax(noise, 1e-9)));
+    }
+    if (best < MIN_STFT_SNR_DB) {
+        sim_error("stft round trip SNR (dB)", best);
+    }
+    snprintf(rs->check, sizeof(rs->check), "round trip %.1f dB", best);
+    ra->nsPerCall = time_kernel(run_stft_analyze, ra->calls);
+    rs->nsPerCall = time_kernel(run_stft_synthesize, rs->calls);
+}
+
+// The same transforms with circular buffers, which have to match the shifting ones bit for bit
+static stftModule stftOla;
+static uint8_t stftOlaArena[16 * 1024];
+static int16_t stftOutOla[SAMPLES];
+static int16_t seMask[STFT_FFT / 2 + 1];
+static int16_t seOut[SAMPLES], seRef[SAMPLES];
+
+static void run_stft_analyze_ola(void) {
+    static int32_t spec[2 * STFT_FFT + 2];
+    int16_t qbit;
+    stftModule_setDefault(&stftOla);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        stftModule_analyze_ola(&stftOla, &audio[h * STFT_HOP], spec, STFT_FFT, &qbit);
+    }
+}
+
+static void run_stft_synthesize_ola(void) {
+    static int32_t spec[2 * STFT_FFT + 2];
+    stftModule_setDefault(&stftOla);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        memcpy(spec, stftSpec[h], sizeof(spec));
+        stftModule_synthesize_ola(&stftOla, spec, &stftOutOla[h * STFT_HOP]);
+    }
+}
+
+// Speech enhancement output stage: mask, inverse STFT and overlap-add
+static void run_stft_se_ola(void) {
+    static int32_t spec[2 * STFT_FFT + 2];
+    stftModule_setDefault(&stftOla);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        memcpy(spec, stftSpec[h], sizeof(spec));
+        stftModule_synthesize_masked_ola(
+            &stftOla, spec, seMask, SE_START_BIN, SE_BINS, &seOut[h * STFT_HOP]);
+    }
+}
+
+// The shifting path as se_post_proc ran it before the overlap-add engine
+static void run_stft_se(void) {
+    static int32_t spec[2 * STFT_FFT + 2];
+    stftModule_setDefault(&stft);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        memcpy(spec, stftSpec[h], sizeof(spec));
+        for (int k = 0; k <= STFT_FFT / 2; k++) {
+            int16_t m = (k >= SE_START_BIN && k < SE_START_BIN + SE_BINS) ? seMask[k] : 0;
+            spec[2 * k] = (int32_t)(((int64_t)m * spec[2 * k]) >> 15);
+            spec[2 * k + 1] = (int32_t)(((int64_t)m * spec[2 * k + 1]) >> 15);
+        }
+        stftModule_synthesize_arm(&stft, spec, &seRef[h * STFT_HOP]);
+    }
+}
+
+static void bench_stft_ola(void) {
+    kernel_result_t *ra = add_result("stft_analyze_ola", STFT_HOPS);
+    kernel_result_t *rs = add_result("stft_synthesize_ola", STFT_HOPS);
+    kernel_result_t *rse = add_result("stft_se_ola", STFT_HOPS);
+    ns_arena_t arena;
+
+    // Its own buffers: stftModule_construct would share the static ones with bench_stft's
+    ns_arena_init(&arena, stftOlaArena, sizeof(stftOlaArena));
+    ns_arena_begin(&arena, "stft_ola");
+    if (stftModule_construct_arena(
+            &stftOla, STFT_WIN, STFT_HOP, STFT_FFT, stft_win_coeff_w480_h160, &arena) ||
+        ns_arena_end(&arena)) {
+        sim_error("stft_ola arena bytes needed", ns_arena_required(&arena));
+        return;
+    }
+    g_seed = 3;
+    for (int k = 0; k <= STFT_FFT / 2; k++) {
+        seMask[k] = (int16_t)lcg_range(0, 32767);
+    }
+
+    // Analysis, hop by hop against the spectra bench_stft kept
+    static int32_t spec[2 * STFT_FFT + 2];
+    int16_t qbit;
+    int mismatched = 0;
+    stftModule_setDefault(&stftOla);
+    for (int h = 0; h < STFT_HOPS; h++) {
+        stftModule_analyze_ola(&stftOla, &audio[h * STFT_HOP], spec, STFT_FFT, &qbit);
+        mismatched += memcmp(spec, stftSpec[h], sizeof(spec)) != 0;
+    }
+    run_stft_synthesize_ola();
+    bool synthesizeExact = !memcmp(stftOutOla, stftOut, sizeof(stftOut));
+    run_stft_se_ola();
+    run_stft_se();
+    bool seExact = !memcmp(seOut, seRef, sizeof(seOut));
+    if (mismatched) {
+        sim_error("stft_analyze_ola hops differing from stft_analyze", mismatched);
+    }
+    if (!synthesizeExact) {
+        sim_error("stft_synthesize_ola differs from stft_synthesize", 1);
+    }
+    if (!seExact) {
+        sim_error("stft_se_ola differs from mask + stft_synthesize", 1);
+    }
+
+    ra->nsPerCall = time_kernel(run_stft_analyze_ola, ra->calls);
+    rs->nsPerCall = time_kernel(run_stft_synthesize_ola, rs->calls);
+    rse->nsPerCall = time_kernel(run_stft_se_ola, rse->calls);
+    snprintf(ra->check, sizeof(ra->check), "%s stft_analyze",
+             mismatched ? "differs from" : "bit-exact with");
+    snprintf(rs->check, sizeof(rs->check), "%s stft_synthesize",
+             synthesizeExact ? "bit-exact with" : "differs from");
+    snprintf(rse->check, sizeof(rse->check), "%s mask + stft_synthesize",
+             seExact ? "bit-exact with" : "differs from");
+}
+
+//
+// NNSP layers
+//
+static int8_t fcKernel[FC_OUT * FC_IN];
+static int16_t fcBias[FC_OUT], fcIn[FC_IN], fcOut[FC_OUT];
+static int8_t lstmKernel[4 * LSTM_DIM * FC_OUT], lstmKernelRec[4 * LSTM_DIM * LSTM_DIM];
+static int16_t lstmBias[4 * LSTM_DIM], lstmH[LSTM_DIM], lstmOut[LSTM_DIM];
+static int32_t lstmC[LSTM_DIM];
+#define LAYER_CALLS 1000
+
+static void fill8(int8_t *p, int n, int lim) {
+    for (int i = 0; i < n; i++) {
+        p[i] = (int8_t)lcg_range(-lim, lim);
+    }
+}
+
+static void fill16(int16_t *p, int n, int lim) {
+    for (int i = 0; i < n; i++) {
+        p[i] = (int16_t)lcg_range(-lim, lim);
+    }
+}
+
+// Q7 weights, Q12 inputs (as the NNSP models quantize them)
+static void run_fc(void) {
+    for (int i = 0; i < LAYER_CALLS; i++) {
+        fc_8x16(
+            fcOut, fcKernel, NULL, fcBias, fcIn, NULL, NULL, FC_OUT, FC_IN, 0, 7, 15, 12, 12,
+            relu6, (void *(*)(void *, int32_t *, int))relu6_fix);
+    }
+}
+
+// One timestep per call, the state carried through
+static void run_lstm(void) {
+    memset(lstmH, 0, sizeof(lstmH));
+    memset(lstmC, 0, sizeof(lstmC));
+    for (int i = 0; i < LAYER_CALLS; i++) {
+        lstm_8x16(
+            lstmOut, lstmKernel, lstmKernelRec, lstmBias, fcOut, lstmH, lstmC, LSTM_DIM, FC_OUT,
+            LSTM_DIM, 7, 15, 12, 15, ftanh, (void *(*)(void *, int32_t *, int))tanh_fix);
+        memcpy(lstmH, lstmOut, sizeof(lstmH));
+    }
+}
+
+static void bench_layers(void) {
+    kernel_result_t *rf = add_result("fc_8x16", LAYER_CALLS);
+    kernel_result_t *rl = add_result("lstm_8x16", LAYER_CALLS);
+    g_seed = 2;
+    fill8(fcKernel, sizeof(fcKernel), 24);
+    fill16(fcBias, FC_OUT, 2000);
+    fill16(fcIn, FC_IN, 4096);
+    fill8(lstmKernel, sizeof(lstmKernel), 24);
+    fill8(lstmKernelRec, sizeof(lstmKernelRec), 24);
+    fill16(lstmBias, 4 * LSTM_DIM, 2000);
+
+    run_fc();
+    set_crc(rf, fcOut, sizeof(fcOut));
+    int active = 0;
+    for (int i = 0; i < FC_OUT; i++) {
+        active += (fcOut[i] > 0) && (fcOut[i] < 6 << 12); // not clipped by relu6
+    }
+    snprintf(rf->check, sizeof(rf->check), "%d/%d in range", active, FC_OUT);
+
+    run_lstm();
+    uint8_t state[sizeof(lstmOut) + sizeof(lstmC)];
+    memcpy(state, lstmOut, sizeof(lstmOut));
+    memcpy(state + sizeof(lstmOut), lstmC, sizeof(lstmC));
+    set_crc(rl, state, sizeof(state));
+    snprintf(rl->check, sizeof(rl->check), "h and c after %d steps", LAYER_CALLS);
+
+    rf->nsPerCall = time_kernel(run_fc, rf->calls);
+    rl->nsPerCall = time_kernel(run_lstm, rl->calls);
+}
+
+//
+// Compressed NNSP layers (affine_packed.h): random 4-bit and block-sparse tables, checked
+// bit-exact against fc_8x16/lstm_8x16 on the int8 weights they decode to
+//
+typedef int (*layer_fn)(
+    int16_t *, int8_t *, int8_t *, int16_t *, int16_t *, int16_t *, int32_t *, int16_t, int16_t,
+    int16_t, int16_t, int16_t, int16_t, int16_t, ACTIVATION_TYPE,
+    void *(*)(void *, int32_t *, int));
+typedef uint32_t (*make_table_fn)(uint8_t *dst, int8_t *rows, int nrows, int n);
+
+#define PACKED_ROW_MAX(n) (AFFINE_SPARSE_MASK_BYTES(n) + (n)) // sparse with every block kept
+static int8_t denseRows[4 * LSTM_DIM * FC_IN];
+static int8_t refKernel[4 * LSTM_DIM * FC_IN], refKernelRec[4 * LSTM_DIM * LSTM_DIM];
+static uint8_t packedKernel[4 * LSTM_DIM * PACKED_ROW_MAX(FC_IN)];
+static uint8_t packedKernelRec[4 * LSTM_DIM * PACKED_ROW_MAX(LSTM_DIM)];
+static int16_t refOut[LSTM_DIM];
+static int32_t refC[LSTM_DIM];
+static layer_fn packedFc, packedLstm;
+
+// Random q in [-8, 7] with scales in [1, 15], so every s * q fits the int8 reference
+static uint32_t make_4x16(uint8_t *dst, int8_t *rows, int nrows, int n) {
+    uint8_t *p = dst;
+    for (int r = 0; r < nrows; r++, rows += n, p += AFFINE_4X16_ROW_BYTES(n)) {
+        int s = lcg_range(1, 15);
+        memset(p, 0, AFFINE_4X16_ROW_BYTES(n));
+        p[0] = (uint8_t)s;
+        for (int k = 0; k < n; k++) {
+            int q = lcg_range(-8, 7);
+            rows[k] = (int8_t)(s * q);
+            int base = k & ~15, h = (n - base >= 16) ? 8 : (n - base + 1) >> 1;
+            int j = k - base;
+            p[1 + base / 2 + ((j < h) ? j : j - h)] |= (uint8_t)((q & 15) << ((j < h) ? 0 : 4));
+        }
+    }
+    return (uint32_t)(p - dst);
+}
+
+// Random int8 rows with about half of their 8-wide blocks zero
+static uint32_t make_sparse(uint8_t *dst, int8_t *rows, int nrows, int n) {
+    uint8_t *p = dst;
+    for (int r = 0; r < nrows; r++, rows += n) {
+        uint8_t *mask = p;
+        memset(mask, 0, AFFINE_SPARSE_MASK_BYTES(n));
+        p += AFFINE_SPARSE_MASK_BYTES(n);
+        for (int b = 0; 8 * b < n; b++) {
+            int w = (n - 8 * b < 8) ? n - 8 * b : 8;
+            bool keep = lcg() & 1;
+            for (int j = 0; j < w; j++) {
+                rows[8 * b + j] = keep ? (int8_t)lcg_range(-24, 24) : 0;
+            }
+            if (keep) {
+                mask[b >> 3] |= (uint8_t)(1 << (b & 7));
+                memcpy(p, &rows[8 * b], w);
+                p += w;
+            }
+        }
+    }
+    return (uint32_t)(p - dst);
+}
+
+// The ARM_OPTIMIZED == 1 int8 layout the host library is built with: per group of up to 4
+// rows (per gate for an LSTM), input pairs interleaved for __SMLALD as affine.c reads them
+static void to_m4_layout(int8_t *dst, const int8_t *rows, int units, int gates, int n) {
+    for (int u = 0; u < units; u += 4) {
+        int sub = (units - u < 4) ? units - u : 4;
+        for (int g = 0; g < gates; g++, rows += sub * n) {
+            for (int i = 0; i + 1 < n; i += 2) {
+                for (int r = 0; r < sub; r += 2) {
+                    *dst++ = rows[r * n + i];
+                    if (r + 1 < sub) {
+                        *dst++ = rows[(r + 1) * n + i];
+                    }
+                    *dst++ = rows[r * n + i + 1];
+                    if (r + 1 < sub) {
+                        *dst++ = rows[(r + 1) * n + i + 1];
+                    }
+                }
+            }
+            for (int r = 0; (n & 1) && (r < sub); r++) {
+                *dst++ = rows[r * n + n - 1];
+            }
+        }
+    }
+}
+
+static void fc_run(layer_fn fc, void *kernel, int out, int in) {
+    fc(fcOut, (int8_t *)kernel, NULL, fcBias, fcIn, NULL, NULL, out, in, 0, 7, 15, 12, 12, relu6,
+       (void *(*)(void *, int32_t *, int))relu6_fix);
+}
+
+static void lstm_run(layer_fn lstm, void *kernel, void *kernelRec, int units, int in, int steps) {
+    memset(lstmH, 0, sizeof(lstmH));
+    memset(lstmC, 0, sizeof(lstmC));
+    for (int i = 0; i < steps; i++) {
+        lstm(lstmOut, (int8_t *)kernel, (int8_t *)kernelRec, lstmBias, fcIn, lstmH, lstmC, units,
+             in, units, 7, 15, 12, 15, ftanh, (void *(*)(void *, int32_t *, int))tanh_fix);
+        memcpy(lstmH, lstmOut, units * sizeof(int16_t));
+    }
+}
+
+static bool packed_fc_matches(layer_fn fc, make_table_fn make, int out, int in, uint32_t *bytes) {
+    *bytes = make(packedKernel, denseRows, out, in);
+    to_m4_layout(refKernel, denseRows, out, 1, in);
+    fc_run(fc_8x16, refKernel, out, in);
+    memcpy(refOut, fcOut, out * sizeof(int16_t));
+    fc_run(fc, packedKernel, out, in);
+    return !memcmp(refOut, fcOut, out * sizeof(int16_t));
+}
+
+static bool packed_lstm_matches(
+    layer_fn lstm, make_table_fn make, int units, int in, int steps, uint32_t *bytes) {
+    *bytes = make(packedKernel, denseRows, 4 * units, in);
+    to_m4_layout(refKernel, denseRows, units, 4, in);
+    *bytes += make(packedKernelRec, denseRows, 4 * units, units);
+    to_m4_layout(refKernelRec, denseRows, units, 4, units);
+    lstm_run(lstm_8x16, refKernel, refKernelRec, units, in, steps);
+    memcpy(refOut, lstmOut, units * sizeof(int16_t));
+    memcpy(refC, lstmC, units * sizeof(int32_t));
+    lstm_run(lstm, packedKernel, packedKernelRec, units, in, steps);
+    return !memcmp(refOut, lstmOut, units * sizeof(int16_t)) &&
+           !memcmp(refC, lstmC, units * sizeof(int32_t));
+}
+
+static void run_fc_packed(void) {
+    for (int i = 0; i < LAYER_CALLS; i++) {
+        fc_run(packedFc, packedKernel, FC_OUT, FC_IN);
+    }
+}
+
+static void run_lstm_packed(void) {
+    lstm_run(packedLstm, packedKernel, packedKernelRec, LSTM_DIM, FC_OUT, LAYER_CALLS);
+}
+
+static void bench_packed(
+    const char *fcName, const char *lstmName, layer_fn fc, layer_fn lstm, make_table_fn make) {
+    kernel_result_t *rf = add_result(fcName, LAYER_CALLS);
+    kernel_result_t *rl = add_result(lstmName, LAYER_CALLS);
+    uint32_t bytes = 0, tailBytes;
+    bool exact;
+
+    g_seed = 3;
+    packedFc = fc;
+    packedLstm = lstm;
+    // Odd shapes first: partial row groups, nibble groups and sparse blocks
+    exact = packed_fc_matches(fc, make, 7, 37, &tailBytes) &&
+            packed_fc_matches(fc, make, FC_OUT, FC_IN, &bytes);
+    if (!exact) {
+        sim_error("compressed fc differs from fc_8x16", 0);
+    }
+    snprintf(rf->check, sizeof(rf->check), "%s, %u/%u weight bytes",
+             exact ? "bit-exact" : "MISMATCH", bytes, FC_OUT * FC_IN);
+    rf->nsPerCall = time_kernel(run_fc_packed, rf->calls);
+
+    exact = packed_lstm_matches(lstm, make, 6, 21, 20, &tailBytes) &&
+            packed_lstm_matches(lstm, make, LSTM_DIM, FC_OUT, LAYER_CALLS, &bytes);
+    if (!exact) {
+        sim_error("compressed lstm differs from lstm_8x16", 0);
+    }
+    snprintf(rl->check, sizeof(rl->check), "%s, %u/%u weight bytes",
+             exact ? "bit-exact" : "MISMATCH", bytes, 4 * LSTM_DIM * (FC_OUT + LSTM_DIM));
+    rl->nsPerCall = time_kernel(run_lstm_packed, rl->calls);
+}
+
+//
+// log10
+//
+static int32_t logIn[LOG10_LEN], logOut[LOG10_LEN];
+
+static void run_log10(void) {
+    for (int i = 0; i < 100; i++) {
+        log10_vec(logOut, logIn, LOG10_LEN, 15);
+    }
+}
+
+static void bench_log10(void) {
+    kernel_result_t *r = add_result("log10_vec", 100 * LOG10_LEN); // per element
+    for (int i = 0; i < LOG10_LEN; i++) {
+        logIn[i] = (int32_t)fmin(exp2(31.0 * (i + 1) / LOG10_LEN), INT32_MAX); // log spaced
+    }
+    run_log10();
+    double maxErr = 0;
+    for (int i = 0; i < LOG10_LEN; i++) {
+        maxErr = fmax(maxErr, fabs(logOut[i] / 32768.0 - log10(logIn[i] / 32768.0)));
+    }
+    if (maxErr > MAX_LOG10_ERR) {
+        sim_error("log10_vec error", maxErr);
+    }
+    set_crc(r, logOut, sizeof(logOut));
+    snprintf(r->check, sizeof(r->check), "max err %.1e", maxErr);
+    r->nsPerCall = time_kernel(run_log10, r->calls);
+}
+
+//
+// Ring buffer, audio frames through an ns_ipc ring as the audio pipeline moves them
+//
+static ns_ipc_ring_buffer_t ring;
+static uint8_t ringStorage[RING_BYTES];
+static int16_t ringOut[STFT_HOP];
+static uint32_t crcIn, crcOut;
+
+static void run_ring(void) {
+    ns_ipc_ring_buffer_init(&ring, (ns_ipc_ringbuff_setup_t){0, ringStorage, RING_BYTES});
+    crcIn = crcOut = 0xFFFFFFFF;
+    for (int i = 0; i < RING_FRAMES; i++) {
+        int16_t *frame = &audio[(i * STFT_HOP) % (SAMPLES - STFT_HOP)];
+        ns_ipc_ring_buffer_push(&ring, frame, sizeof(ringOut), true);
+        crcIn = CalcCrc32(crcIn, sizeof(ringOut), (uint8_t *)frame);
+        if (i & 1) { // the consumer lags a frame behind
+            for (int k = 0; k < 2; k++) {
+                ns_ipc_ring_buffer_pop(&ring, ringOut, sizeof(ringOut));
+                crcOut = CalcCrc32(crcOut, sizeof(ringOut), (uint8_t *)ringOut);
+            }
+        }
+    }
+}
+
+static void bench_ring(void) {
+    kernel_result_t *r = add_result("ring_buffer", 2 * RING_FRAMES);
+    run_ring();
+    if (crcIn != crcOut) {
+        sim_error("ring buffer stream corrupted", 0);
+    }
+    snprintf(r->check, sizeof(r->check), "%s", crcIn == crcOut ? "stream intact" : "CORRUPT");
+    r->nsPerCall = time_kernel(run_ring, r->calls); // push or pop, CRC of the frame included
+}
+
+//
+// Goldens and baselines
+//
+static void check_golden(const char *path, bool regenerate) {
+    FILE *f;
+    if (regenerate) {
+        if ((f = fopen(path, "w")) == NULL) {
+            sim_error("can't write golden file", 0);
+            return;
+        }
+        fprintf(f, "# kernel\tCRC-32 of its output, regenerate with ./dsp_bench -g\n");
+        for (int i = 0; i < numResults; i++) {
+            if (results[i].hasCrc) {
+                fprintf(f, "%s\t%08x\n", results[i].name, (unsigned)results[i].crc);
+            }
+        }
+        fclose(f);
+        return;
+    }
+    if ((f = fopen(path, "r")) == NULL) {
+        sim_error("can't read golden file", 0);
+        return;
+    }
+    char line[128], name[64];
+    unsigned crc;
+    while (fgets(line, sizeof(line), f)) {
+        if ((line[0] == '#') || (sscanf(line, "%63s %x", name, &crc) != 2)) {
+            continue;
+        }
+        for (int i = 0; i < numResults; i++) {
+            if (results[i].hasCrc && !strcmp(results[i].name, name) && (results[i].crc != crc)) {
+                fprintf(stderr, "%s: output CRC %08x, golden %08x\n", name, results[i].crc, crc);
+                errors++;
+            }
+        }
+    }
+    fclose(f);
+}
+
+static void save_times(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        sim_error("can't write timings", 0);
+        return;
+    }
+    for (int i = 0; i < numResults; i++) {
+        fprintf(f, "%s\t%.1f\n", results[i].name, results[i].nsPerCall);
+    }
+    fclose(f);
+}
+
+static void check_baseline(const char *path, double tolerance) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        sim_error("can't read baseline", 0);
+        return;
+    }
+    char name[64];
+    double ns;
+    while (fscanf(f, "%63s %lf", name, &ns) == 2) {
+        for (int i = 0; i < numResults; i++) {
+            if (!strcmp(results[i].name, name) && (results[i].nsPerCall > ns * (1 + tolerance))) {
+                fprintf(
+                    stderr, "%s: %.1f ns/call, baseline %.1f\n", name, results[i].nsPerCall, ns);
+                errors++;
+            }
+        }
+    }
+    fclose(f);
+}
+
+int main(int argc, char **argv) {
+    const char *savePath = NULL, *baselinePath = NULL, *goldenPath = GOLDEN_PATH;
+    double tolerance = 0.25;
+    bool regenerate = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "go:b:t:f:")) != -1) {
+        switch (opt) {
+        case 'g':
+            regenerate = true;
+            break;
+        case 'o':
+            savePath = optarg;
+            break;
+        case 'b':
+            baselinePath = optarg;
+            break;
+        case 't':
+            tolerance = atof(optarg) / 100;
+            break;
+        case 'f':
+            goldenPath = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-g] [-f golden] [-o times] [-b times] [-t pct]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    synthesize();
+    bench_mfcc();
+    bench_melspec();
+    bench_stft();
+    bench_stft_ola();
+    bench_layers();
+    bench_packed("fc_4x16", "lstm_4x16", fc_4x16, lstm_4x16, make_4x16);
+    bench_packed("fc_sparse_8x16", "lstm_sparse_8x16", fc_sparse_8x16, lstm_sparse_8x16,
+                 make_sparse);
+    bench_log10();
+    bench_ring();
+    check_golden(goldenPath, regenerate);
+
+    printf("kernel\tcalls\tns/call\tcheck\n");
+    for (int i = 0; i < numResults; i++) {
+        const kernel_result_t *r = &results[i];
+        printf("%s\t%u\t%9.1f\t%s", r->name, r->calls, r->nsPerCall, r->check);
+        printf(r->hasCrc ? ", crc %08x\n" : "\n", (unsigned)r->crc);
+    }
+    if (savePath) {
+        save_times(savePath);
+    }
+    if (baselinePath) {
+        check_baseline(baselinePath, tolerance);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * @file imu_fifo_replay.c
+ * @author Ambiq
+ * @brief Host replay of IMU FIFO dumps through the unpacker and window batching
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Without arguments, synthesizes a FIFO dump (sinusoids on every axis, empty and invalid
+ * packets, 16-bit timestamp wraps, bursts of varying size, a trailing partial packet) and
+ * checks the unpacked samples, timestamps, window boundaries and both window conversions
+ * against double-precision references.
+ *
+ * With a file argument, replays a recorded dump (raw FIFO_DATA bytes, little endian) and
+ * prints one line per window:
+ *
+ *   ./imu_fifo_replay [-w window] [-p hop] [-b burst] dump.bin
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ns_imu_fifo.h"
+
+#define SYN_SAMPLES 2000
+#define SYN_WINDOW 200
+#define SYN_HOP 160
+#define SYN_BURST 37       // deliberately not a divisor of the window or hop
+#define SYN_ODR_US 20000   // 50Hz
+#define TS_RES_US 16
+#define ZSCORE_SCALE 0.04f // typical input scale for a z-scored HAR model
+#define ZSCORE_ZP (-3)
+
+static int errors;
+
+static void check(int ok, const char *msg) {
+    if (!ok && (errors++ < 10)) {
+        fprintf(stderr, "FAIL: %s\n", msg);
+    }
+}
+
+static int16_t syn_value(uint32_t i, int a) {
+    return (int16_t)(a * 1000 + 8000 * sin(0.05 * i * (a + 1)) + ((i * 7 + a) % 13));
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+// Writes one packet, returns the next write position
+static uint8_t *syn_packet(uint8_t *p, uint8_t header, const int16_t *d, uint16_t ts) {
+    *p++ = header;
+    for (int a = 0; a < NS_IMU_AXES; a++) {
+        p = put16(p, (uint16_t)d[a]);
+    }
+    *p++ = 25;
+    return put16(p, ts);
+}
+
+static void zscore_reference(const ns_imu_window_t *w, int8_t *out) {
+    for (int a = 0; a < NS_IMU_AXES; a++) {
+        double mean = 0, var = 0;
+        for (uint32_t i = 0; i < w->window_len; i++) {
+            mean += ns_imu_window_sample(w, i)->data[a];
+        }
+        mean /= w->window_len;
+        for (uint32_t i = 0; i < w->window_len; i++) {
+            double d = ns_imu_window_sample(w, i)->data[a] - mean;
+            var += d * d;
+        }
+        double std = sqrt(var / w->window_len);
+        for (uint32_t i = 0; i < w->window_len; i++) {
+            double z = std > 0 ? (ns_imu_window_sample(w, i)->data[a] - mean) / std : 0;
+            double q = floor(z / ZSCORE_SCALE + ZSCORE_ZP + 0.5);
+            out[i * NS_IMU_AXES + a] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    }
+}
+
+static int self_test(void) {
+    static uint8_t dump[(SYN_SAMPLES + SYN_SAMPLES / 50 + 1) * NS_IMU_FIFO_PACKET_SIZE];
+    static ns_imu_raw_sample_t ring[NS_IMU_WINDOW_CAPACITY(SYN_WINDOW, SYN_BURST)];
+    static float fwin[SYN_WINDOW * NS_IMU_AXES];
+    static int8_t qwin[SYN_WINDOW * NS_IMU_AXES], qref[SYN_WINDOW * NS_IMU_AXES];
+    const int16_t invalid[NS_IMU_AXES] = {(int16_t)0x8000, 0, 0, (int16_t)0x8000, 0, 0};
+
+    // Synthesize the dump. Every 50th sample is preceded by a junk packet, alternating an
+    // empty FIFO read (0xFF) and a packet flagged invalid by the sensor.
+    uint8_t *p = dump;
+    uint32_t junk = 0;
+    for (uint32_t i = 0; i < SYN_SAMPLES; i++) {
+        int16_t d[NS_IMU_AXES];
+        uint16_t ts = (uint16_t)(i * (SYN_ODR_US / TS_RES_US) + 60000);
+        if ((i % 50) == 25) {
+            if (junk++ & 1) {
+                p = syn_packet(p, 0x68, invalid, ts);
+            } else {
+                memset(p, 0xFF, NS_IMU_FIFO_PACKET_SIZE);
+                p += NS_IMU_FIFO_PACKET_SIZE;
+            }
+        }
+        for (int a = 0; a < NS_IMU_AXES; a++) {
+            d[a] = syn_value(i, a);
+        }
+        p = syn_packet(p, 0x68, d, ts);
+    }
+    uint32_t bytes = p - dump + 5; // trailing partial packet
+
+    ns_imu_fifo_unpacker_t u = {.big_endian = false, .ts_resolution_us = TS_RES_US};
+    ns_imu_window_t w = {.buffer = ring,
+                         .capacity = NS_IMU_WINDOW_CAPACITY(SYN_WINDOW, SYN_BURST),
+                         .window_len = SYN_WINDOW,
+                         .hop = SYN_HOP};
+    ns_imu_axis_scale_t scale;
+    for (int a = 0; a < NS_IMU_AXES; a++) {
+        scale.gain[a] = (a < 3) ? 4.0f / 32768 : 2000.0f / 32768;
+        scale.bias[a] = 0.01f * a;
+    }
+    ns_imu_fifo_unpacker_reset(&u);
+    check(ns_imu_window_init(&w) == 0, "window init");
+
+    // Feed it in bursts, as the driver would, converting every completed window
+    uint32_t samples = 0, windows = 0, last_ts = 0, max_q_err = 0;
+    ns_imu_raw_sample_t burst[SYN_BURST];
+    for (uint32_t off = 0; off < bytes;) {
+        uint32_t len = SYN_BURST * NS_IMU_FIFO_PACKET_SIZE;
+        len = (off + len > bytes) ? bytes - off : len;
+        uint32_t n = ns_imu_fifo_unpack(&u, dump + off, len, burst, SYN_BURST);
+        off += len;
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t s = samples + i;
+            check(burst[i].data[4] == syn_value(s, 4), "sample out of order or corrupt");
+            check(burst[i].timestamp_us == s * SYN_ODR_US, "timestamp not unwrapped");
+            check((s == 0) || (burst[i].timestamp_us > last_ts), "timestamp not monotonic");
+            last_ts = burst[i].timestamp_us;
+        }
+        samples += n;
+
+        if (!ns_imu_window_push(&w, burst, n)) {
+            continue;
+        }
+        windows++;
+        uint32_t first = w.ready_end - SYN_WINDOW;
+        check((first % SYN_HOP) == 0, "window doesn't start on a hop boundary");
+        check(samples - w.ready_end < n, "window isn't the latest");
+
+        ns_imu_window_to_float(&w, &scale, fwin);
+        for (uint32_t i = 0; i < SYN_WINDOW; i++) {
+            for (int a = 0; a < NS_IMU_AXES; a++) {
+                double ref = syn_value(first + i, a) * (double)scale.gain[a] - scale.bias[a];
+                check(fabs(fwin[i * NS_IMU_AXES + a] - ref) < 1e-4, "float conversion");
+            }
+        }
+
+        check(!w.ready, "ready flag not cleared");
+        w.ready = true; // convert the same window again
+        ns_imu_window_zscore_int8(&w, ZSCORE_SCALE, ZSCORE_ZP, qwin);
+        zscore_reference(&w, qref);
+        for (uint32_t i = 0; i < SYN_WINDOW * NS_IMU_AXES; i++) {
+            uint32_t e = abs(qwin[i] - qref[i]);
+            max_q_err = e > max_q_err ? e : max_q_err;
+        }
+    }
+
+    check(samples == SYN_SAMPLES, "sample count");
+    check(u.invalid == junk, "invalid packet count");
+    check(windows == 1 + (SYN_SAMPLES - SYN_WINDOW) / SYN_HOP, "window count");
+    check(w.overruns == 0, "overruns");
+    check(max_q_err <= 1, "int8 z-score differs from reference by more than 1 LSB");
+
+    // Bus traffic: one register read per sample vs one burst per watermark
+    const double odr_hz = 1e6 / SYN_ODR_US;
+    printf("samples %u, skipped %u, windows %u, max z-score error %u LSB\n", samples, u.invalid,
+           windows, max_q_err);
+    printf("SPI transactions/s at %.0fHz: per-sample %.0f, FIFO (watermark %d) %.2f\n", odr_hz,
+           odr_hz, SYN_BURST, odr_hz / SYN_BURST);
+    return errors;
+}
+
+static int replay(const char *path, uint32_t window_len, uint32_t hop, uint32_t burst) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 1;
+    }
+    uint32_t capacity = NS_IMU_WINDOW_CAPACITY(window_len, burst);
+    ns_imu_raw_sample_t *ring = calloc(capacity, sizeof(*ring));
+    ns_imu_raw_sample_t *samples = calloc(burst, sizeof(*samples));
+    uint8_t *raw = malloc(burst * NS_IMU_FIFO_PACKET_SIZE);
+    int8_t *q = malloc(window_len * NS_IMU_AXES);
+    ns_imu_fifo_unpacker_t u = {.ts_resolution_us = TS_RES_US};
+    ns_imu_window_t w = {.buffer = ring, .capacity = capacity, .window_len = window_len,
+                         .hop = hop};
+    ns_imu_fifo_unpacker_reset(&u);
+    if (ns_imu_window_init(&w)) {
+        fprintf(stderr, "invalid window config\n");
+        return 1;
+    }
+
+    size_t len;
+    uint32_t total = 0;
+    printf("window\tfirst\tstart_ms\tspan_ms\tq[0..5]\n");
+    while ((len = fread(raw, 1, burst * NS_IMU_FIFO_PACKET_SIZE, f)) > 0) {
+        uint32_t n = ns_imu_fifo_unpack(&u, raw, len, samples, burst);
+        total += n;
+        if (ns_imu_window_push(&w, samples, n)) {
+            const ns_imu_raw_sample_t *s0 = ns_imu_window_sample(&w, 0);
+            const ns_imu_raw_sample_t *s1 = ns_imu_window_sample(&w, window_len - 1);
+            ns_imu_window_zscore_int8(&w, ZSCORE_SCALE, ZSCORE_ZP, q);
+            printf("%u\t%u\t%.1f\t%.1f\t%d %d %d %d %d %d\n", w.windows - 1,
+                   w.ready_end - window_len, s0->timestamp_us / 1000.0,
+                   (s1->timestamp_us - s0->timestamp_us) / 1000.0, q[0], q[1], q[2], q[3], q[4],
+                   q[5]);
+        }
+    }
+    printf("%u samples, %u invalid packets, %u windows\n", total, u.invalid, w.windows);
+    fclose(f);
+    free(ring);
+    free(samples);
+    free(raw);
+    free(q);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint32_t window_len = SYN_WINDOW, hop = SYN_HOP, burst = SYN_BURST;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:p:b:")) != -1) {
+        switch (opt) {
+        case 'w':
+            window_len = atoi(optarg);
+            break;
+        case 'p':
+            hop = atoi(optarg);
+            break;
+        case 'b':
+            burst = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-w window] [-p hop] [-b burst] [dump.bin]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc) {
+        return replay(argv[optind], window_len, hop, burst ? burst : SYN_BURST);
+    }
+    return self_test() ? 1 : 0;
+}
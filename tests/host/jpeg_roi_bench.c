@@ -0,0 +1,179 @@
+/**
+ * @file jpeg_roi_bench.c
+ * @author Ambiq
+ * @brief Host benchmark for ROI (crop window) JPEG decoding
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Decodes each JPEG with a centered crop window of decreasing size and reports the
+ * decode time relative to a full decode. Pixels inside the window are compared
+ * against the full decode to check that skipped MCUs leave the entropy decoder in
+ * sync.
+ *
+ * Usage: jpeg_roi_bench [file.jpg ...] (defaults to the JPEGs in docs/images)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "jpeg_decoder.h"
+
+static const char *default_images[] = {
+    "../../docs/images/i2c-evb-wiring.jpg", "../../docs/images/mpu6050-wiring.jpg"};
+
+static const int crop_percent[] = {100, 75, 50, 25, 10};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static uint8_t *load_file(const char *path, uint32_t *size) {
+    FILE *f = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc(len);
+    if (buf && fread(buf, 1, len, f) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *size = (uint32_t)len;
+    return buf;
+}
+
+// Decode with a centered window of 'percent' of the MCUs in each dimension, copying
+// the decoded MCUs into 'out' (one uint16_t per pixel, MCU-aligned, may be NULL).
+// Returns the number of MCUs that were fully decoded, or -1 on error.
+static int decode(
+    jpeg_decoder_context_t *ctx, uint8_t *jpg, uint32_t size, int percent, uint16_t *out) {
+    int fully_decoded = 0;
+
+    if (!jpeg_decoder_open(ctx, jpg, size, 0)) {
+        return -1;
+    }
+    const int per_row = ctx->imgInfo.m_MCUSPerRow;
+    const int per_col = ctx->imgInfo.m_MCUSPerCol;
+    const int keep_x = (per_row * percent + 99) / 100;
+    const int keep_y = (per_col * percent + 99) / 100;
+    const int x0 = (per_row - keep_x) / 2;
+    const int y0 = (per_col - keep_y) / 2;
+    jpeg_decoder_set_roi(ctx, x0, y0, x0 + keep_x, y0 + keep_y);
+
+    const int mcu_w = ctx->imgInfo.m_MCUWidth;
+    const int mcu_h = ctx->imgInfo.m_MCUHeight;
+    const int stride = per_row * mcu_w;
+    while (jpeg_decoder_read(ctx)) {
+        if (ctx->MCUx < x0 || ctx->MCUx >= x0 + keep_x || ctx->MCUy < y0 ||
+            ctx->MCUy >= y0 + keep_y) {
+            continue;
+        }
+        fully_decoded++;
+        if (out) {
+            for (int row = 0; row < mcu_h; row++) {
+                memcpy(
+                    out + (ctx->MCUy * mcu_h + row) * stride + ctx->MCUx * mcu_w,
+                    ctx->pImage + row * mcu_w, mcu_w * sizeof(uint16_t));
+            }
+        }
+    }
+    if (ctx->status != PJPG_NO_MORE_BLOCKS) {
+        return -1;
+    }
+    return fully_decoded;
+}
+
+static int bench_file(const char *path) {
+    static jpeg_decoder_context_t ctx;
+    uint32_t size;
+    uint8_t *jpg = load_file(path, &size);
+    int errors = 0;
+
+    if (jpg == NULL) {
+        fprintf(stderr, "can't read %s\n", path);
+        return 1;
+    }
+    if (!jpeg_decoder_open(&ctx, jpg, size, 0)) {
+        fprintf(stderr, "%s: unsupported JPEG (picojpeg status %d)\n", path, ctx.status);
+        free(jpg);
+        return 1;
+    }
+    const int per_row = ctx.imgInfo.m_MCUSPerRow;
+    const int per_col = ctx.imgInfo.m_MCUSPerCol;
+    const size_t pixels = (size_t)per_row * ctx.imgInfo.m_MCUWidth * per_col *
+                          ctx.imgInfo.m_MCUHeight;
+    uint16_t *full = calloc(pixels, sizeof(uint16_t));
+    uint16_t *crop = calloc(pixels, sizeof(uint16_t));
+
+    printf(
+        "%s: %dx%d, %dx%d MCUs of %dx%d\n", path, ctx.imgInfo.m_width, ctx.imgInfo.m_height,
+        per_row, per_col, ctx.imgInfo.m_MCUWidth, ctx.imgInfo.m_MCUHeight);
+    printf("crop%%\tdecoded MCUs\tms\trelative\tmismatches\n");
+
+    double full_ms = 0;
+    for (size_t i = 0; i < sizeof(crop_percent) / sizeof(crop_percent[0]); i++) {
+        const int reps = 3;
+        double best = 1e30;
+        int decoded = 0;
+        for (int r = 0; r < reps; r++) {
+            double t0 = now_ms();
+            decoded = decode(&ctx, jpg, size, crop_percent[i], NULL);
+            double t = now_ms() - t0;
+            best = (t < best) ? t : best;
+        }
+        if (decoded < 0) {
+            fprintf(stderr, "%s: decode error\n", path);
+            errors++;
+            break;
+        }
+        if (i == 0) {
+            full_ms = best;
+            decode(&ctx, jpg, size, 100, full);
+        }
+
+        // Every MCU decoded inside the window must match the full decode
+        memset(crop, 0, pixels * sizeof(uint16_t));
+        decode(&ctx, jpg, size, crop_percent[i], crop);
+        size_t mismatches = 0;
+        for (size_t p = 0; p < pixels; p++) {
+            if (crop[p] && crop[p] != full[p]) {
+                mismatches++;
+            }
+        }
+        errors += mismatches != 0;
+        printf(
+            "%d\t%d\t\t%.2f\t%.2f\t\t%zu\n", crop_percent[i], decoded, best, best / full_ms,
+            mismatches);
+    }
+    free(full);
+    free(crop);
+    free(jpg);
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    int errors = 0;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            errors += bench_file(argv[i]);
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(default_images) / sizeof(default_images[0]); i++) {
+            errors += bench_file(default_images[i]);
+        }
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+/**
+ * @file jpeg_tensor_bench.c
+ * @author Ambiq
+ * @brief Host benchmark and PSNR check for the fused JPEG to tensor decode
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Compares three ways of getting a WxH RGB model input out of a JPEG:
+ *  - legacy: decode to RGB565 with point sampling (as camera_decode_image does),
+ *    then a separate pass converting RGB565 to the tensor
+ *  - fused:  ns_camera_decode_to_tensor, area-averaged
+ *  - fused DC-only: same, decoding only the DC term of each 8x8 block
+ * against a reference made by area-averaging a full-resolution decode in double
+ * precision. The fused path must match the reference to within rounding.
+ *
+ * Usage: jpeg_tensor_bench [-w width] [-h height] [file.jpg ...]
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "jpeg-decoder/jpeg_decoder.h"
+#include "ns_camera_tensor.h"
+
+static const char *default_images[] = {
+    "../../docs/images/i2c-evb-wiring.jpg", "../../docs/images/mpu6050-wiring.jpg"};
+
+// The fused decode must be this close to the double-precision reference
+#define MIN_FUSED_PSNR 45.0
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static uint8_t *load_file(const char *path, uint32_t *size) {
+    FILE *f = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc(len);
+    if (buf && fread(buf, 1, len, f) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *size = (uint32_t)len;
+    return buf;
+}
+
+static double psnr(const uint8_t *a, const uint8_t *b, size_t n) {
+    double se = 0;
+    for (size_t i = 0; i < n; i++) {
+        double d = (double)a[i] - b[i];
+        se += d * d;
+    }
+    return (se == 0) ? INFINITY : 10.0 * log10(255.0 * 255.0 / (se / n));
+}
+
+// Center crop of the source matching the tensor's aspect ratio (as center_crop does)
+static void crop_region(
+    uint32_t src_w, uint32_t src_h, uint32_t w, uint32_t h, uint32_t *x0, uint32_t *y0,
+    uint32_t *cw, uint32_t *ch) {
+    *cw = src_w;
+    *ch = src_h;
+    if (src_w * h > src_h * w) {
+        *cw = src_h * w / h;
+    } else {
+        *ch = src_w * h / w;
+    }
+    *x0 = (src_w - *cw) / 2;
+    *y0 = (src_h - *ch) / 2;
+}
+
+// Full resolution RGB888 decode
+static uint8_t *decode_rgb888(uint8_t *jpg, uint32_t size, uint32_t *width, uint32_t *height) {
+    static jpeg_decoder_context_t ctx;
+    if (!jpeg_decoder_open(&ctx, jpg, size, 0)) {
+        return NULL;
+    }
+    const pjpeg_image_info_t *info = &ctx.imgInfo;
+    const uint32_t w = info->m_width, h = info->m_height;
+    uint8_t *rgb = malloc((size_t)w * h * 3);
+
+    for (int my = 0; my < info->m_MCUSPerCol; my++) {
+        for (int mx = 0; mx < info->m_MCUSPerRow; mx++) {
+            if (pjpeg_decode_mcu()) {
+                free(rgb);
+                return NULL;
+            }
+            for (int py = 0; py < info->m_MCUHeight; py++) {
+                for (int px = 0; px < info->m_MCUWidth; px++) {
+                    uint32_t x = mx * info->m_MCUWidth + px, y = my * info->m_MCUHeight + py;
+                    if (x >= w || y >= h) {
+                        continue;
+                    }
+                    uint32_t ofs = (py >> 3) * 128 + (px >> 3) * 64 + (py & 7) * 8 + (px & 7);
+                    uint8_t *dst = rgb + ((size_t)y * w + x) * 3;
+                    int gray = info->m_scanType == PJPG_GRAYSCALE;
+                    dst[0] = info->m_pMCUBufR[ofs];
+                    dst[1] = gray ? dst[0] : info->m_pMCUBufG[ofs];
+                    dst[2] = gray ? dst[0] : info->m_pMCUBufB[ofs];
+                }
+            }
+        }
+    }
+    *width = w;
+    *height = h;
+    return rgb;
+}
+
+// Double precision area average of the center crop, using the same bins as the fused path
+static void reference(
+    const uint8_t *rgb, uint32_t src_w, uint32_t src_h, uint32_t w, uint32_t h, uint8_t *out) {
+    uint32_t x0, y0, cw, ch;
+    crop_region(src_w, src_h, w, h, &x0, &y0, &cw, &ch);
+    double *sum = calloc((size_t)w * h * 3, sizeof(double));
+    uint32_t *cnt = calloc((size_t)w * h, sizeof(uint32_t));
+
+    for (uint32_t sy = 0; sy < ch; sy++) {
+        for (uint32_t sx = 0; sx < cw; sx++) {
+            uint32_t o = (sy * h / ch) * w + sx * w / cw;
+            const uint8_t *p = rgb + ((size_t)(sy + y0) * src_w + sx + x0) * 3;
+            for (int c = 0; c < 3; c++) {
+                sum[o * 3 + c] += p[c];
+            }
+            cnt[o]++;
+        }
+    }
+    for (size_t i = 0; i < (size_t)w * h * 3; i++) {
+        out[i] = (uint8_t)floor(sum[i] / cnt[i / 3] + 0.5);
+    }
+    free(sum);
+    free(cnt);
+}
+
+// What apps do today: RGB565 decode with point sampling, then convert to the tensor
+static double legacy(uint8_t *jpg, uint32_t size, uint32_t w, uint32_t h, uint8_t *out) {
+    static jpeg_decoder_context_t ctx;
+    uint16_t *img = calloc((size_t)w * h, sizeof(uint16_t));
+    double t0 = now_ms();
+
+    jpeg_decoder_open(&ctx, jpg, size, 0);
+    uint32_t x0, y0, cw, ch;
+    crop_region(ctx.imgInfo.m_width, ctx.imgInfo.m_height, w, h, &x0, &y0, &cw, &ch);
+    const int mcu_w = ctx.imgInfo.m_MCUWidth, mcu_h = ctx.imgInfo.m_MCUHeight;
+    jpeg_decoder_set_roi(
+        &ctx, x0 / mcu_w, y0 / mcu_h, (x0 + cw + mcu_w - 1) / mcu_w, (y0 + ch + mcu_h - 1) / mcu_h);
+
+    while (jpeg_decoder_read(&ctx)) {
+        for (int py = 0; py < mcu_h; py++) {
+            for (int px = 0; px < mcu_w; px++) {
+                int32_t sx = ctx.MCUx * mcu_w + px - (int32_t)x0;
+                int32_t sy = ctx.MCUy * mcu_h + py - (int32_t)y0;
+                if (sx < 0 || sy < 0 || sx >= (int32_t)cw || sy >= (int32_t)ch) {
+                    continue;
+                }
+                // Keep the first source pixel of each output pixel
+                uint32_t ox = sx * w / cw, oy = sy * h / ch;
+                if (((ox * cw + w - 1) / w == (uint32_t)sx) &&
+                    ((oy * ch + h - 1) / h == (uint32_t)sy)) {
+                    img[oy * w + ox] = ctx.pImage[py * mcu_w + px];
+                }
+            }
+        }
+    }
+    // Conversion pass
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        uint16_t c = img[i];
+        out[i * 3 + 0] = ((c >> 11) & 0x1F) * 255 / 31;
+        out[i * 3 + 1] = ((c >> 5) & 0x3F) * 255 / 63;
+        out[i * 3 + 2] = (c & 0x1F) * 255 / 31;
+    }
+    double t = now_ms() - t0;
+    free(img);
+    return t;
+}
+
+static int fused(
+    uint8_t *jpg, uint32_t size, uint32_t w, uint32_t h, bool dc_only, uint8_t *out,
+    double *ms) {
+    static uint16_t scratch[64 * 1024];
+    ns_camera_tensor_cfg_t cfg = {
+        .tensor = out,
+        .width = w,
+        .height = h,
+        .color = NS_CAMERA_TENSOR_RGB,
+        .is_signed = false,
+        .pixel_scale = 1.0f,
+        .pixel_offset = 0.0f,
+        .scale = 1.0f,
+        .zero_point = 0,
+        .center_crop = true,
+        .dc_only = dc_only,
+        .scratch = scratch,
+        .scratch_size = sizeof(scratch)};
+    double t0 = now_ms();
+    int status = ns_camera_decode_to_tensor(jpg, size, &cfg);
+    *ms = now_ms() - t0;
+    return status;
+}
+
+static int bench_file(const char *path, uint32_t w, uint32_t h) {
+    uint32_t size, src_w, src_h;
+    uint8_t *jpg = load_file(path, &size);
+    int errors = 0;
+    double ms;
+
+    if (jpg == NULL) {
+        fprintf(stderr, "can't read %s\n", path);
+        return 1;
+    }
+    uint8_t *rgb = decode_rgb888(jpg, size, &src_w, &src_h);
+    if (rgb == NULL) {
+        fprintf(stderr, "%s: unsupported JPEG\n", path);
+        free(jpg);
+        return 1;
+    }
+    const size_t n = (size_t)w * h * 3;
+    uint8_t *ref = malloc(n), *out = malloc(n);
+    reference(rgb, src_w, src_h, w, h, ref);
+
+    printf("%s: %ux%u -> %ux%u RGB\n", path, src_w, src_h, w, h);
+    printf("path\t\tms\tPSNR (dB)\n");
+
+    ms = legacy(jpg, size, w, h, out);
+    printf("legacy\t\t%.2f\t%.2f\n", ms, psnr(ref, out, n));
+
+    int status = fused(jpg, size, w, h, false, out, &ms);
+    if (status == NS_CAMERA_TENSOR_OK) {
+        double p = psnr(ref, out, n);
+        printf("fused\t\t%.2f\t%.2f\n", ms, p);
+        if (p < MIN_FUSED_PSNR) {
+            fprintf(stderr, "fused PSNR below %.0f dB\n", MIN_FUSED_PSNR);
+            errors++;
+        }
+    } else {
+        printf("fused\t\tn/a (status %d)\n", status);
+    }
+
+    status = fused(jpg, size, w, h, true, out, &ms);
+    if (status == NS_CAMERA_TENSOR_OK) {
+        printf("fused DC-only\t%.2f\t%.2f\n", ms, psnr(ref, out, n));
+    } else {
+        printf("fused DC-only\tn/a (status %d)\n", status);
+    }
+
+    free(ref);
+    free(out);
+    free(rgb);
+    free(jpg);
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    uint32_t w = 224, h = 224;
+    int errors = 0, files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            w = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-h") && i + 1 < argc) {
+            h = atoi(argv[++i]);
+        } else {
+            errors += bench_file(argv[i], w, h);
+            files++;
+        }
+    }
+    if (files == 0) {
+        for (size_t i = 0; i < sizeof(default_images) / sizeof(default_images[0]); i++) {
+            errors += bench_file(default_images[i], w, h);
+        }
+    }
+    return errors ? 1 : 0;
+}
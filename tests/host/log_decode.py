@@ -0,0 +1,82 @@
+"""Host check of tools/ns_log_decode.py against records captured by log_ring_bench.
+
+log_ring_bench writes the words its ns_log() calls produced to log_ring_bench.bin and the
+printf rendering of the same calls to log_ring_bench.txt. Decoding the words with the
+log_ring_bench ELF has to reproduce the text exactly, from the raw word stream, from "#NSL"
+console lines mixed with other output, and from an ITM packet stream.
+
+    make -C tests/host log_ring_bench && (cd tests/host && ./log_ring_bench && python3 log_decode.py)
+"""
+
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "tools"))
+
+import ns_log_decode  # noqa: E402
+
+STAMP = re.compile(r"^\[\s*\d+\] ")
+
+
+def strip_stamps(lines):
+    out = []
+    for line in lines:
+        m = STAMP.match(line)
+        assert m, f"no timestamp in {line!r}"
+        out.append(line[m.end() :])
+    return out
+
+
+def itm_stream(words, port):
+    """Words as 4-byte ITM stimulus packets, with sync and other ports' packets mixed in."""
+    data = bytearray(b"\x00\x00\x00\x00\x00\x80")
+    for i, w in enumerate(words):
+        if i % 5 == 0:
+            data += bytes([(0 << 3) | 0x1, ord("x")])  # a printf character on port 0
+        data += bytes([(port << 3) | 0x3]) + struct.pack("<I", w)
+    return bytes(data)
+
+
+def main():
+    elf = ns_log_decode.ElfImage(os.path.join(HERE, "log_ring_bench"))
+    with open(os.path.join(HERE, "log_ring_bench.bin"), "rb") as f:
+        data = f.read()
+    with open(os.path.join(HERE, "log_ring_bench.txt")) as f:
+        expected = f.read().splitlines()
+    words = list(struct.unpack(f"<{len(data) // 4}I", data))
+
+    decoded = strip_stamps(ns_log_decode.decode_words(elf, words))
+    for got, want in zip(decoded, expected):
+        assert got == want, f"decoded {got!r}, printf gave {want!r}"
+    assert len(decoded) == len(expected), (len(decoded), len(expected))
+
+    # Console capture: one "#NSL" line per record between ordinary prints
+    lines, i = ["booting"], 0
+    for record in ns_log_decode.records_from_words(words):
+        lines.append("#NSL " + " ".join(f"{w:08x}" for w in record) + "\n")
+        lines.append(f"plain line {i}\n")
+        i += 1
+    out = list(ns_log_decode.decode_lines(elf, lines))
+    assert out[0] == "booting"
+    assert strip_stamps(out[1::2]) == expected
+    assert out[2::2] == [f"plain line {k}" for k in range(i)]
+
+    # SWO capture, after a corrupted word the decoder resyncs on the next header
+    itm = ns_log_decode.words_from_itm(itm_stream([0xDEADBEEF] + words, 1), 1)
+    assert itm == [0xDEADBEEF] + words
+    assert strip_stamps(ns_log_decode.decode_words(elf, itm)) == expected
+
+    # Drop markers and unknown IDs still produce a line
+    marker = [0x4E4C0001, ns_log_decode.ID_DROPPED, 7, 12]
+    assert strip_stamps(ns_log_decode.decode_words(elf, marker)) == ["<12 ns_log records dropped>"]
+    unknown = [0x4E4C0001, 0x7FFFFFF0, 7, 1]
+    assert strip_stamps(ns_log_decode.decode_words(elf, unknown))[0].startswith("<unknown format")
+
+    print(f"ns_log_decode: {len(expected)} records match printf")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,268 @@
+/**
+ * @file log_ring_bench.c
+ * @author Ambiq
+ * @brief Host check and benchmark of the ns_log deferred binary logging ring
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Checks:
+ *   - record layout for every argument type ns_log() converts, drained through the callback
+ *     sink into log_ring_bench.bin, with the printf rendering of the same calls written to
+ *     log_ring_bench.txt so log_decode.py can check ns_log_decode.py against this binary
+ *   - overflow: records that don't fit are dropped, counted, and reported ahead of the rest
+ *   - several producer threads logging while a consumer drains: every record arrives intact
+ *     and in order per producer, or is counted as dropped
+ * then times an ns_log() call against formatting the same message with snprintf.
+ *
+ * Built without PIE so format string addresses in the ring match the ELF the decoder reads.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ns_log.h"
+
+#define PRODUCERS 3
+#define PER_PRODUCER 200000
+#define REPEATS 1000000
+
+static int errors;
+
+static void fail(const char *what, long got, long want) {
+    if (errors++ < 10) {
+        printf("FAIL %s: got %ld want %ld\n", what, got, want);
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Callback sink that keeps every word
+static uint32_t captured[4096];
+static uint32_t numCaptured;
+
+static void capture(const uint32_t *words, uint32_t count, void *user) {
+    (void)user;
+    if (numCaptured + count <= sizeof(captured) / sizeof(captured[0])) {
+        memcpy(&captured[numCaptured], words, count * sizeof(uint32_t));
+    }
+    numCaptured += count;
+}
+
+static uint32_t ring[1024];
+
+static void check_decoding(FILE *ref) {
+    static const char *names[] = {"kws", "vad"};
+    const char *name = names[1];
+    ns_log_config_t cfg = {.api = &ns_log_V1_0_0, .buffer = ring, .size = 1024,
+                           .sink = NS_LOG_SINK_CALLBACK, .write = capture};
+    if (ns_log_init(&cfg) != NS_STATUS_SUCCESS) {
+        fail("init", 1, 0);
+        return;
+    }
+    numCaptured = 0;
+
+    // Each call twice: once through the ring, once through printf for the expected text
+#define LOG_BOTH(fmt, ...)                                                                         \
+    do {                                                                                           \
+        ns_log(fmt, ##__VA_ARGS__);                                                                \
+        fprintf(ref, fmt "\n", ##__VA_ARGS__);                                                     \
+    } while (0)
+    LOG_BOTH("boot");
+    LOG_BOTH("frame %d of %u", -3, 4000000000u);
+    LOG_BOTH("score %f energy %.2e ratio %g", 0.75f, 1536.0, 0.1875);
+    LOG_BOTH("model %s at %p flags 0x%08x %c", name, (void *)0x20001000, 0xa5u, 'k');
+    LOG_BOTH("%5d|%-5d|%05u|%x|%X|%#o|%%", 42, 42, 42u, 0xbeefu, 0xbeefu, 8u);
+    LOG_BOTH("eight %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+#undef LOG_BOTH
+
+    ns_log_flush();
+    ns_log_stats_t stats;
+    ns_log_get_stats(&stats);
+    if (stats.drained != 6) {
+        fail("records drained", stats.drained, 6);
+    }
+    // 6 records, 18 overhead words, 0 + 2 + 3 + 4 + 6 + 8 arguments
+    if (numCaptured != 18 + 23) {
+        fail("words drained", numCaptured, 18 + 23);
+    }
+    if ((captured[0] != NS_LOG_HEADER(0)) || (captured[3] != NS_LOG_HEADER(2)) ||
+        (captured[6] != (uint32_t)-3) || (captured[7] != 4000000000u)) {
+        fail("record layout", captured[6], -3);
+    }
+    float f;
+    memcpy(&f, &captured[3 + 5 + 3], sizeof(f));
+    if (f != 0.75f) {
+        fail("float argument", (long)(f * 100), 75);
+    }
+
+    FILE *bin = fopen("log_ring_bench.bin", "wb");
+    if (bin != NULL) {
+        fwrite(captured, sizeof(uint32_t), numCaptured, bin);
+        fclose(bin);
+    }
+}
+
+static void check_overflow(void) {
+    static uint32_t small[16];
+    ns_log_config_t cfg = {.api = &ns_log_V1_0_0, .buffer = small, .size = 16,
+                           .sink = NS_LOG_SINK_CALLBACK, .write = capture};
+    ns_log_init(&cfg);
+    numCaptured = 0;
+
+    // 4-word records: 4 fit, 6 are dropped
+    for (int i = 0; i < 10; i++) {
+        ns_log("overflow %d", i);
+    }
+    ns_log_stats_t stats;
+    ns_log_get_stats(&stats);
+    if (stats.dropped != 6) {
+        fail("dropped", stats.dropped, 6);
+    }
+    if (ns_log_drain(2) != 2) {
+        fail("drain limit", numCaptured, 8);
+    }
+    // The drop marker goes first
+    if ((captured[1] != NS_LOG_ID_DROPPED) || (captured[3] != 6) || (captured[7] != 0)) {
+        fail("drop marker", captured[3], 6);
+    }
+    ns_log("overflow %d", 10);
+    ns_log_flush();
+    for (int i = 0; i < 4; i++) {
+        uint32_t want = (i < 3) ? i + 1 : 10;
+        if (captured[8 + i * 4 + 3] != want) {
+            fail("order after overflow", captured[8 + i * 4 + 3], want);
+        }
+    }
+
+    ns_log_config_t bad = cfg;
+    bad.size = 24;
+    if (ns_log_init(&bad) != NS_STATUS_INVALID_CONFIG) {
+        fail("non power of 2 ring accepted", 0, 1);
+    }
+}
+
+// Concurrent producers, one draining consumer
+static uint32_t lastSeq[PRODUCERS];
+static uint32_t received;
+static int producersDone;
+
+static void verify(const uint32_t *words, uint32_t count, void *user) {
+    (void)user;
+    if (words[1] == NS_LOG_ID_DROPPED) {
+        return;
+    }
+    if ((count != 6) || (words[0] != NS_LOG_HEADER(3))) {
+        fail("concurrent record", count, 6);
+        return;
+    }
+    uint32_t t = words[3], seq = words[4];
+    if ((t >= PRODUCERS) || (words[5] != (seq ^ 0x5a5a5a5au))) {
+        fail("concurrent payload", words[5], seq ^ 0x5a5a5a5au);
+        return;
+    }
+    if (seq <= lastSeq[t]) {
+        fail("concurrent order", seq, lastSeq[t] + 1);
+    }
+    lastSeq[t] = seq;
+    received++;
+}
+
+static void *producer(void *arg) {
+    uint32_t t = (uint32_t)(uintptr_t)arg;
+    for (uint32_t seq = 1; seq <= PER_PRODUCER; seq++) {
+        ns_log("thread %u seq %u check %x", t, seq, seq ^ 0x5a5a5a5au);
+        // Give the consumer a chance on machines with fewer cores than threads
+        if ((seq & 15) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_fetch_add(&producersDone, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void check_concurrency(void) {
+    static uint32_t words[256];
+    ns_log_config_t cfg = {.api = &ns_log_V1_0_0, .buffer = words, .size = 256,
+                           .sink = NS_LOG_SINK_CALLBACK, .write = verify};
+    pthread_t threads[PRODUCERS];
+
+    ns_log_init(&cfg);
+    for (uintptr_t t = 0; t < PRODUCERS; t++) {
+        pthread_create(&threads[t], NULL, producer, (void *)t);
+    }
+    while (__atomic_load_n(&producersDone, __ATOMIC_ACQUIRE) < PRODUCERS) {
+        if (ns_log_drain(0) == 0) {
+            sched_yield();
+        }
+    }
+    for (int t = 0; t < PRODUCERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    ns_log_flush();
+
+    ns_log_stats_t stats;
+    ns_log_get_stats(&stats);
+    if (received + stats.dropped != PRODUCERS * PER_PRODUCER) {
+        fail("received + dropped", received + stats.dropped, PRODUCERS * PER_PRODUCER);
+    }
+    printf("concurrent: %d producers x %d records, %u received, %u dropped, max fill %u/256\n",
+           PRODUCERS, PER_PRODUCER, received, stats.dropped, stats.maxFill);
+}
+
+static void discard(const uint32_t *words, uint32_t count, void *user) {
+    (void)words;
+    (void)count;
+    (void)user;
+}
+
+static void bench(void) {
+    static uint32_t words[1 << 16];
+    ns_log_config_t cfg = {.api = &ns_log_V1_0_0, .buffer = words, .size = 1 << 16,
+                           .sink = NS_LOG_SINK_CALLBACK, .write = discard};
+    char line[128];
+    volatile int sink = 0;
+
+    ns_log_init(&cfg);
+    double t0 = now_ns();
+    for (int i = 0; i < REPEATS; i++) {
+        ns_log("frame %d score %f label %d", i, 0.5f, 3);
+        if ((i & 1023) == 1023) {
+            ns_log_drain(0);
+        }
+    }
+    double t1 = now_ns();
+    for (int i = 0; i < REPEATS; i++) {
+        sink += snprintf(line, sizeof(line), "frame %d score %f label %d\n", i, 0.5f, 3);
+    }
+    double t2 = now_ns();
+    ns_log_flush();
+
+    printf("per call: ns_log %.1f ns (incl. drain), snprintf alone %.1f ns (%.0fx)\n",
+           (t1 - t0) / REPEATS, (t2 - t1) / REPEATS, (t2 - t1) / (t1 - t0));
+}
+
+int main(void) {
+    FILE *ref = fopen("log_ring_bench.txt", "w");
+    if (ref == NULL) {
+        printf("FAIL can't write log_ring_bench.txt\n");
+        return 1;
+    }
+    check_decoding(ref);
+    fclose(ref);
+    check_overflow();
+    check_concurrency();
+    printf("ring checks: %s\n", errors ? "FAILED" : "ok");
+    bench();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file mahony_bench.c
+ * @author Ambiq
+ * @brief Host accuracy check and benchmark of the batched Mahony updates
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Synthesizes a 1kHz IMU recording (a body tumbling on three axes, gravity seen by the
+ * accelerometer, quantized to ns_imu_raw_sample_t at 16g / 2000dps with sensor noise) and
+ * runs it through ns_mahony_update one sample at a time, ns_mahony_update_batch and
+ * ns_mahony_update_batch_q in FIFO-sized windows. Checks that both batched paths stay within
+ * tolerance of the per-sample filter, reports how all three track the true attitude and the
+ * cost per sample.
+ *
+ * Host timings only show the batched paths aren't slower where double precision and division
+ * are in hardware; on Cortex-M4/M55 ns_mahony_update pays for software double sqrt and float
+ * divisions, which the batched paths don't use.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ns_imu_fifo.h"
+#include "quaternion.h"
+
+#define ODR_HZ 1000
+#define SECONDS 20
+#define SAMPLES (ODR_HZ * SECONDS)
+#define WINDOW 32     // samples per FIFO watermark
+#define SUBSTEPS 16   // truth integration steps per sample
+#define SETTLE 1000   // samples before tracking error is measured
+#define ACCEL_LSB_PER_G 2048.0
+#define GYRO_RAD_PER_LSB (M_PI / 180.0 / 16.4)
+#define ACCEL_NOISE_LSB 8
+#define GYRO_NOISE_LSB 2
+#define REPEATS 20
+
+// Allowed distance from the per-sample filter
+#define MAX_Q_ERR_FLOAT 1e-4
+#define MAX_Q_ERR_FIXED 1e-3
+#define MAX_EULER_ERR 2e-3 // rad, float getters of the batched paths against the double ones
+
+static ns_imu_raw_sample_t raw[SAMPLES];
+static float samples[SAMPLES * NS_MAHONY_SAMPLE_AXES];
+static double truth[SAMPLES][4];
+static int errors;
+
+uint32_t ns_core_check_api(
+    const ns_core_api_t *s, const ns_core_api_t *oldest, const ns_core_api_t *newest) {
+    return NS_STATUS_SUCCESS;
+}
+
+static void sim_error(const char *msg, double v) {
+    if (errors++ < 10) {
+        fprintf(stderr, "%s: %g\n", msg, v);
+    }
+}
+
+static int16_t quantize(double v, int noise) {
+    v = round(v) + (noise ? (rand() % (2 * noise + 1)) - noise : 0);
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+// True attitude integrated finely from the body rates, and the IMU samples it produces
+static void synthesize(void) {
+    double q[4] = {1, 0, 0, 0};
+    const double dt = 1.0 / ODR_HZ / SUBSTEPS;
+
+    srand(1);
+    for (int i = 0; i < SAMPLES; i++) {
+        double t = (double)i / ODR_HZ, w[3];
+        w[0] = 3.0 * sin(2 * M_PI * 0.5 * t);
+        w[1] = 2.0 * sin(2 * M_PI * 0.3 * t + 1.0);
+        w[2] = 4.0 * sin(2 * M_PI * 0.2 * t + 2.0);
+
+        // Gravity direction in the body frame, as the filter estimates it
+        double v[3] = {2 * (q[1] * q[3] - q[0] * q[2]), 2 * (q[0] * q[1] + q[2] * q[3]),
+                       q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]};
+        for (int a = 0; a < 3; a++) {
+            raw[i].data[a] = quantize(v[a] * ACCEL_LSB_PER_G, ACCEL_NOISE_LSB);
+            raw[i].data[3 + a] = quantize(w[a] / GYRO_RAD_PER_LSB, GYRO_NOISE_LSB);
+        }
+        raw[i].timestamp_us = i * (1000000 / ODR_HZ);
+        for (int a = 0; a < 3; a++) {
+            samples[i * NS_MAHONY_SAMPLE_AXES + a] = raw[i].data[a];
+            samples[i * NS_MAHONY_SAMPLE_AXES + 3 + a] = raw[i].data[3 + a] * GYRO_RAD_PER_LSB;
+        }
+
+        // Attitude at the end of the sample period, what the filter should report
+        for (int s = 0; s < SUBSTEPS; s++) {
+            double h[3] = {0.5 * w[0] * dt, 0.5 * w[1] * dt, 0.5 * w[2] * dt};
+            double n[4] = {q[0] - q[1] * h[0] - q[2] * h[1] - q[3] * h[2],
+                           q[1] + q[0] * h[0] + q[2] * h[2] - q[3] * h[1],
+                           q[2] + q[0] * h[1] - q[1] * h[2] + q[3] * h[0],
+                           q[3] + q[0] * h[2] + q[1] * h[1] - q[2] * h[0]};
+            double norm = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2] + n[3] * n[3]);
+            for (int k = 0; k < 4; k++) {
+                q[k] = n[k] / norm;
+            }
+        }
+        memcpy(truth[i], q, sizeof(q));
+    }
+}
+
+static void init(ns_mahony_cfg_t *cfg) {
+    cfg->api = &ns_mahony_V0_0_1;
+    ns_mahony_init(cfg);
+    cfg->sampleFreq = ODR_HZ;
+}
+
+// Largest component difference, q and -q being the same attitude
+static double q_dist(const ns_mahony_cfg_t *a, const ns_mahony_cfg_t *b) {
+    double dp = 0, dm = 0;
+    const float qa[4] = {a->q0, a->q1, a->q2, a->q3}, qb[4] = {b->q0, b->q1, b->q2, b->q3};
+    for (int k = 0; k < 4; k++) {
+        dp = fmax(dp, fabs(qa[k] - qb[k]));
+        dm = fmax(dm, fabs(qa[k] + qb[k]));
+    }
+    return fmin(dp, dm);
+}
+
+// Rotation angle between the estimate and the truth
+static double track_err(const ns_mahony_cfg_t *c, const double *q) {
+    double dot = fabs(c->q0 * q[0] + c->q1 * q[1] + c->q2 * q[2] + c->q3 * q[3]);
+    double norm = sqrt(c->q0 * c->q0 + c->q1 * c->q1 + c->q2 * c->q2 + c->q3 * c->q3);
+    return 2 * acos(fmin(dot / norm, 1.0)); // acos is steep next to 1, leave out norm error
+}
+
+static double euler_dist(ns_mahony_cfg_t *ref, ns_mahony_cfg_t *c) {
+    double r[3];
+    float f[3];
+    double d = 0;
+    ns_get_RollPitchYaw(ref, &r[0], &r[1], &r[2]);
+    ns_get_RollPitchYaw_f(c, &f[0], &f[1], &f[2]);
+    for (int k = 0; k < 3; k++) {
+        double e = fabs(r[k] - f[k]);
+        d = fmax(d, fmin(e, 2 * M_PI - e)); // yaw and roll wrap at +-pi
+    }
+    return d;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void run_scalar(ns_mahony_cfg_t *c, int first, int n) {
+    for (int i = first; i < first + n; i++) {
+        const float *s = &samples[i * NS_MAHONY_SAMPLE_AXES];
+        ns_mahony_update(c, s[3], s[4], s[5], s[0], s[1], s[2]);
+    }
+}
+
+static void run_float(ns_mahony_cfg_t *c, int first, int n) {
+    ns_mahony_update_batch(c, &samples[first * NS_MAHONY_SAMPLE_AXES], n);
+}
+
+static void run_fixed(ns_mahony_cfg_t *c, int first, int n) {
+    ns_mahony_update_batch_q(
+        c, raw[first].data, n, sizeof(ns_imu_raw_sample_t) / sizeof(int16_t),
+        (float)GYRO_RAD_PER_LSB);
+}
+
+static double time_path(void (*run)(ns_mahony_cfg_t *, int, int)) {
+    ns_mahony_cfg_t c;
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        init(&c);
+        double t0 = now_ns();
+        for (int i = 0; i < SAMPLES; i += WINDOW) {
+            run(&c, i, WINDOW);
+        }
+        best = fmin(best, (now_ns() - t0) / SAMPLES);
+    }
+    return best;
+}
+
+int main(void) {
+    ns_mahony_cfg_t ref, flt, fix;
+    double qErr[2] = {0}, eulerErr[2] = {0}, track[3] = {0};
+
+    synthesize();
+    init(&ref);
+    init(&flt);
+    init(&fix);
+    for (int i = 0; i < SAMPLES; i += WINDOW) {
+        run_scalar(&ref, i, WINDOW);
+        run_float(&flt, i, WINDOW);
+        run_fixed(&fix, i, WINDOW);
+
+        qErr[0] = fmax(qErr[0], q_dist(&ref, &flt));
+        qErr[1] = fmax(qErr[1], q_dist(&ref, &fix));
+        eulerErr[0] = fmax(eulerErr[0], euler_dist(&ref, &flt));
+        eulerErr[1] = fmax(eulerErr[1], euler_dist(&ref, &fix));
+        if (i + WINDOW > SETTLE) {
+            const double *q = truth[i + WINDOW - 1];
+            track[0] = fmax(track[0], track_err(&ref, q));
+            track[1] = fmax(track[1], track_err(&flt, q));
+            track[2] = fmax(track[2], track_err(&fix, q));
+        }
+    }
+    if (qErr[0] > MAX_Q_ERR_FLOAT) {
+        sim_error("float batch quaternion error", qErr[0]);
+    }
+    if (qErr[1] > MAX_Q_ERR_FIXED) {
+        sim_error("fixed-point batch quaternion error", qErr[1]);
+    }
+    for (int k = 0; k < 2; k++) {
+        if (eulerErr[k] > MAX_EULER_ERR) {
+            sim_error(k ? "fixed-point batch euler error" : "float batch euler error", eulerErr[k]);
+        }
+    }
+
+    const double tScalar = time_path(run_scalar);
+    const double tFloat = time_path(run_float);
+    const double tFixed = time_path(run_fixed);
+
+    printf("path\tns/sample\tspeedup\tmax |dq|\tmax d euler\tmax track err (deg)\n");
+    printf("update\t%9.1f\t%6.2fx\t%8s\t%11s\t%8.3f\n", tScalar, 1.0, "-", "-",
+           track[0] * 180 / M_PI);
+    printf("batch\t%9.1f\t%6.2fx\t%8.2e\t%11.2e\t%8.3f\n", tFloat, tScalar / tFloat, qErr[0],
+           eulerErr[0], track[1] * 180 / M_PI);
+    printf("batch_q\t%9.1f\t%6.2fx\t%8.2e\t%11.2e\t%8.3f\n", tFixed, tScalar / tFixed, qErr[1],
+           eulerErr[1], track[2] * 180 / M_PI);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file model_stream_sim.cc
+ * @author Ambiq
+ * @brief Host checks of ns_model_stream's window bookkeeping
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * ns_model_stream.cc is built against the vendored TFLM headers; the interpreter's Invoke and
+ * Reset are stood in for below, so every invoke snapshots the input tensor and then scribbles
+ * over it (TFLM may reuse input tensor memory during Invoke). Checks:
+ *   - windowed mode, data pushed in odd-sized pieces: each invoke sees exactly the last window
+ *     of bytes pushed, every hopsPerInvoke hops once a window is full, and the window moves
+ *     back to the front of the buffer once per (bufferSize - window) / hopBytes hops
+ *   - ns_model_stream_window tracks the last window between invokes
+ *   - streaming mode (buffer == NULL): hops are written straight into the input tensor and each
+ *     invoke sees only the new hops
+ *   - a failed invoke stops the push; reset drops the window and resets the interpreter
+ *   - configuration validation
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ns_core.h"
+#include "ns_model_stream.h"
+
+#define TENSOR_MAX 64
+#define MAX_INVOKES 64
+
+static int errors;
+
+static void fail(const char *what, long got, long want) {
+    if (errors++ < 10) {
+        printf("FAIL %s: got %ld want %ld\n", what, got, want);
+    }
+}
+
+static uint8_t tensorData[TENSOR_MAX];
+static TfLiteTensor tensor;
+static uint8_t snapshots[MAX_INVOKES][TENSOR_MAX];
+static int invokes, resets, failAt = -1;
+
+// Stand-ins for the TFLM library, which is only built for Cortex-M. The interpreter object is
+// never constructed: ns_model_stream only calls these two members through the pointer.
+namespace tflite {
+TfLiteStatus MicroInterpreter::Invoke() {
+    if (invokes == failAt) {
+        return kTfLiteError;
+    }
+    memcpy(snapshots[invokes++], tensorData, tensor.bytes);
+    memset(tensorData, 0xEE, sizeof(tensorData));
+    return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::Reset() {
+    resets++;
+    return kTfLiteOk;
+}
+} // namespace tflite
+
+alignas(16) static uint8_t interpreterStorage[sizeof(tflite::MicroInterpreter)];
+static ns_model_state_t ms;
+static uint8_t input[512];
+
+static void setup_model(uint32_t tensorBytes) {
+    memset(&ms, 0, sizeof(ms));
+    ms.state = READY;
+    ms.numInputTensors = 1;
+    ms.interpreter = reinterpret_cast<tflite::MicroInterpreter *>(interpreterStorage);
+    ms.model_input[0] = &tensor;
+    tensor.bytes = tensorBytes;
+    tensor.data.uint8 = tensorData;
+    invokes = 0;
+    failAt = -1;
+}
+
+// Pushes the first total bytes of input in pieces of 1 to 13 bytes, so pieces straddle
+// hop boundaries in every way
+static void push_input(ns_model_stream_t *s, uint32_t total) {
+    for (uint32_t p = 0; p < total;) {
+        uint32_t n = 1 + (p * 7) % 13;
+        if (p + n > total) {
+            n = total - p;
+        }
+        ns_model_stream_push(s, input + p, n);
+        p += n;
+        const uint8_t *w = ns_model_stream_window(s);
+        if ((s->buffer != NULL) && (p >= s->windowBytes)) {
+            if ((w == NULL) || (w[0] != input[p - s->windowBytes]) || (w[s->windowBytes - 1] !=
+                                                                         input[p - 1])) {
+                fail("window between invokes", p, 0);
+            }
+        } else if (w != NULL) {
+            fail("window before it is full", p, 0);
+        }
+    }
+}
+
+static int outputs;
+static void on_output(ns_model_stream_t *s, void *user) {
+    if (user == &outputs) {
+        outputs++;
+    }
+}
+
+static void check_windowed(void) {
+    static uint8_t buffer[40 + 3 * 8]; // window plus three hops of slack
+    ns_model_stream_t s = {};
+
+    setup_model(40);
+    s.ms = &ms;
+    s.hopBytes = 8;
+    s.hopsPerInvoke = 2;
+    s.buffer = buffer;
+    s.bufferSize = sizeof(buffer);
+    s.onOutput = on_output;
+    s.user = &outputs;
+    outputs = 0;
+    if (ns_model_stream_init(&s) != NS_STATUS_SUCCESS) {
+        fail("windowed init", 1, 0);
+        return;
+    }
+    push_input(&s, 400);
+
+    // First invoke once 40 bytes are in, then every 16 bytes
+    int want = (400 - 40) / 16 + 1;
+    if ((invokes != want) || ((int)s.invokes != want) || (outputs != want)) {
+        fail("windowed invokes", invokes, want);
+    }
+    for (int k = 0; k < invokes; k++) {
+        const uint8_t *expect = input + 16 * k;
+        if (memcmp(snapshots[k], expect, 40) != 0) {
+            fail("windowed invoke input", k, 0);
+        }
+    }
+    // The tail first reaches the end of the buffer at byte 64, then every 24 bytes (3 hops)
+    if (s.moves != 14) {
+        fail("window moves", s.moves, 14);
+    }
+
+    // A failed invoke drops the rest of the push
+    failAt = invokes;
+    if (ns_model_stream_push(&s, input, 64) != (uint32_t)NS_STATUS_FAILURE) {
+        fail("failed invoke reported", 0, 1);
+    }
+    // Reset: no window until a full one is pushed again, and the interpreter state is cleared
+    failAt = -1;
+    resets = 0;
+    if ((ns_model_stream_reset(&s) != NS_STATUS_SUCCESS) || (resets != 1) ||
+        (ns_model_stream_window(&s) != NULL)) {
+        fail("reset", resets, 1);
+    }
+    invokes = 0;
+    push_input(&s, 40);
+    if ((invokes != 1) || (memcmp(snapshots[0], input, 40) != 0)) {
+        fail("first window after reset", invokes, 1);
+    }
+}
+
+static void check_streaming(void) {
+    ns_model_stream_t s = {};
+
+    setup_model(24);
+    s.ms = &ms;
+    s.hopBytes = 8;
+    s.hopsPerInvoke = 3;
+    if (ns_model_stream_init(&s) != NS_STATUS_SUCCESS) {
+        fail("streaming init", 1, 0);
+        return;
+    }
+    push_input(&s, 100);
+    if (invokes != 4) {
+        fail("streaming invokes", invokes, 4);
+    }
+    for (int k = 0; k < invokes; k++) {
+        if (memcmp(snapshots[k], input + 24 * k, 24) != 0) {
+            fail("streaming invoke input", k, 0);
+        }
+    }
+    if (s.moves != 0) {
+        fail("streaming moves", s.moves, 0);
+    }
+}
+
+static void check_config(void) {
+    static uint8_t buffer[48];
+    ns_model_stream_t s = {};
+
+    setup_model(20);
+    s.ms = &ms;
+    s.hopBytes = 8;
+    s.hopsPerInvoke = 3;
+    if (ns_model_stream_init(&s) != NS_STATUS_INVALID_CONFIG) {
+        fail("streaming tensor not hopsPerInvoke hops", 0, 1);
+    }
+    setup_model(44);
+    s.buffer = buffer;
+    s.bufferSize = sizeof(buffer);
+    if (ns_model_stream_init(&s) != NS_STATUS_INVALID_CONFIG) {
+        fail("buffer without a hop of slack", 0, 1);
+    }
+    setup_model(40);
+    if ((ns_model_stream_init(&s) != NS_STATUS_SUCCESS) || (s.hopsPerInvoke != 3)) {
+        fail("valid windowed config", 1, 0);
+    }
+    s.hopsPerInvoke = 0;
+    if ((ns_model_stream_init(&s) != NS_STATUS_SUCCESS) || (s.hopsPerInvoke != 1)) {
+        fail("hopsPerInvoke 0 taken as 1", s.hopsPerInvoke, 1);
+    }
+    s.hopBytes = 0;
+    if (ns_model_stream_init(&s) != NS_STATUS_INVALID_CONFIG) {
+        fail("zero hop accepted", 0, 1);
+    }
+    s.hopBytes = 8;
+    ms.state = NOT_READY;
+    if (ns_model_stream_init(&s) != NS_STATUS_INVALID_CONFIG) {
+        fail("uninitialized model accepted", 0, 1);
+    }
+}
+
+int main(void) {
+    for (uint32_t i = 0; i < sizeof(input); i++) {
+        input[i] = (uint8_t)(i * 13 + 1);
+    }
+    check_windowed();
+    check_streaming();
+    check_config();
+    printf("model stream checks: %s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
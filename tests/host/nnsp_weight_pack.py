@@ -0,0 +1,229 @@
+"""Host check of tools/ns_nnsp_weight_pack.py, the converter to the affine_packed.h tables.
+
+Packed rows are decoded here straight from the layout documented in affine_packed.h, so the
+packer and the C kernels (checked bit-exact against fc_8x16/lstm_8x16 by dsp_bench) have to
+agree on it. A synthetic network definition with an ARM_OPTIMIZED==1 and an ==3 section holding
+the same weights has to come out as identical compressed tables in both sections, with the
+layer functions switched. The nnse definition is converted to check the bytes saved, that by
+default only its output layers are converted, and that the network SNR estimate warns about
+converting every layer.
+
+    cd tests/host && python3 nnsp_weight_pack.py
+"""
+
+import io
+import os
+import random
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "tools"))
+
+import ns_nnsp_weight_pack as wp  # noqa: E402
+
+
+def nib(v):
+    return v - 16 if v & 8 else v
+
+
+def decode_4x16(data, n):
+    s, out = data[0], []
+    for base in range(0, n, 16):
+        h = 8 if n - base >= 16 else (n - base + 1) // 2
+        grp = data[1 + base // 2 :]
+        m = min(16, n - base)
+        out += [s * nib(grp[j] & 15) for j in range(h)]
+        out += [s * nib(grp[j] >> 4) for j in range(m - h)]
+    return out
+
+
+def decode_sparse(data, n):
+    blocks = (n + 7) // 8
+    mask, pos, out = data, (blocks + 7) // 8, []
+    for b in range(blocks):
+        width = min(8, n - 8 * b)
+        if mask[b >> 3] >> (b & 7) & 1:
+            out += [v - 256 if v > 127 else v for v in data[pos : pos + width]]
+            pos += width
+        else:
+            out += [0] * width
+    assert pos == len(data), (pos, len(data))
+    return out
+
+
+def check_rows():
+    data, dq = wp.pack_4x16_row([-16, 14, 0, 2])
+    # s = 2, q = -8 7 0 1: the 4-input tail splits at 2, q0|q2 and q1|q3
+    assert data == bytes([2, 0x08, 0x17]), data.hex()
+    assert dq == [-16, 14, 0, 2]
+
+    rng = random.Random(1)
+    for n in (1, 2, 7, 15, 16, 17, 20, 31, 32, 37, 72, 257):
+        s = rng.randint(1, 15)
+        w = [s * rng.randint(-8, 7) for _ in range(n)]
+        data, dq = wp.pack_4x16_row(w)
+        assert len(data) == wp.row_bytes_4x16(n) == 1 + n // 2 + (n & 1), (n, len(data))
+        assert dq == w, n  # products of a scale and nibbles come back exactly
+        assert decode_4x16(data, n) == w, n
+
+        w = [0 if (k // 8) % 3 == 1 else rng.randint(-128, 127) for k in range(n)]
+        data, dq = wp.pack_sparse_row(w)
+        assert decode_sparse(data, n) == dq == w, n
+        zero_blocks = sum(1 for b in range(0, n, 8) if not any(w[b : b + 8]))
+        assert len(data) == (((n + 7) // 8 + 7) // 8) + n - sum(
+            len(w[b : b + 8]) for b in range(0, n, 8) if not any(w[b : b + 8])
+        ), (n, zero_blocks)
+
+    data, dq = wp.pack_sparse_row([1, -2, 0, 1] * 4, prune=2)
+    assert data == bytes([0]) and dq == [0] * 16
+
+    # Rows that are not s * q pick the scale with the smallest squared error
+    w = [rng.randint(-128, 127) for _ in range(64)]
+    _, dq = wp.pack_4x16_row(w)
+    err = sum((a - b) ** 2 for a, b in zip(w, dq))
+    for s in range(1, 40):
+        q = [max(-8, min(7, round(v / s))) for v in w]
+        assert err <= sum((a - s * b) ** 2 for a, b in zip(w, q)), s
+    print("rows: ok")
+
+
+def check_interleave():
+    rng = random.Random(2)
+    for units, gates, n in ((6, 4, 21), (7, 1, 37), (4, 1, 8), (1, 4, 3)):
+        rows = [[rng.randint(-128, 127) for _ in range(n)] for _ in range(units * gates)]
+        flat = wp.interleave_m4(rows, units, gates)
+        assert len(flat) == units * gates * n
+        assert wp.deinterleave_m4(flat, units, gates, n) == rows, (units, gates, n)
+    # Two rows, two inputs: r0[0] r1[0] r0[1] r1[1]
+    assert wp.interleave_m4([[1, 2], [3, 4]], 2, 1) == [1, 3, 2, 4]
+    print("interleave: ok")
+
+
+def c_array(name, values):
+    return f"const int8_t {name}[] = {{" + ",".join(str(v) for v in values) + ",};\n"
+
+
+def net_section(arm_optimized, kernels):
+    """A two layer network (fc 21->6, lstm 6->5) in the NeuralNetClass layout of def_nn*.c."""
+    text = f"#{'if' if arm_optimized == 1 else 'elif'} ARM_OPTIMIZED=={arm_optimized}\n"
+    text += '#include <stdint.h>\n#include "neural_nets.h"\n#include "affine.h"\n'
+    for name, values in kernels.items():
+        text += c_array(name, values)
+    text += """NeuralNetClass net = {
+    2, // layers
+    {21, 6, 5,}, // nn size for each layer, including the input layer
+    {fc, lstm,}, // layer type
+    {5, 6,}, // fractional bits (kernel)
+    {8, 15,}, // qbit_i
+    {13, 14,}, // fractional bits (bias)
+    {ftanh, ftanh,}, // activations
+    {(int32_t*) 0, (int32_t*) cstate,}, // cstates lstm
+    {(int16_t*) 0, (int16_t*) hstate,}, // hstates lstm
+    {(void* (*)(void*, int32_t*, int)) &tanh_fix, (void* (*)(void*, int32_t*, int)) &tanh_fix,},
+    {(int* (*)()) &fc_8x16, (int* (*)()) &lstm_8x16,}, // net layer type
+    {(int8_t*) k0, (int8_t*) k1,}, // kernel
+    {(int16_t*) b0, (int16_t*) b1,}, // bias
+    {(int8_t*) 0, (int8_t*) k_rec1,}, // kernel_rec
+};
+"""
+    return text
+
+
+def tables(text):
+    return {
+        m.group("name"): bytes(int(v, 0) & 0xFF for v in m.group("body").split(",") if v.strip())
+        for m in wp._ARRAY.finditer(text)
+    }
+
+
+def check_definition():
+    rng = random.Random(3)
+
+    def rows(count, n):
+        out = []
+        for _ in range(count):
+            s = rng.randint(1, 15)
+            out.append([s * rng.randint(-8, 7) for _ in range(n)])
+        return out
+
+    dense = {"k0": (rows(6, 21), 6, 1), "k1": (rows(20, 6), 5, 4), "k_rec1": (rows(20, 5), 5, 4)}
+    flat = {k: [v for r in w for v in r] for k, (w, _, _) in dense.items()}
+    m4 = {k: wp.interleave_m4(w, units, gates) for k, (w, units, gates) in dense.items()}
+    text = net_section(1, m4) + net_section(3, flat) + "#endif\n"
+
+    out, reports = wp.convert(text, layers="all")
+    assert [a for a, _, _ in reports] == [1, 3]
+    sec1, sec3 = out.split("#elif")
+    t1, t3 = tables(sec1), tables(sec3)
+    assert t1 == t3 and set(t1) == set(dense), "sections differ"
+    for name, (w, _, _) in dense.items():
+        n = len(w[0])
+        rb = wp.row_bytes_4x16(n)
+        got = [decode_4x16(t1[name][r * rb : (r + 1) * rb], n) for r in range(len(w))]
+        assert got == w and len(t1[name]) == rb * len(w), name
+    for sec in (sec1, sec3):
+        assert sec.count('#include "affine_packed.h"') == 1
+        assert "&fc_4x16" in sec and "&lstm_4x16" in sec and "_8x16" not in sec
+        assert "const uint8_t k0[]" in sec
+    for _, r, _ in reports:
+        assert all(row["weight_snr"] == float("inf") for row in r), r
+
+    # No layers after the LSTM: the default converts nothing
+    out, reports = wp.convert(text)
+    assert out == text and reports == []
+
+    # Only the LSTM layer: fc keeps its int8 table and function
+    out, reports = wp.convert(text, fmt="sparse", layers={1})
+    sec1, sec3 = out.split("#elif")
+    t1, t3 = tables(sec1), tables(sec3)
+    assert t1["k1"] == t3["k1"] and t1["k_rec1"] == t3["k_rec1"]
+    assert t1["k0"] == bytes(v & 0xFF for v in m4["k0"])
+    assert "&fc_8x16" in sec1 and "&lstm_sparse_8x16" in sec1 and "&lstm_8x16" not in sec1
+    assert [row["table"] for row in reports[0][1]] == ["k1", "k_rec1"]
+
+    # Converting an already converted layer is refused
+    try:
+        wp.convert(wp.convert(text, layers="all")[0], layers="all")
+        raise AssertionError("converted twice")
+    except ValueError:
+        pass
+    print("definition: ok")
+
+
+def check_nnse():
+    path = os.path.join(HERE, "..", "..", "apps", "demos", "nnse", "src", "def_nn3_se.c")
+    with open(path, newline="") as f:
+        text = f.read()
+    out, reports = wp.convert(text, layers="all")
+    report = io.StringIO()
+    wp.print_report(reports, report)
+    assert [a for a, _, _ in reports] == [1, 3]
+    for arm_optimized, r, snr in reports:
+        int8 = sum(row["int8"] for row in r)
+        packed = sum(row["packed"] for row in r)
+        assert packed <= 0.52 * int8, (arm_optimized, packed, int8)
+        assert all(row["weight_snr"] > 12 for row in r), report.getvalue()
+        assert snr < wp.NETWORK_SNR_WARN_DB, (arm_optimized, snr)
+    assert len(re.findall(r"\b(fc|lstm)_4x16\b", out)) == 9
+    print(report.getvalue(), end="")
+
+    # Default: the fc layers after the LSTM, 2 and 3 of ==1, 2 to 4 of ==3
+    out, reports = wp.convert(text)
+    tables = [[row["table"] for row in r] for _, r, _ in reports]
+    assert tables == [
+        ["se_kernel2", "se_kernel3"],
+        ["se_kernel2", "se_kernel3", "se_kernel4"],
+    ], tables
+    assert all(snr >= wp.NETWORK_SNR_WARN_DB for _, _, snr in reports), reports
+    assert len(re.findall(r"\b(fc|lstm)_4x16\b", out)) == 5
+    assert len(re.findall(r"\b(fc|lstm)_8x16\b", out)) == 4
+    print("nnse: ok")
+
+
+if __name__ == "__main__":
+    check_rows()
+    check_interleave()
+    check_definition()
+    check_nnse()
+    print("weight pack checks: ok")
@@ -0,0 +1,233 @@
+/**
+ * @file pdm_repack_bench.c
+ * @author Ambiq
+ * @brief Host bit-exactness check and benchmark of the PDM DMA word to PCM conversion
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Feeds synthetic PDM DMA frames (a tone over a DC offset and noise, packed the way the
+ * Apollo4/Apollo5 24-bit and Apollo330 16-bit PDM engines deliver them, plus full scale words
+ * that force saturation) through ns_audio_pdm_repack and checks:
+ *   - unity gain, no DC removal: identical to the byte-by-byte loop the PDM ISRs used to run
+ *   - gain, DC removal and de-interleaving: identical to an independent per-sample reference,
+ *     frame after frame, including the DC tracking state
+ *   - in-place conversion over the DMA buffer and frame lengths that leave a vector tail
+ * then times a 10ms frame both ways.
+ *
+ * On the host the scalar path runs; the Helium path computes the same integer expression and
+ * is covered on the EVB by the same vectors.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ns_audio_pdm_repack.h"
+
+#define SAMPLE_RATE 16000
+#define FRAME_SAMPLES 160 // 10ms
+#define FRAMES 50
+#define MAX_CH 2
+#define REPEATS 2000
+
+static uint32_t dma[FRAMES][FRAME_SAMPLES * MAX_CH];
+static int16_t out[FRAME_SAMPLES * MAX_CH];
+static int16_t ref[FRAME_SAMPLES * MAX_CH];
+static int errors;
+
+static void check(int ok, const char *what, int frame, int idx, int got, int want) {
+    if (!ok && errors++ < 10) {
+        printf("FAIL %s: frame %d sample %d got %d want %d\n", what, frame, idx, got, want);
+    }
+}
+
+static uint32_t rng = 0x1234567u;
+static uint32_t next_rand(void) {
+    rng = rng * 1664525u + 1013904223u;
+    return rng;
+}
+
+// Packs a 16-bit sample the way the DMA engine does, with junk in the bits the driver ignores
+static uint32_t pack(int16_t s, int shift) {
+    uint32_t junk = next_rand();
+    uint32_t mask = 0xFFFFu << shift;
+    return ((uint32_t)(uint16_t)s << shift) | (junk & ~mask);
+}
+
+static void make_frames(int channels, int shift) {
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            double t = (double)(f * FRAME_SAMPLES + i) / SAMPLE_RATE;
+            for (int c = 0; c < channels; c++) {
+                double v = 9000.0 * sin(2 * M_PI * (440.0 + 300 * c) * t) + 1500.0 * (c + 1) +
+                           (double)((int32_t)(next_rand() >> 20) - 2048);
+                int16_t s = (int16_t)v;
+                // Sprinkle full scale samples so gain has something to saturate
+                if ((i % 37) == 5) {
+                    s = (i & 64) ? INT16_MAX : INT16_MIN;
+                }
+                dma[f][i * channels + c] = pack(s, shift);
+            }
+        }
+    }
+}
+
+// The conversion the PDM ISRs did before ns_audio_pdm_repack existed
+static void legacy_repack(const uint32_t *words, int16_t *pcm, uint32_t count, int shift) {
+    uint8_t *temp1 = (uint8_t *)pcm;
+    for (uint32_t i = 0; i < count; i++) {
+        if (shift == NS_AUDIO_PDM_SHIFT_24BIT) {
+            temp1[2 * i] = (words[i] & 0xFF00) >> 8U;
+            temp1[2 * i + 1] = (words[i] & 0xFF0000) >> 16U;
+        } else {
+            temp1[2 * i] = (words[i] & 0xFF);
+            temp1[2 * i + 1] = (words[i] & 0xFF00) >> 8U;
+        }
+    }
+}
+
+// Independent statement of the conversion documented in ns_audio_pdm_repack.h
+typedef struct {
+    int channels, shift, dcShift, deinterleave;
+    int gain[2];
+    long long dc[2];
+} ref_state_t;
+
+static void ref_repack(ref_state_t *s, const uint32_t *words, int16_t *pcm, int n) {
+    long long sums[2] = {0, 0};
+    long long dcv[2];
+    for (int c = 0; c < s->channels; c++) {
+        dcv[c] = s->dcShift ? (long long)floor(s->dc[c] / 256.0) : 0;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int c = 0; c < s->channels; c++) {
+            int16_t x = (int16_t)(uint16_t)(words[i * s->channels + c] >> s->shift);
+            long long y = (long long)floor((double)((x - dcv[c]) * s->gain[c]) / 256.0);
+            y = y > 32767 ? 32767 : (y < -32768 ? -32768 : y);
+            pcm[s->deinterleave ? c * n + i : i * s->channels + c] = (int16_t)y;
+            sums[c] += x;
+        }
+    }
+    if (s->dcShift) {
+        for (int c = 0; c < s->channels; c++) {
+            long long mean = sums[c] * 256 / n; // C division truncates, as in the driver
+            s->dc[c] += (long long)floor((double)(mean - s->dc[c]) / (1 << s->dcShift));
+        }
+    }
+}
+
+static void check_legacy(int channels, int shift, int n) {
+    ns_audio_pdm_repack_t r;
+    ns_audio_pdm_repack_init(&r, channels, shift);
+    make_frames(channels, shift);
+    for (int f = 0; f < FRAMES; f++) {
+        legacy_repack(dma[f], ref, n * channels, shift);
+        ns_audio_pdm_repack(&r, dma[f], out, n);
+        for (int i = 0; i < n * channels; i++) {
+            check(out[i] == ref[i], "legacy", f, i, out[i], ref[i]);
+        }
+    }
+}
+
+static void check_fused(int channels, int shift, int n, int gainL, int gainR, int dcShift,
+                        int deinterleave, int inPlace) {
+    static uint32_t work[FRAME_SAMPLES * MAX_CH];
+    ns_audio_pdm_repack_t r;
+    ref_state_t s = {channels, shift, dcShift, deinterleave, {gainL, gainR}, {0, 0}};
+
+    ns_audio_pdm_repack_init(&r, channels, shift);
+    r.gain[0] = gainL;
+    r.gain[1] = gainR;
+    r.dcShift = dcShift;
+    r.deinterleave = deinterleave;
+    make_frames(channels, shift);
+    for (int f = 0; f < FRAMES; f++) {
+        int16_t *dst = out;
+        ref_repack(&s, dma[f], ref, n);
+        if (inPlace) {
+            memcpy(work, dma[f], sizeof(uint32_t) * n * channels);
+            dst = (int16_t *)work;
+            ns_audio_pdm_repack(&r, work, dst, n);
+        } else {
+            ns_audio_pdm_repack(&r, dma[f], dst, n);
+        }
+        for (int i = 0; i < n * channels; i++) {
+            check(dst[i] == ref[i], "fused", f, i, dst[i], ref[i]);
+        }
+        for (int c = 0; c < channels; c++) {
+            check(r.dc[c] == s.dc[c], "dc state", f, c, r.dc[c], (int)s.dc[c]);
+        }
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int16_t sink;
+
+static void bench(int channels) {
+    ns_audio_pdm_repack_t plain, fused;
+    double best_legacy = 1e30, best_plain = 1e30, best_fused = 1e30;
+
+    make_frames(channels, NS_AUDIO_PDM_SHIFT_24BIT);
+    ns_audio_pdm_repack_init(&plain, channels, NS_AUDIO_PDM_SHIFT_24BIT);
+    ns_audio_pdm_repack_init(&fused, channels, NS_AUDIO_PDM_SHIFT_24BIT);
+    fused.gain[0] = fused.gain[1] = 3 * NS_AUDIO_PDM_GAIN_UNITY / 2;
+    fused.dcShift = 3;
+    fused.deinterleave = (channels == 2);
+
+    for (int pass = 0; pass < 5; pass++) {
+        double t0 = now_ns();
+        for (int k = 0; k < REPEATS; k++) {
+            legacy_repack(dma[k % FRAMES], out, FRAME_SAMPLES * channels, 8);
+            sink = out[k % FRAME_SAMPLES];
+        }
+        double t1 = now_ns();
+        for (int k = 0; k < REPEATS; k++) {
+            ns_audio_pdm_repack(&plain, dma[k % FRAMES], out, FRAME_SAMPLES);
+            sink = out[k % FRAME_SAMPLES];
+        }
+        double t2 = now_ns();
+        for (int k = 0; k < REPEATS; k++) {
+            ns_audio_pdm_repack(&fused, dma[k % FRAMES], out, FRAME_SAMPLES);
+            sink = out[k % FRAME_SAMPLES];
+        }
+        double t3 = now_ns();
+        best_legacy = fmin(best_legacy, (t1 - t0) / REPEATS);
+        best_plain = fmin(best_plain, (t2 - t1) / REPEATS);
+        best_fused = fmin(best_fused, (t3 - t2) / REPEATS);
+    }
+    printf("%s 10ms frame: legacy byte loop %7.0f ns, repack %7.0f ns, "
+           "repack+gain+dc%s %7.0f ns\n",
+           channels == 1 ? "mono  " : "stereo", best_legacy, best_plain,
+           channels == 2 ? "+deinterleave" : "", best_fused);
+}
+
+int main(void) {
+    static const int lengths[] = {FRAME_SAMPLES, FRAME_SAMPLES - 1, 3, 1};
+
+    for (int ch = 1; ch <= MAX_CH; ch++) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            int n = lengths[l];
+            check_legacy(ch, NS_AUDIO_PDM_SHIFT_24BIT, n);
+            check_legacy(ch, NS_AUDIO_PDM_SHIFT_16BIT, n);
+            check_fused(ch, NS_AUDIO_PDM_SHIFT_24BIT, n, 640, 200, 2, 0, 0);
+            check_fused(ch, NS_AUDIO_PDM_SHIFT_16BIT, n, 256, 1000, 4, ch == 2, 0);
+            check_fused(ch, NS_AUDIO_PDM_SHIFT_24BIT, n, 32767, -300, 1, 0, 1);
+            check_fused(ch, NS_AUDIO_PDM_SHIFT_24BIT, n, 90, 256, 0, ch == 2, 0);
+        }
+    }
+    printf("bit-exact checks: %s\n", errors ? "FAILED" : "ok");
+
+    bench(1);
+    bench(2);
+    return errors ? 1 : 0;
+}
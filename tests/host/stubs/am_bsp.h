@@ -0,0 +1,5 @@
+// Host build stand-in for the AmbiqSuite BSP header
+#pragma once
+#include <stdbool.h>
+#include <stdio.h>
+#define am_util_stdio_printf printf
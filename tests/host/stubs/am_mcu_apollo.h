@@ -0,0 +1,25 @@
+// Host build stand-in for the AmbiqSuite MCU header
+#pragma once
+#include <stdint.h>
+
+// Interrupt masking and sleep, implemented by the host program that needs them
+#define AM_HAL_STATUS_SUCCESS 0
+#define AM_HAL_SYSCTRL_SLEEP_NORMAL 0
+uint32_t am_hal_interrupt_master_disable(void);
+uint32_t am_hal_interrupt_master_enable(void);
+void am_hal_interrupt_master_set(uint32_t state);
+void am_hal_sysctrl_sleep(uint32_t mode);
+#define AM_CRITICAL_BEGIN uint32_t ui32Primask = am_hal_interrupt_master_disable()
+#define AM_CRITICAL_END am_hal_interrupt_master_set(ui32Primask)
+
+// Audio HAL types referenced by ns_audio.h; there is no PDM or AUDADC on the host
+typedef enum {
+    AM_HAL_PDM_GAIN_M120DB = 0x00,
+    AM_HAL_PDM_GAIN_P345DB = 0x1F,
+} am_hal_pdm_gain_e;
+typedef struct {
+    uint32_t ui32TargetAddr;
+    uint32_t ui32TargetAddrReverse;
+    uint32_t ui32TotalCount;
+} am_hal_pdm_transfer_t;
+typedef void am_hal_offset_cal_coeffs_array_t;
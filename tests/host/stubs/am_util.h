@@ -0,0 +1,2 @@
+// Host build stand-in for the AmbiqSuite utilities header
+#pragma once
@@ -0,0 +1,198 @@
+/**
+ * @file arm_math_host.c
+ * @author Ambiq
+ * @brief CMSIS-DSP transforms for the host library build
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * CMSIS-DSP ships as prebuilt Cortex-M libraries, so the host build provides the transforms
+ * neuralSPOT calls (arm_rfft_q31, arm_rfft_fast_f32, arm_cfft_f32) as a double precision
+ * radix-2 FFT following CMSIS scaling and layout:
+ *
+ *  - arm_rfft_q31 forward returns DFT / N as N complex values (the upper half the conjugate of
+ *    the lower), inverse reads bins 0..N/2 and returns the IDFT
+ *  - arm_rfft_fast_f32 packs X(0) and X(N/2) real parts in the first complex slot
+ *  - arm_cfft_f32 is in place, inverse scaled by 1/N, and leaves the output bit reversed
+ *    when bitReverseFlag is 0
+ *
+ * Results are rounded rather than truncated stage by stage, so they are close to, not bit
+ * exact with, the device library; the host benchmarks check these paths against tolerances.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <math.h>
+
+#include "arm_math.h"
+
+#define HOST_FFT_MAX 8192
+
+static double g_re[HOST_FFT_MAX], g_im[HOST_FFT_MAX];
+static double g_cos[HOST_FFT_MAX / 2], g_sin[HOST_FFT_MAX / 2];
+static uint32_t g_twiddleLen; // g_cos/g_sin hold the twiddles of this size
+
+static int host_is_pow2(uint32_t n) { return (n >= 2) && (n <= HOST_FFT_MAX) && !(n & (n - 1)); }
+
+static uint32_t host_bit_reverse(uint32_t i, uint32_t n) {
+    uint32_t r = 0;
+    for (uint32_t b = n >> 1; b; b >>= 1, i >>= 1) {
+        r = (r << 1) | (i & 1);
+    }
+    return r;
+}
+
+// Twiddles for the largest size seen, smaller sizes stride through them
+static void host_twiddles(uint32_t n) {
+    if (n <= g_twiddleLen) {
+        return;
+    }
+    for (uint32_t k = 0; k < n / 2; k++) {
+        g_cos[k] = cos(2 * M_PI * k / n);
+        g_sin[k] = sin(2 * M_PI * k / n);
+    }
+    g_twiddleLen = n;
+}
+
+// In place on g_re/g_im, natural order in and out, unscaled
+static void host_fft(uint32_t n, int inverse) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = host_bit_reverse(i, n);
+        if (j > i) {
+            double t = g_re[i];
+            g_re[i] = g_re[j];
+            g_re[j] = t;
+            t = g_im[i];
+            g_im[i] = g_im[j];
+            g_im[j] = t;
+        }
+    }
+    const double sign = inverse ? 1.0 : -1.0;
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        const uint32_t stride = g_twiddleLen / len;
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                const double wr = g_cos[k * stride], wi = sign * g_sin[k * stride];
+                const uint32_t a = i + k, b = i + k + len / 2;
+                const double tr = g_re[b] * wr - g_im[b] * wi;
+                const double ti = g_re[b] * wi + g_im[b] * wr;
+                g_re[b] = g_re[a] - tr;
+                g_im[b] = g_im[a] - ti;
+                g_re[a] += tr;
+                g_im[a] += ti;
+            }
+        }
+    }
+}
+
+static q31_t host_sat_q31(double v) {
+    v = round(v);
+    return (q31_t)(v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : v));
+}
+
+arm_status arm_rfft_init_q31(
+    arm_rfft_instance_q31 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag) {
+    if (!host_is_pow2(fftLenReal)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLenReal = fftLenReal;
+    S->ifftFlagR = (uint8_t)ifftFlagR;
+    S->bitReverseFlagR = (uint8_t)bitReverseFlag;
+    host_twiddles(fftLenReal);
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst) {
+    const uint32_t n = S->fftLenReal;
+    if (S->ifftFlagR) {
+        for (uint32_t k = 0; k <= n / 2; k++) {
+            g_re[k] = pSrc[2 * k];
+            g_im[k] = (k == 0 || k == n / 2) ? 0 : pSrc[2 * k + 1];
+        }
+        for (uint32_t k = n / 2 + 1; k < n; k++) {
+            g_re[k] = g_re[n - k];
+            g_im[k] = -g_im[n - k];
+        }
+        host_fft(n, 1);
+        for (uint32_t i = 0; i < n; i++) {
+            pDst[i] = host_sat_q31(g_re[i] / n);
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            g_re[i] = pSrc[i];
+            g_im[i] = 0;
+        }
+        host_fft(n, 0);
+        for (uint32_t k = 0; k < n; k++) {
+            pDst[2 * k] = host_sat_q31(g_re[k] / n);
+            pDst[2 * k + 1] = host_sat_q31(g_im[k] / n);
+        }
+    }
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen) {
+    if (!host_is_pow2(fftLen)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLenRFFT = fftLen;
+    S->Sint.fftLen = fftLen / 2;
+    host_twiddles(fftLen);
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_rfft_fast_f32(
+    const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag) {
+    const uint32_t n = S->fftLenRFFT;
+    if (ifftFlag) {
+        g_re[0] = p[0];
+        g_im[0] = 0;
+        g_re[n / 2] = p[1];
+        g_im[n / 2] = 0;
+        for (uint32_t k = 1; k < n / 2; k++) {
+            g_re[k] = g_re[n - k] = p[2 * k];
+            g_im[k] = p[2 * k + 1];
+            g_im[n - k] = -p[2 * k + 1];
+        }
+        host_fft(n, 1);
+        for (uint32_t i = 0; i < n; i++) {
+            pOut[i] = (float32_t)(g_re[i] / n);
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            g_re[i] = p[i];
+            g_im[i] = 0;
+        }
+        host_fft(n, 0);
+        pOut[0] = (float32_t)g_re[0];
+        pOut[1] = (float32_t)g_re[n / 2];
+        for (uint32_t k = 1; k < n / 2; k++) {
+            pOut[2 * k] = (float32_t)g_re[k];
+            pOut[2 * k + 1] = (float32_t)g_im[k];
+        }
+    }
+}
+
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32 *S, uint16_t fftLen) {
+    if (!host_is_pow2(fftLen)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLen = fftLen;
+    host_twiddles(fftLen);
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_cfft_f32(
+    const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    const uint32_t n = S->fftLen;
+    for (uint32_t i = 0; i < n; i++) {
+        g_re[i] = p1[2 * i];
+        g_im[i] = p1[2 * i + 1];
+    }
+    host_fft(n, ifftFlag);
+    const double scale = ifftFlag ? 1.0 / n : 1.0;
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t o = bitReverseFlag ? i : host_bit_reverse(i, n);
+        p1[2 * o] = (float32_t)(g_re[i] * scale);
+        p1[2 * o + 1] = (float32_t)(g_im[i] * scale);
+    }
+}
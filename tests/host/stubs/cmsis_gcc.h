@@ -0,0 +1,4 @@
+// Host build stand-in for the CMSIS-Core GCC header: with __GNUC_PYTHON__ defined, CMSIS-DSP
+// supplies portable C versions of the SIMD intrinsics (__SMLALD, __SXTB16, ...)
+#pragma once
+#include "arm_math.h"
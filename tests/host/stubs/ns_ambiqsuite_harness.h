@@ -0,0 +1,12 @@
+// Host build stand-in for ns-harness: printing goes to stdout
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#define ns_lp_printf printf
+#define ns_printf printf
+#define ns_interrupt_master_enable am_hal_interrupt_master_enable
+#define ns_interrupt_master_disable am_hal_interrupt_master_disable
+
+// Implemented by the host program that needs it (e.g. on a simulated clock)
+void ns_delay_us(uint32_t us);
@@ -0,0 +1,86 @@
+/**
+ * @file ns_host_shim.c
+ * @author Ambiq
+ * @brief AmbiqSuite and ns-utils platform functions for the host library build
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Linked into libneuralspot_host.a next to the portable neuralSPOT sources: interrupt masking
+ * is a flag (host programs are single threaded), delays sleep, and ns_timer's platform layer
+ * counts microseconds on CLOCK_MONOTONIC. Timers that interrupt aren't available here, and
+ * neither is the PDM driver, so ns_audio only has its file replay source.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <time.h>
+
+#include "am_mcu_apollo.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_audio.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+
+static uint32_t g_masked;
+static uint64_t g_timerStart[NS_TIMER_TEMPCO + 1];
+
+uint32_t am_hal_interrupt_master_disable(void) {
+    uint32_t was = g_masked;
+    g_masked = 1;
+    return was;
+}
+
+uint32_t am_hal_interrupt_master_enable(void) {
+    uint32_t was = g_masked;
+    g_masked = 0;
+    return was;
+}
+
+void am_hal_interrupt_master_set(uint32_t state) { g_masked = state; }
+
+void am_hal_sysctrl_sleep(uint32_t mode) {}
+
+static uint64_t host_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void ns_delay_us(uint32_t us) {
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+uint32_t ns_timer_platform_init(ns_timer_config_t *cfg) {
+    if (cfg->enableInterrupt) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    g_timerStart[cfg->timer] = host_now_us();
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_us_ticker_read(ns_timer_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return 0xDEADBEEF;
+    }
+#endif
+    return (uint32_t)(host_now_us() - g_timerStart[cfg->timer]);
+}
+
+uint32_t ns_timer_clear(ns_timer_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    g_timerStart[cfg->timer] = host_now_us();
+    return NS_STATUS_SUCCESS;
+}
+
+ns_pdm_cfg_t ns_pdm_default;
+
+uint32_t pdm_init(ns_audio_config_t *config) { return NS_STATUS_INIT_FAILED; }
+
+void pdm_deinit(ns_audio_config_t *config) {}
@@ -0,0 +1,24 @@
+// Host build stand-in for TinyUSB: the CDC and vendor device calls ns-usb makes, implemented by
+// the host program (e.g. a simulated USB host feeding the CDC FIFO)
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+bool tusb_init(void);
+void tud_task(void);
+uint32_t tud_cdc_available(void);
+uint32_t tud_cdc_read(void *buffer, uint32_t bufsize);
+void tud_cdc_read_flush(void);
+uint32_t tud_cdc_write(void const *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_vendor_available(void);
+uint32_t tud_vendor_read(void *buffer, uint32_t bufsize);
+void tud_vendor_read_flush(void);
+uint32_t tud_vendor_write(void const *buffer, uint32_t bufsize);
+uint32_t tud_vendor_write_flush(void);
+uint32_t tud_vendor_write_available(void);
+
+// Callbacks ns-usb implements
+void tud_cdc_rx_cb(uint8_t itf);
+void tud_cdc_tx_complete_cb(uint8_t itf);
@@ -0,0 +1,102 @@
+"""Host check of tools/ns_trace_export.py against the dump trace_ring_sim writes.
+
+trace_ring_sim records an instrumented ns_pipeline run and dumps it to trace_ring_sim.log. The
+exported Chrome trace has to hold every event with balanced spans per thread and increasing
+timestamps. Synthetic dumps check timestamp unwrapping, track naming, unmatched span ends left
+over from a wrapped ring, and several dumps in one log.
+
+    make -C tests/host trace_ring_sim && (cd tests/host && ./trace_ring_sim && python3 trace_export.py)
+"""
+
+import json
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "tools"))
+
+import ns_trace_export  # noqa: E402
+
+
+def events(trace):
+    return [e for e in trace["traceEvents"] if e["ph"] != "M"]
+
+
+def check_balanced(trace):
+    stacks = {}
+    last = None
+    for e in events(trace):
+        assert last is None or e["ts"] >= last, f"timestamps go back at {e}"
+        last = e["ts"]
+        stack = stacks.setdefault(e["tid"], [])
+        if e["ph"] == "B":
+            stack.append(e["name"])
+        elif e["ph"] == "E":
+            assert stack, f"unmatched end {e}"
+            stack.pop()
+    assert all(not s for s in stacks.values()), f"unclosed spans {stacks}"
+
+
+def check_pipeline_dump():
+    path = os.path.join(HERE, "trace_ring_sim.log")
+    with open(path) as f:
+        lines = f.readlines()
+    recorded = sum(1 for line in lines if line.startswith("#NST "))
+    trace = ns_trace_export.to_chrome(ns_trace_export.parse_dumps(lines))
+    evs = events(trace)
+    assert len(evs) == recorded, (len(evs), recorded)
+    check_balanced(trace)
+    names = {e["name"] for e in evs if e["ph"] == "B"}
+    assert names == {"pipeline_frame", "halve", "sum"}, names
+    assert any(e["ph"] == "C" and e["name"] == "pipeline_queue" for e in evs)
+    assert any(e["ph"] == "i" and e["s"] == "t" for e in evs)
+    threads = [e for e in trace["traceEvents"] if e["name"] == "thread_name"]
+    assert [t["args"]["name"] for t in threads] == ["task 0"], threads
+
+    out = os.path.join(HERE, "trace_ring_sim.json")
+    ns_trace_export.main([path, "-o", out])
+    with open(out) as f:
+        assert json.load(f) == trace
+    print(f"pipeline dump: {len(evs)} events exported")
+
+
+def check_synthetic():
+    log = [
+        "boot banner\n",
+        "#NST-BEGIN ticks_per_us=100 events=6 lost=9\n",
+        "#NST 4294967000 E 128 0 overwritten_begin\n",  # its begin fell out of the ring
+        "#NST 4294967100 B 17 0 pdm_isr\n",
+        "[app] #NST 4294967196 E 17 0 pdm_isr\n",  # prefixed by other output, still parsed
+        "#NST 100 B 128 7 inference\n",  # the 32-bit timestamp wrapped
+        "#NST 300 C 128 42 queue\n",
+        "#NST 500 i 15 3 tick\n",
+        "#NST-END\n",
+        "#NST 999 B 128 0 outside_a_dump\n",
+        "#NST-BEGIN ticks_per_us=1 events=1 lost=0\n",
+        "#NST 5 i 128 0 second_dump\n",
+        "#NST-END\n",
+    ]
+    trace = ns_trace_export.to_chrome(ns_trace_export.parse_dumps(log))
+    evs = events(trace)
+    check_balanced(trace)
+    by_name = {e["name"]: e for e in evs if e["ph"] != "E"}
+    assert all(e["name"] not in ("overwritten_begin", "outside_a_dump") for e in evs)
+    # Time zero is the dump's earliest stamp, 4294967000, at 100 ticks per microsecond
+    assert by_name["pdm_isr"]["ts"] == 1.0 and by_name["pdm_isr"]["tid"] == 17
+    assert abs(by_name["inference"]["ts"] - 3.96) < 1e-9, by_name["inference"]
+    assert by_name["inference"]["args"] == {"value": 7}
+    assert by_name["queue"]["args"] == {"queue": 42}
+    # inference never ended: closed at the end of its dump
+    closing = [e for e in evs if e["ph"] == "E" and e["name"] == "inference"]
+    assert len(closing) == 1 and closing[0]["ts"] == by_name["tick"]["ts"]
+    assert by_name["second_dump"]["ts"] > by_name["tick"]["ts"]
+    threads = [e for e in trace["traceEvents"] if e["name"] == "thread_name"]
+    names = {e["tid"]: e["args"]["name"] for e in threads}
+    assert names == {15: "SysTick", 17: "IRQ 1", 128: "task 0"}, names
+    print("synthetic dumps: ok")
+
+
+if __name__ == "__main__":
+    check_pipeline_dump()
+    check_synthetic()
+    print("trace export checks: ok")
@@ -0,0 +1,293 @@
+/**
+ * @file trace_ring_sim.c
+ * @author Ambiq
+ * @brief Host check and benchmark of the ns_trace event ring
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Checks:
+ *   - a full NS_TRACE_RING keeps the latest events, oldest first, and reports the rest as lost
+ *   - a full NS_TRACE_ONESHOT keeps the first events and counts the drops; nothing is recorded
+ *     while tracing is paused
+ *   - several threads (tracks) recording concurrently: every event read back is intact
+ *   - an instrumented ns_pipeline (built with NS_TRACE) emits balanced frame and stage spans,
+ *     dumped to trace_ring_sim.log for trace_export.py to convert
+ * then times ns_trace_begin/ns_trace_end pairs.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ns_pipeline.h"
+#include "ns_trace.h"
+
+#define THREADS 3
+#define PER_THREAD 100000
+#define REPEATS 1000000
+
+static int errors;
+
+static void fail(const char *what, long got, long want) {
+    if (errors++ < 10) {
+        printf("FAIL %s: got %ld want %ld\n", what, got, want);
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static ns_trace_event_t ring[256];
+static ns_trace_event_t snapshot[256];
+
+static void check_ring(void) {
+    static const char *names[] = {"even", "odd"};
+    ns_trace_config_t cfg = {.api = &ns_trace_V1_0_0, .events = ring, .size = 16,
+                             .mode = NS_TRACE_RING};
+    if (ns_trace_init(&cfg) != NS_STATUS_SUCCESS) {
+        fail("init", 1, 0);
+        return;
+    }
+    for (int i = 0; i < 40; i++) {
+        ns_trace_instant(names[i & 1], i);
+    }
+    uint32_t n = ns_trace_read(snapshot, 256);
+    if (n != 16) {
+        fail("ring events", n, 16);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if ((snapshot[i].value != (int32_t)(24 + i)) || (snapshot[i].name != names[i & 1]) ||
+            (snapshot[i].phase != NS_TRACE_PH_INSTANT) ||
+            (snapshot[i].track != NS_TRACE_TASK_TRACK)) {
+            fail("ring keeps the latest", snapshot[i].value, 24 + i);
+        }
+        if ((i > 0) && ((int32_t)(snapshot[i].timestamp - snapshot[i - 1].timestamp) < 0)) {
+            fail("ring timestamps", i, 0);
+        }
+    }
+    if (ns_trace_read(snapshot, 5) != 5 || snapshot[0].value != 24) {
+        fail("partial read", snapshot[0].value, 24);
+    }
+
+    ns_trace_config_t bad = cfg;
+    bad.size = 24;
+    if (ns_trace_init(&bad) != NS_STATUS_INVALID_CONFIG) {
+        fail("non power of 2 ring accepted", 0, 1);
+    }
+}
+
+static void check_oneshot(void) {
+    ns_trace_config_t cfg = {.api = &ns_trace_V1_0_0, .events = ring, .size = 16,
+                             .mode = NS_TRACE_ONESHOT};
+    ns_trace_init(&cfg);
+    for (int i = 0; i < 40; i++) {
+        ns_trace_counter("depth", i);
+    }
+    uint32_t n = ns_trace_read(snapshot, 256);
+    if ((n != 16) || (snapshot[0].value != 0) || (snapshot[15].value != 15)) {
+        fail("oneshot keeps the first", snapshot[15].value, 15);
+    }
+    if (cfg.dropped != 24) {
+        fail("oneshot dropped", cfg.dropped, 24);
+    }
+
+    ns_trace_init(&cfg);
+    ns_trace_enable(false);
+    ns_trace_begin("paused");
+    ns_trace_enable(true);
+    ns_trace_begin("running");
+    n = ns_trace_read(snapshot, 256);
+    if ((n != 1) || strcmp(snapshot[0].name, "running")) {
+        fail("recorded while paused", n, 1);
+    }
+}
+
+// Concurrent producers on their own tracks
+static __thread uint8_t threadTrack;
+
+static uint8_t current_track(void) { return threadTrack; }
+
+static void *producer(void *arg) {
+    threadTrack = (uint8_t)(uintptr_t)arg;
+    for (int32_t i = 0; i < PER_THREAD; i++) {
+        ns_trace_record(NS_TRACE_PH_COUNTER, "producer", (threadTrack << 24) | i);
+        if ((i & 15) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void check_concurrency(void) {
+    ns_trace_config_t cfg = {.api = &ns_trace_V1_0_0, .events = ring, .size = 256,
+                             .mode = NS_TRACE_RING, .track = current_track};
+    pthread_t threads[THREADS];
+    int32_t last[THREADS];
+    uint32_t reads = 0, seen = 0;
+
+    ns_trace_init(&cfg);
+    for (uintptr_t t = 0; t < THREADS; t++) {
+        pthread_create(&threads[t], NULL, producer, (void *)(t + 1));
+    }
+    // Read while the producers run: whatever comes back must be a whole event
+    while (cfg.next < THREADS * PER_THREAD) {
+        uint32_t n = ns_trace_read(snapshot, 256);
+        for (int t = 0; t < THREADS; t++) {
+            last[t] = -1;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t t = snapshot[i].track - NS_TRACE_TASK_TRACK;
+            int32_t v = snapshot[i].value;
+            if ((t < 1) || (t > THREADS) || ((uint32_t)(v >> 24) != t) ||
+                strcmp(snapshot[i].name, "producer")) {
+                fail("torn event", snapshot[i].track, t);
+                continue;
+            }
+            if ((v & 0xFFFFFF) <= last[t - 1]) {
+                fail("per-track order", v & 0xFFFFFF, last[t - 1] + 1);
+            }
+            last[t - 1] = v & 0xFFFFFF;
+        }
+        seen += n;
+        reads++;
+        sched_yield();
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    if (ns_trace_read(snapshot, 256) != 256) {
+        fail("events after the producers finished", 0, 256);
+    }
+    printf("concurrent: %d tracks x %d events, %u reads returned %u whole events\n", THREADS,
+           PER_THREAD, reads, seen);
+}
+
+// A two-stage pipeline, traced through ns_pipeline's own instrumentation
+static uint32_t halve(void *ctx, const void *in, void *out) {
+    (void)ctx;
+    const int16_t *x = (const int16_t *)in;
+    int16_t *y = (int16_t *)out;
+    for (int i = 0; i < 8; i++) {
+        y[i] = x[2 * i] / 2;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t sum(void *ctx, const void *in, void *out) {
+    (void)ctx;
+    const int16_t *x = (const int16_t *)in;
+    int32_t s = 0;
+    for (int i = 0; i < 16; i++) {
+        s += x[i];
+    }
+    *(int32_t *)out = s;
+    return NS_STATUS_SUCCESS;
+}
+
+static void write_line(const char *line, void *user) { fprintf((FILE *)user, "%s\n", line); }
+
+static void check_pipeline(void) {
+    static int16_t frames[4][16];
+    static const void *slots[4];
+    int16_t window[16];
+    int32_t result;
+    ns_pipeline_stage_t stages[2] = {
+        {.name = "halve", .run = halve, .item_bytes = 2, .frame = 16, .hop = 16, .out_bytes = 16},
+        {.name = "sum", .run = sum, .item_bytes = 2, .frame = 16, .hop = 8, .out_bytes = 4,
+         .window = (uint8_t *)window}};
+    ns_pipeline_t pipe = {.api = &ns_pipeline_V1_0_0, .stages = stages, .numStages = 2,
+                          .output = &result, .frameSlots = slots, .frameDepth = 4,
+                          .frameItems = 16};
+    ns_trace_config_t cfg = {.api = &ns_trace_V1_0_0, .events = ring, .size = 256,
+                             .mode = NS_TRACE_ONESHOT};
+
+    if (ns_pipeline_init(&pipe) != NS_STATUS_SUCCESS) {
+        fail("pipeline init", 1, 0);
+        return;
+    }
+    ns_trace_init(&cfg);
+    for (int round = 0; round < 5; round++) {
+        for (int f = 0; f < 4; f++) {
+            ns_pipeline_submit(&pipe, frames[f]);
+        }
+        ns_pipeline_submit(&pipe, frames[0]); // ring full: a pipeline_drop instant
+        ns_pipeline_process(&pipe);
+    }
+
+    uint32_t n = ns_trace_read(snapshot, 256);
+    int depth = 0, frameSpans = 0, halveSpans = 0, sumSpans = 0, drops = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const char *name = snapshot[i].name;
+        if (snapshot[i].phase == NS_TRACE_PH_BEGIN) {
+            depth++;
+            frameSpans += !strcmp(name, "pipeline_frame");
+            halveSpans += !strcmp(name, "halve");
+            sumSpans += !strcmp(name, "sum");
+            if (strcmp(name, "pipeline_frame") && depth != 2) {
+                fail("stage span outside its frame", depth, 2);
+            }
+        } else if (snapshot[i].phase == NS_TRACE_PH_END) {
+            depth--;
+        } else if (snapshot[i].phase == NS_TRACE_PH_INSTANT) {
+            drops += !strcmp(name, "pipeline_drop");
+        }
+    }
+    if ((depth != 0) || (frameSpans != 20) || (halveSpans != 20) || (sumSpans != 19) ||
+        (drops != 5)) {
+        fail("pipeline spans", sumSpans, 19);
+    }
+
+    FILE *log = fopen("trace_ring_sim.log", "w");
+    if (log == NULL) {
+        fail("can't write trace_ring_sim.log", 0, 1);
+        return;
+    }
+    fprintf(log, "[ns_pipeline trace, %u events]\n", n);
+    if (ns_trace_dump(write_line, log) != n) {
+        fail("dumped events", 0, n);
+    }
+    fclose(log);
+}
+
+static void bench(void) {
+    static ns_trace_event_t events[1 << 12];
+    ns_trace_config_t cfg = {.api = &ns_trace_V1_0_0, .events = events, .size = 1 << 12,
+                             .mode = NS_TRACE_RING};
+
+    ns_trace_init(&cfg);
+    double t0 = now_ns();
+    for (int i = 0; i < REPEATS; i++) {
+        ns_trace_begin("bench");
+        ns_trace_end("bench");
+    }
+    double t1 = now_ns();
+    ns_trace_enable(false);
+    for (int i = 0; i < REPEATS; i++) {
+        ns_trace_begin("bench");
+        ns_trace_end("bench");
+    }
+    double t2 = now_ns();
+
+    printf("per event: %.1f ns recording (clock_gettime timestamps), %.1f ns paused, "
+           "%u bytes\n",
+           (t1 - t0) / (2.0 * REPEATS), (t2 - t1) / (2.0 * REPEATS),
+           (unsigned)sizeof(ns_trace_event_t));
+}
+
+int main(void) {
+    check_ring();
+    check_oneshot();
+    check_concurrency();
+    check_pipeline();
+    printf("trace checks: %s\n", errors ? "FAILED" : "ok");
+    bench();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file usb_bulk_loopback.c
+ * @author Ambiq
+ * @brief Host loopback test of the USB vendor bulk framing and transport path
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Framing: frames of every length around the packet size boundaries are checked to end in a
+ * short packet, encoded back to back and read back through the deframer in randomly sized
+ * bulk reads, with garbage spliced in between frames to exercise resync. The encoding is also
+ * compared against a golden frame shared with usb_bulk_loopback.py, so the device and host
+ * implementations can't drift apart.
+ *
+ * Transport: builds ns_usb.c as a NS_USB_VENDOR_BULK_DEVICE against a stubbed vendor class. A
+ * simulated host sends eRPC-style messages (4-byte header, then the body) as framed 64-byte
+ * packets; the device side reads them the way the eRPC bulk transport does, echoes each one
+ * back as a single frame through ns_usb_send_data, and the host deframes the IN stream and
+ * compares.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "ns_usb.h"
+#include "ns_usb_bulk_frame.h"
+#include "tusb.h"
+
+#define PACKET_BYTES 64   // full-speed bulk packet
+#define VENDOR_FIFO 512   // CFG_TUD_VENDOR_RX_BUFSIZE
+#define VENDOR_TX 4096    // CFG_TUD_VENDOR_TX_BUFSIZE
+#define STREAM_BYTES (2 << 20)
+#define MESSAGES 300
+#define MAX_BODY 4096
+#define RX_RING 2048
+
+extern ns_timer_config_t g_ns_usbTimer;
+extern void ns_usb_rx_drain(void);
+
+static int errors;
+
+static void check(int ok, const char *msg) {
+    if (!ok && (errors++ < 10)) {
+        fprintf(stderr, "FAIL: %s\n", msg);
+    }
+}
+
+// A byte stream read back in chunks of random size, like bulk reads of whatever has arrived
+typedef struct {
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t pos;
+    uint32_t max_chunk;
+} stream_t;
+
+static uint32_t stream_read(void *ctx, uint8_t *buf, uint32_t len) {
+    stream_t *s = ctx;
+    uint32_t n = 1 + rand() % s->max_chunk;
+    if (n > len) {
+        n = len;
+    }
+    if (n > s->len - s->pos) {
+        n = s->len - s->pos;
+    }
+    memcpy(buf, s->data + s->pos, n);
+    s->pos += n;
+    return n;
+}
+
+static uint32_t frame_encode(uint8_t *out, const uint8_t *payload, uint32_t len) {
+    uint32_t pad = ns_usb_bulk_frame_header(out, len, PACKET_BYTES);
+    memcpy(out + NS_USB_BULK_FRAME_HEADER_SIZE, payload, len);
+    memset(out + NS_USB_BULK_FRAME_HEADER_SIZE + len, 0, pad);
+    return NS_USB_BULK_FRAME_HEADER_SIZE + len + pad;
+}
+
+static void test_golden(void) {
+    // Same vectors as usb_bulk_loopback.py
+    static const uint8_t abc[] = {0x4E, 0x53, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+                                  'a',  'b',  'c'};
+    static const uint8_t full_hdr[] = {0x4E, 0x53, 0x01, 0x00, 0x38, 0x00, 0x00, 0x00};
+    uint8_t frame[128], payload[56];
+
+    check(frame_encode(frame, (const uint8_t *)"abc", 3) == sizeof(abc), "golden length");
+    check(memcmp(frame, abc, sizeof(abc)) == 0, "golden frame");
+
+    memset(payload, 0x5A, sizeof(payload)); // 8 + 56 = 64, needs a pad byte
+    uint32_t n = frame_encode(frame, payload, sizeof(payload));
+    check(n == 65, "padded golden length");
+    check(memcmp(frame, full_hdr, sizeof(full_hdr)) == 0, "padded golden header");
+    check(frame[64] == 0, "pad byte");
+}
+
+static void test_framing(void) {
+    static uint8_t stream[STREAM_BYTES], expect[STREAM_BYTES], got[STREAM_BYTES];
+    uint32_t len = 0, plen = 0, frames = 0, garbage = 0;
+
+    // Every length up to several packets, then larger ones in steps of 13 (up to ~4.5KB)
+    for (uint32_t p = 0; p < 900; p++) {
+        uint32_t size = (p < 600) ? p : 600 + (p - 600) * 13;
+        for (uint32_t i = 0; i < size; i++) {
+            expect[plen + i] = rand();
+        }
+        uint32_t n = frame_encode(stream + len, expect + plen, size);
+        check((n % PACKET_BYTES) != 0, "frame is a whole number of full speed packets");
+        check((n % 512) != 0, "frame is a whole number of high speed packets");
+        len += n;
+        plen += size;
+        frames++;
+        if ((p % 97) == 0) {
+            // Line noise between frames; must not contain a valid header
+            stream[len++] = 0x4E;
+            stream[len++] = 0xEE;
+            stream[len++] = 0x53;
+            garbage += 3;
+        }
+    }
+
+    for (uint32_t max_chunk = 1; max_chunk <= 16384; max_chunk *= 8) {
+        stream_t s = {.data = stream, .len = len, .max_chunk = max_chunk};
+        ns_usb_bulk_deframer_t d;
+        ns_usb_bulk_deframer_reset(&d);
+        uint32_t got_len = 0;
+        while (got_len < plen) {
+            // Read in pieces of random size, independent of the frame boundaries
+            uint32_t want = 1 + rand() % 3000;
+            if (want > plen - got_len) {
+                want = plen - got_len;
+            }
+            uint32_t n = ns_usb_bulk_deframe_read(&d, stream_read, &s, got + got_len, want);
+            check(n == want, "short read from a complete stream");
+            if (n != want) {
+                break;
+            }
+            got_len += n;
+        }
+        check(memcmp(got, expect, plen) == 0, "payload mismatch after deframing");
+        check(d.frames == frames, "frame count");
+        check(d.resyncs == garbage, "resync count");
+    }
+
+    // Truncated stream: a read must come back short rather than block or overrun
+    stream_t s = {.data = stream, .len = NS_USB_BULK_FRAME_HEADER_SIZE + 2, .max_chunk = 64};
+    ns_usb_bulk_deframer_t d;
+    ns_usb_bulk_deframer_reset(&d);
+    uint8_t small[16];
+    check(ns_usb_bulk_deframe_read(&d, stream_read, &s, small, sizeof(small)) < sizeof(small),
+          "truncated stream");
+
+    printf("framing: %u frames, %u payload bytes, %u garbage bytes skipped\n", frames, plen,
+           garbage);
+}
+
+// Vendor class stand-in: OUT packets from the host queue reach the vendor FIFO when tud_task
+// runs; IN data is collected as the host would read it
+static uint8_t host_out[STREAM_BYTES];
+static uint32_t host_out_head, host_out_len;
+static uint8_t vendor_fifo[VENDOR_FIFO];
+static uint32_t vendor_head, vendor_count;
+static uint8_t host_in[STREAM_BYTES];
+static uint32_t host_in_len, tx_pending, transfers;
+
+bool tusb_init(void) { return true; }
+
+void tud_task(void) {
+    while ((host_out_head < host_out_len) && (VENDOR_FIFO - vendor_count >= PACKET_BYTES)) {
+        uint32_t n = host_out_len - host_out_head;
+        n = (n < PACKET_BYTES) ? n : PACKET_BYTES;
+        for (uint32_t i = 0; i < n; i++) {
+            vendor_fifo[(vendor_head + vendor_count++) % VENDOR_FIFO] = host_out[host_out_head++];
+        }
+        ns_usb_rx_drain(); // tud_vendor_rx_cb
+    }
+}
+
+uint32_t tud_vendor_available(void) { return vendor_count; }
+
+uint32_t tud_vendor_read(void *buffer, uint32_t bufsize) {
+    uint32_t n = (bufsize < vendor_count) ? bufsize : vendor_count;
+    for (uint32_t i = 0; i < n; i++) {
+        ((uint8_t *)buffer)[i] = vendor_fifo[vendor_head];
+        vendor_head = (vendor_head + 1) % VENDOR_FIFO;
+    }
+    vendor_count -= n;
+    return n;
+}
+
+void tud_vendor_read_flush(void) { vendor_count = 0; }
+
+uint32_t tud_vendor_write(void const *buffer, uint32_t bufsize) {
+    uint32_t space = VENDOR_TX - tx_pending;
+    uint32_t n = (bufsize < space) ? bufsize : space;
+    memcpy(host_in + host_in_len, buffer, n);
+    host_in_len += n;
+    tx_pending += n;
+    return n;
+}
+
+// Sent instantly. The host's read only completes when a packet is short, so only a flush
+// ending in a short packet finishes a transfer.
+uint32_t tud_vendor_write_flush(void) {
+    if (tx_pending % PACKET_BYTES) {
+        transfers++;
+    }
+    tx_pending = 0;
+    return 0;
+}
+
+uint32_t tud_vendor_write_available(void) { return VENDOR_TX - tx_pending; }
+
+uint32_t tud_cdc_available(void) { return 0; }
+uint32_t tud_cdc_read(void *buffer, uint32_t bufsize) { return 0; }
+void tud_cdc_read_flush(void) {}
+uint32_t tud_cdc_write(void const *buffer, uint32_t bufsize) { return 0; }
+uint32_t tud_cdc_write_flush(void) { return 0; }
+uint32_t tud_cdc_write_available(void) { return 0; }
+
+// Platform stand-ins
+const ns_core_api_t ns_timer_V1_0_0 = {.apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_0_0};
+uint32_t ns_timer_init(ns_timer_config_t *cfg) { return NS_STATUS_SUCCESS; }
+uint32_t ns_core_check_api(
+    const ns_core_api_t *s, const ns_core_api_t *oldest, const ns_core_api_t *newest) {
+    return NS_STATUS_SUCCESS;
+}
+void ns_core_fail_loop(void) { exit(1); }
+uint32_t am_hal_interrupt_master_disable(void) { return 0; }
+uint32_t am_hal_interrupt_master_enable(void) { return 0; }
+void am_hal_interrupt_master_set(uint32_t state) {}
+void ns_delay_us(uint32_t us) {}
+
+// WFI: the next thing to happen is the service tick
+void am_hal_sysctrl_sleep(uint32_t mode) { g_ns_usbTimer.callback(&g_ns_usbTimer); }
+
+static uint32_t device_read(void *ctx, uint8_t *buf, uint32_t len) {
+    return ns_usb_receive_data_timeout(ctx, buf, len, 10);
+}
+
+static void test_transport(void) {
+    static uint8_t ring[RX_RING], tx[64];
+    static uint8_t msg[4 + MAX_BODY], frame[NS_USB_BULK_FRAME_HEADER_SIZE + 4 + MAX_BODY + 1];
+    static uint8_t expect[STREAM_BYTES], got[STREAM_BYTES];
+    ns_usb_config_t cfg = {.api = &ns_usb_V1_0_0, .deviceType = NS_USB_VENDOR_BULK_DEVICE,
+                           .rx_buffer = ring, .rx_bufferLength = sizeof(ring), .tx_buffer = tx,
+                           .tx_bufferLength = sizeof(tx)};
+    usb_handle_t h;
+
+    fflush(stdout);
+    int out = dup(1), null = open("/dev/null", O_WRONLY);
+    dup2(null, 1); // ns_usb_init is chatty
+    ns_usb_init(&cfg, &h);
+    fflush(stdout);
+    dup2(out, 1);
+    close(null);
+    close(out);
+
+    // Host side: queue every request up front, sizes spanning several packets and the ring
+    uint32_t expect_len = 0;
+    for (int m = 0; m < MESSAGES; m++) {
+        uint32_t body = (m < 100) ? 1 + m : 1 + rand() % MAX_BODY;
+        msg[0] = body & 0xFF;
+        msg[1] = body >> 8;
+        msg[2] = msg[3] = 0;
+        for (uint32_t i = 0; i < body; i++) {
+            msg[4 + i] = rand();
+        }
+        memcpy(expect + expect_len, msg, 4 + body);
+        expect_len += 4 + body;
+        host_out_len += frame_encode(host_out + host_out_len, msg, 4 + body);
+    }
+
+    // Device side: header, then body, then echo as one frame
+    ns_usb_bulk_deframer_t d;
+    ns_usb_bulk_deframer_reset(&d);
+    for (int m = 0; m < MESSAGES; m++) {
+        if (ns_usb_bulk_deframe_read(&d, device_read, h, msg, 4) != 4) {
+            check(0, "device header read timed out");
+            break;
+        }
+        uint32_t body = msg[0] | (msg[1] << 8);
+        if (ns_usb_bulk_deframe_read(&d, device_read, h, msg + 4, body) != body) {
+            check(0, "device body read timed out");
+            break;
+        }
+        uint32_t before = transfers;
+        uint32_t n = frame_encode(frame, msg, 4 + body);
+        check(ns_usb_send_data(h, frame, n) == n, "device send");
+        check(transfers == before + 1, "echo not sent as a single short-terminated transfer");
+    }
+    check(ns_usb_receive_data_timeout(h, msg, 1, 5) == 0, "extra data after the last message");
+
+    // Host reads the IN stream back in large bulk reads
+    stream_t s = {.data = host_in, .len = host_in_len, .max_chunk = 16384};
+    ns_usb_bulk_deframer_t hd;
+    ns_usb_bulk_deframer_reset(&hd);
+    uint32_t n = ns_usb_bulk_deframe_read(&hd, stream_read, &s, got, expect_len);
+    check(n == expect_len, "host read of the echoed stream");
+    check(memcmp(got, expect, expect_len) == 0, "echoed data mismatch");
+    check(hd.resyncs == 0, "device frames needed resync");
+
+    printf("transport: %d messages, %u bytes each way, %u IN transfers, %u frames received\n",
+           MESSAGES, expect_len, transfers, d.frames);
+}
+
+int main(void) {
+    srand(1);
+    test_golden();
+    test_framing();
+    test_transport();
+    if (errors) {
+        fprintf(stderr, "%d failures\n", errors);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+"""Host loopback test of the Python side of the USB vendor bulk framing.
+
+Checks usb_bulk_framing.py against the same golden frames as usb_bulk_loopback.c, then loops
+random messages through a fake pair of bulk endpoints: frames are written the way
+UsbBulkTransport._base_send writes them, cut into max-packet-size packets, and read back in
+bulk reads that end at the first short packet, the way libusb completes them.
+
+    python3 tests/host/usb_bulk_loopback.py
+"""
+
+import os
+import random
+import sys
+
+sys.path.insert(
+    0,
+    os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "..", "..", "neuralspot", "ns-rpc", "python", "ns-rpc-genericdata",
+    ),
+)
+
+from usb_bulk_framing import HEADER_SIZE, Deframer, encode_frame  # noqa: E402
+
+
+class FakeBulkPipe:
+    """Packets written on one side, bulk reads on the other."""
+
+    def __init__(self, max_packet):
+        self.max_packet = max_packet
+        self.packets = []
+        self.transfers = 0
+
+    def write(self, data):
+        for i in range(0, len(data), self.max_packet):
+            self.packets.append(bytes(data[i : i + self.max_packet]))
+        if len(data) % self.max_packet == 0:
+            # No short packet: the host's read would wait for the next transfer
+            self.packets.append(None)
+        self.transfers += 1
+
+    def read(self, size):
+        out = bytearray()
+        while self.packets and len(out) < size:
+            p = self.packets.pop(0)
+            if p is None:
+                raise AssertionError("transfer ended without a short packet")
+            out += p
+            if len(p) < self.max_packet:
+                break
+        return bytes(out)
+
+
+def test_golden():
+    assert encode_frame(b"abc") == bytes([0x4E, 0x53, 0, 0, 3, 0, 0, 0]) + b"abc"
+    frame = encode_frame(b"\x5a" * 56)
+    assert frame[:HEADER_SIZE] == bytes([0x4E, 0x53, 1, 0, 0x38, 0, 0, 0])
+    assert len(frame) == 65 and frame[-1] == 0
+
+
+def test_loopback(max_packet, messages=300):
+    rng = random.Random(max_packet)
+    pipe = FakeBulkPipe(max_packet)
+    deframer = Deframer(lambda: pipe.read(16384))
+    sent = []
+    for m in range(messages):
+        size = m if m < messages // 2 else rng.randrange(1, 9000)
+        msg = bytes(rng.getrandbits(8) for _ in range(size))
+        sent.append(msg)
+        frame = encode_frame(msg, max_packet)
+        assert len(frame) % max_packet != 0
+        pipe.write(frame)
+        if m % 50 == 7:
+            pipe.write(b"\x4e\xee\x53")  # noise between frames
+    for msg in sent:
+        # Read the way the eRPC FramedTransport does: header-sized piece, then the rest
+        head = deframer.read(min(4, len(msg)))
+        assert head + deframer.read(len(msg) - len(head)) == msg
+    assert deframer.frames == messages
+    assert deframer.resyncs == 3 * len([m for m in range(messages) if m % 50 == 7])
+    print("python %d B packets: %d messages, %d transfers" % (max_packet, messages, pipe.transfers))
+
+
+if __name__ == "__main__":
+    test_golden()
+    test_loopback(64)
+    test_loopback(512)
@@ -0,0 +1,301 @@
+/**
+ * @file usb_cdc_rx_sim.c
+ * @author Ambiq
+ * @brief Host simulation of the ns-usb CDC receive path
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Builds ns_usb.c against a stubbed TinyUSB on a simulated clock. A simulated USB host
+ * sends eRPC-style frames (4-byte header, then the body) as 64-byte full-speed packets.
+ * As on hardware, received packets only reach the CDC FIFO when tud_task() runs (in the 1ms
+ * USB service interrupt, or from a waiting reader), and a WFI is woken by either that
+ * interrupt or a packet arriving.
+ *
+ * Each frame is read the way the eRPC transport does (header, then body), once with
+ * ns_usb_recieve_data and once with the previous busy-wait loop, replayed against the same
+ * stub, and the receive latency per RPC is compared. Also checks the timeout API: expiry
+ * with no data, partial reads, non-blocking reads, and reads larger than the rx ring.
+ * Like the real CDC class, the stub keeps its FIFO in ns_usb_get_rx_buffer(), so anything
+ * else that writes to that buffer corrupts the received data.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "ns_usb.h"
+#include "tusb.h"
+
+#define TICK_US 1000     // USB service timer period
+#define PACKET_BYTES 64  // full-speed bulk packet
+#define PACKET_US 50     // time on the bus per packet
+#define CDC_FIFO 2048    // rx_bufferLength, which the CDC class sizes its FIFO by
+#define HOST_QUEUE 65536
+#define RPCS 200
+
+extern ns_timer_config_t g_ns_usbTimer;
+extern volatile uint8_t gGotUSBRx;
+
+// Simulated clock and USB host
+static uint64_t now_us;
+static uint64_t next_tick_us;
+static uint32_t wakeups;
+static int errors;
+
+static uint8_t host_data[HOST_QUEUE];
+static uint64_t host_arrival[HOST_QUEUE]; // when each byte reaches the USB controller
+static uint32_t host_head, host_tail;
+
+// CDC FIFO: its storage is ns_usb_get_rx_buffer(), as in cdc_device_ns.c
+static uint32_t cdc_head, cdc_count;
+
+static void check(int ok, const char *msg) {
+    if (!ok && (errors++ < 10)) {
+        fprintf(stderr, "FAIL: %s\n", msg);
+    }
+}
+
+// Queue data from the host, split into packets starting at time t. Returns the arrival time
+// of the last packet.
+static uint64_t host_send(const uint8_t *data, uint32_t len, uint64_t t) {
+    for (uint32_t i = 0; i < len; i++) {
+        if ((i % PACKET_BYTES) == 0) {
+            t += PACKET_US;
+        }
+        host_data[host_tail % HOST_QUEUE] = data[i];
+        host_arrival[host_tail % HOST_QUEUE] = t;
+        host_tail++;
+    }
+    return t;
+}
+
+// TinyUSB stand-in
+bool tusb_init(void) { return true; }
+
+void tud_task(void) {
+    uint8_t *cdc_fifo = ns_usb_get_rx_buffer();
+    uint32_t size = ns_get_cdc_rx_bufferLength();
+    uint32_t moved = 0;
+    while ((host_head != host_tail) && (host_arrival[host_head % HOST_QUEUE] <= now_us) &&
+           (cdc_count < size)) {
+        cdc_fifo[(cdc_head + cdc_count++) % size] = host_data[host_head++ % HOST_QUEUE];
+        moved++;
+    }
+    if (moved) {
+        tud_cdc_rx_cb(0);
+    }
+}
+
+uint32_t tud_cdc_available(void) { return cdc_count; }
+
+uint32_t tud_cdc_read(void *buffer, uint32_t bufsize) {
+    uint8_t *cdc_fifo = ns_usb_get_rx_buffer();
+    uint32_t n = (bufsize < cdc_count) ? bufsize : cdc_count;
+    for (uint32_t i = 0; i < n; i++) {
+        ((uint8_t *)buffer)[i] = cdc_fifo[cdc_head];
+        cdc_head = (cdc_head + 1) % ns_get_cdc_rx_bufferLength();
+    }
+    cdc_count -= n;
+    return n;
+}
+
+void tud_cdc_read_flush(void) { cdc_count = 0; }
+uint32_t tud_cdc_write(void const *buffer, uint32_t bufsize) { return bufsize; }
+uint32_t tud_cdc_write_flush(void) { return 0; }
+uint32_t tud_cdc_write_available(void) { return 0; }
+uint32_t tud_vendor_available(void) { return 0; }
+uint32_t tud_vendor_read(void *buffer, uint32_t bufsize) { return 0; }
+void tud_vendor_read_flush(void) {}
+uint32_t tud_vendor_write(void const *buffer, uint32_t bufsize) { return 0; }
+uint32_t tud_vendor_write_flush(void) { return 0; }
+uint32_t tud_vendor_write_available(void) { return 0; }
+
+// Platform stand-ins: time only passes in delays and sleeps, and that is where the service
+// interrupt gets delivered
+const ns_core_api_t ns_timer_V1_0_0 = {.apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_0_0};
+uint32_t ns_timer_init(ns_timer_config_t *cfg) { return NS_STATUS_SUCCESS; }
+uint32_t ns_core_check_api(
+    const ns_core_api_t *s, const ns_core_api_t *oldest, const ns_core_api_t *newest) {
+    return NS_STATUS_SUCCESS;
+}
+void ns_core_fail_loop(void) { exit(1); }
+uint32_t am_hal_interrupt_master_disable(void) { return 0; }
+uint32_t am_hal_interrupt_master_enable(void) { return 0; }
+void am_hal_interrupt_master_set(uint32_t state) {}
+
+static void advance_to(uint64_t t) {
+    while (next_tick_us <= t) {
+        now_us = next_tick_us;
+        next_tick_us += TICK_US;
+        g_ns_usbTimer.callback(&g_ns_usbTimer);
+    }
+    now_us = t;
+}
+
+void ns_delay_us(uint32_t us) { advance_to(now_us + us); }
+
+// WFI: wake on the next service tick or packet arrival
+void am_hal_sysctrl_sleep(uint32_t mode) {
+    uint64_t wake = next_tick_us;
+    if ((host_head != host_tail) && (host_arrival[host_head % HOST_QUEUE] > now_us) &&
+        (host_arrival[host_head % HOST_QUEUE] < wake)) {
+        wake = host_arrival[host_head % HOST_QUEUE];
+    }
+    wakeups++;
+    advance_to(wake);
+}
+
+// The receive loop ns_usb_recieve_data used before, against the same stub
+static uint32_t legacy_recieve_data(void *buffer, uint32_t bufsize) {
+    uint32_t bytes_rx = 0;
+    uint32_t retries = 100000;
+    uint32_t block_retries = 15;
+
+    if (gGotUSBRx == 0)
+        ns_delay_us(100);
+    while (tud_cdc_available() < bufsize) {
+        if (tud_cdc_available() < bufsize) {
+            gGotUSBRx = 0;
+        }
+        while ((gGotUSBRx == 0) && (tud_cdc_available() < bufsize)) {
+            ns_delay_us(750);
+            if (--retries == 0) {
+                break;
+            }
+        };
+        if (block_retries == 0) {
+            break;
+        }
+        block_retries--;
+    }
+    gGotUSBRx = 0;
+    tud_task();
+    bytes_rx = tud_cdc_read(buffer, bufsize);
+    ns_delay_us(200);
+    return bytes_rx;
+}
+
+static void usb_reset(ns_usb_device_type_e type) {
+    static uint8_t rx[CDC_FIFO], tx[64];
+    static ns_usb_config_t cfg;
+    usb_handle_t h;
+    cfg = (ns_usb_config_t){.api = &ns_usb_V1_0_0, .deviceType = type, .rx_buffer = rx,
+                            .rx_bufferLength = sizeof(rx), .tx_buffer = tx,
+                            .tx_bufferLength = sizeof(tx)};
+    host_head = host_tail = 0;
+    cdc_head = cdc_count = 0;
+    gGotUSBRx = 0;
+    fflush(stdout);
+    int out = dup(1), null = open("/dev/null", O_WRONLY);
+    dup2(null, 1); // ns_usb_init is chatty
+    ns_usb_init(&cfg, &h);
+    fflush(stdout);
+    dup2(out, 1);
+    close(null);
+    close(out);
+}
+
+// Runs RPCS request frames of body_len bytes, returns the mean receive latency in us
+static double run_rpcs(uint32_t body_len, int legacy, uint32_t *rate) {
+    static uint8_t frame[4 + 4096], rx[4 + 4096];
+    double total_latency = 0;
+
+    usb_reset(legacy ? NS_USB_VENDOR_DEVICE : NS_USB_CDC_DEVICE);
+    srand(1);
+    uint64_t start = now_us;
+    wakeups = 0;
+    for (int r = 0; r < RPCS; r++) {
+        // The host sends the next request a little after the previous response
+        uint64_t sent = now_us + 100 + rand() % 900;
+        memcpy(frame, &body_len, 4);
+        for (uint32_t i = 0; i < body_len; i++) {
+            frame[4 + i] = (uint8_t)(r + i);
+        }
+        uint64_t arrived = host_send(frame, 4 + body_len, sent);
+
+        uint32_t got;
+        if (legacy) {
+            advance_to(sent); // the old loop only starts polling once something arrived
+            got = legacy_recieve_data(rx, 4);
+            got += legacy_recieve_data(rx + 4, body_len);
+        } else {
+            advance_to(sent - 100); // already waiting in erpc_server_poll / a client reply
+            got = ns_usb_recieve_data(NULL, rx, 4);
+            got += ns_usb_recieve_data(NULL, rx + 4, body_len);
+        }
+        check(got == 4 + body_len, "short read");
+        check(memcmp(rx, frame, 4 + body_len) == 0, "data corrupted");
+        total_latency += (double)(now_us - arrived);
+        ns_delay_us(50); // handle the request and send the response
+    }
+    *rate = (uint32_t)(RPCS * 1e6 / (now_us - start));
+    return total_latency / RPCS;
+}
+
+static void test_timeouts(void) {
+    static uint8_t data[NS_USB_CDC_RX_RING_SIZE + CDC_FIFO + 1000];
+    static uint8_t rx[sizeof(data)];
+
+    usb_reset(NS_USB_CDC_DEVICE);
+
+    uint64_t t0 = now_us;
+    check(ns_usb_receive_data_timeout(NULL, rx, 16, 5) == 0, "timeout with no data");
+    check((now_us - t0 >= 4000) && (now_us - t0 <= 6000), "timeout duration");
+
+    t0 = now_us;
+    check(ns_usb_receive_data_timeout(NULL, rx, 16, 0) == 0, "non-blocking with no data");
+    check(now_us == t0, "non-blocking read slept");
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + i / 251); // not periodic in the ring or FIFO size
+    }
+    host_send(data, 10, now_us);
+    check(ns_usb_receive_data_timeout(NULL, rx, 20, 3) == 10, "partial read on timeout");
+    check(memcmp(rx, data, 10) == 0, "partial read data");
+    check(!ns_usb_data_available(NULL), "data left after partial read");
+
+    // Larger than both the ring and the TinyUSB FIFO: only works if bytes are consumed as
+    // they arrive
+    host_send(data, sizeof(data), now_us);
+    check(ns_usb_receive_data_timeout(NULL, rx, sizeof(data), 100) == sizeof(data),
+          "read larger than the rx ring");
+    check(memcmp(rx, data, sizeof(data)) == 0, "large read data");
+
+    // Received while nobody reads: the ring fills, then the CDC FIFO behind it, and the host
+    // is NAKed for the rest. The ring must not overwrite what waits in the FIFO.
+    host_send(data, sizeof(data), now_us);
+    advance_to(now_us + 50 * TICK_US);
+    check(ns_usb_receive_data_timeout(NULL, rx, sizeof(data), 100) == sizeof(data),
+          "read after the ring and FIFO filled");
+    check(memcmp(rx, data, sizeof(data)) == 0, "ring and FIFO data");
+
+    host_send(data, 8, now_us);
+    advance_to(now_us + 2 * TICK_US);
+    check(ns_usb_rx_available(NULL) == 8, "rx_available");
+    check(ns_usb_receive_data_timeout(NULL, rx, 8, 0) == 8, "non-blocking with data");
+}
+
+int main(void) {
+    const uint32_t sizes[] = {16, 64, 256, 1024};
+    uint32_t legacy_rate, rate;
+
+    // Latency: from the last byte of a request reaching the controller to the read returning
+    printf("body B\tlegacy us\tnew us\tlegacy rpc/s\tnew rpc/s\twakeups/rpc\n");
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        double legacy = run_rpcs(sizes[i], 1, &legacy_rate);
+        double latency = run_rpcs(sizes[i], 0, &rate);
+        printf("%u\t%9.0f\t%6.0f\t%12u\t%9u\t%11.1f\n", sizes[i], legacy, latency, legacy_rate,
+               rate, (double)wakeups / RPCS);
+        check(latency < legacy, "event-driven receive slower than the legacy loop");
+        check(latency <= TICK_US, "receive latency beyond one USB service period");
+    }
+    test_timeouts();
+    return errors ? 1 : 0;
+}
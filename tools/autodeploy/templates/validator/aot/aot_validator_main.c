@@ -84,7 +84,7 @@ void vrpc_on_after_invoke(void) {
   #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L)
   // If the host asked for full PMU capture, advertise PMU availability so that
   // the fetch path can switch to per-layer PMU streaming after FullStats.
-  if (mut_cfg.config.full_pmu_stats == 1) {
+  if (mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) {
     mut_stats.stats.pmu_count = NS_NUM_PMU_MAP_SIZE;
   } else {
     mut_stats.stats.pmu_count = 0;
@@ -159,6 +159,9 @@ int main(void) {
 #if (NS_VALIDATOR_RPC_TRANSPORT == NS_AD_RPC_TRANSPORT_UART)
     .uartHandle = (ns_uart_handle_t)&rpcUARTHandle,
     .transport = NS_RPC_TRANSPORT_UART,
+#elif (NS_VALIDATOR_RPC_TRANSPORT == NS_AD_RPC_TRANSPORT_USB_BULK)
+    .uartHandle = NULL,
+    .transport = NS_RPC_TRANSPORT_USB_BULK,
 #else
     .uartHandle = NULL,
     .transport = NS_RPC_TRANSPORT_USB,
@@ -199,7 +199,10 @@ static int aot_pmu_get_layer_counters(uint32_t layer,
   ns_pmu_accm_get_layer(s_accm, (uint16_t)layer, out_counters, (uint16_t)out_capacity);
   return 0;
 }
-static void aot_pmu_full_characterize(int (*invoke_cb)(void)){
+static void aot_pmu_full_characterize(int (*invoke_cb)(void), const ns_mut_config_t* cfg,
+                                      uint32_t layer_count, uint32_t rv_max){
+  // The accumulator always sweeps the whole map; adaptive and subset plans are TFLM only.
+  (void)cfg; (void)layer_count; (void)rv_max;
   // Iterate inferences until all event groups are accumulated.
   while (!ns_pmu_accm_complete(s_accm)){
     if (invoke_cb) (void)invoke_cb(); else (void)aot_invoke();
@@ -209,7 +212,7 @@ static void aot_pmu_full_characterize(int (*invoke_cb)(void)){
 static void aot_pmu_get_header(char* dst, uint32_t max_len){ (void)dst; (void)max_len; }
 static uint32_t aot_pmu_events_per_layer(void){ return 0; }
 static int aot_pmu_get_layer_counters(uint32_t a,uint32_t b,uint32_t c,uint32_t*d,uint32_t e){ (void)a;(void)b;(void)c;(void)d;(void)e; return -1; }
-static void aot_pmu_full_characterize(int (*cb)(void)){ (void)cb; }
+static void aot_pmu_full_characterize(int (*cb)(void), const ns_mut_config_t* cfg, uint32_t a, uint32_t b){ (void)cb;(void)cfg;(void)a;(void)b; }
 #endif
 
 
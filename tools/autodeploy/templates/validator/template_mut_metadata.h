@@ -17,6 +17,13 @@
 
 #define TFLM_VALIDATOR_MAC_ESTIMATE_COUNT NS_AD_MAC_ESTIMATE_COUNT
 
+// Generic (prebuilt) image: pool sizes in KB for runtime model and arena placement
+#define NS_AD_GENERIC                 NS_AD_GENERIC_VALUE
+#define TFLM_VALIDATOR_TCM_POOL_SIZE  NS_AD_TCM_POOL_SIZE
+#define TFLM_VALIDATOR_SRAM_POOL_SIZE NS_AD_SRAM_POOL_SIZE
+#define TFLM_VALIDATOR_MRAM_SLOT_SIZE NS_AD_MRAM_SLOT_SIZE
+#define TFLM_VALIDATOR_PSRAM_POOL_SIZE NS_AD_PSRAM_POOL_SIZE
+
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L) || defined(AM_PART_APOLLO330P)
 #define NS_PROFILER_PMU_EVENT_0 NS_AD_PMU_EVENT_0
 #define NS_PROFILER_PMU_EVENT_1 NS_AD_PMU_EVENT_1
@@ -21,11 +21,19 @@
 // NS includes
 #include "ns_ambiqsuite_harness.h"
 #include "ns_debug_log.h"
+#include "ns_timer.h"
 #include "tflm_ns_model.h"
+#include "tflm_validator.h"
 
 // Tensorflow Lite for Microcontroller includes (somewhat boilerplate)
 // #include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/arena_allocator/non_persistent_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/arena_allocator/persistent_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
 #include "tensorflow/lite/micro/kernels/micro_ops.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/memory_planner/linear_memory_planner.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
@@ -38,6 +46,18 @@
     #include "tensorflow/lite/micro/micro_error_reporter.h"
 #endif
 
+#include <new>
+
+// Set by model init; arena probes build their throwaway interpreters with it
+static tflite::MicroOpResolver *s_probe_resolver = nullptr;
+
+// Below this, MicroAllocator::Create can't place its own objects and doesn't check
+static constexpr uint32_t kProbeMinArena =
+    sizeof(tflite::MicroAllocator) + sizeof(tflite::LinearMemoryPlanner) +
+    sizeof(tflite::GreedyMemoryPlanner) + sizeof(tflite::SingleArenaBufferAllocator) +
+    sizeof(tflite::PersistentArenaBufferAllocator) +
+    sizeof(tflite::NonPersistentArenaBufferAllocator) + 256;
+
 /**
  * @brief Initialize TF with model
  *
@@ -98,6 +118,7 @@ int NS_AD_NAME_model_init(ns_model_state_t *ms) {
     static tflite::MicroMutableOpResolver<NS_AD_NUM_OPS> resolver(ms->error_reporter);
 #endif
     NS_AD_RESOLVER_ADDS
+    s_probe_resolver = &resolver;
 
     // Allocate ResourceVariable stuff if needed
     tflite::MicroResourceVariables *resource_variables;
@@ -146,3 +167,70 @@ int NS_AD_NAME_model_init(ns_model_state_t *ms) {
     ms->state = READY;
     return NS_STATUS_SUCCESS;
 }
+
+/**
+ * @brief Allocate, and optionally time, the model in a trial arena
+ *
+ * Builds a throwaway interpreter for the model NS_AD_NAME_model_init mapped, over the
+ * given buffers and with the given planner. With a scratch buffer the arena holds only the
+ * persistent allocations (interpreter, planner, tensor metadata) and the scratch buffer the
+ * planned activations. The buffers may overlap ms->arena, so the model has to be initialized
+ * again before ms->interpreter is used.
+ *
+ * @return NS_AD_PROBE_* status
+ */
+uint32_t NS_AD_NAME_model_probe(ns_model_state_t *ms, const ns_arena_probe_t *probe,
+                                uint8_t *arena, uint8_t *scratch, ns_timer_config_t *timer,
+                                ns_arena_probe_result_t *result) {
+    if ((s_probe_resolver == nullptr) || (ms->model == nullptr)) {
+        return NS_AD_PROBE_UNSUPPORTED;
+    }
+    if ((result->arena_size < kProbeMinArena) || ((scratch != nullptr) && (result->scratch_size < 16))) {
+        return NS_AD_PROBE_ALLOC_FAILED;
+    }
+    tflite::MemoryPlannerType planner = (probe->planner == NS_AD_PLANNER_LINEAR)
+                                            ? tflite::MemoryPlannerType::kLinear
+                                            : tflite::MemoryPlannerType::kGreedy;
+    tflite::MicroAllocator *allocator =
+        (scratch != nullptr)
+            ? tflite::MicroAllocator::Create(arena, result->arena_size, scratch,
+                                             result->scratch_size, planner)
+            : tflite::MicroAllocator::Create(arena, result->arena_size, planner);
+
+    // Resource variables get a fresh allocator too, ms->interpreter's are overwritten anyway
+    tflite::MicroResourceVariables *resource_variables = nullptr;
+    if (ms->rv_count != 0) {
+        tflite::MicroAllocator *var_allocator =
+            tflite::MicroAllocator::Create(ms->rv_arena, ms->rv_arena_size, nullptr);
+        resource_variables = tflite::MicroResourceVariables::Create(var_allocator, ms->rv_count);
+    }
+
+    // No profiler: the trial invokes are timed as a whole
+    alignas(tflite::MicroInterpreter) static uint8_t interpreter_buf[sizeof(tflite::MicroInterpreter)];
+    tflite::MicroInterpreter *interpreter = new (interpreter_buf)
+        tflite::MicroInterpreter(ms->model, *s_probe_resolver, allocator, resource_variables);
+
+    uint32_t status = NS_AD_PROBE_OK;
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+        status = NS_AD_PROBE_ALLOC_FAILED;
+    } else {
+        result->used_bytes = interpreter->arena_used_bytes();
+        if ((probe->iterations > 0) && (timer != nullptr)) {
+            // The warmup invoke also prepares kernel scratch state
+            if (interpreter->Invoke() != kTfLiteOk) {
+                status = NS_AD_PROBE_INVOKE_FAILED;
+            } else {
+                uint32_t start = ns_us_ticker_read(timer);
+                for (uint32_t i = 0; i < probe->iterations; i++) {
+                    if (interpreter->Invoke() != kTfLiteOk) {
+                        status = NS_AD_PROBE_INVOKE_FAILED;
+                        break;
+                    }
+                }
+                result->latency_us = (ns_us_ticker_read(timer) - start) / probe->iterations;
+            }
+        }
+    }
+    interpreter->~MicroInterpreter();
+    return status;
+}
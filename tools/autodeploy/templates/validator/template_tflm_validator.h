@@ -25,6 +25,13 @@
 // #include <cstdlib>
 // #include <cstring>
 
+// Full PMU characterization (ns_mut_config_t.full_pmu_stats)
+#define NS_AD_PMU_OFF      0
+#define NS_AD_PMU_FULL     1 // every ns_pmu_map event, one inference per 4 events
+#define NS_AD_PMU_ADAPTIVE 2 // cheap pass, then the event groups each layer calls for
+#define NS_AD_PMU_SUBSET   3 // only the events in pmu_events
+#define NS_AD_PMU_EVENTS_MAX 16
+
 typedef struct {
     uint32_t profile_mut; ///> 1 -> enable ML Profiling and reporting
     // uint32_t num_resource_variables; ///> number of TFLM ResourceVariables to allocate
@@ -33,7 +40,12 @@ typedef struct {
     uint32_t profile_warmup; ///> how many inferences to run before profiling
     uint32_t num_input_tensors;
     uint32_t num_output_tensors;
-    uint32_t full_pmu_stats; ///> 1 -> enable full PMU stats
+    uint32_t full_pmu_stats; ///> NS_AD_PMU_* characterization mode, 0 -> off
+    uint32_t num_layers;     ///> layers in the model, used by generic images
+    uint32_t arena_location; ///> NS_AD_* arena location, used by generic images
+    uint32_t arena_size;     ///> in bytes, 0 for the whole pool, used by generic images
+    uint32_t pmu_num_events; ///> entries used in pmu_events
+    uint32_t pmu_events[NS_AD_PMU_EVENTS_MAX]; ///> ARM_PMU_* ids, the SUBSET or extra ADAPTIVE events
 } ns_mut_config_t;
 
 typedef union {
@@ -59,9 +71,41 @@ typedef union {
 #define NS_AD_PSRAM 1
 #define NS_AD_SRAM  2
 #define NS_AD_MRAM  3
+#define NS_AD_RUNTIME 4 // generic image, placed by the host at run time
+
+// Arena probes (arena search): a throwaway interpreter allocated, and optionally timed, in a
+// trial arena. With a scratch location the arena holds only the persistent allocations and the
+// scratch buffer the planned (non-persistent) ones.
+#define NS_AD_PLANNER_GREEDY 0
+#define NS_AD_PLANNER_LINEAR 1
+#define NS_AD_PROBE_UNIFIED  0xFF // scratch_location for a single arena
+
+#define NS_AD_PROBE_OK           0
+#define NS_AD_PROBE_NO_ROOM      1 // the location is missing or smaller than requested
+#define NS_AD_PROBE_ALLOC_FAILED 2 // AllocateTensors failed, the arena is too small
+#define NS_AD_PROBE_INVOKE_FAILED 3
+#define NS_AD_PROBE_UNSUPPORTED  4 // runtime can't probe, or the model isn't configured yet
+
+typedef struct {
+    uint32_t planner;          ///> NS_AD_PLANNER_*
+    uint32_t arena_location;   ///> NS_AD_* location of the arena (or its persistent part)
+    uint32_t arena_size;       ///> in bytes, 0 for the rest of the location
+    uint32_t scratch_location; ///> NS_AD_* location of the scratch part, or NS_AD_PROBE_UNIFIED
+    uint32_t scratch_size;     ///> in bytes, 0 for the rest of the location
+    uint32_t iterations;       ///> timed invokes after a warmup, 0 to only allocate
+} ns_arena_probe_t;
+
+typedef struct {
+    uint32_t status;       ///> NS_AD_PROBE_*
+    uint32_t arena_size;   ///> bytes actually given to the arena (resolves a 0 request)
+    uint32_t scratch_size; ///> bytes actually given to the scratch part
+    uint32_t used_bytes;   ///> arena_used_bytes() of the trial interpreter
+    uint32_t latency_us;   ///> average over the timed invokes
+} ns_arena_probe_result_t;
 
 #define NS_AD_RPC_TRANSPORT_UART 0
 #define NS_AD_RPC_TRANSPORT_USB 1
+#define NS_AD_RPC_TRANSPORT_USB_BULK 2
 
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L)
 #define NS_NUM_PMU_EVENTS NS_NUM_PMU_MAP_SIZE
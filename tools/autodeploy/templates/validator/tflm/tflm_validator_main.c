@@ -49,7 +49,8 @@ const uint32_t tflm_validator_mac_estimates[TFLM_VALIDATOR_MAC_ESTIMATE_COUNT] =
 const int tflm_validator_number_of_estimates = TFLM_VALIDATOR_MAC_ESTIMATE_COUNT;
 
 NS_AD_LAYER_METADATA_CODE
-const ns_perf_mac_count_t mac_estimates = {
+// Not const: generic images set number_of_layers per model in vrpc_on_configure()
+ns_perf_mac_count_t mac_estimates = {
     .number_of_layers = tflm_validator_number_of_estimates,
     .mac_count_map = (uint32_t *)tflm_validator_mac_estimates,
     .output_magnitudes = (uint32_t *)NS_AD_NAME_output_magnitudes,
@@ -79,13 +80,24 @@ ns_pmu_config_t   s_pmu_cfg;
 #endif
 #endif
 
+#if NS_AD_GENERIC && defined(NS_MLPROFILE)
+// ------------------------ Generic image configure hook ----------------------
+// The per-layer metadata above is a zeroed placeholder sized for the largest
+// model; the host knows the real estimates and applies them to the stats.
+void vrpc_on_configure(void) {
+  uint32_t n = mut_cfg.config.num_layers;
+  mac_estimates.number_of_layers =
+      ((n > 0) && (n <= TFLM_VALIDATOR_MAC_ESTIMATE_COUNT)) ? n : TFLM_VALIDATOR_MAC_ESTIMATE_COUNT;
+}
+#endif
+
 // -------------------------- Stats refresh (post-invoke) ---------------------
 // The validator_rpc.c file calls this hook after each successful invoke.
 // We translate profiler buffers into mut_stats so the host can fetch them.
 void vrpc_on_after_invoke(void) {
   // Platform stamping handled in fetch handler; fill the rest here.
 #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L)
-  if (mut_cfg.config.full_pmu_stats == 1) {
+  if (mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) {
     mut_stats.stats.pmu_count = NS_NUM_PMU_MAP_SIZE;
   } else {
     mut_stats.stats.pmu_count = 0;
@@ -143,7 +155,8 @@ int main(void) {
   // Memory placement defaults; PSRAM base set after init (if used)
   ns_mem_init_defaults();
 
-#if (TFLM_MODEL_LOCATION == NS_AD_PSRAM) || (TFLM_ARENA_LOCATION == NS_AD_PSRAM)
+#if (TFLM_MODEL_LOCATION == NS_AD_PSRAM) || (TFLM_ARENA_LOCATION == NS_AD_PSRAM) || \
+    (NS_AD_GENERIC && (TFLM_VALIDATOR_PSRAM_POOL_SIZE > 0))
   // Initialize PSRAM early and provide base to memory provider
   ns_psram_config_t psram_cfg = {
     .api = &ns_psram_V0_0_1,
@@ -209,6 +222,8 @@ ns_interrupt_master_enable();
     .computeOnEVB_cb = infer,
 #if (NS_VALIDATOR_RPC_TRANSPORT == NS_AD_RPC_TRANSPORT_UART)
     .transport = NS_RPC_TRANSPORT_UART
+#elif (NS_VALIDATOR_RPC_TRANSPORT == NS_AD_RPC_TRANSPORT_USB_BULK)
+    .transport = NS_RPC_TRANSPORT_USB_BULK
 #else
     .transport = NS_RPC_TRANSPORT_USB
 #endif
@@ -48,12 +48,15 @@ extern "C" {
 
     // Model-specific init function generated from template_tflm_model.cc
     extern int tflm_validator_model_init(ns_model_state_t *ms);
+    extern uint32_t tflm_validator_model_probe(ns_model_state_t *ms, const ns_arena_probe_t *probe,
+                                               uint8_t *arena, uint8_t *scratch, ns_timer_config_t *timer,
+                                               ns_arena_probe_result_t *result);
     
     // Resource Variable arena (always in TCM/SRAM per harness)
     #ifdef __cplusplus
     #include "tensorflow/lite/micro/micro_resource_variable.h"
     #endif
-    extern const ns_perf_mac_count_t mac_estimates;
+    extern ns_perf_mac_count_t mac_estimates;
     #if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L)
     extern ns_pmu_config_t s_pmu_cfg;
     #endif
@@ -65,6 +68,7 @@ extern "C" {
     
     // Single runtime state
     static ns_model_state_t s_tflm;  // owned here
+    static ns_timer_config_t *s_probe_timer = nullptr;  // times arena probes
     
     // Minimal profiler hook: call LogCsv when available
     static void tflm_stats_hook(void){
@@ -88,6 +92,9 @@ extern "C" {
     // ---- API impl ---------------------------------------------------------------
     static int rt_init(uint32_t num_inputs, uint32_t num_outputs, uint32_t profile, uint32_t warmup, ns_timer_config_t *tickTimer){
       (void)profile; (void)warmup; // handled by upper layer via mut_cfg
+    #ifdef NS_MLPROFILE
+      s_probe_timer = tickTimer;   // only initialized on profiling builds
+    #endif
     
       // Fill required fields prior to init
       s_tflm.runtime = TFLM;
@@ -181,13 +188,54 @@ extern "C" {
       #endif
       return 0;
     }
-    static void rt_pmu_full_characterize(int (*invoke_cb)(void)){
+    static void rt_pmu_full_characterize(int (*invoke_cb)(void),
+                                         const ns_mut_config_t* cfg,
+                                         uint32_t layer_count,
+                                         uint32_t rv_max){
       #if defined(ARMCM55)
       /* Characterize via the existing helper; prefer callback if provided. */
-      (void)ns_characterize_model(invoke_cb ? invoke_cb : rt_invoke_cb_shim);
+      invoke_fp func = invoke_cb ? invoke_cb : rt_invoke_cb_shim;
+      ns_characterize_cfg_t plan;
+      plan.mode = (cfg->full_pmu_stats == NS_AD_PMU_ADAPTIVE) ? NS_CHARACTERIZE_ADAPTIVE
+                : (cfg->full_pmu_stats == NS_AD_PMU_SUBSET) ? NS_CHARACTERIZE_SUBSET
+                : NS_CHARACTERIZE_FULL;
+      plan.events = cfg->pmu_events;
+      plan.numEvents = (cfg->pmu_num_events < NS_AD_PMU_EVENTS_MAX) ? cfg->pmu_num_events
+                                                                     : NS_AD_PMU_EVENTS_MAX;
+      plan.numLayers = layer_count;
+      plan.rv = rv_max;
+      // A rejected plan has not run any inference yet, so the sidecar is still clean
+      if (ns_characterize_model_cfg(func, &plan) != NS_STATUS_SUCCESS){
+        ns_lp_printf("[WARN] PMU event plan rejected, running the full sweep\n");
+        (void)ns_characterize_model(func);
+      }
+      #else
+      (void)invoke_cb; (void)cfg; (void)layer_count; (void)rv_max;
       #endif
     }
         
+    // -------- Arena search ----------------------------------------------------
+    static uint32_t rt_arena_probe(const ns_arena_probe_t* probe, ns_arena_probe_result_t* result){
+      memset(result, 0, sizeof(*result));
+      result->arena_size = probe->arena_size;
+      result->scratch_size = probe->scratch_size;
+      ns_mem_probe_reset();
+      uint8_t* arena = ns_mem_probe_alloc(probe->arena_location, &result->arena_size);
+      uint8_t* scratch = nullptr;
+      if (arena && (probe->scratch_location != NS_AD_PROBE_UNIFIED)){
+        scratch = ns_mem_probe_alloc(probe->scratch_location, &result->scratch_size);
+        if (!scratch) arena = nullptr;
+      } else {
+        result->scratch_size = 0;
+      }
+      if (!arena){
+        result->status = NS_AD_PROBE_NO_ROOM;
+      } else {
+        result->status = tflm_validator_model_probe(&s_tflm, probe, arena, scratch, s_probe_timer, result);
+      }
+      return result->status;
+    }
+
     static const ns_validator_rt_api_t kAPI = {
       rt_init,
       rt_set_input,
@@ -200,7 +248,8 @@ extern "C" {
       rt_pmu_get_header,
       rt_pmu_events_per_layer,
       rt_pmu_get_layer_counters,
-      rt_pmu_full_characterize
+      rt_pmu_full_characterize,
+      rt_arena_probe
     };
     
     extern "C" const ns_validator_rt_api_t* ns_get_runtime_api(void){ return &kAPI; }
@@ -21,8 +21,8 @@
 #include "validator_mem.h"
 #include "mut_model_metadata.h"   // buffer sizes & locations
 
-// Generated model data when not streaming via PSRAM
-#if (TFLM_MODEL_LOCATION != NS_AD_PSRAM) && (NS_AD_AOT == 0)
+// Generated model data when not streaming via PSRAM (generic images always stream)
+#if (TFLM_MODEL_LOCATION != NS_AD_PSRAM) && (NS_AD_AOT == 0) && (NS_AD_GENERIC == 0)
 #include "mut_model_data.h"
 #endif
 
@@ -46,6 +46,167 @@ uint32_t vrpc_tx_scratch_size(void){ return (uint32_t)sizeof(s_tx_scratch); }
 uint8_t* vrpc_out_hold_buf(void){ return s_out_hold; }
 
 // ---------------------- Model pointer and arena pointer ----------------------
+#if NS_AD_GENERIC
+/*
+ * Generic (prebuilt) image: the model and arena are placed by the host at run
+ * time instead of at compile time. Every location is a pool; the model is
+ * placed first (Model Header, before its chunks), the arena after it at
+ * configure time when both share a pool. The MRAM pool is a zero-filled slot in
+ * the image that the model is programmed into, so it only holds models.
+ */
+typedef struct {
+  uint8_t* base;
+  uint32_t size;
+} vmem_pool_t;
+
+#if TFLM_VALIDATOR_TCM_POOL_SIZE > 0
+NS_PUT_IN_TCM __attribute__((aligned(16))) static uint8_t s_tcm_pool[TFLM_VALIDATOR_TCM_POOL_SIZE * 1024u];
+#endif
+NS_SRAM_BSS __attribute__((aligned(16))) static uint8_t s_sram_pool[TFLM_VALIDATOR_SRAM_POOL_SIZE * 1024u];
+#if TFLM_VALIDATOR_MRAM_SLOT_SIZE > 0
+// volatile: contents change behind the compiler's back when the slot is programmed
+static const volatile uint8_t s_mram_slot[TFLM_VALIDATOR_MRAM_SLOT_SIZE * 1024u] __attribute__((aligned(16))) = {0};
+static uint32_t s_mram_stage[256] __attribute__((aligned(16)));  // whole 16-byte program units
+static uint32_t s_mram_staged = 0;   // bytes waiting in s_mram_stage
+static uint32_t s_mram_written = 0;  // bytes programmed into the slot
+#endif
+
+static vmem_pool_t s_pools[4];       // indexed by NS_AD_TCM/PSRAM/SRAM/MRAM
+static uint32_t s_probe_used[4];     // bytes handed to the current arena probe, per pool
+static uint32_t s_model_loc = NS_AD_SRAM;
+static uint32_t s_model_size = 0;
+static uint8_t* s_model_ptr = 0;
+static uint8_t* s_arena_ptr = 0;
+static uint32_t s_arena_size = 0;
+
+static inline uint32_t vmem_align16(uint32_t n){ return (n + 15u) & ~15u; }
+
+void ns_mem_init_defaults(void){
+  memset(s_pools, 0, sizeof(s_pools));
+#if TFLM_VALIDATOR_TCM_POOL_SIZE > 0
+  s_pools[NS_AD_TCM] = (vmem_pool_t){ s_tcm_pool, (uint32_t)sizeof(s_tcm_pool) };
+#endif
+  s_pools[NS_AD_SRAM] = (vmem_pool_t){ s_sram_pool, (uint32_t)sizeof(s_sram_pool) };
+#if TFLM_VALIDATOR_MRAM_SLOT_SIZE > 0
+  s_pools[NS_AD_MRAM] = (vmem_pool_t){ (uint8_t*)s_mram_slot, (uint32_t)sizeof(s_mram_slot) };
+#endif
+  s_model_ptr = 0;
+  s_arena_ptr = 0;
+  s_arena_size = 0;
+}
+
+void ns_mem_set_psram_base(uint8_t* base){
+  s_pools[NS_AD_PSRAM] = (vmem_pool_t){ base, TFLM_VALIDATOR_PSRAM_POOL_SIZE * 1024u };
+}
+
+int ns_mem_place_model(uint32_t location, uint32_t size){
+  if ((location > NS_AD_MRAM) || !s_pools[location].base || (vmem_align16(size) > s_pools[location].size)){
+    return -1;
+  }
+  s_model_loc = location;
+  s_model_size = size;
+  s_model_ptr = s_pools[location].base;
+  s_arena_ptr = 0;  // the old arena may overlap the new model
+  s_arena_size = 0;
+#if TFLM_VALIDATOR_MRAM_SLOT_SIZE > 0
+  s_mram_staged = 0;
+  s_mram_written = 0;
+#endif
+  return 0;
+}
+
+int ns_mem_place_arena(uint32_t location, uint32_t size){
+  if ((location >= NS_AD_MRAM) || !s_pools[location].base){
+    return -1;
+  }
+  uint32_t start = (s_model_ptr && (location == s_model_loc)) ? vmem_align16(s_model_size) : 0;
+  uint32_t avail = (s_pools[location].size > start) ? (s_pools[location].size - start) : 0;
+  if (size == 0){
+    size = avail;  // 0 asks for everything left, used to measure the arena
+  }
+  if ((size == 0) || (size > avail)){
+    return -1;
+  }
+  s_arena_ptr = s_pools[location].base + start;
+  s_arena_size = size;
+  return 0;
+}
+
+uint8_t* ns_mem_model_ptr(void){ return s_model_ptr; }
+uint8_t* ns_mem_arena_ptr(void){ return s_arena_ptr; }
+uint32_t ns_mem_arena_size(void){ return s_arena_size; }
+
+void ns_mem_probe_reset(void){ memset(s_probe_used, 0, sizeof(s_probe_used)); }
+
+// Probes take any pool but MRAM, after the model when it shares the pool (the arena is not kept)
+uint8_t* ns_mem_probe_alloc(uint32_t location, uint32_t* size){
+  if ((location >= NS_AD_MRAM) || !s_pools[location].base){
+    return NULL;
+  }
+  uint32_t start = (s_model_ptr && (location == s_model_loc)) ? vmem_align16(s_model_size) : 0;
+  start += s_probe_used[location];
+  uint32_t avail = (s_pools[location].size > start) ? (s_pools[location].size - start) : 0;
+  if (*size == 0){
+    *size = avail & ~15u;
+  }
+  if ((*size == 0) || (*size > avail)){
+    return NULL;
+  }
+  s_probe_used[location] += vmem_align16(*size);
+  return s_pools[location].base + start;
+}
+
+#if TFLM_VALIDATOR_MRAM_SLOT_SIZE > 0
+static int vmem_mram_flush(void){
+  uint32_t padded = vmem_align16(s_mram_staged);
+  memset((uint8_t*)s_mram_stage + s_mram_staged, 0, padded - s_mram_staged);
+  if (am_hal_mram_main_program(AM_HAL_MRAM_PROGRAM_KEY, s_mram_stage,
+                               (uint32_t*)(s_pools[NS_AD_MRAM].base + s_mram_written), padded / 4u) != 0){
+    return -1;
+  }
+  s_mram_written += s_mram_staged;
+  s_mram_staged = 0;
+  return 0;
+}
+
+// MRAM is programmed in 16-byte units, so chunks are staged and must arrive in order
+static int vmem_mram_write(uint32_t offset, const uint8_t* data, uint32_t len){
+  if (offset != (s_mram_written + s_mram_staged)){
+    return -1;
+  }
+  while (len > 0u){
+    uint32_t n = (uint32_t)sizeof(s_mram_stage) - s_mram_staged;
+    if (n > len) n = len;
+    memcpy((uint8_t*)s_mram_stage + s_mram_staged, data, n);
+    s_mram_staged += n;
+    data += n;
+    len -= n;
+    if ((s_mram_staged == sizeof(s_mram_stage)) || (s_mram_written + s_mram_staged == s_model_size)){
+      if (vmem_mram_flush() != 0) return -1;
+    }
+  }
+#if defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO330P_510L)
+  if (s_mram_written == s_model_size){
+    am_hal_cachectrl_dcache_invalidate(NULL, true);  // drop lines cached before programming
+  }
+#endif
+  return 0;
+}
+#endif
+
+int vrpc_model_write(uint32_t offset, const void* data, uint32_t len){
+  if (!s_model_ptr || (offset + len > s_model_size)) return -1;
+#if TFLM_VALIDATOR_MRAM_SLOT_SIZE > 0
+  if (s_model_loc == NS_AD_MRAM){
+    return vmem_mram_write(offset, (const uint8_t*)data, len);
+  }
+#endif
+  memcpy(s_model_ptr + offset, data, len);
+  return 0;
+}
+
+#else // Per-model image: placement fixed at compile time
+
 #if (TFLM_MODEL_LOCATION == NS_AD_PSRAM)
 static uint8_t* s_model_ptr = 0;   // set at runtime once PSRAM is ready
 // #else
@@ -97,6 +258,28 @@ uint8_t* ns_mem_model_ptr(void){
 uint8_t* ns_mem_arena_ptr(void){ return s_arena_ptr; }
 uint32_t ns_mem_arena_size(void){ return s_arena_size; }
 
+// Per-model images probe inside their compiled arena
+static uint32_t s_probe_used = 0;
+
+void ns_mem_probe_reset(void){ s_probe_used = 0; }
+
+uint8_t* ns_mem_probe_alloc(uint32_t location, uint32_t* size){
+  if ((location != TFLM_ARENA_LOCATION) || !s_arena_ptr){
+    return NULL;
+  }
+  uint32_t avail = s_arena_size - s_probe_used;
+  if (*size == 0){
+    *size = avail & ~15u;
+  }
+  if ((*size == 0) || (*size > avail)){
+    return NULL;
+  }
+  uint8_t* p = s_arena_ptr + s_probe_used;
+  s_probe_used += (*size + 15u) & ~15u;
+  if (s_probe_used > s_arena_size) s_probe_used = s_arena_size;
+  return p;
+}
+
 // Allow host to stream model chunks into PSRAM-backed model buffer
 int vrpc_model_write(uint32_t offset, const void* data, uint32_t len){
 #if (TFLM_MODEL_LOCATION == NS_AD_PSRAM)
@@ -106,4 +289,5 @@ int vrpc_model_write(uint32_t offset, const void* data, uint32_t len){
 #else
   (void)offset; (void)data; (void)len; return -1; // not supported
 #endif
-}
\ No newline at end of file
+}
+#endif // NS_AD_GENERIC
@@ -35,6 +35,19 @@ uint32_t ns_mem_arena_size(void);
 // When PSRAM is used, set the base address so model/arena pointers are valid.
 void     ns_mem_set_psram_base(uint8_t* base);
 
+// Generic images only: place the model (before its chunks are written) and the
+// arena (at configure) in an NS_AD_* location. A zero arena size takes the rest
+// of the pool. Return 0 on success, -1 if the location is missing or too small.
+int      ns_mem_place_model(uint32_t location, uint32_t size);
+int      ns_mem_place_arena(uint32_t location, uint32_t size);
+
+// Arena probes: hand out trial buffers from an NS_AD_* location (generic images:
+// any pool but MRAM; per-model images: only the compiled arena). *size of 0
+// takes the rest of the location and is updated. Buffers overlap the configured
+// arena. Returns NULL if the location is missing or too small.
+void     ns_mem_probe_reset(void);
+uint8_t* ns_mem_probe_alloc(uint32_t location, uint32_t* size);
+
 // Strong overrides for weak scratch providers used by RPC layer
 uint8_t* vrpc_tx_scratch(void);
 uint32_t vrpc_tx_scratch_size(void);
@@ -38,10 +38,12 @@
  *   description : short ASCII tag (e.g., "FullTensor", "PartStats", …)
  *
  * ------------------------- High-level sequence (TFLM/AOT) -------------------
- * 1) (optional) Model Streaming (PSRAM builds only)
+ * 1) (optional) Model Streaming (PSRAM builds and generic images)
  *    validator.py → send_model_to_evb()      → cmd=read
+ *       sendBlockToEVB(Model Header)         → vrpc_incoming_model_header()
+ *       -> generic images place the model via ns_mem_place_model() (size, location)
  *       sendBlockToEVB(ModelChunk)           → decodeIncomingSendblock()
- *       -> vrpc_incoming_model_chunk(): writes PSRAM via vrpc_model_write()
+ *       -> vrpc_incoming_model_chunk(): writes the model via vrpc_model_write()
  *       Repeats until full model transferred.
  *
  * 2) Configure runtime
@@ -51,6 +53,7 @@
  *         -> vrpc_configure_model():
  *            - Copies mut_cfg and the variable-length input/output size arrays
  *              into g_in_details[] / g_out_details[].
+ *            - Generic images place the arena via ns_mem_place_arena().
  *            - Binds the runtime via ns_get_runtime_api() (TFLM or AOT).
  *            - Calls rt->init(num_inputs, num_outputs, profile, warmup, &s_tickTimer).
  *            - Precomputes total output bytes and resets all chunk state.
@@ -98,6 +101,14 @@
  *            - If a stats chunk is active: vrpc_get_stats_chunk() returns the next
  *              "PartStats"/"LastStats".
  *
+ * 4b) (optional) Arena search
+ *    validator.py → tuneArena()  (after configure, before the model is re-flashed)
+ *      computeOnEVB(in description "Arena Probe", payload ns_arena_probe_t)
+ *        → infer() → vrpc_arena_probe() → rt->arena_probe()
+ *        ← "Arena Probe" block carrying ns_arena_probe_result_t
+ *      Each probe builds a throwaway interpreter in memory that overlaps the
+ *      configured arena, so the host configures again before inferring.
+ *
  * 5) (AP5 only, optional) Full PMU per-layer stream
  *    validator.py → getPMUStats()  (called after FullStats when full_pmu_capture is set)
  *      Repeated fetchBlockFromEVB() calls retrieve per-layer PMU snapshots.
@@ -145,6 +156,7 @@
 #include "ns_malloc.h"
 #include "tflm_validator.h"        // ns_incoming_config_t, ns_outgoing_stats_t, tensor detail unions
 #include "mut_model_metadata.h"
+#include "validator_mem.h"
 
 // -----------------------------------------------------------------------------
 // Configuration macros
@@ -166,6 +178,9 @@
 #if NS_AD_AOT == 1
 // AOT layer ids can be sparse; PMU streaming uses dense ids [0..last_identifier].
 #define VALIDATOR_LAYER_COUNT (AOT_LAST_IDENTIFIER + 1)
+#elif NS_AD_GENERIC
+// Generic images are not built for a model; the host sends the layer count
+#define VALIDATOR_LAYER_COUNT (mut_cfg.config.num_layers)
 #else
 #define VALIDATOR_LAYER_COUNT TFLM_VALIDATOR_MAC_ESTIMATE_COUNT
 #endif
@@ -200,6 +215,7 @@ __attribute__((weak)) int vrpc_model_write(uint32_t offset, const void* data, ui
 }
 
 __attribute__((weak)) void vrpc_on_after_invoke(void) {}
+__attribute__((weak)) void vrpc_on_configure(void) {}
 
 static inline uint32_t vrpc_tx_payload_max(void){
   uint32_t sz = vrpc_tx_scratch_size();
@@ -234,6 +250,9 @@ static ns_incoming_tensor_details_u g_out_details[NS_MAX_OUTPUT_TENSORS];
 // Input staging offset (when chunking directly into mapped input buffer)
 static uint32_t g_input_offset = 0;
 
+// Model streaming offset, reset by the Model Header (not by configure, which follows the model)
+static uint32_t g_model_offset = 0;
+
 // Runtime binding
 static const ns_validator_rt_api_t* g_rt = NULL;
 
@@ -323,6 +342,19 @@ static status vrpc_configure_model(const dataBlock* in){
   memcpy(g_in_details,  in->buffer.data + sizeof(mut_cfg), 4u * mut_cfg.config.num_input_tensors);
   memcpy(g_out_details, in->buffer.data + sizeof(mut_cfg) + 4u * mut_cfg.config.num_input_tensors, 4u * mut_cfg.config.num_output_tensors);
 
+#if NS_AD_GENERIC
+  if (ns_mem_model_ptr() == NULL){
+    ns_lp_printf("[ERROR] Generic validator needs the model sent before the config\n");
+    return ns_rpc_data_failure;
+  }
+  if (ns_mem_place_arena(mut_cfg.config.arena_location, mut_cfg.config.arena_size) != 0){
+    ns_lp_printf("[ERROR] Arena of %u bytes does not fit location %u\n",
+                 (unsigned)mut_cfg.config.arena_size, (unsigned)mut_cfg.config.arena_location);
+    return ns_rpc_data_failure;
+  }
+#endif
+  vrpc_on_configure();
+
   // Bind runtime
   g_rt = ns_get_runtime_api();
   if (!g_rt) { ns_lp_printf("[ERROR] Runtime API not linked\n"); return ns_rpc_data_failure; }
@@ -367,12 +399,29 @@ static status vrpc_incoming_tensor_chunk(const dataBlock* in){
 }
 
 // -----------------------------------------------------------------------------
-// Optional PSRAM model chunking (sendBlock with other cmd)
+// Optional model streaming (sendBlock with other cmd)
 // -----------------------------------------------------------------------------
+static status vrpc_incoming_model_header(const dataBlock* in){
+  uint32_t hdr[2];  // model size in bytes, NS_AD_* location
+  if (in->buffer.dataLength != sizeof(hdr)){
+    ns_lp_printf("[ERROR] Model header size mismatch. exp=%u got=%u\n", (unsigned)sizeof(hdr), (unsigned)in->buffer.dataLength);
+    return ns_rpc_data_failure;
+  }
+  memcpy(hdr, in->buffer.data, sizeof(hdr));
+#if NS_AD_GENERIC
+  if (ns_mem_place_model(hdr[1], hdr[0]) != 0){
+    ns_lp_printf("[ERROR] Model of %u bytes does not fit location %u\n", (unsigned)hdr[0], (unsigned)hdr[1]);
+    return ns_rpc_data_failure;
+  }
+#endif
+  g_model_offset = 0;
+  return ns_rpc_data_success;
+}
+
 static status vrpc_incoming_model_chunk(const dataBlock* in){
-  int rc = vrpc_model_write(g_input_offset, in->buffer.data, in->buffer.dataLength);
+  int rc = vrpc_model_write(g_model_offset, in->buffer.data, in->buffer.dataLength);
   if (rc != 0){ ns_lp_printf("[ERROR] Model write not supported or failed\n"); return ns_rpc_data_failure; }
-  g_input_offset += in->buffer.dataLength;  // reuse offset for model
+  g_model_offset += in->buffer.dataLength;
   return ns_rpc_data_success;
 }
 
@@ -382,6 +431,9 @@ static status vrpc_incoming_model_chunk(const dataBlock* in){
 status decodeIncomingSendblock(const dataBlock* in){
   if (in->cmd == generic_cmd) return vrpc_configure_model(in);
   if (in->cmd == write_cmd)   return vrpc_incoming_tensor_chunk(in);
+  if ((in->description != NULL) && (strcmp(in->description, "Model Header") == 0)) {
+    return vrpc_incoming_model_header(in);
+  }
   return vrpc_incoming_model_chunk(in);
 }
 
@@ -409,7 +461,7 @@ static status vrpc_get_stats_full(dataBlock* out){
     ns_chunk_advance(&g_stats_chunk, to_send);
   } else {
     // Full stats fit in one block; if Full PMU requested, prime PMU stream now.
-    if ((mut_cfg.config.full_pmu_stats == 1) && g_rt && g_rt->pmu_events_per_layer) {
+    if ((mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) && g_rt && g_rt->pmu_events_per_layer) {
       mut_stats.stats.pmu_events_per_layer = g_rt->pmu_events_per_layer();
       g_pmu_events_per_layer = mut_stats.stats.pmu_events_per_layer;
       g_pmu_layer_iter = 0;
@@ -429,7 +481,7 @@ static status vrpc_get_stats_chunk(dataBlock* out){
   ns_chunk_advance(&g_stats_chunk, n);
   // If that was the final stats chunk and Full PMU is requested, switch to PMU layer stream
 
-  if (!g_stats_chunk.active && (mut_cfg.config.full_pmu_stats == 1) && g_rt && g_rt->pmu_events_per_layer) {
+  if (!g_stats_chunk.active && (mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) && g_rt && g_rt->pmu_events_per_layer) {
     // Inform host how many PMU counters per layer and prime first layer
     mut_stats.stats.pmu_events_per_layer = g_rt->pmu_events_per_layer();
     g_pmu_events_per_layer = mut_stats.stats.pmu_events_per_layer;
@@ -502,7 +554,7 @@ status decodeIncomingFetchblock(dataBlock* out){
 
   if (g_stats_sent_once &&
       !g_stats_chunk.active &&
-      (mut_cfg.config.full_pmu_stats == 1) &&
+      (mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) &&
       g_rt && g_rt->pmu_events_per_layer &&
       (g_rt->pmu_events_per_layer() == 0)) {
     const char* msg = "PMU stream unavailable";
@@ -519,11 +571,35 @@ status decodeIncomingFetchblock(dataBlock* out){
   return rc;
 }
 
+// -----------------------------------------------------------------------------
+// Arena search (computeOnEVB with description "Arena Probe")
+// -----------------------------------------------------------------------------
+static status vrpc_arena_probe(const dataBlock* in, dataBlock* out){
+  ns_arena_probe_t probe;
+  ns_arena_probe_result_t result;
+  memset(&result, 0, sizeof(result));
+  if (in->buffer.dataLength != sizeof(probe)){
+    ns_lp_printf("[ERROR] Arena probe size mismatch. exp=%u got=%u\n", (unsigned)sizeof(probe), (unsigned)in->buffer.dataLength);
+    return ns_rpc_data_failure;
+  }
+  memcpy(&probe, in->buffer.data, sizeof(probe));
+  if (!g_rt || !g_rt->arena_probe){
+    result.status = NS_AD_PROBE_UNSUPPORTED;
+  } else {
+    g_rt->arena_probe(&probe, &result);
+  }
+  vrpc_fill_block(out, generic_cmd, &result, (uint32_t)sizeof(result), "Arena Probe");
+  return ns_rpc_data_success;
+}
+
 // -----------------------------------------------------------------------------
 // computeOnEVB handler (invoke path + output chunking)
 // -----------------------------------------------------------------------------
 status infer(const dataBlock* in, dataBlock* out){
 //   ns_lp_printf("infer\n");
+  if ((in->description != NULL) && (strcmp(in->description, "Arena Probe") == 0)) {
+    return vrpc_arena_probe(in, out);
+  }
   // If host asks for next output chunk (by calling compute with write_cmd)
   if (in->cmd == write_cmd && g_output_chunked && g_tensor_chunk.active){
     uint32_t n = ns_chunk_next(&g_tensor_chunk);
@@ -561,12 +637,13 @@ status infer(const dataBlock* in, dataBlock* out){
   // If Full PMU is requested, let the runtime do its one-time characterization
   // after warmups (TFLM may run ns_characterize_model; AOT loops accumulator).
   if (!g_full_characterization_done &&
-      (mut_cfg.config.full_pmu_stats == 1) &&
+      (mut_cfg.config.full_pmu_stats != NS_AD_PMU_OFF) &&
       (mut_cfg.config.profile_mut == 1) &&
       (g_warmups_seen == mut_cfg.config.profile_warmup) &&
       g_rt && g_rt->pmu_full_characterize) {
     ns_lp_printf("Running runtime-specific full PMU characterization\n");
-    g_rt->pmu_full_characterize(vrpc_invoke_cb);
+    g_rt->pmu_full_characterize(vrpc_invoke_cb, &mut_cfg.config, VALIDATOR_LAYER_COUNT,
+                                TFLM_VALIDATOR_MAX_RESOURCE_VARIABLES);
     g_full_characterization_done = true;
   }
 
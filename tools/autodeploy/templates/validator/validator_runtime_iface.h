@@ -83,9 +83,23 @@ typedef struct ns_validator_rt_api_s {
                                 uint32_t* out_counters,
                                 uint32_t out_capacity);
   /** Perform a one-time “full characterization” run if the runtime needs it.
-   *  The runtime may ignore invoke_cb and call its own invoke path.
+   *  The runtime may ignore invoke_cb and call its own invoke path. cfg carries the
+   *  NS_AD_PMU_* mode and event list; runtimes that can't plan may always run the full sweep.
    */
-  void (*pmu_full_characterize)(int (*invoke_cb)(void));
+  void (*pmu_full_characterize)(int (*invoke_cb)(void),
+                                const ns_mut_config_t* cfg,
+                                uint32_t layer_count,
+                                uint32_t rv_max);
+
+  /* --------------------------------------------------------------------------
+   * Arena search (optional; may be NULL when not supported)
+   * ------------------------------------------------------------------------*/
+  /** Allocate (and time, if probe->iterations) the configured model in a trial
+   *  arena described by probe, filling result. Returns result->status. The trial
+   *  reuses validator memory, so the model must be configured again before the
+   *  next inference.
+   */
+  uint32_t (*arena_probe)(const ns_arena_probe_t* probe, ns_arena_probe_result_t* result);
 
 } ns_validator_rt_api_t;
 
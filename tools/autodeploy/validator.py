@@ -1,7 +1,12 @@
+import collections
+import functools
+import hashlib
+import json
 import logging as log
 import os
 import shutil
 import struct
+import subprocess
 import sys
 import time
 import erpc
@@ -35,6 +40,7 @@ from neuralspot.tools.ns_utils import (
     reset_dut,
     xxd_c_dump,
     read_pmu_definitions,
+    read_pmu_characterize_events,
     suppress_os_stdio,
     resolve_resource_path,
     flatten_tensor_examples,
@@ -54,7 +60,12 @@ from pathlib import Path
 import neuralspot.rpc.GenericDataOperations_PcToEvb as GenericDataOperations_PcToEvb
 import yaml
 
-modelConfigPreambleSize = 7  # number of uint32_t words
+modelConfigPreambleSize = 27  # number of uint32_t words
+
+# Full PMU characterization, mirrors NS_AD_PMU_* in template_tflm_validator.h
+PMU_CHARACTERIZATION_MODES = {"full": 1, "adaptive": 2, "subset": 3}
+PMU_CHARACTERIZE_EVENTS_MAX = 16
+PMU_NOT_CAPTURED = 0xFFFFFFFF  # NS_PMU_NOT_CAPTURED, an event the characterization skipped
 modelStatPreambleSize = 7+128  # number of uint32_t words
 
 # Max RPC Block Length is roughly 3000 bytes, per testing
@@ -210,6 +221,7 @@ class ModelConfiguration:
         self.modelStructureDetails = ModelStructureDetails(params.tflite_filename, params.model_name)
         self.rv_count = self.modelStructureDetails.rv_count
         self.aot_layers = 0
+        self.generic_validator = False  # stats came from the prebuilt image, see GenericValidator
 
     def update_from_stats(self, stats, md):
         self.arena_size = stats[0]  # in bytes
@@ -249,11 +261,26 @@ class ModelConfiguration:
             )
 
 
-def send_model_to_evb(params, client):
+def send_model_to_evb(params, client, location=None):
     # Load the model as an array of bytes
     with open(params.tflite_filename, "rb") as f:
         model = f.read()
 
+    # The generic validator places the model from this header before the chunks arrive
+    if location is not None:
+        header = struct.pack("<II", len(model), location)
+        headerBlock = GenericDataOperations_PcToEvb.common.dataBlock(
+            description="Model Header",
+            dType=GenericDataOperations_PcToEvb.common.dataType.uint8_e,
+            cmd=GenericDataOperations_PcToEvb.common.command.read,
+            buffer=header,
+            length=len(header),
+        )
+        status = client.ns_rpc_data_sendBlockToEVB(headerBlock)
+        if status != 0:
+            print("[ERROR] Model Header Send Status = %d, model does not fit the location" % status)
+            exit("Model Send Failed")
+
     # Send the model to the EVB in chunks
     for chunk in chunker(model, maxRpcBlockLength):
         modelBlock = GenericDataOperations_PcToEvb.common.dataBlock(
@@ -273,14 +300,40 @@ def send_model_to_evb(params, client):
             # print(".", end="")
 
 
-def configModel(params, client, md):
+def pmu_characterization_plan(params):
+    """(NS_AD_PMU_* mode, ARM_PMU_* ids) sent by configModel, mode 0 without full PMU capture"""
+    if not params.full_pmu_capture:
+        return 0, []
+    mode = params.pmu_characterization
+    if mode not in PMU_CHARACTERIZATION_MODES:
+        exit(f"Unknown PMU characterization '{mode}', expected one of {list(PMU_CHARACTERIZATION_MODES)}")
+    events = []
+    if mode != "full":
+        # Adaptive picks its own groups, only an explicit CHARACTERIZE list adds to them
+        events = read_pmu_characterize_events(params, counters_fallback=(mode == "subset"))
+    if mode == "subset" and not events:
+        exit("PMU characterization 'subset' needs events in the PMU config file")
+    if len(events) > PMU_CHARACTERIZE_EVENTS_MAX:
+        log.warning(
+            "Characterizing the first %d of %d PMU events", PMU_CHARACTERIZE_EVENTS_MAX, len(events)
+        )
+        events = events[:PMU_CHARACTERIZE_EVENTS_MAX]
+    return PMU_CHARACTERIZATION_MODES[mode], events
+
+
+def configModel(params, client, md, placement=None, pmu_plan=None):
+    """placement is a GenericPlacement when talking to the generic validator image, pmu_plan
+    overrides pmu_characterization_plan() (e.g. (0, []) when the PMU counters are cached)"""
     if params.create_profile:
         prof_enable = 1  # convert to int just to be explicit for serialization
     else:
         prof_enable = 0
     # print(f"[DEBUG] Configuring model with prof_enable {prof_enable}")
     # Send the model before config
-    if params.model_location == "PSRAM":
+    if placement is not None:
+        log.info("Sending model to generic validator over RPC")
+        send_model_to_evb(params, client, placement.model_location)
+    elif params.model_location == "PSRAM":
         log.info("Sending model to EVB over RPC")
         send_model_to_evb(params, client)
         # print("Model sent to EVB")
@@ -293,6 +346,9 @@ def configModel(params, client, md):
     for tensor in md.outputTensors:
         outputTensorByteLengths.append(tensor.bytes)
 
+    pmu_mode, pmu_events = pmu_characterization_plan(params) if pmu_plan is None else pmu_plan
+    pmu_event_words = list(pmu_events) + [0] * (PMU_CHARACTERIZE_EVENTS_MAX - len(pmu_events))
+
     configBytes = struct.pack(
         "<"
         + "I"
@@ -307,7 +363,12 @@ def configModel(params, client, md):
         params.profile_warmup - 1,
         md.numInputs,
         md.numOutputs,
-        params.full_pmu_capture,
+        pmu_mode,
+        placement.num_layers if placement else 0,
+        placement.arena_location if placement else 0,
+        placement.arena_size if placement else 0,
+        len(pmu_events),
+        *pmu_event_words,
         *inputTensorByteLengths,
         *outputTensorByteLengths,
     )
@@ -468,6 +529,198 @@ def getPMUStats(params, client, layer, num_events_per_layer):
     return csv_header, pmu_stats
 
 
+def pmu_cache_dir(params):
+    """Where full PMU captures are kept, None when caching is off"""
+    if params.pmu_cache_dir == "none":
+        return None
+    if params.pmu_cache_dir != "auto":
+        return Path(params.pmu_cache_dir)
+    if params.build_cache_dir != "none":
+        return Path(params.build_cache_dir) / "pmu"
+    return Path(params.destination_rootdir) / "pmu_cache"
+
+
+def pmu_cache_key(params, pmu_plan):
+    """Hash of the model and everything else that changes its per-layer PMU counters"""
+    h = hashlib.sha256()
+    with open(params.tflite_filename, "rb") as f:
+        h.update(hashlib.sha256(f.read()).digest())
+    mode, events = pmu_plan
+    for part in (
+        params.platform,
+        params.model_location,
+        params.arena_location,
+        params.tflm_location,
+        params.tensorflow_version,
+        params.ambiqsuite_version,
+        _compiler_version(params.toolchain),
+        _tree_fingerprint(params.neuralspot_rootdir),
+        str(mode),
+        ",".join(str(e) for e in events),
+    ):
+        h.update(str(part).encode())
+        h.update(b"\0")
+    return h.hexdigest()[:24]
+
+
+def load_pmu_cache(params, key):
+    """(csv_header, per-layer counters) of an earlier capture, None on a miss"""
+    root = pmu_cache_dir(params)
+    if root is None:
+        return None
+    path = root / f"{key}.json"
+    try:
+        with open(path, "r") as f:
+            cached = json.load(f)
+        return cached["csv_header"], [tuple(layer) for layer in cached["layers"]]
+    except (OSError, ValueError, KeyError):
+        return None
+
+
+def store_pmu_cache(params, key, csv_header, layers):
+    root = pmu_cache_dir(params)
+    if root is None or not layers:
+        return
+    root.mkdir(parents=True, exist_ok=True)
+    # Publish atomically, another process may be filling the same key
+    staging = root / f"{key}.json.tmp{os.getpid()}"
+    with open(staging, "w") as f:
+        json.dump(
+            {
+                "model": os.path.basename(params.tflite_filename),
+                "csv_header": csv_header,
+                "layers": [list(layer) for layer in layers],
+            },
+            f,
+        )
+    os.replace(staging, root / f"{key}.json")
+
+
+# Arena search, mirrors ns_arena_probe_t / ns_arena_probe_result_t in template_tflm_validator.h
+ARENA_PROBE_PLANNERS = {"greedy": 0, "linear": 1}
+ARENA_PROBE_UNIFIED = 0xFF
+ARENA_PROBE_OK = 0
+ARENA_PROBE_ALLOC_FAILED = 2
+ARENA_PROBE_STATUS = ["ok", "no room", "allocation failed", "invoke failed", "unsupported"]
+ARENA_PROBE_GRANULE = 16  # TFLM aligns arena buffers to 16 bytes
+
+ArenaProbe = collections.namedtuple(
+    "ArenaProbe", ["status", "arena_size", "scratch_size", "used_bytes", "latency_us"]
+)
+ArenaCandidate = collections.namedtuple(
+    "ArenaCandidate",
+    ["planner", "arena_location", "arena_size", "scratch_location", "scratch_size", "latency_us"],
+)
+
+
+def probeArena(client, planner, arena_location, arena_size, scratch_location=None, scratch_size=0, iterations=0):
+    """Builds a throwaway interpreter on the EVB. Sizes of 0 take the rest of the location."""
+    payload = struct.pack(
+        "<6I",
+        ARENA_PROBE_PLANNERS[planner],
+        GENERIC_VALIDATOR_LOCATIONS[arena_location],
+        arena_size,
+        GENERIC_VALIDATOR_LOCATIONS[scratch_location] if scratch_location else ARENA_PROBE_UNIFIED,
+        scratch_size,
+        iterations,
+    )
+    probeBlock = GenericDataOperations_PcToEvb.common.dataBlock(
+        description="Arena Probe",
+        dType=GenericDataOperations_PcToEvb.common.dataType.uint8_e,
+        cmd=GenericDataOperations_PcToEvb.common.command.generic_cmd,
+        buffer=payload,
+        length=len(payload),
+    )
+    resultBlock = erpc.Reference()
+    stat = client.ns_rpc_data_computeOnEVB(probeBlock, resultBlock)
+    if stat != 0 or resultBlock.value.description != "Arena Probe":
+        exit("Arena probe failed, the validator image may predate arena search")
+    return ArenaProbe(*struct.unpack("<5I", resultBlock.value.buffer))
+
+
+def _smallest_working_size(probe, lo, hi, known_good):
+    """Binary search for the smallest size in (lo, hi] that allocates, known_good if hi doesn't"""
+    if hi < known_good and probe(hi).status != ARENA_PROBE_OK:
+        hi = known_good
+    lo, hi = lo // ARENA_PROBE_GRANULE, hi // ARENA_PROBE_GRANULE
+    while hi - lo > 1:
+        mid = (lo + hi) // 2
+        if probe(mid * ARENA_PROBE_GRANULE).status == ARENA_PROBE_OK:
+            hi = mid
+        else:
+            lo = mid
+    return hi * ARENA_PROBE_GRANULE
+
+
+def tuneArena(client, locations, iterations):
+    """
+    Finds the smallest working arena for each memory planner and placement, then times each at
+    that size. Placements are a single arena in each location, and the arena split so the
+    planned activations (scratch) go in one location and the persistent allocations in another.
+    Returns the candidates that fit, fastest first.
+    """
+    placements = [(loc, None) for loc in locations]
+    placements += [(p, s) for p in locations for s in locations if p != s]
+    candidates = []
+    for planner in ARENA_PROBE_PLANNERS:
+        for arena_loc, scratch_loc in placements:
+            full = probeArena(client, planner, arena_loc, 0, scratch_loc, 0)
+            where = arena_loc if scratch_loc is None else f"{arena_loc}+{scratch_loc} scratch"
+            if full.status != ARENA_PROBE_OK:
+                log.info("Arena search: %s %s does not fit (%s)", planner, where, ARENA_PROBE_STATUS[full.status])
+                continue
+            if scratch_loc is None:
+                # The plan doesn't depend on the arena size, so nothing below used_bytes can work
+                arena_size = _smallest_working_size(
+                    lambda n: probeArena(client, planner, arena_loc, n),
+                    full.used_bytes - 1,
+                    full.arena_size,
+                    full.arena_size,
+                )
+                scratch_size = 0
+            else:
+                # Each part holds at most everything, which bounds both searches
+                bound = (full.used_bytes // ARENA_PROBE_GRANULE + 2) * ARENA_PROBE_GRANULE
+                arena_size = _smallest_working_size(
+                    lambda n: probeArena(client, planner, arena_loc, n, scratch_loc, 0),
+                    0,
+                    min(bound, full.arena_size),
+                    full.arena_size,
+                )
+                scratch_size = _smallest_working_size(
+                    lambda n: probeArena(client, planner, arena_loc, arena_size, scratch_loc, n),
+                    0,
+                    min(bound, full.scratch_size),
+                    full.scratch_size,
+                )
+            timed = probeArena(client, planner, arena_loc, arena_size, scratch_loc, scratch_size, iterations)
+            if timed.status != ARENA_PROBE_OK:
+                log.info("Arena search: %s %s failed to run (%s)", planner, where, ARENA_PROBE_STATUS[timed.status])
+                continue
+            candidates.append(
+                ArenaCandidate(planner, arena_loc, arena_size, scratch_loc, scratch_size, timed.latency_us)
+            )
+    return sorted(candidates, key=lambda c: (c.latency_us, c.arena_size + c.scratch_size))
+
+
+def printArenaSearch(candidates, csv_file=None):
+    rows = [
+        [
+            c.planner,
+            c.arena_location,
+            f"{c.arena_size / 1024:.1f}",
+            c.scratch_location or "-",
+            f"{c.scratch_size / 1024:.1f}" if c.scratch_location else "-",
+            c.latency_us,
+        ]
+        for c in candidates
+    ]
+    header = ["Planner", "Arena", "Arena KB", "Scratch", "Scratch KB", "Latency (us)"]
+    print(tabulate(rows, headers=header, tablefmt="simple"))
+    if csv_file is not None:
+        pd.DataFrame(rows, columns=header).to_csv(csv_file, index=False)
+
+
 def _table_to_dataframe(table, strict=False):
     """Convert table to DataFrame; optionally fail if rows are ragged."""
     if not table:
@@ -1724,6 +1977,10 @@ def printStats(params, mc, stats, stats_filename, pmu_csv_header, overall_pmu_st
         row = []
         time = stats[offset + 15]
         macs = stats[offset + 14]
+        if getattr(mc, "generic_validator", False):
+            # The generic image has no per-layer estimates compiled in, use the host's
+            estimates = mc.modelStructureDetails.macEstimates
+            macs = estimates[i % len(estimates)] if estimates else 0
         tag = str(
             struct.unpack(
                 "<20s",
@@ -1763,7 +2020,7 @@ def printStats(params, mc, stats, stats_filename, pmu_csv_header, overall_pmu_st
                 row.append(mc.modelStructureDetails.dilation_w[i])
                 log.info(f"Full PMU Capture, {len(overall_pmu_stats)} layers")
                 for event in overall_pmu_stats[i]:
-                    row.append(event)
+                    row.append(np.nan if event == PMU_NOT_CAPTURED else event)
             else:
                 for j in range(4):
                     row.append(stats[offset + j])
@@ -1840,7 +2097,7 @@ def printStats(params, mc, stats, stats_filename, pmu_csv_header, overall_pmu_st
     return totalCycles, totalMacs, totalTime, captured_events, pmu_events_per_layer
 
 
-def compile_and_deploy(params, mc, first_time=False, aot=False):
+def compile_and_deploy(params, mc, first_time=False, aot=False, deploy=True):
    # The following lines find the paths relative to the cwd
     model_path = params.destination_rootdir + "/" + params.model_name
     d = os.path.join(params.neuralspot_rootdir, model_path)
@@ -1865,12 +2122,9 @@ def compile_and_deploy(params, mc, first_time=False, aot=False):
         # toolchain is gcc, which is default
         ps = f"PLATFORM={params.platform} AS_VERSION={params.ambiqsuite_version} TF_VERSION={params.tensorflow_version}"
     example = "tflm_validator"
-    if first_time:
-        makefile_result = os.system(f"cd {params.neuralspot_rootdir} {ws1} make clean >{ws3} 2>&1 ")
-    else:
-        # The first time (create-binary) we only create the TFLM binary, otherwise we honor the aot flag
-        if aot:
-            example = "aot_validator"
+    # The first time (create-binary) we only create the TFLM binary, otherwise we honor the aot flag
+    if aot and not first_time:
+        example = "aot_validator"
 
     if (params.tflm_location == "ITCM"):
         itcm = "TFLM_IN_ITCM=1"
@@ -1881,6 +2135,17 @@ def compile_and_deploy(params, mc, first_time=False, aot=False):
     if params.full_pmu_capture and ((params.platform == "apollo510_evb") or (params.platform == "apollo510L_eb") or (params.platform == "apollo510b_evb")):
         itcm = itcm + " STACK_SIZE_IN_32B_WORDS=5120"
 
+    if params.build_cache_dir != "none":
+        build_flags = f"{ps} {itcm} AUTODEPLOY=1 ADPATH={relative_build_path} EXAMPLE={example}"
+        if (params.create_profile) or (params.create_binary):
+            build_flags += f" TFLM_VALIDATOR=1 MLPROFILE=1 TFLM_VALIDATOR_MAX_EVENTS={mc.modelStructureDetails.layers}"
+        deploy_flags = f"AUTODEPLOY=1 {ps} ADPATH={relative_build_path} EXAMPLE={example}"
+        return cached_compile_and_deploy(params, example, build_flags, deploy_flags, deploy)
+
+    GenericValidator.forget_board(params)
+    if first_time:
+        makefile_result = os.system(f"cd {params.neuralspot_rootdir} {ws1} make clean >{ws3} 2>&1 ")
+
     if (params.create_profile) or (params.create_binary):
 
         if params.verbosity > 3:
@@ -1969,6 +2234,9 @@ def create_mut_metadata(params, tflm_dir, mc, aot):
         ev2 = "PMU_EVENT2_NA"
         ev3 = "PMU_EVENT3_NA"
 
+    # Pool sizes (KB) when generating the generic image, see GenericValidator
+    pools = getattr(mc, "generic_pools", None)
+
     rm = {
         "NS_AD_LARGE_MODEL": ns_ad_large_model,
         "NS_AD_MODEL_LOCATION": f"NS_AD_{params.model_location}",
@@ -1989,6 +2257,11 @@ def create_mut_metadata(params, tflm_dir, mc, aot):
         "NS_AD_AOT_VALUE": 1 if aot else 0,
         "NS_AD_AOT_NUM_LAYERS": mc.aot_layers if aot else 0,
         "NS_AD_AOT_LAST_IDENTIFIER": mc.aot_layer_last_identifier if aot else 0,
+        "NS_AD_GENERIC_VALUE": 1 if pools else 0,
+        "NS_AD_TCM_POOL_SIZE": pools["TCM"] if pools else 0,
+        "NS_AD_SRAM_POOL_SIZE": pools["SRAM"] if pools else 0,
+        "NS_AD_MRAM_SLOT_SIZE": pools["MRAM"] if pools else 0,
+        "NS_AD_PSRAM_POOL_SIZE": pools["PSRAM"] if pools else 0,
     }
     log.info(
         "Create metadata file with %dk arena size, %dk padding, RPC RX/TX buffer %d, RV Count %d"
@@ -2133,7 +2406,328 @@ def create_mut_main(params, tflm_dir, mc, md, aot):
         mk_template = str(tmpl_root / "validator/template_tflm_validator.mk")
         shutil.copyfile(mk_template, f"{tflm_dir}/module.mk")
 
-def create_validation_binary(params, mc, md, baseline, aot):
+# ---------------------------------------------------------------------------
+#   Content-addressed build cache (--build-cache-dir)
+# ---------------------------------------------------------------------------
+# A validator binary is fully determined by its generated sources (which embed the model), the
+# make flags and the compiler, plus the neuralSPOT tree it links against. Hashing those gives a
+# key under which the .bin is stored, so an unchanged configuration skips compilation, and each
+# build gets its own BINDIRROOT so that several models can compile at the same time.
+
+
+@functools.lru_cache(maxsize=None)
+def _compiler_version(toolchain):
+    compiler = "armclang" if toolchain == "arm" else "arm-none-eabi-gcc"
+    try:
+        out = subprocess.run([compiler, "--version"], capture_output=True, text=True, timeout=30)
+        return out.stdout.splitlines()[0] if out.stdout else compiler
+    except (OSError, subprocess.SubprocessError):
+        return f"{compiler} (not found)"
+
+
+@functools.lru_cache(maxsize=None)
+def _tree_fingerprint(neuralspot_rootdir):
+    # HEAD plus any uncommitted edits to the sources and makefiles the validator builds from
+    h = hashlib.sha256()
+    for cmd in (["git", "rev-parse", "HEAD"], ["git", "diff", "HEAD", "--", "neuralspot", "make", "Makefile"]):
+        try:
+            out = subprocess.run(cmd, cwd=neuralspot_rootdir, capture_output=True, timeout=60)
+            h.update(out.stdout)
+        except (OSError, subprocess.SubprocessError):
+            h.update(b"no-git")
+    return h.hexdigest()
+
+
+def validator_build_key(params, example, build_flags, validator_dir=None, with_model=True):
+    """Hash of everything that determines the validator binary"""
+    h = hashlib.sha256()
+    for part in (
+        build_flags,
+        _compiler_version(params.toolchain),
+        _tree_fingerprint(params.neuralspot_rootdir),
+    ):
+        h.update(part.encode())
+        h.update(b"\0")
+    if with_model:
+        with open(params.tflite_filename, "rb") as f:
+            h.update(hashlib.sha256(f.read()).digest())
+    if validator_dir is None:
+        validator_dir = Path(params.destination_rootdir) / params.model_name / example
+    for path in sorted(Path(validator_dir).rglob("*")):
+        if path.is_file():
+            h.update(str(path.relative_to(validator_dir)).encode())
+            h.update(b"\0")
+            h.update(path.read_bytes())
+    return h.hexdigest()[:24]
+
+
+def cached_build(params, example, build_flags, cache_root, label, validator_dir=None, with_model=True):
+    """Builds into cache_root/<key> unless that key is already there, returns (key, cached .bin)"""
+    key = validator_build_key(params, example, build_flags, validator_dir, with_model)
+    cache_dir = Path(cache_root).resolve() / key
+    cached_bin = cache_dir / f"{example}.bin"
+    quiet = "" if params.verbosity > 3 else " >" + os.devnull + " 2>&1"
+
+    if cached_bin.exists():
+        print(f"[NS] Build cache hit for {label} ({key}), skipping compile")
+        return key, cached_bin
+
+    # Fresh tree per build: flags that make can't see (e.g. TFLM_VALIDATOR_MAX_EVENTS) never
+    # leave stale objects behind, so no 'make clean' of the shared build directory. Keyed by
+    # process too, a concurrent build of the same key must not remove it mid-compile.
+    bindirroot = f"build/ad/{key}.{os.getpid()}"
+    jobs = f"-j{params.make_jobs}" if params.make_jobs > 0 else "-j"
+    cmd = f"make {jobs} {build_flags} BINDIRROOT={bindirroot}"
+    if params.verbosity > 3:
+        print(f"cd {params.neuralspot_rootdir} && {cmd}")
+    makefile_result = subprocess.call(cmd + quiet, shell=True, cwd=params.neuralspot_rootdir)
+    if makefile_result != 0:
+        print("[ERROR] Make failed, return code %d" % makefile_result)
+        exit("Make failed, return code %d" % makefile_result)
+    built = list((Path(params.neuralspot_rootdir) / bindirroot).rglob(f"{example}.bin"))
+    if len(built) != 1:
+        exit(f"Expected one {example}.bin under {bindirroot}, found {len(built)}")
+
+    # Publish atomically, another process may be filling the same key
+    staging = Path(str(cache_dir) + f".tmp{os.getpid()}")
+    staging.mkdir(parents=True, exist_ok=True)
+    shutil.copyfile(built[0], staging / cached_bin.name)
+    shutil.copyfile(built[0].with_suffix(".axf"), staging / f"{example}.axf")
+    try:
+        os.replace(staging, cache_dir)
+    except OSError:
+        shutil.rmtree(staging, ignore_errors=True)  # lost the race, same contents
+    shutil.rmtree(Path(params.neuralspot_rootdir) / bindirroot, ignore_errors=True)
+    print(f"[NS] Cached {example} build for {label} ({key})")
+    return key, cached_bin
+
+
+def deploy_binary(params, deploy_flags, binary):
+    """Flashes an already built image; deploy_target points make at it so nothing is rebuilt"""
+    quiet = "" if params.verbosity > 3 else " >" + os.devnull + " 2>&1"
+    cmd = f"make {deploy_flags} deploy_target={binary} deploy"
+    makefile_result = subprocess.call(cmd + quiet, shell=True, cwd=params.neuralspot_rootdir)
+    if makefile_result != 0:
+        print("[ERROR] Deploy failed, return code %d" % makefile_result)
+        exit("Deploy failed, return code %d" % makefile_result)
+    time.sleep(3)
+    return makefile_result
+
+
+def cached_compile_and_deploy(params, example, build_flags, deploy_flags, deploy):
+    _, cached_bin = cached_build(params, example, build_flags, params.build_cache_dir, params.model_name)
+    if not deploy:
+        return 0
+    GenericValidator.forget_board(params)
+    return deploy_binary(params, deploy_flags, cached_bin)
+
+
+# ---------------------------------------------------------------------------
+#   Generic (prebuilt) validator
+# ---------------------------------------------------------------------------
+# One tflm_validator image per platform and toolchain with every TFLM op registered and the
+# model and arena placed at run time: the host sends a Model Header (size, location) and the
+# model over RPC, then the arena location and size in the config. The image is flashed once and
+# each later model only costs a reset and an upload. Models it can't hold fall back to the
+# per-model build.
+
+GENERIC_VALIDATOR_MAX_LAYERS = 512  # profiler events, also sizes the placeholder metadata
+GENERIC_VALIDATOR_RV_COUNT = 32
+GENERIC_VALIDATOR_SRAM_OVERHEAD_K = 96  # SRAM the larger profiler buffers take from the pool
+GENERIC_VALIDATOR_LOCATIONS = {"TCM": 0, "PSRAM": 1, "SRAM": 2, "MRAM": 3}
+
+# MicroMutableOpResolver adds common to every supported TFLM version, minus the signal library
+# ops (not linked by neuralSPOT) and the generic Builtin/Custom/EthosU hooks
+GENERIC_VALIDATOR_OPS = [
+    "AddAbs", "AddAdd", "AddAddN", "AddArgMax", "AddArgMin", "AddAssignVariable",
+    "AddAveragePool2D", "AddBatchMatMul", "AddBatchToSpaceNd", "AddBroadcastArgs",
+    "AddBroadcastTo", "AddCallOnce", "AddCast", "AddCeil", "AddCircularBuffer",
+    "AddConcatenation", "AddConv2D", "AddCos", "AddCumSum", "AddDepthToSpace",
+    "AddDepthwiseConv2D", "AddDequantize", "AddDetectionPostprocess", "AddDiv", "AddElu",
+    "AddEmbeddingLookup", "AddEqual", "AddExp", "AddExpandDims", "AddFill", "AddFloor",
+    "AddFloorDiv", "AddFloorMod", "AddFullyConnected", "AddGather", "AddGatherNd", "AddGreater",
+    "AddGreaterEqual", "AddHardSwish", "AddIf", "AddL2Normalization", "AddL2Pool2D",
+    "AddLeakyRelu", "AddLess", "AddLessEqual", "AddLog", "AddLogSoftmax", "AddLogicalAnd",
+    "AddLogicalNot", "AddLogicalOr", "AddLogistic", "AddMaxPool2D", "AddMaximum", "AddMean",
+    "AddMinimum", "AddMirrorPad", "AddMul", "AddNeg", "AddNotEqual", "AddPack", "AddPad",
+    "AddPadV2", "AddPrelu", "AddQuantize", "AddReadVariable", "AddReduceMax", "AddRelu",
+    "AddRelu6", "AddReshape", "AddResizeBilinear", "AddResizeNearestNeighbor", "AddRound",
+    "AddRsqrt", "AddSelectV2", "AddShape", "AddSin", "AddSlice", "AddSoftmax",
+    "AddSpaceToBatchNd", "AddSpaceToDepth", "AddSplit", "AddSplitV", "AddSqrt", "AddSquare",
+    "AddSquaredDifference", "AddSqueeze", "AddStridedSlice", "AddSub", "AddSum", "AddSvdf",
+    "AddTanh", "AddTranspose", "AddTransposeConv", "AddUnidirectionalSequenceLSTM", "AddUnpack",
+    "AddVarHandle", "AddWhile", "AddZerosLike",
+]
+
+# What configModel() sends the generic image, locations are GENERIC_VALIDATOR_LOCATIONS values
+GenericPlacement = collections.namedtuple(
+    "GenericPlacement", ["model_location", "num_layers", "arena_location", "arena_size"]
+)
+
+
+class _GenericModelStructure:
+    """Stands in for ModelStructureDetails when generating the model-independent image"""
+
+    def __init__(self, name):
+        n = GENERIC_VALIDATOR_MAX_LAYERS
+        self.macEstimates = [0] * n
+        self.layers = n
+        # Same arrays ns_tflite_analyze emits, zeroed; "" so the profiler can print them
+        self.code = "".join(
+            f"const uint32_t {name}_{a}[{n}] = {{0}};\n"
+            for a in ("output_magnitudes", "stride_h", "stride_w", "dilation_h", "dilation_w")
+        ) + "".join(
+            f'const char* {name}_{a}[{n}] = {{[0 ... {n - 1}] = ""}};\n'
+            for a in ("mac_strings", "output_shapes", "mac_filter_shapes")
+        )
+
+    def getAddList(self):
+        return "".join(f"resolver.{op}();\n" for op in GENERIC_VALIDATOR_OPS), len(GENERIC_VALIDATOR_OPS)
+
+
+class _GenericModelConfiguration:
+    """The ModelConfiguration fields create_mut_* read, for the generic image"""
+
+    def __init__(self, name, pools):
+        self.modelStructureDetails = _GenericModelStructure(name)
+        self.arena_size_k = 0
+        self.arena_size_scratch_buffer_padding_k = 0
+        self.adjusted_stat_buffer_size = max_rpc_buf_size
+        self.rv_count = GENERIC_VALIDATOR_RV_COUNT
+        self.aot_layers = 0
+        self.generic_pools = pools
+
+
+class GenericValidator:
+    def __init__(self, params, platform_cfg):
+        self.p = params
+        cfg = platform_cfg.platform_config
+        mram_slot = params.generic_mram_slot if params.generic_mram_slot > 0 else cfg["mram"] // 2
+        # Pool sizes in KB, compiled into the image
+        self.pools = {
+            "TCM": platform_cfg.GetDTCMSize(),
+            "SRAM": max(0, platform_cfg.GetMaxArenaSize() - GENERIC_VALIDATOR_SRAM_OVERHEAD_K),
+            "MRAM": mram_slot,
+            "PSRAM": cfg.get("psram", 0),
+        }
+        self.mcu = cfg.get("mcu", "")
+        self.root = Path(params.destination_rootdir) / "generic_validator" / params.platform
+        self.cache_root = (
+            Path(params.build_cache_dir) if params.build_cache_dir != "none" else self.root / "cache"
+        )
+        self.bin = None
+        self.reflashed = False  # --generic-reflash applies once per run
+
+    def unsupported_reason(self, mc, model_size_k):
+        """None if this model can run on the generic image, else why not"""
+        msd = mc.modelStructureDetails
+        if self.mcu.startswith("apollo3"):
+            return "Apollo3 has no programmable MRAM"
+        if self.p.nocompile_mode:
+            return "nocompile mode debugs a per-model image"
+        location = self.p.model_location
+        if location not in GENERIC_VALIDATOR_LOCATIONS:
+            return f"model location {location} is not supported"
+        if not self.fits(location, model_size_k):
+            return f"{model_size_k}KB model exceeds the {self.pools[location]}KB {location} pool"
+        if msd.layers > GENERIC_VALIDATOR_MAX_LAYERS:
+            return f"{msd.layers} layers exceed {GENERIC_VALIDATOR_MAX_LAYERS}"
+        if mc.rv_count > GENERIC_VALIDATOR_RV_COUNT:
+            return f"{mc.rv_count} resource variables exceed {GENERIC_VALIDATOR_RV_COUNT}"
+        missing = sorted(
+            {CreateAddFromSnakeOpName(op) for op in msd.opsetList[0].values()} - set(GENERIC_VALIDATOR_OPS)
+        )
+        if missing:
+            return "ops not in the generic resolver: " + ", ".join(missing)
+        return None
+
+    def fits(self, location, model_size_k, arena_location=None, arena_size_k=0):
+        """Stage 2 may move the model (e.g. back to SRAM), so placement is rechecked there"""
+        if location not in GENERIC_VALIDATOR_LOCATIONS:
+            return False
+        if arena_location == location:
+            return model_size_k + arena_size_k <= self.pools[location]
+        if arena_location is not None and arena_size_k > self.pools.get(arena_location, 0):
+            return False
+        return model_size_k <= self.pools[location]
+
+    def placement(self, mc, arena_location, arena_size_k):
+        """arena_size_k of 0 gives the arena the rest of its pool, for measuring it"""
+        return GenericPlacement(
+            GENERIC_VALIDATOR_LOCATIONS[self.p.model_location],
+            mc.modelStructureDetails.layers,
+            GENERIC_VALIDATOR_LOCATIONS[arena_location],
+            arena_size_k * 1024,
+        )
+
+    def _flags(self):
+        p = self.p
+        ps = f"PLATFORM={p.platform} AS_VERSION={p.ambiqsuite_version} TF_VERSION={p.tensorflow_version}"
+        if p.toolchain == "arm":
+            ps += f" TOOLCHAIN={p.toolchain}"
+        rel = os.path.relpath(self.root, start=p.neuralspot_rootdir).replace("\\", "/")
+        build = f"{ps} AUTODEPLOY=1 ADPATH={rel} EXAMPLE=tflm_validator"
+        deploy = build
+        if p.tflm_location == "ITCM":
+            build += " TFLM_IN_ITCM=1"
+        if self.mcu.startswith("apollo5") or self.mcu.startswith("apollo330"):
+            build += " STACK_SIZE_IN_32B_WORDS=5120"  # full PMU capture, built in so one image fits all
+        build += f" TFLM_VALIDATOR=1 MLPROFILE=1 TFLM_VALIDATOR_MAX_EVENTS={GENERIC_VALIDATOR_MAX_LAYERS}"
+        return build, deploy
+
+    def build(self):
+        """Generates and compiles the image (cached), returns its key"""
+        gparams = self.p.model_copy(
+            update={
+                "model_name": "generic",
+                "model_location": "RUNTIME",
+                "arena_location": "RUNTIME",
+            }
+        )
+        gmc = _GenericModelConfiguration("generic", self.pools)
+        validator_dir = self.root / "tflm_validator"
+        create_mut_main(gparams, str(validator_dir), gmc, None, aot=False)
+        create_mut_metadata(gparams, str(validator_dir), gmc, aot=False)
+        create_mut_modelinit(str(validator_dir), gmc)
+        build_flags, _ = self._flags()
+        key, self.bin = cached_build(
+            self.p, "tflm_validator", build_flags, self.cache_root,
+            f"generic {self.p.platform} validator", validator_dir=validator_dir, with_model=False,
+        )
+        return key
+
+    @staticmethod
+    def _board_record(params):
+        return Path(params.destination_rootdir) / "generic_validator" / f"{params.platform}.onboard"
+
+    @staticmethod
+    def forget_board(params):
+        """Any other image flashed to the board invalidates the record"""
+        GenericValidator._board_record(params).unlink(missing_ok=True)
+
+    def start(self):
+        """Flashes the image if the board holds something else, otherwise resets it"""
+        key = self.build()
+        record = self._board_record(self.p)
+        _, deploy_flags = self._flags()
+        reflash = self.p.generic_reflash and not self.reflashed
+        if reflash or not record.exists() or record.read_text().strip() != key:
+            print(f"[NS] Flashing generic validator image ({key}), later models reuse it")
+            deploy_binary(self.p, deploy_flags, self.bin)
+            record.parent.mkdir(parents=True, exist_ok=True)
+            record.write_text(key + "\n")
+            self.reflashed = True
+        else:
+            # A fresh boot for each model: the interpreter and profiler are set up once per boot
+            subprocess.call(
+                f"make {deploy_flags} reset" + ("" if self.p.verbosity > 3 else " >" + os.devnull + " 2>&1"),
+                shell=True,
+                cwd=self.p.neuralspot_rootdir,
+            )
+            time.sleep(3)
+
+
+def create_validation_binary(params, mc, md, baseline, aot, deploy=True):
     if aot:
         subdir = "aot_validator"
     else:
@@ -2163,7 +2757,7 @@ def create_validation_binary(params, mc, md, baseline, aot):
 
     if baseline:
         print(
-            f"[NS] Compiling and deploying Baseline image: arena size = {mc.arena_size_k}k, arena location = {params.arena_location} model_location = {params.model_location}, Resource Variables count = {mc.rv_count}"
+            f"[NS] Compiling {'and deploying ' if deploy else ''}Baseline image: arena size = {mc.arena_size_k}k, arena location = {params.arena_location} model_location = {params.model_location}, Resource Variables count = {mc.rv_count}"
         )
     elif aot:
         print(
@@ -2176,8 +2770,9 @@ def create_validation_binary(params, mc, md, baseline, aot):
 
     create_mut_metadata(params, validator_dir, mc, aot)
     create_mut_modelinit(validator_dir, mc)
-    compile_and_deploy(params, mc, first_time=baseline, aot=aot)
-    time.sleep(3)
+    compile_and_deploy(params, mc, first_time=baseline, aot=aot, deploy=deploy)
+    if deploy:
+        time.sleep(3)
 
 
 # def get_interpreter(params):
@@ -4,6 +4,10 @@ import subprocess
 import yaml
 import sys
 import os
+from concurrent.futures import ThreadPoolExecutor
+
+# Timeout: 15 minutes (900 seconds).
+TIMEOUT_SECONDS = 900
 
 def load_yaml_models(yaml_path):
     if not os.path.exists(yaml_path):
@@ -20,9 +24,10 @@ def load_yaml_models(yaml_path):
         sys.exit(1)
     return data["models"]
 
-def build_command(model, args):
+def build_command(model, args, prebuild=False):
     """
     Build the ns_autodeploy command based on global arguments and per-model settings.
+    With prebuild, the command only compiles the baseline image into the build cache.
     """
     cmd = ["ns_autodeploy"]
 
@@ -36,9 +41,15 @@ def build_command(model, args):
         cmd.extend(["--tensorflow-version", args.tflm_version])
 
     # Enable joulescope if specified.
-    if args.joulescope:
+    if args.joulescope and not prebuild:
         cmd.append("--joulescope")
 
+    if args.build_cache_dir != "none":
+        cmd.extend(["--build-cache-dir", os.path.abspath(args.build_cache_dir)])
+        cmd.extend(["--make-jobs", str(args.make_jobs)])
+    if prebuild:
+        cmd.append("--prebuild-only")
+
     # If the platform belongs to the apollo5 family, enable full PMU capture.
     if "apollo5" in args.platform.lower():
         cmd.append("--full-pmu-capture")
@@ -82,6 +93,83 @@ def build_command(model, args):
 
     return cmd
 
+def run_autodeploy(cmd, model_id):
+    """Run one ns_autodeploy invocation, retrying once on timeout."""
+    for attempt in range(2):
+        try:
+            print(f"Attempt {attempt + 1} for model: {model_id}")
+            subprocess.run(cmd, check=True, timeout=TIMEOUT_SECONDS)
+            print(f"Completed model: {model_id}")
+            return True
+        except subprocess.TimeoutExpired:
+            if attempt == 0:
+                print(f"Timeout expired after {TIMEOUT_SECONDS} seconds for model '{model_id}'. Retrying once...")
+            else:
+                print(f"Timeout expired again for model '{model_id}'. Moving to next model.")
+        except subprocess.CalledProcessError as e:
+            print(f"ns_autodeploy failed for model '{model_id}' with error: {e}")
+            break  # Do not retry on other errors.
+    return False
+
+def prebuild_group(group, log_dir):
+    """
+    Compile the baseline images of one model (all toolchains) into the build cache.
+    Runs of the same model share its generated source directory, so they stay serial.
+    """
+    for model_id, cmd in group:
+        toolchain = cmd[cmd.index("--toolchain") + 1]
+        log_path = os.path.join(log_dir, f"{os.path.basename(model_id)}_{toolchain}.log")
+        with open(log_path, "w") as log:
+            try:
+                result = subprocess.run(cmd, stdout=log, stderr=subprocess.STDOUT, timeout=TIMEOUT_SECONDS)
+                ok = result.returncode == 0
+            except subprocess.TimeoutExpired:
+                ok = False
+        # A failed prebuild isn't fatal, the EVB run compiles (and reports) it again
+        sys.stdout.write(f"Prebuild {'done' if ok else 'FAILED'} for model: {model_id} (log: {log_path})\n")
+
+def prebuild_generic(jobs, log_dir):
+    """
+    Compile the generic validator image once per toolchain, before any worker starts: its
+    generated sources are shared by every model. Models that fit it skip their own prebuild.
+    """
+    toolchains = {}
+    for _, _, _, prebuild_cmd in jobs:
+        toolchains.setdefault(prebuild_cmd[prebuild_cmd.index("--toolchain") + 1], prebuild_cmd)
+    for toolchain, cmd in toolchains.items():
+        log_path = os.path.join(log_dir, f"generic_{toolchain}.log")
+        with open(log_path, "w") as log:
+            try:
+                result = subprocess.run(
+                    cmd + ["--prebuild-generic"], stdout=log, stderr=subprocess.STDOUT, timeout=TIMEOUT_SECONDS
+                )
+                ok = result.returncode == 0
+            except subprocess.TimeoutExpired:
+                ok = False
+        # Not fatal either, the first EVB run on the generic image builds it
+        print(f"Prebuild {'done' if ok else 'FAILED'} for the generic validator ({toolchain}, log: {log_path})")
+
+def start_prebuilds(jobs, args):
+    """
+    With --jobs, compile every model's baseline image on a pool of host workers.
+    Returns {model_id: future} so the EVB loop can wait for each model in turn.
+    """
+    if args.jobs <= 0:
+        return {}
+
+    log_dir = os.path.join(args.build_cache_dir, "logs")
+    os.makedirs(log_dir, exist_ok=True)
+    prebuild_generic(jobs, log_dir)
+    groups = {}
+    for _, model_id, _, prebuild_cmd in jobs:
+        groups.setdefault(model_id, []).append((model_id, prebuild_cmd))
+
+    pool = ThreadPoolExecutor(max_workers=args.jobs)
+    # In YAML order, so the first model is ready first
+    futures = {model_id: pool.submit(prebuild_group, group, log_dir) for model_id, group in groups.items()}
+    pool.shutdown(wait=False)
+    return futures
+
 def main():
     parser = argparse.ArgumentParser(
         description="Invoke ns_autodeploy for multiple models defined in a YAML file."
@@ -143,25 +231,38 @@ def main():
         default=False,
         help="Enable joulescope power consumption measurement."
     )
+    parser.add_argument(
+        "--jobs",
+        type=int,
+        required=False,
+        default=0,
+        help="Compile this many models in parallel ahead of the EVB runs (0: build serially)."
+    )
+    parser.add_argument(
+        "--build-cache-dir",
+        type=str,
+        required=False,
+        default="none",
+        help="Cache of validator binaries reused across runs (default 'ad_build_cache' with --jobs)."
+    )
     args = parser.parse_args()
+    if args.jobs > 0 and args.build_cache_dir == "none":
+        args.build_cache_dir = "ad_build_cache"
+    # Share the host cores between the parallel builds
+    args.make_jobs = max(1, (os.cpu_count() or 1) // args.jobs) if args.jobs > 0 else 0
 
     models = load_yaml_models(args.yaml_file)
 
-    # Timeout: 15 minutes (900 seconds).
-    TIMEOUT_SECONDS = 900
-
-    failed_models = []
     if args.toolchain == "auto":
         toolchains = ["arm", "gcc"]
     else:
         toolchains = [args.toolchain]
-
-    toolchain = args.toolchain
     # Auto will run both gcc and arm
 
+    jobs = []
     for model in models:
         model_id = model.get("model_name", model.get("tflite_filename", "Unknown model"))
-        
+
         # Check unsupported_platforms, if specified.
         if "unsupported_platforms" in model:
             if args.platform in model["unsupported_platforms"]:
@@ -170,30 +271,20 @@ def main():
 
         for toolchain in toolchains:
             args.toolchain = toolchain
-            print(f"Toolchain: {args.toolchain}")
-            cmd = build_command(model, args)
-            print(f"\nRunning ns_autodeploy for model: {model_id}")
-            print("Command:", " ".join(cmd))
-            
-            success = False
-            for attempt in range(2):
-                try:
-                    print(f"Attempt {attempt + 1} for model: {model_id}")
-                    subprocess.run(cmd, check=True, timeout=TIMEOUT_SECONDS)
-                    print(f"Completed model: {model_id}")
-                    success = True
-                    break  # Exit the retry loop on success.
-                except subprocess.TimeoutExpired:
-                    if attempt == 0:
-                        print(f"Timeout expired after {TIMEOUT_SECONDS} seconds for model '{model_id}'. Retrying once...")
-                    else:
-                        print(f"Timeout expired again for model '{model_id}'. Moving to next model.")
-                except subprocess.CalledProcessError as e:
-                    print(f"ns_autodeploy failed for model '{model_id}' with error: {e}")
-                    break  # Do not retry on other errors.
-    
-            if not success:
-                failed_models.append(model)
+            jobs.append((model, model_id, build_command(model, args), build_command(model, args, prebuild=True)))
+
+    prebuilds = start_prebuilds(jobs, args)
+
+    failed_models = []
+    for model, model_id, cmd, _ in jobs:
+        if prebuilds:
+            # Model N+1.. keep compiling on the host while model N is on the EVB
+            prebuilds[model_id].result()
+        print(f"Toolchain: {cmd[cmd.index('--toolchain') + 1]}")
+        print(f"\nRunning ns_autodeploy for model: {model_id}")
+        print("Command:", " ".join(cmd))
+        if not run_autodeploy(cmd, model_id):
+            failed_models.append(model)
 
     if failed_models:
         print("\nThe following models failed:")
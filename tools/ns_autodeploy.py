@@ -67,12 +67,20 @@ from neuralspot.tools.autodeploy.measure_power import (
 
 
 from neuralspot.tools.autodeploy.validator import (
+    GenericValidator,
     ModelConfiguration,
     configModel,
+    printArenaSearch,
     create_validation_binary,
     get_interpreter,
     getModelStats,
     getPMUStats,
+    load_pmu_cache,
+    pmu_cache_dir,
+    pmu_cache_key,
+    pmu_characterization_plan,
+    store_pmu_cache,
+    tuneArena,
     printStats,
     validateModel,
 )
@@ -220,6 +228,16 @@ class Params(BaseModel):
         False,
         description="Capture full PMU data during performance measurements on EVB",
     )
+    pmu_characterization: str = Field(
+        "full",
+        description="Full PMU capture strategy: full (every event), adaptive (a cycles/MVE pass, then "
+        "the event groups each layer needs), or subset (the CHARACTERIZE events of --pmu-config-file)",
+    )
+    pmu_cache_dir: str = Field(
+        "auto",
+        description="Directory of full PMU captures keyed by model hash, placement and strategy; 'auto' "
+        "uses <build-cache-dir>/pmu or <destination-rootdir>/pmu_cache, 'none' always captures",
+    )
 
     # ------------------------------------------------------------------
     #   General Configuration
@@ -334,12 +352,37 @@ class Params(BaseModel):
     # ------------------------------------------------------------------
     verbosity: int = Field(1, description="Verbosity level (0-4)")
     nocompile_mode: bool = Field(False, description="Prevents compile and flash, meant for GDB debug")
+    build_cache_dir: str = Field(
+        "none", description="Directory of validator binaries keyed by model, flags and toolchain; 'none' always rebuilds"
+    )
+    make_jobs: int = Field(0, description="Parallel make jobs for cached builds, 0 for unlimited")
+    prebuild_only: bool = Field(
+        False, description="Only build the baseline validator into --build-cache-dir, no EVB needed"
+    )
+    prebuild_generic: bool = Field(
+        False, description="With --prebuild-only, build the generic validator image instead of the model's"
+    )
+    generic_validator: bool = Field(
+        True,
+        description="the prebuilt validator image: flashed once per board, each model is uploaded over RPC",
+    )
+    generic_mram_slot: int = Field(
+        0, description="KB of MRAM the generic validator image reserves for models, 0 for half of MRAM"
+    )
+    generic_reflash: bool = Field(
+        False, description="Flash the generic validator image even if the board already holds it"
+    )
+    tune_arena: bool = Field(
+        False,
+        description="Search the EVB for the smallest working arena per memory planner and placement, pick the fastest",
+    )
+    tune_arena_runs: int = Field(5, description="Inferences timed per arena search candidate")
     run_log_id: str = Field("none", description="Run ID for the run log. If none, no ID is included in report.")
 
     # ------------------------------------------------------------------
     #   RPC & Transport
     # ------------------------------------------------------------------
-    transport: str = Field("auto", description="RPC transport, 'auto' for autodetect. Can set to USB or UART.")
+    transport: str = Field("auto", description="RPC transport, 'auto' for autodetect. Can set to USB, USB_BULK or UART.")
     tty: str = Field("auto", description="Serial device, 'auto' for autodetect")
     baud: str = Field("auto", description="Baud rate, 'auto' for autodetect")
 
@@ -744,6 +787,7 @@ class AutoDeployRunner:
         self.move_model_back_to_sram: bool = False
         self.results = None  # set later when adResults is constructed
         self.host_interpreter = None  # LiteRT or static fallback for metadata
+        self.generic: GenericValidator | None = None  # set when the model fits the prebuilt image
 
     # ------------------------------------------------------------------
     #   Top-level control-flow (identical to legacy order)
@@ -752,6 +796,10 @@ class AutoDeployRunner:
         """Execute the enabled stages in the same order as the original script."""
         self._prepare_environment()
 
+        if self.p.prebuild_only:
+            self._prebuild_baseline()
+            return
+
         if self.p.create_binary:
             self._create_and_finetune_binary()
 
@@ -863,6 +911,16 @@ class AutoDeployRunner:
         self.results = adResults(self.p)
         self.results.setModelSize(self.model_size)
 
+        # --- Prebuilt (generic) validator, unless the model doesn't fit it -
+        if self.p.generic_validator and (self.p.create_binary or self.p.create_profile or self.p.prebuild_only):
+            gv = GenericValidator(self.p, self.platform_cfg)
+            reason = gv.unsupported_reason(self.mc, self.model_size)
+            if reason is None:
+                self.generic = gv
+                print(f"[NS] Characterizing on the generic validator image for {self.p.platform}")
+            else:
+                print(f"[NS] Generic validator can't run this model ({reason}), building a per-model image")
+
         # Create pickle paths once (used by several stages)
         self._pkl_dir = Path(self.p.destination_rootdir) / self.p.model_name
         self._pkl_dir.mkdir(parents=True, exist_ok=True)
@@ -944,16 +1002,27 @@ class AutoDeployRunner:
         if self.p.arena_location != "PSRAM":
             self.p.arena_location = "SRAM"
 
-        if not self.p.nocompile_mode:
+        placement = None
+        if self.generic is not None:
+            # Arena size 0 hands the arena the rest of its pool, as the baseline image does
+            placement = self.generic.placement(self.mc, self.p.arena_location, 0)
+            self.generic.start()
+        elif not self.p.nocompile_mode:
             create_validation_binary(self.p, self.mc, self.md, baseline=True, aot=False)
         client = rpc_connect_as_client(self.p)
-        configModel(self.p, client, self.md)
+        configModel(self.p, client, self.md, placement)
         stats = getModelStats(self.p, client)
         self.mc.update_from_stats(stats, self.md)
 
+        tuned_location = None
+        if self.p.tune_arena:
+            tuned_location = self._tune_arena(client, stash_arena_location)
+
         # Second pass (tuned arena / model loc)
         self.p.arena_location = stash_arena_location
-        if self.p.arena_location == "auto":
+        if tuned_location is not None:
+            self.p.arena_location = tuned_location
+        elif self.p.arena_location == "auto":
             self.p.arena_location = self.platform_cfg.GetArenaLocation(self.mc.arena_size_k, "auto")
         arena_size = self.mc.arena_size_k + self.p.arena_size_scratch_buffer_padding
         self.platform_cfg.CheckArenaSize(arena_size, self.p.arena_location)
@@ -973,6 +1042,61 @@ class AutoDeployRunner:
                 import pickle
                 pickle.dump(obj, fh)
 
+    # ------------------------------------------------------------------
+    def _tune_arena(self, client, requested_location: str) -> str | None:
+        """Arena search on the Stage 1 image, returns the arena location to use (None if none fit)."""
+        if self.generic is not None:
+            locations = [loc for loc in ("TCM", "SRAM", "PSRAM") if self.generic.pools[loc] > 0]
+        else:
+            locations = [self.p.arena_location]  # a per-model image only has its compiled arena
+        print(f"[NS] Searching arena sizes and placements in {', '.join(locations)}")
+        candidates = tuneArena(client, locations, self.p.tune_arena_runs)
+        if not candidates:
+            print("[NS] Arena search found no working arena, keeping the measured size")
+            return None
+        printArenaSearch(candidates, self._pkl_dir / f"{self.p.model_name}_arena_search.csv")
+
+        # Generated images use one greedy-planned arena, so adopt the fastest of those
+        usable = [
+            c
+            for c in candidates
+            if c.planner == "greedy"
+            and c.scratch_location is None
+            and requested_location in ("auto", c.arena_location)
+        ]
+        if candidates[0] not in usable[:1]:
+            c = candidates[0]
+            print(
+                f"[NS] Fastest overall is the {c.planner} planner with the arena in {c.arena_location}"
+                + (f" and scratch in {c.scratch_location}" if c.scratch_location else "")
+                + f" ({c.latency_us}us); autodeploy images use a single greedy arena"
+            )
+        if not usable:
+            return None
+        best = usable[0]
+        self.mc.arena_size = best.arena_size
+        self.mc.arena_size_k = (best.arena_size // 1024) + 1  # as update_from_stats rounds
+        print(f"[NS] Arena search: {self.mc.arena_size_k}KB in {best.arena_location} ({best.latency_us}us)")
+        return best.arena_location
+
+    # ------------------------------------------------------------------
+    def _prebuild_baseline(self) -> None:
+        """Compile the Stage 1 image into the build cache so a later run only flashes it."""
+        if self.p.build_cache_dir == "none":
+            raise SystemExit("--prebuild-only requires --build-cache-dir")
+        if self.p.prebuild_generic:
+            # The generic sources are shared by every model, so ns_ad_batch builds them once
+            # before its per-model workers start
+            GenericValidator(self.p, self.platform_cfg).build()
+            return
+        if self.generic is not None:
+            print("[NS] Model runs on the generic validator image, no baseline image to build")
+            return
+        # Same arena location as the first pass of _create_and_finetune_binary
+        if self.p.arena_location != "PSRAM":
+            self.p.arena_location = "SRAM"
+        create_validation_binary(self.p, self.mc, self.md, baseline=True, aot=False, deploy=False)
+
     # ------------------------------------------------------------------
     def _characterize_model(self) -> None:  # Stage 2
         print(f"\n[NS] *** Stage [{self._stage}/{self._total_stages}]: Characterize model performance on EVB")
@@ -993,10 +1117,28 @@ class AutoDeployRunner:
                 print("[NS] Model plus Arena do not fit in Data TCM. Moving model to MRAM.")
                 self.p.model_location = "MRAM"
 
-        if not self.p.nocompile_mode:
+        # The generic image takes the tuned arena at configure time instead of a rebuild
+        placement = None
+        arena_size = self.mc.arena_size_k + self.mc.arena_size_scratch_buffer_padding_k
+        if self.generic is not None and self.generic.fits(
+            self.p.model_location, self.model_size, self.p.arena_location, arena_size
+        ):
+            placement = self.generic.placement(self.mc, self.p.arena_location, arena_size)
+            self.generic.start()
+        elif not self.p.nocompile_mode:
             create_validation_binary(self.p, self.mc, self.md, baseline=False, aot=False)
+        self.mc.generic_validator = placement is not None
+
+        # A model characterized before with the same placement and strategy reuses its counters,
+        # the EVB then skips the characterization inferences
+        pmu_plan = pmu_characterization_plan(self.p)
+        pmu_key = None
+        cached_pmu = None
+        if self.p.full_pmu_capture and pmu_cache_dir(self.p) is not None:
+            pmu_key = pmu_cache_key(self.p, pmu_plan)
+            cached_pmu = load_pmu_cache(self.p, pmu_key)
         client = rpc_connect_as_client(self.p)
-        configModel(self.p, client, self.md)
+        configModel(self.p, client, self.md, placement, pmu_plan=(0, []) if cached_pmu else pmu_plan)
 
         differences, _ = validateModel(self.p, client, self.host_interpreter, self.md, self.mc)
         # print(f"[DEBUG] TFLM differences: {differences}")
@@ -1016,7 +1158,10 @@ class AutoDeployRunner:
         stats_file_base = Path(self.p.destination_rootdir) / self.p.model_name / f"{self.p.model_name}_stats"
         pmu_csv_header = ""
         overall_pmu_stats: List[List[int]] = []
-        if self.p.full_pmu_capture:
+        if self.p.full_pmu_capture and cached_pmu is not None:
+            print(f"[NS] PMU cache hit ({pmu_key}), skipping characterization")
+            pmu_csv_header, overall_pmu_stats = cached_pmu
+        elif self.p.full_pmu_capture:
             events_per_layer = stats[4]
             if events_per_layer == 0:
                 pmu_count = stats[3]
@@ -1036,6 +1181,8 @@ class AutoDeployRunner:
                 csv_header, pmu_stats = getPMUStats(self.p, client, layer, events_per_layer)
                 pmu_csv_header = csv_header  # keep header once
                 overall_pmu_stats.append(pmu_stats)
+            if pmu_key is not None:
+                store_pmu_cache(self.p, pmu_key, pmu_csv_header, overall_pmu_stats)
 
         cycles, macs, time_us, layers, events_per_layer = printStats(
             self.p,
@@ -1331,6 +1478,7 @@ class AutoDeployRunner:
         if self.p.create_aot_profile:
             runtime_modes.append("aot")
         # runtime_modes = ["aot"]
+        GenericValidator.forget_board(self.p)  # the power images overwrite the generic validator
         for mode in cpu_modes:
             for runtime_mode in runtime_modes:
                 generatePowerBinary(self.p, self.mc, self.md, mode, aot=runtime_mode == "aot")
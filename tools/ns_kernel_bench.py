@@ -0,0 +1,212 @@
+"""Capture and compare kernel_bench PMU results.
+
+apps/examples/kernel_bench measures each DSP/NN kernel case with the PMU and emits one row per
+case: kernel, size, cycles, instructions, MVE instructions and MVE MACs per call. This script
+stores those rows as a TSV and diffs two of them, so a toolchain or CMSIS update that slows a
+kernel (or silently stops vectorizing it) fails a check instead of going unnoticed.
+
+    # receive the rows over RPC (USB CDC) from a running kernel_bench
+    python3 tools/ns_kernel_bench.py capture -o gcc13.tsv
+    # or pull them out of a saved SWO log (make view > swo.log)
+    python3 tools/ns_kernel_bench.py parse swo.log -o gcc13.tsv
+    # compare, exits 1 if any case regressed
+    python3 tools/ns_kernel_bench.py diff baseline.tsv gcc13.tsv --cycles 5
+"""
+
+import argparse
+import os
+import sys
+import threading
+
+COLUMNS = ["kernel", "size", "cycles", "inst", "mve_inst", "mve_mac"]
+SWO_PREFIX = "KB\t"
+
+
+def parse_rows(lines):
+    """Returns ({(kernel, size): {counter: int}}, toolchain) from TSV or SWO log lines"""
+    results = {}
+    toolchain = None
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if line.startswith(SWO_PREFIX):
+            line = line[len(SWO_PREFIX) :]
+        fields = line.split("\t")
+        if fields[0] == "# toolchain" and len(fields) > 1:
+            toolchain = fields[1]
+            continue
+        if len(fields) != len(COLUMNS) or fields[0] == COLUMNS[0]:
+            continue
+        try:
+            counts = [int(f) for f in fields[2:]]
+        except ValueError:
+            continue
+        results[(fields[0], fields[1])] = dict(zip(COLUMNS[2:], counts))
+    return results, toolchain
+
+
+def write_rows(path, results, toolchain):
+    with open(path, "w") as f:
+        if toolchain:
+            f.write("# toolchain\t%s\n" % toolchain)
+        f.write("\t".join(COLUMNS) + "\n")
+        for (kernel, size), c in results.items():
+            f.write("\t".join([kernel, size] + [str(c[k]) for k in COLUMNS[2:]]) + "\n")
+
+
+def load(path):
+    with open(path) as f:
+        return parse_rows(f)
+
+
+def pct(old, new):
+    if old == 0:
+        return 0.0 if new == 0 else float("inf")
+    return 100.0 * (new - old) / old
+
+
+def diff(base, new, cycles_pct, inst_pct, mve_pct):
+    """Returns (report lines, number of regressions)"""
+    lines = []
+    regressions = 0
+    header = "%-24s %-16s %12s %12s %8s %8s  %s" % (
+        "kernel", "size", "base cyc", "new cyc", "cyc %", "inst %", "verdict"
+    )
+    lines.append(header)
+    lines.append("-" * len(header))
+    for key in sorted(set(base) | set(new)):
+        kernel, size = key
+        if key not in new:
+            lines.append("%-24s %-16s %s" % (kernel, size, "missing from new run"))
+            regressions += 1
+            continue
+        if key not in base:
+            lines.append("%-24s %-16s %s" % (kernel, size, "new case, no baseline"))
+            continue
+        b, n = base[key], new[key]
+        dc, di = pct(b["cycles"], n["cycles"]), pct(b["inst"], n["inst"])
+        verdict = []
+        if dc > cycles_pct:
+            verdict.append("SLOWER")
+        if inst_pct is not None and di > inst_pct:
+            verdict.append("MORE INST")
+        # A kernel that stops issuing MVE instructions usually lost its vector path entirely
+        if b["mve_inst"] > 0 and pct(b["mve_inst"], n["mve_inst"]) < -mve_pct:
+            verdict.append("LOST MVE (%d -> %d)" % (b["mve_inst"], n["mve_inst"]))
+        if verdict:
+            regressions += 1
+        elif dc < -cycles_pct:
+            verdict.append("faster")
+        else:
+            verdict.append("ok")
+        lines.append(
+            "%-24s %-16s %12d %12d %+7.1f%% %+7.1f%%  %s"
+            % (kernel, size, b["cycles"], n["cycles"], dc, di, ", ".join(verdict))
+        )
+    return lines, regressions
+
+
+def find_tty():
+    # kernel_bench serves RPC over USB CDC only, where the EVB enumerates with VID 0xCAFE
+    import serial.tools.list_ports
+
+    for p in serial.tools.list_ports.comports():
+        if p.vid == 51966:
+            print("Found USB device %s" % p.device)
+            return p.device
+    return None
+
+
+def capture(out_path):
+    sys.path.append(
+        os.path.join(
+            os.path.dirname(os.path.abspath(__file__)),
+            "..", "neuralspot", "ns-rpc", "python", "ns-rpc-genericdata",
+        )
+    )
+    import erpc
+    import GenericDataOperations_EvbToPc
+
+    done = threading.Event()
+    rows = []
+
+    class KernelBenchHandler(GenericDataOperations_EvbToPc.interface.Ievb_to_pc):
+        def ns_rpc_data_sendBlockToPC(self, block):
+            if block.description == "KernelBench":
+                row = bytes(block.buffer).decode(errors="replace")
+                if row:
+                    rows.append(row)
+                    print(row)
+                else:
+                    done.set()
+            return 0
+
+        def ns_rpc_data_fetchBlockFromPC(self, block):
+            return 0
+
+        def ns_rpc_data_computeOnPC(self, in_block, result_block):
+            return 0
+
+        def ns_rpc_data_remotePrintOnPC(self, msg):
+            print(msg)
+            return 0
+
+    tty = find_tty()
+    if tty is None:
+        print("No USB device found; without USB, parse the SWO log instead")
+        return 1
+    transport = erpc.transport.SerialTransport(tty, 115200)
+    service = GenericDataOperations_EvbToPc.server.evb_to_pcService(KernelBenchHandler())
+    server = erpc.simple_server.SimpleServer(transport, erpc.basic_codec.BasicCodec)
+    server.add_service(service)
+    threading.Thread(target=server.run, daemon=True).start()
+    print("Waiting for kernel_bench rows (press Button 0 on the EVB)")
+    done.wait()
+
+    results, toolchain = parse_rows(rows)
+    write_rows(out_path, results, toolchain)
+    print("Wrote %d cases to %s" % (len(results), out_path))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="neuralSPOT kernel PMU benchmark capture and diff")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    c = sub.add_parser("capture", help="receive kernel_bench rows over RPC (USB)")
+    c.add_argument("-o", "--out", default="kernel_bench.tsv", help="output TSV")
+
+    p = sub.add_parser("parse", help="extract kernel_bench rows from a SWO log")
+    p.add_argument("log")
+    p.add_argument("-o", "--out", default="kernel_bench.tsv", help="output TSV")
+
+    d = sub.add_parser("diff", help="compare a run against a baseline")
+    d.add_argument("baseline")
+    d.add_argument("new")
+    d.add_argument("--cycles", type=float, default=5.0, help="cycle increase that fails, in %%")
+    d.add_argument("--inst", type=float, default=None, help="instruction increase that fails, %%")
+    d.add_argument("--mve", type=float, default=20.0, help="MVE instruction drop that fails, %%")
+
+    args = ap.parse_args()
+    if args.cmd == "capture":
+        return capture(args.out)
+    if args.cmd == "parse":
+        results, toolchain = load(args.log)
+        if not results:
+            print("No kernel_bench rows in %s" % args.log)
+            return 1
+        write_rows(args.out, results, toolchain)
+        print("Wrote %d cases to %s" % (len(results), args.out))
+        return 0
+
+    base, base_tc = load(args.baseline)
+    new, new_tc = load(args.new)
+    print("baseline: %s (%s)" % (args.baseline, base_tc or "unknown toolchain"))
+    print("new:      %s (%s)" % (args.new, new_tc or "unknown toolchain"))
+    lines, regressions = diff(base, new, args.cycles, args.inst, args.mve)
+    print("\n".join(lines))
+    print("\n%d regression(s)" % regressions)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
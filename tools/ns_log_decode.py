@@ -0,0 +1,263 @@
+#!/usr/bin/env python
+"""Decode ns_log binary records back into text using the application's ELF.
+
+ns_log() records are 32-bit words: a header (0x4E4C in the upper half, argument count in the
+low byte), the address of the format string in the .ns_log_fmt section, a timestamp (core
+cycles on the EVB), and one word per argument. This tool accepts them as:
+
+  * text, e.g. a captured console log, where the NS_LOG_SINK_PRINTF sink wrote "#NSL <hex>"
+    lines - every other line is passed through untouched
+  * a raw little-endian word stream (--binary), e.g. what an NS_LOG_SINK_CALLBACK writer
+    sent over RPC or USB
+  * a raw SWO capture (--itm PORT), i.e. ITM packets from the NS_LOG_SINK_ITM sink
+
+    ns_log_decode build/apollo510_evb/app.axf swo.bin --itm 1
+    ns_log_decode build/apollo510_evb/app.axf console.log --clock 250e6
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+HEADER_MAGIC = 0x4E4C0000
+HEADER_MAGIC_MASK = 0xFFFF0000
+RECORD_OVERHEAD = 3
+MAX_ARGS = 8
+ID_DROPPED = 0xFFFFFFFF
+FMT_SECTION = ".ns_log_fmt"
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf conversion spec: flags, width, precision, length modifier, conversion
+_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaA%])")
+
+
+class ElfImage:
+    """Section contents of an ELF file, addressed by virtual address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        is64 = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+        self.endian = endian
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+            fmt = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+            fmt = endian + "IIIIIIIIII"
+
+        headers = [struct.unpack_from(fmt, data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx] if shnum else None
+        self.sections = []
+        for name, type_, flags, addr, offset, size, *_ in headers:
+            label = ""
+            if names is not None:
+                start = names[4] + name
+                label = data[start : data.index(b"\0", start)].decode("ascii", "replace")
+            contents = b"" if type_ == SHT_NOBITS else data[offset : offset + size]
+            self.sections.append((label, flags, addr, contents))
+
+    def _lookup(self, sections, addr):
+        for _, _, base, contents in sections:
+            if base <= addr < base + len(contents):
+                return contents, addr - base
+        return None, 0
+
+    def string_at(self, addr, fmt=False):
+        """NUL-terminated string at addr: format IDs are looked up in .ns_log_fmt first (it may
+        be non-allocated, at address 0), %s arguments only in loaded sections."""
+        candidates = []
+        if fmt:
+            candidates = [s for s in self.sections if s[0] == FMT_SECTION]
+        candidates += [s for s in self.sections if s[1] & SHF_ALLOC]
+        contents, offset = self._lookup(candidates, addr)
+        if contents is None:
+            return None
+        end = contents.find(b"\0", offset)
+        if end < 0:
+            end = len(contents)
+        return contents[offset:end].decode("utf-8", "replace")
+
+
+def _c_style(flags, width, precision, conv, value):
+    spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+    text = (spec + conv) % value
+    # Python's alternate octal form is 0o17, C's is 017
+    return text.replace("0o", "0", 1) if conv == "o" and "#" in flags else text
+
+
+def format_record(elf, fmt, args):
+    """Expand fmt with the raw argument words the way the EVB's printf would."""
+    out = []
+    pos = 0
+    argi = 0
+
+    def next_word():
+        nonlocal argi
+        if argi >= len(args):
+            raise IndexError
+        argi += 1
+        return args[argi - 1]
+
+    for m in _SPEC.finditer(fmt):
+        out.append(fmt[pos : m.start()])
+        pos = m.end()
+        flags, width, precision, _, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        try:
+            if width == "*":
+                width = str(struct.unpack("<i", struct.pack("<I", next_word()))[0])
+            if precision == "*":
+                precision = str(struct.unpack("<i", struct.pack("<I", next_word()))[0])
+            w = next_word()
+        except IndexError:
+            out.append(m.group(0))
+            continue
+        if conv in "di":
+            value = struct.unpack("<i", struct.pack("<I", w))[0]
+        elif conv in "ouxX":
+            value = w
+        elif conv == "c":
+            value = chr(w & 0xFF)
+            conv = "s"
+        elif conv == "s":
+            value = elf.string_at(w)
+            if value is None:
+                value = f"<0x{w:08x}>"
+        elif conv == "p":
+            value = f"0x{w:x}"
+            conv = "s"
+        else:
+            value = struct.unpack("<f", struct.pack("<I", w))[0]
+            if conv in "aA":
+                value = float.hex(value)
+                conv = "s"
+        out.append(_c_style(flags, width, precision, conv, value))
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode_record(elf, words, clock=None):
+    """Text for one record: [timestamp] message."""
+    nargs = words[0] & 0xFF
+    fmt_id, stamp, args = words[1], words[2], words[RECORD_OVERHEAD : RECORD_OVERHEAD + nargs]
+    if clock:
+        prefix = f"[{stamp / clock:12.6f}] "
+    else:
+        prefix = f"[{stamp:10d}] "
+    if fmt_id == ID_DROPPED:
+        return prefix + f"<{args[0] if args else '?'} ns_log records dropped>"
+    fmt = elf.string_at(fmt_id, fmt=True)
+    if fmt is None:
+        raw = " ".join(f"{a:08x}" for a in args)
+        return prefix + f"<unknown format 0x{fmt_id:08x}: {raw}>"
+    return prefix + format_record(elf, fmt.rstrip("\n"), args)
+
+
+def records_from_words(words):
+    """Split a word stream into records, resyncing on the header marker after corruption."""
+    i = 0
+    while i < len(words):
+        header = words[i]
+        nargs = header & 0xFFFF
+        if (header & HEADER_MAGIC_MASK) != HEADER_MAGIC or nargs > MAX_ARGS:
+            i += 1
+            continue
+        end = i + RECORD_OVERHEAD + nargs
+        if end > len(words):
+            break
+        yield words[i:end]
+        i = end
+
+
+def words_from_itm(data, port):
+    """32-bit payloads written to one ITM stimulus port, out of a raw SWO byte stream."""
+    words = []
+    i = 0
+    while i < len(data):
+        b = data[i]
+        i += 1
+        size = {1: 1, 2: 2, 3: 4}.get(b & 0x3, 0)
+        if size == 0:
+            # Sync, overflow, timestamp and extension packets: skip continuation bytes
+            if (b & 0x0F) == 0 and (b & 0x80):
+                while i < len(data) and data[i] & 0x80:
+                    i += 1
+                i += 1
+            continue
+        payload = data[i : i + size]
+        i += size
+        if not (b & 0x4) and (b >> 3) == port and size == 4 and len(payload) == 4:
+            words.append(struct.unpack("<I", payload)[0])
+    return words
+
+
+def decode_lines(elf, lines, clock=None):
+    """Decode "#NSL" lines, passing anything else through."""
+    for line in lines:
+        stripped = line.strip()
+        idx = stripped.find("#NSL ")
+        if idx < 0:
+            yield line.rstrip("\n")
+            continue
+        try:
+            words = [int(w, 16) for w in stripped[idx + 5 :].split()]
+        except ValueError:
+            yield line.rstrip("\n")
+            continue
+        if stripped[:idx]:
+            yield stripped[:idx]
+        for record in records_from_words(words):
+            yield decode_record(elf, record, clock)
+
+
+def decode_words(elf, words, clock=None):
+    for record in records_from_words(words):
+        yield decode_record(elf, record, clock)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Decode ns_log binary records using the ELF")
+    parser.add_argument("elf", help="Application ELF (.axf) the records came from")
+    parser.add_argument("log", nargs="?", default="-", help="Captured log, '-' for stdin")
+    mode = parser.add_mutually_exclusive_group()
+    mode.add_argument("--binary", action="store_true", help="Log is raw little-endian words")
+    mode.add_argument("--itm", type=int, metavar="PORT", help="Log is a raw SWO capture")
+    parser.add_argument(
+        "--clock", type=float, default=None, help="Timestamp rate in Hz, prints seconds"
+    )
+    parser.add_argument("-o", "--output", default="-", help="Decoded text, '-' for stdout")
+    args = parser.parse_args(argv)
+
+    elf = ElfImage(args.elf)
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    try:
+        if args.binary or args.itm is not None:
+            data = sys.stdin.buffer.read() if args.log == "-" else open(args.log, "rb").read()
+            if args.itm is not None:
+                words = words_from_itm(data, args.itm)
+            else:
+                words = list(struct.unpack(f"<{len(data) // 4}I", data[: len(data) // 4 * 4]))
+            lines = decode_words(elf, words, args.clock)
+        else:
+            src = sys.stdin if args.log == "-" else open(args.log, errors="replace")
+            lines = decode_lines(elf, src, args.clock)
+        for line in lines:
+            print(line, file=out)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
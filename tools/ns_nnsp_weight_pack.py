@@ -0,0 +1,556 @@
+#!/usr/bin/env python
+"""Convert the int8 weight tables of an NNSP network definition to 4-bit or block-sparse tables.
+
+NNSP networks (def_nn3_se.c, def_nn4_nnid.c, ...) hold every FC/LSTM kernel as a dense int8
+array that is read from flash on every frame. This tool rewrites such a file for the kernels in
+ns-nnsp's affine_packed.h:
+
+  * 4x16: 4-bit weights with a per-row scale, w = s * q with q in [-8, 7], picking for each row
+    the scale with the smallest squared error. About half the bytes.
+  * sparse: int8 weights in 8-wide blocks, all-zero blocks left out. --prune T also drops
+    blocks whose weights are all within +-T.
+
+Each "#if ARM_OPTIMIZED==N" section of the file is converted on its own: its NeuralNetClass
+gives the layer sizes and the kernel and recurrent kernel arrays, which are read as row-major
+(ARM_OPTIMIZED==3) or in the interleaved Cortex-M4 order (ARM_OPTIMIZED==1, or a file without
+sections). The compressed tables are the same for every target, so both sections of a file come
+out in the one format. fc_8x16/lstm_8x16 become fc_4x16/lstm_4x16 or fc_sparse_8x16/
+lstm_sparse_8x16, and affine_packed.h is included.
+
+    ns_nnsp_weight_pack apps/demos/nnse/src/def_nn3_se.c                  # report only
+    ns_nnsp_weight_pack def_nn3_se.c -o def_nn3_se.c                      # convert in place
+    ns_nnsp_weight_pack def_nn3_se.c --layers 2,3 -o def_nn3_se_mixed.c       # some layers
+    ns_nnsp_weight_pack def_nn4_nnid.c --format sparse --prune 1 -o out.c
+
+By default only the output layers are converted: the layers after the last LSTM layer. The
+error of a converted input or LSTM layer compounds through the recurrence (converting every
+layer of nnse leaves a mask SNR of about 1 dB, against 23 dB for its two output layers).
+--layers all converts every layer; otherwise --layers counts from 0 in each NeuralNetClass, and
+the sections of a file may hold different networks (def_nn3_se.c has 4 layers for
+ARM_OPTIMIZED==1 and 5 for ==3).
+
+The report lists, per table, the bytes read per frame before and after, the weight SNR, and
+the SNR of the table's matrix-vector product on random inputs, i.e. the error the layer sees
+before its activation. It then estimates the SNR of the network's output by running a float
+model of the network, with the int8 and with the converted weights, over a sequence of random
+input frames, and warns when that is below NETWORK_SNR_WARN_DB.
+"""
+
+import argparse
+import math
+import operator
+import random
+import re
+import sys
+
+BLOCK = 8
+# The float estimate on random frames is far more optimistic than the fixed-point network on
+# audio: nnse estimates 10-14 dB with every layer converted (a mask SNR of 1 dB measured) and
+# 19-23 dB with its output layers converted (23 dB measured)
+NETWORK_SNR_WARN_DB = 16.0
+FORMATS = {
+    "4x16": {"fc_8x16": "fc_4x16", "lstm_8x16": "lstm_4x16"},
+    "sparse": {"fc_8x16": "fc_sparse_8x16", "lstm_8x16": "lstm_sparse_8x16"},
+}
+
+_SECTION = re.compile(r"^[ \t]*#[ \t]*(if|elif)[ \t]+ARM_OPTIMIZED[ \t]*==[ \t]*(\d+)", re.M)
+_PP = re.compile(r"^[ \t]*#[ \t]*(if|ifdef|ifndef|elif|else|endif)\b", re.M)
+_ARRAY = re.compile(
+    r"(?P<decl>(?:const\s+)?u?int8_t\s+(?P<name>\w+)\s*\[\s*\]\s*=\s*)\{(?P<body>[^}]*)\}\s*;"
+)
+_BIAS = re.compile(
+    r"(?:const\s+)?u?int16_t\s+(?P<name>\w+)\s*\[\s*\]\s*=\s*\{(?P<body>[^}]*)\}\s*;"
+)
+_NET = re.compile(r"NeuralNetClass\s+\w+\s*=\s*\{")
+_COMMENTS = re.compile(r"//[^\n]*|/\*.*?\*/", re.S)
+
+
+def row_bytes_4x16(n):
+    """Bytes of one packed row, AFFINE_4X16_ROW_BYTES in affine_packed.h."""
+    return 1 + 8 * (n >> 4) + ((n & 15) + 1) // 2
+
+
+def pack_4x16_row(w):
+    """Pack one int8 row: returns (bytes, the int8 values it decodes to)."""
+    n = len(w)
+    peak = max((abs(v) for v in w), default=0)
+    best = None
+    if peak == 0:
+        best = (0, 1, [0] * n)
+    else:
+        # Rows that use only part of the nibble range can be best served by any scale up to
+        # the peak itself
+        for s in range(max(1, -(-peak // 16)), peak + 1):
+            q, err = [], 0
+            for v in w:
+                x = max(-8, min(7, math.floor(v / s + 0.5)))
+                q.append(x)
+                err += (v - s * x) ** 2
+                if best is not None and err >= best[0]:
+                    break
+            else:
+                best = (err, s, q)
+    _, s, q = best
+    out = bytearray(row_bytes_4x16(n))
+    out[0] = s
+    for k, x in enumerate(q):
+        # 16 inputs per 8 bytes, low then high nibbles; the last group splits at half its size
+        base = k & ~15
+        h = 8 if n - base >= 16 else (n - base + 1) // 2
+        j = k - base
+        out[1 + base // 2 + (j if j < h else j - h)] |= (x & 15) << (0 if j < h else 4)
+    return bytes(out), [s * x for x in q]
+
+
+def pack_sparse_row(w, prune=0):
+    """Block-sparse row: returns (bytes, the int8 values it decodes to)."""
+    n = len(w)
+    blocks = (n + BLOCK - 1) // BLOCK
+    mask = bytearray((blocks + 7) // 8)
+    data = bytearray()
+    dense = []
+    for b in range(blocks):
+        blk = w[b * BLOCK : (b + 1) * BLOCK]
+        if any(abs(v) > prune for v in blk):
+            mask[b >> 3] |= 1 << (b & 7)
+            data += bytes(v & 0xFF for v in blk)
+            dense += blk
+        else:
+            dense += [0] * len(blk)
+    return bytes(mask) + bytes(data), dense
+
+
+def group_sizes(units, gates):
+    """Rows per affine_Krows call, in the order a layer makes them."""
+    sizes = []
+    for u in range(0, units, 4):
+        sizes += [min(4, units - u)] * gates
+    return sizes
+
+
+def interleave_m4(rows, units, gates):
+    """Row-major rows (in consumption order) to the ARM_OPTIMIZED==1 int8 order of affine.c."""
+    out = []
+    r0 = 0
+    for sub in group_sizes(units, gates):
+        grp = rows[r0 : r0 + sub]
+        n = len(grp[0])
+        for i in range(0, n - 1, 2):
+            for r in range(0, sub, 2):
+                if r + 1 < sub:
+                    out += [grp[r][i], grp[r + 1][i], grp[r][i + 1], grp[r + 1][i + 1]]
+                else:
+                    out += [grp[r][i], grp[r][i + 1]]
+        if n & 1:
+            out += [row[n - 1] for row in grp]
+        r0 += sub
+    return out
+
+
+def deinterleave_m4(values, units, gates, n):
+    """Inverse of interleave_m4: the rows of a table in ARM_OPTIMIZED==1 order."""
+    order = interleave_m4(
+        [[(r, k) for k in range(n)] for r in range(units * gates)], units, gates
+    )
+    rows = [[0] * n for _ in range(units * gates)]
+    for (r, k), v in zip(order, values):
+        rows[r][k] = v
+    return rows
+
+
+def snr_db(ref, approx):
+    noise = sum((a - b) ** 2 for a, b in zip(ref, approx))
+    power = sum(a * a for a in ref)
+    if noise == 0:
+        return math.inf
+    return 10 * math.log10(power / noise) if power else -math.inf
+
+
+def matvec_snr(rows, approx, vectors=8, seed=0):
+    """SNR of W x with the decoded weights, over random Gaussian inputs."""
+    rng = random.Random(seed)
+    n = len(rows[0])
+    ref, got = [], []
+    for _ in range(vectors):
+        x = [rng.gauss(0, 1) for _ in range(n)]
+        for w, wq in zip(rows, approx):
+            ref.append(sum(a * b for a, b in zip(w, x)))
+            got.append(sum(a * b for a, b in zip(wq, x)))
+    return snr_db(ref, got)
+
+
+def _dot(a, b):
+    return sum(map(operator.mul, a, b))
+
+
+_ACTIVATIONS = {
+    "relu6": lambda v: min(max(v, 0.0), 6.0),
+    "ftanh": math.tanh,
+    "sigmoid": lambda v: 1 / (1 + math.exp(-v)) if v > -60 else 0.0,
+    "linear": lambda v: v,
+}
+
+
+def network_snr(net, frames=96, seed=0):
+    """SNR of the network output with the converted weights against the int8 ones.
+
+    net: per layer dicts of kind, rows, rows_rec, approx, approx_rec (None when the layer is
+    not converted), bias, qbit_kernel, qbit_bias and activation. The layers are run in float,
+    LSTM states carried over a sequence of random Gaussian input frames.
+    """
+    rng = random.Random(seed)
+    inputs = [[rng.gauss(0, 1) for _ in range(len(net[0]["rows"][0]))] for _ in range(frames)]
+
+    def run(converted):
+        states = [([0.0] * layer["units"], [0.0] * layer["units"]) for layer in net]
+        out = []
+        for x in inputs:
+            for layer, (h, c) in zip(net, states):
+                use = converted and layer["approx"] is not None
+                rows = layer["approx"] if use else layer["rows"]
+                rows_rec = layer["approx_rec"] if use else layer["rows_rec"]
+                sk = 2.0 ** -layer["qbit_kernel"]
+                sb = 2.0 ** -layer["qbit_bias"]
+                pre = [_dot(w, x) for w in rows]
+                if rows_rec is not None:
+                    pre = [p + _dot(w, h) for p, w in zip(pre, rows_rec)]
+                pre = [p * sk + b * sb for p, b in zip(pre, layer["bias"])]
+                if layer["kind"] == "fc":
+                    x = [_ACTIVATIONS[layer["activation"]](v) for v in pre]
+                    continue
+                # Gates i, j, f, o of up to 4 units at a time, as lstm.c consumes the rows
+                r0 = 0
+                for u in range(0, layer["units"], 4):
+                    sub = min(4, layer["units"] - u)
+                    for k in range(sub):
+                        i, j, f, o = (pre[r0 + g * sub + k] for g in range(4))
+                        i, f, o = (_ACTIVATIONS["sigmoid"](v) for v in (i, f, o))
+                        c[u + k] = i * math.tanh(j) + f * c[u + k]
+                        h[u + k] = math.tanh(c[u + k]) * o
+                    r0 += 4 * sub
+                x = list(h)
+            out += x
+        return out
+
+    return snr_db(run(False), run(True))
+
+
+def _split_items(text):
+    """Top-level comma separated items of a brace initializer's contents."""
+    items, depth, cur = [], 0, ""
+    for c in text:
+        if c in "({":
+            depth += 1
+        elif c in ")}":
+            depth -= 1
+        if c == "," and depth == 0:
+            items.append(cur.strip())
+            cur = ""
+        else:
+            cur += c
+    if cur.strip():
+        items.append(cur.strip())
+    return items
+
+
+def _brace_end(text, start):
+    """Index just past the brace that closes the one at text[start]."""
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == "{":
+            depth += 1
+        elif text[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+    raise ValueError("unbalanced braces")
+
+
+def _symbol(item):
+    """Array name of a "(int8_t *)name" initializer item, None for a null pointer."""
+    m = re.search(r"(\w+)\s*$", item)
+    if m is None or re.fullmatch(r"0x0*|0+", m.group(1)):
+        return None
+    return m.group(1)
+
+
+def sections(text):
+    """(start, end, ARM_OPTIMIZED value or None) spans of the file to convert separately."""
+    spans = []
+    for m in _SECTION.finditer(text):
+        start = text.index("\n", m.start()) + 1
+        depth = 0
+        end = len(text)
+        for pp in _PP.finditer(text, start):
+            kw = pp.group(1)
+            if kw in ("if", "ifdef", "ifndef"):
+                depth += 1
+            elif depth == 0:
+                end = pp.start()
+                break
+            elif kw == "endif":
+                depth -= 1
+        spans.append((start, end, int(m.group(2))))
+    return spans or [(0, len(text), None)]
+
+
+def _select_layers(layers, types):
+    """Layer indices to convert: "output", "all" or a set of indices."""
+    if layers == "all":
+        return set(range(len(types)))
+    if layers == "output":
+        lstm = [i for i, kind in enumerate(types) if kind == "lstm"]
+        return set(range(lstm[-1] + 1 if lstm else 0, len(types)))
+    return set(layers)
+
+
+def _table_rows(arrays, name, layer, count, n, units, gates, row_major):
+    """Rows of a kernel table in the order a layer consumes them."""
+    if name not in arrays:
+        raise ValueError(f"layer {layer}: kernel array {name} not found")
+    body_values = [v for v in arrays[name].group("body").split(",") if v.strip()]
+    values = [(int(v, 0) + 128) % 256 - 128 for v in body_values]
+    if len(values) != count * n:
+        raise ValueError(f"{name}: {len(values)} weights, expected {count * n}")
+    if row_major:
+        return [values[r * n : (r + 1) * n] for r in range(count)]
+    return deinterleave_m4(values, units, gates, n)
+
+
+def _bias(biases, name, count):
+    if name is None:
+        return [0] * count
+    if name not in biases:
+        raise ValueError(f"bias array {name} not found")
+    values = [(int(v, 0) + 32768) % 65536 - 32768 for v in biases[name].split(",") if v.strip()]
+    if len(values) != count:
+        raise ValueError(f"{name}: {len(values)} biases, expected {count}")
+    return values
+
+
+def convert_section(text, start, end, arm_optimized, fmt, prune, layers="output"):
+    """Returns (edits, report rows, estimated network SNR or None) for one section.
+
+    edits are (start, end, replacement).
+    """
+    if arm_optimized not in (None, 1, 3):
+        raise ValueError(f"ARM_OPTIMIZED=={arm_optimized} tables are not supported")
+    row_major = arm_optimized == 3
+    body = text[start:end]
+    net = _NET.search(body)
+    if net is None:
+        return [], [], None
+    net_start = net.end() - 1
+    net_end = _brace_end(body, net_start)
+    fields = _split_items(_COMMENTS.sub("", body[net_start + 1 : net_end - 1]))
+    numlayers = int(fields[0], 0)
+    sizes = [int(v, 0) for v in _split_items(fields[1][1:-1])]
+    types = _split_items(fields[2][1:-1])
+    qbit_kernel = [int(v, 0) for v in _split_items(fields[3][1:-1])]
+    qbit_bias = [int(v, 0) for v in _split_items(fields[5][1:-1])]
+    activations = _split_items(fields[6][1:-1])
+    funcs = _split_items(fields[10][1:-1])
+    kernels = [_symbol(v) for v in _split_items(fields[11][1:-1])]
+    biases = [_symbol(v) for v in _split_items(fields[12][1:-1])]
+    kernels_rec = [_symbol(v) for v in _split_items(fields[13][1:-1])]
+    arrays = {m.group("name"): m for m in _ARRAY.finditer(body)}
+    bias_arrays = {m.group("name"): m.group("body") for m in _BIAS.finditer(body)}
+    layers = _select_layers(layers, types[:numlayers])
+    if not layers & set(range(numlayers)):
+        return [], [], None
+
+    edits, report, net = [], [], []
+    for layer in range(numlayers):
+        kind = types[layer]
+        units = sizes[layer + 1]
+        gates = 4 if kind == "lstm" else 1
+        tables = [(kernels[layer], sizes[layer])]
+        if kind == "lstm":
+            tables.append((kernels_rec[layer], units))
+        if layer not in layers:
+            # Kept as int8: only read for the network estimate, which is skipped when a layer
+            # is not a plain fc_8x16/lstm_8x16 one
+            if net is not None and f"{kind}_8x16" in funcs[layer]:
+                try:
+                    rows = [
+                        _table_rows(arrays, name, layer, units * gates, n, units, gates, row_major)
+                        for name, n in tables
+                    ]
+                    net.append(
+                        {
+                            "kind": kind,
+                            "units": units,
+                            "rows": rows[0],
+                            "rows_rec": rows[1] if kind == "lstm" else None,
+                            "approx": None,
+                            "approx_rec": None,
+                            "bias": _bias(bias_arrays, biases[layer], units * gates),
+                            "qbit_kernel": qbit_kernel[layer],
+                            "qbit_bias": qbit_bias[layer],
+                            "activation": activations[layer],
+                        }
+                    )
+                except ValueError:
+                    net = None
+            else:
+                net = None
+            continue
+        if kind not in ("fc", "lstm") or f"{kind}_8x16" not in funcs[layer]:
+            raise ValueError(f"layer {layer}: only fc_8x16 and lstm_8x16 layers are converted")
+        dense, decoded = [], []
+        for name, n in tables:
+            rows = _table_rows(arrays, name, layer, units * gates, n, units, gates, row_major)
+            m = arrays[name]
+            values = [v for row in rows for v in row]
+            packed, approx = bytearray(), []
+            for w in rows:
+                data, dq = pack_4x16_row(w) if fmt == "4x16" else pack_sparse_row(w, prune)
+                packed += data
+                approx.append(dq)
+            flat = [v for row in rows for v in row]
+            flat_q = [v for row in approx for v in row]
+            report.append(
+                {
+                    "table": name,
+                    "shape": f"{units * gates}x{n}",
+                    "int8": len(values),
+                    "packed": len(packed),
+                    "weight_snr": snr_db(flat, flat_q),
+                    "output_snr": matvec_snr(rows, approx),
+                }
+            )
+            lines = [
+                "    " + ", ".join(f"0x{b:02x}" for b in packed[i : i + 16]) + ","
+                for i in range(0, len(packed), 16)
+            ]
+            decl = m.group("decl").replace("uint8_t", "int8_t").replace("int8_t", "uint8_t")
+            edits.append(
+                (start + m.start(), start + m.end(), decl + "{\n" + "\n".join(lines) + "\n};")
+            )
+            dense.append(rows)
+            decoded.append(approx)
+        if net is not None:
+            try:
+                bias = _bias(bias_arrays, biases[layer], units * gates)
+            except ValueError:
+                net = None
+                continue
+            net.append(
+                {
+                    "kind": kind,
+                    "units": units,
+                    "rows": dense[0],
+                    "rows_rec": dense[1] if kind == "lstm" else None,
+                    "approx": decoded[0],
+                    "approx_rec": decoded[1] if kind == "lstm" else None,
+                    "bias": bias,
+                    "qbit_kernel": qbit_kernel[layer],
+                    "qbit_bias": qbit_bias[layer],
+                    "activation": activations[layer],
+                }
+            )
+
+    # Layer functions (listed once each, in layer order), then the header they are declared in
+    calls = iter(range(numlayers))
+
+    def switch(m):
+        layer = next(calls)
+        keep = layer not in layers
+        return m.group(0) if keep else FORMATS[fmt][m.group(0)]
+
+    net_text = re.sub(r"\b(fc|lstm)_8x16\b", switch, body[net_start:net_end])
+    edits.append((start + net_start, start + net_end, net_text))
+    if not re.search(r'#include\s+"affine_packed.h"', body):
+        inc = re.search(r'#include\s+"(affine|neural_nets)\.h"[^\n]*\n', body)
+        if inc is None:
+            raise ValueError("no #include of affine.h or neural_nets.h to add affine_packed.h to")
+        edits.append((start + inc.end(), start + inc.end(), '#include "affine_packed.h"\n'))
+    snr = network_snr(net) if net and report else None
+    return edits, report, snr
+
+
+def convert(text, fmt="4x16", prune=0, layers="output"):
+    """Returns (converted source, [(ARM_OPTIMIZED value, report rows, network SNR)]).
+
+    layers: "output" for the layers after the last LSTM layer, "all", or a set of indices.
+    The network SNR is None when it could not be estimated.
+    """
+    edits, reports = [], []
+    for start, end, arm_optimized in sections(text):
+        e, r, snr = convert_section(text, start, end, arm_optimized, fmt, prune, layers)
+        edits += e
+        if r:
+            reports.append((arm_optimized, r, snr))
+    for s, e, new in sorted(edits, key=lambda x: x[0], reverse=True):
+        text = text[:s] + new + text[e:]
+    return text, reports
+
+
+def print_report(reports, out):
+    for arm_optimized, rows, snr in reports:
+        where = "file" if arm_optimized is None else f"ARM_OPTIMIZED=={arm_optimized}"
+        print(f"[{where}]", file=out)
+        print(f"{'table':<20}{'shape':>10}{'int8 B':>9}{'packed B':>10}{'ratio':>7}"
+              f"{'weight SNR':>12}{'W.x SNR':>10}", file=out)
+        for r in rows:
+            print(f"{r['table']:<20}{r['shape']:>10}{r['int8']:>9}{r['packed']:>10}"
+                  f"{r['packed'] / r['int8']:>7.3f}{r['weight_snr']:>10.1f}dB"
+                  f"{r['output_snr']:>8.1f}dB", file=out)
+        total8 = sum(r["int8"] for r in rows)
+        total = sum(r["packed"] for r in rows)
+        print(f"{'weight bytes/frame':<30}{total8:>9}{total:>10}{total / total8:>7.3f}", file=out)
+        if snr is not None:
+            print(f"{'network output SNR':<30}{snr:>26.1f}dB", file=out)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Convert NNSP int8 weight tables")
+    parser.add_argument("source", help="Network definition, e.g. def_nn3_se.c")
+    parser.add_argument("-o", "--output", help="Converted source; without it only reports")
+    parser.add_argument("--format", choices=sorted(FORMATS), default="4x16")
+    parser.add_argument(
+        "--prune", type=int, default=0, help="sparse: drop blocks with all |w| <= PRUNE"
+    )
+    parser.add_argument(
+        "--layers",
+        default="output",
+        help="output (default: the layers after the last LSTM layer), all, or comma separated "
+        "layer indices, e.g. 0,3",
+    )
+    args = parser.parse_args(argv)
+    layers = args.layers
+    if layers not in ("output", "all"):
+        layers = {int(v) for v in layers.split(",")}
+
+    with open(args.source, newline="") as f:
+        text = f.read()
+    try:
+        converted, reports = convert(text, args.format, args.prune, layers)
+    except ValueError as e:
+        print(f"{args.source}: {e}", file=sys.stderr)
+        return 1
+    if not reports:
+        print(
+            f"{args.source}: nothing to convert (no NeuralNetClass definition, or no layers "
+            "after the last LSTM layer; see --layers)",
+            file=sys.stderr,
+        )
+        return 1
+    print_report(reports, sys.stdout)
+    for arm_optimized, _, snr in reports:
+        if snr is not None and snr < NETWORK_SNR_WARN_DB:
+            where = "" if arm_optimized is None else f" (ARM_OPTIMIZED=={arm_optimized})"
+            print(
+                f"{args.source}{where}: warning: estimated network output SNR {snr:.1f} dB is "
+                f"below {NETWORK_SNR_WARN_DB:.0f} dB; convert fewer layers (--layers output) or "
+                "retrain with 4-bit weights",
+                file=sys.stderr,
+            )
+    if args.output:
+        with open(args.output, "w", newline="") as f:
+            f.write(converted)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python
+"""Convert an ns_trace dump into Chrome trace JSON for chrome://tracing or ui.perfetto.dev.
+
+ns_trace_dump() prints the trace ring between "#NST-BEGIN" and "#NST-END" lines, one event per
+"#NST <timestamp> <phase> <track> <value> <name>" line. Everything else in the log is ignored,
+so a whole console capture can be passed in. A log holding several dumps is exported as one
+trace, each dump continuing on the timeline where the previous one stopped.
+
+    ns_trace_export console.log -o trace.json
+
+Timestamps are 32-bit and wrap (after about 71 minutes with a microsecond timer, or seconds with
+DWT cycles), so they are unwrapped by accumulating signed deltas. Tracks are ISRs (by exception
+number) or tasks; each becomes a thread in the viewer.
+"""
+
+import argparse
+import json
+import sys
+
+LINE_TAG = "#NST "
+BEGIN_TAG = "#NST-BEGIN"
+END_TAG = "#NST-END"
+TASK_TRACK = 128
+
+_EXCEPTIONS = {
+    1: "Reset",
+    2: "NMI",
+    3: "HardFault",
+    4: "MemManage",
+    5: "BusFault",
+    6: "UsageFault",
+    7: "SecureFault",
+    11: "SVCall",
+    12: "DebugMon",
+    14: "PendSV",
+    15: "SysTick",
+}
+
+
+def track_name(track):
+    """Viewer thread name of an ns_trace track number."""
+    if track >= TASK_TRACK:
+        return f"task {track - TASK_TRACK}"
+    if track == 0:
+        return "thread"
+    if track < 16:
+        return _EXCEPTIONS.get(track, f"exception {track}")
+    return f"IRQ {track - 16}"
+
+
+def parse_dumps(lines):
+    """Yield (ticks_per_us, events) per dump, events as (ts, phase, track, value, name) tuples."""
+    ticks_per_us = None
+    events = None
+    for line in lines:
+        idx = line.find("#NST")
+        if idx < 0:
+            continue
+        text = line[idx:].strip()
+        if text.startswith(BEGIN_TAG):
+            fields = dict(f.split("=", 1) for f in text.split()[1:] if "=" in f)
+            ticks_per_us = float(fields.get("ticks_per_us", 1)) or 1.0
+            events = []
+        elif text.startswith(END_TAG):
+            if events is not None:
+                yield ticks_per_us, events
+            events = None
+        elif text.startswith(LINE_TAG) and events is not None:
+            parts = text.split(None, 5)
+            if len(parts) < 5:
+                continue
+            try:
+                ts, phase, track, value = int(parts[1]), parts[2], int(parts[3]), int(parts[4])
+            except ValueError:
+                continue
+            events.append((ts, phase, track, value, parts[5] if len(parts) > 5 else "?"))
+
+
+def to_chrome(dumps, pid=1):
+    """Chrome trace events for the parsed dumps."""
+    out = []
+    tracks = set()
+    offset_us = 0.0
+    for ticks_per_us, events in dumps:
+        if not events:
+            continue
+        # Unwrap the 32-bit timestamps, events are in recording order
+        stamps = []
+        prev = events[0][0]
+        acc = 0
+        for ts, *_ in events:
+            delta = (ts - prev) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            acc += delta
+            prev = ts
+            stamps.append(acc)
+        base = min(stamps)
+
+        # Recording order and time order can differ slightly when an ISR preempted a producer
+        # between taking its slot and reading the clock, so sort before matching spans
+        timed = sorted(
+            ((offset_us + (s - base) / ticks_per_us, e) for s, e in zip(stamps, events)),
+            key=lambda x: x[0],
+        )
+        open_spans = {}
+        last = offset_us
+        for t, (_, phase, track, value, name) in timed:
+            tracks.add(track)
+            last = max(last, t)
+            ev = {"name": name, "ph": phase, "ts": round(t, 3), "pid": pid, "tid": track}
+            if phase == "B":
+                open_spans.setdefault(track, []).append(name)
+                if value:
+                    ev["args"] = {"value": value}
+            elif phase == "E":
+                stack = open_spans.get(track)
+                if not stack:
+                    continue  # its begin was overwritten in the ring
+                stack.pop()
+            elif phase == "i":
+                ev["s"] = "t"
+                ev["args"] = {"value": value}
+            elif phase == "C":
+                ev["args"] = {name: value}
+            else:
+                continue
+            out.append(ev)
+        # Close spans still open at the end of the dump so the viewer shows them
+        for track, stack in open_spans.items():
+            for name in reversed(stack):
+                out.append(
+                    {"name": name, "ph": "E", "ts": round(last, 3), "pid": pid, "tid": track}
+                )
+        offset_us = last + 1.0
+
+    meta = [
+        {"name": "process_name", "ph": "M", "pid": pid, "tid": 0, "args": {"name": "EVB"}}
+    ]
+    for track in sorted(tracks):
+        meta.append(
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": pid,
+                "tid": track,
+                "args": {"name": track_name(track)},
+            }
+        )
+        meta.append(
+            {
+                "name": "thread_sort_index",
+                "ph": "M",
+                "pid": pid,
+                "tid": track,
+                "args": {"sort_index": track},
+            }
+        )
+    return {"traceEvents": meta + out, "displayTimeUnit": "ns"}
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Convert ns_trace dumps to Chrome trace JSON")
+    parser.add_argument("log", nargs="?", default="-", help="Captured log, '-' for stdin")
+    parser.add_argument("-o", "--output", default="-", help="Trace JSON, '-' for stdout")
+    args = parser.parse_args(argv)
+
+    src = sys.stdin if args.log == "-" else open(args.log, errors="replace")
+    try:
+        trace = to_chrome(parse_dumps(src))
+    finally:
+        if src is not sys.stdin:
+            src.close()
+    if not any(e["ph"] != "M" for e in trace["traceEvents"]):
+        print("no #NST events found", file=sys.stderr)
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    try:
+        json.dump(trace, out)
+        out.write("\n")
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -252,6 +252,97 @@ def read_pmu_definitions(params):
             exit("Error reading PMU definitions")
     return pmu_defs
 
+# ARM_PMU_* event ids in the Apollo5 PMU map (ns_pmu_map in ns-utils/src/apollo5/ns_pmu_utils.c),
+# the events a full characterization sweeps
+ARM_PMU_EVENT_IDS = {
+    "ARM_PMU_SW_INCR": 0x0000,
+    "ARM_PMU_L1I_CACHE_REFILL": 0x0001,
+    "ARM_PMU_L1D_CACHE_REFILL": 0x0003,
+    "ARM_PMU_L1D_CACHE": 0x0004,
+    "ARM_PMU_LD_RETIRED": 0x0006,
+    "ARM_PMU_ST_RETIRED": 0x0007,
+    "ARM_PMU_INST_RETIRED": 0x0008,
+    "ARM_PMU_EXC_TAKEN": 0x0009,
+    "ARM_PMU_EXC_RETURN": 0x000A,
+    "ARM_PMU_PC_WRITE_RETIRED": 0x000C,
+    "ARM_PMU_BR_IMMED_RETIRED": 0x000D,
+    "ARM_PMU_BR_RETURN_RETIRED": 0x000E,
+    "ARM_PMU_UNALIGNED_LDST_RETIRED": 0x000F,
+    "ARM_PMU_CPU_CYCLES": 0x0011,
+    "ARM_PMU_MEM_ACCESS": 0x0013,
+    "ARM_PMU_L1I_CACHE": 0x0014,
+    "ARM_PMU_L1D_CACHE_WB": 0x0015,
+    "ARM_PMU_BUS_ACCESS": 0x0019,
+    "ARM_PMU_MEMORY_ERROR": 0x001A,
+    "ARM_PMU_BUS_CYCLES": 0x001D,
+    "ARM_PMU_L1D_CACHE_ALLOCATE": 0x001F,
+    "ARM_PMU_BR_RETIRED": 0x0021,
+    "ARM_PMU_BR_MIS_PRED_RETIRED": 0x0022,
+    "ARM_PMU_STALL_FRONTEND": 0x0023,
+    "ARM_PMU_STALL_BACKEND": 0x0024,
+    "ARM_PMU_LL_CACHE_RD": 0x0036,
+    "ARM_PMU_LL_CACHE_MISS_RD": 0x0037,
+    "ARM_PMU_L1D_CACHE_MISS_RD": 0x0039,
+    "ARM_PMU_STALL": 0x003C,
+    "ARM_PMU_L1D_CACHE_RD": 0x0040,
+    "ARM_PMU_LE_RETIRED": 0x0100,
+    "ARM_PMU_LE_CANCEL": 0x0108,
+    "ARM_PMU_SE_CALL_S": 0x0114,
+    "ARM_PMU_SE_CALL_NS": 0x0115,
+    "ARM_PMU_MVE_INST_RETIRED": 0x0200,
+    "ARM_PMU_MVE_FP_RETIRED": 0x0204,
+    "ARM_PMU_MVE_FP_HP_RETIRED": 0x0208,
+    "ARM_PMU_MVE_FP_SP_RETIRED": 0x020C,
+    "ARM_PMU_MVE_FP_MAC_RETIRED": 0x0214,
+    "ARM_PMU_MVE_INT_RETIRED": 0x0224,
+    "ARM_PMU_MVE_INT_MAC_RETIRED": 0x0228,
+    "ARM_PMU_MVE_LDST_RETIRED": 0x0238,
+    "ARM_PMU_MVE_LD_RETIRED": 0x023C,
+    "ARM_PMU_MVE_ST_RETIRED": 0x0240,
+    "ARM_PMU_MVE_LDST_CONTIG_RETIRED": 0x0244,
+    "ARM_PMU_MVE_LD_CONTIG_RETIRED": 0x0248,
+    "ARM_PMU_MVE_ST_CONTIG_RETIRED": 0x024C,
+    "ARM_PMU_MVE_LDST_NONCONTIG_RETIRED": 0x0250,
+    "ARM_PMU_MVE_LD_NONCONTIG_RETIRED": 0x0254,
+    "ARM_PMU_MVE_ST_NONCONTIG_RETIRED": 0x0258,
+    "ARM_PMU_MVE_LDST_MULTI_RETIRED": 0x025C,
+    "ARM_PMU_MVE_LD_MULTI_RETIRED": 0x0260,
+    "ARM_PMU_MVE_ST_MULTI_RETIRED": 0x0261,
+    "ARM_PMU_MVE_LDST_UNALIGNED_RETIRED": 0x028C,
+    "ARM_PMU_MVE_LD_UNALIGNED_RETIRED": 0x0290,
+    "ARM_PMU_MVE_ST_UNALIGNED_RETIRED": 0x0294,
+    "ARM_PMU_MVE_LDST_UNALIGNED_NONCONTIG_RETIRED": 0x0298,
+    "ARM_PMU_MVE_VREDUCE_RETIRED": 0x02A0,
+    "ARM_PMU_MVE_VREDUCE_FP_RETIRED": 0x02A4,
+    "ARM_PMU_MVE_VREDUCE_INT_RETIRED": 0x02A8,
+    "ARM_PMU_MVE_PRED": 0x02B8,
+    "ARM_PMU_MVE_STALL": 0x02CC,
+    "ARM_PMU_MVE_STALL_RESOURCE": 0x02CD,
+    "ARM_PMU_MVE_STALL_RESOURCE_MEM": 0x02CE,
+    "ARM_PMU_MVE_STALL_RESOURCE_FP": 0x02CF,
+    "ARM_PMU_MVE_STALL_RESOURCE_INT": 0x02D0,
+    "ARM_PMU_MVE_STALL_BREAK": 0x02D3,
+    "ARM_PMU_MVE_STALL_DEPENDENCY": 0x02D4,
+    "ARM_PMU_ITCM_ACCESS": 0x4007,
+    "ARM_PMU_DTCM_ACCESS": 0x4008,
+}
+
+
+def read_pmu_characterize_events(params, counters_fallback=True):
+    """ARM_PMU_* ids for an adaptive or subset PMU characterization: the CHARACTERIZE list of
+    the PMU yaml, or its four PMU_EVENTn counters when it has no such list"""
+    pmu_defs = read_pmu_definitions(params) or {}
+    names = pmu_defs.get("CHARACTERIZE")
+    if names is None and counters_fallback:
+        names = [pmu_defs[f"PMU_EVENT{i}"]["name"] for i in range(4) if f"PMU_EVENT{i}" in pmu_defs]
+    ids = []
+    for name in names or []:
+        if name not in ARM_PMU_EVENT_IDS:
+            exit(f"Unknown PMU event {name} in {params.pmu_config_file}")
+        ids.append(ARM_PMU_EVENT_IDS[name])
+    return ids
+
+
 def next_power_of_2(x):
     return 1 if x == 0 else 2 ** math.ceil(math.log2(x))
 
@@ -330,6 +421,28 @@ def find_tty(params):
     return tty
 
 def rpc_connect_as_client(params):
+    if params.transport == 'USB_BULK':
+        # Vendor bulk endpoints, no tty involved
+        from neuralspot.rpc.usb_bulk_transport import UsbBulkTransport
+
+        log.info("Connecting to EVB USB vendor bulk interface")
+        start_time = time.time()
+        while True:
+            # The EVB may still be enumerating after a reset
+            try:
+                transport = UsbBulkTransport()
+                break
+            except Exception as e:
+                if time.time() - start_time > 30:
+                    print("[NS ERROR] Could not open USB vendor bulk interface: %s" % e)
+                    print("pyusb and a libusb backend are required; on Linux the user also needs access to VID 0xCAFE.")
+                    exit(1)
+                time.sleep(2)
+        clientManager = erpc.client.ClientManager(
+            transport, erpc.basic_codec.BasicCodec
+        )
+        return GenericDataOperations_PcToEvb.client.pc_to_evbClient(clientManager)
+
     tty = wait_for_tty(params)
     if tty is None:
         print("Couldn't find tty device on %s" % params.transport)